@@ -0,0 +1,274 @@
+#include "BenchmarkRunner.h"
+
+// 値を使ったことにする
+#ifdef _MSC_VER
+__declspec(noinline)
+#endif
+void UseValue(const void* pointer)
+{
+	[[maybe_unused]] static const void* volatile sink = nullptr;
+	sink = pointer;
+}
+
+// ケースを登録する
+void BenchmarkRunner::Add(const std::string& group, const std::string& name, std::function<void(BenchmarkState&)> function,
+	std::function<bool()> setup)
+{
+	cases_.push_back({ group, name, setup, function });
+}
+
+// 名前にfilterを含むケースを計測し、結果を1行ずつ書き出す
+void BenchmarkRunner::Run(std::ostream& os, const std::string& filter)
+{
+	os << engine::format("{:<44} {:>12} {:>12} {:>12} {:>8} {:>14}", "benchmark", "median", "min", "stddev", "samples", "throughput") << std::endl;
+
+	for (BenchmarkCase& benchmarkCase : cases_)
+	{
+		std::string fullName = benchmarkCase.group + "/" + benchmarkCase.name;
+		if (fullName.find(filter) == std::string::npos)
+			continue;
+
+		// 準備に失敗したケースは飛ばす（ファイルが無いなど）
+		if (benchmarkCase.setup && benchmarkCase.setup() == false)
+		{
+			os << engine::format("{:<44} skipped", fullName) << std::endl;
+			continue;
+		}
+
+		// 1回目は、キャッシュなどを温めるために捨てる
+		Measure(benchmarkCase, 1);
+
+		double sampleNanoseconds = 0.0;
+		uint64_t iterations = Calibrate(benchmarkCase, sampleNanoseconds);
+
+		// 1回の計測が長いケースは、計測する回数を減らす
+		uint32_t numSamples = numSamples_;
+		double sampleMilliseconds = sampleNanoseconds / 1e6;
+		if (sampleMilliseconds * numSamples > kCaseBudgetMilliseconds_)
+		{
+			numSamples = (std::max)(uint32_t(kCaseBudgetMilliseconds_ / sampleMilliseconds), (std::min)(kMinSlowSamples_, numSamples_));
+		}
+
+		std::vector<double> nanoseconds;
+		uint64_t bytesPerIteration = 0;
+		uint64_t itemsPerIteration = 0;
+		std::vector<std::pair<std::string, double>> counters;
+		for (uint32_t sample = 0; sample < numSamples; ++sample)
+		{
+			BenchmarkState state = Measure(benchmarkCase, iterations);
+			nanoseconds.push_back(state.GetElapsedNanoseconds() / double(iterations));
+			bytesPerIteration = state.GetBytesPerIteration();
+			itemsPerIteration = state.GetItemsPerIteration();
+			counters = state.GetCounters();
+		}
+
+
+		/*--------------
+		    集計する
+		--------------*/
+
+		std::sort(nanoseconds.begin(), nanoseconds.end());
+
+		BenchmarkResult result{};
+		result.group = benchmarkCase.group;
+		result.name = benchmarkCase.name;
+		result.iterations = iterations;
+		result.numSamples = numSamples;
+		result.minNanoseconds = nanoseconds.front();
+		result.medianNanoseconds = (nanoseconds.size() % 2 == 1) ? nanoseconds[nanoseconds.size() / 2] :
+			(nanoseconds[nanoseconds.size() / 2 - 1] + nanoseconds[nanoseconds.size() / 2]) * 0.5;
+
+		double sum = 0.0;
+		for (double value : nanoseconds)
+		{
+			sum += value;
+		}
+		result.meanNanoseconds = sum / double(nanoseconds.size());
+
+		double variance = 0.0;
+		for (double value : nanoseconds)
+		{
+			variance += (value - result.meanNanoseconds) * (value - result.meanNanoseconds);
+		}
+		result.stddevNanoseconds = nanoseconds.size() > 1 ? std::sqrt(variance / double(nanoseconds.size() - 1)) : 0.0;
+
+		result.bytesPerSecond = double(bytesPerIteration) * 1e9 / result.medianNanoseconds;
+		result.itemsPerSecond = double(itemsPerIteration) * 1e9 / result.medianNanoseconds;
+		result.counters = counters;
+
+		results_.push_back(result);
+
+
+		// 読みやすい単位で書き出す
+		auto formatTime = [](double value)
+			{
+				if (value < 1e3)
+					return engine::format("{:.2f} ns", value);
+
+				if (value < 1e6)
+					return engine::format("{:.2f} us", value / 1e3);
+
+				if (value < 1e9)
+					return engine::format("{:.2f} ms", value / 1e6);
+
+				return engine::format("{:.2f} s", value / 1e9);
+			};
+
+		std::string throughput;
+		if (bytesPerIteration != 0)
+		{
+			throughput = engine::format("{:.1f} MB/s", result.bytesPerSecond / (1024.0 * 1024.0));
+		}
+		else if (itemsPerIteration != 0)
+		{
+			throughput = engine::format("{:.2f} M/s", result.itemsPerSecond / 1e6);
+		}
+
+		for (const auto& [name, value] : result.counters)
+		{
+			throughput += engine::format("{}{}={:.2f}", throughput.empty() ? "" : " ", name, value);
+		}
+
+		os << engine::format("{:<44} {:>12} {:>12} {:>12} {:>8} {:>14}", fullName, formatTime(result.medianNanoseconds),
+			formatTime(result.minNanoseconds), formatTime(result.stddevNanoseconds), numSamples, throughput) << std::endl;
+	}
+}
+
+// 名前にfilterを含むケースの名前を書き出す
+void BenchmarkRunner::List(std::ostream& os, const std::string& filter) const
+{
+	for (const BenchmarkCase& benchmarkCase : cases_)
+	{
+		std::string fullName = benchmarkCase.group + "/" + benchmarkCase.name;
+		if (fullName.find(filter) == std::string::npos)
+			continue;
+
+		os << fullName << std::endl;
+	}
+}
+
+// 計測結果をJSONに書き出す
+bool BenchmarkRunner::WriteJson(const std::string& filePath, const std::string& label) const
+{
+	std::ofstream file(filePath);
+	if (file.is_open() == false)
+		return false;
+
+	// 比べるときに、条件が同じかを確かめられるようにする
+#if defined(_DEBUG) || (!defined(_MSC_VER) && !defined(NDEBUG))
+	const char* configuration = "Debug";
+#else
+	const char* configuration = "Release";
+#endif
+
+#if defined(_MSC_VER)
+	std::string compiler = engine::format("MSVC {}", _MSC_FULL_VER);
+#elif defined(__clang__)
+	std::string compiler = engine::format("Clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+	std::string compiler = engine::format("GCC {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#else
+	std::string compiler = "unknown";
+#endif
+
+	std::string date = engine::format("{:%Y-%m-%dT%H:%M:%S}", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+
+	file << "{\n";
+	file << "  \"context\": {\n";
+	file << engine::format("    \"label\": \"{}\",\n", EscapeJson(label));
+	file << engine::format("    \"date\": \"{}\",\n", date);
+	file << engine::format("    \"configuration\": \"{}\",\n", configuration);
+	file << engine::format("    \"compiler\": \"{}\",\n", EscapeJson(compiler));
+	file << engine::format("    \"hardware_threads\": {},\n", std::thread::hardware_concurrency());
+	file << engine::format("    \"min_sample_ms\": {}\n", minSampleMilliseconds_);
+	file << "  },\n";
+	file << "  \"benchmarks\": [\n";
+
+	for (size_t i = 0; i < results_.size(); ++i)
+	{
+		const BenchmarkResult& result = results_[i];
+
+		file << "    {";
+		file << engine::format("\"group\": \"{}\", \"name\": \"{}\", ", EscapeJson(result.group), EscapeJson(result.name));
+		file << engine::format("\"iterations\": {}, \"samples\": {}, ", result.iterations, result.numSamples);
+		file << engine::format("\"median_ns\": {:.3f}, \"min_ns\": {:.3f}, \"mean_ns\": {:.3f}, \"stddev_ns\": {:.3f}, ",
+			result.medianNanoseconds, result.minNanoseconds, result.meanNanoseconds, result.stddevNanoseconds);
+		file << engine::format("\"bytes_per_second\": {:.1f}, \"items_per_second\": {:.1f}", result.bytesPerSecond, result.itemsPerSecond);
+
+		// 時間の他に書き出す値は、あるときだけ書き出す
+		if (result.counters.empty() == false)
+		{
+			file << ", \"counters\": {";
+			for (size_t counter = 0; counter < result.counters.size(); ++counter)
+			{
+				file << engine::format("{}\"{}\": {:.4f}", counter == 0 ? "" : ", ", EscapeJson(result.counters[counter].first), result.counters[counter].second);
+			}
+			file << "}";
+		}
+		file << (i + 1 < results_.size() ? "},\n" : "}\n");
+	}
+
+	file << "  ]\n";
+	file << "}\n";
+
+	return true;
+}
+
+// 1回の計測にかかる時間が、minSampleMilliseconds_を超えるまで回数を増やす
+uint64_t BenchmarkRunner::Calibrate(BenchmarkCase& benchmarkCase, double& sampleNanoseconds)
+{
+	const double minSampleNanoseconds = minSampleMilliseconds_ * 1e6;
+
+	uint64_t iterations = 1;
+	for (;;)
+	{
+		sampleNanoseconds = Measure(benchmarkCase, iterations).GetElapsedNanoseconds();
+		if (sampleNanoseconds >= minSampleNanoseconds)
+			return iterations;
+
+		// 足りない分を見積もって増やす（見積もりが外れても、10倍までにする）
+		double scale = minSampleNanoseconds * 1.2 / (std::max)(sampleNanoseconds, 1.0);
+		iterations = uint64_t(double(iterations) * std::clamp(scale, 2.0, 10.0));
+	}
+}
+
+// 指定した回数で1回計測する
+BenchmarkState BenchmarkRunner::Measure(BenchmarkCase& benchmarkCase, uint64_t iterations)
+{
+	BenchmarkState state(iterations);
+
+	state.ResumeTiming();
+	benchmarkCase.function(state);
+	state.PauseTiming();
+
+	return state;
+}
+
+// JSONの文字列にする
+std::string BenchmarkRunner::EscapeJson(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '"':
+			escaped += "\\\"";
+			break;
+
+		case '\\':
+			escaped += "\\\\";
+			break;
+
+		case '\n':
+			escaped += "\\n";
+			break;
+
+		default:
+			escaped += c;
+			break;
+		}
+	}
+
+	return escaped;
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <ostream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "../../../Class/Engine/Func/Format/Format.h"
+
+// 値を使ったことにする（別の翻訳単位に置き、計測する計算が最適化で消されないようにする）
+void UseValue(const void* pointer);
+
+// 計算した値が、最適化で消されないようにする
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+	UseValue(&value);
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+// 1回分の計測で、ケースに渡すもの
+class BenchmarkState
+{
+public:
+
+	// コンストラクタ
+	explicit BenchmarkState(uint64_t iterations) : iterations_(iterations) {}
+
+	// 計測を止める（準備や後片付けなど、計測しない処理の前に呼ぶ）
+	void PauseTiming()
+	{
+		elapsed_ += std::chrono::steady_clock::now() - start_;
+	}
+
+	// 計測を再開する
+	void ResumeTiming()
+	{
+		start_ = std::chrono::steady_clock::now();
+	}
+
+	// Getter
+	uint64_t GetIterations() const { return iterations_; }
+	double GetElapsedNanoseconds() const { return std::chrono::duration<double, std::nano>(elapsed_).count(); }
+	uint64_t GetBytesPerIteration() const { return bytesPerIteration_; }
+	uint64_t GetItemsPerIteration() const { return itemsPerIteration_; }
+	const std::vector<std::pair<std::string, double>>& GetCounters() const { return counters_; }
+
+	// Setter（1回あたりに処理したバイト数と個数。設定すると、秒あたりの量も書き出す）
+	void SetBytesPerIteration(uint64_t bytes) { bytesPerIteration_ = bytes; }
+	void SetItemsPerIteration(uint64_t items) { itemsPerIteration_ = items; }
+
+	// 時間の他に書き出す値（画質など）を設定する（同じ名前なら上書きする）
+	void SetCounter(const std::string& name, double value)
+	{
+		for (std::pair<std::string, double>& counter : counters_)
+		{
+			if (counter.first == name)
+			{
+				counter.second = value;
+				return;
+			}
+		}
+
+		counters_.emplace_back(name, value);
+	}
+
+
+private:
+
+	// 繰り返す回数
+	uint64_t iterations_ = 0;
+
+	// 計測した時間と、再開した時刻
+	std::chrono::steady_clock::duration elapsed_{};
+	std::chrono::steady_clock::time_point start_{};
+
+	// 1回あたりに処理したバイト数と個数
+	uint64_t bytesPerIteration_ = 0;
+	uint64_t itemsPerIteration_ = 0;
+
+	// 時間の他に書き出す値（名前と値）
+	std::vector<std::pair<std::string, double>> counters_;
+};
+
+// 計測するケース
+typedef struct BenchmarkCase
+{
+	// 分類と名前
+	std::string group;
+	std::string name;
+
+	// 最初に1回だけ呼ぶ準備（無くてもよい。falseを返したら、そのケースは飛ばす）
+	std::function<bool()> setup;
+
+	// GetIterations回繰り返す処理
+	std::function<void(BenchmarkState&)> function;
+}BenchmarkCase;
+
+// ケースの計測結果
+typedef struct BenchmarkResult
+{
+	// 分類と名前
+	std::string group;
+	std::string name;
+
+	// 1回の計測で繰り返した回数と、計測した回数
+	uint64_t iterations;
+	uint32_t numSamples;
+
+	// 1回あたりの時間（ナノ秒）
+	double minNanoseconds;
+	double medianNanoseconds;
+	double meanNanoseconds;
+	double stddevNanoseconds;
+
+	// 中央値から求めた、秒あたりのバイト数と個数（設定していなければ0）
+	double bytesPerSecond;
+	double itemsPerSecond;
+
+	// 時間の他に書き出す値（最後の計測のもの）
+	std::vector<std::pair<std::string, double>> counters;
+}BenchmarkResult;
+
+// ケースを登録して、繰り返す回数を調整しながら計測し、JSONに書き出す
+class BenchmarkRunner
+{
+public:
+
+	// ケースを登録する
+	void Add(const std::string& group, const std::string& name, std::function<void(BenchmarkState&)> function,
+		std::function<bool()> setup = nullptr);
+
+	// 名前（group/name）にfilterを含むケースを計測し、結果を1行ずつ書き出す
+	void Run(std::ostream& os, const std::string& filter);
+
+	// 名前にfilterを含むケースの名前を書き出す（計測はしない）
+	void List(std::ostream& os, const std::string& filter) const;
+
+	// 計測結果をJSONに書き出す（labelには、比べるためのバージョンなどを入れる）
+	bool WriteJson(const std::string& filePath, const std::string& label) const;
+
+	// Getter
+	const std::vector<BenchmarkResult>& GetResults() const { return results_; }
+
+	// Setter
+	void SetMinSampleMilliseconds(double milliseconds) { minSampleMilliseconds_ = milliseconds; }
+	void SetNumSamples(uint32_t numSamples) { numSamples_ = (std::max)(numSamples, 1u); }
+
+
+private:
+
+	// 1回の計測にかかる時間が、minSampleMilliseconds_を超えるまで回数を増やす
+	uint64_t Calibrate(BenchmarkCase& benchmarkCase, double& sampleNanoseconds);
+
+	// 指定した回数で1回計測する
+	static BenchmarkState Measure(BenchmarkCase& benchmarkCase, uint64_t iterations);
+
+	// JSONの文字列にする
+	static std::string EscapeJson(const std::string& text);
+
+
+	// 1回の計測にかける最低の時間
+	double minSampleMilliseconds_ = 50.0;
+
+	// 計測する回数
+	uint32_t numSamples_ = 10;
+
+	// 1回の計測が長いケースの、計測する回数の下限
+	const uint32_t kMinSlowSamples_ = 3;
+
+	// 1つのケースにかける時間の目安（これを超えるケースは、計測する回数を減らす）
+	const double kCaseBudgetMilliseconds_ = 3000.0;
+
+	// 登録したケース
+	std::vector<BenchmarkCase> cases_;
+
+	// 計測結果
+	std::vector<BenchmarkResult> results_;
+};
@@ -0,0 +1,1581 @@
+#include "BenchmarkCases.h"
+
+// 計測に使う入力の数（1回あたりに、これだけ処理する）
+static const uint32_t kNumInputs = 1024;
+
+// Objファイルのディレクトリ
+static const std::string kObjDirectory = "Resources/ModelDatas/monky";
+static const std::string kObjFilename = "monky.obj";
+
+#ifdef _WIN32
+// .wavのディレクトリ
+static const std::string kSoundDirectory = "Resources/Sounds/Se";
+
+// 画像のディレクトリ
+static const std::string kTextureDirectory = "Resources/Textures";
+#endif
+
+/// <summary>
+/// 計測のたびに同じになる乱数を作る
+/// </summary>
+/// <returns>乱数</returns>
+static std::mt19937 MakeRandom()
+{
+	return std::mt19937(20240601u);
+}
+
+/// <summary>
+/// 乱数で決めたアフィン変換行列を作る
+/// </summary>
+/// <param name="random">乱数</param>
+/// <returns>アフィン変換行列</returns>
+static Matrix4x4 MakeRandomAffineMatrix(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+	Vector3 scale = { 1.0f + std::abs(distribution(random)), 1.0f + std::abs(distribution(random)), 1.0f + std::abs(distribution(random)) };
+	Vector3 rotation = { distribution(random), distribution(random), distribution(random) };
+	Vector3 translation = { distribution(random), distribution(random), distribution(random) };
+
+	return Make4x4AffineMatrix(scale, rotation, translation);
+}
+
+#ifdef _WIN32
+/// <summary>
+/// グラデーションに細かい模様を重ねた画像を作る（圧縮が単色の画像より重くなるように）
+/// </summary>
+/// <param name="width">横幅</param>
+/// <param name="height">縦幅</param>
+/// <returns>画像（R8G8B8A8_UNORM_SRGB）</returns>
+static std::shared_ptr<DirectX::ScratchImage> MakeSyntheticImage(uint32_t width, uint32_t height)
+{
+	std::shared_ptr<DirectX::ScratchImage> image = std::make_shared<DirectX::ScratchImage>();
+	HRESULT hr = image->Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, width, height, 1, 1);
+	assert(SUCCEEDED(hr));
+
+	const DirectX::Image* pixels = image->GetImage(0, 0, 0);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		uint8_t* row = pixels->pixels + y * pixels->rowPitch;
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint32_t noise = (x * 73856093u) ^ (y * 19349663u);
+			row[x * 4 + 0] = uint8_t(x * 255 / width);
+			row[x * 4 + 1] = uint8_t(y * 255 / height);
+			row[x * 4 + 2] = uint8_t((noise >> 8) & 0xff);
+			row[x * 4 + 3] = 255;
+		}
+	}
+
+	return image;
+}
+
+/// <summary>
+/// 圧縮した画像を展開し、元の画像と比べたPSNRを求める
+/// </summary>
+/// <param name="source">元の画像</param>
+/// <param name="compressedImage">圧縮した画像</param>
+/// <returns>PSNR（dB）</returns>
+static double ComputeCompressPsnr(const DirectX::Image& source, const DirectX::ScratchImage& compressedImage)
+{
+	DirectX::ScratchImage decompressedImage{};
+	HRESULT hr = DirectX::Decompress(*compressedImage.GetImage(0, 0, 0), source.format, decompressedImage);
+	assert(SUCCEEDED(hr));
+
+	float mse = 0.0f;
+	hr = DirectX::ComputeMSE(source, *decompressedImage.GetImage(0, 0, 0), mse, nullptr);
+	assert(SUCCEEDED(hr));
+
+	return (mse > 0.0f) ? 10.0 * std::log10(1.0 / mse) : 99.0;
+}
+
+// BC7の画質を比べる画像（最初に選ばれたときに読み込み、通常の設定で圧縮したときのPSNRを求めておく）
+typedef struct CompressQualitySource
+{
+	// 元の画像（ミップ0だけ）
+	DirectX::ScratchImage image;
+
+	// 通常の設定で圧縮したときのPSNR（dB）
+	double basePsnr;
+}CompressQualitySource;
+#endif
+
+
+/*---------------
+    行列の計算
+---------------*/
+
+/// <summary>
+/// 行列の計算（Func/Matrix）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMatrixBenchmarks(BenchmarkRunner& runner)
+{
+	// 入力は全てのケースで共有する
+	std::shared_ptr<std::vector<Matrix4x4>> matrices = std::make_shared<std::vector<Matrix4x4>>();
+	std::shared_ptr<std::vector<Vector3>> vectors = std::make_shared<std::vector<Vector3>>();
+
+	auto setup = [matrices, vectors]()
+		{
+			if (matrices->empty())
+			{
+				std::mt19937 random = MakeRandom();
+				std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					matrices->push_back(MakeRandomAffineMatrix(random));
+					vectors->push_back({ distribution(random), distribution(random), distribution(random) });
+				}
+			}
+
+			return true;
+		};
+
+	runner.Add("Matrix", "Multiply", [matrices](BenchmarkState& state)
+		{
+			const std::vector<Matrix4x4>& m = *matrices;
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					Matrix4x4 result = Multiply(m[i], m[(i + 1) % kNumInputs]);
+					DoNotOptimize(result);
+				}
+			}
+			state.SetItemsPerIteration(kNumInputs);
+		}, setup);
+
+	runner.Add("Matrix", "Transform", [matrices, vectors](BenchmarkState& state)
+		{
+			const std::vector<Matrix4x4>& m = *matrices;
+			const std::vector<Vector3>& v = *vectors;
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					Vector3 result = Transform(v[i], m[i]);
+					DoNotOptimize(result);
+				}
+			}
+			state.SetItemsPerIteration(kNumInputs);
+		}, setup);
+
+	runner.Add("Matrix", "Make4x4AffineMatrix", [vectors](BenchmarkState& state)
+		{
+			const std::vector<Vector3>& v = *vectors;
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					Matrix4x4 result = Make4x4AffineMatrix({ 1.0f, 1.0f, 1.0f }, v[i], v[(i + 1) % kNumInputs]);
+					DoNotOptimize(result);
+				}
+			}
+			state.SetItemsPerIteration(kNumInputs);
+		}, setup);
+
+	runner.Add("Matrix", "Make4x4InverseMatrix", [matrices](BenchmarkState& state)
+		{
+			const std::vector<Matrix4x4>& m = *matrices;
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					Matrix4x4 result = Make4x4InverseMatrix(m[i]);
+					DoNotOptimize(result);
+				}
+			}
+			state.SetItemsPerIteration(kNumInputs);
+		}, setup);
+
+	// 1オブジェクト分のワールドビュープロジェクション行列（描画のたびに行う計算）
+	runner.Add("Matrix", "WorldViewProjection", [vectors](BenchmarkState& state)
+		{
+			const std::vector<Vector3>& v = *vectors;
+			Matrix4x4 viewMatrix = Make4x4InverseMatrix(Make4x4AffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.1f, 0.2f, 0.0f }, { 0.0f, 0.0f, -5.0f }));
+			Matrix4x4 projectionMatrix = Make4x4PerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumInputs; ++i)
+				{
+					Matrix4x4 worldMatrix = Make4x4AffineMatrix({ 1.0f, 1.0f, 1.0f }, v[i], v[(i + 1) % kNumInputs]);
+					Matrix4x4 result = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
+					DoNotOptimize(result);
+				}
+			}
+			state.SetItemsPerIteration(kNumInputs);
+		});
+}
+
+
+/*--------------------------
+    Objファイルの読み込み
+--------------------------*/
+
+/// <summary>
+/// Objファイルの読み込み（monky.objと、それを複製して大きくしたもの）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterObjBenchmarks(BenchmarkRunner& runner)
+{
+	// 1つのファイルを、今の読み方と以前の読み方で計測する
+	auto addFile = [&runner](const std::string& label, const std::string& directory, std::shared_ptr<std::string> filename,
+		std::function<bool()> setup)
+		{
+			runner.Add("Obj", "LoadObjFile " + label, [directory, filename](BenchmarkState& state)
+				{
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						ModelData modelData = LoadObjFile(directory, *filename);
+						DoNotOptimize(modelData.vertices.data());
+					}
+					state.SetBytesPerIteration(std::filesystem::file_size(directory + "/" + *filename));
+				}, setup);
+
+			runner.Add("Obj", "LoadObjFileStream " + label, [directory, filename](BenchmarkState& state)
+				{
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						ModelData modelData = LoadObjFileStream(directory, *filename);
+						DoNotOptimize(modelData.vertices.data());
+					}
+					state.SetBytesPerIteration(std::filesystem::file_size(directory + "/" + *filename));
+				}, setup);
+		};
+
+	// 複製して大きくしたものは、最初に選ばれたときに書き出す
+	auto makeTiledSetup = [](std::shared_ptr<std::string> tiledFilename, uint32_t numCopies)
+		{
+			return [tiledFilename, numCopies]()
+				{
+					if (std::filesystem::exists(kObjDirectory + "/" + kObjFilename) == false)
+						return false;
+
+					if (tiledFilename->empty())
+					{
+						*tiledFilename = WriteTiledObjFile(kObjDirectory, kObjFilename, numCopies);
+					}
+
+					return true;
+				};
+		};
+
+	std::shared_ptr<std::string> monkyFilename = std::make_shared<std::string>(kObjFilename);
+	addFile("monky", kObjDirectory, monkyFilename, [monkyFilename]()
+		{
+			return std::filesystem::exists(kObjDirectory + "/" + *monkyFilename);
+		});
+
+	std::shared_ptr<std::string> largestFilename = nullptr;
+	for (uint32_t numCopies : { 16u, 128u })
+	{
+		largestFilename = std::make_shared<std::string>();
+		addFile(engine::format("monky x{}", numCopies), kObjTiledDirectory, largestFilename, makeTiledSetup(largestFilename, numCopies));
+	}
+
+	// 最も大きいものをマップして、スレッド数ごとに読む（1, 2, 4 ... と増やし、最後にハードウェアのスレッド数で計測する）
+	const uint32_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t numThreads = 1; ; numThreads = (std::min)(numThreads * 2, maxThreads))
+	{
+		runner.Add("Obj", engine::format("ParseObj monky x128 {}T", numThreads), [largestFilename, numThreads](BenchmarkState& state)
+			{
+				MappedFile mappedFile;
+				bool isOpen = mappedFile.Open(kObjTiledDirectory + "/" + *largestFilename);
+				assert(isOpen);
+
+				const char* data = reinterpret_cast<const char*>(mappedFile.GetData());
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					ModelData modelData = ParseObj(data, mappedFile.GetSize(), kObjTiledDirectory, numThreads);
+					DoNotOptimize(modelData.vertices.data());
+				}
+				state.SetBytesPerIteration(mappedFile.GetSize());
+			}, makeTiledSetup(largestFilename, 128));
+
+		if (numThreads == maxThreads)
+			break;
+	}
+}
+
+
+/*------------------------------------------
+    メッシュファイルのクックと読み込み
+------------------------------------------*/
+
+// 計測に使うモデル（Objで読んだものと、それをクックしたメッシュファイル）
+typedef struct MeshFileSource
+{
+	// Objで読んだモデル
+	ModelData modelData;
+
+	// クックしたメッシュファイルのパス
+	std::string meshPath;
+}MeshFileSource;
+
+// クックを計測するときに書き出すファイル
+static const std::string kMeshCookFilename = kObjTiledDirectory + "/BenchmarkCook.mesh";
+
+/// <summary>
+/// メッシュファイルのクックと、マップして読む処理（Func/MeshFile）を、monky.objを複製したもので登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMeshFileBenchmarks(BenchmarkRunner& runner)
+{
+	// 複製する数（Objの読み込みのケースの最も大きいものと同じにして、比べられるようにする）
+	const uint32_t kNumCopies = 128;
+
+	// 最初に選ばれたときに、Objを書き出して読み、クックしておく
+	std::shared_ptr<MeshFileSource> source = std::make_shared<MeshFileSource>();
+	auto setup = [source, kNumCopies]()
+		{
+			if (std::filesystem::exists(kObjDirectory + "/" + kObjFilename) == false)
+				return false;
+
+			if (source->meshPath.empty())
+			{
+				std::string tiledFilename = WriteTiledObjFile(kObjDirectory, kObjFilename, kNumCopies);
+				source->modelData = LoadObjFile(kObjTiledDirectory, tiledFilename);
+
+				std::string meshPath = GetMeshCachePath(kObjTiledDirectory, tiledFilename);
+				if (CookMeshFile(source->modelData, meshPath) == false)
+					return false;
+
+				source->meshPath = meshPath;
+			}
+
+			return true;
+		};
+
+	runner.Add("MeshFile", engine::format("CookMeshFile monky x{}", kNumCopies), [source](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				bool isCooked = CookMeshFile(source->modelData, kMeshCookFilename);
+				DoNotOptimize(isCooked);
+			}
+			state.SetBytesPerIteration(std::filesystem::file_size(kMeshCookFilename));
+		}, setup);
+
+	// マップして中身を確かめるだけ（ページには触れない）
+	runner.Add("MeshFile", engine::format("LoadMeshFile monky x{}", kNumCopies), [source](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				MappedFile mappedFile;
+				MeshFileView view{};
+				bool isLoaded = mappedFile.Open(source->meshPath) && LoadMeshFile(mappedFile, view);
+				assert(isLoaded);
+				DoNotOptimize(view.vertices.data());
+			}
+			state.SetBytesPerIteration(std::filesystem::file_size(source->meshPath));
+		}, setup);
+
+	// アップロード用のバッファへ書き込むのと同じく、全てのページに触れる
+	runner.Add("MeshFile", engine::format("LoadMeshFile+copy monky x{}", kNumCopies), [source](BenchmarkState& state)
+		{
+			std::vector<uint8_t> uploadBytes;
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				MappedFile mappedFile;
+				MeshFileView view{};
+				bool isLoaded = mappedFile.Open(source->meshPath) && LoadMeshFile(mappedFile, view);
+				assert(isLoaded);
+
+				uploadBytes.resize(view.vertices.size_bytes() + view.indices.size_bytes());
+				std::memcpy(uploadBytes.data(), view.vertices.data(), view.vertices.size_bytes());
+				std::memcpy(uploadBytes.data() + view.vertices.size_bytes(), view.indices.data(), view.indices.size_bytes());
+				DoNotOptimize(uploadBytes.data());
+			}
+			state.SetBytesPerIteration(std::filesystem::file_size(source->meshPath));
+		}, setup);
+}
+
+
+#ifdef _WIN32
+/*--------------------
+    .wavの読み込み
+--------------------*/
+
+/// <summary>
+/// .wavの読み込み（Resources/Sounds/Seの全てのファイル）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterSoundBenchmarks(BenchmarkRunner& runner)
+{
+	if (std::filesystem::is_directory(kSoundDirectory) == false)
+		return;
+
+	// 名前の順に並べて、毎回同じ順に計測する
+	std::vector<std::string> filePaths;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(kSoundDirectory))
+	{
+		if (entry.path().extension() == ".wav")
+		{
+			filePaths.push_back(entry.path().generic_string());
+		}
+	}
+	std::sort(filePaths.begin(), filePaths.end());
+
+	for (const std::string& filePath : filePaths)
+	{
+		runner.Add("Sound", "LoadSoundWav " + std::filesystem::path(filePath).filename().string(), [filePath](BenchmarkState& state)
+			{
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					SoundData soundData = Sound::LoadSoundWav(filePath.c_str());
+					DoNotOptimize(soundData.pBuffer);
+
+					// 解放は計測しない
+					state.PauseTiming();
+					Sound::SoundUnload(&soundData);
+					state.ResumeTiming();
+				}
+				state.SetBytesPerIteration(std::filesystem::file_size(filePath));
+			});
+	}
+}
+
+
+/*------------------------
+    テクスチャの処理
+------------------------*/
+
+/// <summary>
+/// ミップマップの生成、フォーマットの変換、ブロック圧縮（作った画像）と、テクスチャのクック、キャッシュの読み込み、BC7の画質（Resources/Textures）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTextureBenchmarks(BenchmarkRunner& runner)
+{
+	// 画像は大きさごとに、最初に選ばれたときに作る
+	auto makeImageSetup = [](std::shared_ptr<std::shared_ptr<DirectX::ScratchImage>> image, uint32_t size)
+		{
+			return [image, size]()
+				{
+					if (*image == nullptr)
+					{
+						*image = MakeSyntheticImage(size, size);
+					}
+
+					return true;
+				};
+		};
+
+	std::shared_ptr<std::shared_ptr<DirectX::ScratchImage>> image1024 = std::make_shared<std::shared_ptr<DirectX::ScratchImage>>();
+	std::shared_ptr<std::shared_ptr<DirectX::ScratchImage>> image256 = std::make_shared<std::shared_ptr<DirectX::ScratchImage>>();
+
+	// 1回あたりの入力のバイト数
+	auto getSourceBytes = [](const DirectX::Image& image) { return uint64_t(image.slicePitch); };
+
+	// テクスチャを読み込むときと同じ設定
+	runner.Add("Texture", "GenerateMipMaps 1024", [image1024, getSourceBytes](BenchmarkState& state)
+		{
+			const DirectX::Image& source = *(*image1024)->GetImage(0, 0, 0);
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				DirectX::ScratchImage mipImages{};
+				HRESULT hr = DirectX::GenerateMipMaps(source, DirectX::TEX_FILTER_SRGB, 0, mipImages);
+				assert(SUCCEEDED(hr));
+				DoNotOptimize(mipImages.GetPixels());
+			}
+			state.SetBytesPerIteration(getSourceBytes(source));
+		}, makeImageSetup(image1024, 1024));
+
+	for (const auto& [format, name] : { std::pair{ DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, "BGRA8" }, std::pair{ DXGI_FORMAT_R16G16B16A16_FLOAT, "RGBA16F" } })
+	{
+		DXGI_FORMAT targetFormat = format;
+		runner.Add("Texture", engine::format("Convert 1024 RGBA8 -> {}", name), [image1024, getSourceBytes, targetFormat](BenchmarkState& state)
+			{
+				const DirectX::Image& source = *(*image1024)->GetImage(0, 0, 0);
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					DirectX::ScratchImage convertedImage{};
+					HRESULT hr = DirectX::Convert(source, targetFormat, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, convertedImage);
+					assert(SUCCEEDED(hr));
+					DoNotOptimize(convertedImage.GetPixels());
+				}
+				state.SetBytesPerIteration(getSourceBytes(source));
+			}, makeImageSetup(image1024, 1024));
+	}
+
+	// フォーマットごとに、圧縮に使うスレッドの上限を 1, 2, 4 ... と増やし、最後にハードウェアのスレッド数で計測する
+	// BC6HとBC7は重いので小さい画像で計測する
+	const struct
+	{
+		const char* name;
+		DXGI_FORMAT format;
+		DirectX::TEX_COMPRESS_FLAGS flags;
+		uint32_t size;
+	} compressions[] =
+	{
+		{ "BC1 1024", DXGI_FORMAT_BC1_UNORM_SRGB, DirectX::TEX_COMPRESS_PARALLEL, 1024 },
+		{ "BC3 1024", DXGI_FORMAT_BC3_UNORM_SRGB, DirectX::TEX_COMPRESS_PARALLEL, 1024 },
+		{ "BC4 1024", DXGI_FORMAT_BC4_UNORM, DirectX::TEX_COMPRESS_PARALLEL, 1024 },
+		{ "BC5 1024", DXGI_FORMAT_BC5_UNORM, DirectX::TEX_COMPRESS_PARALLEL, 1024 },
+		{ "BC6H 256", DXGI_FORMAT_BC6H_UF16, DirectX::TEX_COMPRESS_PARALLEL, 256 },
+		{ "BC7 256", DXGI_FORMAT_BC7_UNORM_SRGB, DirectX::TEX_COMPRESS_PARALLEL, 256 },
+		{ "BC7 fast 256", DXGI_FORMAT_BC7_UNORM_SRGB, DirectX::TEX_COMPRESS_PARALLEL | DirectX::TEX_COMPRESS_BC7_FAST, 256 },
+		{ "BC7 quick 256", DXGI_FORMAT_BC7_UNORM_SRGB, DirectX::TEX_COMPRESS_PARALLEL | DirectX::TEX_COMPRESS_BC7_QUICK, 256 },
+	};
+
+	const uint32_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+	for (const auto& compression : compressions)
+	{
+		std::shared_ptr<std::shared_ptr<DirectX::ScratchImage>> image = compression.size == 1024 ? image1024 : image256;
+		DXGI_FORMAT format = compression.format;
+		DirectX::TEX_COMPRESS_FLAGS flags = compression.flags;
+
+		for (uint32_t numThreads = 1; ; numThreads = (std::min)(numThreads * 2, maxThreads))
+		{
+			runner.Add("Texture", engine::format("Compress {} {}T", compression.name, numThreads), [image, getSourceBytes, format, flags, numThreads](BenchmarkState& state)
+				{
+					DirectX::SetCompressThreadLimit(numThreads);
+
+					const DirectX::Image& source = *(*image)->GetImage(0, 0, 0);
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						DirectX::ScratchImage compressedImage{};
+						HRESULT hr = DirectX::Compress(source, format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressedImage);
+						assert(SUCCEEDED(hr));
+						DoNotOptimize(compressedImage.GetPixels());
+					}
+					state.SetBytesPerIteration(getSourceBytes(source));
+
+					// 制限を戻す
+					DirectX::SetCompressThreadLimit(0);
+				}, makeImageSetup(image, compression.size));
+
+			if (numThreads == maxThreads)
+				break;
+		}
+	}
+
+	// Resources/Texturesの画像を、クックする場合（コールド）とキャッシュから読む場合（ウォーム）で計測する
+	if (std::filesystem::is_directory(kTextureDirectory) == false)
+		return;
+
+	// 名前の順に並べて、毎回同じ順に計測する
+	std::vector<std::string> filePaths;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(kTextureDirectory))
+	{
+		std::string extension = entry.path().extension().string();
+		if (extension == ".png" || extension == ".jpg" || extension == ".bmp")
+		{
+			filePaths.push_back(entry.path().generic_string());
+		}
+	}
+	std::sort(filePaths.begin(), filePaths.end());
+
+	for (const auto& [settings, label] : { std::pair{ TextureCookSettings{ DXGI_FORMAT_UNKNOWN , false }, "mips" }, std::pair{ TextureCookSettings{ DXGI_FORMAT_BC7_UNORM , true }, "BC7 fast" } })
+	{
+		for (const std::string& filePath : filePaths)
+		{
+			std::string filename = std::filesystem::path(filePath).filename().string();
+			TextureCookSettings cookSettings = settings;
+
+			// 読み込み、ミップ生成、圧縮、保存
+			runner.Add("TextureCache", engine::format("Cook {} {}", filename, label), [filePath, cookSettings](BenchmarkState& state)
+				{
+					std::filesystem::create_directories(kTextureCacheDirectory);
+
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						std::vector<uint8_t> sourceBytes = ReadTextureFile(filePath);
+						DirectX::ScratchImage cookedImages = CookTexture(sourceBytes.data(), sourceBytes.size(), cookSettings);
+
+						std::wstring cachePathW = ConvertString(GetTextureCachePath(sourceBytes.data(), sourceBytes.size(), cookSettings));
+						HRESULT hr = DirectX::SaveToDDSFile(cookedImages.GetImages(), cookedImages.GetImageCount(), cookedImages.GetMetadata(),
+							DirectX::DDS_FLAGS_NONE, cachePathW.c_str());
+						assert(SUCCEEDED(hr));
+					}
+					state.SetBytesPerIteration(std::filesystem::file_size(filePath));
+				});
+
+			// 元のファイルのハッシュ値とDDSの読み込み（キャッシュが無ければ、最初に選ばれたときにクックして保存する）
+			runner.Add("TextureCache", engine::format("Load cached {} {}", filename, label), [filePath, cookSettings](BenchmarkState& state)
+				{
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						std::vector<uint8_t> sourceBytes = ReadTextureFile(filePath);
+						std::wstring cachePathW = ConvertString(GetTextureCachePath(sourceBytes.data(), sourceBytes.size(), cookSettings));
+
+						DirectX::ScratchImage cachedImages{};
+						HRESULT hr = DirectX::LoadFromDDSFile(cachePathW.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, cachedImages);
+						assert(SUCCEEDED(hr));
+						DoNotOptimize(cachedImages.GetPixels());
+					}
+					state.SetBytesPerIteration(std::filesystem::file_size(filePath));
+				}, [filePath, cookSettings]()
+				{
+					std::ostringstream log;
+					DirectX::ScratchImage images = LoadTexture(log, filePath, cookSettings);
+					return images.GetImageCount() > 0;
+				});
+		}
+	}
+
+	// Resources/Texturesの画像を、BC7の設定（通常、高速、モード6のみ）ごとに1スレッドで圧縮し、画質も書き出す
+	// psnr_dbは展開した画像と元の画像のPSNR、psnr_loss_dbは通常の設定と比べて下がった分（画像ごとの最悪値を見るため）
+	const std::pair<DirectX::TEX_COMPRESS_FLAGS, const char*> tiers[] =
+	{
+		{ DirectX::TEX_COMPRESS_DEFAULT, "default" },
+		{ DirectX::TEX_COMPRESS_BC7_FAST, "fast" },
+		{ DirectX::TEX_COMPRESS_BC7_QUICK, "quick" },
+	};
+
+	for (const std::string& filePath : filePaths)
+	{
+		std::shared_ptr<CompressQualitySource> source = std::make_shared<CompressQualitySource>();
+		auto setup = [filePath, source]()
+			{
+				if (source->image.GetImageCount() > 0)
+					return true;
+
+				std::vector<uint8_t> sourceBytes = ReadTextureFile(filePath);
+				HRESULT hr = DirectX::LoadFromWICMemory(sourceBytes.data(), sourceBytes.size(), DirectX::WIC_FLAGS_NONE, nullptr, source->image);
+				if (FAILED(hr))
+					return false;
+
+				// ブロック圧縮は4の倍数の大きさでないと使えない
+				const DirectX::Image& image = *source->image.GetImage(0, 0, 0);
+				if (image.width % 4 != 0 || image.height % 4 != 0)
+					return false;
+
+				DirectX::ScratchImage compressedImage{};
+				hr = DirectX::Compress(image, DXGI_FORMAT_BC7_UNORM, DirectX::TEX_COMPRESS_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, compressedImage);
+				assert(SUCCEEDED(hr));
+
+				source->basePsnr = ComputeCompressPsnr(image, compressedImage);
+				return true;
+			};
+
+		std::string filename = std::filesystem::path(filePath).filename().string();
+		for (const auto& [flags, name] : tiers)
+		{
+			DirectX::TEX_COMPRESS_FLAGS compressFlags = flags;
+			runner.Add("TextureQuality", engine::format("BC7 {} {}", name, filename), [source, compressFlags, getSourceBytes](BenchmarkState& state)
+				{
+					const DirectX::Image& image = *source->image.GetImage(0, 0, 0);
+
+					DirectX::ScratchImage compressedImage{};
+					for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+					{
+						HRESULT hr = DirectX::Compress(image, DXGI_FORMAT_BC7_UNORM, compressFlags, DirectX::TEX_THRESHOLD_DEFAULT, compressedImage);
+						assert(SUCCEEDED(hr));
+						DoNotOptimize(compressedImage.GetPixels());
+					}
+					state.SetBytesPerIteration(getSourceBytes(image));
+
+					// 画質は計測しない
+					state.PauseTiming();
+					double psnr = ComputeCompressPsnr(image, compressedImage);
+					state.SetCounter("psnr_db", psnr);
+					state.SetCounter("psnr_loss_db", source->basePsnr - psnr);
+					state.ResumeTiming();
+				}, setup);
+		}
+	}
+}
+
+
+/*--------------------------
+    マネージャの番号の検索
+--------------------------*/
+
+// ケースを登録する
+void HandleLookupBenchmark::Register(BenchmarkRunner& runner)
+{
+	// マネージャは大きいので、ヒープに置く
+	std::shared_ptr<std::unique_ptr<TextureManager>> textureManager = std::make_shared<std::unique_ptr<TextureManager>>();
+	std::shared_ptr<std::unique_ptr<ModelManager>> modelManager = std::make_shared<std::unique_ptr<ModelManager>>();
+
+	// 探す番号（登録したものから選んだものと、どれにも当たらないもの）
+	std::shared_ptr<std::vector<uint32_t>> hitNumbers = std::make_shared<std::vector<uint32_t>>();
+	std::shared_ptr<std::vector<uint32_t>> missNumbers = std::make_shared<std::vector<uint32_t>>();
+
+	auto setup = [textureManager, modelManager, hitNumbers, missNumbers]()
+		{
+			if (*textureManager)
+				return true;
+
+			// テクスチャの格納場所は、リソースがあるものだけが使用中になるので、小さなバッファを全ての場所で共有する
+			Microsoft::WRL::ComPtr<ID3D12Device> device;
+			if (FAILED(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&device))))
+				return false;
+
+			Microsoft::WRL::ComPtr<ID3D12Resource> resource = CreateBufferResource(device, 256);
+
+			*textureManager = std::make_unique<TextureManager>();
+			*modelManager = std::make_unique<ModelManager>();
+
+			TextureManager& textures = **textureManager;
+			ModelManager& models = **modelManager;
+
+			std::vector<uint32_t> numbers;
+			for (uint32_t i = 0; i < textures.kNumTexture_; ++i)
+			{
+				// 読み込むときと同じように番号を割り当てる
+				int32_t slot = textures.AllocateSlot();
+				textures.textureResources_[slot] = resource;
+				numbers.push_back(textures.textureNumbers_[slot]);
+
+				// モデルも同じ番号で埋める
+				models.modelNumbers_[i] = textures.textureNumbers_[slot];
+				models.isLoad_[i] = true;
+			}
+
+			std::mt19937 random = MakeRandom();
+			std::uniform_int_distribution<size_t> distribution(0, numbers.size() - 1);
+			for (uint32_t i = 0; i < kNumInputs; ++i)
+			{
+				hitNumbers->push_back(numbers[distribution(random)]);
+			}
+
+			// 割り当てる番号は10000以下なので、それより大きいものは必ず外れる
+			for (uint32_t i = 0; i < kNumInputs; ++i)
+			{
+				missNumbers->push_back(10001 + i);
+			}
+
+			return true;
+		};
+
+	for (const auto& [numbers, label] : { std::pair{ hitNumbers, "hit" }, std::pair{ missNumbers, "miss" } })
+	{
+		std::shared_ptr<std::vector<uint32_t>> lookupNumbers = numbers;
+
+		runner.Add("Handle", engine::format("TextureManager::FindSlot {}", label), [textureManager, lookupNumbers](BenchmarkState& state)
+			{
+				TextureManager& textures = **textureManager;
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					for (uint32_t number : *lookupNumbers)
+					{
+						int32_t slot = textures.FindSlot(number);
+						DoNotOptimize(slot);
+					}
+				}
+				state.SetItemsPerIteration(lookupNumbers->size());
+			}, setup);
+
+		runner.Add("Handle", engine::format("ModelManager::FindSlot {}", label), [modelManager, lookupNumbers](BenchmarkState& state)
+			{
+				ModelManager& models = **modelManager;
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					for (uint32_t number : *lookupNumbers)
+					{
+						int32_t slot = models.FindSlot(number);
+						DoNotOptimize(slot);
+					}
+				}
+				state.SetItemsPerIteration(lookupNumbers->size());
+			}, setup);
+	}
+}
+#endif
+
+
+/*------------------------------------
+    描画のコマンド（GPUを使わない）
+------------------------------------*/
+
+/// <summary>
+/// 描画のコマンドを積む処理（Func/DrawRecord）を、NullRenderDeviceで登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderBenchmarks(BenchmarkRunner& runner)
+{
+	// 1フレームに積む描画の数
+	const uint32_t kNumDraws = 1024;
+
+	// モデルのサブメッシュの数と、サブメッシュごとのインデックスの数
+	const uint32_t kNumSubMeshes = 3;
+	const uint32_t kNumSubMeshIndices = 3000;
+
+	std::shared_ptr<NullRenderDevice> device = std::make_shared<NullRenderDevice>();
+
+	// ルートシグネチャ、PSO、テクスチャは、0でなければ何でもよい
+	DrawPass pass{};
+	pass.viewport = { 0.0f , 0.0f , 1280.0f , 720.0f , 0.0f , 1.0f };
+	pass.scissorRect = { 0 , 0 , 1280 , 720 };
+	pass.rootSignature = 0x1000;
+	pass.pipelineState = 0x2000;
+
+	// 読み込んだモデルの代わりに、解放しないバッファを作る
+	RenderBuffer vertexBuffer = device->CreateStaticBuffer(sizeof(VertexData) * kNumSubMeshIndices);
+	RenderBuffer indexBuffer = device->CreateStaticBuffer(sizeof(uint32_t) * kNumSubMeshIndices * kNumSubMeshes);
+
+	std::shared_ptr<std::vector<SubMesh>> subMeshes = std::make_shared<std::vector<SubMesh>>();
+	std::shared_ptr<std::vector<RenderHandle>> textureDescriptors = std::make_shared<std::vector<RenderHandle>>();
+	for (uint32_t i = 0; i < kNumSubMeshes; ++i)
+	{
+		subMeshes->push_back({ i * kNumSubMeshIndices , kNumSubMeshIndices , i });
+		textureDescriptors->push_back(0x3000 + i * 32);
+	}
+
+	// 描画ごとの姿勢
+	std::shared_ptr<std::vector<Transform3D>> transforms = std::make_shared<std::vector<Transform3D>>();
+	std::mt19937 random = MakeRandom();
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	for (uint32_t i = 0; i < kNumDraws; ++i)
+	{
+		transforms->push_back({ { 1.0f , 1.0f , 1.0f } , { distribution(random) , distribution(random) , distribution(random) } ,
+			{ distribution(random) , distribution(random) , distribution(random) } });
+	}
+
+	Matrix4x4 viewProjectionMatrix = Multiply(Make4x4InverseMatrix(Make4x4AffineMatrix({ 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , -30.0f })),
+		Make4x4PerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f));
+	DirectionalLight light = { { 1.0f , 1.0f , 1.0f , 1.0f } , { 0.0f , -1.0f , 0.0f } , 1.0f };
+
+	// 描画の種類ごとに、1フレーム分を積む
+	std::vector<std::pair<std::string, std::function<void()>>> frames;
+
+	frames.push_back({ "DrawModel", [=]()
+		{
+			RenderVertexBufferView vertexView = { vertexBuffer.gpuAddress , vertexBuffer.sizeInBytes , sizeof(VertexData) };
+			RenderIndexBufferView indexView = { indexBuffer.gpuAddress , indexBuffer.sizeInBytes };
+			for (const Transform3D& transform : *transforms)
+			{
+				Matrix4x4 worldViewProjectionMatrix = RecordModel(*device, pass, vertexView, indexView, *subMeshes, *textureDescriptors,
+					transform, viewProjectionMatrix, light);
+				DoNotOptimize(worldViewProjectionMatrix);
+			}
+		} });
+
+	frames.push_back({ "DrawSprite", [=]()
+		{
+			Vector2 corners[4] = { { 0.0f , 0.0f } , { 64.0f , 0.0f } , { 0.0f , 64.0f } , { 64.0f , 64.0f } };
+			SpriteRegion sprite = { 1 , { 0.0f , 0.0f } , { 0.25f , 0.25f } };
+			for (const Transform3D& transform : *transforms)
+			{
+				Matrix4x4 worldViewProjectionMatrix = RecordSprite(*device, pass, corners, transform, viewProjectionMatrix, sprite, textureDescriptors->front());
+				DoNotOptimize(worldViewProjectionMatrix);
+			}
+		} });
+
+	frames.push_back({ "DrawSphere 16", [=]()
+		{
+			for (const Transform3D& transform : *transforms)
+			{
+				Matrix4x4 worldViewProjectionMatrix = RecordSphere(*device, pass, 16, transform, viewProjectionMatrix, light, textureDescriptors->front());
+				DoNotOptimize(worldViewProjectionMatrix);
+			}
+		} });
+
+	for (const auto& [name, frame] : frames)
+	{
+		// 1フレームを積んで、誤りが無いことを確かめてから計測する
+		auto setup = [device, frame]()
+			{
+				device->ResetStats();
+				frame();
+				device->FinishFrame();
+
+				for (const std::string& error : device->GetErrors())
+				{
+					std::cout << "NullRenderDevice : " << error << std::endl;
+				}
+
+				return device->GetStats().numErrors == 0;
+			};
+
+		runner.Add("Render", engine::format("Null {} x{}", name, kNumDraws), [device, frame, kNumDraws](BenchmarkState& state)
+			{
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					frame();
+					uint64_t frameBufferBytes = device->FinishFrame();
+					DoNotOptimize(frameBufferBytes);
+				}
+				state.SetItemsPerIteration(kNumDraws);
+			}, setup);
+	}
+}
+
+
+/*---------------------------
+    レンダーグラフの組み立て
+---------------------------*/
+
+// 作り物のフレームのパスの数（影、Gバッファ、ライティング、ポストエフェクト、トーンマップ、UI、使われないデバッグ）
+static const uint32_t kNumShadowPasses = 4;
+static const uint32_t kNumPostPasses = 48;
+static const uint32_t kNumDebugPasses = 9;
+
+// 作り物のフレームのリソースの大きさ（2048x2048のD32、1280x720のRGBA8とRGBA16F）
+static const uint64_t kShadowMapSize = 2048ull * 2048 * 4;
+static const uint64_t kColorTargetSize = 1280ull * 720 * 4;
+static const uint64_t kHdrTargetSize = 1280ull * 720 * 8;
+
+/// <summary>
+/// 作り物のフレームのパスを組み立てる（デバッグのパスは、書いたものを誰も読まないので全て省かれる）
+/// </summary>
+/// <param name="graph">組み立てる先</param>
+static void BuildSyntheticRenderGraph(RenderGraph& graph)
+{
+	graph.Reset();
+
+	uint32_t backBuffer = graph.ImportResource("BackBuffer", 0x1000, RenderState::Present, RenderState::Present);
+
+	// 影
+	std::vector<uint32_t> shadowMaps;
+	for (uint32_t i = 0; i < kNumShadowPasses; ++i)
+	{
+		shadowMaps.push_back(graph.CreateTransientResource(engine::format("ShadowMap{}", i), kShadowMapSize));
+
+		uint32_t pass = graph.AddPass(engine::format("Shadow{}", i), nullptr);
+		graph.Write(pass, shadowMaps.back(), RenderState::DepthWrite);
+	}
+
+	// Gバッファ
+	uint32_t albedo = graph.CreateTransientResource("Albedo", kColorTargetSize);
+	uint32_t normal = graph.CreateTransientResource("Normal", kColorTargetSize);
+	uint32_t depth = graph.CreateTransientResource("Depth", kColorTargetSize);
+
+	uint32_t gbufferPass = graph.AddPass("GBuffer", nullptr);
+	graph.Write(gbufferPass, albedo, RenderState::RenderTarget);
+	graph.Write(gbufferPass, normal, RenderState::RenderTarget);
+	graph.Write(gbufferPass, depth, RenderState::DepthWrite);
+
+	// ライティング（ポストエフェクトも深度を読むので、読み込む状態が組み合わされる）
+	uint32_t hdr = graph.CreateTransientResource("HDR", kHdrTargetSize);
+
+	uint32_t lightingPass = graph.AddPass("Lighting", nullptr);
+	graph.Read(lightingPass, albedo, RenderState::PixelShaderResource);
+	graph.Read(lightingPass, normal, RenderState::PixelShaderResource);
+	graph.Read(lightingPass, depth, RenderState::PixelShaderResource);
+	for (uint32_t shadowMap : shadowMaps)
+	{
+		graph.Read(lightingPass, shadowMap, RenderState::PixelShaderResource);
+	}
+	graph.Write(lightingPass, hdr, RenderState::RenderTarget);
+
+	// ポストエフェクト（コンピュートで、前の結果を読んで次に書く）
+	uint32_t source = hdr;
+	for (uint32_t i = 0; i < kNumPostPasses; ++i)
+	{
+		uint32_t destination = graph.CreateTransientResource(engine::format("Post{}", i), kHdrTargetSize);
+
+		uint32_t pass = graph.AddPass(engine::format("Post{}", i), nullptr);
+		graph.Read(pass, source, RenderState::NonPixelShaderResource);
+		graph.Read(pass, depth, RenderState::NonPixelShaderResource);
+		graph.Write(pass, destination, RenderState::UnorderedAccess);
+
+		source = destination;
+	}
+
+	// トーンマップとUI
+	uint32_t tonemapPass = graph.AddPass("Tonemap", nullptr);
+	graph.Read(tonemapPass, source, RenderState::PixelShaderResource);
+	graph.Write(tonemapPass, backBuffer, RenderState::RenderTarget);
+
+	uint32_t uiPass = graph.AddPass("UI", nullptr);
+	graph.Write(uiPass, backBuffer, RenderState::RenderTarget);
+
+	// 使われないデバッグ表示
+	for (uint32_t i = 0; i < kNumDebugPasses; ++i)
+	{
+		uint32_t debugView = graph.CreateTransientResource(engine::format("DebugView{}", i), kColorTargetSize);
+
+		uint32_t pass = graph.AddPass(engine::format("Debug{}", i), nullptr);
+		graph.Read(pass, i % 2 == 0 ? depth : normal, RenderState::PixelShaderResource);
+		graph.Write(pass, debugView, RenderState::RenderTarget);
+	}
+}
+
+/// <summary>
+/// レンダーグラフの組み立てとコンパイル（GPUを使わない）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderGraphBenchmarks(BenchmarkRunner& runner)
+{
+	std::shared_ptr<RenderGraph> graph = std::make_shared<RenderGraph>();
+
+	// 計測するフレームを組み立てておく（省き方や重ね方は、TestのRenderGraphで確かめる）
+	auto setup = [graph]()
+		{
+			BuildSyntheticRenderGraph(*graph);
+			if (graph->Compile(std::cout) == false)
+				return false;
+
+			graph->ReportTransientMemory(std::cout);
+			return true;
+		};
+
+	std::string name = engine::format("Build+Compile {} passes", kNumShadowPasses + kNumPostPasses + kNumDebugPasses + 4);
+	runner.Add("RenderGraph", name, [graph](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				BuildSyntheticRenderGraph(*graph);
+				bool isCompiled = graph->Compile(std::cout);
+				DoNotOptimize(isCompiled);
+			}
+			state.SetItemsPerIteration(graph->GetNumPasses());
+		}, setup);
+
+	// 組み立て済みのものをコンパイルし直す
+	name = engine::format("Compile {} passes", kNumShadowPasses + kNumPostPasses + kNumDebugPasses + 4);
+	runner.Add("RenderGraph", name, [graph](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				bool isCompiled = graph->Compile(std::cout);
+				DoNotOptimize(isCompiled);
+			}
+			state.SetItemsPerIteration(graph->GetNumPasses());
+		});
+}
+
+
+/*-------------------------------------
+    リソースを重ねて置く（GPUを使わない）
+-------------------------------------*/
+
+/// <summary>
+/// 乱数で、使うパスの範囲と大きさを決めたリソースを作る
+/// </summary>
+/// <param name="random">乱数</param>
+/// <param name="numRequests">リソースの数</param>
+/// <param name="numPasses">パスの数</param>
+/// <param name="isSameSize">全て同じ大きさにするか</param>
+/// <returns>リソース</returns>
+static std::vector<AliasingRequest> MakeRandomAliasingRequests(std::mt19937& random, uint32_t numRequests, uint32_t numPasses, bool isSameSize)
+{
+	std::uniform_int_distribution<uint32_t> passDistribution(0, numPasses - 1);
+	std::uniform_int_distribution<uint32_t> lengthDistribution(0, numPasses / 8);
+	std::uniform_int_distribution<uint64_t> sizeDistribution(1, 16 * 1024 * 1024);
+	std::uniform_int_distribution<uint32_t> alignmentDistribution(0, 3);
+
+	std::vector<AliasingRequest> requests;
+	for (uint32_t i = 0; i < numRequests; ++i)
+	{
+		AliasingRequest request{};
+		request.firstPass = passDistribution(random);
+		request.lastPass = (std::min)(request.firstPass + lengthDistribution(random), numPasses - 1);
+
+		if (isSameSize)
+		{
+			request.sizeInBytes = kDefaultAliasingAlignment;
+			request.alignment = kDefaultAliasingAlignment;
+		}
+		else
+		{
+			// 4MB揃え（MSAA）も混ぜる
+			request.sizeInBytes = sizeDistribution(random);
+			request.alignment = alignmentDistribution(random) == 0 ? 4 * 1024 * 1024 : kDefaultAliasingAlignment;
+		}
+
+		requests.push_back(request);
+	}
+
+	return requests;
+}
+
+/// <summary>
+/// リソースを重ねて置く処理（Func/AliasingPlan）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAliasingBenchmarks(BenchmarkRunner& runner)
+{
+	const uint32_t kNumRequests = 256;
+	const uint32_t kNumPasses = 128;
+
+	std::shared_ptr<std::vector<AliasingRequest>> requests = std::make_shared<std::vector<AliasingRequest>>();
+
+	// 計測するリソースを作っておく（配置が正しいかは、TestのAliasingで確かめる）
+	auto setup = [requests, kNumRequests, kNumPasses]()
+		{
+			std::mt19937 random = MakeRandom();
+			*requests = MakeRandomAliasingRequests(random, kNumRequests, kNumPasses, false);
+			return true;
+		};
+
+	runner.Add("Aliasing", engine::format("Plan {} resources", kNumRequests), [requests](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				AliasingPlan plan = PlanAliasing(*requests);
+				DoNotOptimize(plan.heapSize);
+			}
+			state.SetItemsPerIteration(requests->size());
+		}, setup);
+}
+
+
+/*----------------------------------------
+    ヒープの切り分け（GPUを使わない）
+----------------------------------------*/
+
+/// <summary>
+/// ヒープの切り分け（Class/TlsfAllocator）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTlsfBenchmarks(BenchmarkRunner& runner)
+{
+	// 1フレームに確保する、描画ごとのバッファの数
+	const uint32_t kNumAllocations = 4096;
+
+	// テクスチャのヒープと同じ大きさ
+	const uint64_t kCapacity = 64 * 1024 * 1024;
+
+	std::shared_ptr<std::vector<uint64_t>> sizes = std::make_shared<std::vector<uint64_t>>();
+	std::shared_ptr<std::vector<uint32_t>> freeOrder = std::make_shared<std::vector<uint32_t>>();
+
+	// 定数バッファほどの大きさを確保し、ばらばらの順に解放する（状態が正しいかは、TestのTlsfで確かめる）
+	auto setup = [sizes, freeOrder, kNumAllocations]()
+		{
+			std::mt19937 random = MakeRandom();
+
+			std::uniform_int_distribution<uint64_t> sizeDistribution(64, 4096);
+			sizes->clear();
+			freeOrder->clear();
+			for (uint32_t i = 0; i < kNumAllocations; ++i)
+			{
+				sizes->push_back(sizeDistribution(random));
+				freeOrder->push_back(i);
+			}
+			std::shuffle(freeOrder->begin(), freeOrder->end(), random);
+
+			return true;
+		};
+
+	runner.Add("Tlsf", engine::format("Allocate+Free x{}", kNumAllocations), [sizes, freeOrder, kCapacity, kNumAllocations](BenchmarkState& state)
+		{
+			TlsfAllocator allocator(kCapacity);
+			std::vector<uint32_t> blocks(kNumAllocations);
+
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumAllocations; ++i)
+				{
+					uint64_t offset = 0;
+					blocks[i] = allocator.Allocate((*sizes)[i], 256, offset);
+					DoNotOptimize(offset);
+				}
+
+				for (uint32_t i : *freeOrder)
+				{
+					allocator.Free(blocks[i]);
+				}
+			}
+			state.SetItemsPerIteration(kNumAllocations);
+		}, setup);
+}
+
+
+/*--------------------------------------
+    .wavのストリーミング（XAudio2を使わない）
+--------------------------------------*/
+
+// ストリーミングで読む.wav（計測の前に作る）
+static const std::string kStreamFilename = kObjTiledDirectory + "/BenchmarkStream.wav";
+
+/// <summary>
+/// 乱数で決めた波形の.wavを書き出す（16bitステレオ。JUNKと、奇数の大きさのLISTを間に挟む）
+/// </summary>
+/// <param name="filePath">書き出す先</param>
+/// <param name="dataSize">波形データのバイト数</param>
+/// <param name="headerDataSize">ヘッダに書くバイト数（途中で切れたファイルを作るとき、dataSizeより大きくする）</param>
+/// <returns>書き出した波形データ</returns>
+static std::vector<uint8_t> WriteSyntheticWav(const std::string& filePath, uint32_t dataSize, uint32_t headerDataSize)
+{
+	std::mt19937 random = MakeRandom();
+	std::vector<uint8_t> data(dataSize);
+	for (uint8_t& byte : data)
+	{
+		byte = static_cast<uint8_t>(random());
+	}
+
+	WavStreamFormat format{};
+	format.formatTag = 1;
+	format.channels = 2;
+	format.samplesPerSec = 48000;
+	format.bitsPerSample = 16;
+	format.blockAlign = format.channels * format.bitsPerSample / 8;
+	format.avgBytesPerSec = format.samplesPerSec * format.blockAlign;
+
+	std::ofstream file(filePath, std::ios::binary);
+	auto writeChunkHeader = [&file](const char* id, uint32_t size)
+		{
+			file.write(id, 4);
+			file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		};
+
+	const char junk[10] = {};
+	const char list[5] = { 'I', 'N', 'F', 'O', 0 };
+
+	uint32_t riffSize = 4 + (8 + 16) + (8 + sizeof(junk)) + (8 + sizeof(list) + 1) + 8 + headerDataSize;
+	writeChunkHeader("RIFF", riffSize);
+	file.write("WAVE", 4);
+
+	writeChunkHeader("JUNK", sizeof(junk));
+	file.write(junk, sizeof(junk));
+
+	writeChunkHeader("fmt ", 16);
+	file.write(reinterpret_cast<const char*>(&format), 16);
+
+	writeChunkHeader("LIST", sizeof(list));
+	file.write(list, sizeof(list));
+	file.put(0);
+
+	writeChunkHeader("data", headerDataSize);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+	return data;
+}
+
+// 積まれたらすぐに再生し終えたことにする（読み込みだけを計測する）
+class DiscardStreamSink : public WavStreamSink
+{
+public:
+
+	// コンストラクタ
+	explicit DiscardStreamSink(WavStream* stream) : stream_(stream) {}
+
+	// バッファを再生する列に積む
+	void SubmitBuffer(const uint8_t* data, uint32_t sizeInBytes, bool isEndOfStream) override
+	{
+		DoNotOptimize(data[sizeInBytes - 1]);
+		DoNotOptimize(isEndOfStream);
+		stream_->OnBufferEnd();
+	}
+
+
+private:
+
+	WavStream* stream_ = nullptr;
+};
+
+/// <summary>
+/// .wavのストリーミング（Class/WavStream）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterWavStreamBenchmarks(BenchmarkRunner& runner)
+{
+	// 3分ほどの長さ（48kHz、16bitステレオ）
+	const uint32_t kDataSize = 48000 * 4 * 180;
+
+	// 計測する.wavを書き出しておく（流したものが正しいかは、TestのWavStreamで確かめる）
+	auto setup = [kDataSize]()
+		{
+			std::filesystem::create_directories(kObjTiledDirectory);
+			WriteSyntheticWav(kStreamFilename, kDataSize, kDataSize);
+			return true;
+		};
+
+	runner.Add("WavStream", engine::format("FillBuffers {}MB", kDataSize / (1024 * 1024)), [kDataSize](BenchmarkState& state)
+		{
+			WavStream stream;
+			bool isOpen = stream.Open(kStreamFilename);
+			assert(isOpen);
+
+			DiscardStreamSink sink(&stream);
+
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				// 読み込むスレッドを使わずに、終わりまで読む
+				stream.Start(&sink, false, false);
+				while (stream.IsFinished() == false)
+				{
+					stream.FillBuffers();
+				}
+			}
+			state.SetBytesPerIteration(kDataSize);
+		}, setup);
+}
+
+
+/*-------------------------------------
+    ボイスの使い回し（XAudio2を使わない）
+-------------------------------------*/
+
+/// <summary>
+/// ボイスの使い回し（Class/VoicePool）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterVoicePoolBenchmarks(BenchmarkRunner& runner)
+{
+	// 1フレームに鳴らす効果音の数
+	const uint32_t kNumPlays = 256;
+
+	runner.Add("VoicePool", engine::format("Acquire+Release x{}", kNumPlays), [kNumPlays](BenchmarkState& state)
+		{
+			const VoiceFormat kFormats[2] = { { 1 , 2 , 48000 , 4 , 16 } , { 1 , 1 , 44100 , 2 , 16 } };
+			VoicePool pool(32);
+
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				// 連打する効果音のように、鳴らしきれずに止めるものを含める
+				for (uint32_t i = 0; i < kNumPlays; ++i)
+				{
+					uint32_t sound = i % 16;
+					VoiceRequest request = pool.Acquire(kFormats[sound % 2], sound, static_cast<int32_t>(sound % 3), 3);
+					DoNotOptimize(request);
+
+					if (i % 2 == 0 && request.voiceIndex != VoicePool::kInvalidVoice)
+					{
+						pool.Release(request.voiceIndex);
+					}
+				}
+			}
+			state.SetItemsPerIteration(kNumPlays);
+		});
+}
+
+
+/*----------------
+    ログの書き込み
+----------------*/
+
+// ログを書き出すファイル
+static const std::string kLogSyncFilename = kObjTiledDirectory + "/BenchmarkSync.log";
+static const std::string kLogAsyncFilename = kObjTiledDirectory + "/BenchmarkAsync.log";
+
+/// <summary>
+/// 書き込むスレッドを並べて、全て終わるまで待つ
+/// </summary>
+/// <param name="numThreads">スレッドの数</param>
+/// <param name="body">スレッドごとの処理（引数はスレッドの番号）</param>
+static void RunLogThreads(uint32_t numThreads, const std::function<void(uint32_t)>& body)
+{
+	std::vector<std::thread> threads;
+	for (uint32_t thread = 0; thread < numThreads; ++thread)
+	{
+		threads.emplace_back(body, thread);
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/// <summary>
+/// ログの書き込み（Class/Logger）を、同期の書き出しと比べて登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterLogBenchmarks(BenchmarkRunner& runner)
+{
+	// 1回に書き込むログの数（スレッドごと）
+	const uint32_t kNumMessages = 1024;
+
+	auto setup = []()
+		{
+			std::filesystem::create_directories(kObjTiledDirectory);
+			return true;
+		};
+
+	for (uint32_t numThreads : { 1u , 4u })
+	{
+		// 以前の書き方（呼んだスレッドで書式にし、ロックしてendlで書き出す）
+		runner.Add("Log", engine::format("sync endl {} threads x{}", numThreads, kNumMessages), [numThreads, kNumMessages](BenchmarkState& state)
+			{
+				std::ofstream file(kLogSyncFilename);
+				std::mutex mutex;
+
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					RunLogThreads(numThreads, [&](uint32_t thread)
+						{
+							for (uint32_t i = 0; i < kNumMessages; ++i)
+							{
+								std::string message = engine::format("Benchmark : thread {} , message {} , value {:.3f}", thread, i, i * 0.5);
+
+								std::lock_guard<std::mutex> lock(mutex);
+								file << message << std::endl;
+							}
+						});
+				}
+				state.SetItemsPerIteration(uint64_t(numThreads) * kNumMessages);
+			}, setup);
+
+		// リングバッファに置くまで（Infoは満杯なら捨てるので、呼んだスレッドが待たされる時間だけを測る）
+		runner.Add("Log", engine::format("Write Info {} threads x{}", numThreads, kNumMessages), [numThreads, kNumMessages](BenchmarkState& state)
+			{
+				Logger logger;
+				logger.Start(kLogAsyncFilename, false);
+
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					RunLogThreads(numThreads, [&](uint32_t thread)
+						{
+							for (uint32_t i = 0; i < kNumMessages; ++i)
+							{
+								logger.Write(LogLevel::Info, "Benchmark : thread {} , message {} , value {:.3f}", thread, i, i * 0.5);
+							}
+						});
+				}
+
+				// 残りの書き出しは計測しない
+				state.PauseTiming();
+				logger.Stop();
+				state.ResumeTiming();
+
+				state.SetItemsPerIteration(uint64_t(numThreads) * kNumMessages);
+			}, setup);
+
+		// ファイルに書き出し終えるまで（Warningは捨てずに空くまで待つので、書き出すスレッドの速度で頭打ちになる）
+		runner.Add("Log", engine::format("Write+Flush Warning {} threads x{}", numThreads, kNumMessages), [numThreads, kNumMessages](BenchmarkState& state)
+			{
+				Logger logger;
+				logger.Start(kLogAsyncFilename, false);
+
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					RunLogThreads(numThreads, [&](uint32_t thread)
+						{
+							for (uint32_t i = 0; i < kNumMessages; ++i)
+							{
+								logger.Write(LogLevel::Warning, "Benchmark : thread {} , message {} , value {:.3f}", thread, i, i * 0.5);
+							}
+						});
+					logger.Flush();
+				}
+
+				state.PauseTiming();
+				logger.Stop();
+				state.ResumeTiming();
+
+				state.SetItemsPerIteration(uint64_t(numThreads) * kNumMessages);
+			}, setup);
+	}
+
+	// 最低の重要度より低いものは、書き込む前に弾かれる
+	runner.Add("Log", engine::format("Write filtered Debug x{}", kNumMessages), [kNumMessages](BenchmarkState& state)
+		{
+			Logger logger;
+			logger.SetMinLevel(LogLevel::Warning);
+
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumMessages; ++i)
+				{
+					logger.Write(LogLevel::Debug, "Benchmark : thread {} , message {} , value {:.3f}", 0, i, i * 0.5);
+				}
+			}
+			state.SetItemsPerIteration(kNumMessages);
+		});
+}
+
+
+/*-----------------------
+    フレームの計測の負荷
+-----------------------*/
+
+/// <summary>
+/// フレームの計測（Class/FrameProfiler）の、区間1つを記録する時間と、フレームごとに読む時間を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterProfilerBenchmarks(BenchmarkRunner& runner)
+{
+	// 1回に記録する区間の数
+	const uint32_t kNumScopes = 1024;
+
+	// 計測するとき（時刻を2回取り、リングバッファに書き込む）と、実行中に止めたとき（フラグを見るだけ）
+	for (bool isEnabled : { true , false })
+	{
+		runner.Add("Profiler", engine::format("PROFILE_SCOPE {} x{}", isEnabled ? "enabled" : "disabled", kNumScopes), [isEnabled, kNumScopes](BenchmarkState& state)
+			{
+				FrameProfiler::SetEnabled(isEnabled);
+
+				for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+				{
+					for (uint32_t i = 0; i < kNumScopes; ++i)
+					{
+						PROFILE_SCOPE("BenchmarkScope");
+						DoNotOptimize(i);
+					}
+				}
+				state.SetItemsPerIteration(kNumScopes);
+
+				FrameProfiler::SetEnabled(true);
+			});
+	}
+
+	// 区間1つで2回取る時刻（記録の時間のうち、時計の分）
+	runner.Add("Profiler", engine::format("GetTicks x{}", kNumScopes * 2), [kNumScopes](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumScopes * 2; ++i)
+				{
+					int64_t ticks = FrameProfiler::GetTicks();
+					DoNotOptimize(ticks);
+				}
+			}
+			state.SetItemsPerIteration(kNumScopes);
+		});
+
+	// 入れ子にしたとき（深さを数える分が増える）
+	runner.Add("Profiler", engine::format("PROFILE_SCOPE nested 4 x{}", kNumScopes / 4), [kNumScopes](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				for (uint32_t i = 0; i < kNumScopes / 4; ++i)
+				{
+					PROFILE_SCOPE("BenchmarkOuter");
+					{
+						PROFILE_SCOPE("BenchmarkMiddle");
+						{
+							PROFILE_SCOPE("BenchmarkInner");
+							{
+								PROFILE_SCOPE("BenchmarkLeaf");
+								DoNotOptimize(i);
+							}
+						}
+					}
+				}
+			}
+			state.SetItemsPerIteration(kNumScopes);
+		});
+
+	// フレームの最初に、前のフレームの区間を読んでフレームに移す（記録は計測しない）
+	runner.Add("Profiler", engine::format("NewFrame {} scopes", kNumScopes), [kNumScopes](BenchmarkState& state)
+		{
+			for (uint64_t iteration = 0; iteration < state.GetIterations(); ++iteration)
+			{
+				state.PauseTiming();
+				for (uint32_t i = 0; i < kNumScopes; ++i)
+				{
+					PROFILE_SCOPE("BenchmarkScope");
+				}
+				state.ResumeTiming();
+
+				FrameProfiler::NewFrame();
+			}
+			state.SetItemsPerIteration(kNumScopes);
+		});
+}
+
+
+/*---------------
+    全てのケース
+---------------*/
+
+/// <summary>
+/// 全てのケースを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAllBenchmarks(BenchmarkRunner& runner)
+{
+	RegisterMatrixBenchmarks(runner);
+	RegisterObjBenchmarks(runner);
+	RegisterMeshFileBenchmarks(runner);
+#ifdef _WIN32
+	RegisterSoundBenchmarks(runner);
+	RegisterTextureBenchmarks(runner);
+	HandleLookupBenchmark::Register(runner);
+#endif
+	RegisterRenderBenchmarks(runner);
+	RegisterRenderGraphBenchmarks(runner);
+	RegisterAliasingBenchmarks(runner);
+	RegisterTlsfBenchmarks(runner);
+	RegisterWavStreamBenchmarks(runner);
+	RegisterVoicePoolBenchmarks(runner);
+	RegisterLogBenchmarks(runner);
+	RegisterProfilerBenchmarks(runner);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <memory>
+#include <random>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include "../../Class/BenchmarkRunner/BenchmarkRunner.h"
+#include "../../../Class/Engine/Func/Matrix/Matrix.h"
+#include "../../../Class/Engine/Func/ModelData/ModelData.h"
+#include "../../../Class/Engine/Func/ObjParser/ObjParser.h"
+#include "../../../Class/Engine/Func/MeshFile/MeshFile.h"
+#include "../../../Class/Engine/Func/DrawRecord/DrawRecord.h"
+#include "../../../Class/Engine/Class/RenderDevice/NullRenderDevice/NullRenderDevice.h"
+#include "../../../Class/Engine/Class/RenderGraph/RenderGraph.h"
+#include "../../../Class/Engine/Class/TlsfAllocator/TlsfAllocator.h"
+#include "../../../Class/Engine/Class/WavStream/WavStream.h"
+#include "../../../Class/Engine/Class/VoicePool/VoicePool.h"
+#include "../../../Class/Engine/Class/Logger/Logger.h"
+#include "../../../Class/Engine/Class/FrameProfiler/FrameProfiler.h"
+
+// DirectXTex、XAudio2、D3D12を使うケースは、Windowsだけで計測する（CMakeではビルドしない）
+#ifdef _WIN32
+#include "../../../Class/Engine/Func/Create/Create.h"
+#include "../../../Class/Engine/Class/Sound/Sound.h"
+#include "../../../Class/Engine/Class/TextureManager/TextureManager.h"
+#include "../../../Class/Engine/Class/ModelManager/ModelManager.h"
+#include "../../../Class/Engine/externals/DirectXTex/DirectXTex.h"
+#endif
+
+/// <summary>
+/// 行列の計算（Func/Matrix）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMatrixBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// Objファイルの読み込み（monky.objと、それを複製して大きくしたもの）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterObjBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// メッシュファイルのクックと、マップして読む処理（Func/MeshFile）を、monky.objを複製したもので登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMeshFileBenchmarks(BenchmarkRunner& runner);
+
+#ifdef _WIN32
+/// <summary>
+/// .wavの読み込み（Resources/Sounds/Seの全てのファイル）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterSoundBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// ミップマップの生成、フォーマットの変換、ブロック圧縮（作った画像）と、テクスチャのクック、キャッシュの読み込み、BC7の画質（Resources/Textures）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTextureBenchmarks(BenchmarkRunner& runner);
+#endif
+
+/// <summary>
+/// 描画のコマンドを積む処理（Func/DrawRecord）を、GPUを使わないNullRenderDeviceで登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// レンダーグラフの組み立てとコンパイル（GPUを使わない）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderGraphBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// リソースを重ねて置く処理（Func/AliasingPlan）を、乱数で作った組で登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAliasingBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// ヒープの切り分け（Class/TlsfAllocator）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTlsfBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// .wavのストリーミング（Class/WavStream）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterWavStreamBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// ボイスの使い回し（Class/VoicePool）を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterVoicePoolBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// ログの書き込み（Class/Logger）を、同期の書き出しと比べて登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterLogBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// フレームの計測（Class/FrameProfiler）の、区間1つを記録する時間と、フレームごとに読む時間を登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterProfilerBenchmarks(BenchmarkRunner& runner);
+
+/// <summary>
+/// 全てのケースを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAllBenchmarks(BenchmarkRunner& runner);
+
+#ifdef _WIN32
+// マネージャの番号から格納場所を探す処理を、GPUで読み込まずに計測する（TextureManagerとModelManagerのfriend）
+class HandleLookupBenchmark
+{
+public:
+
+	// ケースを登録する
+	static void Register(BenchmarkRunner& runner);
+};
+#endif
@@ -0,0 +1,105 @@
+#include <iostream>
+#include "Func/BenchmarkCases/BenchmarkCases.h"
+
+// 結果を書き出すディレクトリ
+static const std::string kResultDirectory = "Benchmark/Results";
+
+// 使い方
+static void PrintUsage()
+{
+	std::cout << "Benchmark [--filter text] [--out file.json] [--label text] [--samples n] [--min-time ms] [--list]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+	// ミップマップの生成などで、DirectXTexがWICを使う
+	HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
+	assert(SUCCEEDED(hr));
+#endif
+
+
+	/*------------------
+	    引数を読み取る
+	------------------*/
+
+	std::string filter;
+	std::string label = "local";
+	std::string outputPath;
+	bool isListOnly = false;
+
+	BenchmarkRunner runner;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--filter" && hasValue)
+		{
+			filter = argv[++i];
+		}
+		else if (argument == "--out" && hasValue)
+		{
+			outputPath = argv[++i];
+		}
+		else if (argument == "--label" && hasValue)
+		{
+			label = argv[++i];
+		}
+		else if (argument == "--samples" && hasValue)
+		{
+			runner.SetNumSamples(uint32_t(std::stoul(argv[++i])));
+		}
+		else if (argument == "--min-time" && hasValue)
+		{
+			runner.SetMinSampleMilliseconds(std::stod(argv[++i]));
+		}
+		else if (argument == "--list")
+		{
+			isListOnly = true;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// 指定が無ければ、日時の名前で書き出す（リリースごとに残して比べる）
+	if (outputPath.empty())
+	{
+		std::filesystem::create_directories(kResultDirectory);
+		outputPath = engine::format("{}/{:%Y%m%d_%H%M%S}.json", kResultDirectory,
+			std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+	}
+
+
+	/*---------------
+	    計測する
+	---------------*/
+
+	RegisterAllBenchmarks(runner);
+
+	if (isListOnly)
+	{
+		runner.List(std::cout, filter);
+		return 0;
+	}
+
+	runner.Run(std::cout, filter);
+
+	if (runner.WriteJson(outputPath, label) == false)
+	{
+		std::cout << "failed to write " << outputPath << std::endl;
+		return 1;
+	}
+
+	std::cout << "wrote " << outputPath << std::endl;
+
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,147 @@
+#include "AssetArchive.h"
+
+// アーカイブを開いて、目次を確かめる（壊れていればfalse）
+bool AssetArchive::Open(const std::string& filePath)
+{
+	Close();
+
+	if (file_.Open(filePath) == false)
+		return false;
+
+	const uint8_t* data = file_.GetData();
+	uint64_t size = file_.GetSize();
+
+	// ヘッダ
+	if (size < sizeof(AssetArchiveHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const AssetArchiveHeader* header = reinterpret_cast<const AssetArchiveHeader*>(data);
+	if (header->magic != kAssetArchiveMagic || header->version != kAssetArchiveVersion)
+	{
+		Close();
+		return false;
+	}
+
+	// 目次がファイルの中にあること
+	uint64_t entriesSize = uint64_t(header->numEntries) * sizeof(AssetArchiveEntry);
+	if (header->entriesOffset > size || entriesSize > size - header->entriesOffset || header->entriesOffset % alignof(AssetArchiveEntry) != 0 ||
+		header->namesOffset > size || header->namesSize > size - header->namesOffset)
+	{
+		Close();
+		return false;
+	}
+
+	const AssetArchiveEntry* entries = reinterpret_cast<const AssetArchiveEntry*>(data + header->entriesOffset);
+
+	for (uint32_t i = 0; i < header->numEntries; ++i)
+	{
+		const AssetArchiveEntry& entry = entries[i];
+
+		// 中身とパスがファイルの中にあること
+		if (entry.offset > size || entry.storedSize > size - entry.offset ||
+			uint64_t(entry.nameOffset) + entry.nameLength > header->namesSize)
+		{
+			Close();
+			return false;
+		}
+
+		// 圧縮していないものは、格納しているバイト数がそのまま中身のバイト数
+		if (entry.compression > kAssetCompressionLZ4 || (entry.compression == kAssetCompressionNone && entry.storedSize != entry.size))
+		{
+			Close();
+			return false;
+		}
+
+		// 二分探索できるように並んでいること
+		if (i > 0 && entries[i - 1].pathHash > entry.pathHash)
+		{
+			Close();
+			return false;
+		}
+	}
+
+	filePath_ = filePath;
+	header_ = header;
+	entries_ = entries;
+	names_ = reinterpret_cast<const char*>(data + header->namesOffset);
+
+	return true;
+}
+
+// 閉じる
+void AssetArchive::Close()
+{
+	file_.Close();
+	filePath_.clear();
+	header_ = nullptr;
+	entries_ = nullptr;
+	names_ = nullptr;
+}
+
+// パスからエントリを探す（無ければnullptr）
+const AssetArchiveEntry* AssetArchive::FindEntry(const std::string& filePath) const
+{
+	if (header_ == nullptr)
+		return nullptr;
+
+	std::string path = NormalizePath(filePath);
+	uint64_t pathHash = HashString(path);
+
+	const AssetArchiveEntry* begin = entries_;
+	const AssetArchiveEntry* end = entries_ + header_->numEntries;
+
+	const AssetArchiveEntry* entry = std::lower_bound(begin, end, pathHash,
+		[](const AssetArchiveEntry& entry, uint64_t hash) { return entry.pathHash < hash; });
+
+	// ハッシュ値が同じものの中から、パスが一致するものを探す
+	for (; entry != end && entry->pathHash == pathHash; ++entry)
+	{
+		if (entry->nameLength == path.size() && std::memcmp(names_ + entry->nameOffset, path.data(), path.size()) == 0)
+			return entry;
+	}
+
+	return nullptr;
+}
+
+// エントリの中身を読む（圧縮されていれば展開する）
+bool AssetArchive::Read(const AssetArchiveEntry& entry, std::vector<uint8_t>& bytes) const
+{
+	std::span<const uint8_t> stored = GetStoredData(entry);
+
+	bytes.resize(size_t(entry.size));
+
+	if (entry.compression == kAssetCompressionLZ4)
+		return DecompressLZ4Block(stored.data(), stored.size(), bytes.data(), bytes.size());
+
+	std::memcpy(bytes.data(), stored.data(), stored.size());
+	return true;
+}
+
+// エントリの格納している中身を、コピーせずに参照する
+std::span<const uint8_t> AssetArchive::GetStoredData(const AssetArchiveEntry& entry) const
+{
+	return std::span<const uint8_t>(file_.GetData() + entry.offset, size_t(entry.storedSize));
+}
+
+// エントリのパスを取得する
+std::string AssetArchive::GetEntryPath(const AssetArchiveEntry& entry) const
+{
+	return std::string(names_ + entry.nameOffset, entry.nameLength);
+}
+
+// アーカイブの中で使うパスの書き方にそろえる
+std::string AssetArchive::NormalizePath(const std::string& filePath)
+{
+	std::string path = std::filesystem::path(filePath).lexically_normal().generic_string();
+
+	// 先頭の"./"は無いものとする
+	while (path.size() >= 2 && path[0] == '.' && path[1] == '/')
+	{
+		path.erase(0, 2);
+	}
+
+	return path;
+}
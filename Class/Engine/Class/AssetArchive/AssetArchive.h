@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "../MappedFile/MappedFile.h"
+#include "../../Func/Hash/Hash.h"
+#include "../../Func/Compression/Compression.h"
+
+// アーカイブの識別子（"PAK1"）
+const uint32_t kAssetArchiveMagic = 0x314B4150;
+
+// アーカイブのバージョン（形式を変えたら更新する）
+const uint32_t kAssetArchiveVersion = 1;
+
+// 各エントリの中身の先頭の揃え
+const uint32_t kAssetArchiveAlignment = 16;
+
+// エントリの圧縮の種類
+const uint32_t kAssetCompressionNone = 0;
+const uint32_t kAssetCompressionLZ4 = 1;
+
+// アーカイブのヘッダ
+typedef struct AssetArchiveHeader
+{
+	// 識別子
+	uint32_t magic;
+
+	// バージョン
+	uint32_t version;
+
+	// エントリの数
+	uint32_t numEntries;
+
+	// 予約
+	uint32_t reserved;
+
+	// エントリの表の位置
+	uint64_t entriesOffset;
+
+	// パスの文字列を並べた場所の位置とバイト数
+	uint64_t namesOffset;
+	uint64_t namesSize;
+}AssetArchiveHeader;
+
+// アーカイブのエントリ（パスのハッシュ値の順に並べる）
+typedef struct AssetArchiveEntry
+{
+	// パスのハッシュ値
+	uint64_t pathHash;
+
+	// 展開後の中身のハッシュ値
+	uint64_t contentHash;
+
+	// 中身の位置
+	uint64_t offset;
+
+	// 格納しているバイト数
+	uint64_t storedSize;
+
+	// 展開後のバイト数
+	uint64_t size;
+
+	// パスの文字列の位置と長さ
+	uint32_t nameOffset;
+	uint32_t nameLength;
+
+	// 圧縮の種類
+	uint32_t compression;
+
+	// 予約
+	uint32_t reserved;
+}AssetArchiveEntry;
+
+// 1つのファイルにまとめたアセットを、マップして読む
+class AssetArchive
+{
+public:
+
+	// アーカイブを開いて、目次を確かめる（壊れていればfalse）
+	bool Open(const std::string& filePath);
+
+	// 閉じる
+	void Close();
+
+	// パスからエントリを探す（無ければnullptr）
+	const AssetArchiveEntry* FindEntry(const std::string& filePath) const;
+
+	// エントリの中身を読む（圧縮されていれば展開する）
+	bool Read(const AssetArchiveEntry& entry, std::vector<uint8_t>& bytes) const;
+
+	// エントリの格納している中身を、コピーせずに参照する
+	std::span<const uint8_t> GetStoredData(const AssetArchiveEntry& entry) const;
+
+	// エントリのパスを取得する
+	std::string GetEntryPath(const AssetArchiveEntry& entry) const;
+
+	// アーカイブの中で使うパスの書き方にそろえる
+	static std::string NormalizePath(const std::string& filePath);
+
+	// Getter
+	bool IsOpen() const { return header_ != nullptr; }
+	uint32_t GetNumEntries() const { return header_ ? header_->numEntries : 0; }
+	const AssetArchiveEntry& GetEntry(uint32_t index) const { return entries_[index]; }
+	const std::string& GetFilePath() const { return filePath_; }
+
+
+private:
+
+	// マップしたアーカイブ
+	MappedFile file_;
+
+	// ファイルパス
+	std::string filePath_;
+
+	// ヘッダ
+	const AssetArchiveHeader* header_ = nullptr;
+
+	// エントリの表
+	const AssetArchiveEntry* entries_ = nullptr;
+
+	// パスの文字列
+	const char* names_ = nullptr;
+};
@@ -0,0 +1,164 @@
+#include "AssetFile.h"
+
+// 読む範囲を設定する
+void AssetStreamBuffer::SetRange(const uint8_t* data, size_t size)
+{
+	// 読むだけなので、constを外しても書き換えない
+	char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+	setg(begin, begin, begin + size);
+}
+
+// 読み取り位置を動かす
+AssetStreamBuffer::pos_type AssetStreamBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::in) == 0)
+		return pos_type(off_type(-1));
+
+	off_type base = 0;
+	if (direction == std::ios_base::cur)
+	{
+		base = gptr() - eback();
+	}
+	else if (direction == std::ios_base::end)
+	{
+		base = egptr() - eback();
+	}
+
+	off_type position = base + offset;
+	if (position < 0 || position > egptr() - eback())
+		return pos_type(off_type(-1));
+
+	setg(eback(), eback() + position, egptr());
+	return pos_type(position);
+}
+
+// 読み取り位置を動かす
+AssetStreamBuffer::pos_type AssetStreamBuffer::seekpos(pos_type position, std::ios_base::openmode which)
+{
+	return seekoff(off_type(position), std::ios_base::beg, which);
+}
+
+// ファイルを開く（どこにも無ければfalse）
+bool AssetFile::Open(const std::string& filePath)
+{
+	Close();
+
+	/*------------------------------
+	    マウントしたアーカイブから探す
+	------------------------------*/
+
+	const AssetArchive* archive = nullptr;
+	const AssetArchiveEntry* entry = FindArchiveEntry(filePath, &archive);
+
+	if (entry)
+	{
+		if (entry->compression == kAssetCompressionNone)
+		{
+			// 圧縮していなければ、マップしたアーカイブをそのまま参照する
+			std::span<const uint8_t> stored = archive->GetStoredData(*entry);
+			data_ = stored.data();
+			size_ = stored.size();
+		}
+		else
+		{
+			if (archive->Read(*entry, bytes_) == false)
+				return false;
+
+			data_ = bytes_.data();
+			size_ = bytes_.size();
+		}
+
+		isFromArchive_ = true;
+	}
+
+
+	/*------------------------------
+	    無ければディスクから開く
+	------------------------------*/
+
+	else
+	{
+		if (mappedFile_.Open(filePath) == false)
+			return false;
+
+		data_ = mappedFile_.GetData();
+		size_ = mappedFile_.GetSize();
+	}
+
+	isOpen_ = true;
+
+	streamBuffer_.SetRange(data_, size_);
+	stream_.clear();
+
+	return true;
+}
+
+// 閉じる
+void AssetFile::Close()
+{
+	mappedFile_.Close();
+	bytes_.clear();
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+	isFromArchive_ = false;
+
+	streamBuffer_.SetRange(nullptr, 0);
+	stream_.clear();
+}
+
+// アーカイブをマウントする（後からマウントしたものを優先する）
+void AssetFile::MountArchive(const AssetArchive* archive)
+{
+	UnmountArchive(archive);
+	archives_.push_back(archive);
+}
+
+// アーカイブのマウントを解除する
+void AssetFile::UnmountArchive(const AssetArchive* archive)
+{
+	archives_.erase(std::remove(archives_.begin(), archives_.end(), archive), archives_.end());
+}
+
+// ファイルがアーカイブかディスクにあるかどうか
+bool AssetFile::Exists(const std::string& filePath)
+{
+	const AssetArchive* archive = nullptr;
+	if (FindArchiveEntry(filePath, &archive))
+		return true;
+
+	return std::filesystem::is_regular_file(filePath);
+}
+
+// 中身が変わったら変わる値を取得する（アーカイブなら中身のハッシュ値、ディスクならバイト数と更新日時）
+uint64_t AssetFile::GetStamp(const std::string& filePath)
+{
+	const AssetArchive* archive = nullptr;
+	const AssetArchiveEntry* entry = FindArchiveEntry(filePath, &archive);
+
+	if (entry)
+		return entry->contentHash;
+
+	uint64_t fileSize = std::filesystem::file_size(filePath);
+	int64_t writeTime = std::filesystem::last_write_time(filePath).time_since_epoch().count();
+
+	uint64_t hash = HashBytes(&fileSize, sizeof(fileSize));
+	return HashBytes(&writeTime, sizeof(writeTime), hash);
+}
+
+// マウントしたアーカイブからエントリを探す
+const AssetArchiveEntry* AssetFile::FindArchiveEntry(const std::string& filePath, const AssetArchive** archive)
+{
+	// 後からマウントしたものを優先する
+	for (auto it = archives_.rbegin(); it != archives_.rend(); ++it)
+	{
+		const AssetArchiveEntry* entry = (*it)->FindEntry(filePath);
+		if (entry)
+		{
+			*archive = *it;
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <istream>
+#include <streambuf>
+#include <filesystem>
+#include <algorithm>
+#include "../AssetArchive/AssetArchive.h"
+#include "../MappedFile/MappedFile.h"
+#include "../../Func/Hash/Hash.h"
+
+// 読み込んだバイト列を、コピーせずにストリームとして読むためのバッファ
+class AssetStreamBuffer : public std::streambuf
+{
+public:
+
+	// 読む範囲を設定する
+	void SetRange(const uint8_t* data, size_t size);
+
+
+protected:
+
+	// 読み取り位置を動かす
+	pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+};
+
+// アセットのファイルを開く（マウントしたアーカイブにあればそこから、無ければディスクから読む）
+class AssetFile
+{
+public:
+
+	// コンストラクタ
+	AssetFile() : stream_(&streamBuffer_) {}
+
+	// 同じファイルを2回閉じないように、コピーはしない
+	AssetFile(const AssetFile&) = delete;
+	AssetFile& operator=(const AssetFile&) = delete;
+
+	// ファイルを開く（どこにも無ければfalse）
+	bool Open(const std::string& filePath);
+
+	// 閉じる
+	void Close();
+
+	// 中身をストリームとして読む
+	std::istream& GetStream() { return stream_; }
+
+	// Getter
+	const uint8_t* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+	bool IsOpen() const { return isOpen_; }
+	bool IsFromArchive() const { return isFromArchive_; }
+
+	// アーカイブをマウントする（後からマウントしたものを優先する）
+	static void MountArchive(const AssetArchive* archive);
+
+	// アーカイブのマウントを解除する
+	static void UnmountArchive(const AssetArchive* archive);
+
+	// ファイルがアーカイブかディスクにあるかどうか
+	static bool Exists(const std::string& filePath);
+
+	// 中身が変わったら変わる値を取得する（アーカイブなら中身のハッシュ値、ディスクならバイト数と更新日時）
+	static uint64_t GetStamp(const std::string& filePath);
+
+
+private:
+
+	// マウントしたアーカイブからエントリを探す
+	static const AssetArchiveEntry* FindArchiveEntry(const std::string& filePath, const AssetArchive** archive);
+
+	// マウントしたアーカイブ
+	static inline std::vector<const AssetArchive*> archives_;
+
+	// ディスクから開いたファイル
+	MappedFile mappedFile_;
+
+	// アーカイブで圧縮されていたものを展開した中身
+	std::vector<uint8_t> bytes_;
+
+	// 中身の先頭
+	const uint8_t* data_ = nullptr;
+
+	// バイト数
+	size_t size_ = 0;
+
+	// 開いているかどうか
+	bool isOpen_ = false;
+
+	// アーカイブから開いたかどうか
+	bool isFromArchive_ = false;
+
+	// ストリーム
+	AssetStreamBuffer streamBuffer_;
+	std::istream stream_;
+};
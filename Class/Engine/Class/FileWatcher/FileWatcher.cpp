@@ -0,0 +1,261 @@
+#include "FileWatcher.h"
+
+// デストラクタ
+FileWatcher::~FileWatcher()
+{
+	Clear();
+}
+
+// 変更を受け取り、最後の変更から一定時間たったファイルのパスを返す（保存中の連続した変更を1回にまとめる）
+std::vector<std::string> FileWatcher::Update(double currentTime)
+{
+	PollEvents(currentTime);
+
+	std::vector<std::string> changedPaths;
+
+	for (auto it = pendingChanges_.begin(); it != pendingChanges_.end();)
+	{
+		if (currentTime - it->second < debounceSeconds_)
+		{
+			++it;
+			continue;
+		}
+
+		changedPaths.push_back(it->first);
+		it = pendingChanges_.erase(it);
+	}
+
+	// 毎回同じ順に読み込み直すように、並べておく
+	std::sort(changedPaths.begin(), changedPaths.end());
+
+	return changedPaths;
+}
+
+// 変更があったことにする（監視の仕組みを通さずに、まとめる処理だけを使う）
+void FileWatcher::AddChange(const std::string& filePath, double currentTime)
+{
+	// 読み込んだときのパスと比べられるように、書き方をそろえる
+	std::string path = std::filesystem::path(filePath).lexically_normal().generic_string();
+	pendingChanges_[path] = currentTime;
+}
+
+#ifdef _WIN32
+
+// ディレクトリを、中のディレクトリも含めて監視する（監視できなければfalse）
+bool FileWatcher::AddDirectory(const std::string& directoryPath)
+{
+	std::wstring directoryPathW = ConvertString(directoryPath);
+
+	HANDLE handle = CreateFileW(directoryPathW.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	WatchedDirectory* directory = new WatchedDirectory{};
+	directory->path = directoryPath;
+	directory->handle = handle;
+	directory->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+	if (directory->overlapped.hEvent == nullptr || BeginRead(directory) == false)
+	{
+		if (directory->overlapped.hEvent)
+		{
+			CloseHandle(directory->overlapped.hEvent);
+		}
+
+		CloseHandle(handle);
+		delete directory;
+		return false;
+	}
+
+	directories_.push_back(directory);
+	return true;
+}
+
+// 全ての監視を止める
+void FileWatcher::Clear()
+{
+	for (WatchedDirectory* directory : directories_)
+	{
+		// 受け取り中の通知を取り消して、終わるのを待ってから閉じる
+		CancelIoEx(directory->handle, &directory->overlapped);
+
+		DWORD bytes = 0;
+		GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+
+		CloseHandle(directory->overlapped.hEvent);
+		CloseHandle(directory->handle);
+		delete directory;
+	}
+
+	directories_.clear();
+	pendingChanges_.clear();
+}
+
+// 監視しているディレクトリの数
+uint32_t FileWatcher::GetNumDirectories() const
+{
+	return uint32_t(directories_.size());
+}
+
+// 次の通知の受け取りを始める
+bool FileWatcher::BeginRead(WatchedDirectory* directory)
+{
+	ResetEvent(directory->overlapped.hEvent);
+
+	BOOL isStarted = ReadDirectoryChangesW(directory->handle, directory->buffer, sizeof(directory->buffer), TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+		nullptr, &directory->overlapped, nullptr);
+
+	return isStarted != FALSE;
+}
+
+// OSから変更の通知を受け取る
+void FileWatcher::PollEvents(double currentTime)
+{
+	for (WatchedDirectory* directory : directories_)
+	{
+		// 待たずに、届いている通知だけを受け取る
+		DWORD bytes = 0;
+		if (GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, FALSE) == FALSE)
+			continue;
+
+		// 通知が多すぎてあふれたときは、何が変わったか分からないので取りこぼす
+		if (bytes > 0)
+		{
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(directory->buffer);
+
+			while (true)
+			{
+				const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data);
+
+				// 書き込み、作成、名前を変えて置き換えたものを変更とする
+				if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+				{
+					std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+					AddChange(directory->path + "/" + ConvertString(fileName), currentTime);
+				}
+
+				if (info->NextEntryOffset == 0)
+					break;
+
+				data += info->NextEntryOffset;
+			}
+		}
+
+		BeginRead(directory);
+	}
+}
+
+#else
+
+// ディレクトリを、中のディレクトリも含めて監視する（監視できなければfalse）
+bool FileWatcher::AddDirectory(const std::string& directoryPath)
+{
+	if (inotify_ < 0)
+	{
+		inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotify_ < 0)
+			return false;
+	}
+
+	// inotifyは中のディレクトリを監視しないので、1つずつ加える
+	if (AddWatch(directoryPath) == false)
+		return false;
+
+	std::error_code errorCode;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directoryPath, errorCode))
+	{
+		if (entry.is_directory())
+		{
+			AddWatch(entry.path().generic_string());
+		}
+	}
+
+	return true;
+}
+
+// 全ての監視を止める
+void FileWatcher::Clear()
+{
+	if (inotify_ >= 0)
+	{
+		close(inotify_);
+		inotify_ = -1;
+	}
+
+	watchPaths_.clear();
+	pendingChanges_.clear();
+}
+
+// 監視しているディレクトリの数
+uint32_t FileWatcher::GetNumDirectories() const
+{
+	return uint32_t(watchPaths_.size());
+}
+
+// 中のディレクトリを1つ監視に加える
+bool FileWatcher::AddWatch(const std::string& directoryPath)
+{
+	int watch = inotify_add_watch(inotify_, directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (watch < 0)
+		return false;
+
+	watchPaths_[watch] = directoryPath;
+	return true;
+}
+
+// OSから変更の通知を受け取る
+void FileWatcher::PollEvents(double currentTime)
+{
+	if (inotify_ < 0)
+		return;
+
+	alignas(inotify_event) char buffer[16384];
+
+	while (true)
+	{
+		ssize_t length = read(inotify_, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			auto watch = watchPaths_.find(event->wd);
+			if (watch == watchPaths_.end() || event->len == 0)
+				continue;
+
+			std::string path = watch->second + "/" + event->name;
+
+			// 作られたディレクトリは監視に加え、中のファイルは書き終わったときに通知される
+			// 監視に加えるまでに書かれたファイルは通知されないので、中にあるものを変更とする
+			if (event->mask & IN_ISDIR)
+			{
+				if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && AddDirectory(path))
+				{
+					std::error_code errorCode;
+					for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path, errorCode))
+					{
+						if (entry.is_regular_file())
+						{
+							AddChange(entry.path().generic_string(), currentTime);
+						}
+					}
+				}
+
+				continue;
+			}
+
+			// 作っただけのファイルは、書き終わったとき（IN_CLOSE_WRITE）に変更とする
+			if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				AddChange(path, currentTime);
+			}
+		}
+	}
+}
+
+#endif
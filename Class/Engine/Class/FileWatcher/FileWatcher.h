@@ -0,0 +1,102 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "../../Func/StringInfo/StringInfo.h"
+#else
+#include <sys/inotify.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// ディレクトリの中のファイルの変更を監視する
+class FileWatcher
+{
+public:
+
+	// コンストラクタ
+	FileWatcher() = default;
+
+	// 監視を2回止めないように、コピーはしない
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// デストラクタ
+	~FileWatcher();
+
+	// ディレクトリを、中のディレクトリも含めて監視する（監視できなければfalse）
+	bool AddDirectory(const std::string& directoryPath);
+
+	// 全ての監視を止める
+	void Clear();
+
+	// 変更を受け取り、最後の変更から一定時間たったファイルのパスを返す（保存中の連続した変更を1回にまとめる）
+	std::vector<std::string> Update(double currentTime);
+
+	// 変更があったことにする（監視の仕組みを通さずに、まとめる処理だけを使う）
+	void AddChange(const std::string& filePath, double currentTime);
+
+	// Getter
+	double GetDebounceSeconds() const { return debounceSeconds_; }
+	uint32_t GetNumDirectories() const;
+	uint32_t GetNumPendingChanges() const { return uint32_t(pendingChanges_.size()); }
+
+	// Setter
+	void SetDebounceSeconds(double debounceSeconds) { debounceSeconds_ = debounceSeconds; }
+
+
+private:
+
+	// OSから変更の通知を受け取る
+	void PollEvents(double currentTime);
+
+	// 最後の変更からこの時間（秒）たったら、変更を返す
+	double debounceSeconds_ = 0.25;
+
+	// 変更を待っているファイルと、最後に変更された時刻
+	std::unordered_map<std::string, double> pendingChanges_;
+
+#ifdef _WIN32
+
+	// 監視しているディレクトリ
+	typedef struct WatchedDirectory
+	{
+		// パス
+		std::string path;
+
+		// ディレクトリのハンドル
+		HANDLE handle;
+
+		// 非同期で受け取るための設定
+		OVERLAPPED overlapped;
+
+		// 通知を受け取る場所（DWORDの境界に揃える）
+		DWORD buffer[16384];
+	}WatchedDirectory;
+
+	// 次の通知の受け取りを始める
+	bool BeginRead(WatchedDirectory* directory);
+
+	// 監視しているディレクトリ（受け取る場所が動かないように、ポインタで持つ）
+	std::vector<WatchedDirectory*> directories_;
+
+#else
+
+	// 中のディレクトリを1つ監視に加える
+	bool AddWatch(const std::string& directoryPath);
+
+	// inotifyのファイルディスクリプタ
+	int inotify_ = -1;
+
+	// 監視の番号から、ディレクトリのパスを引く
+	std::unordered_map<int, std::string> watchPaths_;
+
+#endif
+};
@@ -0,0 +1,535 @@
+#include "FrameProfiler.h"
+
+namespace
+{
+	// スレッドの終了時に、リングバッファを使い回せるようにする
+	struct ThreadBufferReleaser
+	{
+		FrameProfileThreadBuffer* buffer = nullptr;
+
+		~ThreadBufferReleaser()
+		{
+			if (buffer)
+			{
+				buffer->isOwned.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	thread_local ThreadBufferReleaser threadBufferReleaser;
+
+	// JSONの文字列に入れられるように、エスケープする
+	std::string EscapeJsonString(std::string_view str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+
+		for (char c : str)
+		{
+			if (c == '\"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += c;
+			} else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				escaped += engine::format("\\u{:04x}", static_cast<unsigned char>(c));
+			} else
+			{
+				escaped += c;
+			}
+		}
+
+		return escaped;
+	}
+
+	// CSVの1つの欄に入れられるように、ダブルクォートで囲む
+	std::string QuoteCsvField(std::string_view str)
+	{
+		std::string quoted = "\"";
+
+		for (char c : str)
+		{
+			if (c == '\"')
+			{
+				quoted += '\"';
+			}
+
+			quoted += c;
+		}
+
+		return quoted + "\"";
+	}
+
+	// 名前ごとに、同じ色になるようにする
+	ImU32 GetScopeColor(const char* name)
+	{
+		size_t hash = std::hash<std::string_view>{}(name);
+		float hue = static_cast<float>(hash % 360) / 360.0f;
+		return ImColor::HSV(hue, 0.45f, 0.85f);
+	}
+}
+
+// フレームを区切る（メインスレッドでフレームの最初に呼ぶ。前のフレームの区間を集める）
+void FrameProfiler::NewFrame()
+{
+	int64_t nowTicks = GetTicks();
+
+	if (frameStartTicks_ != 0)
+	{
+		// 古いフレームの配列を使い回して、毎フレーム確保しないようにする
+		FrameProfileFrame frame{};
+		if (isPaused_ == false && frames_.size() >= kNumFrames)
+		{
+			frame = std::move(frames_.front());
+			frames_.pop_front();
+			frame.events.clear();
+		}
+
+		frame.frameNumber = frameNumber_;
+		frame.startTicks = frameStartTicks_;
+		frame.durationMicroseconds = TicksToMicroseconds(nowTicks - frameStartTicks_);
+
+		// 一時停止中も、リングバッファがあふれないように読み捨てる
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex_);
+
+			for (FrameProfileThreadBuffer* buffer : buffers_)
+			{
+				CollectRecords(buffer, frame);
+			}
+		}
+
+		if (isPaused_ == false)
+		{
+			frames_.push_back(std::move(frame));
+		}
+	}
+
+	frameNumber_++;
+	frameStartTicks_ = nowTicks;
+}
+
+// リングバッファから、まだ読んでいない区間をフレームに移す
+void FrameProfiler::CollectRecords(FrameProfileThreadBuffer* buffer, FrameProfileFrame& frame)
+{
+	const uint64_t kNumRecords = FrameProfileThreadBuffer::kNumRecords;
+
+	uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+	uint64_t readCount = buffer->readCount;
+
+	// 1周以上遅れていたら、上書きされた分は読めない
+	if (writeCount - readCount > kNumRecords)
+	{
+		numDroppedRecords_ += writeCount - readCount - kNumRecords;
+		readCount = writeCount - kNumRecords;
+	}
+
+	size_t firstEvent = frame.events.size();
+
+	for (uint64_t i = readCount; i < writeCount; ++i)
+	{
+		const FrameProfileRecord& record = buffer->records[i & (kNumRecords - 1)];
+
+		int64_t startTicks = record.startTicks.load(std::memory_order_relaxed);
+		int64_t endTicks = record.endTicks.load(std::memory_order_relaxed);
+
+		FrameProfileEvent event{};
+		event.name = record.name.load(std::memory_order_relaxed);
+		event.startMicroseconds = TicksToMicroseconds(startTicks - frame.startTicks);
+		event.durationMicroseconds = TicksToMicroseconds(endTicks - startTicks);
+		event.depth = record.depth.load(std::memory_order_relaxed);
+		event.threadIndex = buffer->threadIndex;
+		frame.events.push_back(event);
+	}
+
+	DiscardOverwrittenRecords(buffer, frame, firstEvent, readCount, writeCount);
+
+	buffer->readCount = writeCount;
+}
+
+// 読んでいる間に上書きされたかもしれない区間を、フレームから捨てる（捨てた数を返す）
+uint64_t FrameProfiler::DiscardOverwrittenRecords(FrameProfileThreadBuffer* buffer, FrameProfileFrame& frame, size_t firstEvent,
+	uint64_t readCount, uint64_t writeCount)
+{
+	const uint64_t kNumRecords = FrameProfileThreadBuffer::kNumRecords;
+
+	// 読んだ区間より後に書き込んだ数を見る（WriteRecordのフェンスと対になり、途中の値を読んでいれば、その書き込みの番号が見える）
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t latestWriteCount = buffer->writeCount.load(std::memory_order_relaxed);
+
+	// 番号latestWriteCountの区間は書いている途中かもしれないので、それが上書きする区間（latestWriteCount - kNumRecords）までを捨てる
+	if (latestWriteCount + 1 - readCount <= kNumRecords)
+		return 0;
+
+	uint64_t numOverwritten = (std::min)(latestWriteCount + 1 - readCount - kNumRecords, writeCount - readCount);
+	frame.events.erase(frame.events.begin() + firstEvent, frame.events.begin() + firstEvent + static_cast<size_t>(numOverwritten));
+	numDroppedRecords_ += numOverwritten;
+
+	return numOverwritten;
+}
+
+// 呼んだスレッドにリングバッファを割り当てる
+void FrameProfiler::RegisterThread()
+{
+	std::lock_guard<std::mutex> lock(buffersMutex_);
+
+	FrameProfileThreadBuffer* buffer = nullptr;
+
+	// 終了したスレッドのものがあれば使い回す（読み残しは、そのまま次のフレームで読む）
+	for (FrameProfileThreadBuffer* candidate : buffers_)
+	{
+		if (candidate->isOwned.load(std::memory_order_acquire) == false)
+		{
+			buffer = candidate;
+			break;
+		}
+	}
+
+	if (buffer == nullptr)
+	{
+		// スレッドが終了しても他のスレッドが使い回すので、解放しない
+		buffer = new FrameProfileThreadBuffer();
+		buffer->threadIndex = static_cast<uint32_t>(buffers_.size());
+		buffer->threadName = engine::format("Thread {}", buffer->threadIndex);
+		buffers_.push_back(buffer);
+	}
+
+	buffer->isOwned.store(true, std::memory_order_release);
+	buffer->depth = 0;
+
+	threadBuffer_ = buffer;
+	threadBufferReleaser.buffer = buffer;
+}
+
+// 呼んだスレッドに名前を付ける
+void FrameProfiler::SetThreadName(const std::string& threadName)
+{
+	FrameProfileThreadBuffer* buffer = GetThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(buffersMutex_);
+	buffer->threadName = threadName;
+}
+
+// スレッドの番号から名前を取得する
+std::string FrameProfiler::GetThreadName(uint32_t threadIndex)
+{
+	std::lock_guard<std::mutex> lock(buffersMutex_);
+
+	if (threadIndex >= buffers_.size())
+		return engine::format("Thread {}", threadIndex);
+
+	return buffers_[threadIndex]->threadName;
+}
+
+// 目盛りをマイクロ秒に変換する
+double FrameProfiler::TicksToMicroseconds(int64_t ticks)
+{
+#ifdef _WIN32
+	static const double kMicrosecondsPerTick = []()
+		{
+			LARGE_INTEGER frequency;
+			QueryPerformanceFrequency(&frequency);
+			return 1000000.0 / static_cast<double>(frequency.QuadPart);
+		}();
+
+	return static_cast<double>(ticks) * kMicrosecondsPerTick;
+#else
+	std::chrono::duration<double, std::micro> microseconds = std::chrono::steady_clock::duration(ticks);
+	return microseconds.count();
+#endif
+}
+
+// 残しているフレームを、Chromeのトレース（chrome://tracing や Perfetto で開けるJSON）に書き出す
+bool FrameProfiler::WriteChromeTrace(const std::string& filePath)
+{
+	if (frames_.empty())
+		return false;
+
+	std::ofstream file(filePath, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	int64_t originTicks = frames_.front().startTicks;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Engine\"}}";
+	file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+
+	// スレッドの番号は、フレームの区切りと重ならないように1から始める
+	std::vector<bool> isNamed;
+
+	for (const FrameProfileFrame& frame : frames_)
+	{
+		double frameStart = TicksToMicroseconds(frame.startTicks - originTicks);
+
+		file << engine::format(",\n{{\"name\":\"Frame {}\",\"cat\":\"Frame\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":0}}",
+			frame.frameNumber, frameStart, frame.durationMicroseconds);
+
+		for (const FrameProfileEvent& event : frame.events)
+		{
+			if (event.threadIndex >= isNamed.size())
+			{
+				isNamed.resize(event.threadIndex + 1, false);
+			}
+
+			if (isNamed[event.threadIndex] == false)
+			{
+				isNamed[event.threadIndex] = true;
+				file << engine::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+					event.threadIndex + 1, EscapeJsonString(GetThreadName(event.threadIndex)));
+			}
+
+			file << engine::format(",\n{{\"name\":\"{}\",\"cat\":\"CPU\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+				EscapeJsonString(event.name), frameStart + event.startMicroseconds, event.durationMicroseconds, event.threadIndex + 1);
+		}
+	}
+
+	file << "\n]}\n";
+
+	return file.good();
+}
+
+// 残しているフレームを、区間ごとに1行のCSVに書き出す
+bool FrameProfiler::WriteCsv(const std::string& filePath)
+{
+	if (frames_.empty())
+		return false;
+
+	std::ofstream file(filePath, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "frame,frame_ms,thread,name,depth,start_us,duration_us\n";
+
+	for (const FrameProfileFrame& frame : frames_)
+	{
+		for (const FrameProfileEvent& event : frame.events)
+		{
+			file << engine::format("{},{:.3f},{},{},{},{:.3f},{:.3f}\n",
+				frame.frameNumber, frame.durationMicroseconds / 1000.0, QuoteCsvField(GetThreadName(event.threadIndex)),
+				QuoteCsvField(event.name), event.depth, event.startMicroseconds, event.durationMicroseconds);
+		}
+	}
+
+	return file.good();
+}
+
+// 計測のウィンドウを描画する（タイムライン、区間ごとの合計、書き出し）
+void FrameProfiler::DrawWindow(const std::string& exportPathStem)
+{
+	ImGui::Begin("Frame Profiler");
+
+	bool isEnabled = IsEnabled();
+	if (ImGui::Checkbox("Enabled", &isEnabled))
+	{
+		SetEnabled(isEnabled);
+	}
+
+	ImGui::SameLine();
+	ImGui::Checkbox("Pause", &isPaused_);
+
+	if (frames_.empty())
+	{
+		ImGui::Text("no frames");
+		ImGui::End();
+		return;
+	}
+
+
+	/*   フレームの時間   */
+
+	std::vector<float> frameMilliseconds(frames_.size());
+	float sumMilliseconds = 0.0f;
+	float minMilliseconds = (std::numeric_limits<float>::max)();
+	float maxMilliseconds = 0.0f;
+
+	for (size_t i = 0; i < frames_.size(); ++i)
+	{
+		frameMilliseconds[i] = static_cast<float>(frames_[i].durationMicroseconds / 1000.0);
+		sumMilliseconds += frameMilliseconds[i];
+		minMilliseconds = (std::min)(minMilliseconds, frameMilliseconds[i]);
+		maxMilliseconds = (std::max)(maxMilliseconds, frameMilliseconds[i]);
+	}
+
+	float averageMilliseconds = sumMilliseconds / static_cast<float>(frames_.size());
+
+	ImGui::Text("frame %.2f ms (avg %.2f , min %.2f , max %.2f) %.1f fps",
+		frameMilliseconds.back(), averageMilliseconds, minMilliseconds, maxMilliseconds,
+		averageMilliseconds > 0.0f ? 1000.0f / averageMilliseconds : 0.0f);
+
+	ImGui::PlotHistogram("##FrameTimes", frameMilliseconds.data(), static_cast<int>(frameMilliseconds.size()),
+		0, nullptr, 0.0f, maxMilliseconds * 1.2f, ImVec2(-1.0f, 60.0f));
+
+	// 一時停止して、過去のフレームを選んで見る
+	int32_t lastFrame = static_cast<int32_t>(frames_.size()) - 1;
+	selectedFrame_ = (std::min)(selectedFrame_, lastFrame);
+	ImGui::SliderInt("Frame", &selectedFrame_, -1, lastFrame, selectedFrame_ < 0 ? "latest" : "%d");
+
+	const FrameProfileFrame& frame = frames_[selectedFrame_ < 0 ? lastFrame : selectedFrame_];
+
+
+	/*   タイムライン   */
+
+	ImGui::Separator();
+	ImGui::Text("frame %llu : %.3f ms , %zu scopes", static_cast<unsigned long long>(frame.frameNumber),
+		frame.durationMicroseconds / 1000.0, frame.events.size());
+
+	DrawTimeline(frame);
+
+
+	/*   区間ごとの合計   */
+
+	ImGui::Separator();
+	DrawScopeTable(frame);
+
+
+	/*   書き出し   */
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Export Chrome trace"))
+	{
+		std::string filePath = exportPathStem + "_frames.json";
+		exportMessage_ = WriteChromeTrace(filePath) ? "wrote " + filePath : "failed to write " + filePath;
+	}
+
+	ImGui::SameLine();
+
+	if (ImGui::Button("Export CSV"))
+	{
+		std::string filePath = exportPathStem + "_frames.csv";
+		exportMessage_ = WriteCsv(filePath) ? "wrote " + filePath : "failed to write " + filePath;
+	}
+
+	if (exportMessage_.empty() == false)
+	{
+		ImGui::TextUnformatted(exportMessage_.c_str());
+	}
+
+	if (numDroppedRecords_ > 0)
+	{
+		ImGui::Text("dropped %llu scopes (ring buffer overflow)", static_cast<unsigned long long>(numDroppedRecords_));
+	}
+
+	ImGui::End();
+}
+
+// 区間のタイムラインを、スレッドごとに描画する
+void FrameProfiler::DrawTimeline(const FrameProfileFrame& frame)
+{
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	float width = (std::max)(ImGui::GetContentRegionAvail().x, 1.0f);
+	float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	double frameMicroseconds = (std::max)(frame.durationMicroseconds, 1.0);
+
+	// スレッドごとの入れ子の深さ
+	std::vector<uint32_t> maxDepths;
+	for (const FrameProfileEvent& event : frame.events)
+	{
+		if (event.threadIndex >= maxDepths.size())
+		{
+			maxDepths.resize(event.threadIndex + 1, UINT32_MAX);
+		}
+
+		if (maxDepths[event.threadIndex] == UINT32_MAX || event.depth > maxDepths[event.threadIndex])
+		{
+			maxDepths[event.threadIndex] = event.depth;
+		}
+	}
+
+	for (uint32_t threadIndex = 0; threadIndex < maxDepths.size(); ++threadIndex)
+	{
+		if (maxDepths[threadIndex] == UINT32_MAX)
+			continue;
+
+		ImGui::TextUnformatted(GetThreadName(threadIndex).c_str());
+
+		ImVec2 origin = ImGui::GetCursorScreenPos();
+		float height = rowHeight * static_cast<float>(maxDepths[threadIndex] + 1);
+
+		ImGui::PushID(static_cast<int>(threadIndex));
+		ImGui::InvisibleButton("##Timeline", ImVec2(width, height));
+		ImGui::PopID();
+
+		drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+		for (const FrameProfileEvent& event : frame.events)
+		{
+			if (event.threadIndex != threadIndex)
+				continue;
+
+			// フレームの外にはみ出した部分（前のフレームから続く区間など）は切り詰める
+			double start = std::clamp(event.startMicroseconds / frameMicroseconds, 0.0, 1.0);
+			double end = std::clamp((event.startMicroseconds + event.durationMicroseconds) / frameMicroseconds, 0.0, 1.0);
+
+			ImVec2 rectMin(origin.x + static_cast<float>(start) * width, origin.y + rowHeight * static_cast<float>(event.depth));
+			ImVec2 rectMax((std::max)(origin.x + static_cast<float>(end) * width, rectMin.x + 1.0f), rectMin.y + rowHeight - 1.0f);
+
+			drawList->AddRectFilled(rectMin, rectMax, GetScopeColor(event.name));
+
+			// 名前が入る幅があれば書く
+			if (rectMax.x - rectMin.x > ImGui::CalcTextSize(event.name).x + 4.0f)
+			{
+				drawList->AddText(ImVec2(rectMin.x + 2.0f, rectMin.y + 2.0f), IM_COL32(0, 0, 0, 255), event.name);
+			}
+
+			if (ImGui::IsMouseHoveringRect(rectMin, rectMax))
+			{
+				ImGui::SetTooltip("%s\n%.3f ms (start %.3f ms)", event.name,
+					event.durationMicroseconds / 1000.0, event.startMicroseconds / 1000.0);
+			}
+		}
+	}
+}
+
+// 区間の名前ごとの合計を、表にして描画する
+void FrameProfiler::DrawScopeTable(const FrameProfileFrame& frame)
+{
+	typedef struct ScopeTotal
+	{
+		const char* name;
+		uint32_t numCalls;
+		double totalMicroseconds;
+	}ScopeTotal;
+
+	// 名前ごとに、呼んだ回数と時間を足す（入れ子になった同じ名前は、内側の時間も足される）
+	std::unordered_map<std::string_view, size_t> indices;
+	std::vector<ScopeTotal> totals;
+
+	for (const FrameProfileEvent& event : frame.events)
+	{
+		auto it = indices.find(event.name);
+		if (it == indices.end())
+		{
+			it = indices.emplace(event.name, totals.size()).first;
+			totals.push_back({ event.name, 0, 0.0 });
+		}
+
+		totals[it->second].numCalls++;
+		totals[it->second].totalMicroseconds += event.durationMicroseconds;
+	}
+
+	std::sort(totals.begin(), totals.end(),
+		[](const ScopeTotal& a, const ScopeTotal& b) { return a.totalMicroseconds > b.totalMicroseconds; });
+
+	if (ImGui::BeginTable("##Scopes", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 200.0f)))
+	{
+		ImGui::TableSetupColumn("scope");
+		ImGui::TableSetupColumn("calls");
+		ImGui::TableSetupColumn("total ms");
+		ImGui::TableHeadersRow();
+
+		for (const ScopeTotal& total : totals)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(total.name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", total.numCalls);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", total.totalMicroseconds / 1000.0);
+		}
+
+		ImGui::EndTable();
+	}
+}
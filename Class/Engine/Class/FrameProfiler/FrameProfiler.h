@@ -0,0 +1,290 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include "../../externals/imgui/imgui.h"
+#include "../../Func/Format/Format.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// スコープを抜けるまでの時間を計測する（nameは文字列リテラルなど、ずっと残る文字列を渡す）
+// ENGINE_PROFILER_DISABLEDを定義すると、計測のコードごと消える
+#ifdef ENGINE_PROFILER_DISABLED
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) FrameProfileScope PROFILE_CONCAT(frameProfileScope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#endif
+
+// スレッドが書き込む、計測した区間
+// 読む側が1周遅れると、書いている途中の区間を読むことがあるので、全てrelaxedのatomicにする（読んだ後に書き込んだ数を見直し、上書きされたものは捨てる）
+// x64とARM64では、relaxedの読み書きは普通の読み書きと同じ命令になる
+typedef struct FrameProfileRecord
+{
+	// 区間の名前
+	std::atomic<const char*> name;
+
+	// 開始と終了の時刻（GetTicksの目盛り）
+	std::atomic<int64_t> startTicks;
+	std::atomic<int64_t> endTicks;
+
+	// 入れ子の深さ
+	std::atomic<uint32_t> depth;
+}FrameProfileRecord;
+
+// スレッドごとのリングバッファ（書き込むのはそのスレッドだけ、読み込むのはメインスレッドだけなので、ロックはいらない）
+// 書き込んだ数をシーケンス番号にしたseqlockと同じ考え方で、読む側は読み終えてから書き込んだ数を見直す
+typedef struct FrameProfileThreadBuffer
+{
+	// 記録できる区間の数（2の累乗）
+	static const uint32_t kNumRecords = 16384;
+
+	// 区間の記録
+	FrameProfileRecord records[kNumRecords];
+
+	// 書き込んだ数（書き込むスレッドだけが増やす）
+	std::atomic<uint64_t> writeCount{ 0 };
+
+	// 読み込んだ数（メインスレッドだけが使う）
+	uint64_t readCount = 0;
+
+	// 開いている区間の数（書き込むスレッドだけが使う）
+	uint32_t depth = 0;
+
+	// スレッドの番号と名前
+	uint32_t threadIndex = 0;
+	std::string threadName;
+
+	// スレッドが使っているかどうか（終了したスレッドのものは、別のスレッドが使い回す）
+	std::atomic<bool> isOwned{ false };
+}FrameProfileThreadBuffer;
+
+// フレームの中で計測した区間
+typedef struct FrameProfileEvent
+{
+	// 区間の名前
+	const char* name;
+
+	// フレームの開始からの開始時刻と、かかった時間（マイクロ秒）
+	double startMicroseconds;
+	double durationMicroseconds;
+
+	// 入れ子の深さ
+	uint32_t depth;
+
+	// 計測したスレッドの番号
+	uint32_t threadIndex;
+}FrameProfileEvent;
+
+// 1フレーム分の計測
+typedef struct FrameProfileFrame
+{
+	// フレームの番号
+	uint64_t frameNumber;
+
+	// フレームの開始時刻（GetTicksの目盛り）
+	int64_t startTicks;
+
+	// フレームの時間（マイクロ秒）
+	double durationMicroseconds;
+
+	// 計測した区間（スレッドごとに、終えた順）
+	std::vector<FrameProfileEvent> events;
+}FrameProfileFrame;
+
+// フレームごとのCPUの時間を、スコープの入れ子で計測する
+class FrameProfiler
+{
+public:
+
+	// フレームを区切る（メインスレッドでフレームの最初に呼ぶ。前のフレームの区間を集める）
+	static void NewFrame();
+
+	// 計測のウィンドウを描画する（タイムライン、区間ごとの合計、書き出し。書き出すファイルはexportPathStemに拡張子を付ける）
+	static void DrawWindow(const std::string& exportPathStem);
+
+	// 残しているフレームを、Chromeのトレース（chrome://tracing や Perfetto で開けるJSON）に書き出す
+	static bool WriteChromeTrace(const std::string& filePath);
+
+	// 残しているフレームを、区間ごとに1行のCSVに書き出す
+	static bool WriteCsv(const std::string& filePath);
+
+	// 呼んだスレッドに名前を付ける
+	static void SetThreadName(const std::string& threadName);
+
+	// 呼んだスレッドのリングバッファ（初めて呼んだときに用意する）
+	static FrameProfileThreadBuffer* GetThreadBuffer()
+	{
+		if (threadBuffer_ == nullptr)
+		{
+			RegisterThread();
+		}
+
+		return threadBuffer_;
+	}
+
+	// 現在の時刻（WindowsではQueryPerformanceCounterをそのまま使い、chronoの単位の変換を省く）
+	static int64_t GetTicks()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return counter.QuadPart;
+#else
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	// Getter
+	static bool IsEnabled() { return isEnabled_.load(std::memory_order_relaxed); }
+	static bool IsPaused() { return isPaused_; }
+	static uint64_t GetNumDroppedRecords() { return numDroppedRecords_; }
+	static const std::deque<FrameProfileFrame>& GetFrames() { return frames_; }
+
+	// Setter
+	static void SetEnabled(bool isEnabled) { isEnabled_.store(isEnabled, std::memory_order_relaxed); }
+	static void SetPaused(bool isPaused) { isPaused_ = isPaused; }
+
+	// 終えた区間をリングバッファに書き込む（書き込むスレッドだけが呼ぶ）
+	static void WriteRecord(FrameProfileThreadBuffer* buffer, const char* name, int64_t startTicks, int64_t endTicks, uint32_t depth)
+	{
+		uint64_t index = buffer->writeCount.load(std::memory_order_relaxed);
+		FrameProfileRecord& record = buffer->records[index & (FrameProfileThreadBuffer::kNumRecords - 1)];
+
+		// 読む側が、この書き込みの途中の値を読んだときに、ここまでに書き込んだ数（index）が必ず見えるようにする
+		std::atomic_thread_fence(std::memory_order_release);
+
+		record.name.store(name, std::memory_order_relaxed);
+		record.startTicks.store(startTicks, std::memory_order_relaxed);
+		record.endTicks.store(endTicks, std::memory_order_relaxed);
+		record.depth.store(depth, std::memory_order_relaxed);
+
+		// 書き込んでから数を増やすので、読む側は増えた数までを読めばよい
+		buffer->writeCount.store(index + 1, std::memory_order_release);
+	}
+
+
+private:
+
+	// テストから、リングバッファを読む処理を直接呼ぶ
+	friend class FrameProfilerTests;
+
+	// 呼んだスレッドにリングバッファを割り当てる
+	static void RegisterThread();
+
+	// リングバッファから、まだ読んでいない区間をフレームに移す
+	static void CollectRecords(FrameProfileThreadBuffer* buffer, FrameProfileFrame& frame);
+
+	// 読んでいる間に上書きされたかもしれない区間を、フレームから捨てる（捨てた数を返す）
+	static uint64_t DiscardOverwrittenRecords(FrameProfileThreadBuffer* buffer, FrameProfileFrame& frame, size_t firstEvent,
+		uint64_t readCount, uint64_t writeCount);
+
+	// スレッドの番号から名前を取得する
+	static std::string GetThreadName(uint32_t threadIndex);
+
+	// 目盛りをマイクロ秒に変換する
+	static double TicksToMicroseconds(int64_t ticks);
+
+	// 区間のタイムラインを、スレッドごとに描画する
+	static void DrawTimeline(const FrameProfileFrame& frame);
+
+	// 区間の名前ごとの合計を、表にして描画する
+	static void DrawScopeTable(const FrameProfileFrame& frame);
+
+
+	// 残すフレームの数
+	static const uint32_t kNumFrames = 240;
+
+	// 計測するかどうか
+	static inline std::atomic<bool> isEnabled_{ true };
+
+	// 一時停止しているかどうか（止めている間はフレームを残さない）
+	static inline bool isPaused_ = false;
+
+	// 全てのスレッドのリングバッファ（スレッドを登録するときだけロックする）
+	static inline std::vector<FrameProfileThreadBuffer*> buffers_;
+	static inline std::mutex buffersMutex_;
+
+	// 呼んだスレッドのリングバッファ
+	static inline thread_local FrameProfileThreadBuffer* threadBuffer_ = nullptr;
+
+	// 残しているフレーム（古い順）
+	static inline std::deque<FrameProfileFrame> frames_;
+
+	// 今のフレームの番号と開始時刻
+	static inline uint64_t frameNumber_ = 0;
+	static inline int64_t frameStartTicks_ = 0;
+
+	// 読み込む前に上書きされた区間の数
+	static inline uint64_t numDroppedRecords_ = 0;
+
+	// ウィンドウで選んでいるフレーム（-1なら最新）
+	static inline int32_t selectedFrame_ = -1;
+
+	// 書き出しの結果
+	static inline std::string exportMessage_;
+};
+
+// スコープを抜けるまでを1つの区間として、スレッドのリングバッファに記録する
+class FrameProfileScope
+{
+public:
+
+	// コンストラクタ（計測しないときは、フラグを見るだけ）
+	explicit FrameProfileScope(const char* name)
+	{
+		if (FrameProfiler::IsEnabled() == false)
+			return;
+
+		buffer_ = FrameProfiler::GetThreadBuffer();
+		name_ = name;
+		depth_ = buffer_->depth++;
+		startTicks_ = FrameProfiler::GetTicks();
+	}
+
+	// 2回記録しないように、コピーはしない
+	FrameProfileScope(const FrameProfileScope&) = delete;
+	FrameProfileScope& operator=(const FrameProfileScope&) = delete;
+
+	// デストラクタ（終えた区間を書き込む）
+	~FrameProfileScope()
+	{
+		if (buffer_ == nullptr)
+			return;
+
+		int64_t endTicks = FrameProfiler::GetTicks();
+		buffer_->depth--;
+
+		FrameProfiler::WriteRecord(buffer_, name_, startTicks_, endTicks, depth_);
+	}
+
+
+private:
+
+	// 書き込むリングバッファ（計測しないときはnullptr）
+	FrameProfileThreadBuffer* buffer_ = nullptr;
+
+	// 区間の名前
+	const char* name_ = nullptr;
+
+	// 開始時刻
+	int64_t startTicks_ = 0;
+
+	// 入れ子の深さ
+	uint32_t depth_ = 0;
+};
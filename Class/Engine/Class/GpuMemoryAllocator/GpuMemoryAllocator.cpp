@@ -0,0 +1,222 @@
+#include "GpuMemoryAllocator.h"
+
+// コンストラクタ
+GpuMemoryAllocator::GpuMemoryAllocator(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<IDXGIAdapter4> adapter)
+	: device_(device), adapter_(adapter)
+{
+
+}
+
+// 書き込めるバッファの範囲を確保する
+GpuBufferAllocation GpuMemoryAllocator::AllocateUploadBuffer(uint64_t sizeInBytes, uint64_t alignment)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	GpuBufferAllocation allocation{};
+	allocation.sizeInBytes = sizeInBytes;
+	allocation.heapIndex = Allocate(GpuMemoryPool::UploadBuffer, sizeInBytes, alignment, allocation.offset, allocation.block);
+
+	const Heap& heap = heaps_[static_cast<uint32_t>(GpuMemoryPool::UploadBuffer)][allocation.heapIndex];
+	allocation.resource = heap.buffer.Get();
+	allocation.gpuAddress = heap.gpuAddress + allocation.offset;
+	allocation.data = heap.data + allocation.offset;
+
+	return allocation;
+}
+
+// バッファの範囲を解放する
+void GpuMemoryAllocator::FreeUploadBuffer(const GpuBufferAllocation& allocation)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	heaps_[static_cast<uint32_t>(GpuMemoryPool::UploadBuffer)][allocation.heapIndex].allocator->Free(allocation.block);
+}
+
+// テクスチャを作る
+GpuTextureAllocation GpuMemoryAllocator::CreateTexture(const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState)
+{
+	GpuTextureAllocation allocation{};
+	allocation.block = TlsfAllocator::kInvalidBlock;
+
+	// レンダーターゲットや深度は、テクスチャのプールのヒープに置けない
+	const D3D12_RESOURCE_FLAGS kTargetFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+	if ((resourceDesc.Flags & kTargetFlags) != 0)
+	{
+		D3D12_HEAP_PROPERTIES heapProperties{};
+		heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+		HRESULT hr = device_->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, initialState, nullptr,
+			IID_PPV_ARGS(&allocation.resource));
+		assert(SUCCEEDED(hr));
+
+		return allocation;
+	}
+
+	// 小さいテクスチャは4KBに揃えて置ける（置けないものは、64KBの揃えが返ってくる）
+	D3D12_RESOURCE_DESC placedDesc = resourceDesc;
+	placedDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+	D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = device_->GetResourceAllocationInfo(0, 1, &placedDesc);
+
+	bool isSmall = allocationInfo.Alignment == D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+	if (isSmall == false)
+	{
+		placedDesc.Alignment = 0;
+		allocationInfo = device_->GetResourceAllocationInfo(0, 1, &placedDesc);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	uint64_t offset = 0;
+	allocation.heapIndex = Allocate(GpuMemoryPool::Texture, allocationInfo.SizeInBytes, allocationInfo.Alignment, offset, allocation.block);
+
+	const Heap& heap = heaps_[static_cast<uint32_t>(GpuMemoryPool::Texture)][allocation.heapIndex];
+	HRESULT hr = device_->CreatePlacedResource(heap.heap.Get(), offset, &placedDesc, initialState, nullptr, IID_PPV_ARGS(&allocation.resource));
+	assert(SUCCEEDED(hr));
+
+	if (isSmall)
+	{
+		numSmallTextures_++;
+	}
+
+	return allocation;
+}
+
+// テクスチャを解放する
+void GpuMemoryAllocator::FreeTexture(GpuTextureAllocation& allocation)
+{
+	// 配置したリソースを先に解放してから、ヒープの範囲を返す
+	allocation.resource = nullptr;
+
+	if (allocation.block == TlsfAllocator::kInvalidBlock)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	heaps_[static_cast<uint32_t>(GpuMemoryPool::Texture)][allocation.heapIndex].allocator->Free(allocation.block);
+	allocation.block = TlsfAllocator::kInvalidBlock;
+}
+
+// プールの状況を求める
+GpuMemoryPoolStats GpuMemoryAllocator::GetPoolStats(GpuMemoryPool pool)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	GpuMemoryPoolStats stats{};
+
+	for (const Heap& heap : heaps_[static_cast<uint32_t>(pool)])
+	{
+		TlsfStats heapStats = heap.allocator->GetStats();
+
+		stats.numHeaps++;
+		stats.reservedBytes += heapStats.capacity;
+		stats.numAllocations += heapStats.numAllocations;
+		stats.usedBytes += heapStats.usedBytes;
+		stats.numFreeBlocks += heapStats.numFreeBlocks;
+		stats.largestFreeBlock = heapStats.largestFreeBlock > stats.largestFreeBlock ? heapStats.largestFreeBlock : stats.largestFreeBlock;
+	}
+
+	// ヒープをまたいだ空きの合計と、一番大きい空きブロックから求める
+	TlsfStats totalStats{ stats.reservedBytes, stats.usedBytes, stats.numAllocations, stats.numFreeBlocks, stats.largestFreeBlock };
+	stats.fragmentation = GetFragmentation(totalStats);
+
+	if (pool == GpuMemoryPool::Texture)
+	{
+		stats.numSmallTextures = numSmallTextures_;
+	}
+
+	return stats;
+}
+
+// OSから見たVRAMの予算を問い合わせる
+GpuMemoryBudget GpuMemoryAllocator::QueryBudget() const
+{
+	GpuMemoryBudget budget{};
+
+	DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo{};
+	if (adapter_ && SUCCEEDED(adapter_->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &videoMemoryInfo)))
+	{
+		budget.budget = videoMemoryInfo.Budget;
+		budget.currentUsage = videoMemoryInfo.CurrentUsage;
+		budget.available = videoMemoryInfo.Budget > videoMemoryInfo.CurrentUsage ? videoMemoryInfo.Budget - videoMemoryInfo.CurrentUsage : 0;
+	}
+
+	return budget;
+}
+
+// プールのヒープから確保する
+uint32_t GpuMemoryAllocator::Allocate(GpuMemoryPool pool, uint64_t sizeInBytes, uint64_t alignment, uint64_t& offset, uint32_t& block)
+{
+	std::vector<Heap>& heaps = heaps_[static_cast<uint32_t>(pool)];
+
+	for (uint32_t i = 0; i < heaps.size(); ++i)
+	{
+		block = heaps[i].allocator->Allocate(sizeInBytes, alignment, offset);
+		if (block != TlsfAllocator::kInvalidBlock)
+			return i;
+	}
+
+	// 入らなければヒープを増やす（大きいものは、専用の大きさにする）
+	// 専用のヒープは、TLSFが探すときにサイズクラスを切り上げても入る大きさにする
+	uint64_t heapSize = pool == GpuMemoryPool::UploadBuffer ? kUploadHeapSize : kTextureHeapSize;
+	const uint64_t kHeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	uint64_t requiredSize = (TlsfAllocator::GetRequiredCapacity(sizeInBytes, alignment) + kHeapAlignment - 1) / kHeapAlignment * kHeapAlignment;
+	uint32_t heapIndex = CreateHeap(pool, requiredSize > heapSize ? requiredSize : heapSize);
+
+	block = heaps[heapIndex].allocator->Allocate(sizeInBytes, alignment, offset);
+	assert(block != TlsfAllocator::kInvalidBlock);
+
+	return heapIndex;
+}
+
+// プールにヒープを加える
+uint32_t GpuMemoryAllocator::CreateHeap(GpuMemoryPool pool, uint64_t sizeInBytes)
+{
+	Heap heap{};
+
+	D3D12_HEAP_DESC heapDesc{};
+	heapDesc.SizeInBytes = sizeInBytes;
+	heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	if (pool == GpuMemoryPool::UploadBuffer)
+	{
+		heapDesc.Properties.Type = D3D12_HEAP_TYPE_UPLOAD;
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+	}
+	else
+	{
+		heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+	}
+
+	HRESULT hr = device_->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap.heap));
+	assert(SUCCEEDED(hr));
+
+	// 書き込めるバッファは、ヒープ全体に1つのバッファを置いて、その中を切り分ける（バッファは64KBより細かく配置できない）
+	if (pool == GpuMemoryPool::UploadBuffer)
+	{
+		D3D12_RESOURCE_DESC resourceDesc{};
+		resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		resourceDesc.Width = sizeInBytes;
+		resourceDesc.Height = 1;
+		resourceDesc.DepthOrArraySize = 1;
+		resourceDesc.MipLevels = 1;
+		resourceDesc.SampleDesc.Count = 1;
+		resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		hr = device_->CreatePlacedResource(heap.heap.Get(), 0, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&heap.buffer));
+		assert(SUCCEEDED(hr));
+
+		// 開いたままにする（UPLOADのヒープは、マップしたまま使える）
+		hr = heap.buffer->Map(0, nullptr, reinterpret_cast<void**>(&heap.data));
+		assert(SUCCEEDED(hr));
+
+		heap.gpuAddress = heap.buffer->GetGPUVirtualAddress();
+	}
+
+	heap.allocator = std::make_unique<TlsfAllocator>(sizeInBytes);
+
+	std::vector<Heap>& heaps = heaps_[static_cast<uint32_t>(pool)];
+	heaps.push_back(std::move(heap));
+
+	return static_cast<uint32_t>(heaps.size() - 1);
+}
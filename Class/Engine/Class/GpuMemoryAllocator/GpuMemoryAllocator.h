@@ -0,0 +1,158 @@
+#pragma once
+#include <Windows.h>
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cassert>
+#include <wrl.h>
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include "../TlsfAllocator/TlsfAllocator.h"
+
+#pragma comment(lib,"d3d12.lib")
+#pragma comment(lib, "dxgi.lib")
+
+// ヒープのプール
+enum class GpuMemoryPool : uint32_t
+{
+	// CPUから書き込むバッファ（UPLOADのヒープに置いた大きなバッファを切り分ける）
+	UploadBuffer,
+
+	// テクスチャ（DEFAULTのヒープに配置する。小さいものは4KBに揃える）
+	Texture,
+
+	Count
+};
+
+// プールの状況
+typedef struct GpuMemoryPoolStats
+{
+	// ヒープの数と、その大きさの合計
+	uint32_t numHeaps;
+	uint64_t reservedBytes;
+
+	// 確保している数と大きさ
+	uint32_t numAllocations;
+	uint64_t usedBytes;
+
+	// 空いているブロックの数と、一番大きい空きブロック
+	uint32_t numFreeBlocks;
+	uint64_t largestFreeBlock;
+
+	// 断片化の度合い（0なら空きがまとまっていて、1に近いほど細かく分かれている）
+	double fragmentation;
+
+	// 4KBに揃えて置けたテクスチャの数（置けなかったものは64KBに揃える）
+	uint32_t numSmallTextures;
+}GpuMemoryPoolStats;
+
+// OSから見たVRAMの予算
+typedef struct GpuMemoryBudget
+{
+	// 予算と、このプロセスが使っている大きさ
+	uint64_t budget;
+	uint64_t currentUsage;
+
+	// 予算までの残り（超えていれば0）
+	uint64_t available;
+}GpuMemoryBudget;
+
+// バッファから切り分けた範囲
+typedef struct GpuBufferAllocation
+{
+	// 切り分けた元のバッファ（プールが持っているので、参照を増やさない）と、その中の位置
+	ID3D12Resource* resource;
+	uint64_t offset;
+
+	// GPUのアドレスと、書き込む先
+	uint64_t gpuAddress;
+	void* data;
+
+	// 大きさ
+	uint64_t sizeInBytes;
+
+	// 解放するときに使う、ヒープとブロック
+	uint32_t heapIndex;
+	uint32_t block;
+}GpuBufferAllocation;
+
+// ヒープに配置したテクスチャ
+typedef struct GpuTextureAllocation
+{
+	// リソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+
+	// 解放するときに使う、ヒープとブロック（プールに置けなかったものは、ブロックが TlsfAllocator::kInvalidBlock）
+	uint32_t heapIndex;
+	uint32_t block;
+}GpuTextureAllocation;
+
+// 大きなID3D12Heapを作り、バッファとテクスチャをTLSFで切り分けて置く（リソースごとにCreateCommittedResourceしない）
+class GpuMemoryAllocator
+{
+public:
+
+	// コンストラクタ（adapterは予算の問い合わせに使う）
+	GpuMemoryAllocator(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<IDXGIAdapter4> adapter);
+
+	// 書き込めるバッファの範囲を確保する（alignmentは、定数バッファなら256）
+	GpuBufferAllocation AllocateUploadBuffer(uint64_t sizeInBytes, uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	// バッファの範囲を解放する（GPUが使い終わってから呼ぶ）
+	void FreeUploadBuffer(const GpuBufferAllocation& allocation);
+
+	// テクスチャを作る（レンダーターゲットなど、プールに置けないものはコミットしたリソースにする）
+	GpuTextureAllocation CreateTexture(const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState);
+
+	// テクスチャを解放する（GPUが使い終わってから呼ぶ）
+	void FreeTexture(GpuTextureAllocation& allocation);
+
+	// プールの状況を求める
+	GpuMemoryPoolStats GetPoolStats(GpuMemoryPool pool);
+
+	// OSから見たVRAMの予算を問い合わせる
+	GpuMemoryBudget QueryBudget() const;
+
+
+private:
+
+	// 切り分けるヒープ
+	typedef struct Heap
+	{
+		Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+
+		// ヒープ全体に置いたバッファ（書き込めるバッファのプールだけ）と、そのアドレス
+		Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+		uint8_t* data;
+		uint64_t gpuAddress;
+
+		// ヒープの中の位置を切り分ける
+		std::unique_ptr<TlsfAllocator> allocator;
+	}Heap;
+
+	// プールのヒープから確保する（入らなければヒープを増やす）
+	uint32_t Allocate(GpuMemoryPool pool, uint64_t sizeInBytes, uint64_t alignment, uint64_t& offset, uint32_t& block);
+
+	// プールにヒープを加える
+	uint32_t CreateHeap(GpuMemoryPool pool, uint64_t sizeInBytes);
+
+
+	// 1つのヒープの大きさ（これより大きいものは、専用のヒープを作る）
+	static const uint64_t kUploadHeapSize = 16 * 1024 * 1024;
+	static const uint64_t kTextureHeapSize = 64 * 1024 * 1024;
+
+
+	// デバイスとアダプター
+	Microsoft::WRL::ComPtr<ID3D12Device> device_ = nullptr;
+	Microsoft::WRL::ComPtr<IDXGIAdapter4> adapter_ = nullptr;
+
+	// プールごとのヒープ
+	std::vector<Heap> heaps_[static_cast<uint32_t>(GpuMemoryPool::Count)];
+
+	// 4KBに揃えて置けたテクスチャの数
+	uint32_t numSmallTextures_ = 0;
+
+	// 読み込みのスレッドからも使えるようにする
+	std::mutex mutex_;
+};
@@ -0,0 +1,358 @@
+#include "Logger.h"
+
+// コンストラクタ
+Logger::Logger(uint32_t numRecords)
+	: records_(std::bit_ceil((std::max)(numRecords, 2u)))
+{
+	recordMask_ = records_.size() - 1;
+
+	// 空いている場所は、書き込む位置と同じ番号を持つ
+	for (uint64_t i = 0; i < records_.size(); ++i)
+	{
+		records_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	startTicks_ = std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// デストラクタ
+Logger::~Logger()
+{
+	Stop();
+}
+
+// ファイルを開き、書き出すスレッドを始める
+bool Logger::Start(const std::string& filePath, bool echoDebugger)
+{
+	if (isRunning_)
+		return true;
+
+	file_.open(filePath, std::ios::binary);
+	if (file_.is_open() == false)
+		return false;
+
+	echoDebugger_ = echoDebugger;
+	isStopping_.store(false);
+	isRunning_.store(true);
+
+	// 始める前に書き込んだものも、ここから書き出す
+	writerThread_ = std::thread(&Logger::WriterThread, this);
+
+	return true;
+}
+
+// 残っているログを全て書き出し、書き出すスレッドを止めてファイルを閉じる
+void Logger::Stop()
+{
+	if (isRunning_)
+	{
+		isStopping_.store(true);
+		WakeWriter();
+		writerThread_.join();
+		isRunning_.store(false);
+	}
+
+	// 止めた後に残ったものを、このスレッドで書き出す（ファイルを開いていなければ捨てるだけ）
+	std::string batch;
+	while (WriteBatch(batch));
+
+	if (file_.is_open())
+	{
+		file_.close();
+	}
+}
+
+// ここまでに書き込んだログが、ファイルに書き出されるまで待つ
+void Logger::Flush()
+{
+	if (isRunning_ == false)
+		return;
+
+	uint64_t target = writePosition_.load(std::memory_order_acquire);
+	WakeWriter();
+
+	for (uint64_t written = numWritten_.load(std::memory_order_acquire); written < target; written = numWritten_.load(std::memory_order_acquire))
+	{
+		numWritten_.wait(written, std::memory_order_acquire);
+	}
+}
+
+// 文字列にしたログを書き込む
+void Logger::WriteMessage(LogLevel level, std::string message)
+{
+	if (IsEnabled(level) == false)
+		return;
+
+	uint64_t position = 0;
+	LogRecord* record = Acquire(level, position);
+	if (record == nullptr)
+		return;
+
+	new (record->arguments) std::string(std::move(message));
+	record->formatFunction = &FormatString;
+	Publish(record, position);
+
+	// エラーは、落ちる前に書き出されているように待つ
+	if (level >= LogLevel::Error)
+	{
+		Flush();
+	}
+}
+
+// 重要度の名前
+const char* Logger::GetLevelName(LogLevel level)
+{
+	switch (level)
+	{
+	case LogLevel::Trace:
+		return "Trace";
+
+	case LogLevel::Debug:
+		return "Debug";
+
+	case LogLevel::Info:
+		return "Info";
+
+	case LogLevel::Warning:
+		return "Warning";
+
+	case LogLevel::Error:
+		return "Error";
+
+	default:
+		return "Unknown";
+	}
+}
+
+// 置いた文字列を書き足し、破棄する
+void Logger::FormatString(void* arguments, std::string& out)
+{
+	std::string* message = static_cast<std::string*>(arguments);
+	out += *message;
+	message->~basic_string();
+}
+
+// リングバッファの場所を1つ確保する
+LogRecord* Logger::Acquire(LogLevel level, uint64_t& position)
+{
+	uint64_t writePosition = writePosition_.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		LogRecord& record = records_[writePosition & recordMask_];
+		uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+		int64_t difference = int64_t(sequence) - int64_t(writePosition);
+
+		if (difference == 0)
+		{
+			// 空いているので、他のスレッドより先に位置を進められたら使う
+			if (writePosition_.compare_exchange_weak(writePosition, writePosition + 1, std::memory_order_relaxed))
+			{
+				position = writePosition;
+				record.level = level;
+				record.ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+				return &record;
+			}
+		}
+		else if (difference < 0)
+		{
+			// 満杯（書き出すスレッドが動いていなければ、待っても空かないので捨てる）
+			if (level < LogLevel::Warning || isRunning_.load(std::memory_order_relaxed) == false)
+			{
+				numDropped_.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (isWriterSleeping_.load(std::memory_order_relaxed))
+			{
+				WakeWriter();
+			}
+
+			std::this_thread::yield();
+			writePosition = writePosition_.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			// 他のスレッドが先に使った
+			writePosition = writePosition_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// 引数を置いた場所を、書き出すスレッドに渡す
+void Logger::Publish(LogRecord* record, uint64_t position)
+{
+	record->sequence.store(position + 1, std::memory_order_release);
+
+	// 眠っているときだけ起こす（書き出している間は、起こす処理を省く）
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (isWriterSleeping_.load(std::memory_order_relaxed))
+	{
+		WakeWriter();
+	}
+}
+
+// 書き出すスレッドの処理
+void Logger::WriterThread()
+{
+	std::string batch;
+	batch.reserve(64 * 1024);
+
+	for (;;)
+	{
+		if (WriteBatch(batch))
+			continue;
+
+		if (isStopping_.load())
+			break;
+
+		// 眠る前にもう一度確かめ、その間に書き込まれていれば眠らない
+		uint32_t wakeCount = wakeCount_.load(std::memory_order_acquire);
+		isWriterSleeping_.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		LogRecord& record = records_[readPosition_ & recordMask_];
+		if (record.sequence.load(std::memory_order_acquire) == readPosition_ + 1 || isStopping_.load())
+		{
+			isWriterSleeping_.store(false, std::memory_order_relaxed);
+			continue;
+		}
+
+		wakeCount_.wait(wakeCount, std::memory_order_acquire);
+		isWriterSleeping_.store(false, std::memory_order_relaxed);
+	}
+}
+
+// 溜まっているログを1回分まとめて書き出す
+bool Logger::WriteBatch(std::string& batch)
+{
+	batch.clear();
+
+	for (uint32_t i = 0; i < kNumBatchRecords; ++i)
+	{
+		LogRecord& record = records_[readPosition_ & recordMask_];
+		if (record.sequence.load(std::memory_order_acquire) != readPosition_ + 1)
+			break;
+
+		// 時刻は整数のまま書く（浮動小数点の書式は、書き出すスレッドで一番重い）
+		int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::duration(record.ticks - startTicks_)).count();
+		engine::format_to(std::back_inserter(batch), "[{:6}.{:03}] {:<7} ", milliseconds / 1000, milliseconds % 1000, GetLevelName(record.level));
+		record.formatFunction(record.arguments, batch);
+		batch += '\n';
+
+		// 1周後の書き込みに空ける
+		record.sequence.store(readPosition_ + records_.size(), std::memory_order_release);
+		readPosition_++;
+	}
+
+	// 満杯で捨てたものがあれば、その数を残す
+	uint64_t numDropped = numDropped_.load(std::memory_order_relaxed);
+	if (numDropped != numReportedDropped_)
+	{
+		engine::format_to(std::back_inserter(batch), "[{:>10}] {:<7} Logger : dropped {} messages (queue full)\n",
+			"", GetLevelName(LogLevel::Warning), numDropped - numReportedDropped_);
+		numReportedDropped_ = numDropped;
+	}
+
+	if (batch.empty())
+		return false;
+
+	// まとめて1回で書き出す
+	if (file_.is_open())
+	{
+		file_.write(batch.data(), std::streamsize(batch.size()));
+		file_.flush();
+	}
+
+#ifdef _WIN32
+	if (echoDebugger_)
+	{
+		OutputDebugStringA(batch.c_str());
+	}
+#endif
+
+	numWritten_.store(readPosition_, std::memory_order_release);
+	numWritten_.notify_all();
+
+	return true;
+}
+
+// 書き出すスレッドを起こす
+void Logger::WakeWriter()
+{
+	wakeCount_.fetch_add(1, std::memory_order_release);
+	wakeCount_.notify_one();
+}
+
+
+/*------------------
+    LogStream
+------------------*/
+
+// コンストラクタ
+LogStream::LogStream(Logger& logger, LogLevel level)
+	: std::ostream(nullptr), buffer_(logger, level)
+{
+	rdbuf(&buffer_);
+}
+
+// デストラクタ
+LogStream::~LogStream()
+{
+	buffer_.FlushLine();
+}
+
+// 溜まっている行を渡す
+void LogStream::LineBuffer::FlushLine()
+{
+	if (line_.empty())
+		return;
+
+	logger_.WriteMessage(level_, std::move(line_));
+	line_.clear();
+}
+
+// 1文字書き込む
+LogStream::LineBuffer::int_type LogStream::LineBuffer::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	if (traits_type::to_char_type(c) == '\n')
+	{
+		// 空の行もそのまま残す
+		logger_.WriteMessage(level_, std::move(line_));
+		line_.clear();
+	}
+	else
+	{
+		line_ += traits_type::to_char_type(c);
+	}
+
+	return c;
+}
+
+// まとめて書き込む
+std::streamsize LogStream::LineBuffer::xsputn(const char* s, std::streamsize n)
+{
+	std::string_view text(s, size_t(n));
+
+	for (size_t newline = text.find('\n'); newline != std::string_view::npos; newline = text.find('\n'))
+	{
+		line_.append(text.substr(0, newline));
+		logger_.WriteMessage(level_, std::move(line_));
+		line_.clear();
+
+		text.remove_prefix(newline + 1);
+	}
+
+	line_.append(text);
+	return n;
+}
+
+// flushやendlで呼ばれる
+int LogStream::LineBuffer::sync()
+{
+	FlushLine();
+	return 0;
+}
@@ -0,0 +1,274 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <type_traits>
+#include <new>
+#include <bit>
+#include <algorithm>
+#include "../../Func/Format/Format.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// ログの重要度
+enum class LogLevel : uint32_t
+{
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Count
+};
+
+// リングバッファの1つ分（書き込むスレッドが引数を置き、書き出すスレッドが文字列にする）
+typedef struct LogRecord
+{
+	// 引数を置いておける大きさ（超えるものは、書き込むスレッドで文字列にしてから置く）
+	static const uint32_t kArgumentBytes = 192;
+
+	// 書き込みと読み込みの順番（Vyukovの有界キュー）
+	std::atomic<uint64_t> sequence;
+
+	// 重要度
+	LogLevel level;
+
+	// 書き込んだ時刻（steady_clockの目盛り）
+	int64_t ticks;
+
+	// 置いた引数を文字列に書き足し、引数を破棄する関数
+	void (*formatFunction)(void* arguments, std::string& out);
+
+	// 置いた引数
+	alignas(std::max_align_t) unsigned char arguments[kArgumentBytes];
+}LogRecord;
+
+// 複数のスレッドからロックせずに書き込み、専用のスレッドがまとめてファイルに書き出すログ
+class Logger
+{
+public:
+
+	// コンストラクタ（numRecordsは2の累乗に切り上げる）
+	explicit Logger(uint32_t numRecords = 8192);
+
+	// デストラクタ（残っているログを書き出してから止める）
+	~Logger();
+
+	// ファイルを開き、書き出すスレッドを始める（echoDebuggerならデバッガの出力にも書き出す）
+	bool Start(const std::string& filePath, bool echoDebugger = true);
+
+	// 残っているログを全て書き出し、書き出すスレッドを止めてファイルを閉じる
+	void Stop();
+
+	// ここまでに書き込んだログが、ファイルに書き出されるまで待つ
+	void Flush();
+
+	// 書式と引数を書き込む（文字列にするのは書き出すスレッドで行う。const char*やstring_viewの引数はコピーする）
+	template<typename... Args>
+	void Write(LogLevel level, engine::format_string<Args...> format, Args&&... args);
+
+	// 文字列にしたログを書き込む
+	void WriteMessage(LogLevel level, std::string message);
+
+	// 指定した重要度を書き出すかどうか
+	bool IsEnabled(LogLevel level) const { return level >= minLevel_.load(std::memory_order_relaxed); }
+
+	// 重要度の名前
+	static const char* GetLevelName(LogLevel level);
+
+	// Getter
+	bool IsRunning() const { return isRunning_.load(); }
+	uint64_t GetNumDropped() const { return numDropped_.load(std::memory_order_relaxed); }
+	uint64_t GetNumWritten() const { return numWritten_.load(std::memory_order_acquire); }
+
+	// Setter（minLevelより低い重要度は、書き込む前に捨てる）
+	void SetMinLevel(LogLevel minLevel) { minLevel_.store(minLevel, std::memory_order_relaxed); }
+
+
+private:
+
+	// 置いておく引数の型（文字列のポインタやビューは、書き出すまで残っているとは限らないのでコピーする）
+	template<typename T>
+	using StoredArgument = std::conditional_t<
+		std::is_convertible_v<std::decay_t<T>, std::string_view> && !std::is_same_v<std::decay_t<T>, std::string>,
+		std::string, std::decay_t<T>>;
+
+	// 書式と引数をまとめたもの
+	template<typename... Args>
+	struct DeferredArguments
+	{
+		engine::format_string<Args...> format;
+		std::tuple<StoredArgument<Args>...> arguments;
+	};
+
+	// 置いた引数を文字列に書き足し、破棄する
+	template<typename... Args>
+	static void FormatDeferred(void* arguments, std::string& out);
+
+	// 置いた文字列を書き足し、破棄する
+	static void FormatString(void* arguments, std::string& out);
+
+	// リングバッファの場所を1つ確保する（満杯なら、Warningより低いものはnullptrを返して捨て、それ以外は空くまで待つ）
+	LogRecord* Acquire(LogLevel level, uint64_t& position);
+
+	// 引数を置いた場所を、書き出すスレッドに渡す
+	void Publish(LogRecord* record, uint64_t position);
+
+	// 書き出すスレッドの処理
+	void WriterThread();
+
+	// 溜まっているログを1回分まとめて書き出す（書き出したらtrue）
+	bool WriteBatch(std::string& batch);
+
+	// 書き出すスレッドを起こす
+	void WakeWriter();
+
+
+	// 1回にまとめて書き出すログの数
+	static const uint32_t kNumBatchRecords = 1024;
+
+	// リングバッファ
+	std::vector<LogRecord> records_;
+	uint64_t recordMask_ = 0;
+
+	// 書き込む位置（書き込むスレッドが奪い合う）
+	alignas(64) std::atomic<uint64_t> writePosition_{ 0 };
+
+	// 読み込む位置（書き出すスレッドだけが使う）
+	alignas(64) uint64_t readPosition_ = 0;
+
+	// 書き出したログの数
+	alignas(64) std::atomic<uint64_t> numWritten_{ 0 };
+
+	// 満杯で捨てたログの数と、最後にログに書いた数
+	std::atomic<uint64_t> numDropped_{ 0 };
+	uint64_t numReportedDropped_ = 0;
+
+	// 書き出す最低の重要度
+	std::atomic<LogLevel> minLevel_{ LogLevel::Trace };
+
+	// 書き出すスレッドが眠っているかどうかと、起こした回数
+	std::atomic<bool> isWriterSleeping_{ false };
+	std::atomic<uint32_t> wakeCount_{ 0 };
+
+	// 書き出すスレッドを止めるかどうか
+	std::atomic<bool> isStopping_{ false };
+
+	// 書き出すスレッド
+	std::thread writerThread_;
+	std::atomic<bool> isRunning_{ false };
+
+	// 書き出すファイル
+	std::ofstream file_;
+
+	// デバッガの出力にも書き出すかどうか
+	bool echoDebugger_ = true;
+
+	// 時刻の基準
+	int64_t startTicks_ = 0;
+};
+
+// 書式と引数を書き込む
+template<typename... Args>
+inline void Logger::Write(LogLevel level, engine::format_string<Args...> format, Args&&... args)
+{
+	if (IsEnabled(level) == false)
+		return;
+
+	using Deferred = DeferredArguments<Args...>;
+
+	// 置けない引数は、ここで文字列にする
+	if constexpr (sizeof(Deferred) > LogRecord::kArgumentBytes || alignof(Deferred) > alignof(std::max_align_t))
+	{
+		WriteMessage(level, engine::format(format, std::forward<Args>(args)...));
+	}
+	else
+	{
+		uint64_t position = 0;
+		LogRecord* record = Acquire(level, position);
+		if (record == nullptr)
+			return;
+
+		new (record->arguments) Deferred{ format, std::tuple<StoredArgument<Args>...>(std::forward<Args>(args)...) };
+		record->formatFunction = &FormatDeferred<Args...>;
+		Publish(record, position);
+	}
+}
+
+// 置いた引数を文字列に書き足し、破棄する
+template<typename... Args>
+inline void Logger::FormatDeferred(void* arguments, std::string& out)
+{
+	using Deferred = DeferredArguments<Args...>;
+	Deferred* deferred = static_cast<Deferred*>(arguments);
+
+	std::apply([&](auto&... values)
+		{
+			engine::vformat_to(std::back_inserter(out), engine::get_format_text(deferred->format), engine::make_format_args(values...));
+		}, deferred->arguments);
+
+	deferred->~Deferred();
+}
+
+
+// 書き込んだ文字列を1行ずつLoggerに渡すストリーム（Log(os, ...)や os << ... をそのまま使える）
+class LogStream : public std::ostream
+{
+public:
+
+	// コンストラクタ
+	LogStream(Logger& logger, LogLevel level = LogLevel::Info);
+
+	// デストラクタ（改行で終わっていない残りも渡す）
+	~LogStream();
+
+
+private:
+
+	// 行ごとにLoggerへ渡すバッファ
+	class LineBuffer : public std::streambuf
+	{
+	public:
+
+		// コンストラクタ
+		LineBuffer(Logger& logger, LogLevel level) : logger_(logger), level_(level) {}
+
+		// 溜まっている行を渡す
+		void FlushLine();
+
+	protected:
+
+		// 1文字書き込む
+		int_type overflow(int_type c) override;
+
+		// まとめて書き込む
+		std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+		// flushやendlで呼ばれる（ファイルへの書き出しは待たない）
+		int sync() override;
+
+	private:
+
+		// 渡す先
+		Logger& logger_;
+
+		// 重要度
+		LogLevel level_;
+
+		// 改行までの文字列
+		std::string line_;
+	};
+
+	// 行ごとにLoggerへ渡すバッファ
+	LineBuffer buffer_;
+};
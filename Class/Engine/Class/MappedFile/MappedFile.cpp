@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+// デストラクタ
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+// ファイルを開いてマップする（開けなければfalse）
+bool MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+#ifdef _WIN32
+
+	std::wstring filePathW = ConvertString(filePath);
+
+	file_ = CreateFileW(filePathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize{};
+	if (GetFileSizeEx(file_, &fileSize) == FALSE || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+
+#else
+
+	int file = open(filePath.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat fileStat {};
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// マップした後はファイルを閉じてもよい
+	void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	data_ = static_cast<const uint8_t*>(data);
+	size_ = static_cast<size_t>(fileStat.st_size);
+
+#endif
+
+	return true;
+}
+
+// マップを解除して閉じる
+void MappedFile::Close()
+{
+#ifdef _WIN32
+
+	if (data_)
+	{
+		UnmapViewOfFile(data_);
+		data_ = nullptr;
+	}
+
+	if (mapping_)
+	{
+		CloseHandle(mapping_);
+		mapping_ = nullptr;
+	}
+
+	if (file_ != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file_);
+		file_ = INVALID_HANDLE_VALUE;
+	}
+
+#else
+
+	if (data_)
+	{
+		munmap(const_cast<uint8_t*>(data_), size_);
+		data_ = nullptr;
+	}
+
+#endif
+
+	size_ = 0;
+}
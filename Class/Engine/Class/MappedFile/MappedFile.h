@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "../../Func/StringInfo/StringInfo.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ファイルをメモリにマップし、読み込まずにそのまま参照する
+class MappedFile
+{
+public:
+
+	// コンストラクタ
+	MappedFile() = default;
+
+	// 同じファイルを2回閉じないように、コピーはしない
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// デストラクタ
+	~MappedFile();
+
+	// ファイルを開いてマップする（開けなければfalse）
+	bool Open(const std::string& filePath);
+
+	// マップを解除して閉じる
+	void Close();
+
+	// Getter
+	const uint8_t* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+	bool IsOpen() const { return data_ != nullptr; }
+
+
+private:
+
+#ifdef _WIN32
+
+	// ファイル
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+
+	// ファイルマッピング
+	HANDLE mapping_ = nullptr;
+
+#endif
+
+	// マップした先頭
+	const uint8_t* data_ = nullptr;
+
+	// バイト数
+	size_t size_ = 0;
+};
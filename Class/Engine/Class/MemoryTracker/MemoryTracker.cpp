@@ -0,0 +1,421 @@
+#include "MemoryTracker.h"
+
+// 確保したメモリを記録する（同じkeyは何度記録しても1つと数え、同じ回数Removeしたら解放したとみなす）
+void MemoryTracker::Add(const void* key, MemoryCategory category, MemoryHeap heap, const std::string& name, uint64_t bytes)
+{
+	if (key == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = allocations_.find(key);
+	if (it != allocations_.end())
+	{
+		it->second.refCount++;
+		return;
+	}
+
+	allocations_.emplace(key, MemoryAllocation{ category, heap, name, bytes, 1 });
+	AddBytes(category, heap, int64_t(bytes));
+}
+
+// GPUのリソースを記録する（バイト数はデバイスに問い合わせる）
+void MemoryTracker::AddResource(ID3D12Resource* resource, MemoryCategory category, const std::string& name)
+{
+	if (resource == nullptr)
+		return;
+
+	Add(resource, category, MemoryHeap::Gpu, name, GetResourceBytes(resource));
+}
+
+// 解放したメモリの記録を消す（記録していなければ何もしない）
+void MemoryTracker::Remove(const void* key)
+{
+	if (key == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = allocations_.find(key);
+	if (it == allocations_.end())
+		return;
+
+	it->second.refCount--;
+	if (it->second.refCount > 0)
+		return;
+
+	AddBytes(it->second.category, it->second.heap, -int64_t(it->second.bytes));
+	allocations_.erase(it);
+}
+
+// GPUのリソースが実際に使うバイト数（アラインメントを含む）
+uint64_t MemoryTracker::GetResourceBytes(ID3D12Resource* resource)
+{
+	Microsoft::WRL::ComPtr<ID3D12Device> device = nullptr;
+	if (FAILED(resource->GetDevice(IID_PPV_ARGS(&device))))
+		return 0;
+
+	D3D12_RESOURCE_DESC resourceDesc = resource->GetDesc();
+	return device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+}
+
+// 使用量を増減し、最大値と予算を確かめる（ロックしてから呼ぶ）
+void MemoryTracker::AddBytes(MemoryCategory category, MemoryHeap heap, int64_t bytes)
+{
+	uint32_t c = static_cast<uint32_t>(category);
+	uint32_t h = static_cast<uint32_t>(heap);
+
+	uint64_t previousBytes = currentBytes_[c][h];
+	currentBytes_[c][h] = uint64_t(int64_t(previousBytes) + bytes);
+	totalBytes_[h] = uint64_t(int64_t(totalBytes_[h]) + bytes);
+
+	peakBytes_[c][h] = (std::max)(peakBytes_[c][h], currentBytes_[c][h]);
+	peakTotalBytes_[h] = (std::max)(peakTotalBytes_[h], totalBytes_[h]);
+
+	// 予算を超えた瞬間だけ知らせる（超えたまま増えても、何度も知らせない）
+	uint64_t budget = budgetBytes_[c][h];
+	if (budget > 0 && previousBytes <= budget && currentBytes_[c][h] > budget)
+	{
+		budgetWarnings_.push_back(std::format("MemoryTracker : {} {} over budget , {} / {}",
+			GetCategoryName(category), GetHeapName(heap), FormatBytes(currentBytes_[c][h]), FormatBytes(budget)));
+	}
+}
+
+// 予算を超えたときのメッセージを受け取る（受け取ったものは消える）
+std::vector<std::string> MemoryTracker::TakeBudgetWarnings()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<std::string> warnings;
+	warnings.swap(budgetWarnings_);
+	return warnings;
+}
+
+// アセットごとの合計（大きい順）
+std::vector<MemoryAssetTotal> MemoryTracker::GetAssetTotals()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// 同じアセットの確保（テクスチャのリソースと転送用のバッファなど）は、用途と場所ごとにまとめる
+	std::unordered_map<std::string, size_t> indices;
+	std::vector<MemoryAssetTotal> totals;
+
+	for (const auto& allocation : allocations_)
+	{
+		const MemoryAllocation& a = allocation.second;
+		std::string key = std::format("{}|{}|{}", static_cast<uint32_t>(a.category), static_cast<uint32_t>(a.heap), a.name);
+
+		auto it = indices.find(key);
+		if (it == indices.end())
+		{
+			it = indices.emplace(key, totals.size()).first;
+			totals.push_back({ a.category, a.heap, a.name, 0, 0 });
+		}
+
+		totals[it->second].bytes += a.bytes;
+		totals[it->second].numAllocations++;
+	}
+
+	std::sort(totals.begin(), totals.end(),
+		[](const MemoryAssetTotal& a, const MemoryAssetTotal& b) { return a.bytes > b.bytes; });
+
+	return totals;
+}
+
+// 用途の名前
+const char* MemoryTracker::GetCategoryName(MemoryCategory category)
+{
+	switch (category)
+	{
+	case MemoryCategory::Texture: return "Texture";
+	case MemoryCategory::Mesh: return "Mesh";
+	case MemoryCategory::Sound: return "Sound";
+	case MemoryCategory::Upload: return "Upload";
+	case MemoryCategory::RenderTarget: return "RenderTarget";
+	default: return "Other";
+	}
+}
+
+// 場所の名前
+const char* MemoryTracker::GetHeapName(MemoryHeap heap)
+{
+	return heap == MemoryHeap::Cpu ? "CPU" : "GPU";
+}
+
+// 用途と場所ごとの使用量
+uint64_t MemoryTracker::GetCurrentBytes(MemoryCategory category, MemoryHeap heap)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return currentBytes_[static_cast<uint32_t>(category)][static_cast<uint32_t>(heap)];
+}
+
+// 用途と場所ごとの最大値
+uint64_t MemoryTracker::GetPeakBytes(MemoryCategory category, MemoryHeap heap)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return peakBytes_[static_cast<uint32_t>(category)][static_cast<uint32_t>(heap)];
+}
+
+// 用途と場所ごとの予算
+uint64_t MemoryTracker::GetBudgetBytes(MemoryCategory category, MemoryHeap heap)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return budgetBytes_[static_cast<uint32_t>(category)][static_cast<uint32_t>(heap)];
+}
+
+// 場所ごとの合計
+uint64_t MemoryTracker::GetTotalBytes(MemoryHeap heap)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return totalBytes_[static_cast<uint32_t>(heap)];
+}
+
+// 場所ごとの合計の最大値
+uint64_t MemoryTracker::GetPeakTotalBytes(MemoryHeap heap)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return peakTotalBytes_[static_cast<uint32_t>(heap)];
+}
+
+// 予算を設定する（0なら制限しない）
+void MemoryTracker::SetBudgetBytes(MemoryCategory category, MemoryHeap heap, uint64_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	budgetBytes_[static_cast<uint32_t>(category)][static_cast<uint32_t>(heap)] = bytes;
+}
+
+// OSから見たVRAMの予算と使用量を設定する
+void MemoryTracker::SetVideoMemoryInfo(uint64_t budgetBytes, uint64_t usageBytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	videoMemoryBudgetBytes_ = budgetBytes;
+	videoMemoryUsageBytes_ = usageBytes;
+}
+
+// バイト数を読みやすい単位の文字列にする
+std::string MemoryTracker::FormatBytes(uint64_t bytes)
+{
+	if (bytes >= 1024ull * 1024 * 1024)
+		return std::format("{:.2f} GB", double(bytes) / (1024.0 * 1024.0 * 1024.0));
+
+	if (bytes >= 1024ull * 1024)
+		return std::format("{:.2f} MB", double(bytes) / (1024.0 * 1024.0));
+
+	if (bytes >= 1024ull)
+		return std::format("{:.1f} KB", double(bytes) / 1024.0);
+
+	return std::format("{} B", bytes);
+}
+
+// 用途ごとの使用量とアセットごとの内訳を、テキストで書き出す
+bool MemoryTracker::WriteDump(const std::string& filePath)
+{
+	std::vector<MemoryAssetTotal> assetTotals = GetAssetTotals();
+
+	std::ofstream file(filePath, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	file << std::format("{:<14} {:<4} {:>14} {:>14} {:>14}\n", "category", "heap", "current", "peak", "budget");
+
+	for (uint32_t c = 0; c < kNumCategories; ++c)
+	{
+		for (uint32_t h = 0; h < kNumHeaps; ++h)
+		{
+			if (peakBytes_[c][h] == 0 && budgetBytes_[c][h] == 0)
+				continue;
+
+			file << std::format("{:<14} {:<4} {:>14} {:>14} {:>14}{}\n",
+				GetCategoryName(MemoryCategory(c)), GetHeapName(MemoryHeap(h)),
+				FormatBytes(currentBytes_[c][h]), FormatBytes(peakBytes_[c][h]),
+				budgetBytes_[c][h] > 0 ? FormatBytes(budgetBytes_[c][h]) : "-",
+				budgetBytes_[c][h] > 0 && peakBytes_[c][h] > budgetBytes_[c][h] ? "  OVER BUDGET" : "");
+		}
+	}
+
+	for (uint32_t h = 0; h < kNumHeaps; ++h)
+	{
+		file << std::format("{:<14} {:<4} {:>14} {:>14}\n", "total", GetHeapName(MemoryHeap(h)),
+			FormatBytes(totalBytes_[h]), FormatBytes(peakTotalBytes_[h]));
+	}
+
+	if (videoMemoryBudgetBytes_ > 0)
+	{
+		file << std::format("DXGI local video memory : usage {} / budget {}\n",
+			FormatBytes(videoMemoryUsageBytes_), FormatBytes(videoMemoryBudgetBytes_));
+	}
+
+	file << std::format("\n{:<14} {:<4} {:>14} {:>6}  {}\n", "category", "heap", "bytes", "allocs", "asset");
+
+	for (const MemoryAssetTotal& total : assetTotals)
+	{
+		file << std::format("{:<14} {:<4} {:>14} {:>6}  {}\n", GetCategoryName(total.category), GetHeapName(total.heap),
+			FormatBytes(total.bytes), total.numAllocations, total.name);
+	}
+
+	return file.good();
+}
+
+// 計測のウィンドウを描画する（用途ごとの使用量、最大値、予算、アセットごとの内訳、書き出し）
+void MemoryTracker::DrawWindow(const std::string& dumpPathStem)
+{
+	ImGui::Begin("Memory");
+
+
+	/*   全体   */
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		ImGui::Text("CPU %s (peak %s) , GPU %s (peak %s)",
+			FormatBytes(totalBytes_[0]).c_str(), FormatBytes(peakTotalBytes_[0]).c_str(),
+			FormatBytes(totalBytes_[1]).c_str(), FormatBytes(peakTotalBytes_[1]).c_str());
+
+		if (videoMemoryBudgetBytes_ > 0)
+		{
+			ImGui::Text("DXGI local video memory : %s / %s", FormatBytes(videoMemoryUsageBytes_).c_str(), FormatBytes(videoMemoryBudgetBytes_).c_str());
+		}
+	}
+
+#ifdef _WIN32
+	// 記録していないCPUのメモリがどれくらいあるか
+	PROCESS_MEMORY_COUNTERS_EX counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+	{
+		ImGui::Text("process private %s , working set %s",
+			FormatBytes(counters.PrivateUsage).c_str(), FormatBytes(counters.WorkingSetSize).c_str());
+	}
+#endif
+
+
+	/*   用途ごと   */
+
+	ImGui::Separator();
+
+	if (ImGui::BeginTable("##Categories", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("category");
+		ImGui::TableSetupColumn("heap");
+		ImGui::TableSetupColumn("current");
+		ImGui::TableSetupColumn("peak");
+		ImGui::TableSetupColumn("budget");
+		ImGui::TableHeadersRow();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		for (uint32_t c = 0; c < kNumCategories; ++c)
+		{
+			for (uint32_t h = 0; h < kNumHeaps; ++h)
+			{
+				if (peakBytes_[c][h] == 0 && budgetBytes_[c][h] == 0)
+					continue;
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetCategoryName(MemoryCategory(c)));
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetHeapName(MemoryHeap(h)));
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(FormatBytes(currentBytes_[c][h]).c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(FormatBytes(peakBytes_[c][h]).c_str());
+				ImGui::TableNextColumn();
+
+				if (budgetBytes_[c][h] == 0)
+				{
+					ImGui::TextUnformatted("-");
+					continue;
+				}
+
+				// 予算に対する使用量（超えたら赤くする）
+				float ratio = float(double(currentBytes_[c][h]) / double(budgetBytes_[c][h]));
+				bool isOver = currentBytes_[c][h] > budgetBytes_[c][h];
+
+				if (isOver)
+				{
+					ImGui::PushStyleColor(ImGuiCol_PlotHistogram, IM_COL32(220, 60, 60, 255));
+				}
+
+				ImGui::ProgressBar((std::min)(ratio, 1.0f), ImVec2(-1.0f, 0.0f), FormatBytes(budgetBytes_[c][h]).c_str());
+
+				if (isOver)
+				{
+					ImGui::PopStyleColor();
+				}
+			}
+		}
+
+		ImGui::EndTable();
+	}
+
+
+	/*   アセットごと   */
+
+	ImGui::Separator();
+
+	const char* preview = selectedCategory_ < 0 ? "All" : GetCategoryName(MemoryCategory(selectedCategory_));
+	if (ImGui::BeginCombo("Category", preview))
+	{
+		if (ImGui::Selectable("All", selectedCategory_ < 0))
+		{
+			selectedCategory_ = -1;
+		}
+
+		for (uint32_t c = 0; c < kNumCategories; ++c)
+		{
+			if (ImGui::Selectable(GetCategoryName(MemoryCategory(c)), selectedCategory_ == int32_t(c)))
+			{
+				selectedCategory_ = int32_t(c);
+			}
+		}
+
+		ImGui::EndCombo();
+	}
+
+	if (ImGui::BeginTable("##Assets", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 240.0f)))
+	{
+		ImGui::TableSetupColumn("asset");
+		ImGui::TableSetupColumn("category");
+		ImGui::TableSetupColumn("heap");
+		ImGui::TableSetupColumn("bytes");
+		ImGui::TableHeadersRow();
+
+		for (const MemoryAssetTotal& total : GetAssetTotals())
+		{
+			if (selectedCategory_ >= 0 && total.category != MemoryCategory(selectedCategory_))
+				continue;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(total.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(GetCategoryName(total.category));
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(GetHeapName(total.heap));
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(FormatBytes(total.bytes).c_str());
+		}
+
+		ImGui::EndTable();
+	}
+
+
+	/*   書き出し   */
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Write dump"))
+	{
+		std::string filePath = dumpPathStem + "_memory.txt";
+		dumpMessage_ = WriteDump(filePath) ? "wrote " + filePath : "failed to write " + filePath;
+	}
+
+	if (dumpMessage_.empty() == false)
+	{
+		ImGui::TextUnformatted(dumpMessage_.c_str());
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <wrl.h>
+#include <d3d12.h>
+#include "../../externals/imgui/imgui.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#endif
+
+// メモリの用途
+enum class MemoryCategory : uint32_t
+{
+	Texture,
+	Mesh,
+	Sound,
+	Upload,
+	RenderTarget,
+	Other,
+	Count
+};
+
+// メモリの場所
+enum class MemoryHeap : uint32_t
+{
+	Cpu,
+	Gpu,
+	Count
+};
+
+// 記録した確保
+typedef struct MemoryAllocation
+{
+	// 用途と場所
+	MemoryCategory category;
+	MemoryHeap heap;
+
+	// 使っているアセットの名前
+	std::string name;
+
+	// バイト数
+	uint64_t bytes;
+
+	// 同じものを記録した回数（共有しているリソースなど）
+	uint32_t refCount;
+}MemoryAllocation;
+
+// アセットごとの合計
+typedef struct MemoryAssetTotal
+{
+	// 用途と場所
+	MemoryCategory category;
+	MemoryHeap heap;
+
+	// アセットの名前
+	std::string name;
+
+	// バイト数と確保の数
+	uint64_t bytes;
+	uint32_t numAllocations;
+}MemoryAssetTotal;
+
+// 用途と場所ごとに、使っているメモリと最大値を記録し、予算と比べる
+class MemoryTracker
+{
+public:
+
+	// 確保したメモリを記録する（同じkeyは何度記録しても1つと数え、同じ回数Removeしたら解放したとみなす）
+	static void Add(const void* key, MemoryCategory category, MemoryHeap heap, const std::string& name, uint64_t bytes);
+
+	// GPUのリソースを記録する（バイト数はデバイスに問い合わせる）
+	static void AddResource(ID3D12Resource* resource, MemoryCategory category, const std::string& name);
+
+	// 解放したメモリの記録を消す（記録していなければ何もしない）
+	static void Remove(const void* key);
+
+	// GPUのリソースが実際に使うバイト数（アラインメントを含む）
+	static uint64_t GetResourceBytes(ID3D12Resource* resource);
+
+	// 計測のウィンドウを描画する（用途ごとの使用量、最大値、予算、アセットごとの内訳、書き出し）
+	static void DrawWindow(const std::string& dumpPathStem);
+
+	// 用途ごとの使用量とアセットごとの内訳を、テキストで書き出す
+	static bool WriteDump(const std::string& filePath);
+
+	// 予算を超えたときのメッセージを受け取る（受け取ったものは消える）
+	static std::vector<std::string> TakeBudgetWarnings();
+
+	// アセットごとの合計（大きい順）
+	static std::vector<MemoryAssetTotal> GetAssetTotals();
+
+	// 用途の名前
+	static const char* GetCategoryName(MemoryCategory category);
+
+	// 場所の名前
+	static const char* GetHeapName(MemoryHeap heap);
+
+	// Getter
+	static uint64_t GetCurrentBytes(MemoryCategory category, MemoryHeap heap);
+	static uint64_t GetPeakBytes(MemoryCategory category, MemoryHeap heap);
+	static uint64_t GetBudgetBytes(MemoryCategory category, MemoryHeap heap);
+	static uint64_t GetTotalBytes(MemoryHeap heap);
+	static uint64_t GetPeakTotalBytes(MemoryHeap heap);
+
+	// Setter（予算が0なら制限しない）
+	static void SetBudgetBytes(MemoryCategory category, MemoryHeap heap, uint64_t bytes);
+	static void SetVideoMemoryInfo(uint64_t budgetBytes, uint64_t usageBytes);
+
+
+private:
+
+	// バイト数を読みやすい単位の文字列にする
+	static std::string FormatBytes(uint64_t bytes);
+
+	// 使用量を増減し、最大値と予算を確かめる（ロックしてから呼ぶ）
+	static void AddBytes(MemoryCategory category, MemoryHeap heap, int64_t bytes);
+
+
+	// 用途と場所の数
+	static const uint32_t kNumCategories = static_cast<uint32_t>(MemoryCategory::Count);
+	static const uint32_t kNumHeaps = static_cast<uint32_t>(MemoryHeap::Count);
+
+	// 記録を守るロック（読み込みは別のスレッドで行うことがある）
+	static inline std::mutex mutex_;
+
+	// keyごとの確保
+	static inline std::unordered_map<const void*, MemoryAllocation> allocations_;
+
+	// 用途と場所ごとの使用量、最大値、予算
+	static inline uint64_t currentBytes_[kNumCategories][kNumHeaps] = {};
+	static inline uint64_t peakBytes_[kNumCategories][kNumHeaps] = {};
+	static inline uint64_t budgetBytes_[kNumCategories][kNumHeaps] = {};
+
+	// 場所ごとの合計と、その最大値
+	static inline uint64_t totalBytes_[kNumHeaps] = {};
+	static inline uint64_t peakTotalBytes_[kNumHeaps] = {};
+
+	// 予算を超えたときのメッセージ
+	static inline std::vector<std::string> budgetWarnings_;
+
+	// OSから見たVRAMの予算と使用量（DXGI）
+	static inline uint64_t videoMemoryBudgetBytes_ = 0;
+	static inline uint64_t videoMemoryUsageBytes_ = 0;
+
+	// ウィンドウで内訳を見る用途（-1なら全て）
+	static inline int32_t selectedCategory_ = -1;
+
+	// 書き出しの結果
+	static inline std::string dumpMessage_;
+};
+
+// スコープを抜けるまでの一時的な確保を記録する（最大値に残る）
+class MemoryScope
+{
+public:
+
+	// コンストラクタ
+	MemoryScope(const void* key, MemoryCategory category, MemoryHeap heap, const std::string& name, uint64_t bytes)
+		: key_(key)
+	{
+		MemoryTracker::Add(key_, category, heap, name, bytes);
+	}
+
+	// 2回消さないように、コピーはしない
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+
+	// デストラクタ
+	~MemoryScope()
+	{
+		MemoryTracker::Remove(key_);
+	}
+
+
+private:
+
+	// 記録したkey
+	const void* key_ = nullptr;
+};
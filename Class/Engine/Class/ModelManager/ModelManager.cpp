@@ -1,14 +1,33 @@
 #include "ModelManager.h"
 
 // 初期化
-void ModelManager::Initialize()
+void ModelManager::Initialize(GpuMemoryAllocator* memoryAllocator)
 {
 	srand(currentTimer_);
+
+	memoryAllocator_ = memoryAllocator;
 }
 
-// モデルを読み込み、番号を取得する
-uint32_t ModelManager::LoadModelGetNumber(const std::string& directory, const std::string& fileName)
+// モデルを読み込み、番号を取得する（クック済みのメッシュファイルがあればマップして使い、無ければObjからクックする）
+uint32_t ModelManager::LoadModelGetNumber(std::ostream& os, const std::string& directory, const std::string& fileName,
+	Microsoft::WRL::ComPtr<ID3D12Device> device)
 {
+	// 同じパスのモデルを読み込み済みなら、それを共有する
+	std::string pathKey = std::filesystem::path(directory + "/" + fileName).lexically_normal().generic_string();
+
+	auto path = pathSlots_.find(pathKey);
+	if (path != pathSlots_.end())
+	{
+		uint32_t i = path->second;
+		refCounts_[i]++;
+		savedVramBytes_ += gpuBytes_[i];
+
+		Log(os, std::format("LoadModel (shared by path) : {}/{} , refs {} , saved VRAM {} bytes (total {} bytes)",
+			directory, fileName, refCounts_[i], gpuBytes_[i], savedVramBytes_));
+
+		return modelNumbers_[i];
+	}
+
 	// 使用していない（ロードフラグがfalse）場所に、格納する
 	for (uint32_t i = 0; i < kNumModel; ++i)
 	{
@@ -39,9 +58,72 @@ uint32_t ModelManager::LoadModelGetNumber(const std::string& directory, const st
 			}
 		}
 
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// クック済みのメッシュファイルをマップする
+		std::string meshPath = GetMeshCachePath(directory, fileName);
+		MappedFile mappedFile;
+		MeshFileView view{};
+		bool isCacheHit = mappedFile.Open(meshPath) && LoadMeshFile(mappedFile, view);
+
+		// 無ければObjファイルを読んでクックし、書き出したものをマップする
+		if (isCacheHit == false)
+		{
+			mappedFile.Close();
+
+			bool isCooked = CookMeshFile(LoadObjFile(directory, fileName), meshPath);
+			assert(isCooked);
+
+			bool isLoaded = mappedFile.Open(meshPath) && LoadMeshFile(mappedFile, view);
+			assert(isLoaded);
+		}
+
+		// 形状が同じモデルがあれば、頂点とインデックスのバッファを共有する（マテリアルはモデルごと）
+		uint64_t geometryHash = HashBytes(view.vertices.data(), view.vertices.size_bytes());
+		geometryHash = HashBytes(view.indices.data(), view.indices.size_bytes(), geometryHash);
+
+		auto geometry = geometrySlots_.find(geometryHash);
+		if (geometry != geometrySlots_.end())
+		{
+			uint32_t j = geometry->second;
+			vertexResources_[i] = vertexResources_[j];
+			indexResources_[i] = indexResources_[j];
+			vertexAllocations_[i] = vertexAllocations_[j];
+			indexAllocations_[i] = indexAllocations_[j];
+			vertexBufferViews_[i] = vertexBufferViews_[j];
+			indexBufferViews_[i] = indexBufferViews_[j];
+			numIndices_[i] = numIndices_[j];
+			bounds_[i] = bounds_[j];
+			gpuBytes_[i] = gpuBytes_[j];
+
+			savedVramBytes_ += gpuBytes_[j];
+			Log(os, std::format("LoadModel (shared geometry) : {}/{} , saved VRAM {} bytes (total {} bytes)",
+				directory, fileName, gpuBytes_[j], savedVramBytes_));
+		}
+		else
+		{
+			// マップしたメモリから、そのままバッファに書き込む
+			CreateMeshBuffers(i, view, device);
+			geometrySlots_[geometryHash] = i;
+		}
+
+		geometryHashes_[i] = geometryHash;
+		pathSlots_[pathKey] = i;
+		refCounts_[i] = 1;
+		directories_[i] = directory;
+		fileNames_[i] = fileName;
+		TrackMeshBuffers(i);
+
+		// マテリアルの表とサブメッシュは、同じバッファの範囲を指す
+		StoreMaterials(i, view);
+
+		// 読み込みにかかった時間
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		Log(os, std::format("LoadModel {} : {}/{} , {} triangles , {} submeshes , {:.2f}ms", isCacheHit ? "(cache hit)" : "(cooked)",
+			directory, fileName, numIndices_[i] / 3, subMeshes_[i].size(), elapsed.count()));
+
 		// ロードする（ロードフラグをtrueにする）
 		isLoad_[i] = true;
-		modelDatas_[i] = LoadObjFile(directory, fileName);
 		
 		return modelNumbers_[i];
 	}
@@ -51,45 +133,277 @@ uint32_t ModelManager::LoadModelGetNumber(const std::string& directory, const st
 	return 0;
 }
 
-// 指定した番号のモデルの要素数を取得する
-ModelData ModelManager::GetModelData(uint32_t modelNumber)
+// マップしたメッシュファイルから、頂点とインデックスのバッファを作る
+void ModelManager::CreateMeshBuffers(uint32_t slot, const MeshFileView& view, Microsoft::WRL::ComPtr<ID3D12Device> device)
 {
-	for (uint32_t i = 0; i < kNumModel; ++i)
+	uint32_t i = slot;
+
+	// 頂点リソースを作成し、マップしたメモリから1回でコピーする
+	vertexBufferViews_[i].BufferLocation =
+		CreateMeshBuffer(view.vertices.data(), view.vertices.size_bytes(), vertexResources_[i], vertexAllocations_[i], device);
+	vertexBufferViews_[i].SizeInBytes = UINT(view.vertices.size_bytes());
+	vertexBufferViews_[i].StrideInBytes = sizeof(VertexData);
+
+	// インデックスリソースも同じように作る
+	indexBufferViews_[i].BufferLocation =
+		CreateMeshBuffer(view.indices.data(), view.indices.size_bytes(), indexResources_[i], indexAllocations_[i], device);
+	indexBufferViews_[i].SizeInBytes = UINT(view.indices.size_bytes());
+	indexBufferViews_[i].Format = DXGI_FORMAT_R32_UINT;
+
+	numIndices_[i] = uint32_t(view.indices.size());
+	bounds_[i] = view.bounds;
+	gpuBytes_[i] = view.vertices.size_bytes() + view.indices.size_bytes();
+}
+
+// バッファを作ってデータを書き込み、GPUのアドレスを返す（memoryAllocatorがあれば、書き込めるバッファのプールから切り分ける）
+D3D12_GPU_VIRTUAL_ADDRESS ModelManager::CreateMeshBuffer(const void* data, uint64_t sizeInBytes, Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+	GpuBufferAllocation& allocation, Microsoft::WRL::ComPtr<ID3D12Device> device)
+{
+	if (memoryAllocator_ == nullptr)
 	{
-		if (isLoad_[i] == false)
-			continue;
+		resource = CreateBufferResource(device, UINT(sizeInBytes));
+		allocation = {};
 
-		if (modelNumber != modelNumbers_[i])
-			continue;
+		void* mappedData = nullptr;
+		resource->Map(0, nullptr, &mappedData);
+		std::memcpy(mappedData, data, sizeInBytes);
+		resource->Unmap(0, nullptr);
 
-		return modelDatas_[i];
+		return resource->GetGPUVirtualAddress();
 	}
 
-	assert(false);
-	return modelDatas_[0];
+	// プールのバッファはマップしたままなので、そのまま書き込む
+	allocation = memoryAllocator_->AllocateUploadBuffer(sizeInBytes);
+	resource = allocation.resource;
+	std::memcpy(allocation.data, data, sizeInBytes);
+
+	return allocation.gpuAddress;
+}
+
+// 頂点とインデックスのバッファを、GPUが使い終わるまで残す（同じ範囲を使う別のモデルがあれば、プールの範囲は返さない）
+void ModelManager::RetireMeshBuffers(uint32_t slot)
+{
+	retiredResources_.push_back(vertexResources_[slot]);
+	retiredResources_.push_back(indexResources_[slot]);
+
+	if (vertexAllocations_[slot].resource)
+	{
+		bool isShared = false;
+		for (uint32_t j = 0; j < kNumModel; ++j)
+		{
+			if (j != slot && isLoad_[j] && vertexAllocations_[j].data == vertexAllocations_[slot].data)
+			{
+				isShared = true;
+				break;
+			}
+		}
+
+		if (isShared == false)
+		{
+			retiredAllocations_.push_back(vertexAllocations_[slot]);
+			retiredAllocations_.push_back(indexAllocations_[slot]);
+		}
+	}
+
+	vertexAllocations_[slot] = {};
+	indexAllocations_[slot] = {};
+}
+
+// 前のフレームで解放したリソースを解放する（GPUの完了を待ってから呼ぶ）
+void ModelManager::CollectRetiredResources()
+{
+	retiredResources_.clear();
+
+	for (const GpuBufferAllocation& allocation : retiredAllocations_)
+	{
+		memoryAllocator_->FreeUploadBuffer(allocation);
+	}
+	retiredAllocations_.clear();
 }
 
-// 指定した番号のモデルのテクスチャ番号を入力する
-void ModelManager::SetTextureNumber(uint32_t modelNumber, uint32_t textureNumber)
+// マップしたメッシュファイルから、マテリアルの表とサブメッシュを取り出す
+void ModelManager::StoreMaterials(uint32_t slot, const MeshFileView& view)
 {
+	uint32_t i = slot;
+
+	materialDatas_[i].clear();
+	for (const std::string& textureFilePath : view.materialFilePaths)
+	{
+		materialDatas_[i].push_back({ "", textureFilePath });
+	}
+
+	subMeshes_[i].assign(view.subMeshes.begin(), view.subMeshes.end());
+	textureNumbers_[i].assign(materialDatas_[i].size(), 0);
+
+	// マテリアルの表とサブメッシュが使うCPUのメモリ（文字列の中身は数えない）
+	uint64_t cpuBytes = materialDatas_[i].capacity() * sizeof(MaterialData) + subMeshes_[i].capacity() * sizeof(SubMesh) +
+		textureNumbers_[i].capacity() * sizeof(uint32_t);
+
+	MemoryTracker::Remove(&subMeshes_[i]);
+	MemoryTracker::Add(&subMeshes_[i], MemoryCategory::Mesh, MemoryHeap::Cpu, directories_[i] + "/" + fileNames_[i], cpuBytes);
+}
+
+// 頂点とインデックスのバッファを、メモリの記録に加える（共有しているバッファは1つと数える）
+void ModelManager::TrackMeshBuffers(uint32_t slot)
+{
+	std::string name = directories_[slot] + "/" + fileNames_[slot];
+
+	// プールから切り分けた範囲は、同じバッファを使う他の範囲と区別するため、書き込む先で記録する
+	if (vertexAllocations_[slot].resource)
+	{
+		MemoryTracker::Add(vertexAllocations_[slot].data, MemoryCategory::Mesh, MemoryHeap::Gpu, name, vertexAllocations_[slot].sizeInBytes);
+		MemoryTracker::Add(indexAllocations_[slot].data, MemoryCategory::Mesh, MemoryHeap::Gpu, name, indexAllocations_[slot].sizeInBytes);
+		return;
+	}
+
+	MemoryTracker::AddResource(vertexResources_[slot].Get(), MemoryCategory::Mesh, name);
+	MemoryTracker::AddResource(indexResources_[slot].Get(), MemoryCategory::Mesh, name);
+}
+
+// 頂点とインデックスのバッファを、メモリの記録から外す
+void ModelManager::UntrackMeshBuffers(uint32_t slot)
+{
+	if (vertexAllocations_[slot].resource)
+	{
+		MemoryTracker::Remove(vertexAllocations_[slot].data);
+		MemoryTracker::Remove(indexAllocations_[slot].data);
+		return;
+	}
+
+	MemoryTracker::Remove(vertexResources_[slot].Get());
+	MemoryTracker::Remove(indexResources_[slot].Get());
+}
+
+// 形状の索引を、同じバッファを使う別のモデルに引き継ぐ（バッファを手放す前に呼ぶ）
+void ModelManager::HandOverGeometry(uint32_t slot)
+{
+	uint32_t i = slot;
+
+	auto geometry = geometrySlots_.find(geometryHashes_[i]);
+	if (geometry == geometrySlots_.end() || geometry->second != i)
+		return;
+
+	geometrySlots_.erase(geometry);
+
+	for (uint32_t j = 0; j < kNumModel; ++j)
+	{
+		if (j != i && isLoad_[j] && geometryHashes_[j] == geometryHashes_[i])
+		{
+			geometrySlots_[geometryHashes_[j]] = j;
+			break;
+		}
+	}
+}
+
+// 読み込み済みのモデルをObjファイルから読み込み直し、同じ番号のまま中身を差し替える（マテリアルのテクスチャ番号は0に戻る）
+bool ModelManager::ReloadModel(std::ostream& os, uint32_t modelNumber, Microsoft::WRL::ComPtr<ID3D12Device> device)
+{
+	int32_t i = FindSlot(modelNumber);
+	if (i < 0)
+		return false;
+
+	const std::string& directory = directories_[i];
+	const std::string& fileName = fileNames_[i];
+
+	// 保存の途中で消えているときは、次の変更を待つ
+	if (AssetFile::Exists(directory + "/" + fileName) == false)
+		return false;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Mtlファイルだけが変わったときはキャッシュのパスが変わらないので、必ずクックし直す
+	std::string meshPath = GetMeshCachePath(directory, fileName);
+	if (CookMeshFile(LoadObjFile(directory, fileName), meshPath) == false)
+		return false;
+
+	MappedFile mappedFile;
+	MeshFileView view{};
+	if (mappedFile.Open(meshPath) == false || LoadMeshFile(mappedFile, view) == false)
+		return false;
+
+	// 古いバッファは、このフレームのコマンドが使っているかもしれないので、次のフレームまで残す（共有している別のモデルはそのまま使う）
+	UntrackMeshBuffers(i);
+	RetireMeshBuffers(i);
+	HandOverGeometry(i);
+
+	CreateMeshBuffers(i, view, device);
+	TrackMeshBuffers(i);
+
+	uint64_t geometryHash = HashBytes(view.vertices.data(), view.vertices.size_bytes());
+	geometryHashes_[i] = HashBytes(view.indices.data(), view.indices.size_bytes(), geometryHash);
+	geometrySlots_.try_emplace(geometryHashes_[i], uint32_t(i));
+
+	StoreMaterials(i, view);
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	Log(os, std::format("ReloadModel : {}/{} , {} triangles , {} submeshes , refs {} , {:.2f}ms",
+		directory, fileName, numIndices_[i] / 3, subMeshes_[i].size(), refCounts_[i], elapsed.count()));
+
+	return true;
+}
+
+// ファイルを使っているモデルの番号を探す（Objファイルそのもの、または同じディレクトリのMtlファイル）
+std::vector<uint32_t> ModelManager::FindModelsUsingFile(const std::string& filePath)
+{
+	std::filesystem::path path = std::filesystem::path(filePath).lexically_normal();
+	bool isMaterialFile = path.extension() == ".mtl";
+
+	std::vector<uint32_t> modelNumbers;
+
 	for (uint32_t i = 0; i < kNumModel; ++i)
 	{
 		if (isLoad_[i] == false)
 			continue;
 
-		if (modelNumber != modelNumbers_[i])
-			continue;
+		std::filesystem::path sourcePath = std::filesystem::path(directories_[i] + "/" + fileNames_[i]).lexically_normal();
 
-		textureNumbers_[i] = textureNumber;
+		// Mtlファイルはパスを覚えていないので、Objファイルと同じディレクトリにあるものを使っているとみなす
+		if (path == sourcePath || (isMaterialFile && path.parent_path() == sourcePath.parent_path()))
+		{
+			modelNumbers.push_back(modelNumbers_[i]);
+		}
+	}
+
+	return modelNumbers;
+}
 
-		break;
+// 指定したモデルの参照を1つ減らす（誰も使わなくなったら、GPUが使い終わってから解放する）
+bool ModelManager::ReleaseModel(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	if (i < 0)
+	{
+		assert(false);
+		return false;
 	}
 
-	return;
+	refCounts_[i]--;
+	if (refCounts_[i] > 0)
+		return false;
+
+	// 他のモデルと共有しているバッファは、参照が無くなったときに解放される
+	UntrackMeshBuffers(i);
+	RetireMeshBuffers(i);
+	vertexResources_[i] = nullptr;
+	indexResources_[i] = nullptr;
+
+	// 索引から外す（形状の索引は、同じバッファを使う別のモデルに引き継ぐ）
+	std::erase_if(pathSlots_, [i](const std::pair<const std::string, uint32_t>& entry) { return entry.second == uint32_t(i); });
+
+	HandOverGeometry(i);
+
+	MemoryTracker::Remove(&subMeshes_[i]);
+	materialDatas_[i].clear();
+	subMeshes_[i].clear();
+	textureNumbers_[i].clear();
+	modelNumbers_[i] = 0;
+	isLoad_[i] = false;
+
+	return true;
 }
 
-// 指定した番号のモデルのテクスチャを取得する
-uint32_t ModelManager::GetTextureNumber(uint32_t modelNumber)
+// モデル番号から格納場所を探す
+int32_t ModelManager::FindSlot(uint32_t modelNumber)
 {
 	for (uint32_t i = 0; i < kNumModel; ++i)
 	{
@@ -99,9 +413,90 @@ uint32_t ModelManager::GetTextureNumber(uint32_t modelNumber)
 		if (modelNumber != modelNumbers_[i])
 			continue;
 
-		return textureNumbers_[i];
+		return int32_t(i);
 	}
 
-	assert(false);
-	return textureNumbers_[0];
-}
\ No newline at end of file
+	return -1;
+}
+
+// 指定した番号のモデルの参照の数を取得する
+uint32_t ModelManager::GetReferenceCount(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return refCounts_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルのマテリアルの表を取得する
+const std::vector<MaterialData>& ModelManager::GetMaterialDatas(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return materialDatas_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルのサブメッシュを取得する
+const std::vector<SubMesh>& ModelManager::GetSubMeshes(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return subMeshes_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルのVBVを取得する
+const D3D12_VERTEX_BUFFER_VIEW& ModelManager::GetVertexBufferView(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return vertexBufferViews_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルのIBVを取得する
+const D3D12_INDEX_BUFFER_VIEW& ModelManager::GetIndexBufferView(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return indexBufferViews_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルのインデックスの数を取得する
+uint32_t ModelManager::GetNumIndices(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return numIndices_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルの境界ボックスを取得する
+const MeshBounds& ModelManager::GetBounds(uint32_t modelNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	assert(i >= 0);
+	return bounds_[(std::max)(i, 0)];
+}
+
+// 指定した番号のモデルの、マテリアルのテクスチャ番号を入力する
+void ModelManager::SetTextureNumber(uint32_t modelNumber, uint32_t materialIndex, uint32_t textureNumber)
+{
+	int32_t i = FindSlot(modelNumber);
+	if (i < 0 || materialIndex >= textureNumbers_[i].size())
+	{
+		assert(false);
+		return;
+	}
+
+	textureNumbers_[i][materialIndex] = textureNumber;
+}
+
+// 指定した番号のモデルの、マテリアルのテクスチャを取得する
+uint32_t ModelManager::GetTextureNumber(uint32_t modelNumber, uint32_t materialIndex)
+{
+	int32_t i = FindSlot(modelNumber);
+	if (i < 0 || materialIndex >= textureNumbers_[i].size())
+	{
+		assert(false);
+		return 0;
+	}
+
+	return textureNumbers_[i][materialIndex];
+}
@@ -1,45 +1,157 @@
 #pragma once
 #include <stdlib.h>
 #include <time.h>
+#include <wrl.h>
+#include <unordered_map>
+#include <d3d12.h>
 #include "../../Struct.h"
 #include "../../Func/ModelData/ModelData.h"
+#include "../../Func/MeshFile/MeshFile.h"
+#include "../../Func/Create/Create.h"
+#include "../MappedFile/MappedFile.h"
+#include "../MemoryTracker/MemoryTracker.h"
+#include "../GpuMemoryAllocator/GpuMemoryAllocator.h"
 
 class ModelManager
 {
 public:
 
-	// 初期化
-	void Initialize();
+	// 初期化（memoryAllocatorがあれば、頂点とインデックスのバッファを書き込めるバッファのプールから切り分ける。無ければリソースごとにコミットする）
+	void Initialize(GpuMemoryAllocator* memoryAllocator = nullptr);
 
-	// モデルを読み込み、番号を取得する
-	uint32_t LoadModelGetNumber(const std::string& directory, const std::string& fileName);
+	// モデルを読み込み、番号を取得する（クック済みのメッシュファイルがあればマップして使い、無ければObjからクックする）
+	uint32_t LoadModelGetNumber(std::ostream& os, const std::string& directory, const std::string& fileName,
+		Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// 読み込み済みのモデルをObjファイルから読み込み直し、同じ番号のまま中身を差し替える（マテリアルのテクスチャ番号は0に戻る）
+	bool ReloadModel(std::ostream& os, uint32_t modelNumber, Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// ファイルを使っているモデルの番号を探す（Objファイルそのもの、または同じディレクトリのMtlファイル）
+	std::vector<uint32_t> FindModelsUsingFile(const std::string& filePath);
+
+	// 指定したモデルの参照を1つ減らす（誰も使わなくなったら、GPUが使い終わってから解放してtrueを返す）
+	bool ReleaseModel(uint32_t modelNumber);
+
+	// 前のフレームで解放したリソースを解放する（GPUの完了を待ってから呼ぶ）
+	void CollectRetiredResources();
 
 	// Getter
 	uint32_t GetNumModel() { return kNumModel; }
-	uint32_t GetTextureNumber(uint32_t modelNumber);
-	ModelData GetModelData(uint32_t modelNumber);
+	uint32_t GetReferenceCount(uint32_t modelNumber);
+	uint64_t GetSavedVramBytes() const { return savedVramBytes_; }
+	uint32_t GetTextureNumber(uint32_t modelNumber, uint32_t materialIndex);
+	const std::vector<MaterialData>& GetMaterialDatas(uint32_t modelNumber);
+	const std::vector<SubMesh>& GetSubMeshes(uint32_t modelNumber);
+	const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView(uint32_t modelNumber);
+	const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView(uint32_t modelNumber);
+	uint32_t GetNumIndices(uint32_t modelNumber);
+	const MeshBounds& GetBounds(uint32_t modelNumber);
 	
 	// Setter
-	void SetTextureNumber(uint32_t modelNumber , uint32_t textureNumber);
+	void SetTextureNumber(uint32_t modelNumber, uint32_t materialIndex, uint32_t textureNumber);
 
 private:
 
+	// ベンチマークから、GPUで読み込まずに格納場所を埋めて、番号の検索を計測する
+	friend class HandleLookupBenchmark;
+
+	// モデル番号から格納場所を探す
+	int32_t FindSlot(uint32_t modelNumber);
+
+	// マップしたメッシュファイルから、頂点とインデックスのバッファを作る
+	void CreateMeshBuffers(uint32_t slot, const MeshFileView& view, Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// バッファを作ってデータを書き込み、GPUのアドレスを返す（memoryAllocatorがあれば、書き込めるバッファのプールから切り分ける）
+	D3D12_GPU_VIRTUAL_ADDRESS CreateMeshBuffer(const void* data, uint64_t sizeInBytes, Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+		GpuBufferAllocation& allocation, Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// 頂点とインデックスのバッファを、GPUが使い終わるまで残す（同じ範囲を使う別のモデルがあれば、プールの範囲は返さない）
+	void RetireMeshBuffers(uint32_t slot);
+
+	// マップしたメッシュファイルから、マテリアルの表とサブメッシュを取り出す
+	void StoreMaterials(uint32_t slot, const MeshFileView& view);
+
+	// 形状の索引を、同じバッファを使う別のモデルに引き継ぐ（バッファを手放す前に呼ぶ）
+	void HandOverGeometry(uint32_t slot);
+
+	// 頂点とインデックスのバッファを、メモリの記録に加える（共有しているバッファは1つと数える）
+	void TrackMeshBuffers(uint32_t slot);
+
+	// 頂点とインデックスのバッファを、メモリの記録から外す
+	void UntrackMeshBuffers(uint32_t slot);
+
+
 	// 時間
 	unsigned int currentTimer_ = static_cast<unsigned int>(time(nullptr));
 
 	// 使用できるモデル数
 	const uint32_t kNumModel = 256;
 
-	// モデルデータ
-	ModelData modelDatas_[256] = {};
+	// マテリアルの表
+	std::vector<MaterialData> materialDatas_[256];
+
+	// サブメッシュ（全て同じ頂点、インデックスのバッファを使う）
+	std::vector<SubMesh> subMeshes_[256];
+
+	// 頂点リソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResources_[256] = { nullptr };
+
+	// インデックスリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResources_[256] = { nullptr };
+
+	// 頂点とインデックスのバッファを切り分けるプール（無ければ、リソースごとにコミットする）と、切り分けた範囲
+	GpuMemoryAllocator* memoryAllocator_ = nullptr;
+	GpuBufferAllocation vertexAllocations_[256] = {};
+	GpuBufferAllocation indexAllocations_[256] = {};
+
+	// VBV
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferViews_[256] = {};
+
+	// IBV
+	D3D12_INDEX_BUFFER_VIEW indexBufferViews_[256] = {};
+
+	// インデックスの数
+	uint32_t numIndices_[256] = { 0 };
+
+	// 境界ボックス
+	MeshBounds bounds_[256] = {};
 
 	// モデル番号
 	uint32_t modelNumbers_[256] = { 0 };
 
-	// テクスチャの番号
-	uint32_t textureNumbers_[256] = { 0 };
+	// 読み込んだObjファイルのディレクトリとファイル名
+	std::string directories_[256];
+	std::string fileNames_[256];
+
+	// マテリアルごとのテクスチャの番号
+	std::vector<uint32_t> textureNumbers_[256];
 
 	// 読み込んでいるかどうか（ロードフラグ）
 	UINT isLoad_[256] = { false };
+
+
+	/*   共有   */
+
+	// 参照の数
+	uint32_t refCounts_[256] = { 0 };
+
+	// 頂点とインデックスのハッシュ値
+	uint64_t geometryHashes_[256] = { 0 };
+
+	// 頂点とインデックスのバッファのバイト数
+	uint64_t gpuBytes_[256] = { 0 };
+
+	// パスから格納場所を引く索引
+	std::unordered_map<std::string, uint32_t> pathSlots_;
+
+	// 頂点とインデックスのハッシュ値から、バッファを持つ格納場所を引く索引
+	std::unordered_map<uint64_t, uint32_t> geometrySlots_;
+
+	// 共有して節約できたバイト数
+	uint64_t savedVramBytes_ = 0;
+
+	// 解放を待っているリソースと、プールから切り分けた範囲（GPUの完了後に解放する）
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retiredResources_;
+	std::vector<GpuBufferAllocation> retiredAllocations_;
 };
 
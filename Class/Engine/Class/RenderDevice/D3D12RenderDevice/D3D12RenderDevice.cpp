@@ -0,0 +1,152 @@
+#include "D3D12RenderDevice.h"
+
+// コンストラクタ
+D3D12RenderDevice::D3D12RenderDevice(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, GpuMemoryAllocator* memoryAllocator)
+	: memoryAllocator_(memoryAllocator), commandList_(commandList)
+{
+	frameBuffers_.reserve(1024);
+}
+
+// 描画ごとのバッファを確保する
+RenderBuffer D3D12RenderDevice::CreateUploadBuffer(uint32_t sizeInBytes)
+{
+	GpuBufferAllocation allocation = memoryAllocator_->AllocateUploadBuffer(sizeInBytes);
+
+	RenderBuffer buffer{};
+	buffer.data = allocation.data;
+	buffer.gpuAddress = allocation.gpuAddress;
+	buffer.sizeInBytes = sizeInBytes;
+
+	frameBuffers_.push_back(allocation);
+
+	return buffer;
+}
+
+// ビューポートを設定する
+void D3D12RenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	static_assert(sizeof(RenderViewport) == sizeof(D3D12_VIEWPORT));
+	commandList_->RSSetViewports(1, reinterpret_cast<const D3D12_VIEWPORT*>(&viewport));
+}
+
+// シザーレクトを設定する
+void D3D12RenderDevice::SetScissorRect(const RenderRect& scissorRect)
+{
+	static_assert(sizeof(RenderRect) == sizeof(D3D12_RECT));
+	commandList_->RSSetScissorRects(1, reinterpret_cast<const D3D12_RECT*>(&scissorRect));
+}
+
+// ルートシグネチャを設定する
+void D3D12RenderDevice::SetRootSignature(RenderHandle rootSignature)
+{
+	if (rootSignature_ == rootSignature)
+		return;
+
+	commandList_->SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(rootSignature));
+	rootSignature_ = rootSignature;
+
+	// ルートシグネチャが変わると、設定した引数は無効になる
+	for (RenderHandle& descriptorTable : descriptorTables_)
+	{
+		descriptorTable = 0;
+	}
+}
+
+// PSOを設定する
+void D3D12RenderDevice::SetPipelineState(RenderHandle pipelineState)
+{
+	if (pipelineState_ == pipelineState)
+		return;
+
+	commandList_->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(pipelineState));
+	pipelineState_ = pipelineState;
+}
+
+// 頂点バッファを設定する
+void D3D12RenderDevice::SetVertexBuffer(const RenderVertexBufferView& view)
+{
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+	vertexBufferView.BufferLocation = view.gpuAddress;
+	vertexBufferView.SizeInBytes = view.sizeInBytes;
+	vertexBufferView.StrideInBytes = view.strideInBytes;
+	commandList_->IASetVertexBuffers(0, 1, &vertexBufferView);
+}
+
+// インデックスバッファを設定する
+void D3D12RenderDevice::SetIndexBuffer(const RenderIndexBufferView& view)
+{
+	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+	indexBufferView.BufferLocation = view.gpuAddress;
+	indexBufferView.SizeInBytes = view.sizeInBytes;
+	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	commandList_->IASetIndexBuffer(&indexBufferView);
+}
+
+// 形状を設定する
+void D3D12RenderDevice::SetPrimitiveTopology(RenderTopology topology)
+{
+	switch (topology)
+	{
+	case RenderTopology::TriangleList:
+	default:
+		commandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		break;
+	}
+}
+
+// ルートの引数に、定数バッファのアドレスを設定する
+void D3D12RenderDevice::SetConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuAddress)
+{
+	commandList_->SetGraphicsRootConstantBufferView(rootParameterIndex, gpuAddress);
+}
+
+// ルートの引数に、ディスクリプタテーブルを設定する
+void D3D12RenderDevice::SetDescriptorTable(uint32_t rootParameterIndex, RenderHandle gpuDescriptor)
+{
+	assert(rootParameterIndex < kMaxRootParameters);
+
+	if (descriptorTables_[rootParameterIndex] == gpuDescriptor)
+		return;
+
+	D3D12_GPU_DESCRIPTOR_HANDLE descriptorHandle{};
+	descriptorHandle.ptr = gpuDescriptor;
+	commandList_->SetGraphicsRootDescriptorTable(rootParameterIndex, descriptorHandle);
+	descriptorTables_[rootParameterIndex] = gpuDescriptor;
+}
+
+// 描画する
+void D3D12RenderDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	commandList_->DrawInstanced(vertexCount, 1, startVertex, 0);
+}
+
+// インデックスを使って描画する
+void D3D12RenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	commandList_->DrawIndexedInstanced(indexCount, 1, startIndex, baseVertex, 0);
+}
+
+// フレームを終える
+uint64_t D3D12RenderDevice::FinishFrame()
+{
+	// 定数バッファの揃え（256バイト）で切り分けたので、その大きさで数える
+	uint64_t frameBufferBytes = 0;
+	for (const GpuBufferAllocation& allocation : frameBuffers_)
+	{
+		uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+		frameBufferBytes += (allocation.sizeInBytes + alignment - 1) / alignment * alignment;
+		memoryAllocator_->FreeUploadBuffer(allocation);
+	}
+
+	frameBuffers_.clear();
+
+	// リセットしたコマンドリストには、何も設定されていない
+	rootSignature_ = 0;
+	pipelineState_ = 0;
+	for (RenderHandle& descriptorTable : descriptorTables_)
+	{
+		descriptorTable = 0;
+	}
+
+	return frameBufferBytes;
+}
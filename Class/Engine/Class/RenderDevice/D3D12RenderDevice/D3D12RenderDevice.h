@@ -0,0 +1,81 @@
+#pragma once
+#include <Windows.h>
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+#include <wrl.h>
+#include <d3d12.h>
+#include "../RenderDevice.h"
+#include "../../GpuMemoryAllocator/GpuMemoryAllocator.h"
+
+#pragma comment(lib,"d3d12.lib")
+
+// D3D12のコマンドリストに描画のコマンドを積む
+class D3D12RenderDevice : public RenderDevice
+{
+public:
+
+	// コンストラクタ（描画ごとのバッファは、memoryAllocatorの書き込めるバッファのプールから切り分ける）
+	D3D12RenderDevice(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, GpuMemoryAllocator* memoryAllocator);
+
+	// 描画ごとのバッファを確保する（書き込めるようにしておき、FinishFrameで解放する）
+	RenderBuffer CreateUploadBuffer(uint32_t sizeInBytes) override;
+
+	// ビューポートを設定する
+	void SetViewport(const RenderViewport& viewport) override;
+
+	// シザーレクトを設定する
+	void SetScissorRect(const RenderRect& scissorRect) override;
+
+	// ルートシグネチャを設定する（同じものなら設定し直さない）
+	void SetRootSignature(RenderHandle rootSignature) override;
+
+	// PSOを設定する（同じものなら設定し直さない）
+	void SetPipelineState(RenderHandle pipelineState) override;
+
+	// 頂点バッファを設定する
+	void SetVertexBuffer(const RenderVertexBufferView& view) override;
+
+	// インデックスバッファを設定する
+	void SetIndexBuffer(const RenderIndexBufferView& view) override;
+
+	// 形状を設定する
+	void SetPrimitiveTopology(RenderTopology topology) override;
+
+	// ルートの引数に、定数バッファのアドレスを設定する
+	void SetConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuAddress) override;
+
+	// ルートの引数に、ディスクリプタテーブルを設定する（同じものが設定されたままなら設定し直さない）
+	void SetDescriptorTable(uint32_t rootParameterIndex, RenderHandle gpuDescriptor) override;
+
+	// 描画する
+	void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+
+	// インデックスを使って描画する
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+
+	// フレームを終える（GPUの完了を待ち、コマンドリストをリセットしてから呼ぶ）
+	uint64_t FinishFrame() override;
+
+
+private:
+
+	// バッファを切り分けるもの
+	GpuMemoryAllocator* memoryAllocator_ = nullptr;
+
+	// コマンドリスト
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_ = nullptr;
+
+	// このフレームで確保したバッファ
+	std::vector<GpuBufferAllocation> frameBuffers_;
+
+	// 設定中のルートシグネチャとPSO
+	RenderHandle rootSignature_ = 0;
+	RenderHandle pipelineState_ = 0;
+
+	// ルートの引数の数の上限
+	static const uint32_t kMaxRootParameters = 16;
+
+	// 設定中のディスクリプタテーブル
+	RenderHandle descriptorTables_[kMaxRootParameters] = {};
+};
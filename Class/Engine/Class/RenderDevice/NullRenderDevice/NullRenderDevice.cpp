@@ -0,0 +1,395 @@
+#include "NullRenderDevice.h"
+
+// コンストラクタ
+NullRenderDevice::NullRenderDevice(uint32_t numRootParameters, uint32_t requiredRootParameterMask)
+	: numRootParameters_(numRootParameters < kMaxRootParameters ? numRootParameters : kMaxRootParameters), requiredRootParameterMask_(requiredRootParameterMask)
+{
+
+}
+
+// 描画ごとのバッファを作る
+RenderBuffer NullRenderDevice::CreateUploadBuffer(uint32_t sizeInBytes)
+{
+	if (sizeInBytes == 0)
+	{
+		ReportError("CreateUploadBuffer : size is 0");
+	}
+
+	// まとまりに入らなければ次のまとまりに進む（無いか小さければ、そこに作る）
+	size_t alignedSize = (size_t(sizeInBytes) + 15) & ~size_t(15);
+	if (chunks_.empty() || chunkOffset_ + alignedSize > chunks_[chunkIndex_].size)
+	{
+		if (chunks_.empty() == false)
+		{
+			++chunkIndex_;
+		}
+
+		if (chunkIndex_ >= chunks_.size() || chunks_[chunkIndex_].size < alignedSize)
+		{
+			Chunk chunk;
+			chunk.size = alignedSize > kChunkSize ? alignedSize : kChunkSize;
+			chunk.memory = std::make_unique<uint8_t[]>(chunk.size);
+			chunks_.insert(chunks_.begin() + chunkIndex_, std::move(chunk));
+		}
+
+		chunkOffset_ = 0;
+	}
+
+	RenderBuffer buffer{};
+	buffer.data = chunks_[chunkIndex_].memory.get() + chunkOffset_;
+	buffer.gpuAddress = nextUploadAddress_;
+	buffer.sizeInBytes = sizeInBytes;
+
+	chunkOffset_ += alignedSize;
+
+	// 定数バッファにも使えるように、アドレスは256バイトに揃える
+	uint64_t addressSize = (uint64_t(sizeInBytes) + kConstantBufferAlignment - 1) & ~(kConstantBufferAlignment - 1);
+	nextUploadAddress_ += addressSize;
+
+	stats_.numUploadBuffers++;
+	stats_.uploadBytes += addressSize;
+
+	return buffer;
+}
+
+// ビューポートを設定する
+void NullRenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	if (viewport.Width <= 0.0f || viewport.Height <= 0.0f || viewport.MinDepth > viewport.MaxDepth)
+	{
+		ReportError(engine::format("SetViewport : invalid viewport {}x{} depth {}..{}", viewport.Width, viewport.Height, viewport.MinDepth, viewport.MaxDepth));
+	}
+
+	bool isRedundant = hasViewport_ && viewport_.TopLeftX == viewport.TopLeftX && viewport_.TopLeftY == viewport.TopLeftY &&
+		viewport_.Width == viewport.Width && viewport_.Height == viewport.Height &&
+		viewport_.MinDepth == viewport.MinDepth && viewport_.MaxDepth == viewport.MaxDepth;
+	CountStateChange(isRedundant);
+
+	viewport_ = viewport;
+	hasViewport_ = true;
+
+	Record(RenderCommandType::SetViewport);
+}
+
+// シザーレクトを設定する
+void NullRenderDevice::SetScissorRect(const RenderRect& scissorRect)
+{
+	if (scissorRect.left >= scissorRect.right || scissorRect.top >= scissorRect.bottom)
+	{
+		ReportError(engine::format("SetScissorRect : empty rect ({}, {}) - ({}, {})", scissorRect.left, scissorRect.top, scissorRect.right, scissorRect.bottom));
+	}
+
+	bool isRedundant = hasScissorRect_ && scissorRect_.left == scissorRect.left && scissorRect_.top == scissorRect.top &&
+		scissorRect_.right == scissorRect.right && scissorRect_.bottom == scissorRect.bottom;
+	CountStateChange(isRedundant);
+
+	scissorRect_ = scissorRect;
+	hasScissorRect_ = true;
+
+	Record(RenderCommandType::SetScissorRect);
+}
+
+// ルートシグネチャを設定する
+void NullRenderDevice::SetRootSignature(RenderHandle rootSignature)
+{
+	if (rootSignature == 0)
+	{
+		ReportError("SetRootSignature : null root signature");
+	}
+
+	bool isRedundant = rootSignature_ == rootSignature;
+	CountStateChange(isRedundant);
+
+	// ルートシグネチャが変わると、設定した引数は無効になる
+	if (isRedundant == false)
+	{
+		boundRootParameterMask_ = 0;
+	}
+
+	rootSignature_ = rootSignature;
+
+	Record(RenderCommandType::SetRootSignature, rootSignature);
+}
+
+// PSOを設定する
+void NullRenderDevice::SetPipelineState(RenderHandle pipelineState)
+{
+	if (pipelineState == 0)
+	{
+		ReportError("SetPipelineState : null pipeline state");
+	}
+
+	CountStateChange(pipelineState_ == pipelineState);
+	pipelineState_ = pipelineState;
+
+	Record(RenderCommandType::SetPipelineState, pipelineState);
+}
+
+// 頂点バッファを設定する
+void NullRenderDevice::SetVertexBuffer(const RenderVertexBufferView& view)
+{
+	if (IsValidAddress(view.gpuAddress) == false)
+	{
+		ReportError(engine::format("SetVertexBuffer : unknown address {:#x}", view.gpuAddress));
+	}
+
+	if (view.strideInBytes == 0 || view.sizeInBytes % view.strideInBytes != 0)
+	{
+		ReportError(engine::format("SetVertexBuffer : size {} is not a multiple of stride {}", view.sizeInBytes, view.strideInBytes));
+	}
+
+	CountStateChange(vertexBuffer_.gpuAddress == view.gpuAddress && vertexBuffer_.sizeInBytes == view.sizeInBytes &&
+		vertexBuffer_.strideInBytes == view.strideInBytes);
+	vertexBuffer_ = view;
+
+	Record(RenderCommandType::SetVertexBuffer, view.gpuAddress, view.sizeInBytes, view.strideInBytes);
+}
+
+// インデックスバッファを設定する
+void NullRenderDevice::SetIndexBuffer(const RenderIndexBufferView& view)
+{
+	if (IsValidAddress(view.gpuAddress) == false)
+	{
+		ReportError(engine::format("SetIndexBuffer : unknown address {:#x}", view.gpuAddress));
+	}
+
+	if (view.sizeInBytes % sizeof(uint32_t) != 0)
+	{
+		ReportError(engine::format("SetIndexBuffer : size {} is not a multiple of 4", view.sizeInBytes));
+	}
+
+	CountStateChange(indexBuffer_.gpuAddress == view.gpuAddress && indexBuffer_.sizeInBytes == view.sizeInBytes);
+	indexBuffer_ = view;
+
+	Record(RenderCommandType::SetIndexBuffer, view.gpuAddress, view.sizeInBytes);
+}
+
+// 形状を設定する
+void NullRenderDevice::SetPrimitiveTopology(RenderTopology topology)
+{
+	CountStateChange(hasTopology_);
+	hasTopology_ = true;
+
+	Record(RenderCommandType::SetPrimitiveTopology, uint64_t(topology));
+}
+
+// ルートの引数に、定数バッファのアドレスを設定する
+void NullRenderDevice::SetConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuAddress)
+{
+	stats_.numRootArguments++;
+	Record(RenderCommandType::SetConstantBuffer, rootParameterIndex, gpuAddress);
+
+	if (rootParameterIndex >= numRootParameters_)
+	{
+		ReportError(engine::format("SetConstantBuffer : root parameter {} is out of range ({})", rootParameterIndex, numRootParameters_));
+		return;
+	}
+
+	if (IsValidAddress(gpuAddress) == false || gpuAddress % kConstantBufferAlignment != 0)
+	{
+		ReportError(engine::format("SetConstantBuffer : root parameter {} has invalid address {:#x}", rootParameterIndex, gpuAddress));
+	}
+
+	rootArguments_[rootParameterIndex] = gpuAddress;
+	boundRootParameterMask_ |= 1u << rootParameterIndex;
+}
+
+// ルートの引数に、ディスクリプタテーブルを設定する
+void NullRenderDevice::SetDescriptorTable(uint32_t rootParameterIndex, RenderHandle gpuDescriptor)
+{
+	stats_.numRootArguments++;
+	Record(RenderCommandType::SetDescriptorTable, rootParameterIndex, gpuDescriptor);
+
+	if (rootParameterIndex >= numRootParameters_)
+	{
+		ReportError(engine::format("SetDescriptorTable : root parameter {} is out of range ({})", rootParameterIndex, numRootParameters_));
+		return;
+	}
+
+	if (gpuDescriptor == 0)
+	{
+		ReportError(engine::format("SetDescriptorTable : root parameter {} has null descriptor", rootParameterIndex));
+	}
+
+	// 同じテーブルを設定し直したものも数える（D3D12の方では省く）
+	bool isBound = (boundRootParameterMask_ & (1u << rootParameterIndex)) != 0;
+	if (isBound && rootArguments_[rootParameterIndex] == gpuDescriptor)
+	{
+		stats_.numRedundantStateChanges++;
+	}
+
+	rootArguments_[rootParameterIndex] = gpuDescriptor;
+	boundRootParameterMask_ |= 1u << rootParameterIndex;
+}
+
+// 描画する
+void NullRenderDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	Record(RenderCommandType::Draw, vertexCount, startVertex);
+
+	if (ValidateDraw("Draw") && vertexBuffer_.strideInBytes != 0)
+	{
+		uint64_t numBufferVertices = vertexBuffer_.sizeInBytes / vertexBuffer_.strideInBytes;
+		if (uint64_t(startVertex) + vertexCount > numBufferVertices)
+		{
+			ReportError(engine::format("Draw : vertices {}..{} exceed the vertex buffer ({})", startVertex, uint64_t(startVertex) + vertexCount, numBufferVertices));
+		}
+	}
+
+	stats_.numDraws++;
+	stats_.numVertices += vertexCount;
+}
+
+// インデックスを使って描画する
+void NullRenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	Record(RenderCommandType::DrawIndexed, indexCount, startIndex, uint64_t(int64_t(baseVertex)));
+
+	if (ValidateDraw("DrawIndexed"))
+	{
+		if (indexBuffer_.gpuAddress == 0)
+		{
+			ReportError("DrawIndexed : index buffer is not set");
+		}
+		else
+		{
+			uint64_t numBufferIndices = indexBuffer_.sizeInBytes / sizeof(uint32_t);
+			if (uint64_t(startIndex) + indexCount > numBufferIndices)
+			{
+				ReportError(engine::format("DrawIndexed : indices {}..{} exceed the index buffer ({})", startIndex, uint64_t(startIndex) + indexCount, numBufferIndices));
+			}
+		}
+	}
+
+	stats_.numDraws++;
+	stats_.numVertices += indexCount;
+}
+
+// フレームを終える
+uint64_t NullRenderDevice::FinishFrame()
+{
+	uint64_t frameBufferBytes = nextUploadAddress_ - kUploadAddressBase;
+
+	// メモリは残して、次のフレームで使い回す
+	chunkIndex_ = 0;
+	chunkOffset_ = 0;
+	nextUploadAddress_ = kUploadAddressBase;
+
+	// リセットしたコマンドリストと同じように、設定した状態を忘れる
+	hasViewport_ = false;
+	hasScissorRect_ = false;
+	hasTopology_ = false;
+	rootSignature_ = 0;
+	pipelineState_ = 0;
+	vertexBuffer_ = {};
+	indexBuffer_ = {};
+	boundRootParameterMask_ = 0;
+
+	commands_.clear();
+
+	return frameBufferBytes;
+}
+
+// 解放しないバッファを作る
+RenderBuffer NullRenderDevice::CreateStaticBuffer(uint32_t sizeInBytes)
+{
+	staticBuffers_.push_back(std::make_unique<uint8_t[]>(sizeInBytes));
+
+	RenderBuffer buffer{};
+	buffer.data = staticBuffers_.back().get();
+	buffer.gpuAddress = nextStaticAddress_;
+	buffer.sizeInBytes = sizeInBytes;
+
+	nextStaticAddress_ += (uint64_t(sizeInBytes) + kConstantBufferAlignment - 1) & ~(kConstantBufferAlignment - 1);
+
+	return buffer;
+}
+
+// 数えたものを0に戻す
+void NullRenderDevice::ResetStats()
+{
+	stats_ = {};
+	errors_.clear();
+}
+
+// 誤りを記録する
+void NullRenderDevice::ReportError(const std::string& message)
+{
+	stats_.numErrors++;
+
+	if (errors_.size() < kMaxErrors)
+	{
+		errors_.push_back(message);
+	}
+}
+
+// 状態を変えたことを数える
+void NullRenderDevice::CountStateChange(bool isRedundant)
+{
+	stats_.numStateChanges++;
+
+	if (isRedundant)
+	{
+		stats_.numRedundantStateChanges++;
+	}
+}
+
+// コマンドを記録する
+void NullRenderDevice::Record(RenderCommandType type, uint64_t argument0, uint64_t argument1, uint64_t argument2)
+{
+	if (isRecording_ == false)
+		return;
+
+	commands_.push_back({ type, { argument0, argument1, argument2 } });
+}
+
+// 作り物のアドレスが、作ったバッファのものかどうか
+bool NullRenderDevice::IsValidAddress(uint64_t gpuAddress) const
+{
+	if (gpuAddress >= kUploadAddressBase && gpuAddress < nextUploadAddress_)
+		return true;
+
+	if (gpuAddress >= kStaticAddressBase && gpuAddress < nextStaticAddress_)
+		return true;
+
+	return false;
+}
+
+// 描画に必要な状態が設定されているかを確かめる
+bool NullRenderDevice::ValidateDraw(const char* name)
+{
+	bool isValid = true;
+
+	if (hasViewport_ == false || hasScissorRect_ == false)
+	{
+		ReportError(engine::format("{} : viewport or scissor rect is not set", name));
+		isValid = false;
+	}
+
+	if (rootSignature_ == 0 || pipelineState_ == 0)
+	{
+		ReportError(engine::format("{} : root signature or pipeline state is not set", name));
+		isValid = false;
+	}
+
+	if (hasTopology_ == false)
+	{
+		ReportError(engine::format("{} : primitive topology is not set", name));
+		isValid = false;
+	}
+
+	if (vertexBuffer_.gpuAddress == 0)
+	{
+		ReportError(engine::format("{} : vertex buffer is not set", name));
+		isValid = false;
+	}
+
+	uint32_t missingMask = requiredRootParameterMask_ & ~boundRootParameterMask_;
+	if (missingMask != 0)
+	{
+		ReportError(engine::format("{} : root parameters {:#b} are not set", name, missingMask));
+		isValid = false;
+	}
+
+	return isValid;
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "../RenderDevice.h"
+#include "../../../Func/Format/Format.h"
+
+// 積んだコマンドの種類
+enum class RenderCommandType
+{
+	SetViewport,
+	SetScissorRect,
+	SetRootSignature,
+	SetPipelineState,
+	SetVertexBuffer,
+	SetIndexBuffer,
+	SetPrimitiveTopology,
+	SetConstantBuffer,
+	SetDescriptorTable,
+	Draw,
+	DrawIndexed
+};
+
+// 記録したコマンド（引数は種類ごとに、関数の引数の順に入れる）
+typedef struct RenderCommand
+{
+	RenderCommandType type;
+	uint64_t arguments[3];
+}RenderCommand;
+
+// 数えたもの（ResetStatsまで足し続ける）
+typedef struct RenderDeviceStats
+{
+	// 描画の回数と、描画した頂点（インデックス）の数
+	uint64_t numDraws;
+	uint64_t numVertices;
+
+	// 状態を変えた回数と、そのうち直前と同じものを設定し直した回数
+	uint64_t numStateChanges;
+	uint64_t numRedundantStateChanges;
+
+	// ルートの引数を設定した回数
+	uint64_t numRootArguments;
+
+	// 描画ごとのバッファを作った数と、その大きさ
+	uint64_t numUploadBuffers;
+	uint64_t uploadBytes;
+
+	// 検証で見つかった誤りの数
+	uint64_t numErrors;
+}RenderDeviceStats;
+
+// GPUを使わずに、コマンドを検証して数える（バッファはCPUのメモリに作り、アドレスは作り物を返す）
+class NullRenderDevice : public RenderDevice
+{
+public:
+
+	// コンストラクタ（requiredRootParameterMaskは、描画までに設定されている必要があるルートの引数のビット）
+	explicit NullRenderDevice(uint32_t numRootParameters = 4, uint32_t requiredRootParameterMask = 0b0111);
+
+	// 描画ごとのバッファを作る（FinishFrameで、メモリを次のフレームに使い回す）
+	RenderBuffer CreateUploadBuffer(uint32_t sizeInBytes) override;
+
+	// ビューポートを設定する
+	void SetViewport(const RenderViewport& viewport) override;
+
+	// シザーレクトを設定する
+	void SetScissorRect(const RenderRect& scissorRect) override;
+
+	// ルートシグネチャを設定する
+	void SetRootSignature(RenderHandle rootSignature) override;
+
+	// PSOを設定する
+	void SetPipelineState(RenderHandle pipelineState) override;
+
+	// 頂点バッファを設定する
+	void SetVertexBuffer(const RenderVertexBufferView& view) override;
+
+	// インデックスバッファを設定する
+	void SetIndexBuffer(const RenderIndexBufferView& view) override;
+
+	// 形状を設定する
+	void SetPrimitiveTopology(RenderTopology topology) override;
+
+	// ルートの引数に、定数バッファのアドレスを設定する
+	void SetConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuAddress) override;
+
+	// ルートの引数に、ディスクリプタテーブルを設定する
+	void SetDescriptorTable(uint32_t rootParameterIndex, RenderHandle gpuDescriptor) override;
+
+	// 描画する
+	void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+
+	// インデックスを使って描画する
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+
+	// フレームを終える
+	uint64_t FinishFrame() override;
+
+	// 解放しないバッファを作る（モデルの頂点など、読み込んだときに作るものの代わり）
+	RenderBuffer CreateStaticBuffer(uint32_t sizeInBytes);
+
+	// 積んだコマンドを記録するかどうか（記録したものはFinishFrameで消す）
+	void SetRecording(bool isRecording) { isRecording_ = isRecording; }
+
+	// 数えたものを0に戻す
+	void ResetStats();
+
+	// Getter
+	const RenderDeviceStats& GetStats() const { return stats_; }
+	const std::vector<RenderCommand>& GetCommands() const { return commands_; }
+	const std::vector<std::string>& GetErrors() const { return errors_; }
+
+
+private:
+
+	// 誤りを記録する
+	void ReportError(const std::string& message);
+
+	// 状態を変えたことを数える（isRedundantなら、直前と同じものを設定し直した）
+	void CountStateChange(bool isRedundant);
+
+	// コマンドを記録する
+	void Record(RenderCommandType type, uint64_t argument0 = 0, uint64_t argument1 = 0, uint64_t argument2 = 0);
+
+	// 作り物のアドレスが、作ったバッファのものかどうか
+	bool IsValidAddress(uint64_t gpuAddress) const;
+
+	// 描画に必要な状態が設定されているかを確かめる
+	bool ValidateDraw(const char* name);
+
+
+	// ルートの引数の数の上限
+	static const uint32_t kMaxRootParameters = 16;
+
+	// 記録する誤りの数の上限（それ以上は数えるだけ）
+	static const uint32_t kMaxErrors = 64;
+
+	// 定数バッファのアドレスの揃え（D3D12と同じ）
+	static const uint64_t kConstantBufferAlignment = 256;
+
+	// 描画ごとのバッファと、解放しないバッファの作り物のアドレスの始まり
+	static const uint64_t kUploadAddressBase = 0x0000'1000'0000'0000;
+	static const uint64_t kStaticAddressBase = 0x0000'2000'0000'0000;
+
+	// 描画ごとのバッファに使うメモリのまとまりの大きさ
+	static const size_t kChunkSize = 1024 * 1024;
+
+	// 描画ごとのバッファに使うメモリのまとまり
+	typedef struct Chunk
+	{
+		std::unique_ptr<uint8_t[]> memory;
+		size_t size;
+	}Chunk;
+
+
+	// ルートの引数の数と、描画までに設定されている必要があるもの
+	uint32_t numRootParameters_ = 0;
+	uint32_t requiredRootParameterMask_ = 0;
+
+	// 描画ごとのバッファのメモリ（使っているまとまりと、その中の位置）
+	std::vector<Chunk> chunks_;
+	size_t chunkIndex_ = 0;
+	size_t chunkOffset_ = 0;
+
+	// 解放しないバッファのメモリ
+	std::vector<std::unique_ptr<uint8_t[]>> staticBuffers_;
+
+	// 次に返す作り物のアドレス
+	uint64_t nextUploadAddress_ = kUploadAddressBase;
+	uint64_t nextStaticAddress_ = kStaticAddressBase;
+
+
+	/*   設定中の状態   */
+
+	bool hasViewport_ = false;
+	bool hasScissorRect_ = false;
+	bool hasTopology_ = false;
+	RenderViewport viewport_{};
+	RenderRect scissorRect_{};
+	RenderHandle rootSignature_ = 0;
+	RenderHandle pipelineState_ = 0;
+	RenderVertexBufferView vertexBuffer_{};
+	RenderIndexBufferView indexBuffer_{};
+
+	// 設定したルートの引数と、設定済みのもののビット
+	uint64_t rootArguments_[kMaxRootParameters] = {};
+	uint32_t boundRootParameterMask_ = 0;
+
+
+	// 記録するかどうかと、記録したコマンド
+	bool isRecording_ = false;
+	std::vector<RenderCommand> commands_;
+
+	// 数えたもの
+	RenderDeviceStats stats_{};
+
+	// 記録した誤り
+	std::vector<std::string> errors_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+#include <stdint.h>
+
+// 描画に使うオブジェクトの番号（D3D12では、ルートシグネチャやPSOのポインタ、GPUのディスクリプタのアドレス）
+typedef uint64_t RenderHandle;
+
+// ポインタを番号にする
+template<typename T>
+inline RenderHandle ToRenderHandle(T* pointer)
+{
+	return RenderHandle(reinterpret_cast<uintptr_t>(pointer));
+}
+
+// ビューポート（D3D12_VIEWPORTと同じ並び）
+typedef struct RenderViewport
+{
+	float TopLeftX;
+	float TopLeftY;
+	float Width;
+	float Height;
+	float MinDepth;
+	float MaxDepth;
+}RenderViewport;
+
+// シザーレクト（D3D12_RECTと同じ並び）
+typedef struct RenderRect
+{
+	int32_t left;
+	int32_t top;
+	int32_t right;
+	int32_t bottom;
+}RenderRect;
+
+// 頂点バッファの範囲
+typedef struct RenderVertexBufferView
+{
+	uint64_t gpuAddress;
+	uint32_t sizeInBytes;
+	uint32_t strideInBytes;
+}RenderVertexBufferView;
+
+// インデックスバッファの範囲（インデックスは32bit）
+typedef struct RenderIndexBufferView
+{
+	uint64_t gpuAddress;
+	uint32_t sizeInBytes;
+}RenderIndexBufferView;
+
+// 描画ごとに作るバッファ（FinishFrameまで書き込める）
+typedef struct RenderBuffer
+{
+	// CPUから書き込む場所
+	void* data;
+
+	// GPUから見たアドレス
+	uint64_t gpuAddress;
+
+	// 大きさ
+	uint32_t sizeInBytes;
+}RenderBuffer;
+
+// 形状
+enum class RenderTopology
+{
+	TriangleList
+};
+
+// 描画のコマンドを積む先（D3D12と、GPUを使わずに検証と計数だけを行うものがある）
+class RenderDevice
+{
+public:
+
+	// デストラクタ
+	virtual ~RenderDevice() = default;
+
+	// 描画ごとのバッファを作る（書き込めるようにしておき、FinishFrameで解放する）
+	virtual RenderBuffer CreateUploadBuffer(uint32_t sizeInBytes) = 0;
+
+	// ビューポートを設定する
+	virtual void SetViewport(const RenderViewport& viewport) = 0;
+
+	// シザーレクトを設定する
+	virtual void SetScissorRect(const RenderRect& scissorRect) = 0;
+
+	// ルートシグネチャを設定する（変わったら、設定したルートの引数は全て無効になる）
+	virtual void SetRootSignature(RenderHandle rootSignature) = 0;
+
+	// PSOを設定する
+	virtual void SetPipelineState(RenderHandle pipelineState) = 0;
+
+	// 頂点バッファを設定する
+	virtual void SetVertexBuffer(const RenderVertexBufferView& view) = 0;
+
+	// インデックスバッファを設定する
+	virtual void SetIndexBuffer(const RenderIndexBufferView& view) = 0;
+
+	// 形状を設定する
+	virtual void SetPrimitiveTopology(RenderTopology topology) = 0;
+
+	// ルートの引数に、定数バッファのアドレスを設定する
+	virtual void SetConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuAddress) = 0;
+
+	// ルートの引数に、ディスクリプタテーブルを設定する
+	virtual void SetDescriptorTable(uint32_t rootParameterIndex, RenderHandle gpuDescriptor) = 0;
+
+	// 描画する
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex) = 0;
+
+	// インデックスを使って描画する
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+
+	// フレームを終える（描画ごとのバッファを解放し、設定した状態を忘れる。戻り値は解放したバイト数）
+	virtual uint64_t FinishFrame() = 0;
+};
@@ -0,0 +1,424 @@
+#include "RenderGraph.h"
+
+// パスとリソースを全て消す
+void RenderGraph::Reset()
+{
+	passes_.clear();
+	resources_.clear();
+	finalBarriers_.clear();
+
+	isCompiled_ = false;
+	nextPass_ = 0;
+	numCulledPasses_ = 0;
+	numBarriers_ = 0;
+}
+
+// 外部のリソースを登録する
+uint32_t RenderGraph::ImportResource(const std::string& name, RenderHandle resource, RenderState initialState, RenderState finalState)
+{
+	RenderGraphResource importedResource{};
+	importedResource.name = name;
+	importedResource.resource = resource;
+	importedResource.initialState = initialState;
+	importedResource.finalState = finalState;
+	importedResource.isImported = true;
+
+	resources_.push_back(importedResource);
+	return static_cast<uint32_t>(resources_.size() - 1);
+}
+
+// グラフの中だけで使うリソースを登録する
+uint32_t RenderGraph::CreateTransientResource(const std::string& name, uint64_t sizeInBytes, uint64_t alignment)
+{
+	RenderGraphResource transientResource{};
+	transientResource.name = name;
+	transientResource.sizeInBytes = sizeInBytes;
+	transientResource.alignment = alignment;
+
+	resources_.push_back(transientResource);
+	return static_cast<uint32_t>(resources_.size() - 1);
+}
+
+// 実際のリソースを設定する
+void RenderGraph::SetResource(uint32_t resourceIndex, RenderHandle resource)
+{
+	assert(resourceIndex < resources_.size());
+	resources_[resourceIndex].resource = resource;
+}
+
+// パスを追加する
+uint32_t RenderGraph::AddPass(const std::string& name, std::function<void()> execute)
+{
+	RenderGraphPass pass{};
+	pass.name = name;
+	pass.execute = std::move(execute);
+	passes_.push_back(std::move(pass));
+
+	isCompiled_ = false;
+
+	return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+// パスがリソースを読むことを宣言する
+void RenderGraph::Read(uint32_t passIndex, uint32_t resourceIndex, RenderState state)
+{
+	AddAccess(passIndex, resourceIndex, state, false);
+}
+
+// パスがリソースに書き込むことを宣言する
+void RenderGraph::Write(uint32_t passIndex, uint32_t resourceIndex, RenderState state)
+{
+	AddAccess(passIndex, resourceIndex, state, true);
+}
+
+// パスを省かないようにする
+void RenderGraph::SetSideEffect(uint32_t passIndex)
+{
+	assert(passIndex < passes_.size());
+	passes_[passIndex].hasSideEffect = true;
+}
+
+// 使われないパスを省き、パスごとのバリアを求める
+bool RenderGraph::Compile(std::ostream& os)
+{
+	/*--------------------------
+	    宣言が正しいかを確かめる
+	--------------------------*/
+
+	bool isValid = true;
+
+	for (const RenderGraphPass& pass : passes_)
+	{
+		for (const RenderGraphAccess& access : pass.accesses)
+		{
+			const std::string& resourceName = resources_[access.resourceIndex].name;
+
+			// 書き込むのに、読み込みだけの状態を求めた
+			if (access.isWrite && IsReadOnlyState(access.state))
+			{
+				Log(os, engine::format("RenderGraph : pass \"{}\" writes \"{}\" in a read-only state ({:#x})",
+					pass.name, resourceName, static_cast<uint32_t>(access.state)));
+				isValid = false;
+			}
+
+			// 書き込める状態は、他の状態と組み合わせられない（同じパスで、違う状態で読み書きした）
+			if (IsReadOnlyState(access.state) == false && (static_cast<uint32_t>(access.state) & (static_cast<uint32_t>(access.state) - 1)) != 0)
+			{
+				Log(os, engine::format("RenderGraph : pass \"{}\" uses \"{}\" in conflicting states ({:#x})",
+					pass.name, resourceName, static_cast<uint32_t>(access.state)));
+				isValid = false;
+			}
+		}
+	}
+
+	if (isValid == false)
+		return false;
+
+
+	/*---------------------
+	    使われないパスを省く
+	---------------------*/
+
+	CullPasses();
+
+
+	/*------------------------
+	    パスごとのバリアを求める
+	------------------------*/
+
+	// リソースの今の状態（グラフの中だけで使うリソースは、最初に使うまで状態が無い）
+	std::vector<RenderState> states(resources_.size());
+	std::vector<bool> hasState(resources_.size());
+	std::vector<bool> wasWritten(resources_.size());
+	for (size_t i = 0; i < resources_.size(); ++i)
+	{
+		states[i] = resources_[i].initialState;
+		hasState[i] = resources_[i].isImported;
+		resources_[i].isUsed = false;
+	}
+
+	numBarriers_ = 0;
+
+	for (uint32_t passIndex = 0; passIndex < passes_.size(); ++passIndex)
+	{
+		RenderGraphPass& pass = passes_[passIndex];
+		pass.barriers.clear();
+
+		if (pass.isCulled)
+			continue;
+
+		for (const RenderGraphAccess& access : pass.accesses)
+		{
+			uint32_t index = access.resourceIndex;
+
+			// 使うパスの範囲
+			if (resources_[index].isUsed == false)
+			{
+				resources_[index].isUsed = true;
+				resources_[index].firstPass = passIndex;
+			}
+			resources_[index].lastPass = passIndex;
+
+			bool isRead = access.isWrite == false && IsReadOnlyState(access.state);
+			RenderState required = isRead ? MergeFollowingReads(passIndex, index, access.state) : access.state;
+
+			// 最初に使う状態で作られたものとして扱う
+			if (hasState[index] == false)
+			{
+				resources_[index].initialState = required;
+				states[index] = required;
+				hasState[index] = true;
+				wasWritten[index] = access.isWrite;
+				continue;
+			}
+
+			uint32_t current = static_cast<uint32_t>(states[index]);
+			uint32_t wanted = static_cast<uint32_t>(access.state);
+
+			if (isRead && IsReadOnlyState(states[index]) && (current & wanted) == wanted)
+			{
+				// 読み込む状態に遷移済み（前のパスで組み合わせた）
+			}
+			else if (states[index] == access.state)
+			{
+				// UAVに書き込んだ後に、続けてUAVとして使うときは、前の書き込みを待つ
+				if (wasWritten[index] && access.state == RenderState::UnorderedAccess)
+				{
+					pass.barriers.push_back({ index, 0, access.state, access.state, RenderBarrierType::UnorderedAccess });
+				}
+			}
+			else
+			{
+				pass.barriers.push_back({ index, 0, states[index], required, RenderBarrierType::Transition });
+				states[index] = required;
+			}
+
+			wasWritten[index] = access.isWrite;
+		}
+
+		numBarriers_ += static_cast<uint32_t>(pass.barriers.size());
+	}
+
+	// 大きさを指定したリソースを重ねて置く
+	PlanTransientMemory();
+
+	// 外部のリソースを最後の状態に、グラフの中だけで使うリソースを最初の状態に戻す（次のフレームも同じ状態から始める）
+	finalBarriers_.clear();
+	for (uint32_t index = 0; index < resources_.size(); ++index)
+	{
+		const RenderGraphResource& resource = resources_[index];
+		if (resource.isUsed == false && resource.isImported == false)
+			continue;
+
+		RenderState finalState = resource.isImported ? resource.finalState : resource.initialState;
+		if (states[index] != finalState)
+		{
+			finalBarriers_.push_back({ index, 0, states[index], finalState, RenderBarrierType::Transition });
+		}
+	}
+
+	numBarriers_ += static_cast<uint32_t>(finalBarriers_.size());
+
+	isCompiled_ = true;
+	nextPass_ = 0;
+
+	return true;
+}
+
+// パスを順に実行する
+void RenderGraph::Execute(const RenderBarrierFunction& flushBarriers, uint32_t lastPass)
+{
+	assert(isCompiled_);
+
+	// バリアに実際のリソースを入れてから、パスごとに1回で発行する
+	auto flush = [this, &flushBarriers](std::vector<RenderBarrier>& barriers)
+		{
+			if (barriers.empty())
+				return;
+
+			for (RenderBarrier& barrier : barriers)
+			{
+				barrier.resource = resources_[barrier.resourceIndex].resource;
+				assert(barrier.resource != 0);
+			}
+
+			flushBarriers(barriers);
+		};
+
+	bool wasRemaining = nextPass_ < passes_.size();
+
+	for (; nextPass_ < passes_.size() && nextPass_ <= lastPass; ++nextPass_)
+	{
+		RenderGraphPass& pass = passes_[nextPass_];
+		if (pass.isCulled)
+			continue;
+
+		flush(pass.barriers);
+
+		if (pass.execute)
+		{
+			pass.execute();
+		}
+	}
+
+	// 全てのパスを実行したら、外部のリソースを最後の状態に戻す
+	if (wasRemaining && nextPass_ == passes_.size())
+	{
+		flush(finalBarriers_);
+	}
+}
+
+// 重ねて置いたリソースのヒープの大きさと、重ねたことで減った大きさを書き出す
+void RenderGraph::ReportTransientMemory(std::ostream& os) const
+{
+	const AliasingPlan& plan = transientPlan_;
+	const double kMegabyte = 1024.0 * 1024.0;
+
+	Log(os, engine::format("RenderGraph : transient heap {:.2f} MB (unaliased {:.2f} MB, saved {:.2f} MB, peak live {:.2f} MB)",
+		plan.heapSize / kMegabyte, plan.unaliasedSize / kMegabyte, (plan.unaliasedSize - plan.heapSize) / kMegabyte, plan.peakLiveSize / kMegabyte));
+}
+
+// 読み込みだけの状態かどうか
+bool RenderGraph::IsReadOnlyState(RenderState state)
+{
+	const uint32_t kReadOnlyMask = static_cast<uint32_t>(RenderState::VertexAndConstantBuffer | RenderState::IndexBuffer |
+		RenderState::DepthRead | RenderState::NonPixelShaderResource | RenderState::PixelShaderResource |
+		RenderState::IndirectArgument | RenderState::CopySource);
+
+	uint32_t bits = static_cast<uint32_t>(state);
+	return bits != 0 && (bits & ~kReadOnlyMask) == 0;
+}
+
+// 読み書きを追加する
+void RenderGraph::AddAccess(uint32_t passIndex, uint32_t resourceIndex, RenderState state, bool isWrite)
+{
+	assert(passIndex < passes_.size());
+	assert(resourceIndex < resources_.size());
+
+	RenderGraphPass& pass = passes_[passIndex];
+
+	for (RenderGraphAccess& access : pass.accesses)
+	{
+		if (access.resourceIndex != resourceIndex)
+			continue;
+
+		// 読み込み同士は組み合わせる。書き込みが混ざって状態が違えば、コンパイルで矛盾として知らせる
+		access.state = access.state | state;
+		access.isWrite = access.isWrite || isWrite;
+		return;
+	}
+
+	pass.accesses.push_back({ resourceIndex, state, isWrite });
+
+	isCompiled_ = false;
+}
+
+// 使われないパスを省く
+void RenderGraph::CullPasses()
+{
+	// 外部のリソースは、グラフの外で使われる
+	std::vector<bool> isNeeded(resources_.size());
+	for (size_t i = 0; i < resources_.size(); ++i)
+	{
+		isNeeded[i] = resources_[i].isImported;
+	}
+
+	numCulledPasses_ = 0;
+
+	for (size_t i = passes_.size(); i-- > 0;)
+	{
+		RenderGraphPass& pass = passes_[i];
+
+		bool isUsed = pass.hasSideEffect;
+		for (const RenderGraphAccess& access : pass.accesses)
+		{
+			if (access.isWrite && isNeeded[access.resourceIndex])
+			{
+				isUsed = true;
+			}
+		}
+
+		pass.isCulled = isUsed == false;
+		if (pass.isCulled)
+		{
+			numCulledPasses_++;
+			continue;
+		}
+
+		// 残したパスが読むリソースを書き込むパスも残す（書き込みは前の内容を読むこともあるので、書いたものも残したままにする）
+		for (const RenderGraphAccess& access : pass.accesses)
+		{
+			isNeeded[access.resourceIndex] = true;
+		}
+	}
+}
+
+// 読み込む状態を、次に書き込むまでに読むパスの状態と組み合わせる
+RenderState RenderGraph::MergeFollowingReads(uint32_t passIndex, uint32_t resourceIndex, RenderState state) const
+{
+	RenderState merged = state;
+
+	for (size_t i = passIndex + 1; i < passes_.size(); ++i)
+	{
+		if (passes_[i].isCulled)
+			continue;
+
+		for (const RenderGraphAccess& access : passes_[i].accesses)
+		{
+			if (access.resourceIndex != resourceIndex)
+				continue;
+
+			// 書き込むか、読み込みだけではない状態で使うところまで
+			if (access.isWrite || IsReadOnlyState(access.state) == false)
+				return merged;
+
+			merged = merged | access.state;
+		}
+	}
+
+	return merged;
+}
+
+// 大きさを指定したリソースを、使うパスが重ならないもの同士で重ねて置き、切り替えるバリアを加える
+void RenderGraph::PlanTransientMemory()
+{
+	// 省かれていないパスで使う、大きさを指定したリソース
+	std::vector<uint32_t> placed;
+	std::vector<AliasingRequest> requests;
+	for (uint32_t index = 0; index < resources_.size(); ++index)
+	{
+		const RenderGraphResource& resource = resources_[index];
+		if (resource.isImported || resource.isUsed == false || resource.sizeInBytes == 0)
+			continue;
+
+		placed.push_back(index);
+		requests.push_back({ resource.sizeInBytes, resource.alignment, resource.firstPass, resource.lastPass });
+	}
+
+	transientPlan_ = PlanAliasing(requests);
+
+	for (size_t i = 0; i < placed.size(); ++i)
+	{
+		resources_[placed[i]].heapOffset = transientPlan_.offsets[i];
+	}
+
+	// 前に同じメモリを使っていたリソースがあれば、最初に使うパスで切り替える
+	for (size_t i = 0; i < placed.size(); ++i)
+	{
+		const RenderGraphResource& resource = resources_[placed[i]];
+
+		for (size_t j = 0; j < placed.size(); ++j)
+		{
+			const RenderGraphResource& other = resources_[placed[j]];
+
+			bool overlapsMemory = resource.heapOffset < other.heapOffset + other.sizeInBytes && other.heapOffset < resource.heapOffset + resource.sizeInBytes;
+			if (overlapsMemory && other.lastPass < resource.firstPass)
+			{
+				std::vector<RenderBarrier>& barriers = passes_[resource.firstPass].barriers;
+				barriers.insert(barriers.begin(), { placed[i], 0, resource.initialState, resource.initialState, RenderBarrierType::Aliasing });
+				numBarriers_++;
+				break;
+			}
+		}
+	}
+}
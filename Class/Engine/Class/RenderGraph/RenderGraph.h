@@ -0,0 +1,201 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <cassert>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include "../RenderDevice/RenderDevice.h"
+#include "../../Func/StringInfo/StringInfo.h"
+#include "../../Func/AliasingPlan/AliasingPlan.h"
+#include "../../Func/Format/Format.h"
+
+// リソースの状態（値はD3D12_RESOURCE_STATESと同じで、ビットを組み合わせられる）
+enum class RenderState : uint32_t
+{
+	Common = 0,
+	Present = 0,
+	VertexAndConstantBuffer = 0x1,
+	IndexBuffer = 0x2,
+	RenderTarget = 0x4,
+	UnorderedAccess = 0x8,
+	DepthWrite = 0x10,
+	DepthRead = 0x20,
+	NonPixelShaderResource = 0x40,
+	PixelShaderResource = 0x80,
+	IndirectArgument = 0x200,
+	CopyDest = 0x400,
+	CopySource = 0x800
+};
+
+// 状態を組み合わせる
+inline RenderState operator|(RenderState a, RenderState b)
+{
+	return static_cast<RenderState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+// バリアの種類
+enum class RenderBarrierType
+{
+	// 状態を遷移させる
+	Transition,
+
+	// 同じリソースに続けてUAVとして使うとき、前の書き込みを待つ
+	UnorderedAccess,
+
+	// 同じメモリを使っていた前のリソースから、このリソースに切り替える
+	Aliasing
+};
+
+// バリア（遷移でなければ、before と after は使わない）
+typedef struct RenderBarrier
+{
+	// グラフの中のリソースの番号と、実際のリソース（D3D12では ID3D12Resource のポインタ）
+	uint32_t resourceIndex;
+	RenderHandle resource;
+
+	// 遷移前と遷移後の状態
+	RenderState before;
+	RenderState after;
+
+	// 種類
+	RenderBarrierType type;
+}RenderBarrier;
+
+// バリアをまとめて発行する関数（1回の呼び出しで、1回のResourceBarrierにする）
+typedef std::function<void(const std::vector<RenderBarrier>& barriers)> RenderBarrierFunction;
+
+// パスが読み書きするリソースを宣言し、使われないパスを省いて、パスの間に必要なバリアをまとめて求める
+class RenderGraph
+{
+public:
+
+	// 全てのパスを実行する
+	static const uint32_t kAllPasses = 0xffffffff;
+
+	// パスとリソースを全て消す（フレームの始めに呼ぶ）
+	void Reset();
+
+	// 外部のリソースを登録する（実行の最後に finalState に戻す）
+	uint32_t ImportResource(const std::string& name, RenderHandle resource, RenderState initialState, RenderState finalState);
+
+	// グラフの中だけで使うリソースを登録する（最初に使う状態で作られたものとして扱う。使うパスが全て省かれたら作らなくてよい）
+	// 大きさを指定したものは、使うパスが重ならない他のものとヒープの同じ位置に重ねて置く（最初に使うパスで、クリアか破棄をして中身を作ること）
+	uint32_t CreateTransientResource(const std::string& name, uint64_t sizeInBytes = 0, uint64_t alignment = kDefaultAliasingAlignment);
+
+	// 実際のリソースを設定する（グラフの中だけで使うリソースは、コンパイルしてから作って設定する）
+	void SetResource(uint32_t resourceIndex, RenderHandle resource);
+
+	// パスを追加する（execute が空なら、バリアを張るだけ）
+	uint32_t AddPass(const std::string& name, std::function<void()> execute);
+
+	// パスがリソースを読むことを宣言する
+	void Read(uint32_t passIndex, uint32_t resourceIndex, RenderState state);
+
+	// パスがリソースに書き込むことを宣言する
+	void Write(uint32_t passIndex, uint32_t resourceIndex, RenderState state);
+
+	// パスを省かないようにする（外から見える処理をするもの）
+	void SetSideEffect(uint32_t passIndex);
+
+	// 使われないパスを省き、パスごとのバリアを求める（宣言が矛盾していたらログに書き出し、falseを返す）
+	bool Compile(std::ostream& os);
+
+	// パスを順に実行する（lastPassまで。続きは、もう一度呼ぶと lastPass の次から実行する）
+	void Execute(const RenderBarrierFunction& flushBarriers, uint32_t lastPass = kAllPasses);
+
+	// 重ねて置いたリソースのヒープの大きさと、重ねたことで減った大きさを書き出す
+	void ReportTransientMemory(std::ostream& os) const;
+
+	// Getter
+	bool IsPassCulled(uint32_t passIndex) const { return passes_[passIndex].isCulled; }
+	const std::vector<RenderBarrier>& GetPassBarriers(uint32_t passIndex) const { return passes_[passIndex].barriers; }
+	const std::vector<RenderBarrier>& GetFinalBarriers() const { return finalBarriers_; }
+	uint32_t GetNumPasses() const { return static_cast<uint32_t>(passes_.size()); }
+	uint32_t GetNumResources() const { return static_cast<uint32_t>(resources_.size()); }
+	uint32_t GetNumCulledPasses() const { return numCulledPasses_; }
+	uint32_t GetNumBarriers() const { return numBarriers_; }
+	RenderState GetInitialState(uint32_t resourceIndex) const { return resources_[resourceIndex].initialState; }
+	uint64_t GetHeapOffset(uint32_t resourceIndex) const { return resources_[resourceIndex].heapOffset; }
+	const AliasingPlan& GetTransientPlan() const { return transientPlan_; }
+
+	// 読み込みだけの状態かどうか（読み込みだけの状態は、組み合わせて1回の遷移にできる）
+	static bool IsReadOnlyState(RenderState state);
+
+
+private:
+
+	// パスが読み書きするリソース
+	typedef struct RenderGraphAccess
+	{
+		uint32_t resourceIndex;
+		RenderState state;
+		bool isWrite;
+	}RenderGraphAccess;
+
+	// パス
+	typedef struct RenderGraphPass
+	{
+		std::string name;
+		std::function<void()> execute;
+		std::vector<RenderGraphAccess> accesses;
+		bool hasSideEffect;
+
+		// コンパイルで求めるもの（省くかどうかと、実行する前に張るバリア）
+		bool isCulled;
+		std::vector<RenderBarrier> barriers;
+	}RenderGraphPass;
+
+	// リソース
+	typedef struct RenderGraphResource
+	{
+		std::string name;
+		RenderHandle resource;
+		RenderState initialState;
+		RenderState finalState;
+		bool isImported;
+
+		// ヒープに重ねて置くときの大きさと揃え（大きさが0なら、重ねない）と、置いた位置
+		uint64_t sizeInBytes;
+		uint64_t alignment;
+		uint64_t heapOffset;
+
+		// コンパイルで求めるもの（最初と最後に使う、省かれていないパス）
+		bool isUsed;
+		uint32_t firstPass;
+		uint32_t lastPass;
+	}RenderGraphResource;
+
+	// 読み書きを追加する（同じパスで同じリソースを読み書きしたら、1つにまとめる）
+	void AddAccess(uint32_t passIndex, uint32_t resourceIndex, RenderState state, bool isWrite);
+
+	// 使われないパスを省く（後ろから見て、外部のリソースか、残したパスが読むリソースに書き込むものだけを残す）
+	void CullPasses();
+
+	// 読み込む状態を、次に書き込むまでに読むパスの状態と組み合わせる（遷移を1回にする）
+	RenderState MergeFollowingReads(uint32_t passIndex, uint32_t resourceIndex, RenderState state) const;
+
+	// 大きさを指定したリソースを、使うパスが重ならないもの同士で重ねて置き、切り替えるバリアを加える
+	void PlanTransientMemory();
+
+
+	// パス
+	std::vector<RenderGraphPass> passes_;
+
+	// リソース
+	std::vector<RenderGraphResource> resources_;
+
+	// 重ねて置いたリソースの配置
+	AliasingPlan transientPlan_{};
+
+	// 実行を終えた後に張るバリア（外部のリソースを最後の状態に、グラフの中だけで使うリソースを最初の状態に戻す）
+	std::vector<RenderBarrier> finalBarriers_;
+
+	// コンパイルしたかどうかと、次に実行するパス
+	bool isCompiled_ = false;
+	uint32_t nextPass_ = 0;
+
+	// コンパイルの結果
+	uint32_t numCulledPasses_ = 0;
+	uint32_t numBarriers_ = 0;
+};
@@ -3,8 +3,8 @@
 // デストラクタ
 Shader::~Shader()
 {
-
- }
+	ReleaseContext(context_);
+}
 
 // 初期化
 void Shader::Initialize()
@@ -13,43 +13,127 @@ void Shader::Initialize()
 	    DXCを初期化する
 	--------------------*/
 
-	HRESULT hr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils_));
-	assert(SUCCEEDED(hr));
+	// コンパイラは、キャッシュに無いシェーダーをコンパイルするときに作る
+	CreateContext(context_);
+}
 
-	hr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxcCompiler_));
+// DXCの一式を作る（コンパイラは作らない）
+void Shader::CreateContext(DxcContext& context)
+{
+	HRESULT hr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&context.dxcUtils));
 	assert(SUCCEEDED(hr));
+}
 
-	hr = dxcUtils_->CreateDefaultIncludeHandler(&includeHandler_);
-	assert(SUCCEEDED(hr));
+// DXCの一式を解放する
+void Shader::ReleaseContext(DxcContext& context)
+{
+	if (context.includeHandler)
+	{
+		context.includeHandler->Release();
+		context.includeHandler = nullptr;
+	}
+
+	if (context.dxcCompiler)
+	{
+		context.dxcCompiler->Release();
+		context.dxcCompiler = nullptr;
+	}
+
+	if (context.dxcUtils)
+	{
+		context.dxcUtils->Release();
+		context.dxcUtils = nullptr;
+	}
 }
 
 // シェーダーをコンパイルする
 IDxcBlob* Shader::CompilerShader(std::ostream& os,const std::wstring& filePath, const wchar_t* profile)
 {
-	// コンパイルしますよというログ
-	Log(os,ConvertString(std::format(L"Begin CompileShader, path : {}, profile : {}", filePath, profile)));
+	IDxcBlob* shaderBlob = TryCompileShader(os, filePath, profile);
+	assert(shaderBlob != nullptr);
 
-	/*-----------------------
-	    HLSLファイルを読む
-	-----------------------*/
+	return shaderBlob;
+}
 
-	// HLSLファイルを読む
-	IDxcBlobEncoding* shaderSource = nullptr;
-	HRESULT hr = dxcUtils_->LoadFile(filePath.c_str(), nullptr, &shaderSource);
-	assert(SUCCEEDED(hr));
+// シェーダーをコンパイルする（失敗したらログに書き出してnullptrを返す）
+IDxcBlob* Shader::TryCompileShader(std::ostream& os, const std::wstring& filePath, const wchar_t* profile, const std::vector<std::string>& defines)
+{
+	return CompileWithContext(context_, os, filePath, profile, defines);
+}
 
-	// 読み込んだファイルの内容を設定する
-	DxcBuffer shaderSourceBuffer;
-	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
-	shaderSourceBuffer.Size = shaderSource->GetBufferSize();
-	shaderSourceBuffer.Encoding = DXC_CP_UTF8;
+// キーワードの組み合わせごとのバリアントを、複数のスレッドでコンパイルする（失敗したものはnullptr）
+std::vector<IDxcBlob*> Shader::CompileShaderVariants(std::ostream& os, const std::wstring& filePath, const wchar_t* profile,
+	const std::vector<std::vector<std::string>>& keywordGroups, const std::vector<uint32_t>& variantKeys, uint32_t maxThreads)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
+	std::vector<IDxcBlob*> shaderBlobs(variantKeys.size(), nullptr);
 
-	/*-----------------
-	    Compileする
-	-----------------*/
+	// ログが混ざらないように、バリアントごとに書いてから順に書き出す
+	std::vector<std::ostringstream> logs(variantKeys.size());
+
+	// スレッドごとのDXCの一式（0番はこのスレッドのものを使う）
+	uint32_t numThreads = (std::max)(maxThreads, 1u);
+	std::vector<DxcContext> contexts(numThreads);
+	contexts[0] = context_;
+
+	RunParallelJobs(uint32_t(variantKeys.size()), numThreads, [&](uint32_t job, uint32_t worker)
+		{
+			PROFILE_SCOPE("CompileShaderVariant");
 
-	LPCWSTR arguments[] =
+			DxcContext& context = contexts[worker];
+			if (context.dxcUtils == nullptr)
+			{
+				CreateContext(context);
+			}
+
+			std::vector<std::string> defines = GetShaderVariantDefines(keywordGroups, variantKeys[job]);
+			shaderBlobs[job] = CompileWithContext(context, logs[job], filePath, profile, defines);
+		});
+
+	// このスレッドのものは、コンパイラを作っていれば引き継ぐ
+	context_ = contexts[0];
+	for (uint32_t worker = 1; worker < numThreads; ++worker)
+	{
+		ReleaseContext(contexts[worker]);
+	}
+
+	for (std::ostringstream& log : logs)
+	{
+		os << log.str();
+	}
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	Log(os, std::format("Compile Variants, path : {} , profile : {} , {} variants , {} threads , {:.2f}ms \n",
+		ConvertString(filePath), ConvertString(std::wstring(profile)), variantKeys.size(), (std::min)(numThreads, uint32_t(variantKeys.size())), elapsed.count()));
+
+	return shaderBlobs;
+}
+
+// 指定したDXCの一式で、シェーダーをコンパイルする（失敗したらログに書き出してnullptrを返す）
+IDxcBlob* Shader::CompileWithContext(DxcContext& context, std::ostream& os, const std::wstring& filePath, const wchar_t* profile,
+	const std::vector<std::string>& defines)
+{
+	// ログとキャッシュのキーに使う文字列は、ワイド文字列から1回だけ変換しておく
+	std::string filePathText = ConvertString(filePath);
+	std::string profileText = ConvertString(std::wstring(profile));
+
+	// バリアントの定義
+	std::string definesText;
+	std::vector<std::wstring> defineArguments;
+	for (const std::string& define : defines)
+	{
+		defineArguments.push_back(ConvertString(define));
+		definesText += " " + define;
+	}
+
+	// コンパイルしますよというログ
+	Log(os, std::format("Begin CompileShader, path : {}, profile : {}, defines :{}", filePathText, profileText, definesText));
+
+	// 計測開始
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::vector<LPCWSTR> arguments =
 	{
 		// コンパイル対象のhlslファイル名
 		filePath.c_str(),
@@ -60,37 +144,116 @@ IDxcBlob* Shader::CompilerShader(std::ostream& os,const std::wstring& filePath,
 		// ShaderProfileの設定
 		L"-T" , profile ,
 
-		// デバッグ用の情報を埋め込む
-		L"-Zi" , L"-Qembed_debug",
-
-		// 最適化を外しておく
-		L"-Od",
-
 		// メモリレイアウトは行優先
 		L"-Zpr"
 	};
 
+#ifdef _DEBUG
+
+	// デバッグ用の情報を埋め込み、最適化を外しておく
+	arguments.insert(arguments.end(), { L"-Zi" , L"-Qembed_debug" , L"-Od" });
+
+#else
+
+	// 最適化し、デバッグ用の情報とリフレクションを取り除く
+	arguments.insert(arguments.end(), { L"-O3" , L"-Qstrip_debug" , L"-Qstrip_reflect" });
+
+#endif
+
+	// バリアントごとのマクロを定義する
+	for (const std::wstring& define : defineArguments)
+	{
+		arguments.insert(arguments.end(), { L"-D" , define.c_str() });
+	}
+
+
+	/*-----------------------------------
+	    コンパイル済みのものがあれば使う
+	-----------------------------------*/
+
+	// キャッシュのキーに含める引数（ファイル名はソースの中身で区別する）
+	std::vector<std::string> cacheArguments;
+	for (size_t i = 1; i < arguments.size(); ++i)
+	{
+		cacheArguments.push_back(ConvertString(std::wstring(arguments[i])));
+	}
+
+	std::string cachePath = GetShaderCachePath(filePathText, profileText, cacheArguments);
+
+	std::vector<uint8_t> cachedBytes;
+	if (ReadShaderCache(cachePath, cachedBytes))
+	{
+		// 読んだバイナリをBlobにする（DXCでコンパイルはしない）
+		IDxcBlobEncoding* cachedBlob = nullptr;
+		HRESULT hr = context.dxcUtils->CreateBlob(cachedBytes.data(), UINT32(cachedBytes.size()), DXC_CP_ACP, &cachedBlob);
+		if (SUCCEEDED(hr))
+		{
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			Log(os, std::format("Compile Succeeded (cache hit), path : {} , profile : {} , {:.2f}ms \n", filePathText, profileText, elapsed.count()));
+
+			return cachedBlob;
+		}
+	}
+
+	if (context.dxcCompiler == nullptr)
+	{
+		HRESULT hr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&context.dxcCompiler));
+		assert(SUCCEEDED(hr));
+
+		hr = context.dxcUtils->CreateDefaultIncludeHandler(&context.includeHandler);
+		assert(SUCCEEDED(hr));
+	}
+
+
+	/*-----------------------
+	    HLSLファイルを読む
+	-----------------------*/
+
+	// HLSLファイルを読む
+	IDxcBlobEncoding* shaderSource = nullptr;
+	HRESULT hr = context.dxcUtils->LoadFile(filePath.c_str(), nullptr, &shaderSource);
+	if (FAILED(hr))
+	{
+		Log(os, std::format("Compile Failed (cannot read), path : {}", filePathText));
+		return nullptr;
+	}
+
+	// 読み込んだファイルの内容を設定する
+	DxcBuffer shaderSourceBuffer;
+	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
+	shaderSourceBuffer.Size = shaderSource->GetBufferSize();
+	shaderSourceBuffer.Encoding = DXC_CP_UTF8;
+
+
+	/*-----------------
+	    Compileする
+	-----------------*/
+
 	// 実際にShaderをコンパイルする
 	IDxcResult* shaderResult = nullptr;
-	hr = dxcCompiler_->Compile
+	hr = context.dxcCompiler->Compile
 	(
 		// 読み込んだファイル
 		&shaderSourceBuffer,
 
 		// コンパイルオプション
-		arguments,
+		arguments.data(),
 
 		// コンパイルオプションの数
-		_countof(arguments),
+		UINT32(arguments.size()),
 
 		// includeが含まれた諸々
-		includeHandler_,
+		context.includeHandler,
 
 		// コンパイル結果
 		IID_PPV_ARGS(&shaderResult)
 	);
 
-	assert(SUCCEEDED(hr));
+	if (FAILED(hr))
+	{
+		shaderSource->Release();
+		return nullptr;
+	}
 
 
 	/*----------------------------------
@@ -103,7 +266,10 @@ IDxcBlob* Shader::CompilerShader(std::ostream& os,const std::wstring& filePath,
 	{
 		Log(os,shaderError->GetStringPointer());
 
-		assert(false);
+		shaderError->Release();
+		shaderSource->Release();
+		shaderResult->Release();
+		return nullptr;
 	}
 
 
@@ -114,10 +280,19 @@ IDxcBlob* Shader::CompilerShader(std::ostream& os,const std::wstring& filePath,
 	// コンパイル結果から実行用のバイナリ部分を取得
 	IDxcBlob* shaderBlob = nullptr;
 	hr = shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
-	assert(SUCCEEDED(hr));
+	if (FAILED(hr))
+	{
+		shaderSource->Release();
+		shaderResult->Release();
+		return nullptr;
+	}
+
+	// 次に起動したときはコンパイルしないように、キャッシュに書き出す
+	WriteShaderCache(cachePath, shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
 
 	// 成功したよというログ
-	Log(os,ConvertString(std::format(L"Compile Succeeded, path : {} , profile : {} \n" , filePath , profile)));
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	Log(os, std::format("Compile Succeeded, path : {} , profile : {} , {:.2f}ms \n", filePathText, profileText, elapsed.count()));
 
 	// もう使わないリソースを解放する
 	shaderSource->Release();
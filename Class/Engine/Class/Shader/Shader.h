@@ -5,12 +5,18 @@
 #include <cassert>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <chrono>
+#include <format>
+#include <vector>
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <dxgidebug.h>
 #include <dxcapi.h>
 #include "../../Func/StringInfo/StringInfo.h"
+#include "../../Func/ShaderCache/ShaderCache.h"
+#include "../../Func/ShaderPermutation/ShaderPermutation.h"
+#include "../FrameProfiler/FrameProfiler.h"
 
 #pragma comment(lib,"d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -28,20 +34,43 @@ public:
 	// 初期化
 	void Initialize();
 
-	// シェーダーをコンパイルする
+	// シェーダーをコンパイルする（同じソース、インクルード先、引数でコンパイル済みなら、キャッシュから読む）
 	IDxcBlob* CompilerShader(std::ostream& os, const std::wstring& filePath, const wchar_t* profile);
 
+	// シェーダーをコンパイルする（失敗したらログに書き出してnullptrを返す）
+	IDxcBlob* TryCompileShader(std::ostream& os, const std::wstring& filePath, const wchar_t* profile,
+		const std::vector<std::string>& defines = {});
+
+	// キーワードの組み合わせごとのバリアントを、複数のスレッドでコンパイルする（失敗したものはnullptr）
+	std::vector<IDxcBlob*> CompileShaderVariants(std::ostream& os, const std::wstring& filePath, const wchar_t* profile,
+		const std::vector<std::vector<std::string>>& keywordGroups, const std::vector<uint32_t>& variantKeys, uint32_t maxThreads);
+
 
 private:
 
-	// dxcUtils
-	IDxcUtils* dxcUtils_ = nullptr;
+	// DXCの一式（コンパイラはスレッドをまたいで使えないので、スレッドごとに作る）
+	typedef struct DxcContext
+	{
+		// dxcUtils
+		IDxcUtils* dxcUtils = nullptr;
 
-	// dxcCompiler
-	IDxcCompiler3* dxcCompiler_ = nullptr;
+		// dxcCompiler（キャッシュに無いシェーダーをコンパイルするときに作る）
+		IDxcCompiler3* dxcCompiler = nullptr;
 
-	// includeHandle
-	IDxcIncludeHandler* includeHandler_ = nullptr;
+		// includeHandle
+		IDxcIncludeHandler* includeHandler = nullptr;
+	}DxcContext;
 
-};
+	// DXCの一式を作る（コンパイラは作らない）
+	static void CreateContext(DxcContext& context);
 
+	// DXCの一式を解放する
+	static void ReleaseContext(DxcContext& context);
+
+	// 指定したDXCの一式で、シェーダーをコンパイルする（失敗したらログに書き出してnullptrを返す）
+	static IDxcBlob* CompileWithContext(DxcContext& context, std::ostream& os, const std::wstring& filePath, const wchar_t* profile,
+		const std::vector<std::string>& defines);
+
+	// このスレッドで使うDXCの一式
+	DxcContext context_;
+};
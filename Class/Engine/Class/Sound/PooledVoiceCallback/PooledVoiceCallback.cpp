@@ -0,0 +1,7 @@
+#include "PooledVoiceCallback.h"
+
+// バッファを再生し終えた
+void PooledVoiceCallback::OnBufferEnd(void* pBufferContext)
+{
+	finishedPlay_.store(reinterpret_cast<uintptr_t>(pBufferContext), std::memory_order_release);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <Windows.h>
+#include <stdint.h>
+#include <atomic>
+#include <xaudio2.h>
+
+// 使い回すボイスの通知を受け取る（バッファに鳴らした回数を持たせ、止めて使い回す前のバッファの通知を無視する）
+class PooledVoiceCallback : public IXAudio2VoiceCallback
+{
+public:
+
+	// 鳴らし始める（バッファの pContext に持たせる値を返す）
+	void* BeginPlay() { return reinterpret_cast<void*>(static_cast<uintptr_t>(++numPlays_)); }
+
+	// 最後に鳴らし始めたものを、鳴らし終えたかどうか
+	bool IsFinished() const { return finishedPlay_.load(std::memory_order_acquire) == numPlays_; }
+
+	// バッファを再生し終えた（XAudio2のスレッドから呼ばれる）
+	void STDMETHODCALLTYPE OnBufferEnd(void* pBufferContext) override;
+
+	// 使わない通知
+	void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32 bytesRequired) override {}
+	void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+	void STDMETHODCALLTYPE OnStreamEnd() override {}
+	void STDMETHODCALLTYPE OnBufferStart(void* pBufferContext) override {}
+	void STDMETHODCALLTYPE OnLoopEnd(void* pBufferContext) override {}
+	void STDMETHODCALLTYPE OnVoiceError(void* pBufferContext, HRESULT error) override {}
+
+
+private:
+
+	// 鳴らした回数（鳴らすスレッドだけが使う）
+	uintptr_t numPlays_ = 0;
+
+	// 最後に再生し終えたバッファに持たせた値
+	std::atomic<uintptr_t> finishedPlay_{ 0 };
+};
@@ -3,6 +3,21 @@
 // デストラクタ
 Sound::~Sound()
 {
+	// ボイスは、XAudio2より先に破棄する
+	for (uint32_t i = 0; i < kNumStreams; ++i)
+	{
+		streams_[i].reset();
+	}
+
+	for (uint32_t i = 0; i < kMaxVoices; ++i)
+	{
+		if (pooledVoices_[i] == nullptr)
+			continue;
+
+		pooledVoices_[i]->DestroyVoice();
+		pooledVoices_[i] = nullptr;
+	}
+
 	// XAudio2
 	xAudio2_.Reset();
 
@@ -37,12 +52,13 @@ SoundData Sound::LoadSoundWav(const char* fileName)
 		ファイルを開く
 	------------------*/
 
-	// ファイル入力ストリームのインスタンス
-	std::ifstream file;
+	// .wavファイルを開く（マウントしたアーカイブにあれば、そこから読む）
+	AssetFile assetFile;
+	bool isOpen = assetFile.Open(fileName);
+	assert(isOpen);
 
-	// .wavファイルをバイナリモードで開く
-	file.open(fileName, std::ios_base::binary);
-	assert(file.is_open());
+	// ファイル入力ストリーム
+	std::istream& file = assetFile.GetStream();
 
 
 	/*---------------------
@@ -103,9 +119,10 @@ SoundData Sound::LoadSoundWav(const char* fileName)
 	// Dataチャンクのデータ部（波形データ）の読み込み
 	char* pBuffer = new char[data.size];
 	file.read(pBuffer, data.size);
+	MemoryTracker::Add(pBuffer, MemoryCategory::Sound, MemoryHeap::Cpu, fileName, data.size);
 
 	// Waveファイルを閉じる
-	file.close();
+	assetFile.Close();
 
 
 	/*-----------------------------
@@ -126,6 +143,7 @@ SoundData Sound::LoadSoundWav(const char* fileName)
 void Sound::SoundUnload(SoundData* soundData)
 {
 	// バッファメモリを解放
+	MemoryTracker::Remove(soundData->pBuffer);
 	delete[] soundData->pBuffer;
 
 	soundData->pBuffer = 0;
@@ -134,22 +152,74 @@ void Sound::SoundUnload(SoundData* soundData)
 }
 
 // 音声を再生する
-void Sound::PlaySoundWav(const SoundData& soundData)
+void Sound::PlaySoundWav(uint32_t soundIndex)
 {
-	// 波形フォーマットを基にSourceVoiceを生成する
-	IXAudio2SourceVoice* pSourceVoice = nullptr;
-	HRESULT hr = xAudio2_->CreateSourceVoice(&pSourceVoice, &soundData.wfex);
-	assert(SUCCEEDED(hr));
+	const SoundData& soundData = soundDatas_[soundIndex];
+
+	// 鳴らし終えたものを空きに戻してから、鳴らすボイスを選ぶ
+	CollectFinishedVoices();
+
+	VoiceFormat format{};
+	format.formatTag = soundData.wfex.wFormatTag;
+	format.channels = soundData.wfex.nChannels;
+	format.samplesPerSec = soundData.wfex.nSamplesPerSec;
+	format.blockAlign = soundData.wfex.nBlockAlign;
+	format.bitsPerSample = soundData.wfex.wBitsPerSample;
+
+	VoiceRequest request = voicePool_.Acquire(format, soundIndex, soundPriorities_[soundIndex], soundMaxInstances_[soundIndex]);
+
+	// 優先度の高い音で埋まっていれば鳴らさない
+	if (request.voiceIndex == VoicePool::kInvalidVoice)
+		return;
+
+	IXAudio2SourceVoice*& pSourceVoice = pooledVoices_[request.voiceIndex];
+	PooledVoiceCallback& callback = voiceCallbacks_[request.voiceIndex];
+
+	// 鳴っていたものは止めて、積んであったバッファを捨てる
+	if (request.isStolen && request.needsDestroy == false)
+	{
+		pSourceVoice->Stop();
+		pSourceVoice->FlushSourceBuffers();
+	}
+
+	// 波形フォーマットが違えば作り直す
+	if (request.needsDestroy)
+	{
+		pSourceVoice->DestroyVoice();
+		pSourceVoice = nullptr;
+	}
+
+	if (request.needsCreate)
+	{
+		// 波形フォーマットを基にSourceVoiceを生成する
+		HRESULT hr = xAudio2_->CreateSourceVoice(&pSourceVoice, &soundData.wfex, 0, XAUDIO2_DEFAULT_FREQ_RATIO, &callback);
+		assert(SUCCEEDED(hr));
+	}
 
 	// 再生する波形データの設定
 	XAUDIO2_BUFFER buf{};
 	buf.pAudioData = soundData.pBuffer;
 	buf.AudioBytes = soundData.bufferSize;
 	buf.Flags = XAUDIO2_END_OF_STREAM;
+	buf.pContext = callback.BeginPlay();
 
 	// 波形データの再生
-	hr = pSourceVoice->SubmitSourceBuffer(&buf);
+	HRESULT hr = pSourceVoice->SubmitSourceBuffer(&buf);
+	assert(SUCCEEDED(hr));
 	hr = pSourceVoice->Start();
+	assert(SUCCEEDED(hr));
+}
+
+// 鳴らし終えたボイスを、使い回せるように空きに戻す
+void Sound::CollectFinishedVoices()
+{
+	for (uint32_t i = 0; i < voicePool_.GetNumVoices(); ++i)
+	{
+		if (voicePool_.IsPlaying(i) && voiceCallbacks_[i].IsFinished())
+		{
+			voicePool_.Release(i);
+		}
+	}
 }
 
 // .wavを読み込み、サウンドデータの番号を取得する
@@ -207,7 +277,79 @@ void Sound::SelectNumberPlaySoundWav(uint32_t soundNumber)
 		if (soundNumber != soundDataNumbers_[i])
 			continue;
 
-		PlaySoundWav(soundDatas_[i]);
+		PlaySoundWav(i);
+
+		break;
+	}
+}
+
+// 指定した番号のサウンドデータの、同時に鳴らす数の上限と優先度を設定する
+void Sound::SetSoundPlayback(uint32_t soundNumber, uint32_t maxInstances, int32_t priority)
+{
+	for (uint32_t i = 0; i < kNumSounds; ++i)
+	{
+		if (isSoundLoad_[i] == false)
+			continue;
+
+		if (soundNumber != soundDataNumbers_[i])
+			continue;
+
+		soundMaxInstances_[i] = maxInstances;
+		soundPriorities_[i] = priority;
+
+		break;
+	}
+}
+
+// 使い回しているボイスの数を取得する
+VoicePoolStats Sound::GetVoicePoolStats()
+{
+	CollectFinishedVoices();
+
+	return voicePool_.GetStats();
+}
+
+// .wavを少しずつ読み込みながら再生して、ストリームの番号を取得する
+uint32_t Sound::PlayStreamWav(const char* fileName, bool isLoop)
+{
+	// 使っていないか、終わりまで再生した場所で流す
+	for (uint32_t i = 0; i < kNumStreams; ++i)
+	{
+		if (streams_[i] && streams_[i]->IsFinished() == false)
+			continue;
+
+		streams_[i] = std::make_unique<StreamingVoice>();
+		if (streams_[i]->Initialize(xAudio2_.Get(), fileName) == false)
+		{
+			streams_[i].reset();
+			streamNumbers_[i] = 0;
+			return 0;
+		}
+
+		streams_[i]->Play(isLoop);
+
+		streamNumbers_[i] = nextStreamNumber_++;
+		return streamNumbers_[i];
+	}
+
+	assert(false);
+
+	return 0;
+}
+
+// 指定した番号のストリームを止める
+void Sound::StopStreamWav(uint32_t streamNumber)
+{
+	for (uint32_t i = 0; i < kNumStreams; ++i)
+	{
+		if (streams_[i] == nullptr)
+			continue;
+
+		if (streamNumber != streamNumbers_[i])
+			continue;
+
+		streams_[i].reset();
+		streamNumbers_[i] = 0;
 
 		break;
 	}
@@ -6,7 +6,13 @@
 #include <wrl.h>
 #include <xaudio2.h>
 #include <fstream>
+#include <memory>
 #include "../../Struct.h"
+#include "../AssetFile/AssetFile.h"
+#include "../MemoryTracker/MemoryTracker.h"
+#include "StreamingVoice/StreamingVoice.h"
+#include "PooledVoiceCallback/PooledVoiceCallback.h"
+#include "../VoicePool/VoicePool.h"
 
 #pragma comment(lib,"xaudio2.lib")
 
@@ -26,17 +32,32 @@ public:
 	// 指定した番号のサウンドデータを再生する
 	void SelectNumberPlaySoundWav(uint32_t soundNumber);
 
+	// 指定した番号のサウンドデータの、同時に鳴らす数の上限（0なら上限なし）と優先度（鳴らしきれないとき、低いものから止める）を設定する
+	void SetSoundPlayback(uint32_t soundNumber, uint32_t maxInstances, int32_t priority);
 
-private:
+	// 使い回しているボイスの数を取得する
+	VoicePoolStats GetVoicePoolStats();
+
+	// .wavを全て読み込まずに、少しずつ読み込みながら再生してストリームの番号を取得する（BGMなどの長いもの向け。開けなければ0）
+	uint32_t PlayStreamWav(const char* fileName, bool isLoop);
 
-	// .wavを読み込む
-	SoundData LoadSoundWav(const char* fileName);
+	// 指定した番号のストリームを止める
+	void StopStreamWav(uint32_t streamNumber);
 
-	// 音声を再生する
-	void PlaySoundWav(const SoundData& soundData);
+	// .wavを読み込む（XAudio2を使わないので、初期化していなくても呼べる）
+	static SoundData LoadSoundWav(const char* fileName);
 
 	// サウンドデータを解放する
-	void SoundUnload(SoundData* soundData);
+	static void SoundUnload(SoundData* soundData);
+
+
+private:
+
+	// 音声を再生する（使い回すボイスで鳴らし、鳴らしきれなければ優先度の低いものを止める）
+	void PlaySoundWav(uint32_t soundIndex);
+
+	// 鳴らし終えたボイスを、使い回せるように空きに戻す
+	void CollectFinishedVoices();
 
 
 	// 時間
@@ -59,5 +80,29 @@ private:
 
 	// 読み込まれているかどうか（ロードフラグ）
 	uint32_t isSoundLoad_[256] = { false };
+
+	// サウンドデータごとの、同時に鳴らす数の上限と優先度
+	uint32_t soundMaxInstances_[256] = { 0 };
+	int32_t soundPriorities_[256] = { 0 };
+
+	// 同時に鳴らせるボイスの数
+	static const uint32_t kMaxVoices = 32;
+
+	// ボイスを使い回す順番
+	VoicePool voicePool_{ kMaxVoices };
+
+	// 使い回すボイスと、その通知を受け取るもの
+	IXAudio2SourceVoice* pooledVoices_[kMaxVoices] = { nullptr };
+	PooledVoiceCallback voiceCallbacks_[kMaxVoices];
+
+	// 同時に流せるストリームの数
+	static const uint32_t kNumStreams = 16;
+
+	// 流しているストリーム（終わりまで再生したものは、次に流すときに破棄する）
+	std::unique_ptr<StreamingVoice> streams_[kNumStreams];
+
+	// ストリームの番号と、次に渡す番号
+	uint32_t streamNumbers_[kNumStreams] = { 0 };
+	uint32_t nextStreamNumber_ = 1;
 };
 
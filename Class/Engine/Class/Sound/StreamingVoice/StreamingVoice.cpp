@@ -0,0 +1,84 @@
+#include "StreamingVoice.h"
+
+// デストラクタ
+StreamingVoice::~StreamingVoice()
+{
+	Stop();
+
+	MemoryTracker::Remove(stream_.GetBufferMemory());
+	stream_.Close();
+}
+
+// ファイルを開き、波形フォーマットに合わせたボイスを作る
+bool StreamingVoice::Initialize(IXAudio2* xAudio2, const std::string& filePath)
+{
+	assert(xAudio2);
+
+	if (stream_.Open(filePath) == false)
+		return false;
+
+	xAudio2_ = xAudio2;
+
+	// 長さに関係なく、使うのはバッファの分だけ
+	MemoryTracker::Add(stream_.GetBufferMemory(), MemoryCategory::Sound, MemoryHeap::Cpu, filePath, stream_.GetMemoryBytes());
+
+	return true;
+}
+
+// 始めから再生する
+void StreamingVoice::Play(bool isLoop)
+{
+	Stop();
+
+	// 波形フォーマット（並びは同じだが、フィールドごとに写す）
+	const WavStreamFormat& format = stream_.GetFormat();
+	WAVEFORMATEX wfex{};
+	wfex.wFormatTag = format.formatTag;
+	wfex.nChannels = format.channels;
+	wfex.nSamplesPerSec = format.samplesPerSec;
+	wfex.nAvgBytesPerSec = format.avgBytesPerSec;
+	wfex.nBlockAlign = format.blockAlign;
+	wfex.wBitsPerSample = format.bitsPerSample;
+	wfex.cbSize = 0;
+
+	// バッファを再生し終えたら、このクラスに通知する
+	HRESULT hr = xAudio2_->CreateSourceVoice(&sourceVoice_, &wfex, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+	assert(SUCCEEDED(hr));
+
+	// 読み込むスレッドが最初のバッファを積んでから鳴らし始める
+	stream_.Start(this, isLoop);
+	hr = sourceVoice_->Start();
+	assert(SUCCEEDED(hr));
+}
+
+// 止めて、ボイスを破棄する
+void StreamingVoice::Stop()
+{
+	if (sourceVoice_ == nullptr)
+		return;
+
+	sourceVoice_->Stop();
+
+	// 読み込むスレッドを止めてから、積んだバッファごとボイスを破棄する（破棄し終えたら、もう通知は来ない）
+	stream_.Stop();
+	sourceVoice_->DestroyVoice();
+	sourceVoice_ = nullptr;
+}
+
+// バッファをボイスに積む
+void StreamingVoice::SubmitBuffer(const uint8_t* data, uint32_t sizeInBytes, bool isEndOfStream)
+{
+	XAUDIO2_BUFFER buf{};
+	buf.pAudioData = data;
+	buf.AudioBytes = sizeInBytes;
+	buf.Flags = isEndOfStream ? XAUDIO2_END_OF_STREAM : 0;
+
+	HRESULT hr = sourceVoice_->SubmitSourceBuffer(&buf);
+	assert(SUCCEEDED(hr));
+}
+
+// バッファを再生し終えた
+void StreamingVoice::OnBufferEnd(void* pBufferContext)
+{
+	stream_.OnBufferEnd();
+}
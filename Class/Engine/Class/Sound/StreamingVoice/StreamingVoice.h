@@ -0,0 +1,57 @@
+#pragma once
+#include <Windows.h>
+#include <cassert>
+#include <string>
+#include <xaudio2.h>
+#include "../../WavStream/WavStream.h"
+#include "../../MemoryTracker/MemoryTracker.h"
+
+// .wavを少しずつ読み込みながら再生するボイス（バッファを再生し終えた通知で、次のバッファを読み込ませる）
+class StreamingVoice : public IXAudio2VoiceCallback, public WavStreamSink
+{
+public:
+
+	// デストラクタ
+	virtual ~StreamingVoice();
+
+	// ファイルを開き、波形フォーマットに合わせたボイスを作る（開けなければfalse）
+	bool Initialize(IXAudio2* xAudio2, const std::string& filePath);
+
+	// 始めから再生する
+	void Play(bool isLoop);
+
+	// 止めて、ボイスを破棄する
+	void Stop();
+
+	// 終わりまで再生したかどうか
+	bool IsFinished() const { return stream_.IsFinished(); }
+
+	// Getter
+	const WavStream& GetStream() const { return stream_; }
+
+	// バッファをボイスに積む（読み込むスレッドから呼ばれる）
+	void SubmitBuffer(const uint8_t* data, uint32_t sizeInBytes, bool isEndOfStream) override;
+
+	// バッファを再生し終えた（XAudio2のスレッドから呼ばれる）
+	void STDMETHODCALLTYPE OnBufferEnd(void* pBufferContext) override;
+
+	// 使わない通知
+	void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32 bytesRequired) override {}
+	void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+	void STDMETHODCALLTYPE OnStreamEnd() override {}
+	void STDMETHODCALLTYPE OnBufferStart(void* pBufferContext) override {}
+	void STDMETHODCALLTYPE OnLoopEnd(void* pBufferContext) override {}
+	void STDMETHODCALLTYPE OnVoiceError(void* pBufferContext, HRESULT error) override {}
+
+
+private:
+
+	// XAudio2
+	IXAudio2* xAudio2_ = nullptr;
+
+	// ソースボイス
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+
+	// 読み込むストリーム
+	WavStream stream_;
+};
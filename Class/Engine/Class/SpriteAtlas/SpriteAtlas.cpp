@@ -0,0 +1,174 @@
+#include "SpriteAtlas.h"
+
+// 初期化（ページの大きさと、画像の周りに広げる余白）
+void SpriteAtlas::Initialize(uint32_t pageSize, uint32_t padding)
+{
+	pageSize_ = pageSize;
+	padding_ = padding;
+
+	images_.clear();
+	rects_.clear();
+	pages_.clear();
+}
+
+// 画像を追加する（画像の番号は追加した順。読めなければfalse）
+bool SpriteAtlas::AddImage(const std::string& filePath)
+{
+	// マウントしたアーカイブにあれば、そこから読む
+	AssetFile file;
+	if (file.Open(filePath) == false)
+		return false;
+
+	DirectX::ScratchImage image{};
+	HRESULT hr = DirectX::LoadFromWICMemory(file.GetData(), file.GetSize(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
+	if (FAILED(hr))
+		return false;
+
+	// ページと同じフォーマットにそろえる
+	if (image.GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+	{
+		DirectX::ScratchImage converted{};
+		hr = DirectX::Convert(*image.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+		if (FAILED(hr))
+			return false;
+
+		image = std::move(converted);
+	}
+
+	const DirectX::TexMetadata& metadata = image.GetMetadata();
+	rects_.push_back({ 0, 0, 0, uint32_t(metadata.width), uint32_t(metadata.height) });
+	images_.push_back(std::move(image));
+
+	return true;
+}
+
+// 追加した画像をページに詰め、ミップ付きのページ画像を作る（ページより大きい画像があればfalse）
+bool SpriteAtlas::Build()
+{
+	// 余白を含めた大きさで、ページに詰める
+	uint32_t numPages = 0;
+	if (PackAtlasRects(rects_, pageSize_, padding_, numPages) == false)
+		return false;
+
+	std::vector<DirectX::ScratchImage> pageImages(numPages);
+	for (DirectX::ScratchImage& pageImage : pageImages)
+	{
+		HRESULT hr = pageImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, pageSize_, pageSize_, 1, 1);
+		if (FAILED(hr))
+			return false;
+
+		std::memset(pageImage.GetPixels(), 0, pageImage.GetPixelsSize());
+	}
+
+	// 余白には端のピクセルを広げ、フィルタやミップで隣の画像が混ざらないようにする
+	for (uint32_t i = 0; i < images_.size(); ++i)
+	{
+		const DirectX::Image* src = images_[i].GetImage(0, 0, 0);
+		const DirectX::Image* dest = pageImages[rects_[i].page].GetImage(0, 0, 0);
+		CopyAtlasImage(src->pixels, src->rowPitch, rects_[i], padding_, dest->pixels, dest->rowPitch);
+	}
+
+	// 余白で守れる段数までミップを作る
+	pages_.clear();
+	for (const DirectX::ScratchImage& pageImage : pageImages)
+	{
+		DirectX::ScratchImage mipImages{};
+		HRESULT hr = DirectX::GenerateMipMaps(*pageImage.GetImage(0, 0, 0), DirectX::TEX_FILTER_SRGB, GetAtlasSafeMipLevels(padding_), mipImages);
+		if (FAILED(hr))
+			return false;
+
+		pages_.push_back(std::move(mipImages));
+	}
+
+	// 元の画像はもう使わない
+	images_.clear();
+
+	return true;
+}
+
+// ビルドしたアトラスを保存する（ページはDDS、位置はテキスト）
+void SpriteAtlas::Save(const std::string& filePath)
+{
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+
+	std::ofstream file(filePath);
+	assert(file.is_open());
+
+	file << pageSize_ << " " << padding_ << " " << pages_.size() << " " << rects_.size() << "\n";
+	for (const AtlasRect& rect : rects_)
+	{
+		file << rect.page << " " << rect.x << " " << rect.y << " " << rect.width << " " << rect.height << "\n";
+	}
+
+	for (uint32_t page = 0; page < pages_.size(); ++page)
+	{
+		std::wstring pagePathW = ConvertString(std::format("{}_{}.dds", filePath, page));
+		HRESULT hr = DirectX::SaveToDDSFile(pages_[page].GetImages(), pages_[page].GetImageCount(), pages_[page].GetMetadata(),
+			DirectX::DDS_FLAGS_NONE, pagePathW.c_str());
+		assert(SUCCEEDED(hr));
+	}
+}
+
+// 保存したアトラスを読み込む（無ければfalse）
+bool SpriteAtlas::Load(const std::string& filePath)
+{
+	std::ifstream file(filePath);
+	if (file.is_open() == false)
+		return false;
+
+	size_t numPages = 0;
+	size_t numRects = 0;
+	file >> pageSize_ >> padding_ >> numPages >> numRects;
+
+	rects_.resize(numRects);
+	for (AtlasRect& rect : rects_)
+	{
+		file >> rect.page >> rect.x >> rect.y >> rect.width >> rect.height;
+	}
+
+	if (file.fail())
+		return false;
+
+	pages_.resize(numPages);
+	for (uint32_t page = 0; page < numPages; ++page)
+	{
+		std::wstring pagePathW = ConvertString(std::format("{}_{}.dds", filePath, page));
+		HRESULT hr = DirectX::LoadFromDDSFile(pagePathW.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, pages_[page]);
+		if (FAILED(hr))
+		{
+			pages_.clear();
+			rects_.clear();
+			return false;
+		}
+	}
+
+	images_.clear();
+
+	return true;
+}
+
+// 画像ファイルのパスと中身、設定から、キャッシュのパスを求める（読めない画像があれば空）
+std::string SpriteAtlas::GetCachePath(const std::vector<std::string>& filePaths, uint32_t pageSize, uint32_t padding)
+{
+	uint64_t hash = HashBytes(&kSpriteAtlasCacheVersion, sizeof(kSpriteAtlasCacheVersion));
+	hash = HashBytes(&pageSize, sizeof(pageSize), hash);
+	hash = HashBytes(&padding, sizeof(padding), hash);
+
+	for (const std::string& filePath : filePaths)
+	{
+		// マウントしたアーカイブにあれば、そこから読む
+		AssetFile file;
+		if (file.Open(filePath) == false)
+			return "";
+
+		// 中身だけでなくパスも含め、どちらも長さを先に含めて、区切りの違うものを別のキーにする
+		uint64_t pathSize = filePath.size();
+		uint64_t fileSize = file.GetSize();
+		hash = HashBytes(&pathSize, sizeof(pathSize), hash);
+		hash = HashBytes(filePath.data(), filePath.size(), hash);
+		hash = HashBytes(&fileSize, sizeof(fileSize), hash);
+		hash = HashBytes(file.GetData(), file.GetSize(), hash);
+	}
+
+	return kSpriteAtlasCacheDirectory + "/" + HashToString(hash) + ".atlas";
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <format>
+#include <filesystem>
+#include <algorithm>
+#include "../../externals/DirectXTex/DirectXTex.h"
+#include "../../Func/StringInfo/StringInfo.h"
+#include "../../Func/Hash/Hash.h"
+#include "../../Func/AtlasPacker/AtlasPacker.h"
+#include "../AssetFile/AssetFile.h"
+#include "../../Struct.h"
+
+// アトラスのキャッシュを置くディレクトリ
+const std::string kSpriteAtlasCacheDirectory = "Class/Engine/Cache/Atlases";
+
+// キャッシュのバージョン（キャッシュの形式やキーの求め方、詰め方を変えたら更新する）
+const uint32_t kSpriteAtlasCacheVersion = 2;
+
+class SpriteAtlas
+{
+public:
+
+	// 初期化（ページの大きさと、画像の周りに広げる余白）
+	void Initialize(uint32_t pageSize, uint32_t padding);
+
+	// 画像を追加する（マウントしたアーカイブにあれば、そこから読む。画像の番号は追加した順。読めなければfalse）
+	bool AddImage(const std::string& filePath);
+
+	// 追加した画像をページに詰め、ミップ付きのページ画像を作る（ページより大きい画像があればfalse）
+	bool Build();
+
+	// ビルドしたアトラスを保存する（ページはDDS、位置はテキスト）
+	void Save(const std::string& filePath);
+
+	// 保存したアトラスを読み込む（無ければfalse）
+	bool Load(const std::string& filePath);
+
+	// 画像ファイルのパスと中身、設定から、キャッシュのパスを求める（読めない画像があれば空）
+	static std::string GetCachePath(const std::vector<std::string>& filePaths, uint32_t pageSize, uint32_t padding);
+
+	// Getter
+	uint32_t GetNumPages() const { return uint32_t(pages_.size()); }
+	uint32_t GetNumImages() const { return uint32_t(rects_.size()); }
+	const DirectX::ScratchImage& GetPage(uint32_t page) const { return pages_[page]; }
+	const AtlasRect& GetRect(uint32_t imageNumber) const { return rects_[imageNumber]; }
+	Vector2 GetUVMin(uint32_t imageNumber) const { return GetAtlasUVMin(rects_[imageNumber], pageSize_); }
+	Vector2 GetUVMax(uint32_t imageNumber) const { return GetAtlasUVMax(rects_[imageNumber], pageSize_); }
+
+
+private:
+
+	// ページの大きさ
+	uint32_t pageSize_ = 0;
+
+	// 画像の周りに広げる余白
+	uint32_t padding_ = 0;
+
+	// 追加された画像
+	std::vector<DirectX::ScratchImage> images_;
+
+	// 画像の位置
+	std::vector<AtlasRect> rects_;
+
+	// ページの画像
+	std::vector<DirectX::ScratchImage> pages_;
+};
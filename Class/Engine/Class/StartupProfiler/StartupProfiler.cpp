@@ -0,0 +1,239 @@
+#include "StartupProfiler.h"
+
+namespace
+{
+	// JSONの文字列に入れられるように、エスケープする
+	std::string EscapeJsonString(const std::string& str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+
+		for (char c : str)
+		{
+			switch (c)
+			{
+			case '\"': escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\r': escaped += "\\r"; break;
+			case '\t': escaped += "\\t"; break;
+
+			default:
+
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					escaped += engine::format("\\u{:04x}", static_cast<unsigned char>(c));
+				} else
+				{
+					escaped += c;
+				}
+
+				break;
+			}
+		}
+
+		return escaped;
+	}
+}
+
+// コンストラクタ（ここから計測を始める）
+StartupProfiler::StartupProfiler()
+{
+	origin_ = std::chrono::steady_clock::now();
+}
+
+// 区間を始める（計測を終えていたら何もしない）
+void StartupProfiler::Begin(const std::string& name, const std::string& category, const std::string& detail)
+{
+	if (isRecording_ == false)
+		return;
+
+	ProfileEvent event{};
+	event.name = name;
+	event.category = category;
+	event.detail = detail;
+	event.startMicroseconds = GetElapsedMicroseconds();
+	event.durationMicroseconds = 0.0;
+	event.depth = static_cast<uint32_t>(openEvents_.size());
+
+	openEvents_.push_back(events_.size());
+	events_.push_back(event);
+}
+
+// 最後に始めた区間を終える
+void StartupProfiler::End()
+{
+	if (openEvents_.empty())
+		return;
+
+	ProfileEvent& event = events_[openEvents_.back()];
+	event.durationMicroseconds = GetElapsedMicroseconds() - event.startMicroseconds;
+
+	openEvents_.pop_back();
+}
+
+// 計測を終える（開いている区間は全て閉じる）
+void StartupProfiler::Finish()
+{
+	if (isRecording_ == false)
+		return;
+
+	while (openEvents_.empty() == false)
+	{
+		End();
+	}
+
+	totalMicroseconds_ = GetElapsedMicroseconds();
+	isRecording_ = false;
+}
+
+// 区間の入れ子と、分類ごとの合計をログに書き出す
+void StartupProfiler::Report(std::ostream& os) const
+{
+	double totalMilliseconds = GetTotalMilliseconds();
+
+	Log(os, engine::format("StartupProfiler : startup {:.2f} ms , {} events", totalMilliseconds, events_.size()));
+	Log(os, engine::format("StartupProfiler : {:<48} {:>10} {:>10} {:>7}", "phase", "total ms", "self ms", "%"));
+
+	// 区間の時間から、すぐ内側の区間の時間を引いたものを、その区間だけでかかった時間とする
+	std::vector<double> selfMicroseconds(events_.size());
+	for (size_t i = 0; i < events_.size(); ++i)
+	{
+		selfMicroseconds[i] = events_[i].durationMicroseconds;
+
+		for (size_t j = i + 1; j < events_.size() && events_[j].depth > events_[i].depth; ++j)
+		{
+			if (events_[j].depth == events_[i].depth + 1)
+			{
+				selfMicroseconds[i] -= events_[j].durationMicroseconds;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < events_.size(); ++i)
+	{
+		const ProfileEvent& event = events_[i];
+
+		std::string label = std::string(event.depth * 2, ' ') + event.name;
+		if (event.detail.empty() == false)
+		{
+			label += " " + event.detail;
+		}
+
+		double percent = totalMilliseconds > 0.0 ? event.durationMicroseconds / 10.0 / totalMilliseconds : 0.0;
+
+		Log(os, engine::format("StartupProfiler : {:<48} {:>10.2f} {:>10.2f} {:>6.1f}%",
+			label, event.durationMicroseconds / 1000.0, selfMicroseconds[i] / 1000.0, percent));
+	}
+
+	// 分類ごとの合計（入れ子になった同じ分類は、二重に数えないように一番外側だけを足す）
+	std::vector<std::string> categories;
+	std::vector<double> categoryMicroseconds;
+	std::vector<uint32_t> categoryCounts;
+	std::vector<size_t> openCategories;
+
+	for (size_t i = 0; i < events_.size(); ++i)
+	{
+		const ProfileEvent& event = events_[i];
+
+		while (openCategories.empty() == false && events_[openCategories.back()].depth >= event.depth)
+		{
+			openCategories.pop_back();
+		}
+
+		bool isNested = false;
+		for (size_t open : openCategories)
+		{
+			if (events_[open].category == event.category)
+			{
+				isNested = true;
+				break;
+			}
+		}
+
+		openCategories.push_back(i);
+
+		if (isNested)
+			continue;
+
+		size_t index = std::find(categories.begin(), categories.end(), event.category) - categories.begin();
+		if (index == categories.size())
+		{
+			categories.push_back(event.category);
+			categoryMicroseconds.push_back(0.0);
+			categoryCounts.push_back(0);
+		}
+
+		categoryMicroseconds[index] += event.durationMicroseconds;
+		categoryCounts[index]++;
+	}
+
+	for (size_t i = 0; i < categories.size(); ++i)
+	{
+		Log(os, engine::format("StartupProfiler : category {:<16} {:>10.2f} ms ({} events)",
+			categories[i], categoryMicroseconds[i] / 1000.0, categoryCounts[i]));
+	}
+}
+
+// Chromeのトレース（chrome://tracing や Perfetto で開けるJSON）を書き出す
+bool StartupProfiler::WriteChromeTrace(const std::string& filePath) const
+{
+	std::filesystem::path path(filePath);
+	if (path.has_parent_path())
+	{
+		std::error_code errorCode;
+		std::filesystem::create_directories(path.parent_path(), errorCode);
+	}
+
+	std::ofstream file(filePath, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Startup\"}}";
+
+	// 全て同じスレッドで計測しているので、完了イベント（X）として入れ子のまま並べる
+	for (const ProfileEvent& event : events_)
+	{
+		file << engine::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":1",
+			EscapeJsonString(event.name), EscapeJsonString(event.category), event.startMicroseconds, event.durationMicroseconds);
+
+		if (event.detail.empty() == false)
+		{
+			file << engine::format(",\"args\":{{\"detail\":\"{}\"}}", EscapeJsonString(event.detail));
+		}
+
+		file << "}";
+	}
+
+	file << "\n]}\n";
+
+	return file.good();
+}
+
+// 計測を始めてからの経過時間（マイクロ秒）
+double StartupProfiler::GetElapsedMicroseconds() const
+{
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - origin_;
+	return elapsed.count();
+}
+
+
+// コンストラクタ（profilerがnullptrなら何もしない）
+ProfileScope::ProfileScope(StartupProfiler* profiler, const std::string& name, const std::string& category, const std::string& detail)
+{
+	if (profiler == nullptr || profiler->IsRecording() == false)
+		return;
+
+	profiler_ = profiler;
+	profiler_->Begin(name, category, detail);
+}
+
+// デストラクタ
+ProfileScope::~ProfileScope()
+{
+	if (profiler_)
+	{
+		profiler_->End();
+	}
+}
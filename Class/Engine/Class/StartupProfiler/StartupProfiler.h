@@ -0,0 +1,104 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include "../../Func/StringInfo/StringInfo.h"
+#include "../../Func/Format/Format.h"
+
+// 計測した区間
+typedef struct ProfileEvent
+{
+	// 区間の名前
+	std::string name;
+
+	// 分類（集計に使う）
+	std::string category;
+
+	// 補足（読み込んだファイルのパスなど）
+	std::string detail;
+
+	// 計測を始めてからの開始時刻（マイクロ秒）
+	double startMicroseconds;
+
+	// かかった時間（マイクロ秒）
+	double durationMicroseconds;
+
+	// 入れ子の深さ
+	uint32_t depth;
+}ProfileEvent;
+
+// 起動処理の区間ごとの時間を計測し、レポートとChromeのトレースに書き出す（メインスレッドからだけ使う）
+class StartupProfiler
+{
+public:
+
+	// コンストラクタ（ここから計測を始める）
+	StartupProfiler();
+
+	// 区間を始める（計測を終えていたら何もしない）
+	void Begin(const std::string& name, const std::string& category, const std::string& detail = "");
+
+	// 最後に始めた区間を終える
+	void End();
+
+	// 計測を終える（開いている区間は全て閉じる）
+	void Finish();
+
+	// 区間の入れ子と、分類ごとの合計をログに書き出す
+	void Report(std::ostream& os) const;
+
+	// Chromeのトレース（chrome://tracing や Perfetto で開けるJSON）を書き出す
+	bool WriteChromeTrace(const std::string& filePath) const;
+
+	// Getter
+	bool IsRecording() const { return isRecording_; }
+	double GetTotalMilliseconds() const { return totalMicroseconds_ / 1000.0; }
+	const std::vector<ProfileEvent>& GetEvents() const { return events_; }
+
+
+private:
+
+	// 計測を始めてからの経過時間（マイクロ秒）
+	double GetElapsedMicroseconds() const;
+
+	// 計測を始めた時刻
+	std::chrono::steady_clock::time_point origin_{};
+
+	// 計測した区間（始めた順）
+	std::vector<ProfileEvent> events_;
+
+	// 開いている区間の番号
+	std::vector<size_t> openEvents_;
+
+	// 計測全体の時間（マイクロ秒）
+	double totalMicroseconds_ = 0.0;
+
+	// 計測中かどうか
+	bool isRecording_ = true;
+};
+
+// スコープを抜けるまでを1つの区間として計測する
+class ProfileScope
+{
+public:
+
+	// コンストラクタ（profilerがnullptrなら何もしない）
+	ProfileScope(StartupProfiler* profiler, const std::string& name, const std::string& category, const std::string& detail = "");
+
+	// 2回終えないように、コピーはしない
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+	// デストラクタ
+	~ProfileScope();
+
+
+private:
+
+	// 計測先（計測を終えていたらnullptr）
+	StartupProfiler* profiler_ = nullptr;
+};
@@ -1,20 +1,456 @@
 #include "TextureManager.h"
 
 // 初期化する
-void TextureManager::Initialize()
+void TextureManager::Initialize(GpuMemoryAllocator* memoryAllocator)
 {
 	srand(currentTimer_);
+
+	memoryAllocator_ = memoryAllocator;
+
+	// ストリーミングのスケジューラ
+	streamer_.Initialize(kStreamingBytesPerFrame_, kStreamingRequestLifetime_);
 }
 
 // テクスチャを読み込む
-uint32_t TextureManager::LoadTextureGetNumber(const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
+uint32_t TextureManager::LoadTextureGetNumber(std::ostream& os, const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
 	 Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap,Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
 {
-	DirectX::ScratchImage mipImage = LoadTexture(filePath);
+	// 同じテクスチャを読み込み済みなら、それを共有する
+	std::vector<uint8_t> sourceBytes;
+	uint64_t contentHash = 0;
+	int32_t loaded = FindLoadedTexture(os, filePath, sourceBytes, contentHash);
+	if (loaded >= 0)
+		return textureNumbers_[loaded];
+
+	DirectX::ScratchImage mipImage = LoadTexture(os, filePath, sourceBytes, cookSettings_);
+	MemoryScope imageMemory(&mipImage, MemoryCategory::Texture, MemoryHeap::Cpu, filePath, mipImage.GetPixelsSize());
+
+	uint32_t textureNumber = LoadTextureFromImageGetNumber(filePath, mipImage, device, srvDescriptorHeap, commandList);
+	RegisterContent(FindSlot(textureNumber), filePath, contentHash);
+
+	return textureNumber;
+}
+
+// CPU上の画像からテクスチャを作る（nameはメモリの記録に使う）
+uint32_t TextureManager::LoadTextureFromImageGetNumber(const std::string& name, const DirectX::ScratchImage& mipImage, Microsoft::WRL::ComPtr<ID3D12Device> device,
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+{
+	const DirectX::TexMetadata& metadata = mipImage.GetMetadata();
+
+
+	// 使用していないテクスチャリソースに格納する
+	int32_t i = AllocateSlot();
+	if (i < 0)
+	{
+		assert(false);
+		return -1;
+	}
+
+	CreateSlotResource(i, metadata, device);
+	CreateIntermediateBuffer(i, 0, uint32_t(mipImage.GetImageCount()), device);
+	UploadTextureData(textureResources_[i], mipImage, intermediateResources_[i].Get(), intermediateAllocations_[i].offset, device, commandList);
+
+	// metaDataを基にSRVを作成する
+	CreateShaderResourceView(i, metadata, 0, device, srvDescriptorHeap);
+
+	// 共有したときに節約できる大きさを覚えておく
+	D3D12_RESOURCE_DESC resourceDesc = textureResources_[i]->GetDesc();
+	vramBytes_[i] = device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+	ramBytes_[i] = mipImage.GetPixelsSize();
+	refCounts_[i] = 1;
+
+	TrackResources(i, name);
+
+	return textureNumbers_[i];
+}
+
+// テクスチャを読み込む（末尾ミップだけを転送し、細かいミップは後からストリーミングする）
+uint32_t TextureManager::LoadTextureStreamingGetNumber(std::ostream& os, const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+{
+	// 同じテクスチャを読み込み済みなら、それを共有する
+	std::vector<uint8_t> sourceBytes;
+	uint64_t contentHash = 0;
+	int32_t loaded = FindLoadedTexture(os, filePath, sourceBytes, contentHash);
+	if (loaded >= 0)
+		return textureNumbers_[loaded];
+
+	DirectX::ScratchImage mipImage = LoadTexture(os, filePath, sourceBytes, cookSettings_);
+	MemoryScope imageMemory(&mipImage, MemoryCategory::Texture, MemoryHeap::Cpu, filePath, mipImage.GetPixelsSize());
 	const DirectX::TexMetadata& metadata = mipImage.GetMetadata();
 
 
 	// 使用していないテクスチャリソースに格納する
+	int32_t i = AllocateSlot();
+	if (i < 0)
+	{
+		assert(false);
+		return -1;
+	}
+
+	// 全てのミップを持つリソースを作るが、転送するのは末尾のミップだけ
+	uint32_t mipLevels = uint32_t(metadata.mipLevels);
+	uint32_t tailMip = TextureStreamer::SelectTailMip(uint32_t(metadata.width), uint32_t(metadata.height), mipLevels, kStreamingTailSize_);
+
+	CreateSlotResource(i, metadata, device);
+	CreateIntermediateBuffer(i, tailMip, mipLevels - tailMip, device);
+	UploadTextureMipData(textureResources_[i], mipImage, tailMip, mipLevels - tailMip, intermediateResources_[i].Get(), intermediateAllocations_[i].offset,
+		device, commandList);
+
+	// 転送済みのミップだけを参照するSRVを作る
+	CreateShaderResourceView(i, metadata, tailMip, device, srvDescriptorHeap);
+
+	// 共有したときに節約できる大きさを覚えておく
+	D3D12_RESOURCE_DESC resourceDesc = textureResources_[i]->GetDesc();
+	vramBytes_[i] = device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+	ramBytes_[i] = mipImage.GetPixelsSize();
+	refCounts_[i] = 1;
+	RegisterContent(i, filePath, contentHash);
+	TrackResources(i, filePath);
+
+
+	/*------------------------------
+	    ストリーミングに登録する
+	------------------------------*/
+
+	// ミップごとのバイト数
+	std::vector<uint64_t> mipByteSizes(mipLevels);
+	for (uint32_t mipLevel = 0; mipLevel < mipLevels; ++mipLevel)
+	{
+		mipByteSizes[mipLevel] = mipImage.GetImage(mipLevel, 0, 0)->slicePitch;
+	}
+
+	streamer_.Register(i, uint32_t(metadata.width), uint32_t(metadata.height), mipByteSizes, tailMip);
+
+	// 細かいミップを転送し終わるまで、CPU側のデータを持っておく
+	if (tailMip > 0)
+	{
+		streamingImages_[i] = std::move(mipImage);
+		MemoryTracker::Add(&streamingImages_[i], MemoryCategory::Texture, MemoryHeap::Cpu, filePath, streamingImages_[i].GetPixelsSize());
+	}
+
+	return textureNumbers_[i];
+}
+
+// 読み込み済みのテクスチャをファイルから読み込み直し、同じ番号のまま中身を差し替える（読み込んでいなければfalse）
+bool TextureManager::ReloadTexture(std::ostream& os, const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+{
+	auto path = pathSlots_.find(GetPathKey(filePath));
+	if (path == pathSlots_.end())
+		return false;
+
+	// 保存の途中で消えているときは、次の変更を待つ
+	if (AssetFile::Exists(filePath) == false)
+		return false;
+
+	std::string pathKey = path->first;
+	uint32_t i = path->second;
+
+	// 中身が変わっていなければ、読み込み直さない
+	std::vector<uint8_t> sourceBytes = ReadTextureFile(filePath);
+	uint64_t contentHash = HashTextureContent(sourceBytes.data(), sourceBytes.size(), cookSettings_);
+	if (contentHash == contentHashes_[i])
+		return false;
+
+	// 中身が同じで共有していた別のパスがあれば、そちらは元の中身のまま残し、このパスだけを新しい格納場所に分ける
+	bool isShared = std::any_of(pathSlots_.begin(), pathSlots_.end(),
+		[&pathKey, i](const std::pair<const std::string, uint32_t>& entry) { return entry.second == i && entry.first != pathKey; });
+	if (isShared)
+		return SplitReloadedTexture(os, filePath, pathKey, sourceBytes, contentHash, device, srvDescriptorHeap, commandList);
+
+	DirectX::ScratchImage mipImage = LoadTexture(os, filePath, sourceBytes, cookSettings_);
+	MemoryScope imageMemory(&mipImage, MemoryCategory::Texture, MemoryHeap::Cpu, filePath, mipImage.GetPixelsSize());
+	const DirectX::TexMetadata& metadata = mipImage.GetMetadata();
+
+	// 古いリソースとディスクリプタは、このフレームのコマンドが使っているかもしれないので、次のフレームまで残す
+	UntrackResources(i);
+	RetireSlotResources(i);
+
+	// ストリーミング中だったものも、全てのミップを転送し直す
+	MemoryTracker::Remove(&streamingImages_[i]);
+	streamingImages_[i].Release();
+	streamer_.Unregister(i);
+
+	CreateSlotResource(i, metadata, device);
+	CreateIntermediateBuffer(i, 0, uint32_t(mipImage.GetImageCount()), device);
+	UploadTextureData(textureResources_[i], mipImage, intermediateResources_[i].Get(), intermediateAllocations_[i].offset, device, commandList);
+	CreateShaderResourceView(i, metadata, 0, device, srvDescriptorHeap);
+
+	D3D12_RESOURCE_DESC resourceDesc = textureResources_[i]->GetDesc();
+	vramBytes_[i] = device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+	ramBytes_[i] = mipImage.GetPixelsSize();
+	TrackResources(i, filePath);
+
+	// 中身の索引を付け替える（このパスだけが使っている格納場所なので、他のパスの中身は変わらない）
+	auto content = contentSlots_.find(contentHashes_[i]);
+	if (content != contentSlots_.end() && content->second == i)
+	{
+		contentSlots_.erase(content);
+	}
+
+	contentHashes_[i] = contentHash;
+	contentSlots_.try_emplace(contentHash, i);
+
+	Log(os, std::format("ReloadTexture : {} , refs {}", filePath, refCounts_[i]));
+
+	return true;
+}
+
+// 共有していた格納場所から、読み込み直したパスだけを新しい格納場所に分ける
+bool TextureManager::SplitReloadedTexture(std::ostream& os, const std::string& filePath, const std::string& pathKey, const std::vector<uint8_t>& sourceBytes,
+	uint64_t contentHash, Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap,
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+{
+	uint32_t previous = pathSlots_[pathKey];
+
+	// 新しい中身と同じものを読み込み済みなら、このパスはそれを指す
+	auto content = contentSlots_.find(contentHash);
+	if (content != contentSlots_.end())
+	{
+		pathSlots_[pathKey] = content->second;
+		Log(os, std::format("ReloadTexture (split, shared by content) : {} , previous refs {}", filePath, refCounts_[previous]));
+		return true;
+	}
+
+	DirectX::ScratchImage mipImage = LoadTexture(os, filePath, sourceBytes, cookSettings_);
+	MemoryScope imageMemory(&mipImage, MemoryCategory::Texture, MemoryHeap::Cpu, filePath, mipImage.GetPixelsSize());
+
+	uint32_t textureNumber = LoadTextureFromImageGetNumber(filePath, mipImage, device, srvDescriptorHeap, commandList);
+	int32_t slot = FindSlot(textureNumber);
+	if (slot < 0)
+		return false;
+
+	// 元の格納場所の番号を持っているものは、元の中身のまま使う。参照は、このパスを次に読み込んだときに増える
+	refCounts_[slot] = 0;
+	RegisterContent(slot, filePath, contentHash);
+
+	Log(os, std::format("ReloadTexture (split) : {} , previous refs {}", filePath, refCounts_[previous]));
+
+	return true;
+}
+
+// 指定したテクスチャの参照を1つ減らす（誰も使わなくなったら、GPUが使い終わってから解放する）
+void TextureManager::ReleaseTexture(uint32_t textureNumber)
+{
+	int32_t i = FindSlot(textureNumber);
+	if (i < 0)
+	{
+		assert(false);
+		return;
+	}
+
+	refCounts_[i]--;
+	if (refCounts_[i] > 0)
+		return;
+
+	// このフレームのコマンドが使っているかもしれないので、次のフレームまで残す
+	UntrackResources(i);
+	RetireSlotResources(i);
+
+	textureResources_[i] = nullptr;
+	intermediateResources_[i] = nullptr;
+	MemoryTracker::Remove(&streamingImages_[i]);
+	streamingImages_[i].Release();
+	streamer_.Unregister(i);
+
+	// 索引から外す
+	std::erase_if(pathSlots_, [i](const std::pair<const std::string, uint32_t>& entry) { return entry.second == uint32_t(i); });
+
+	auto content = contentSlots_.find(contentHashes_[i]);
+	if (content != contentSlots_.end() && content->second == uint32_t(i))
+	{
+		contentSlots_.erase(content);
+	}
+
+	textureNumbers_[i] = 0;
+}
+
+// 前のフレームで解放したリソースとディスクリプタを、使えるようにする（GPUの完了を待ってから呼ぶ）
+void TextureManager::CollectRetiredResources()
+{
+	retiredResources_.clear();
+
+	// リソースを解放してから、ヒープの場所を使えるようにする
+	for (GpuTextureAllocation& allocation : retiredTextureAllocations_)
+	{
+		memoryAllocator_->FreeTexture(allocation);
+	}
+	retiredTextureAllocations_.clear();
+
+	for (const GpuBufferAllocation& allocation : retiredUploadAllocations_)
+	{
+		memoryAllocator_->FreeUploadBuffer(allocation);
+	}
+	retiredUploadAllocations_.clear();
+
+	freeDescriptorIndices_.insert(freeDescriptorIndices_.end(), retiredDescriptorIndices_.begin(), retiredDescriptorIndices_.end());
+	retiredDescriptorIndices_.clear();
+}
+
+// 指定したテクスチャのディスクリプタを取得する
+RenderHandle TextureManager::GetDescriptorHandle(uint32_t textureNumber)
+{
+	int32_t i = FindSlot(textureNumber);
+	if (i < 0)
+	{
+		assert(false);
+		return 0;
+	}
+
+	return gpuDescriptorHandle_[i].ptr;
+}
+
+// 指定したテクスチャを画面上で表示する大きさ（ピクセル）を要求する
+void TextureManager::RequestScreenSize(uint32_t textureNumber, float screenPixels, double currentTime)
+{
+	int32_t i = FindSlot(textureNumber);
+	if (i < 0)
+		return;
+
+	streamer_.RequestScreenSize(i, screenPixels, currentTime);
+}
+
+// ストリーミング中のミップを、予算の範囲内で転送する
+void TextureManager::UpdateStreaming(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, double currentTime)
+{
+	// 前のフレームの転送は、GPUの完了を待ってから呼ばれるので解放してよい
+	for (const Microsoft::WRL::ComPtr<ID3D12Resource>& resource : streamingIntermediateResources_)
+	{
+		MemoryTracker::Remove(resource.Get());
+	}
+
+	for (const GpuBufferAllocation& allocation : streamingUploadAllocations_)
+	{
+		MemoryTracker::Remove(allocation.data);
+		memoryAllocator_->FreeUploadBuffer(allocation);
+	}
+
+	streamingIntermediateResources_.clear();
+	streamingUploadAllocations_.clear();
+
+	std::vector<StreamingRequest> requests = streamer_.Update(currentTime);
+
+	for (const StreamingRequest& request : requests)
+	{
+		uint32_t i = request.slot;
+
+		// ミップを転送する（memoryAllocatorがあれば、転送用のバッファを書き込めるバッファのプールから切り分ける）
+		uint64_t sizeInBytes = GetRequiredIntermediateSize(textureResources_[i].Get(), request.mipLevel, 1);
+		if (memoryAllocator_)
+		{
+			GpuBufferAllocation allocation = memoryAllocator_->AllocateUploadBuffer(sizeInBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+			UploadTextureMipData(textureResources_[i], streamingImages_[i], request.mipLevel, 1, allocation.resource, allocation.offset, device, commandList);
+
+			streamingUploadAllocations_.push_back(allocation);
+			MemoryTracker::Add(allocation.data, MemoryCategory::Upload, MemoryHeap::Gpu, "Texture streaming", allocation.sizeInBytes);
+		}
+		else
+		{
+			streamingIntermediateResources_.push_back(CreateBufferResource(device, UINT(sizeInBytes)));
+			UploadTextureMipData(textureResources_[i], streamingImages_[i], request.mipLevel, 1, streamingIntermediateResources_.back().Get(), 0, device, commandList);
+			MemoryTracker::AddResource(streamingIntermediateResources_.back().Get(), MemoryCategory::Upload, "Texture streaming");
+		}
+
+		// 転送したミップまで参照するようにSRVを作り直す
+		const DirectX::TexMetadata& metadata = streamingImages_[i].GetMetadata();
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = srvDesc_[i];
+		srvDesc.Texture2D.MostDetailedMip = request.mipLevel;
+		srvDesc.Texture2D.MipLevels = UINT(metadata.mipLevels) - request.mipLevel;
+		srvDesc_[i] = srvDesc;
+		device->CreateShaderResourceView(textureResources_[i].Get(), &srvDesc_[i], cpuDescriptorHandle_[i]);
+
+		// 全て転送し終わったら、CPU側のデータを解放する
+		if (request.mipLevel == 0)
+		{
+			MemoryTracker::Remove(&streamingImages_[i]);
+			streamingImages_[i].Release();
+		}
+	}
+}
+
+// 同じパス、または同じ中身のテクスチャを読み込み済みなら、参照を増やしてその格納場所を返す（無ければ-1）
+int32_t TextureManager::FindLoadedTexture(std::ostream& os, const std::string& filePath, std::vector<uint8_t>& sourceBytes, uint64_t& contentHash)
+{
+	// 同じパスなら、ファイルを読まずに共有する
+	std::string pathKey = GetPathKey(filePath);
+
+	auto path = pathSlots_.find(pathKey);
+	if (path != pathSlots_.end())
+	{
+		AddReference(os, path->second, filePath, "path");
+		return int32_t(path->second);
+	}
+
+	// 中身が同じなら、別のパスでも共有する（モデルごとに置かれた同じ画像など）
+	sourceBytes = ReadTextureFile(filePath);
+	contentHash = HashTextureContent(sourceBytes.data(), sourceBytes.size(), cookSettings_);
+
+	auto content = contentSlots_.find(contentHash);
+	if (content != contentSlots_.end())
+	{
+		pathSlots_[pathKey] = content->second;
+		AddReference(os, content->second, filePath, "content");
+		return int32_t(content->second);
+	}
+
+	return -1;
+}
+
+// 読み込んだテクスチャを、パスと中身の索引に登録する
+void TextureManager::RegisterContent(int32_t slot, const std::string& filePath, uint64_t contentHash)
+{
+	if (slot < 0)
+		return;
+
+	contentHashes_[slot] = contentHash;
+	contentSlots_[contentHash] = uint32_t(slot);
+	pathSlots_[GetPathKey(filePath)] = uint32_t(slot);
+}
+
+// 共有したテクスチャの参照を増やし、節約できた大きさをログに書き出す
+void TextureManager::AddReference(std::ostream& os, uint32_t slot, const std::string& filePath, const char* matchedBy)
+{
+	refCounts_[slot]++;
+
+	// 読み込み直して分けた格納場所を、初めて使うときは共有していない
+	if (refCounts_[slot] == 1)
+		return;
+
+	savedVramBytes_ += vramBytes_[slot];
+	savedRamBytes_ += ramBytes_[slot];
+
+	Log(os, std::format("LoadTexture (shared by {}) : {} , refs {} , saved VRAM {} bytes , RAM {} bytes (total VRAM {} bytes , RAM {} bytes)",
+		matchedBy, filePath, refCounts_[slot], vramBytes_[slot], ramBytes_[slot], savedVramBytes_, savedRamBytes_));
+}
+
+// パスの索引のキー（同じファイルを指す書き方の違いと、クックの設定の違いを区別する）
+std::string TextureManager::GetPathKey(const std::string& filePath)
+{
+	return std::format("{}|{}|{}", std::filesystem::path(filePath).lexically_normal().generic_string(),
+		int32_t(cookSettings_.compressFormat), cookSettings_.fastCompression);
+}
+
+// テクスチャ番号から格納場所を探す
+int32_t TextureManager::FindSlot(uint32_t textureNumber)
+{
+	for (uint32_t i = 0; i < kNumTexture_; i++)
+	{
+		if (textureNumber != textureNumbers_[i])
+			continue;
+
+		if (textureResources_[i] == nullptr)
+			continue;
+
+		return int32_t(i);
+	}
+
+	return -1;
+}
+
+// 使用していない格納場所を探し、テクスチャ番号を割り当てる
+int32_t TextureManager::AllocateSlot()
+{
 	for (uint32_t i = 0; i < kNumTexture_; i++)
 	{
 		if (textureResources_[i])
@@ -38,49 +474,122 @@ uint32_t TextureManager::LoadTextureGetNumber(const std::string& filePath, Micro
 			}
 		}
 
-		textureResources_[i] = CreateTextureResource(device, metadata);
-		intermediateResources_[i] = UploadTextureData(textureResources_[i], mipImage, device, commandList);
+		return int32_t(i);
+	}
 
-		// metaDataを基にSRVを作成する
-		srvDesc_[i].Format = metadata.format;
-		srvDesc_[i].Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		srvDesc_[i].ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-		srvDesc_[i].Texture2D.MipLevels = UINT(metadata.mipLevels);
+	return -1;
+}
 
-		cpuDescriptorHandle_[i] = GetCPUDescriptorHandle(srvDescriptorHeap, device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV), 1 + textureCount_);
-		gpuDescriptorHandle_[i] = GetGPUDescriptorHandle(srvDescriptorHeap, device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV), 1 + textureCount_);
+// テクスチャのリソースを作る
+void TextureManager::CreateSlotResource(uint32_t slot, const DirectX::TexMetadata& metadata, Microsoft::WRL::ComPtr<ID3D12Device> device)
+{
+	if (memoryAllocator_ == nullptr)
+	{
+		textureResources_[slot] = CreateTextureResource(device, metadata);
+		return;
+	}
 
-		// SRVを生成する
-		device->CreateShaderResourceView(textureResources_[i].Get(), &srvDesc_[i], cpuDescriptorHandle_[i]);
+	textureAllocations_[slot] = memoryAllocator_->CreateTexture(MakeTextureResourceDesc(metadata), D3D12_RESOURCE_STATE_COPY_DEST);
+	textureResources_[slot] = textureAllocations_[slot].resource;
+}
 
-		// テクスチャの数をカウントする
-		textureCount_++;
+// 転送用のバッファを用意する（firstMipからnumMips個のミップが入る大きさ）
+void TextureManager::CreateIntermediateBuffer(uint32_t slot, uint32_t firstMip, uint32_t numMips, Microsoft::WRL::ComPtr<ID3D12Device> device)
+{
+	uint64_t sizeInBytes = GetRequiredIntermediateSize(textureResources_[slot].Get(), firstMip, numMips);
 
-		return textureNumbers_[i];
+	if (memoryAllocator_ == nullptr)
+	{
+		intermediateResources_[slot] = CreateBufferResource(device, UINT(sizeInBytes));
+		intermediateAllocations_[slot] = {};
+		return;
 	}
 
-	assert(false);
+	// テクスチャのデータは、バッファの中で512バイトに揃えて置く
+	intermediateAllocations_[slot] = memoryAllocator_->AllocateUploadBuffer(sizeInBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	intermediateResources_[slot] = intermediateAllocations_[slot].resource;
+}
 
-	return -1;
+// テクスチャのリソースと転送用のリソースとディスクリプタを、GPUが使い終わるまで残す
+void TextureManager::RetireSlotResources(uint32_t slot)
+{
+	retiredResources_.push_back(textureResources_[slot]);
+	retiredResources_.push_back(intermediateResources_[slot]);
+	retiredDescriptorIndices_.push_back(descriptorIndices_[slot]);
+
+	if (textureAllocations_[slot].resource)
+	{
+		retiredTextureAllocations_.push_back(std::move(textureAllocations_[slot]));
+		textureAllocations_[slot] = {};
+	}
+
+	if (intermediateAllocations_[slot].resource)
+	{
+		retiredUploadAllocations_.push_back(intermediateAllocations_[slot]);
+		intermediateAllocations_[slot] = {};
+	}
 }
 
-// 指定したテクスチャを使う
-void TextureManager::SelectTexture(uint32_t textureNumber, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+// テクスチャのリソースと転送用のリソースを、メモリの記録に加える
+void TextureManager::TrackResources(uint32_t slot, const std::string& name)
 {
-	for (uint32_t i = 0; i < kNumTexture_; i++)
+	MemoryTracker::Add(textureResources_[slot].Get(), MemoryCategory::Texture, MemoryHeap::Gpu, name, vramBytes_[slot]);
+
+	// プールから切り分けた転送用のバッファは、同じバッファを使う他の範囲と区別するため、書き込む先で記録する
+	if (intermediateAllocations_[slot].resource)
 	{
-		if (textureNumber != textureNumbers_[i])
-			continue;
+		MemoryTracker::Add(intermediateAllocations_[slot].data, MemoryCategory::Upload, MemoryHeap::Gpu, name, intermediateAllocations_[slot].sizeInBytes);
+		return;
+	}
 
-		if (textureResources_[i] == nullptr)
-			continue;
+	MemoryTracker::AddResource(intermediateResources_[slot].Get(), MemoryCategory::Upload, name);
+}
 
-		commandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorHandle_[i]);
+// テクスチャのリソースと転送用のリソースを、メモリの記録から外す
+void TextureManager::UntrackResources(uint32_t slot)
+{
+	MemoryTracker::Remove(textureResources_[slot].Get());
 
+	if (intermediateAllocations_[slot].resource)
+	{
+		MemoryTracker::Remove(intermediateAllocations_[slot].data);
 		return;
 	}
 
-	assert(false);
+	MemoryTracker::Remove(intermediateResources_[slot].Get());
+}
 
-	return;
-}
\ No newline at end of file
+// SRVを作る（mostDetailedMip より粗いミップだけを参照する）
+void TextureManager::CreateShaderResourceView(uint32_t slot, const DirectX::TexMetadata& metadata, uint32_t mostDetailedMip,
+	Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap)
+{
+	uint32_t i = slot;
+
+	// metaDataを基にSRVを作成する
+	srvDesc_[i] = {};
+	srvDesc_[i].Format = metadata.format;
+	srvDesc_[i].Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc_[i].ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc_[i].Texture2D.MostDetailedMip = mostDetailedMip;
+	srvDesc_[i].Texture2D.MipLevels = UINT(metadata.mipLevels) - mostDetailedMip;
+
+	// 解放されたディスクリプタがあれば使い回し、無ければ新しく使う
+	if (freeDescriptorIndices_.empty() == false)
+	{
+		descriptorIndices_[i] = freeDescriptorIndices_.back();
+		freeDescriptorIndices_.pop_back();
+	}
+	else
+	{
+		descriptorIndices_[i] = 1 + textureCount_;
+
+		// テクスチャの数をカウントする
+		textureCount_++;
+	}
+
+	cpuDescriptorHandle_[i] = GetCPUDescriptorHandle(srvDescriptorHeap, device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV), descriptorIndices_[i]);
+	gpuDescriptorHandle_[i] = GetGPUDescriptorHandle(srvDescriptorHeap, device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV), descriptorIndices_[i]);
+
+	// SRVを生成する
+	device->CreateShaderResourceView(textureResources_[i].Get(), &srvDesc_[i], cpuDescriptorHandle_[i]);
+}
@@ -3,11 +3,17 @@
 #include <time.h>
 #include <wrl.h>
 #include <stdint.h>
+#include <unordered_map>
+#include <algorithm>
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <dxgidebug.h>
 #include "../../Func/Get/Get.h"
 #include "../../Func/Texture/Texture.h"
+#include "../TextureStreamer/TextureStreamer.h"
+#include "../MemoryTracker/MemoryTracker.h"
+#include "../RenderDevice/RenderDevice.h"
+#include "../GpuMemoryAllocator/GpuMemoryAllocator.h"
 
 #pragma comment(lib,"d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -17,21 +23,102 @@ class TextureManager
 {
 public:
 
-	// 初期化
-	void Initialize();
+	// 初期化（memoryAllocatorがあれば、テクスチャをそのヒープに配置する。無ければリソースごとにコミットする）
+	void Initialize(GpuMemoryAllocator* memoryAllocator = nullptr);
 
 	// テクスチャを読み込む
-	uint32_t LoadTextureGetNumber(const std::string& filePath ,Microsoft::WRL::ComPtr<ID3D12Device> device,
+	uint32_t LoadTextureGetNumber(std::ostream& os, const std::string& filePath ,Microsoft::WRL::ComPtr<ID3D12Device> device,
 		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap,Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
 
-	// 指定したテクスチャを使う
-	void SelectTexture(uint32_t textureNumber ,  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+	// テクスチャを読み込む（末尾ミップだけを転送し、細かいミップは後からストリーミングする）
+	uint32_t LoadTextureStreamingGetNumber(std::ostream& os, const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+
+	// CPU上の画像からテクスチャを作る（nameはメモリの記録に使う）
+	uint32_t LoadTextureFromImageGetNumber(const std::string& name, const DirectX::ScratchImage& mipImage, Microsoft::WRL::ComPtr<ID3D12Device> device,
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+
+	// 読み込み済みのテクスチャをファイルから読み込み直し、同じ番号のまま中身を差し替える（読み込んでいなければfalse）
+	// 中身が同じで別のパスと共有していたら、そのパスは元の中身のまま残し、このパスだけを新しい番号に分ける（次に読み込んだときから使われる）
+	bool ReloadTexture(std::ostream& os, const std::string& filePath, Microsoft::WRL::ComPtr<ID3D12Device> device,
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+
+	// 指定したテクスチャの参照を1つ減らす（誰も使わなくなったら、GPUが使い終わってから解放する）
+	void ReleaseTexture(uint32_t textureNumber);
+
+	// 前のフレームで解放したリソースとディスクリプタを、使えるようにする（GPUの完了を待ってから呼ぶ）
+	void CollectRetiredResources();
+
+	// 指定したテクスチャのディスクリプタを取得する（描画のコマンドに設定する）
+	RenderHandle GetDescriptorHandle(uint32_t textureNumber);
+
+	// 指定したテクスチャを画面上で表示する大きさ（ピクセル）を要求する
+	void RequestScreenSize(uint32_t textureNumber, float screenPixels, double currentTime);
+
+	// ストリーミング中のミップを、予算の範囲内で転送する
+	void UpdateStreaming(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, double currentTime);
+
+	// Getter
+	const TextureCookSettings& GetCookSettings() { return cookSettings_; }
+	uint64_t GetSavedVramBytes() const { return savedVramBytes_; }
+	uint64_t GetSavedRamBytes() const { return savedRamBytes_; }
+
+	// Setter
+	void SetCookSettings(const TextureCookSettings& cookSettings) { cookSettings_ = cookSettings; }
 
 private:
 
+	// ベンチマークから、GPUで読み込まずに格納場所を埋めて、番号の検索を計測する
+	friend class HandleLookupBenchmark;
+
+	// テクスチャ番号から格納場所を探す
+	int32_t FindSlot(uint32_t textureNumber);
+
+	// 使用していない格納場所を探し、テクスチャ番号を割り当てる
+	int32_t AllocateSlot();
+
+	// 同じパス、または同じ中身のテクスチャを読み込み済みなら、参照を増やしてその格納場所を返す（無ければ-1）
+	int32_t FindLoadedTexture(std::ostream& os, const std::string& filePath, std::vector<uint8_t>& sourceBytes, uint64_t& contentHash);
+
+	// 共有していた格納場所から、読み込み直したパスだけを新しい格納場所に分ける
+	bool SplitReloadedTexture(std::ostream& os, const std::string& filePath, const std::string& pathKey, const std::vector<uint8_t>& sourceBytes,
+		uint64_t contentHash, Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap,
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+
+	// 読み込んだテクスチャを、パスと中身の索引に登録する
+	void RegisterContent(int32_t slot, const std::string& filePath, uint64_t contentHash);
+
+	// 共有したテクスチャの参照を増やし、節約できた大きさをログに書き出す
+	void AddReference(std::ostream& os, uint32_t slot, const std::string& filePath, const char* matchedBy);
+
+	// パスの索引のキー（同じファイルを指す書き方の違いと、クックの設定の違いを区別する）
+	std::string GetPathKey(const std::string& filePath);
+
+	// テクスチャのリソースを作る
+	void CreateSlotResource(uint32_t slot, const DirectX::TexMetadata& metadata, Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// 転送用のバッファを用意する（memoryAllocatorがあれば書き込めるバッファのプールから切り分け、無ければリソースごとにコミットする）
+	void CreateIntermediateBuffer(uint32_t slot, uint32_t firstMip, uint32_t numMips, Microsoft::WRL::ComPtr<ID3D12Device> device);
+
+	// テクスチャのリソースと転送用のリソースとディスクリプタを、GPUが使い終わるまで残す
+	void RetireSlotResources(uint32_t slot);
+
+	// テクスチャのリソースと転送用のリソースを、メモリの記録に加える
+	void TrackResources(uint32_t slot, const std::string& name);
+
+	// テクスチャのリソースと転送用のリソースを、メモリの記録から外す
+	void UntrackResources(uint32_t slot);
+
+	// SRVを作る（mostDetailedMip より粗いミップだけを参照する）
+	void CreateShaderResourceView(uint32_t slot, const DirectX::TexMetadata& metadata, uint32_t mostDetailedMip,
+		Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> srvDescriptorHeap);
+
 	// 乱数
 	unsigned int currentTimer_ = static_cast<unsigned int>(time(nullptr));
 
+	// クックの設定
+	TextureCookSettings cookSettings_ = { DXGI_FORMAT_UNKNOWN, false };
+
 	// 格納できるテクスチャの数
 	const uint32_t kNumTexture_ = 256;
 
@@ -44,13 +131,75 @@ private:
 	// テクスチャリソースを格納する
 	Microsoft::WRL::ComPtr<ID3D12Resource> textureResources_[256] = { nullptr };
 
-	// リソースに転送するデータ
+	// テクスチャを配置するヒープ（無ければ、リソースごとにコミットする）と、配置した場所
+	GpuMemoryAllocator* memoryAllocator_ = nullptr;
+	GpuTextureAllocation textureAllocations_[256] = {};
+
+	// リソースに転送するデータと、プールから切り分けた範囲（コミットしたリソースなら空）
 	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResources_[256] = { nullptr };
+	GpuBufferAllocation intermediateAllocations_[256] = {};
 
 	// SRVの設定
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc_[256] = {};
 
 	D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptorHandle_[256] = {};
 	D3D12_GPU_DESCRIPTOR_HANDLE gpuDescriptorHandle_[256] = {};
+
+	// SRVのディスクリプタの位置
+	uint32_t descriptorIndices_[256] = { 0 };
+
+	// 解放されて使い回せるディスクリプタの位置
+	std::vector<uint32_t> freeDescriptorIndices_;
+
+
+	/*   共有   */
+
+	// 参照の数
+	uint32_t refCounts_[256] = { 0 };
+
+	// 中身のハッシュ値
+	uint64_t contentHashes_[256] = { 0 };
+
+	// VRAMとRAMで使っているバイト数
+	uint64_t vramBytes_[256] = { 0 };
+	uint64_t ramBytes_[256] = { 0 };
+
+	// パスから格納場所を引く索引
+	std::unordered_map<std::string, uint32_t> pathSlots_;
+
+	// 中身のハッシュ値から格納場所を引く索引
+	std::unordered_map<uint64_t, uint32_t> contentSlots_;
+
+	// 共有して節約できたバイト数
+	uint64_t savedVramBytes_ = 0;
+	uint64_t savedRamBytes_ = 0;
+
+	// 解放を待っているリソースとディスクリプタ（GPUの完了後に解放する）
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retiredResources_;
+	std::vector<uint32_t> retiredDescriptorIndices_;
+	std::vector<GpuTextureAllocation> retiredTextureAllocations_;
+	std::vector<GpuBufferAllocation> retiredUploadAllocations_;
+
+
+	/*   ストリーミング   */
+
+	// 最初に転送する末尾ミップの大きさ
+	const uint32_t kStreamingTailSize_ = 64;
+
+	// 1フレームに転送できるバイト数
+	const uint64_t kStreamingBytesPerFrame_ = 1024 * 1024;
+
+	// 大きさの要求が有効な時間（秒）
+	const double kStreamingRequestLifetime_ = 1.0;
+
+	// ストリーミングのスケジューラ
+	TextureStreamer streamer_;
+
+	// 転送を待っているミップ付きのデータ
+	DirectX::ScratchImage streamingImages_[256];
+
+	// ストリーミングの転送に使ったリソースと、プールから切り分けた範囲（GPUの完了後に解放する）
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> streamingIntermediateResources_;
+	std::vector<GpuBufferAllocation> streamingUploadAllocations_;
 };
 
@@ -0,0 +1,199 @@
+#include "TextureStreamer.h"
+
+// 初期化
+void TextureStreamer::Initialize(uint64_t bytesPerFrame, double requestLifetime)
+{
+	bytesPerFrame_ = bytesPerFrame;
+	requestLifetime_ = requestLifetime;
+	streamedBytes_ = 0;
+	textures_.clear();
+}
+
+// テクスチャを登録する
+void TextureStreamer::Register(uint32_t slot, uint32_t width, uint32_t height, const std::vector<uint64_t>& mipByteSizes, uint32_t residentMip)
+{
+	if (slot >= textures_.size())
+	{
+		textures_.resize(slot + 1);
+	}
+
+	StreamingTexture& texture = textures_[slot];
+	texture.isRegistered = true;
+	texture.width = width;
+	texture.height = height;
+	texture.mipByteSizes = mipByteSizes;
+	texture.residentMip = residentMip;
+
+	// 要求があるまでは、転送済みのミップで十分とする
+	texture.desiredMip = residentMip;
+	texture.lastRequestTime = 0.0;
+}
+
+// テクスチャの登録を解除する
+void TextureStreamer::Unregister(uint32_t slot)
+{
+	if (slot >= textures_.size())
+		return;
+
+	textures_[slot] = StreamingTexture{};
+}
+
+// 画面上で表示したい大きさを要求する
+void TextureStreamer::RequestScreenSize(uint32_t slot, float screenPixels, double currentTime)
+{
+	if (IsRegistered(slot) == false)
+		return;
+
+	StreamingTexture& texture = textures_[slot];
+	uint32_t mipLevel = SelectMipLevel(texture.width, texture.height, uint32_t(texture.mipByteSizes.size()), screenPixels);
+
+	// 有効な要求が残っているときは、細かい方を優先する
+	if (currentTime - texture.lastRequestTime <= requestLifetime_)
+	{
+		texture.desiredMip = (std::min)(texture.desiredMip, mipLevel);
+	}
+	else
+	{
+		texture.desiredMip = mipLevel;
+	}
+
+	texture.lastRequestTime = currentTime;
+}
+
+// 1フレーム分の転送予定を決める
+std::vector<StreamingRequest> TextureStreamer::Update(double currentTime)
+{
+	std::vector<StreamingRequest> requests;
+
+	// 期限の切れた要求は、これ以上細かいミップを転送しない
+	for (StreamingTexture& texture : textures_)
+	{
+		if (texture.isRegistered == false)
+			continue;
+
+		if (currentTime - texture.lastRequestTime > requestLifetime_)
+		{
+			texture.desiredMip = texture.residentMip;
+		}
+	}
+
+	// 予算が残っている間、優先度が最も高いミップから転送する
+	uint64_t remainingBytes = bytesPerFrame_;
+
+	while (true)
+	{
+		int32_t bestSlot = -1;
+		uint32_t bestGap = 0;
+		uint64_t bestSize = 0;
+
+		for (uint32_t i = 0; i < textures_.size(); ++i)
+		{
+			const StreamingTexture& texture = textures_[i];
+
+			if (texture.isRegistered == false)
+				continue;
+
+			if (texture.residentMip <= texture.desiredMip)
+				continue;
+
+			// ミップは細かい方へ1段ずつしか増やせない
+			uint64_t size = texture.mipByteSizes[texture.residentMip - 1];
+
+			// 予算を超えるものは、このフレームで何も転送していないときだけ許す
+			if (size > remainingBytes && requests.empty() == false)
+				continue;
+
+			// 不足しているミップの段数が多いものを優先し、同じなら小さいものを優先する
+			uint32_t gap = texture.residentMip - texture.desiredMip;
+			if (bestSlot < 0 || gap > bestGap || (gap == bestGap && size < bestSize))
+			{
+				bestSlot = int32_t(i);
+				bestGap = gap;
+				bestSize = size;
+			}
+		}
+
+		if (bestSlot < 0)
+			break;
+
+		StreamingTexture& texture = textures_[bestSlot];
+		texture.residentMip--;
+
+		requests.push_back({ uint32_t(bestSlot), texture.residentMip, bestSize });
+
+		streamedBytes_ += bestSize;
+		remainingBytes -= (std::min)(bestSize, remainingBytes);
+
+		if (remainingBytes == 0)
+			break;
+	}
+
+	return requests;
+}
+
+// 画面上の大きさから必要なミップレベルを求める
+uint32_t TextureStreamer::SelectMipLevel(uint32_t width, uint32_t height, uint32_t mipLevels, float screenPixels)
+{
+	if (mipLevels == 0)
+		return 0;
+
+	float textureSize = static_cast<float>((std::max)(width, height));
+
+	// 表示する大きさがテクスチャ以上なら最も細かいミップが必要
+	if (screenPixels >= textureSize)
+		return 0;
+
+	// 画面上で小さすぎるものは、最も粗いミップで十分
+	if (screenPixels <= 1.0f)
+		return mipLevels - 1;
+
+	// 1テクセルが1ピクセル以上になる最も粗いミップ
+	uint32_t mipLevel = static_cast<uint32_t>(std::floor(std::log2(textureSize / screenPixels)));
+
+	return (std::min)(mipLevel, mipLevels - 1);
+}
+
+// 最初に転送する末尾ミップを求める
+uint32_t TextureStreamer::SelectTailMip(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t tailSize)
+{
+	for (uint32_t mipLevel = 0; mipLevel < mipLevels; ++mipLevel)
+	{
+		uint32_t mipWidth = (std::max)(width >> mipLevel, 1u);
+		uint32_t mipHeight = (std::max)(height >> mipLevel, 1u);
+
+		if (mipWidth <= tailSize && mipHeight <= tailSize)
+			return mipLevel;
+	}
+
+	return mipLevels - 1;
+}
+
+// 転送済みの最も細かいミップを取得する
+uint32_t TextureStreamer::GetResidentMip(uint32_t slot) const
+{
+	if (IsRegistered(slot) == false)
+		return 0;
+
+	return textures_[slot].residentMip;
+}
+
+// 要求されている最も細かいミップを取得する
+uint32_t TextureStreamer::GetDesiredMip(uint32_t slot) const
+{
+	if (IsRegistered(slot) == false)
+		return 0;
+
+	return textures_[slot].desiredMip;
+}
+
+// 登録されているかどうか
+bool TextureStreamer::IsRegistered(uint32_t slot) const
+{
+	return slot < textures_.size() && textures_[slot].isRegistered;
+}
+
+// 全てのミップが転送済みかどうか
+bool TextureStreamer::IsFullyResident(uint32_t slot) const
+{
+	return IsRegistered(slot) && textures_[slot].residentMip == 0;
+}
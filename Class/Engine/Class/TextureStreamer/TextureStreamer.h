@@ -0,0 +1,93 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// ストリーミングで転送するミップ
+typedef struct StreamingRequest
+{
+	// テクスチャの格納場所
+	uint32_t slot;
+
+	// 転送するミップレベル
+	uint32_t mipLevel;
+
+	// 転送するバイト数
+	uint64_t byteSize;
+}StreamingRequest;
+
+class TextureStreamer
+{
+public:
+
+	// 初期化
+	void Initialize(uint64_t bytesPerFrame, double requestLifetime);
+
+	// テクスチャを登録する（residentMip より粗いミップは転送済み）
+	void Register(uint32_t slot, uint32_t width, uint32_t height, const std::vector<uint64_t>& mipByteSizes, uint32_t residentMip);
+
+	// テクスチャの登録を解除する
+	void Unregister(uint32_t slot);
+
+	// 画面上で表示したい大きさ（ピクセル）を要求する
+	void RequestScreenSize(uint32_t slot, float screenPixels, double currentTime);
+
+	// 1フレーム分の転送予定を決める
+	std::vector<StreamingRequest> Update(double currentTime);
+
+	// 画面上の大きさから必要なミップレベルを求める
+	static uint32_t SelectMipLevel(uint32_t width, uint32_t height, uint32_t mipLevels, float screenPixels);
+
+	// 最初に転送する末尾ミップを求める
+	static uint32_t SelectTailMip(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t tailSize);
+
+	// Getter
+	uint32_t GetResidentMip(uint32_t slot) const;
+	uint32_t GetDesiredMip(uint32_t slot) const;
+	bool IsRegistered(uint32_t slot) const;
+	bool IsFullyResident(uint32_t slot) const;
+	uint64_t GetBytesPerFrame() const { return bytesPerFrame_; }
+	uint64_t GetStreamedBytes() const { return streamedBytes_; }
+
+	// Setter
+	void SetBytesPerFrame(uint64_t bytesPerFrame) { bytesPerFrame_ = bytesPerFrame; }
+
+
+private:
+
+	// ストリーミング中のテクスチャ
+	typedef struct StreamingTexture
+	{
+		// 登録されているかどうか
+		bool isRegistered;
+
+		// 大きさ
+		uint32_t width;
+		uint32_t height;
+
+		// ミップごとのバイト数
+		std::vector<uint64_t> mipByteSizes;
+
+		// 転送済みの最も細かいミップ
+		uint32_t residentMip;
+
+		// 要求されている最も細かいミップ
+		uint32_t desiredMip;
+
+		// 最後に要求された時刻
+		double lastRequestTime;
+	}StreamingTexture;
+
+	// 1フレームに転送できるバイト数
+	uint64_t bytesPerFrame_ = 0;
+
+	// 要求が有効な時間（秒）
+	double requestLifetime_ = 0.0;
+
+	// これまでに転送したバイト数
+	uint64_t streamedBytes_ = 0;
+
+	// テクスチャ
+	std::vector<StreamingTexture> textures_;
+};
@@ -0,0 +1,379 @@
+#include "TlsfAllocator.h"
+
+// コンストラクタ
+TlsfAllocator::TlsfAllocator(uint64_t capacity)
+	: capacity_(capacity / kGranularity * kGranularity)
+{
+	for (uint32_t firstLevel = 0; firstLevel < kNumFirstLevels; ++firstLevel)
+	{
+		for (uint32_t secondLevel = 0; secondLevel < kNumSecondLevels; ++secondLevel)
+		{
+			freeLists_[firstLevel][secondLevel] = kNullBlock;
+		}
+	}
+
+	// 全体を1つの空きブロックにする
+	uint32_t block = CreateBlock(0, capacity_, kNullBlock, kNullBlock);
+	if (capacity_ > 0)
+	{
+		InsertFreeBlock(block);
+	}
+	else
+	{
+		blocks_[block].isFree = false;
+	}
+}
+
+// 確保する
+uint32_t TlsfAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment, uint64_t& offset)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	uint64_t size = ((sizeInBytes == 0 ? 1 : sizeInBytes) + kGranularity - 1) / kGranularity * kGranularity;
+	uint64_t blockAlignment = alignment < kGranularity ? kGranularity : alignment;
+
+	// 揃えるためにずらしても入る大きさで探す
+	uint32_t block = FindFreeBlock(size + blockAlignment - kGranularity);
+	if (block == kNullBlock)
+		return kInvalidBlock;
+
+	RemoveFreeBlock(block);
+
+	// 揃えるためにずらした前の部分は、空きブロックとして残す
+	uint64_t alignedOffset = (blocks_[block].offset + blockAlignment - 1) & ~(blockAlignment - 1);
+	uint64_t gap = alignedOffset - blocks_[block].offset;
+	if (gap > 0)
+	{
+		uint32_t front = block;
+		SplitBlock(front, gap);
+		block = blocks_[front].nextPhysical;
+		InsertFreeBlock(front);
+	}
+
+	// 余った後ろの部分も、空きブロックとして残す
+	if (blocks_[block].size > size)
+	{
+		SplitBlock(block, size);
+		InsertFreeBlock(blocks_[block].nextPhysical);
+	}
+
+	blocks_[block].isFree = false;
+	usedBytes_ += blocks_[block].size;
+	numAllocations_++;
+
+	offset = blocks_[block].offset;
+	return block;
+}
+
+// 解放する
+void TlsfAllocator::Free(uint32_t block)
+{
+	assert(block < blocks_.size() && blocks_[block].isFree == false);
+
+	usedBytes_ -= blocks_[block].size;
+	numAllocations_--;
+	blocks_[block].isFree = true;
+
+	// 前後の空きブロックとつなげる
+	uint32_t prev = blocks_[block].prevPhysical;
+	if (prev != kNullBlock && blocks_[prev].isFree)
+	{
+		RemoveFreeBlock(prev);
+		MergeBlock(prev, block);
+		block = prev;
+	}
+
+	uint32_t next = blocks_[block].nextPhysical;
+	if (next != kNullBlock && blocks_[next].isFree)
+	{
+		RemoveFreeBlock(next);
+		MergeBlock(block, next);
+	}
+
+	InsertFreeBlock(block);
+}
+
+// 確保と解放の状況を求める
+TlsfStats TlsfAllocator::GetStats() const
+{
+	TlsfStats stats{};
+	stats.capacity = capacity_;
+	stats.usedBytes = usedBytes_;
+	stats.numAllocations = numAllocations_;
+
+	for (uint32_t firstLevel = 0; firstLevel < kNumFirstLevels; ++firstLevel)
+	{
+		for (uint32_t secondLevel = 0; secondLevel < kNumSecondLevels; ++secondLevel)
+		{
+			for (uint32_t block = freeLists_[firstLevel][secondLevel]; block != kNullBlock; block = blocks_[block].nextFree)
+			{
+				stats.numFreeBlocks++;
+				stats.largestFreeBlock = blocks_[block].size > stats.largestFreeBlock ? blocks_[block].size : stats.largestFreeBlock;
+			}
+		}
+	}
+
+	return stats;
+}
+
+// 内部の状態が正しいかを確かめる
+bool TlsfAllocator::Validate() const
+{
+	/*-------------------------------
+	    位置の順にブロックをたどる
+	-------------------------------*/
+
+	uint64_t expectedOffset = 0;
+	uint64_t usedBytes = 0;
+	uint32_t numAllocations = 0;
+	uint32_t numFreeBlocks = 0;
+
+	uint32_t prev = kNullBlock;
+	for (uint32_t block = 0; block != kNullBlock; block = blocks_[block].nextPhysical)
+	{
+		const Block& current = blocks_[block];
+
+		// 隙間なく並んでいる
+		if (current.offset != expectedOffset || current.prevPhysical != prev)
+			return false;
+
+		// 空きブロックが隣り合っていない
+		if (current.isFree && prev != kNullBlock && blocks_[prev].isFree)
+			return false;
+
+		if (current.isFree)
+		{
+			numFreeBlocks++;
+		}
+		else if (current.size > 0)
+		{
+			usedBytes += current.size;
+			numAllocations++;
+		}
+
+		expectedOffset += current.size;
+		prev = block;
+	}
+
+	if (expectedOffset != capacity_ || usedBytes != usedBytes_ || numAllocations != numAllocations_)
+		return false;
+
+
+	/*-------------------------------
+	    サイズクラスごとのリストをたどる
+	-------------------------------*/
+
+	uint32_t numListedBlocks = 0;
+
+	for (uint32_t firstLevel = 0; firstLevel < kNumFirstLevels; ++firstLevel)
+	{
+		for (uint32_t secondLevel = 0; secondLevel < kNumSecondLevels; ++secondLevel)
+		{
+			uint32_t head = freeLists_[firstLevel][secondLevel];
+
+			// 空きリストがあるサイズクラスだけ、ビットが立っている
+			bool hasBit = (secondLevelBitmaps_[firstLevel] & (1u << secondLevel)) != 0;
+			if (hasBit != (head != kNullBlock))
+				return false;
+
+			uint32_t prevFree = kNullBlock;
+			for (uint32_t block = head; block != kNullBlock; block = blocks_[block].nextFree)
+			{
+				uint32_t blockFirstLevel = 0;
+				uint32_t blockSecondLevel = 0;
+				Mapping(blocks_[block].size, blockFirstLevel, blockSecondLevel);
+
+				if (blocks_[block].isFree == false || blocks_[block].prevFree != prevFree ||
+					blockFirstLevel != firstLevel || blockSecondLevel != secondLevel)
+					return false;
+
+				numListedBlocks++;
+				prevFree = block;
+			}
+		}
+
+		bool hasFirstLevelBit = (firstLevelBitmap_ & (uint64_t(1) << firstLevel)) != 0;
+		if (hasFirstLevelBit != (secondLevelBitmaps_[firstLevel] != 0))
+			return false;
+	}
+
+	return numListedBlocks == numFreeBlocks;
+}
+
+// 空のときに、必ず確保できる管理する大きさを求める
+uint64_t TlsfAllocator::GetRequiredCapacity(uint64_t sizeInBytes, uint64_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	// Allocateと同じ大きさで探すので、全体の1つの空きブロックが、切り上げたサイズクラス以上にあればよい
+	uint64_t size = ((sizeInBytes == 0 ? 1 : sizeInBytes) + kGranularity - 1) / kGranularity * kGranularity;
+	uint64_t blockAlignment = alignment < kGranularity ? kGranularity : alignment;
+
+	return RoundUpSizeClass(size + blockAlignment - kGranularity);
+}
+
+// 大きさからサイズクラスを求める
+void TlsfAllocator::Mapping(uint64_t sizeInBytes, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	uint64_t units = sizeInBytes / kGranularity;
+
+	// 小さいものは、単位ごとに1つのサイズクラスにする
+	if (units < kNumSecondLevels)
+	{
+		firstLevel = 0;
+		secondLevel = uint32_t(units);
+		return;
+	}
+
+	uint32_t mostSignificantBit = 63 - uint32_t(std::countl_zero(units));
+	firstLevel = mostSignificantBit - kSecondLevelLog2 + 1;
+	secondLevel = uint32_t(units >> (mostSignificantBit - kSecondLevelLog2)) & (kNumSecondLevels - 1);
+}
+
+// 次のサイズクラスの始めに切り上げる
+uint64_t TlsfAllocator::RoundUpSizeClass(uint64_t sizeInBytes)
+{
+	uint64_t units = (sizeInBytes + kGranularity - 1) / kGranularity;
+
+	// 小さいものは、単位ごとのサイズクラスなので切り上げない
+	if (units >= kNumSecondLevels)
+	{
+		uint32_t mostSignificantBit = 63 - uint32_t(std::countl_zero(units));
+		uint64_t step = uint64_t(1) << (mostSignificantBit - kSecondLevelLog2);
+		units = (units + step - 1) & ~(step - 1);
+	}
+
+	return units * kGranularity;
+}
+
+// 大きさ以上のブロックだけが入っている、一番小さいサイズクラスの空きブロックを探す
+uint32_t TlsfAllocator::FindFreeBlock(uint64_t sizeInBytes) const
+{
+	// サイズクラスの中で一番小さいものでも足りるように、次のサイズクラスに切り上げる
+	uint32_t firstLevel = 0;
+	uint32_t secondLevel = 0;
+	Mapping(RoundUpSizeClass(sizeInBytes), firstLevel, secondLevel);
+	if (firstLevel >= kNumFirstLevels)
+		return kNullBlock;
+
+	// 同じ1段目で、それ以上の2段目
+	uint32_t secondLevelMap = secondLevelBitmaps_[firstLevel] & (~0u << secondLevel);
+	if (secondLevelMap == 0)
+	{
+		// それより上の1段目
+		uint64_t firstLevelMap = firstLevel + 1 < kNumFirstLevels ? firstLevelBitmap_ & (~uint64_t(0) << (firstLevel + 1)) : 0;
+		if (firstLevelMap == 0)
+			return kNullBlock;
+
+		firstLevel = uint32_t(std::countr_zero(firstLevelMap));
+		secondLevelMap = secondLevelBitmaps_[firstLevel];
+	}
+
+	secondLevel = uint32_t(std::countr_zero(secondLevelMap));
+	return freeLists_[firstLevel][secondLevel];
+}
+
+// 空きリストに入れる
+void TlsfAllocator::InsertFreeBlock(uint32_t block)
+{
+	uint32_t firstLevel = 0;
+	uint32_t secondLevel = 0;
+	Mapping(blocks_[block].size, firstLevel, secondLevel);
+
+	uint32_t head = freeLists_[firstLevel][secondLevel];
+	blocks_[block].isFree = true;
+	blocks_[block].prevFree = kNullBlock;
+	blocks_[block].nextFree = head;
+	if (head != kNullBlock)
+	{
+		blocks_[head].prevFree = block;
+	}
+
+	freeLists_[firstLevel][secondLevel] = block;
+	firstLevelBitmap_ |= uint64_t(1) << firstLevel;
+	secondLevelBitmaps_[firstLevel] |= 1u << secondLevel;
+}
+
+// 空きリストから外す
+void TlsfAllocator::RemoveFreeBlock(uint32_t block)
+{
+	uint32_t firstLevel = 0;
+	uint32_t secondLevel = 0;
+	Mapping(blocks_[block].size, firstLevel, secondLevel);
+
+	uint32_t prevFree = blocks_[block].prevFree;
+	uint32_t nextFree = blocks_[block].nextFree;
+	if (prevFree != kNullBlock)
+	{
+		blocks_[prevFree].nextFree = nextFree;
+	}
+	else
+	{
+		freeLists_[firstLevel][secondLevel] = nextFree;
+	}
+
+	if (nextFree != kNullBlock)
+	{
+		blocks_[nextFree].prevFree = prevFree;
+	}
+
+	// リストが空になったら、ビットを下ろす
+	if (freeLists_[firstLevel][secondLevel] == kNullBlock)
+	{
+		secondLevelBitmaps_[firstLevel] &= ~(1u << secondLevel);
+		if (secondLevelBitmaps_[firstLevel] == 0)
+		{
+			firstLevelBitmap_ &= ~(uint64_t(1) << firstLevel);
+		}
+	}
+
+	blocks_[block].prevFree = kNullBlock;
+	blocks_[block].nextFree = kNullBlock;
+}
+
+// ブロックを作る
+uint32_t TlsfAllocator::CreateBlock(uint64_t offset, uint64_t size, uint32_t prevPhysical, uint32_t nextPhysical)
+{
+	Block newBlock{ offset, size, prevPhysical, nextPhysical, kNullBlock, kNullBlock, true };
+
+	if (unusedBlocks_.empty() == false)
+	{
+		uint32_t block = unusedBlocks_.back();
+		unusedBlocks_.pop_back();
+		blocks_[block] = newBlock;
+		return block;
+	}
+
+	blocks_.push_back(newBlock);
+	return uint32_t(blocks_.size() - 1);
+}
+
+// ブロックの後ろを切り分けて、新しい空きブロックにする
+void TlsfAllocator::SplitBlock(uint32_t block, uint64_t size)
+{
+	assert(size < blocks_[block].size);
+
+	uint32_t next = CreateBlock(blocks_[block].offset + size, blocks_[block].size - size, block, blocks_[block].nextPhysical);
+	if (blocks_[next].nextPhysical != kNullBlock)
+	{
+		blocks_[blocks_[next].nextPhysical].prevPhysical = next;
+	}
+
+	blocks_[block].size = size;
+	blocks_[block].nextPhysical = next;
+}
+
+// 後ろのブロックを、前のブロックにつなげる
+void TlsfAllocator::MergeBlock(uint32_t block, uint32_t nextBlock)
+{
+	assert(blocks_[block].nextPhysical == nextBlock);
+
+	blocks_[block].size += blocks_[nextBlock].size;
+	blocks_[block].nextPhysical = blocks_[nextBlock].nextPhysical;
+	if (blocks_[block].nextPhysical != kNullBlock)
+	{
+		blocks_[blocks_[block].nextPhysical].prevPhysical = block;
+	}
+
+	unusedBlocks_.push_back(nextBlock);
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+#include <bit>
+
+// 確保と解放の状況（断片化の度合いは、空きの合計と一番大きい空きから求める）
+typedef struct TlsfStats
+{
+	// 管理する大きさと、使っている大きさ
+	uint64_t capacity;
+	uint64_t usedBytes;
+
+	// 確保している数と、空いているブロックの数
+	uint32_t numAllocations;
+	uint32_t numFreeBlocks;
+
+	// 一番大きい空きブロック（これより大きいものは、空きの合計が足りていても確保できない）
+	uint64_t largestFreeBlock;
+}TlsfStats;
+
+/// <summary>
+/// 断片化の度合いを求める（0なら空きが1つにまとまっていて、1に近いほど細かく分かれている）
+/// </summary>
+/// <param name="stats">確保と解放の状況</param>
+/// <returns>断片化の度合い</returns>
+inline double GetFragmentation(const TlsfStats& stats)
+{
+	uint64_t freeBytes = stats.capacity - stats.usedBytes;
+	if (freeBytes == 0)
+		return 0.0;
+
+	return 1.0 - double(stats.largestFreeBlock) / double(freeBytes);
+}
+
+// 決まった大きさの範囲を、TLSF（2段階のサイズクラスと空きリスト）で切り分ける
+// メモリには触れず位置だけを扱うので、GPUのヒープやバッファの中の位置の管理に使える
+class TlsfAllocator
+{
+public:
+
+	// 確保できなかったときのブロック
+	static const uint32_t kInvalidBlock = 0xffffffff;
+
+	// 位置と大きさの単位（全ての確保はこの倍数に揃える）
+	static const uint64_t kGranularity = 256;
+
+	// コンストラクタ（capacityは kGranularity の倍数に切り捨てる）
+	explicit TlsfAllocator(uint64_t capacity);
+
+	// 確保する（alignmentは2のべき乗。確保できなければ kInvalidBlock を返す）
+	uint32_t Allocate(uint64_t sizeInBytes, uint64_t alignment, uint64_t& offset);
+
+	// 解放する（前後の空きブロックとつなげる）
+	void Free(uint32_t block);
+
+	// 確保と解放の状況を求める
+	TlsfStats GetStats() const;
+
+	// 内部の状態が正しいかを確かめる（ブロックが隙間なく並び、空きブロックが正しいリストにあり、隣り合う空きが無い）
+	bool Validate() const;
+
+	// 空のときに、必ず確保できる管理する大きさを求める（探すときにサイズクラスを切り上げる分を含める）
+	static uint64_t GetRequiredCapacity(uint64_t sizeInBytes, uint64_t alignment);
+
+	// Getter
+	uint64_t GetCapacity() const { return capacity_; }
+	uint64_t GetUsedBytes() const { return usedBytes_; }
+	uint32_t GetNumAllocations() const { return numAllocations_; }
+	bool IsEmpty() const { return numAllocations_ == 0; }
+	uint64_t GetBlockOffset(uint32_t block) const { return blocks_[block].offset; }
+	uint64_t GetBlockSize(uint32_t block) const { return blocks_[block].size; }
+
+
+private:
+
+	// 2段目のサイズクラスの数（1段目の2のべき乗の範囲を、さらに16に分ける）
+	static const uint32_t kSecondLevelLog2 = 4;
+	static const uint32_t kNumSecondLevels = 1 << kSecondLevelLog2;
+
+	// 1段目のサイズクラスの数
+	static const uint32_t kNumFirstLevels = 64;
+
+	// リストの終わり
+	static const uint32_t kNullBlock = 0xffffffff;
+
+	// ブロック（位置の順につながり、空いていればサイズクラスごとのリストにもつながる）
+	typedef struct Block
+	{
+		uint64_t offset;
+		uint64_t size;
+
+		// 位置の順で前後のブロック
+		uint32_t prevPhysical;
+		uint32_t nextPhysical;
+
+		// 同じサイズクラスの空きリストで前後のブロック
+		uint32_t prevFree;
+		uint32_t nextFree;
+
+		bool isFree;
+	}Block;
+
+	// 大きさからサイズクラスを求める（切り捨て。空きブロックを入れるリスト）
+	static void Mapping(uint64_t sizeInBytes, uint32_t& firstLevel, uint32_t& secondLevel);
+
+	// 次のサイズクラスの始めに切り上げる（そのサイズクラスの空きブロックは、どれもこの大きさ以上）
+	static uint64_t RoundUpSizeClass(uint64_t sizeInBytes);
+
+	// 大きさ以上のブロックだけが入っている、一番小さいサイズクラスの空きブロックを探す
+	uint32_t FindFreeBlock(uint64_t sizeInBytes) const;
+
+	// 空きリストに入れる
+	void InsertFreeBlock(uint32_t block);
+
+	// 空きリストから外す
+	void RemoveFreeBlock(uint32_t block);
+
+	// ブロックを作る（使っていないものがあれば使い回す）
+	uint32_t CreateBlock(uint64_t offset, uint64_t size, uint32_t prevPhysical, uint32_t nextPhysical);
+
+	// ブロックの後ろを切り分けて、新しい空きブロックにする
+	void SplitBlock(uint32_t block, uint64_t size);
+
+	// 後ろのブロックを、前のブロックにつなげる（後ろのブロックは使わなくなる）
+	void MergeBlock(uint32_t block, uint32_t nextBlock);
+
+
+	// 管理する大きさ
+	uint64_t capacity_ = 0;
+
+	// ブロック（位置の順の先頭は、常に0番）と、使っていないブロックの番号
+	std::vector<Block> blocks_;
+	std::vector<uint32_t> unusedBlocks_;
+
+	// 空きリストがあるサイズクラスのビット（1段目と、1段目ごとの2段目）
+	uint64_t firstLevelBitmap_ = 0;
+	uint32_t secondLevelBitmaps_[kNumFirstLevels] = {};
+
+	// サイズクラスごとの空きリストの先頭
+	uint32_t freeLists_[kNumFirstLevels][kNumSecondLevels];
+
+	// 使っている大きさと、確保している数
+	uint64_t usedBytes_ = 0;
+	uint32_t numAllocations_ = 0;
+};
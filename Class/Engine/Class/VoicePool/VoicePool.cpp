@@ -0,0 +1,193 @@
+#include "VoicePool.h"
+
+// コンストラクタ
+VoicePool::VoicePool(uint32_t maxVoices)
+{
+	assert(maxVoices > 0);
+
+	maxVoices_ = maxVoices;
+	voices_.reserve(maxVoices_);
+}
+
+// 鳴らすボイスを選ぶ
+VoiceRequest VoicePool::Acquire(const VoiceFormat& format, uint32_t soundId, int32_t priority, uint32_t maxInstances)
+{
+	++stats_.numPlays;
+
+	/*-----------------------------------------
+	    同じ音が上限まで鳴っていれば、最も古いものを止める
+	-----------------------------------------*/
+
+	if (maxInstances > 0 && CountInstances(soundId) >= maxInstances)
+	{
+		uint32_t oldest = kInvalidVoice;
+		for (uint32_t i = 0; i < voices_.size(); ++i)
+		{
+			if (voices_[i].isPlaying == false || voices_[i].soundId != soundId)
+				continue;
+
+			if (oldest == kInvalidVoice || voices_[i].order < voices_[oldest].order)
+			{
+				oldest = i;
+			}
+		}
+
+		++stats_.numStolenByInstanceLimit;
+		return Assign(oldest, format, soundId, priority, true, false);
+	}
+
+
+	/*------------------------------
+	    上限より少なければ、空きを使う
+	------------------------------*/
+
+	if (stats_.numActive < maxVoices_)
+	{
+		// 同じ波形フォーマットで空いているものを、そのまま使い回す
+		for (uint32_t i = 0; i < voices_.size(); ++i)
+		{
+			if (voices_[i].isPlaying == false && voices_[i].format == format)
+			{
+				++stats_.numReused;
+				return Assign(i, format, soundId, priority, false, false);
+			}
+		}
+
+		// 作れる数が残っていれば、新しく作る
+		if (voices_.size() < maxVoices_)
+		{
+			voices_.push_back({});
+			++stats_.numVoices;
+			return Assign(static_cast<uint32_t>(voices_.size() - 1), format, soundId, priority, false, true);
+		}
+
+		// 作りきっていれば、最も前に鳴らし終えた空きを作り直す
+		uint32_t leastRecent = kInvalidVoice;
+		for (uint32_t i = 0; i < voices_.size(); ++i)
+		{
+			if (voices_[i].isPlaying)
+				continue;
+
+			if (leastRecent == kInvalidVoice || voices_[i].order < voices_[leastRecent].order)
+			{
+				leastRecent = i;
+			}
+		}
+
+		return Assign(leastRecent, format, soundId, priority, false, false);
+	}
+
+
+	/*----------------------------------------------------------
+	    上限まで鳴っていれば、優先度が同じか低いもので、最も低く古いものを止める
+	----------------------------------------------------------*/
+
+	uint32_t victim = kInvalidVoice;
+	for (uint32_t i = 0; i < voices_.size(); ++i)
+	{
+		if (voices_[i].priority > priority)
+			continue;
+
+		if (victim == kInvalidVoice || voices_[i].priority < voices_[victim].priority ||
+			(voices_[i].priority == voices_[victim].priority && voices_[i].order < voices_[victim].order))
+		{
+			victim = i;
+		}
+	}
+
+	if (victim == kInvalidVoice)
+	{
+		++stats_.numRejected;
+		return { kInvalidVoice , false , false , false };
+	}
+
+	++stats_.numStolenByPriority;
+	return Assign(victim, format, soundId, priority, true, false);
+}
+
+// 鳴らし終えたボイスを空きに戻す
+void VoicePool::Release(uint32_t voiceIndex)
+{
+	assert(voiceIndex < voices_.size());
+
+	PoolVoice& voice = voices_[voiceIndex];
+	if (voice.isPlaying == false)
+		return;
+
+	voice.isPlaying = false;
+	voice.order = nextOrder_++;
+	--stats_.numActive;
+}
+
+// 状態が正しいかを確かめる
+bool VoicePool::Validate() const
+{
+	if (voices_.size() > maxVoices_ || stats_.numVoices != voices_.size())
+		return false;
+
+	uint32_t numActive = 0;
+	for (const PoolVoice& voice : voices_)
+	{
+		if (voice.isPlaying)
+		{
+			++numActive;
+		}
+	}
+
+	// 作った数から破棄した数を引くと、作ってあるボイスの数になる
+	return numActive == stats_.numActive && stats_.numActive <= stats_.peakActive && stats_.peakActive <= maxVoices_ &&
+		stats_.numCreated - stats_.numDestroyed == stats_.numVoices;
+}
+
+// 指定した音が鳴っている数
+uint32_t VoicePool::CountInstances(uint32_t soundId) const
+{
+	uint32_t count = 0;
+	for (const PoolVoice& voice : voices_)
+	{
+		if (voice.isPlaying && voice.soundId == soundId)
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+// ボイスを鳴らしている状態にする
+VoiceRequest VoicePool::Assign(uint32_t voiceIndex, const VoiceFormat& format, uint32_t soundId, int32_t priority, bool isStolen, bool isNew)
+{
+	PoolVoice& voice = voices_[voiceIndex];
+
+	VoiceRequest request{};
+	request.voiceIndex = voiceIndex;
+	request.isStolen = isStolen;
+
+	// 新しく加えたものは作り、波形フォーマットが違うものは作り直す
+	if (isNew)
+	{
+		request.needsCreate = true;
+		++stats_.numCreated;
+	}
+	else if ((voice.format == format) == false)
+	{
+		request.needsDestroy = true;
+		request.needsCreate = true;
+		++stats_.numDestroyed;
+		++stats_.numCreated;
+	}
+
+	if (voice.isPlaying == false)
+	{
+		++stats_.numActive;
+		stats_.peakActive = stats_.numActive > stats_.peakActive ? stats_.numActive : stats_.peakActive;
+	}
+
+	voice.format = format;
+	voice.isPlaying = true;
+	voice.soundId = soundId;
+	voice.priority = priority;
+	voice.order = nextOrder_++;
+
+	return request;
+}
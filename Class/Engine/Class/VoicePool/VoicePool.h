@@ -0,0 +1,132 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+
+// ボイスの波形フォーマット（同じものなら、作ったボイスを使い回せる）
+typedef struct VoiceFormat
+{
+	uint16_t formatTag;
+	uint16_t channels;
+	uint32_t samplesPerSec;
+	uint16_t blockAlign;
+	uint16_t bitsPerSample;
+}VoiceFormat;
+
+// 同じ波形フォーマットかどうか
+inline bool operator==(const VoiceFormat& a, const VoiceFormat& b)
+{
+	return a.formatTag == b.formatTag && a.channels == b.channels && a.samplesPerSec == b.samplesPerSec &&
+		a.blockAlign == b.blockAlign && a.bitsPerSample == b.bitsPerSample;
+}
+
+// 鳴らすボイスを選んだ結果（作る、壊す、止めるのは呼んだ側で行う）
+typedef struct VoiceRequest
+{
+	// 鳴らすボイスの番号（鳴らせなければ kInvalidVoice）
+	uint32_t voiceIndex;
+
+	// 鳴っていたものを止めて使うかどうか
+	bool isStolen;
+
+	// 波形フォーマットが違うので、作ってあったボイスを破棄するかどうか
+	bool needsDestroy;
+
+	// ボイスを作るかどうか
+	bool needsCreate;
+}VoiceRequest;
+
+// 数えたもの
+typedef struct VoicePoolStats
+{
+	// 作ってあるボイスの数と、鳴っている数、鳴っている数の最大
+	uint32_t numVoices;
+	uint32_t numActive;
+	uint32_t peakActive;
+
+	// 鳴らした回数と、そのうち作ってあったボイスを使い回した回数
+	uint64_t numPlays;
+	uint64_t numReused;
+
+	// ボイスを作った回数と、破棄した回数
+	uint64_t numCreated;
+	uint64_t numDestroyed;
+
+	// 鳴っていたものを止めた回数（優先度で止めたものと、同じ音の数の上限で止めたもの）
+	uint64_t numStolenByPriority;
+	uint64_t numStolenByInstanceLimit;
+
+	// 優先度の高い音で埋まっていて、鳴らせなかった回数
+	uint64_t numRejected;
+}VoicePoolStats;
+
+// ソースボイスを波形フォーマットごとに使い回し、同時に鳴らす数を抑える（XAudio2を使わずに、どのボイスを使うかだけを決める）
+class VoicePool
+{
+public:
+
+	// 鳴らせなかったときの番号
+	static const uint32_t kInvalidVoice = 0xffffffff;
+
+	// コンストラクタ（maxVoicesは、作るボイスと同時に鳴らす数の上限）
+	explicit VoicePool(uint32_t maxVoices);
+
+	// 鳴らすボイスを選ぶ（maxInstancesは同じ音を同時に鳴らす数の上限で、0なら上限なし）
+	// 同じ音が上限まで鳴っていれば、その中で最も古いものを止めて使う
+	// 上限まで鳴っていれば、優先度が同じか低いものの中で、最も低く古いものを止めて使う
+	VoiceRequest Acquire(const VoiceFormat& format, uint32_t soundId, int32_t priority, uint32_t maxInstances);
+
+	// 鳴らし終えたボイスを空きに戻す（破棄せずに、次に同じ波形フォーマットを鳴らすときに使う）
+	void Release(uint32_t voiceIndex);
+
+	// 状態が正しいかを確かめる
+	bool Validate() const;
+
+	// Getter
+	uint32_t GetMaxVoices() const { return maxVoices_; }
+	uint32_t GetNumVoices() const { return static_cast<uint32_t>(voices_.size()); }
+	bool IsPlaying(uint32_t voiceIndex) const { return voices_[voiceIndex].isPlaying; }
+	uint32_t GetSoundId(uint32_t voiceIndex) const { return voices_[voiceIndex].soundId; }
+	int32_t GetPriority(uint32_t voiceIndex) const { return voices_[voiceIndex].priority; }
+	const VoiceFormat& GetFormat(uint32_t voiceIndex) const { return voices_[voiceIndex].format; }
+	const VoicePoolStats& GetStats() const { return stats_; }
+
+	// 指定した音が鳴っている数
+	uint32_t CountInstances(uint32_t soundId) const;
+
+
+private:
+
+	// 作ってあるボイス
+	typedef struct PoolVoice
+	{
+		// 波形フォーマット
+		VoiceFormat format;
+
+		// 鳴っているかどうか
+		bool isPlaying;
+
+		// 鳴らしている音と、その優先度
+		uint32_t soundId;
+		int32_t priority;
+
+		// 鳴らし始めた順番（空いたものは、鳴らし終えた順番）
+		uint64_t order;
+	}PoolVoice;
+
+	// ボイスを鳴らしている状態にする（isNewなら、加えたばかりで作っていない）
+	VoiceRequest Assign(uint32_t voiceIndex, const VoiceFormat& format, uint32_t soundId, int32_t priority, bool isStolen, bool isNew);
+
+
+	// 作るボイスと同時に鳴らす数の上限
+	uint32_t maxVoices_ = 0;
+
+	// 作ってあるボイス
+	std::vector<PoolVoice> voices_;
+
+	// 次の順番
+	uint64_t nextOrder_ = 0;
+
+	// 数えたもの
+	VoicePoolStats stats_{};
+};
@@ -0,0 +1,251 @@
+#include "WavStream.h"
+
+// デストラクタ
+WavStream::~WavStream()
+{
+	Close();
+}
+
+// ファイルを開き、ヘッダを読んでバッファを作る
+bool WavStream::Open(const std::string& filePath, uint32_t chunkSize, uint32_t numBuffers)
+{
+	Close();
+
+	if (file_.Open(filePath) == false)
+		return false;
+
+	std::istream& file = file_.GetStream();
+	if (ReadHeader(file, format_, dataOffset_, dataSize_) == false || format_.blockAlign == 0 || numBuffers == 0)
+	{
+		file_.Close();
+		return false;
+	}
+
+	// ヘッダの大きさがファイルより大きければ、ファイルにある分だけにする（ブロックの途中で切らない）
+	uint64_t available = file_.GetSize() - dataOffset_;
+	if (dataSize_ > available)
+	{
+		dataSize_ = static_cast<uint32_t>(available);
+	}
+	dataSize_ -= dataSize_ % format_.blockAlign;
+
+	// バッファの大きさは、ブロックの途中で切らないように揃える
+	chunkSize_ = chunkSize - chunkSize % format_.blockAlign;
+	if (chunkSize_ == 0)
+	{
+		file_.Close();
+		return false;
+	}
+
+	numBuffers_ = numBuffers;
+	buffers_ = std::make_unique<uint8_t[]>(size_t(chunkSize_) * numBuffers_);
+
+	return true;
+}
+
+// 読み込むスレッドを止めて、ファイルを閉じる
+void WavStream::Close()
+{
+	Stop();
+
+	file_.Close();
+	buffers_.reset();
+
+	format_ = {};
+	dataOffset_ = 0;
+	dataSize_ = 0;
+	readPosition_ = 0;
+	chunkSize_ = 0;
+	numBuffers_ = 0;
+	writeIndex_ = 0;
+	numQueued_.store(0);
+	numSubmitted_.store(0);
+	isEndOfData_.store(false);
+}
+
+// 始めから読み込み始める
+void WavStream::Start(WavStreamSink* sink, bool isLoop, bool isThreaded)
+{
+	assert(IsOpen());
+	assert(sink);
+
+	Stop();
+
+	// 読み込む位置を始めに戻す
+	std::istream& file = file_.GetStream();
+	file.clear();
+	file.seekg(dataOffset_, std::ios_base::beg);
+
+	sink_ = sink;
+	isLoop_ = isLoop;
+	readPosition_ = 0;
+	writeIndex_ = 0;
+	numQueued_.store(0);
+	numSubmitted_.store(0);
+	isEndOfData_.store(false);
+
+	if (isThreaded)
+	{
+		isStopping_.store(false);
+		readerThread_ = std::thread(&WavStream::ReaderThread, this);
+	}
+}
+
+// 読み込むスレッドを止める
+void WavStream::Stop()
+{
+	if (readerThread_.joinable())
+	{
+		isStopping_.store(true);
+		wakeCount_.fetch_add(1, std::memory_order_release);
+		wakeCount_.notify_one();
+
+		readerThread_.join();
+	}
+
+	sink_ = nullptr;
+}
+
+// 空いているバッファを全て読み込んで積み、積んだ数を返す
+uint32_t WavStream::FillBuffers()
+{
+	std::istream& file = file_.GetStream();
+	uint32_t numFilled = 0;
+
+	while (isEndOfData_.load(std::memory_order_relaxed) == false && numQueued_.load(std::memory_order_acquire) < numBuffers_)
+	{
+		uint8_t* buffer = buffers_.get() + size_t(writeIndex_) * chunkSize_;
+		uint32_t size = 0;
+
+		// バッファが埋まるまで読む（ループするなら、終わりまで読んだら始めに戻って続ける）
+		while (size < chunkSize_)
+		{
+			uint32_t remaining = dataSize_ - readPosition_;
+			if (remaining == 0)
+			{
+				if (isLoop_ == false || dataSize_ == 0)
+					break;
+
+				readPosition_ = 0;
+				file.seekg(dataOffset_, std::ios_base::beg);
+				continue;
+			}
+
+			uint32_t readSize = chunkSize_ - size < remaining ? chunkSize_ - size : remaining;
+			file.read(reinterpret_cast<char*>(buffer + size), readSize);
+
+			size += readSize;
+			readPosition_ += readSize;
+		}
+
+		// 波形データが無ければ、積むものは無い
+		bool isEndOfStream = isLoop_ == false && readPosition_ == dataSize_;
+		if (size == 0)
+		{
+			isEndOfData_.store(true, std::memory_order_release);
+			break;
+		}
+
+		// 再生し終えたときに減らすので、積む前に数える
+		numQueued_.fetch_add(1, std::memory_order_acq_rel);
+		numSubmitted_.fetch_add(1, std::memory_order_relaxed);
+		if (isEndOfStream)
+		{
+			isEndOfData_.store(true, std::memory_order_release);
+		}
+
+		sink_->SubmitBuffer(buffer, size, isEndOfStream);
+
+		writeIndex_ = (writeIndex_ + 1) % numBuffers_;
+		++numFilled;
+	}
+
+	return numFilled;
+}
+
+// 積んだバッファの1つを再生し終えた
+void WavStream::OnBufferEnd()
+{
+	numQueued_.fetch_sub(1, std::memory_order_acq_rel);
+
+	// 読み込むスレッドを起こす
+	wakeCount_.fetch_add(1, std::memory_order_release);
+	wakeCount_.notify_one();
+}
+
+// 読み込むスレッドの処理
+void WavStream::ReaderThread()
+{
+	while (isStopping_.load() == false)
+	{
+		// 読み込んでいる間に起こされたら、待たずにもう一度読む
+		uint32_t wakeCount = wakeCount_.load(std::memory_order_acquire);
+
+		FillBuffers();
+
+		// 終わりまで読んだら、もう読むものは無い
+		if (isEndOfData_.load(std::memory_order_acquire))
+			break;
+
+		wakeCount_.wait(wakeCount, std::memory_order_acquire);
+	}
+}
+
+// .wavのヘッダを読み、波形データの位置と大きさを求める
+bool WavStream::ReadHeader(std::istream& file, WavStreamFormat& format, uint64_t& dataOffset, uint32_t& dataSize)
+{
+	format = {};
+	dataOffset = 0;
+	dataSize = 0;
+
+	// RIFFヘッダ（"RIFF"、大きさ、"WAVE"）
+	char riff[12] = {};
+	file.read(riff, sizeof(riff));
+	if (file.gcount() != sizeof(riff) || strncmp(riff, "RIFF", 4) != 0 || strncmp(riff + 8, "WAVE", 4) != 0)
+		return false;
+
+	bool hasFormat = false;
+
+	// チャンクを順に見て、fmtとdataを探す
+	while (true)
+	{
+		char id[4] = {};
+		uint32_t size = 0;
+		file.read(id, sizeof(id));
+		file.read(reinterpret_cast<char*>(&size), sizeof(size));
+		if (file.gcount() != sizeof(size))
+			return false;
+
+		if (strncmp(id, "fmt ", 4) == 0)
+		{
+			// WAVEFORMATEXの大きさまで読み、知らない拡張の部分は読まない
+			const uint32_t kFormatSize = 18;
+			uint32_t readSize = size < kFormatSize ? size : kFormatSize;
+			if (readSize < 16)
+				return false;
+
+			file.read(reinterpret_cast<char*>(&format), readSize);
+			file.seekg(size - readSize, std::ios_base::cur);
+			hasFormat = true;
+		}
+		else if (strncmp(id, "data", 4) == 0 && hasFormat)
+		{
+			dataOffset = static_cast<uint64_t>(file.tellg());
+			dataSize = size;
+			return true;
+		}
+		else
+		{
+			file.seekg(size, std::ios_base::cur);
+		}
+
+		// チャンクは2バイトに揃えて並ぶ
+		if (size % 2 != 0)
+		{
+			file.seekg(1, std::ios_base::cur);
+		}
+
+		if (file.fail())
+			return false;
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <cassert>
+#include <istream>
+#include "../AssetFile/AssetFile.h"
+
+// .wavの波形フォーマット（並びはWAVEFORMATEXと同じ）
+typedef struct WavStreamFormat
+{
+	uint16_t formatTag;
+	uint16_t channels;
+	uint32_t samplesPerSec;
+	uint32_t avgBytesPerSec;
+	uint16_t blockAlign;
+	uint16_t bitsPerSample;
+	uint16_t extraSize;
+}WavStreamFormat;
+
+// 読み込んだバッファを再生する先（XAudio2のボイスの代わりに、テストでは作り物を使う）
+class WavStreamSink
+{
+public:
+
+	// デストラクタ
+	virtual ~WavStreamSink() = default;
+
+	// バッファを再生する列に積む（再生し終えたら、積んだ順に WavStream::OnBufferEnd を呼ぶこと）
+	virtual void SubmitBuffer(const uint8_t* data, uint32_t sizeInBytes, bool isEndOfStream) = 0;
+};
+
+// .wavを全て読み込まずに、決まった大きさずつ少数のバッファへ読み込んで再生する先に積む
+class WavStream
+{
+public:
+
+	// 1つのバッファの大きさと、バッファの数（1つのストリームで使うメモリは、長さに関係なくこれだけ）
+	static const uint32_t kDefaultChunkSize = 64 * 1024;
+	static const uint32_t kDefaultNumBuffers = 4;
+
+	// コンストラクタ
+	WavStream() = default;
+
+	// 読み込むスレッドを動かしたまま消さないように、コピーはしない
+	WavStream(const WavStream&) = delete;
+	WavStream& operator=(const WavStream&) = delete;
+
+	// デストラクタ（読み込むスレッドを止める）
+	~WavStream();
+
+	// ファイルを開き、ヘッダを読んでバッファを作る（.wavでなければfalse）
+	// アーカイブで圧縮されているものは展開したものを読むので、ディスクか無圧縮で置くこと
+	bool Open(const std::string& filePath, uint32_t chunkSize = kDefaultChunkSize, uint32_t numBuffers = kDefaultNumBuffers);
+
+	// 読み込むスレッドを止めて、ファイルを閉じる（再生する先は、先に止めておくこと）
+	void Close();
+
+	// 始めから読み込み始める（isLoopなら、終わりまで読んだら始めに戻る。isThreadedでなければ、FillBuffersを呼んだスレッドで読む）
+	void Start(WavStreamSink* sink, bool isLoop, bool isThreaded = true);
+
+	// 読み込むスレッドを止める（積んだバッファは、再生する先で破棄すること）
+	void Stop();
+
+	// 空いているバッファを全て読み込んで積み、積んだ数を返す（読み込むスレッドが呼ぶ）
+	uint32_t FillBuffers();
+
+	// 積んだバッファの1つを再生し終えた（再生する先のスレッドから呼ぶ）
+	void OnBufferEnd();
+
+	// .wavのヘッダを読み、波形データの位置と大きさを求める（JUNKなどの知らないチャンクは飛ばす）
+	static bool ReadHeader(std::istream& file, WavStreamFormat& format, uint64_t& dataOffset, uint32_t& dataSize);
+
+	// Getter
+	const WavStreamFormat& GetFormat() const { return format_; }
+	uint32_t GetDataSize() const { return dataSize_; }
+	uint32_t GetChunkSize() const { return chunkSize_; }
+	uint32_t GetNumBuffers() const { return numBuffers_; }
+	uint64_t GetMemoryBytes() const { return uint64_t(chunkSize_) * numBuffers_; }
+	const uint8_t* GetBufferMemory() const { return buffers_.get(); }
+	uint32_t GetNumQueued() const { return numQueued_.load(std::memory_order_acquire); }
+	uint64_t GetNumSubmitted() const { return numSubmitted_.load(std::memory_order_relaxed); }
+	bool IsOpen() const { return file_.IsOpen(); }
+
+	// 終わりまで読み、積んだバッファを全て再生し終えたかどうか
+	bool IsFinished() const { return isEndOfData_.load(std::memory_order_acquire) && GetNumQueued() == 0; }
+
+
+private:
+
+	// 読み込むスレッドの処理
+	void ReaderThread();
+
+
+	// ファイル
+	AssetFile file_;
+
+	// 波形フォーマット
+	WavStreamFormat format_{};
+
+	// 波形データの位置と大きさ、次に読む位置（波形データの始めから）
+	uint64_t dataOffset_ = 0;
+	uint32_t dataSize_ = 0;
+	uint32_t readPosition_ = 0;
+
+	// バッファ（chunkSize_ ずつ numBuffers_ 個並べたもの）と、次に読み込むバッファ
+	std::unique_ptr<uint8_t[]> buffers_;
+	uint32_t chunkSize_ = 0;
+	uint32_t numBuffers_ = 0;
+	uint32_t writeIndex_ = 0;
+
+	// 再生する先と、終わりまで読んだら始めに戻るかどうか
+	WavStreamSink* sink_ = nullptr;
+	bool isLoop_ = false;
+
+	// 積んで、まだ再生し終えていないバッファの数
+	std::atomic<uint32_t> numQueued_{ 0 };
+
+	// これまでに積んだバッファの数
+	std::atomic<uint64_t> numSubmitted_{ 0 };
+
+	// 終わりまで読んだかどうか
+	std::atomic<bool> isEndOfData_{ false };
+
+	// 読み込むスレッドを起こした回数と、止めるかどうか
+	std::atomic<uint32_t> wakeCount_{ 0 };
+	std::atomic<bool> isStopping_{ false };
+
+	// 読み込むスレッド
+	std::thread readerThread_;
+};
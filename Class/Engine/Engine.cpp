@@ -3,12 +3,14 @@
 // デストラクタ
 Engine::~Engine()
 {
+	// 終了時のメモリの使用量と最大値を書き出す
+	UpdateVideoMemoryInfo();
+	MemoryTracker::WriteDump(logFileStem_ + "_memory.txt");
+
 	ImGui_ImplDX12_Shutdown();
 	ImGui_ImplWin32_Shutdown();
 	ImGui::DestroyContext();
 
-	pixelShaderBlob_->Release();
-	vertexShaderBlob_->Release();
 	rootSignature_->Release();
 	if (errorBlob_)
 	{
@@ -16,6 +18,12 @@ Engine::~Engine()
 	}
 	signatureBlob_->Release();
 
+	// ファイルの変更の監視
+	delete fileWatcher_;
+
+	// 起動処理の計測（最初のフレームの前に終了したときだけ残っている）
+	delete startupProfiler_;
+
 	// シェーダー
 	delete shader_;
 
@@ -28,12 +36,25 @@ Engine::~Engine()
 	// テクスチャマネージャ
 	delete textureManager_;
 
+	// アセットのアーカイブ（読み込んだものを全て解放してから閉じる）
+	for (AssetArchive* assetArchive : assetArchives_)
+	{
+		AssetFile::UnmountArchive(assetArchive);
+		delete assetArchive;
+	}
+
 	// フェンス
 	delete fence_;
 
 	// スワップチェーン
 	delete swapChain_;
 	
+	// 描画のコマンドを積む先
+	delete renderDevice_;
+
+	// ヒープ（置いたリソースを全て解放してから消す）
+	delete memoryAllocator_;
+
 	// コマンドリスト
 	delete commands_;
 
@@ -53,6 +74,12 @@ Engine::~Engine()
 // 初期化
 void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight)
 {
+	// 起動処理の計測を始める（最初のフレームを表示したら、レポートを書き出す）
+	startupProfiler_ = new StartupProfiler();
+	ProfileScope initializeScope(startupProfiler_, "Initialize", "Initialize");
+
+	startupProfiler_->Begin("Log", "Initialize");
+
 	/*-------------------------
 	    ログファイルを書き出す
 	-------------------------*/
@@ -76,10 +103,22 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	// 時刻を使ってファイル名を決定
 	std::string logFilePath = std::string("Class/Engine/Logs/") + dateString + ".log";
 
-	// ファイルを作って書き込み準備
-	std::ofstream logStream(logFilePath);
+	// トレースなども、同じ時刻の名前で書き出す
+	logFileStem_ = std::string("Class/Engine/Logs/") + dateString;
+
+	// ファイルを作り、書き出すスレッドを始める（読み込み時のログも書き込むので、終了まで開いておく）
+	logger_.Start(logFilePath);
+
+	// 起動した時刻を記録する
+	startTime_ = std::chrono::steady_clock::now();
 
+	// フレームの計測で、メインスレッドを見分けられるようにする
+	FrameProfiler::SetThreadName("Main");
 
+	startupProfiler_->End();
+
+
+	startupProfiler_->Begin("Window", "Initialize");
 
 	// COMの初期化
 	CoInitializeEx(0, COINIT_MULTITHREADED);
@@ -100,22 +139,26 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	errorDetection_ = new ErrorDetection();
 	errorDetection_->Initialize();
 
+	startupProfiler_->End();
+
 
 	/*-----------------------
 	    DirectXを初期化する
 	-----------------------*/
 
+	startupProfiler_->Begin("Device", "Initialize");
+
 	// DXGIfactoryを取得する
 	dxgiFactory_ = GetDXGIFactory();
 
 	// 使用するアダプタ（GPU）を取得する
-	useAdapter_ = GetUseAdapter(logStream,dxgiFactory_);
+	useAdapter_ = GetUseAdapter(logStream_,dxgiFactory_);
 
 	// Deviceを取得する
-	device_ = GetDevice(logStream,useAdapter_);
+	device_ = GetDevice(logStream_,useAdapter_);
 
 	// 初期化完了!!!
-	Log(logStream,"Complate create ID3D12Device!! \n");
+	Log(logStream_,"Complate create ID3D12Device!! \n");
 
 
 	// エラーを検知したら停止する
@@ -126,11 +169,21 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	commands_ = new Commands();
 	commands_->Initialize(device_);
 
+	// バッファとテクスチャを置くヒープ
+	memoryAllocator_ = new GpuMemoryAllocator(device_, useAdapter_);
+
+	// 描画のコマンドは、コマンドリストに積む
+	renderDevice_ = new D3D12RenderDevice(commands_->GetCommandList(), memoryAllocator_);
+
+	startupProfiler_->End();
+
 
 	/*----------------------------
 	    DescriptorHeapを生成する
 	----------------------------*/
 
+	startupProfiler_->Begin("DescriptorHeaps", "Initialize");
+
 	// RTV用のディスクリプタヒープ
 	rtvDescriptorHeap_ = CreateDescriptorHeap(device_, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, kNumRtvDescriptor_, false);
 
@@ -140,11 +193,15 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	// DSV用のディスクリプタヒープ
 	dsvDescriptorHeap_ = CreateDescriptorHeap(device_, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, kNunDsvDescriptor_, false);
 
+	startupProfiler_->End();
+
 
 	/*------------------------
 	    wapChainを生成する
 	------------------------*/
 
+	startupProfiler_->Begin("SwapChain", "Initialize");
+
 	// swapChainの生成と初期化
 	swapChain_ = new SwapChain();
 	swapChain_->Initialize(window_->GetHwnd(), dxgiFactory_, device_, commands_->GetCommandQueue(), kClientWidth, kClientHeight);
@@ -157,6 +214,9 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	hr = swapChain_->GetSwapChain()->GetBuffer(1, IID_PPV_ARGS(&swapChainResource_[1]));
 	assert(SUCCEEDED(hr));
 
+	MemoryTracker::AddResource(swapChainResource_[0].Get(), MemoryCategory::RenderTarget, "SwapChain buffer 0");
+	MemoryTracker::AddResource(swapChainResource_[1].Get(), MemoryCategory::RenderTarget, "SwapChain buffer 1");
+
 	
 	/*---------------
 	    RTVを作る
@@ -185,27 +245,35 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	fence_ = new Fence();
 	fence_->Initialize(device_);
 
+	startupProfiler_->End();
+
+
+	startupProfiler_->Begin("Managers", "Initialize");
 
-	
 	// テクスチャマネージャの初期化と生成
 	textureManager_ = new TextureManager();
-	textureManager_->Initialize();
+	textureManager_->Initialize(memoryAllocator_);
 
 	// モデルマネージャの初期化と生成
 	modelManager_ = new ModelManager();
-	modelManager_->Initialize();
+	modelManager_->Initialize(memoryAllocator_);
 
 	// サウンドの初期化と生成
 	sound_ = new Sound();
 	sound_->Initialize();
 
+	startupProfiler_->End();
+
 
 
 	/*------------------
 	    DSVを設定する
 	------------------*/
 
+	startupProfiler_->Begin("DepthStencil", "Initialize");
+
 	depthStencilResource_ = CreateDepthStencilTextureResource(device_, kClientWidth, kClientHeight);
+	MemoryTracker::AddResource(depthStencilResource_.Get(), MemoryCategory::RenderTarget, "DepthStencil");
 
 	// DSVの設定
 	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
@@ -215,15 +283,23 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	// DSVheapの先頭に配置する
 	device_->CreateDepthStencilView(depthStencilResource_.Get(), &dsvDesc, dsvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart());
 
+	startupProfiler_->End();
+
 
 	/*-------------
 	    描画設定
 	-------------*/
 
+	startupProfiler_->Begin("Shader", "Initialize");
+
 	// シェーダーの初期化と生成
 	shader_ = new Shader();
 	shader_->Initialize();
 
+	startupProfiler_->End();
+
+
+	startupProfiler_->Begin("RootSignature", "Initialize");
 
 	// ディスクリプタレンジ
 	D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
@@ -288,7 +364,7 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob_, &errorBlob_);
 	if (FAILED(hr))
 	{
-		Log(logStream,reinterpret_cast<char*>(errorBlob_->GetBufferPointer()));
+		logger_.WriteMessage(LogLevel::Error, reinterpret_cast<char*>(errorBlob_->GetBufferPointer()));
 		assert(false);
 	}
 
@@ -297,8 +373,67 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 		signatureBlob_->GetBufferPointer(), signatureBlob_->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
 	assert(SUCCEEDED(hr));
 
+	startupProfiler_->End();
+
+
+
+	/*   シェーダーのバリアントごとにPSOを作る   */
+
+	startupProfiler_->Begin("PipelineStates", "Initialize");
+
+	bool isBuilt = BuildGraphicsPipelineStates(graphicsPipelineStates_);
+	assert(isBuilt);
+
+	// 描画のたびに求めないように、よく使うバリアントのキーを求めておく
+	unlitVariantKey_ = MakeShaderVariantKey(kPixelShaderKeywords_, {});
+	litVariantKey_ = MakeShaderVariantKey(kPixelShaderKeywords_, { "LIGHTING_HALF_LAMBERT" });
+
+	startupProfiler_->End();
+
+
+	/*   ビューポートとシザー   */
+
+	viewport_.Width = static_cast<float>(kClientWidth);
+	viewport_.Height = static_cast<float>(kClientHeight);
+	viewport_.TopLeftX = 0;
+	viewport_.TopLeftY = 0;
+	viewport_.MinDepth = 0.0f;
+	viewport_.MaxDepth = 1.0f;
+
+	scissorRect_.left = 0;
+	scissorRect_.right = kClientWidth;
+	scissorRect_.top = 0;
+	scissorRect_.bottom = kClientHeight;
+
+
+	/*----------------------
+	    ImGuiを初期化する
+	----------------------*/
+
+	IMGUI_CHECKVERSION();
+	startupProfiler_->Begin("ImGui", "Initialize");
 
+	ImGui::CreateContext();
+	ImGui::StyleColorsDark();
+	ImGui_ImplWin32_Init(window_->GetHwnd());
+	ImGui_ImplDX12_Init(device_.Get(), swapChain_->GetSwapChainDesc().BufferCount, rtvDesc.Format,
+		srvDescriptorHeap_.Get(),
+		srvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(),
+		srvDescriptorHeap_->GetGPUDescriptorHandleForHeapStart());
+
+	startupProfiler_->End();
 
+
+	/*--------------------------------------------
+	    テクスチャの無いマテリアルに使うものを読み込む
+	--------------------------------------------*/
+
+	whiteTextureNumber_ = LoadTexture(kWhiteTextureFilePath_);
+}
+
+// シェーダーから、描画の設定を全て詰め込んだPSOを作る（作れなければnullptr）
+Microsoft::WRL::ComPtr<ID3D12PipelineState> Engine::CreateGraphicsPipelineState(IDxcBlob* vertexShaderBlob, IDxcBlob* pixelShaderBlob)
+{
 	/*   InputLayout   */
 
 	// 頂点シェーダのどの変数にinputするかを選ぶ
@@ -363,15 +498,6 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	rasterizeDesc.FillMode = D3D12_FILL_MODE_SOLID;
 
 
-	/*   シェーダーをコンパイルする   */
-
-	vertexShaderBlob_ = shader_->CompilerShader(logStream,L"./Class/Engine/Shader/Object3D.VS.hlsl", L"vs_6_0");
-	assert(vertexShaderBlob_ != nullptr);
-
-	pixelShaderBlob_ = shader_->CompilerShader(logStream,L"./Class/Engine/Shader/Object3D.PS.hlsl", L"ps_6_0");
-	assert(pixelShaderBlob_ != nullptr);
-
-
 	/*   DepthStencilState   */
 
 	// デプスステンシルの設定
@@ -393,8 +519,8 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
 	graphicsPipelineStateDesc.pRootSignature = rootSignature_;
 	graphicsPipelineStateDesc.InputLayout = inputLayoutDescs;
-	graphicsPipelineStateDesc.VS = { vertexShaderBlob_->GetBufferPointer() , vertexShaderBlob_->GetBufferSize() };
-	graphicsPipelineStateDesc.PS = { pixelShaderBlob_->GetBufferPointer() , pixelShaderBlob_->GetBufferSize() };
+	graphicsPipelineStateDesc.VS = { vertexShaderBlob->GetBufferPointer() , vertexShaderBlob->GetBufferSize() };
+	graphicsPipelineStateDesc.PS = { pixelShaderBlob->GetBufferPointer() , pixelShaderBlob->GetBufferSize() };
 	graphicsPipelineStateDesc.BlendState = blendDesc;
 	graphicsPipelineStateDesc.RasterizerState = rasterizeDesc;
 	graphicsPipelineStateDesc.DepthStencilState = depthStencilDesc;
@@ -414,37 +540,96 @@ void Engine::Initialize(const int32_t kClientWidth , const int32_t kClientHeight
 	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
 
 	// 設定を基に生成する
-	hr = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineState_));
-	assert(SUCCEEDED(hr));
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState = nullptr;
+	HRESULT hr = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineState));
+	if (FAILED(hr))
+		return nullptr;
 
+	return graphicsPipelineState;
+}
 
-	/*   ビューポートとシザー   */
+// シェーダーのバリアントを全てコンパイルし、バリアントのキーごとのPSOを作る（1つでも失敗したらfalse）
+bool Engine::BuildGraphicsPipelineStates(std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>>& pipelineStates)
+{
+	// 頂点シェーダーは全てのバリアントで同じものを使う
+	IDxcBlob* vertexShaderBlob = nullptr;
+	{
+		ProfileScope scope(startupProfiler_, "CompileVertexShader", "Shader");
+		vertexShaderBlob = shader_->TryCompileShader(logStream_, kVertexShaderPath_, L"vs_6_0");
+	}
 
-	viewport_.Width = static_cast<float>(kClientWidth);
-	viewport_.Height = static_cast<float>(kClientHeight);
-	viewport_.TopLeftX = 0;
-	viewport_.TopLeftY = 0;
-	viewport_.MinDepth = 0.0f;
-	viewport_.MaxDepth = 1.0f;
+	// ピクセルシェーダーは、キーワードの組み合わせごとに並列でコンパイルする
+	std::vector<uint32_t> variantKeys = EnumerateShaderVariants(kPixelShaderKeywords_);
+	std::vector<IDxcBlob*> pixelShaderBlobs;
+	{
+		ProfileScope scope(startupProfiler_, "CompilePixelShaderVariants", "Shader", std::format("{} variants", variantKeys.size()));
+		pixelShaderBlobs = shader_->CompileShaderVariants(logStream_, kPixelShaderPath_, L"ps_6_0",
+			kPixelShaderKeywords_, variantKeys, (std::max)(std::thread::hardware_concurrency(), 1u));
+	}
 
-	scissorRect_.left = 0;
-	scissorRect_.right = kClientWidth;
-	scissorRect_.top = 0;
-	scissorRect_.bottom = kClientHeight;
+	bool isBuilt = vertexShaderBlob != nullptr;
 
+	for (uint32_t i = 0; i < variantKeys.size(); ++i)
+	{
+		if (isBuilt == false || pixelShaderBlobs[i] == nullptr)
+		{
+			isBuilt = false;
+			break;
+		}
 
-	/*----------------------
-	    ImGuiを初期化する
-	----------------------*/
+		ProfileScope scope(startupProfiler_, "CreatePipelineState", "Shader", std::format("variant {}", variantKeys[i]));
 
-	IMGUI_CHECKVERSION();
-	ImGui::CreateContext();
-	ImGui::StyleColorsDark();
-	ImGui_ImplWin32_Init(window_->GetHwnd());
-	ImGui_ImplDX12_Init(device_.Get(), swapChain_->GetSwapChainDesc().BufferCount, rtvDesc.Format,
-		srvDescriptorHeap_.Get(),
-		srvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(),
-		srvDescriptorHeap_->GetGPUDescriptorHandleForHeapStart());
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState = CreateGraphicsPipelineState(vertexShaderBlob, pixelShaderBlobs[i]);
+		if (graphicsPipelineState == nullptr)
+		{
+			isBuilt = false;
+			break;
+		}
+
+		pipelineStates[variantKeys[i]] = graphicsPipelineState;
+	}
+
+	// PSOを作ったら、シェーダーのバイナリは要らない
+	if (vertexShaderBlob)
+	{
+		vertexShaderBlob->Release();
+	}
+
+	for (IDxcBlob* pixelShaderBlob : pixelShaderBlobs)
+	{
+		if (pixelShaderBlob)
+		{
+			pixelShaderBlob->Release();
+		}
+	}
+
+	if (isBuilt == false)
+	{
+		pipelineStates.clear();
+	}
+
+	return isBuilt;
+}
+
+// マテリアルの設定に合ったPSOを取得する
+ID3D12PipelineState* Engine::SelectPipelineState(bool enableLighting)
+{
+	auto pipelineState = graphicsPipelineStates_.find(enableLighting ? litVariantKey_ : unlitVariantKey_);
+	assert(pipelineState != graphicsPipelineStates_.end());
+
+	return pipelineState->second.Get();
+}
+
+// 描画に共通の設定を取得する
+DrawPass Engine::GetDrawPass(bool enableLighting)
+{
+	DrawPass pass{};
+	pass.viewport = viewport_;
+	pass.scissorRect = scissorRect_;
+	pass.rootSignature = ToRenderHandle(rootSignature_);
+	pass.pipelineState = ToRenderHandle(SelectPipelineState(enableLighting));
+
+	return pass;
 }
 
 // ウィンドウが開いているかどうか
@@ -461,772 +646,697 @@ bool Engine::IsWindowOpen()
 // フレーム開始
 void Engine::BeginFrame()
 {
+	// 前のフレームの計測を締める（フレームの時間は、ここから次のBeginFrameまで）
+	FrameProfiler::NewFrame();
+
+	PROFILE_SCOPE("BeginFrame");
+
 	ImGui_ImplDX12_NewFrame();
 	ImGui_ImplWin32_NewFrame();
 	ImGui::NewFrame();
 
 	input_->Acquire();
 
+	// 最初のフレームは、表示するまでを起動処理として計測する
+	if (startupProfiler_)
+	{
+		startupProfiler_->Begin("FirstFrame", "Frame");
+	}
+
+	// 前のフレームでメモリの予算を超えたものを知らせる
+	for (const std::string& warning : MemoryTracker::TakeBudgetWarnings())
+	{
+		logger_.WriteMessage(LogLevel::Warning, warning);
+	}
+
+	// 前のフレームで解放したリソースは、GPUが使い終わっている
+	textureManager_->CollectRetiredResources();
+	modelManager_->CollectRetiredResources();
+	retiredPipelineStates_.clear();
+
+	// 変更されたファイルを読み込み直す（差し替えた古いものは、次のフレームで解放する）
+	UpdateHotReload();
+
+	// ストリーミング中のテクスチャのミップを転送する
+	{
+		PROFILE_SCOPE("UpdateStreaming");
+		textureManager_->UpdateStreaming(device_, commands_->GetCommandList(), GetElapsedSeconds());
+	}
+
 	// バックバッファのインデックスを取得する
 	UINT backBufferIndex = swapChain_->GetCurrentBackBufferIndex();
 
-	// バックバッファの状態を Present -> RenderTarget に遷移させる
-	TransitionBarrier(commands_->GetCommandList(), swapChainResource_[backBufferIndex],
-		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	// フレームのパスを組み立てる（バックバッファは、最後にPresentに戻す）
+	renderGraph_.Reset();
+	uint32_t backBuffer = renderGraph_.ImportResource("BackBuffer", ToRenderHandle(swapChainResource_[backBufferIndex].Get()),
+		RenderState::Present, RenderState::Present);
+	uint32_t depthStencil = renderGraph_.ImportResource("DepthStencil", ToRenderHandle(depthStencilResource_.Get()),
+		RenderState::DepthWrite, RenderState::DepthWrite);
 
-	// 描画先のRTVとDSVを設定する
-	D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = dsvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart();
-	commands_->GetCommandList()->OMSetRenderTargets(1, &rtvHandles_[backBufferIndex], false, &dsvHandle);
+	// シーン（描画先を設定してクリアする。描画のコマンドは、この後にユーザーが積む）
+	scenePass_ = renderGraph_.AddPass("Scene", [this, backBufferIndex]()
+		{
+			// 描画先のRTVとDSVを設定する
+			D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = dsvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart();
+			commands_->GetCommandList()->OMSetRenderTargets(1, &rtvHandles_[backBufferIndex], false, &dsvHandle);
+
+			// 指定した色で画面をクリアする
+			float clearColor[] = { 0.1f , 0.25f , 0.5f , 1.0f };
+			commands_->GetCommandList()->ClearRenderTargetView(rtvHandles_[backBufferIndex], clearColor, 0, nullptr);
+			commands_->GetCommandList()->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+			// 描画用のDescriptorの設定
+			ID3D12DescriptorHeap* descriptorHeaps[] = { srvDescriptorHeap_.Get() };
+			commands_->GetCommandList()->SetDescriptorHeaps(1, descriptorHeaps);
+		});
+	renderGraph_.Write(scenePass_, backBuffer, RenderState::RenderTarget);
+	renderGraph_.Write(scenePass_, depthStencil, RenderState::DepthWrite);
+
+	// ImGui（EndFrameで、ImGui::Renderの後に実行する）
+	uint32_t imguiPass = renderGraph_.AddPass("ImGui", [this]()
+		{
+			ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commands_->GetCommandList().Get());
+		});
+	renderGraph_.Write(imguiPass, backBuffer, RenderState::RenderTarget);
 
-	// 指定した色で画面をクリアする
-	float clearColor[] = { 0.1f , 0.25f , 0.5f , 1.0f };
-	commands_->GetCommandList()->ClearRenderTargetView(rtvHandles_[backBufferIndex], clearColor, 0, nullptr);
-	commands_->GetCommandList()->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH,1.0f,0,0,nullptr);
+	// 宣言が矛盾していたら、ログに書き出して止める
+	if (renderGraph_.Compile(logStream_) == false)
+	{
+		assert(false);
+	}
 
-	// 描画用のDescriptorの設定
-	ID3D12DescriptorHeap* descriptorHeaps[] = { srvDescriptorHeap_.Get()};
-	commands_->GetCommandList()->SetDescriptorHeaps(1, descriptorHeaps);
+	// シーンのパスまで実行する
+	renderGraph_.Execute([this](const std::vector<RenderBarrier>& barriers) { SubmitBarriers(commands_->GetCommandList(), barriers); }, scenePass_);
 }
 
 // フレーム終了
 void Engine::EndFrame()
 {
+	PROFILE_SCOPE("EndFrame");
 
-	ImGui::Render();
+	// ImGuiの描画コマンドを積む
+	{
+		PROFILE_SCOPE("ImGuiRender");
 
-	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commands_->GetCommandList().Get());
+		ImGui::Render();
 
-	// バックバッファのインデックスを取得する
-	UINT backBufferIndex = swapChain_->GetCurrentBackBufferIndex();
+		// 残りのパスを実行し、バックバッファをPresentに戻す
+		renderGraph_.Execute([this](const std::vector<RenderBarrier>& barriers) { SubmitBarriers(commands_->GetCommandList(), barriers); });
+	}
 
-	// バックバッファの状態を RenderTarget -> Present に遷移させる
-	TransitionBarrier(commands_->GetCommandList(), swapChainResource_[backBufferIndex],
-		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+	// コマンドリストの内容を確定させ、GPUに実行を行わせる
+	{
+		PROFILE_SCOPE("Submit");
 
-	// コマンドリストの内容を確定させる
-	HRESULT hr = commands_->GetCommandList()->Close();
-	assert(SUCCEEDED(hr));
+		HRESULT hr = commands_->GetCommandList()->Close();
+		assert(SUCCEEDED(hr));
 
-	// GPUにコマンドリストの実行を行わせる
-	ID3D12CommandList* commandLists[] = { commands_->GetCommandList().Get()};
-	commands_->GetCommandQueue()->ExecuteCommandLists(1, commandLists);
+		ID3D12CommandList* commandLists[] = { commands_->GetCommandList().Get()};
+		commands_->GetCommandQueue()->ExecuteCommandLists(1, commandLists);
+	}
 
 	// GPUとOSに画面の交換を行うように通知する
-	swapChain_->GetSwapChain()->Present(1, 0);
+	{
+		PROFILE_SCOPE("Present");
+		swapChain_->GetSwapChain()->Present(1, 0);
+	}
 
 	// GPUの完了を待つ
-	fence_->WaitForGPU(commands_->GetCommandQueue());
+	{
+		PROFILE_SCOPE("WaitForGPU");
+		fence_->WaitForGPU(commands_->GetCommandQueue());
+	}
 
 	// 次のフレーム用のコマンドリストを準備
-	hr = commands_->GetCommandAllocator()->Reset();
+	HRESULT hr = commands_->GetCommandAllocator()->Reset();
 	assert(SUCCEEDED(hr));
 	hr = commands_->GetCommandList()->Reset(commands_->GetCommandAllocator().Get(), nullptr);
 	assert(SUCCEEDED(hr));
 
 
-	// 使用したリソースのアドレスを消す
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i])
-		{
-			resourceMemories[i] = nullptr;
-		}
-	}
+	// 描画ごとのバッファを解放し、設定した状態を忘れる
+	uint64_t frameBufferBytes = renderDevice_->FinishFrame();
+
+	// 描画ごとのバッファはこのフレームで解放したので、最大値にだけ残す
+	MemoryTracker::Add(renderDevice_, MemoryCategory::Upload, MemoryHeap::Gpu, "Per-draw buffers", frameBufferBytes);
+	MemoryTracker::Remove(renderDevice_);
 
 	input_->CopyKeys();
-}
 
-// テクスチャを読み込む
-uint32_t Engine::LoadTexture(const std::string& filePath)
-{
-	return textureManager_->LoadTextureGetNumber(filePath, device_, srvDescriptorHeap_, commands_->GetCommandList());
+	// 最初のフレームを表示したら、起動処理の計測を終える
+	if (startupProfiler_)
+	{
+		FinishStartupProfile();
+	}
 }
 
-// モデルデータを読み込む
-uint32_t Engine::LoadModelData(const std::string& directory, const std::string& fileName)
+// 起動処理の計測を終え、レポートをログに、トレースをJSONに書き出す
+void Engine::FinishStartupProfile()
 {
-	uint32_t modelNumber = modelManager_->LoadModelGetNumber(directory, fileName);
-	modelManager_->SetTextureNumber(modelNumber,
-		textureManager_->LoadTextureGetNumber(modelManager_->GetModelData(modelNumber).material.textureFilePath,
-			device_, srvDescriptorHeap_, commands_->GetCommandList()));
+	startupProfiler_->Finish();
+	startupProfiler_->Report(logStream_);
 
-	return modelNumber;
-}
+	std::string tracePath = logFileStem_ + "_startup.json";
+	if (startupProfiler_->WriteChromeTrace(tracePath))
+	{
+		logger_.Write(LogLevel::Info, "StartupProfiler : wrote {}", tracePath);
+	} else
+	{
+		logger_.Write(LogLevel::Warning, "StartupProfiler : failed to write {}", tracePath);
+	}
 
-// サウンドデータを読み込む
-uint32_t Engine::LoadSound(const char* fileName)
-{
-	return sound_->LoadSoundGetNumber(fileName);
+	// 以降の読み込みは計測しない
+	delete startupProfiler_;
+	startupProfiler_ = nullptr;
 }
 
-// サウンドデータを再生する
-void Engine::PlayerSoundWav(uint32_t soundHandle)
+// テクスチャを読み込む
+uint32_t Engine::LoadTexture(const std::string& filePath)
 {
-	sound_->SelectNumberPlaySoundWav(soundHandle);
-}
+	ProfileScope scope(startupProfiler_, "LoadTexture", "Texture", filePath);
 
-// キー操作（Press）
-UINT Engine::PushPressKeys(BYTE key)
-{
-	return input_->PressKeys(key);
+	return textureManager_->LoadTextureGetNumber(logStream_, filePath, device_, srvDescriptorHeap_, commands_->GetCommandList());
 }
 
-// キー操作（Trigger）
-UINT Engine::PushTriggerKeys(BYTE key)
+// テクスチャを解放する（同じテクスチャを読み込んだ全ての場所で解放したら、GPUが使い終わってから解放する）
+void Engine::UnloadTexture(uint32_t textureHandle)
 {
-	return input_->TriggerKeys(key);
-}
-
-// キー操作（Release）
-UINT Engine::PushReleaseKeys(BYTE key)
-{
-	return input_->ReleaseKeys(key);
+	textureManager_->ReleaseTexture(textureHandle);
 }
 
-// 三角形を描画する
-void Engine::DrawTriangle(struct Transform3D& transform,const Matrix4x4& viewProjectionMatrix, uint32_t textureHandle, Vector3 color)
+// 複数のスプライト画像をアトラスに詰めて読み込む（戻り値は画像ごとの領域）
+std::vector<SpriteRegion> Engine::LoadSpriteAtlas(const std::vector<std::string>& filePaths)
 {
-	// ビューポートの設定
-	commands_->GetCommandList()->RSSetViewports(1, &viewport_);
-	
-	// シザーの設定
-	commands_->GetCommandList()->RSSetScissorRects(1, &scissorRect_);
+	ProfileScope scope(startupProfiler_, "LoadSpriteAtlas", "Texture", std::format("{} sprites", filePaths.size()));
 
-	// rootSignature
-	commands_->GetCommandList()->SetGraphicsRootSignature(rootSignature_);
+	SpriteAtlas atlas;
+	atlas.Initialize(kSpriteAtlasPageSize_, kSpriteAtlasPadding_);
 
-	// PSOの設定
-	commands_->GetCommandList()->SetPipelineState(graphicsPipelineState_.Get());
-
-
-	// 頂点リソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = CreateBufferResource(device_, sizeof(VertexData) * 6);
+	// 同じ画像と設定でビルドしたアトラスがあれば、それを使う
+	std::string cachePath = SpriteAtlas::GetCachePath(filePaths, kSpriteAtlasPageSize_, kSpriteAtlasPadding_);
+	if (cachePath.empty())
+	{
+		logger_.WriteMessage(LogLevel::Error, "LoadSpriteAtlas : failed to read the sprite images");
+		return {};
+	}
 
-	// VBVを作成する
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = sizeof(VertexData) * 6;
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
+	if (atlas.Load(cachePath) == false || atlas.GetNumImages() != filePaths.size())
+	{
+		atlas.Initialize(kSpriteAtlasPageSize_, kSpriteAtlasPadding_);
 
-	// データを書き込む
-	VertexData* vertexData = nullptr;
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	vertexData[0].position = { 0.0f , 0.5f , 0.0f , 1.0f };
-	vertexData[0].texcoord = { 0.5f , 0.0f };
-	vertexData[0].normal = { 0.0f,0.0f,0.0f };
-	vertexData[1].position = { 0.5f , -0.5f , 0.0f , 1.0f };
-	vertexData[1].texcoord = { 1.0f , 1.0f };
-	vertexData[1].normal = { 0.0f,0.0f,0.0f };
-	vertexData[2].position= { -0.5f , -0.5f , 0.0f , 1.0f };
-	vertexData[2].texcoord = { 0.0f , 1.0f };
-	vertexData[2].normal = { 0.0f,0.0f,0.0f };
-	vertexData[3].position = { 0.0f , 0.0f , 0.0f , 1.0f };
-	vertexData[3].texcoord = { 0.5f , 0.0f };
-	vertexData[3].normal = { 0.0f,0.0f,0.0f };
-	vertexData[4].position = { 0.0f , -0.5f , -0.5f , 1.0f };
-	vertexData[4].texcoord = { 1.0f , 1.0f };
-	vertexData[4].normal = { 0.0f,0.0f,0.0f };
-	vertexData[5].position = { 0.0f , -0.5f , 0.5f , 1.0f };
-	vertexData[5].texcoord = { 0.0f , 1.0f };
-	vertexData[5].normal = { 0.0f,0.0f,0.0f };
+		// 画像の番号とfilePathsの順番がずれないように、1枚でも読めなければ何も返さない
+		for (const std::string& filePath : filePaths)
+		{
+			if (atlas.AddImage(filePath) == false)
+			{
+				logger_.Write(LogLevel::Error, "LoadSpriteAtlas : failed to load {}", filePath);
+				return {};
+			}
+		}
 
+		if (atlas.Build() == false)
+		{
+			logger_.Write(LogLevel::Error, "LoadSpriteAtlas : a sprite is larger than a {}x{} page", kSpriteAtlasPageSize_, kSpriteAtlasPageSize_);
+			return {};
+		}
 
-	// マテリアル用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(device_, sizeof(Material));
+		atlas.Save(cachePath);
+	}
 
-	// マテリアルに書き込むデータ
-	Material* materialData = nullptr;
-	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
+	logger_.Write(LogLevel::Info, "LoadSpriteAtlas : {} sprites , {} pages", atlas.GetNumImages(), atlas.GetNumPages());
 
-	Transform3D uvTransform = { {1.0f , 1.0f , 1.0f} , {0.0f , 0.0f , 0.0f} , {0.0f , 0.0f , 0.0f} };
+	// ページをテクスチャにする
+	std::vector<uint32_t> pageHandles(atlas.GetNumPages());
+	for (uint32_t page = 0; page < atlas.GetNumPages(); ++page)
+	{
+		pageHandles[page] = textureManager_->LoadTextureFromImageGetNumber(std::format("SpriteAtlas page {}", page), atlas.GetPage(page), device_, srvDescriptorHeap_, commands_->GetCommandList());
+	}
 
-	materialData->color = {color.x , color.y , color.z , 1.0f};
-	materialData->enableLighting = false;
-	materialData->uvTransform = Multiply(Multiply(Make4x4ScaleMatrix(uvTransform.scale),
-		Make4x4RotateZMatrix(uvTransform.rotate.z)), Make4x4TranslateMatrix(uvTransform.translate));
+	// 画像ごとの領域
+	std::vector<SpriteRegion> sprites(atlas.GetNumImages());
+	for (uint32_t i = 0; i < atlas.GetNumImages(); ++i)
+	{
+		sprites[i].textureHandle = pageHandles[atlas.GetRect(i).page];
+		sprites[i].uvMin = atlas.GetUVMin(i);
+		sprites[i].uvMax = atlas.GetUVMax(i);
+	}
 
+	return sprites;
+}
 
-	// 座標変換用のリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource = CreateBufferResource(device_, sizeof(TransformationMatrix));
+// テクスチャを読み込む（粗いミップから表示し、細かいミップは後のフレームで転送する）
+uint32_t Engine::LoadTextureStreaming(const std::string& filePath)
+{
+	ProfileScope scope(startupProfiler_, "LoadTextureStreaming", "Texture", filePath);
 
-	// 行列に書き込む
-	TransformationMatrix* transformationMatrixData = nullptr;
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
-	transformationMatrixData->world = Make4x4AffineMatrix(transform.scale, transform.rotate, transform.translate);
-	transformationMatrixData->worldViewProjection = Multiply(transformationMatrixData->world, viewProjectionMatrix);
+	return textureManager_->LoadTextureStreamingGetNumber(logStream_, filePath, device_, srvDescriptorHeap_, commands_->GetCommandList());
+}
 
+// テクスチャのブロック圧縮のフォーマットを設定する（DXGI_FORMAT_UNKNOWNなら圧縮しない）
+void Engine::SetTextureCompression(DXGI_FORMAT compressFormat, bool fastCompression)
+{
+	textureManager_->SetCookSettings({ compressFormat, fastCompression });
+}
 
-	// VBVを設定する
-	commands_->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+// テクスチャを画面上で表示する大きさ（ピクセル）を要求する
+void Engine::RequestTextureScreenSize(uint32_t textureHandle, float screenPixels)
+{
+	textureManager_->RequestScreenSize(textureHandle, screenPixels, GetElapsedSeconds());
+}
 
-	// 形状を設定
-	commands_->GetCommandList()->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+// モデルデータを読み込む
+uint32_t Engine::LoadModelData(const std::string& directory, const std::string& fileName)
+{
+	ProfileScope scope(startupProfiler_, "LoadModelData", "Model", directory + "/" + fileName);
 
-	// マテリアル用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	uint32_t modelNumber = modelManager_->LoadModelGetNumber(logStream_, directory, fileName, device_);
 
-	// 座標変換用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+	// 読み込み済みのモデルを共有したときは、テクスチャも読み込み済み
+	if (modelManager_->GetReferenceCount(modelNumber) > 1)
+		return modelNumber;
 
-	// テクスチャのCBVを設定する
-	textureManager_->SelectTexture(textureHandle, commands_->GetCommandList());
+	LoadModelTextures(modelNumber);
 
-	// 描画する
-	commands_->GetCommandList()->DrawInstanced(6, 1, 0, 0);
+	return modelNumber;
+}
 
-	
-	/*--------------------------------------
-	    使用していないリソースメモリに記録する
-	--------------------------------------*/
+// モデルのマテリアルごとにテクスチャを読み込む
+void Engine::LoadModelTextures(uint32_t modelNumber)
+{
+	// マテリアルごとにテクスチャを読み込む（同じテクスチャはTextureManagerが共有する）
+	const std::vector<MaterialData>& materialDatas = modelManager_->GetMaterialDatas(modelNumber);
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
+	for (uint32_t i = 0; i < materialDatas.size(); ++i)
 	{
-		if (resourceMemories[i] == nullptr)
+		// テクスチャの無いマテリアルは、白いテクスチャを使う
+		if (materialDatas[i].textureFilePath.empty())
 		{
-			resourceMemories[i] = vertexResource;
-			break;
+			modelManager_->SetTextureNumber(modelNumber, i, whiteTextureNumber_);
+			continue;
 		}
-	}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = materialResource;
-			break;
-		}
+		uint32_t textureNumber = textureManager_->LoadTextureGetNumber(logStream_, materialDatas[i].textureFilePath,
+			device_, srvDescriptorHeap_, commands_->GetCommandList());
+		modelManager_->SetTextureNumber(modelNumber, i, textureNumber);
 	}
+}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
+// モデルを読み込んだときに参照したテクスチャ（代わりに使っているものは除く）
+std::vector<uint32_t> Engine::GetModelTextureNumbers(uint32_t modelHandle)
+{
+	std::vector<uint32_t> textureNumbers;
+	const std::vector<MaterialData>& materialDatas = modelManager_->GetMaterialDatas(modelHandle);
+	for (uint32_t i = 0; i < materialDatas.size(); ++i)
 	{
-		if (resourceMemories[i] == nullptr)
+		if (materialDatas[i].textureFilePath.empty() == false)
 		{
-			resourceMemories[i] = transformationMatrixResource;
-			break;
+			textureNumbers.push_back(modelManager_->GetTextureNumber(modelHandle, i));
 		}
 	}
-}
 
+	return textureNumbers;
+}
 
-// スプライトを描画する
-void Engine::DrawSprite(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
-	const Transform3D& transform, const Matrix4x4& viewOrthograhpicsMatrix, uint32_t textureHandle)
+// モデルを解放する（他で共有していなければ、テクスチャも解放する）
+void Engine::UnloadModel(uint32_t modelHandle)
 {
-	// ビューポートの設定
-	commands_->GetCommandList()->RSSetViewports(1, &viewport_);
-
-	// シザーの設定
-	commands_->GetCommandList()->RSSetScissorRects(1, &scissorRect_);
-
-	// rootSignature
-	commands_->GetCommandList()->SetGraphicsRootSignature(rootSignature_);
-
-	// PSOの設定
-	commands_->GetCommandList()->SetPipelineState(graphicsPipelineState_.Get());
+	// 読み込んだときに参照したテクスチャ（代わりに使っているものは除く）
+	std::vector<uint32_t> textureNumbers = GetModelTextureNumbers(modelHandle);
 
+	if (modelManager_->ReleaseModel(modelHandle) == false)
+		return;
 
-	// インデックスリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource = CreateBufferResource(device_, sizeof(uint32_t) * 6);
-
-	// IBVを作成する
-	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
-	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
-	indexBufferView.SizeInBytes = sizeof(uint32_t) * 6;
-	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
-
-	// データを書き込む
-	uint32_t* indexData = nullptr;
-	indexResource->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
-	indexData[0] = 0; indexData[1] = 1; indexData[2] = 2;
-	indexData[3] = 1; indexData[4] = 3; indexData[5] = 2;
-
-
-
-	// 頂点リソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = CreateBufferResource(device_, sizeof(VertexData) * 4);
-
-	// VBVを作成する
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = sizeof(VertexData) * 4;
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
-
-	// データを書き込む
-	VertexData* vertexData = nullptr;
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	vertexData[0].position = { x3 , y3 , 0.0f , 1.0f };
-	vertexData[0].texcoord = { 0.0f , 1.0f };
-	vertexData[0].normal = { 0.0f , 0.0f , -1.0f };
-
-	vertexData[1].position = { x1 , y1 , 0.0f , 1.0f };
-	vertexData[1].texcoord = { 0.0f , 0.0f };
-	vertexData[1].normal = { 0.0f , 0.0f , -1.0f };
-
-	vertexData[2].position = { x4 , y4 , 0.0f , 1.0f };
-	vertexData[2].texcoord = { 1.0f , 1.0f };
-	vertexData[2].normal = { 0.0f , 0.0f , -1.0f };
-
-	vertexData[3].position = { x2 , y2 , 0.0f , 1.0f };
-	vertexData[3].texcoord = { 1.0f , 0.0f };
-	vertexData[3].normal = { 0.0f , 0.0f , -1.0f };
-
+	for (uint32_t textureNumber : textureNumbers)
+	{
+		textureManager_->ReleaseTexture(textureNumber);
+	}
+}
 
-	// マテリアル用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(device_, sizeof(Material));
+// アセットのアーカイブをマウントする（以降、アーカイブにあるファイルはそこから読み込む）
+bool Engine::MountAssetArchive(const std::string& filePath)
+{
+	ProfileScope scope(startupProfiler_, "MountAssetArchive", "Archive", filePath);
 
-	// データを書き込む
-	Material* materialData = nullptr;
-	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
+	AssetArchive* assetArchive = new AssetArchive();
 
-	Transform3D uvTransform = { {1.0f , 1.0f , 1.0f} , {0.0f , 0.0f , 0.0f} , {0.0f , 0.0f , 0.0f} };
+	if (assetArchive->Open(filePath) == false)
+	{
+		logger_.Write(LogLevel::Error, "MountAssetArchive : failed to open {}", filePath);
+		delete assetArchive;
+		return false;
+	}
 
-	materialData->color = { 1.0f , 1.0f , 1.0f , 1.0f };
-	materialData->enableLighting = false;
-	materialData->uvTransform = Multiply(Multiply(Make4x4ScaleMatrix(uvTransform.scale),
-		Make4x4RotateZMatrix(uvTransform.rotate.z)), Make4x4TranslateMatrix(uvTransform.translate));
+	AssetFile::MountArchive(assetArchive);
+	assetArchives_.push_back(assetArchive);
 
+	logger_.Write(LogLevel::Info, "MountAssetArchive : mounted {} ({} entries)", filePath, assetArchive->GetNumEntries());
 
-	// 座標変換用のリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource = CreateBufferResource(device_, sizeof(TransformationMatrix));
+	return true;
+}
 
-	// 行列に書き込む
-	TransformationMatrix* transformationMatrixData = nullptr;
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
-	transformationMatrixData->world = Make4x4AffineMatrix(transform.scale, transform.rotate, transform.translate);
-	transformationMatrixData->worldViewProjection = Multiply(transformationMatrixData->world, viewOrthograhpicsMatrix);
+// ディレクトリの中のファイルを、アセットのアーカイブにまとめる
+bool Engine::PackAssetArchive(const std::string& directoryPath, const std::string& archivePath, bool compress)
+{
+	bool isPacked = ::PackAssetArchive(directoryPath, archivePath, compress);
 
+	logger_.Write(isPacked ? LogLevel::Info : LogLevel::Error, "PackAssetArchive : {} {} -> {}", isPacked ? "packed" : "failed to pack", directoryPath, archivePath);
 
-	// IBVを設定する
-	commands_->GetCommandList()->IASetIndexBuffer(&indexBufferView);
+	return isPacked;
+}
 
-	// VBVを設定する
-	commands_->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+// ディレクトリとシェーダーのファイルの変更を監視し、変わったテクスチャ、モデル、シェーダーだけを読み込み直す
+bool Engine::EnableHotReload(const std::string& directoryPath)
+{
+	if (fileWatcher_ == nullptr)
+	{
+		fileWatcher_ = new FileWatcher();
 
-	// 形状を設定
-	commands_->GetCommandList()->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		if (fileWatcher_->AddDirectory(kShaderDirectory_) == false)
+		{
+			logger_.Write(LogLevel::Warning, "EnableHotReload : failed to watch {}", kShaderDirectory_);
+		}
+	}
 
-	// マテリアル用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	bool isWatching = fileWatcher_->AddDirectory(directoryPath);
 
-	// 座標変換用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+	logger_.Write(isWatching ? LogLevel::Info : LogLevel::Warning, "EnableHotReload : {} {}", isWatching ? "watching" : "failed to watch", directoryPath);
 
-	// テクスチャのCBVを設定する
-	textureManager_->SelectTexture(textureHandle, commands_->GetCommandList());
+	return isWatching;
+}
 
-	// 描画する
-	commands_->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
+// 変更されたファイルを使っているものだけを読み込み直す
+void Engine::UpdateHotReload()
+{
+	if (fileWatcher_ == nullptr)
+		return;
 
+	PROFILE_SCOPE("UpdateHotReload");
 
-	/*--------------------------------------
-		使用していないリソースメモリに記録する
-	--------------------------------------*/
+	bool isShaderChanged = false;
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
+	for (const std::string& filePath : fileWatcher_->Update(GetElapsedSeconds()))
 	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = indexResource;
-			break;
-		}
-	}
+		std::string extension = std::filesystem::path(filePath).extension().string();
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
+		// シェーダーは、インクルードしているファイルが変わっても全てコンパイルし直す
+		if (extension == ".hlsl" || extension == ".hlsli")
 		{
-			resourceMemories[i] = vertexResource;
-			break;
+			isShaderChanged = true;
+			continue;
 		}
-	}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
+		if (extension == ".obj" || extension == ".mtl")
 		{
-			resourceMemories[i] = materialResource;
-			break;
+			for (uint32_t modelNumber : modelManager_->FindModelsUsingFile(filePath))
+			{
+				ReloadModelData(modelNumber);
+			}
+
+			continue;
 		}
+
+		// それ以外はテクスチャとして、読み込み済みのものだけを読み込み直す
+		textureManager_->ReloadTexture(logStream_, filePath, device_, srvDescriptorHeap_, commands_->GetCommandList());
 	}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
+	if (isShaderChanged)
 	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = transformationMatrixResource;
-			break;
-		}
+		ReloadShaders();
 	}
 }
 
-// 球を描画する
-void Engine::DrawSphere(uint32_t subdivisions,const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
-	const DirectionalLight& light, uint32_t textureHandle)
+// モデルを読み込み直し、テクスチャを付け直す
+void Engine::ReloadModelData(uint32_t modelHandle)
 {
-	// ビューポートの設定
-	commands_->GetCommandList()->RSSetViewports(1, &viewport_);
-
-	// シザーの設定
-	commands_->GetCommandList()->RSSetScissorRects(1, &scissorRect_);
-
-	// rootSignature
-	commands_->GetCommandList()->SetGraphicsRootSignature(rootSignature_);
-
-	// PSOの設定
-	commands_->GetCommandList()->SetPipelineState(graphicsPipelineState_.Get());
-
-
-	// インデックスリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource = CreateBufferResource(device_, sizeof(uint32_t) * (subdivisions * subdivisions * 6));
+	// 前のマテリアルで参照していたテクスチャは、付け直してから手放す（同じテクスチャは解放されない）
+	std::vector<uint32_t> textureNumbers = GetModelTextureNumbers(modelHandle);
 
-	// IBVを作成する
-	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
-	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
-	indexBufferView.SizeInBytes = sizeof(uint32_t) * (subdivisions * subdivisions * 6);
-	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	if (modelManager_->ReloadModel(logStream_, modelHandle, device_) == false)
+		return;
 
-	// データを書き込む
-	uint32_t* indexData = nullptr;
-	indexResource->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	LoadModelTextures(modelHandle);
 
-	for (uint32_t latIndex = 0; latIndex < subdivisions; ++latIndex)
+	for (uint32_t textureNumber : textureNumbers)
 	{
-		for (uint32_t lonIndex = 0; lonIndex < subdivisions; ++lonIndex)
-		{
-			// 要素数
-			uint32_t index = (latIndex * subdivisions + lonIndex) * 6;
-
-			// 頂点の要素数
-			uint32_t vertexIndex = (latIndex * subdivisions + lonIndex) * 4;
-
-			indexData[index + 0] = vertexIndex + 0;
-			indexData[index + 1] = vertexIndex + 1;
-			indexData[index + 2] = vertexIndex + 2;
-			indexData[index + 3] = vertexIndex + 2;
-			indexData[index + 4] = vertexIndex + 1;
-			indexData[index + 5] = vertexIndex + 3;
-		}
+		textureManager_->ReleaseTexture(textureNumber);
 	}
+}
 
+// シェーダーをコンパイルし直してPSOを差し替える（失敗したら前のものを使い続ける）
+void Engine::ReloadShaders()
+{
+	std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>> graphicsPipelineStates;
 
-	// 頂点リソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = CreateBufferResource(device_, sizeof(VertexData) * (subdivisions * subdivisions * 4));
-
-	// VBVを作成する
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = sizeof(VertexData) * (subdivisions * subdivisions * 4);
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
-
-	// データを書き込む
-	VertexData* vertexData = nullptr;
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	
-	// 経度分割1つ分の角度φ
-	const float kLonEvery = float(M_PI) * 2.0f / static_cast<float>(subdivisions);
-
-	// 緯度分割1つ分の角度Θ
-	const float kLatEvery = float(M_PI) / static_cast<float>(subdivisions);
-
-	// 緯度の方向に分割
-	for (uint32_t latIndex = 0; latIndex < subdivisions; ++latIndex)
+	if (BuildGraphicsPipelineStates(graphicsPipelineStates) == false)
 	{
-		// 現在の緯度
-		float lat = -float(M_PI) / 2.0f + kLatEvery * latIndex;
-
-		// 経度の方向に分割
-		for (uint32_t lonIndex = 0; lonIndex < subdivisions; ++lonIndex)
-		{
-			// 現在の経度
-			float lon = lonIndex * kLonEvery;
-
-			// 要素数
-			uint32_t index = (latIndex * subdivisions + lonIndex) * 4;
-
-			vertexData[index].position.x = std::cos(lat) * std::cos(lon);
-			vertexData[index].position.y = std::sin(lat);
-			vertexData[index].position.z = std::cos(lat) * std::sin(lon);
-			vertexData[index].position.w = 1.0f;
-			vertexData[index].texcoord.x = static_cast<float>(lonIndex) / static_cast<float>(subdivisions);
-			vertexData[index].texcoord.y = 1.0f - static_cast<float>(latIndex) / static_cast<float>(subdivisions);
-			vertexData[index].normal.x = vertexData[index].position.x;
-			vertexData[index].normal.y = vertexData[index].position.y;
-			vertexData[index].normal.z = vertexData[index].position.z;
-
-			vertexData[index + 1].position.x = std::cos(lat + kLatEvery) * std::cos(lon);
-			vertexData[index + 1].position.y = std::sin(lat + kLatEvery);
-			vertexData[index + 1].position.z = std::cos(lat + kLatEvery) * std::sin(lon);
-			vertexData[index + 1].position.w = 1.0f;
-			vertexData[index + 1].texcoord.x = static_cast<float>(lonIndex) / static_cast<float>(subdivisions);
-			vertexData[index + 1].texcoord.y = 1.0f - static_cast<float>(latIndex + 1) / static_cast<float>(subdivisions);
-			vertexData[index + 1].normal.x = vertexData[index + 1].position.x;
-			vertexData[index + 1].normal.y = vertexData[index + 1].position.y;
-			vertexData[index + 1].normal.z = vertexData[index + 1].position.z;
-
-			vertexData[index + 2].position.x = std::cos(lat) * std::cos(lon + kLonEvery);
-			vertexData[index + 2].position.y = std::sin(lat);
-			vertexData[index + 2].position.z = std::cos(lat) * std::sin(lon + kLonEvery);
-			vertexData[index + 2].position.w = 1.0f;
-			vertexData[index + 2].texcoord.x = static_cast<float>(lonIndex + 1) / static_cast<float>(subdivisions);
-			vertexData[index + 2].texcoord.y = 1.0f - static_cast<float>(latIndex) / static_cast<float>(subdivisions);
-			vertexData[index + 2].normal.x = vertexData[index + 2].position.x;
-			vertexData[index + 2].normal.y = vertexData[index + 2].position.y;
-			vertexData[index + 2].normal.z = vertexData[index + 2].position.z;
-
-			vertexData[index + 3].position.x = std::cos(lat + kLatEvery) * std::cos(lon + kLonEvery);
-			vertexData[index + 3].position.y = std::sin(lat + kLatEvery);
-			vertexData[index + 3].position.z = std::cos(lat + kLatEvery) * std::sin(lon + kLonEvery);
-			vertexData[index + 3].position.w = 1.0f;
-			vertexData[index + 3].texcoord.x = static_cast<float>(lonIndex + 1) / static_cast<float>(subdivisions);
-			vertexData[index + 3].texcoord.y = 1.0f - static_cast<float>(latIndex + 1) / static_cast<float>(subdivisions);
-			vertexData[index + 3].normal.x = vertexData[index + 3].position.x;
-			vertexData[index + 3].normal.y = vertexData[index + 3].position.y;
-			vertexData[index + 3].normal.z = vertexData[index + 3].position.z;
-		}
+		logger_.WriteMessage(LogLevel::Warning, "ReloadShaders : failed , keep using the previous pipeline");
+		return;
 	}
 
+	// 古いPSOは、このフレームのコマンドが使っているかもしれないので、次のフレームまで残す
+	for (const auto& pipelineState : graphicsPipelineStates_)
+	{
+		retiredPipelineStates_.push_back(pipelineState.second);
+	}
 
-	// マテリアル用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(device_, sizeof(Material));
-
-	// マテリアルに書き込むデータ
-	Material* materialData = nullptr;
-	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
-
-	Transform3D uvTransform = { {1.0f , 1.0f , 1.0f} , {0.0f , 0.0f , 0.0f} , {0.0f , 0.0f , 0.0f} };
-
-	materialData->color = { 1.0f , 1.0f , 1.0f , 1.0f };
-	materialData->enableLighting = true;
-	materialData->uvTransform = Multiply(Multiply(Make4x4ScaleMatrix(uvTransform.scale),
-		Make4x4RotateZMatrix(uvTransform.rotate.z)), Make4x4TranslateMatrix(uvTransform.translate));
-
-
-	// 座標変換用のリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource = CreateBufferResource(device_, sizeof(TransformationMatrix));
-
-	// 行列に書き込む
-	TransformationMatrix* transformationMatrixData = nullptr;
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
-	transformationMatrixData->world = Make4x4AffineMatrix(transform.scale, transform.rotate, transform.translate);
-	transformationMatrixData->worldViewProjection = Multiply(transformationMatrixData->world, viewProjectionMatrix);
-
-
-	// 平行光源用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource = CreateBufferResource(device_, sizeof(DirectionalLight));
-
-	// データを書き込む
-	DirectionalLight* directionalLightData = nullptr;
-	directionalLightResource->Map(0, nullptr, reinterpret_cast<void**>(&directionalLightData));
-	directionalLightData->color = light.color;
-	directionalLightData->direction = light.direction;
-	directionalLightData->intensity = light.intensity;
-
-
-	// IBVを設定する
-	commands_->GetCommandList()->IASetIndexBuffer(&indexBufferView);
-
-	// VBVを設定する
-	commands_->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
-
-	// 形状を設定
-	commands_->GetCommandList()->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	graphicsPipelineStates_ = std::move(graphicsPipelineStates);
 
-	// マテリアル用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	logger_.Write(LogLevel::Info, "ReloadShaders : pipeline replaced ({} variants)", graphicsPipelineStates_.size());
+}
 
-	// 座標変換用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+// フレームの計測のウィンドウを描画する（BeginFrameとEndFrameの間で呼ぶ）
+void Engine::DrawFrameProfiler()
+{
+	FrameProfiler::DrawWindow(logFileStem_);
+}
 
-	// 平行光源用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
+// メモリの使用量のウィンドウを描画する（BeginFrameとEndFrameの間で呼ぶ）
+void Engine::DrawMemoryTracker()
+{
+	UpdateVideoMemoryInfo();
+	MemoryTracker::DrawWindow(logFileStem_);
+}
 
-	// テクスチャのCBVを設定する
-	textureManager_->SelectTexture(textureHandle, commands_->GetCommandList());
+// 用途ごとのメモリの予算を設定する（超えたらログに書き出す。0なら制限しない）
+void Engine::SetMemoryBudget(MemoryCategory category, MemoryHeap heap, uint64_t bytes)
+{
+	MemoryTracker::SetBudgetBytes(category, heap, bytes);
+}
 
-	// 描画する
-	commands_->GetCommandList()->DrawIndexedInstanced(subdivisions * subdivisions * 6, 1, 0, 0 , 0);
+// バッファとテクスチャを置くヒープの、使っている大きさと断片化の度合いを取得する
+GpuMemoryPoolStats Engine::GetGpuMemoryPoolStats(GpuMemoryPool pool)
+{
+	return memoryAllocator_->GetPoolStats(pool);
+}
 
+// OSから見たVRAMの予算と使用量を問い合わせる
+GpuMemoryBudget Engine::QueryGpuMemoryBudget()
+{
+	return memoryAllocator_->QueryBudget();
+}
 
-	/*--------------------------------------
-		使用していないリソースメモリに記録する
-	--------------------------------------*/
+// OSから見たVRAMの予算と使用量を、メモリの記録に渡す
+void Engine::UpdateVideoMemoryInfo()
+{
+	if (memoryAllocator_ == nullptr)
+		return;
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
+	GpuMemoryBudget budget = memoryAllocator_->QueryBudget();
+	if (budget.budget > 0)
 	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = indexResource;
-			break;
-		}
+		MemoryTracker::SetVideoMemoryInfo(budget.budget, budget.currentUsage);
 	}
+}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = vertexResource;
-			break;
-		}
-	}
+// サウンドデータを読み込む
+uint32_t Engine::LoadSound(const char* fileName)
+{
+	ProfileScope scope(startupProfiler_, "LoadSound", "Sound", fileName);
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = materialResource;
-			break;
-		}
-	}
+	return sound_->LoadSoundGetNumber(fileName);
+}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = transformationMatrixResource;
-			break;
-		}
-	}
+// サウンドデータを再生する
+void Engine::PlayerSoundWav(uint32_t soundHandle)
+{
+	sound_->SelectNumberPlaySoundWav(soundHandle);
+}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = directionalLightResource;
-			break;
-		}
-	}
+// サウンドデータの、同時に鳴らす数の上限と優先度を設定する
+void Engine::SetSoundPlayback(uint32_t soundHandle, uint32_t maxInstances, int32_t priority)
+{
+	sound_->SetSoundPlayback(soundHandle, maxInstances, priority);
 }
 
-// モデルを描画する
-void Engine::DrawModel(uint32_t modelHandle ,Transform3D& transform, const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light)
+// 使い回しているボイスの数を取得する
+VoicePoolStats Engine::GetVoicePoolStats()
 {
-	// ビューポートの設定
-	commands_->GetCommandList()->RSSetViewports(1, &viewport_);
+	return sound_->GetVoicePoolStats();
+}
 
-	// シザーの設定
-	commands_->GetCommandList()->RSSetScissorRects(1, &scissorRect_);
+// .wavを全て読み込まずに、少しずつ読み込みながら再生する
+uint32_t Engine::PlayStreamWav(const char* fileName, bool isLoop)
+{
+	return sound_->PlayStreamWav(fileName, isLoop);
+}
 
-	// rootSignature
-	commands_->GetCommandList()->SetGraphicsRootSignature(rootSignature_);
+// 流しているストリームを止める
+void Engine::StopStreamWav(uint32_t streamHandle)
+{
+	sound_->StopStreamWav(streamHandle);
+}
 
-	// PSOの設定
-	commands_->GetCommandList()->SetPipelineState(graphicsPipelineState_.Get());
+// キー操作（Press）
+UINT Engine::PushPressKeys(BYTE key)
+{
+	return input_->PressKeys(key);
+}
 
+// キー操作（Trigger）
+UINT Engine::PushTriggerKeys(BYTE key)
+{
+	return input_->TriggerKeys(key);
+}
 
-	// 頂点リソースを作成する
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = 
-		CreateBufferResource(device_,UINT(sizeof(VertexData) * modelManager_->GetModelData(modelHandle).vertices.size()));
-	
-	// VBVを設定する
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * modelManager_->GetModelData(modelHandle).vertices.size());
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
-
-	// 頂点リソースにデータを書き込む
-	VertexData* vertexData = nullptr;
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	std::memcpy(vertexData, modelManager_->GetModelData(modelHandle).vertices.data(),
-		sizeof(VertexData) * modelManager_->GetModelData(modelHandle).vertices.size());
-	
+// キー操作（Release）
+UINT Engine::PushReleaseKeys(BYTE key)
+{
+	return input_->ReleaseKeys(key);
+}
 
+// 三角形を描画する
+void Engine::DrawTriangle(struct Transform3D& transform,const Matrix4x4& viewProjectionMatrix, uint32_t textureHandle, Vector3 color)
+{
+	PROFILE_SCOPE("DrawTriangle");
 
-	// マテリアル用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(device_, sizeof(Material));
+	Matrix4x4 worldViewProjectionMatrix = RecordTriangle(*renderDevice_, GetDrawPass(false), transform, viewProjectionMatrix, color,
+		textureManager_->GetDescriptorHandle(textureHandle));
 
-	// マテリアルに書き込むデータ
-	Material* materialData = nullptr;
-	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
+	// 画面上の大きさを基に、ストリーミングするミップを要求する
+	Vector3 screenPoints[3] = { { 0.0f , 0.5f , 0.0f } , { 0.5f , -0.5f , 0.0f } , { -0.5f , -0.5f , 0.0f } };
+	RequestTextureScreenSize(textureHandle, MeasureScreenSize(screenPoints, 3, worldViewProjectionMatrix));
+}
 
-	Transform3D uvTransform = { {1.0f , 1.0f , 1.0f} , {0.0f , 0.0f , 0.0f} , {0.0f , 0.0f , 0.0f} };
 
-	materialData->color = { 1.0f , 1.0f , 1.0f , 1.0f };
-	materialData->enableLighting = true;
-	materialData->uvTransform = Multiply(Multiply(Make4x4ScaleMatrix(uvTransform.scale),
-		Make4x4RotateZMatrix(uvTransform.rotate.z)), Make4x4TranslateMatrix(uvTransform.translate));
+// スプライトを描画する
+void Engine::DrawSprite(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+	const Transform3D& transform, const Matrix4x4& viewOrthograhpicsMatrix, uint32_t textureHandle)
+{
+	// テクスチャ全体を1つの領域として描画する
+	SpriteRegion sprite = { textureHandle , { 0.0f , 0.0f } , { 1.0f , 1.0f } };
+	DrawSprite(x1, y1, x2, y2, x3, y3, x4, y4, transform, viewOrthograhpicsMatrix, sprite);
+}
 
+// スプライトを描画する（アトラスの領域を使う）
+void Engine::DrawSprite(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+	const Transform3D& transform, const Matrix4x4& viewOrthograhpicsMatrix, const SpriteRegion& sprite)
+{
+	PROFILE_SCOPE("DrawSprite");
 
-	// 座標変換用のリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource = CreateBufferResource(device_, sizeof(TransformationMatrix));
+	Vector2 corners[4] = { { x1 , y1 } , { x2 , y2 } , { x3 , y3 } , { x4 , y4 } };
+	Matrix4x4 worldViewProjectionMatrix = RecordSprite(*renderDevice_, GetDrawPass(false), corners, transform, viewOrthograhpicsMatrix,
+		sprite, textureManager_->GetDescriptorHandle(sprite.textureHandle));
 
-	// 行列に書き込む
-	TransformationMatrix* transformationMatrixData = nullptr;
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
-	transformationMatrixData->world = Make4x4AffineMatrix(transform.scale, transform.rotate, transform.translate);
-	transformationMatrixData->worldViewProjection = Multiply(transformationMatrixData->world, viewProjectionMatrix);
+	// 画面上の大きさを基に、ストリーミングするミップを要求する
+	Vector3 screenPoints[4] = { { x1 , y1 , 0.0f } , { x2 , y2 , 0.0f } , { x3 , y3 , 0.0f } , { x4 , y4 , 0.0f } };
+	RequestTextureScreenSize(sprite.textureHandle, MeasureScreenSize(screenPoints, 4, worldViewProjectionMatrix));
+}
 
+// 球を描画する
+void Engine::DrawSphere(uint32_t subdivisions,const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
+	const DirectionalLight& light, uint32_t textureHandle)
+{
+	PROFILE_SCOPE("DrawSphere");
 
-	// 平行光源用のリソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource = CreateBufferResource(device_, sizeof(DirectionalLight));
+	Matrix4x4 worldViewProjectionMatrix = RecordSphere(*renderDevice_, GetDrawPass(true), subdivisions, transform, viewProjectionMatrix,
+		light, textureManager_->GetDescriptorHandle(textureHandle));
 
-	// データを書き込む
-	DirectionalLight* directionalLightData = nullptr;
-	directionalLightResource->Map(0, nullptr, reinterpret_cast<void**>(&directionalLightData));
-	directionalLightData->color = light.color;
-	directionalLightData->direction = light.direction;
-	directionalLightData->intensity = light.intensity;
+	// 画面上の大きさを基に、ストリーミングするミップを要求する
+	Vector3 screenPoints[6] = { { 1.0f , 0.0f , 0.0f } , { -1.0f , 0.0f , 0.0f } , { 0.0f , 1.0f , 0.0f } ,
+		{ 0.0f , -1.0f , 0.0f } , { 0.0f , 0.0f , 1.0f } , { 0.0f , 0.0f , -1.0f } };
+	RequestTextureScreenSize(textureHandle, MeasureScreenSize(screenPoints, 6, worldViewProjectionMatrix));
+}
 
+// モデルを描画する
+void Engine::DrawModel(uint32_t modelHandle ,Transform3D& transform, const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light)
+{
+	PROFILE_SCOPE("DrawModel");
 
+	// サブメッシュごとに、マテリアルのテクスチャを引く
+	const std::vector<SubMesh>& subMeshes = modelManager_->GetSubMeshes(modelHandle);
 
-	// VBVを設定する
-	commands_->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+	modelTextureDescriptors_.clear();
+	for (const SubMesh& subMesh : subMeshes)
+	{
+		uint32_t textureNumber = modelManager_->GetTextureNumber(modelHandle, subMesh.materialIndex);
+		modelTextureDescriptors_.push_back(textureManager_->GetDescriptorHandle(textureNumber));
+	}
 
-	// 形状を設定
-	commands_->GetCommandList()->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// 読み込み時に作ったVBVとIBV
+	const D3D12_VERTEX_BUFFER_VIEW& vertexBufferView = modelManager_->GetVertexBufferView(modelHandle);
+	const D3D12_INDEX_BUFFER_VIEW& indexBufferView = modelManager_->GetIndexBufferView(modelHandle);
+	RenderVertexBufferView vertexBuffer = { vertexBufferView.BufferLocation , vertexBufferView.SizeInBytes , vertexBufferView.StrideInBytes };
+	RenderIndexBufferView indexBuffer = { indexBufferView.BufferLocation , indexBufferView.SizeInBytes };
 
-	// マテリアル用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	Matrix4x4 worldViewProjectionMatrix = RecordModel(*renderDevice_, GetDrawPass(true), vertexBuffer, indexBuffer,
+		subMeshes, modelTextureDescriptors_, transform, viewProjectionMatrix, light);
 
-	// 座標変換用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+	// 画面上の大きさを基に、ストリーミングするミップを要求する（境界ボックスの8つの角を使う）
+	const MeshBounds& bounds = modelManager_->GetBounds(modelHandle);
+	Vector3 screenPoints[8];
+	for (uint32_t corner = 0; corner < 8; ++corner)
+	{
+		screenPoints[corner].x = (corner & 1) ? bounds.max.x : bounds.min.x;
+		screenPoints[corner].y = (corner & 2) ? bounds.max.y : bounds.min.y;
+		screenPoints[corner].z = (corner & 4) ? bounds.max.z : bounds.min.z;
+	}
+	float screenSize = MeasureScreenSize(screenPoints, 8, worldViewProjectionMatrix);
 
-	// 平行光源用のCBVを設定する
-	commands_->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
+	for (const SubMesh& subMesh : subMeshes)
+	{
+		RequestTextureScreenSize(modelManager_->GetTextureNumber(modelHandle, subMesh.materialIndex), screenSize);
+	}
+}
 
-	// テクスチャのCBVを設定する
-	textureManager_->SelectTexture(modelManager_->GetTextureNumber(modelHandle), commands_->GetCommandList());
+// 起動してからの経過時間（秒）
+double Engine::GetElapsedSeconds()
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime_;
+	return elapsed.count();
+}
 
-	// 描画する
-	commands_->GetCommandList()->DrawInstanced(UINT(modelManager_->GetModelData(modelHandle).vertices.size()), 1, 0, 0);
+// 点群を画面に投影したときの大きさ（ピクセル）を求める
+float Engine::MeasureScreenSize(const Vector3* points, uint32_t numPoints, const Matrix4x4& worldViewProjectionMatrix)
+{
+	// 正規化デバイス座標での範囲
+	Vector2 min = { (std::numeric_limits<float>::max)() , (std::numeric_limits<float>::max)() };
+	Vector2 max = { -(std::numeric_limits<float>::max)() , -(std::numeric_limits<float>::max)() };
 
+	for (uint32_t i = 0; i < numPoints; ++i)
+	{
+		const Vector3& p = points[i];
+		const Matrix4x4& m = worldViewProjectionMatrix;
 
-	/*--------------------------------------
-		使用していないリソースメモリに記録する
-	--------------------------------------*/
+		float w = p.x * m.m[0][3] + p.y * m.m[1][3] + p.z * m.m[2][3] + m.m[3][3];
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
+		// カメラの後ろにある点は、画面を覆うものとして扱う
+		if (w <= 0.0f)
 		{
-			resourceMemories[i] = vertexResource;
-			break;
+			return (std::max)(viewport_.Width, viewport_.Height);
 		}
-	}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = materialResource;
-			break;
-		}
-	}
+		float x = (p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0]) / w;
+		float y = (p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1]) / w;
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = transformationMatrixResource;
-			break;
-		}
+		min.x = (std::min)(min.x, x);
+		min.y = (std::min)(min.y, y);
+		max.x = (std::max)(max.x, x);
+		max.y = (std::max)(max.y, y);
 	}
 
-	for (uint32_t i = 0; i < kNumResourceMemories; i++)
-	{
-		if (resourceMemories[i] == nullptr)
-		{
-			resourceMemories[i] = directionalLightResource;
-			break;
-		}
-	}
+	// ピクセルに変換し、長い方の辺を大きさとする
+	float width = (max.x - min.x) * 0.5f * viewport_.Width;
+	float height = (max.y - min.y) * 0.5f * viewport_.Height;
+
+	return (std::max)(width, height);
 }
\ No newline at end of file
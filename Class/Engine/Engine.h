@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <fstream>
 #include <chrono>
+#include <limits>
+#include <unordered_map>
 #include "Struct.h"
 #include "Class/Window/Window.h"
 #include "Class/ErrorDetection/ErrorDetection.h"
@@ -15,6 +17,7 @@
 #include "Class/Sound/Sound.h"
 #include "Class/Input/Input.h"
 #include "Class/ModelManager/ModelManager.h"
+#include "Class/SpriteAtlas/SpriteAtlas.h"
 #include "Func/StringInfo/StringInfo.h"
 #include "Func/Matrix/Matrix.h"
 #include "Func/Create/Create.h"
@@ -23,6 +26,20 @@
 #include "Func/Crash/Crash.h"
 #include "Func/Texture/Texture.h"
 #include "Func/ModelData/ModelData.h"
+#include "Func/MeshFile/MeshFile.h"
+#include "Func/ObjParser/ObjParser.h"
+#include "Func/AssetPacker/AssetPacker.h"
+#include "Class/AssetArchive/AssetArchive.h"
+#include "Class/AssetFile/AssetFile.h"
+#include "Class/FileWatcher/FileWatcher.h"
+#include "Class/StartupProfiler/StartupProfiler.h"
+#include "Class/FrameProfiler/FrameProfiler.h"
+#include "Class/MemoryTracker/MemoryTracker.h"
+#include "Class/Logger/Logger.h"
+#include "Class/RenderDevice/D3D12RenderDevice/D3D12RenderDevice.h"
+#include "Class/GpuMemoryAllocator/GpuMemoryAllocator.h"
+#include "Func/DrawRecord/DrawRecord.h"
+#include "Class/RenderGraph/RenderGraph.h"
 
 class Engine
 {
@@ -46,15 +63,72 @@ public:
 	// テクスチャを読み込む
 	uint32_t LoadTexture(const std::string& filePath);
 
+	// テクスチャを解放する（同じテクスチャを読み込んだ全ての場所で解放したら、GPUが使い終わってから解放する）
+	void UnloadTexture(uint32_t textureHandle);
+
+	// テクスチャを読み込む（粗いミップから表示し、細かいミップは後のフレームで転送する）
+	uint32_t LoadTextureStreaming(const std::string& filePath);
+
+	// テクスチャを画面上で表示する大きさ（ピクセル）を要求する
+	void RequestTextureScreenSize(uint32_t textureHandle, float screenPixels);
+
+	// テクスチャのブロック圧縮のフォーマットを設定する（DXGI_FORMAT_UNKNOWNなら圧縮しない、fastCompressionならBC7を高速に圧縮する）
+	void SetTextureCompression(DXGI_FORMAT compressFormat, bool fastCompression);
+
+	// 複数のスプライト画像をアトラスに詰めて読み込む（戻り値は画像ごとの領域）
+	std::vector<SpriteRegion> LoadSpriteAtlas(const std::vector<std::string>& filePaths);
+
 	// モデルデータを読み込む
 	uint32_t LoadModelData(const std::string& directory, const std::string& fileName);
 
+	// モデルを解放する（他で共有していなければ、テクスチャも解放する）
+	void UnloadModel(uint32_t modelHandle);
+
+	// ログに書き出す最低の重要度を設定する（低いものは書き込む前に捨てる）
+	void SetLogLevel(LogLevel minLevel) { logger_.SetMinLevel(minLevel); }
+
+	// アセットのアーカイブをマウントする（以降、アーカイブにあるファイルはそこから読み込む）
+	bool MountAssetArchive(const std::string& filePath);
+
+	// ディレクトリの中のファイルを、アセットのアーカイブにまとめる（compressなら小さくなるものをLZ4で圧縮する）
+	bool PackAssetArchive(const std::string& directoryPath, const std::string& archivePath, bool compress);
+
+	// ディレクトリとシェーダーのファイルの変更を監視し、変わったテクスチャ、モデル、シェーダーだけを読み込み直す（番号はそのまま使える）
+	bool EnableHotReload(const std::string& directoryPath);
+
+	// フレームの計測のウィンドウを描画する（BeginFrameとEndFrameの間で呼ぶ）
+	void DrawFrameProfiler();
+
+	// メモリの使用量のウィンドウを描画する（BeginFrameとEndFrameの間で呼ぶ）
+	void DrawMemoryTracker();
+
+	// 用途ごとのメモリの予算を設定する（超えたらログに書き出す。0なら制限しない）
+	void SetMemoryBudget(MemoryCategory category, MemoryHeap heap, uint64_t bytes);
+
+	// バッファとテクスチャを置くヒープの、使っている大きさと断片化の度合いを取得する
+	GpuMemoryPoolStats GetGpuMemoryPoolStats(GpuMemoryPool pool);
+
+	// OSから見たVRAMの予算と使用量を問い合わせる
+	GpuMemoryBudget QueryGpuMemoryBudget();
+
 	// サウンドデータを読み込む
 	uint32_t LoadSound(const char* fileName);
 
 	// サウンドデータを再生する
 	void PlayerSoundWav(uint32_t soundHandle);
 
+	// サウンドデータの、同時に鳴らす数の上限（0なら上限なし）と優先度を設定する
+	void SetSoundPlayback(uint32_t soundHandle, uint32_t maxInstances, int32_t priority);
+
+	// 使い回しているボイスの数を取得する
+	VoicePoolStats GetVoicePoolStats();
+
+	// .wavを全て読み込まずに、少しずつ読み込みながら再生する（BGMなどの長いもの向け）
+	uint32_t PlayStreamWav(const char* fileName, bool isLoop);
+
+	// 流しているストリームを止める
+	void StopStreamWav(uint32_t streamHandle);
+
 	// キー操作（Press）
 	UINT PushPressKeys(BYTE key);
 
@@ -71,6 +145,10 @@ public:
 	void DrawSprite(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
 		const Transform3D& transform, const Matrix4x4& viewOrthograhpicsMatrix,uint32_t textureHandle);
 
+	// スプライトを描画する（アトラスの領域を使う）
+	void DrawSprite(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+		const Transform3D& transform, const Matrix4x4& viewOrthograhpicsMatrix, const SpriteRegion& sprite);
+
 	// 球を描画する
 	void DrawSphere(uint32_t subdivisions,const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
 		const DirectionalLight& light, uint32_t textureHandle);
@@ -81,10 +159,66 @@ public:
 
 private:
 
+	// 起動してからの経過時間（秒）
+	double GetElapsedSeconds();
+
+	// 起動処理の計測を終え、レポートをログに、トレースをJSONに書き出す
+	void FinishStartupProfile();
+
+	// OSから見たVRAMの予算と使用量を、メモリの記録に渡す
+	void UpdateVideoMemoryInfo();
+
+	// シェーダーから、描画の設定を全て詰め込んだPSOを作る（作れなければnullptr）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> CreateGraphicsPipelineState(IDxcBlob* vertexShaderBlob, IDxcBlob* pixelShaderBlob);
+
+	// シェーダーのバリアントを全てコンパイルし、バリアントのキーごとのPSOを作る（1つでも失敗したらfalse）
+	bool BuildGraphicsPipelineStates(std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>>& pipelineStates);
+
+	// マテリアルの設定に合ったPSOを取得する
+	ID3D12PipelineState* SelectPipelineState(bool enableLighting);
+
+	// 描画に共通の設定を取得する
+	DrawPass GetDrawPass(bool enableLighting);
+
+	// モデルのマテリアルごとにテクスチャを読み込む
+	void LoadModelTextures(uint32_t modelNumber);
+
+	// モデルを読み込んだときに参照したテクスチャ（代わりに使っているものは除く）
+	std::vector<uint32_t> GetModelTextureNumbers(uint32_t modelHandle);
+
+	// 変更されたファイルを使っているものだけを読み込み直す
+	void UpdateHotReload();
+
+	// モデルを読み込み直し、テクスチャを付け直す
+	void ReloadModelData(uint32_t modelHandle);
+
+	// シェーダーをコンパイルし直してPSOを差し替える（失敗したら前のものを使い続ける）
+	void ReloadShaders();
+
+	// 点群を画面に投影したときの大きさ（ピクセル）を求める
+	float MeasureScreenSize(const Vector3* points, uint32_t numPoints, const Matrix4x4& worldViewProjectionMatrix);
+
+
 	// リークチェッカー
 	D3DResourceLeakChecker leakChecker;
 
 
+	// 起動した時刻
+	std::chrono::steady_clock::time_point startTime_{};
+
+	// ログ（別のスレッドがまとめてファイルに書き出す）
+	Logger logger_;
+
+	// ログに1行ずつ書き込むストリーム（os を受け取る関数に渡す）
+	LogStream logStream_{ logger_ };
+
+	// 起動処理の計測（最初のフレームを表示するまで）
+	StartupProfiler* startupProfiler_ = nullptr;
+
+	// ログファイルのパスから拡張子を除いたもの（トレースなどは、これに付け足した名前で書き出す）
+	std::string logFileStem_;
+
+
 	// ウィンドウ
 	Window* window_;
 
@@ -109,6 +243,16 @@ private:
 	// コマンド
 	Commands* commands_;
 
+	// バッファとテクスチャを切り分けて置くヒープ
+	GpuMemoryAllocator* memoryAllocator_ = nullptr;
+
+	// 描画のコマンドを積む先（描画ごとのバッファは、フレームの終わりに解放する）
+	RenderDevice* renderDevice_ = nullptr;
+
+	// フレームのパス（BeginFrameでシーンのパスまで実行し、EndFrameで残りを実行する）
+	RenderGraph renderGraph_;
+	uint32_t scenePass_ = 0;
+
 
 	// RTVのディスクリプタの数
 	const UINT kNumRtvDescriptor_ = 2;
@@ -151,20 +295,34 @@ private:
 	Fence* fence_;
 
 
-	// リソースを保存する場所
-	const uint32_t kNumResourceMemories = 1024;
-	Microsoft::WRL::ComPtr<ID3D12Resource> resourceMemories[1024] = { nullptr };
-
-
 	// テクスチャマネージャ
 	TextureManager* textureManager_;
 
+	// テクスチャの無いマテリアルに使う、白いテクスチャ（Initializeで1度だけ読み込む）
+	const std::string kWhiteTextureFilePath_ = "Resources/Textures/white.png";
+	uint32_t whiteTextureNumber_ = 0;
+
+	// スプライトのアトラスのページの大きさ
+	const uint32_t kSpriteAtlasPageSize_ = 2048;
+
+	// スプライトの周りに広げる余白（ミップ2段分）
+	const uint32_t kSpriteAtlasPadding_ = 4;
+
 	// モデルマネージャ
 	ModelManager* modelManager_;
 
+	// モデルを描画するときの、サブメッシュごとのテクスチャのディスクリプタ（毎回確保しないように使い回す）
+	std::vector<RenderHandle> modelTextureDescriptors_;
+
 	// サウンド
 	Sound* sound_;
 
+	// マウントしたアセットのアーカイブ
+	std::vector<AssetArchive*> assetArchives_;
+
+	// ファイルの変更の監視（ホットリロードを使うときだけ作る）
+	FileWatcher* fileWatcher_ = nullptr;
+
 
 	// シェーダー
 	Shader* shader_;
@@ -176,19 +334,28 @@ private:
 	// ルートシグネチャ
 	ID3D12RootSignature* rootSignature_ = nullptr;
 
-	// 頂点シェーダのバイナリデータ
-	IDxcBlob* vertexShaderBlob_ = nullptr;
+	// シェーダーのファイル
+	const std::string kShaderDirectory_ = "Class/Engine/Shader";
+	const wchar_t* kVertexShaderPath_ = L"./Class/Engine/Shader/Object3D.VS.hlsl";
+	const wchar_t* kPixelShaderPath_ = L"./Class/Engine/Shader/Object3D.PS.hlsl";
+
+	// ピクセルシェーダーのキーワードのグループ（グループごとに1つ選んだ組み合わせを、バリアントとしてコンパイルする）
+	const std::vector<std::vector<std::string>> kPixelShaderKeywords_ = { { "" , "LIGHTING_HALF_LAMBERT" } };
+
+	// バリアントのキーからPSOを引く表
+	std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>> graphicsPipelineStates_;
 
-	// ピクセルシェーダーのバイナリデータ
-	IDxcBlob* pixelShaderBlob_ = nullptr;
+	// ライティングの有無ごとのバリアントのキー
+	uint32_t unlitVariantKey_ = 0;
+	uint32_t litVariantKey_ = 0;
 
-	// PSO
-	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_ = nullptr;
+	// 差し替えて、GPUの完了を待っているPSO
+	std::vector<Microsoft::WRL::ComPtr<ID3D12PipelineState>> retiredPipelineStates_;
 
 	// ビューポート
-	D3D12_VIEWPORT viewport_{};
+	RenderViewport viewport_{};
 
 	// シザーレクト
-	D3D12_RECT scissorRect_{};
+	RenderRect scissorRect_{};
 };
 
@@ -0,0 +1,141 @@
+#include "AliasingPlan.h"
+
+/// <summary>
+/// 値を揃えに切り上げる
+/// </summary>
+/// <param name="value">値</param>
+/// <param name="alignment">揃え（2のべき乗）</param>
+/// <returns>切り上げた値</returns>
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/// <summary>
+/// 使うパスの範囲が重なるかどうか
+/// </summary>
+/// <param name="a">リソース</param>
+/// <param name="b">リソース</param>
+/// <returns>重なればtrue</returns>
+static bool OverlapsLifetime(const AliasingRequest& a, const AliasingRequest& b)
+{
+	return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+/// <summary>
+/// 使うパスの範囲が重ならないリソースを、ヒープの同じ位置に重ねて配置する
+/// </summary>
+/// <param name="requests">配置するリソース</param>
+/// <returns>配置した結果</returns>
+AliasingPlan PlanAliasing(const std::vector<AliasingRequest>& requests)
+{
+	AliasingPlan plan{};
+	plan.offsets.resize(requests.size());
+
+	// 大きいものから置く（同じ大きさなら、先に使うものから）
+	std::vector<uint32_t> order(requests.size());
+	for (uint32_t i = 0; i < order.size(); ++i)
+	{
+		assert(requests[i].alignment != 0 && (requests[i].alignment & (requests[i].alignment - 1)) == 0);
+		assert(requests[i].firstPass <= requests[i].lastPass);
+
+		order[i] = i;
+		plan.unaliasedSize = AlignUp(plan.unaliasedSize, requests[i].alignment) + requests[i].sizeInBytes;
+	}
+
+	std::sort(order.begin(), order.end(), [&requests](uint32_t a, uint32_t b)
+		{
+			if (requests[a].sizeInBytes != requests[b].sizeInBytes)
+				return requests[a].sizeInBytes > requests[b].sizeInBytes;
+
+			if (requests[a].firstPass != requests[b].firstPass)
+				return requests[a].firstPass < requests[b].firstPass;
+
+			return a < b;
+		});
+
+	// 置いたもののうち、範囲が重なるものの位置（始まりと終わり）
+	std::vector<std::pair<uint64_t, uint64_t>> occupied;
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const AliasingRequest& request = requests[order[i]];
+
+		occupied.clear();
+		for (size_t j = 0; j < i; ++j)
+		{
+			const AliasingRequest& placed = requests[order[j]];
+			if (OverlapsLifetime(request, placed))
+			{
+				uint64_t offset = plan.offsets[order[j]];
+				occupied.push_back({ offset, offset + placed.sizeInBytes });
+			}
+		}
+
+		std::sort(occupied.begin(), occupied.end());
+
+		// 低い位置から、入る隙間を探す
+		uint64_t offset = 0;
+		for (const auto& [begin, end] : occupied)
+		{
+			if (AlignUp(offset, request.alignment) + request.sizeInBytes <= begin)
+				break;
+
+			offset = (std::max)(offset, end);
+		}
+
+		offset = AlignUp(offset, request.alignment);
+		plan.offsets[order[i]] = offset;
+		plan.heapSize = (std::max)(plan.heapSize, offset + request.sizeInBytes);
+	}
+
+	// 同時に使う大きさの最大は、使い始めるパスで求めれば足りる
+	for (const AliasingRequest& request : requests)
+	{
+		uint64_t liveSize = 0;
+		for (const AliasingRequest& other : requests)
+		{
+			if (other.firstPass <= request.firstPass && request.firstPass <= other.lastPass)
+			{
+				liveSize += other.sizeInBytes;
+			}
+		}
+
+		plan.peakLiveSize = (std::max)(plan.peakLiveSize, liveSize);
+	}
+
+	return plan;
+}
+
+/// <summary>
+/// 配置した結果が正しいかを確かめる
+/// </summary>
+/// <param name="requests">配置したリソース</param>
+/// <param name="plan">配置した結果</param>
+/// <returns>正しければtrue</returns>
+bool ValidateAliasing(const std::vector<AliasingRequest>& requests, const AliasingPlan& plan)
+{
+	if (plan.offsets.size() != requests.size())
+		return false;
+
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		uint64_t offset = plan.offsets[i];
+
+		// 揃えを守り、ヒープに収まっている
+		if (offset % requests[i].alignment != 0 || offset + requests[i].sizeInBytes > plan.heapSize)
+			return false;
+
+		// 範囲が重なるもの同士は、メモリを共有しない
+		for (size_t j = i + 1; j < requests.size(); ++j)
+		{
+			uint64_t otherOffset = plan.offsets[j];
+			bool overlapsMemory = offset < otherOffset + requests[j].sizeInBytes && otherOffset < offset + requests[i].sizeInBytes;
+
+			if (overlapsMemory && OverlapsLifetime(requests[i], requests[j]))
+				return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+// 配置するリソースの既定の揃え（D3D12の配置リソースと同じ64KB）
+const uint64_t kDefaultAliasingAlignment = 64 * 1024;
+
+// 配置するリソース（使うパスの範囲が重ならないもの同士は、同じメモリを使える）
+typedef struct AliasingRequest
+{
+	// 大きさと揃え
+	uint64_t sizeInBytes;
+	uint64_t alignment;
+
+	// 最初と最後に使うパス（両端を含む）
+	uint32_t firstPass;
+	uint32_t lastPass;
+}AliasingRequest;
+
+// 配置した結果
+typedef struct AliasingPlan
+{
+	// リソースごとのヒープの中の位置（要求の順）
+	std::vector<uint64_t> offsets;
+
+	// 必要なヒープの大きさ
+	uint64_t heapSize;
+
+	// 重ねずに1つずつ作ったときの大きさの合計
+	uint64_t unaliasedSize;
+
+	// 同時に使うリソースの大きさの合計の最大（ヒープの大きさの下限）
+	uint64_t peakLiveSize;
+}AliasingPlan;
+
+/// <summary>
+/// 使うパスの範囲が重ならないリソースを、ヒープの同じ位置に重ねて配置する
+/// （大きいものから順に、範囲が重なるものを避けて一番低い位置に置く。区間グラフの彩色を、大きさのあるものに広げたもの）
+/// </summary>
+/// <param name="requests">配置するリソース</param>
+/// <returns>配置した結果</returns>
+AliasingPlan PlanAliasing(const std::vector<AliasingRequest>& requests);
+
+/// <summary>
+/// 配置した結果が正しいかを確かめる（揃えを守り、範囲が重なるもの同士がメモリを共有していない）
+/// </summary>
+/// <param name="requests">配置したリソース</param>
+/// <param name="plan">配置した結果</param>
+/// <returns>正しければtrue</returns>
+bool ValidateAliasing(const std::vector<AliasingRequest>& requests, const AliasingPlan& plan);
@@ -0,0 +1,153 @@
+#include "AssetPacker.h"
+
+/// <summary>
+/// ディレクトリの中のファイルを、1つのアーカイブにまとめる
+/// </summary>
+/// <param name="directoryPath">まとめるディレクトリ（中のパスはこのディレクトリからの相対パスではなく、そのままのパスで登録する）</param>
+/// <param name="archivePath">書き出すアーカイブのパス</param>
+/// <param name="compress">小さくなるファイルはLZ4で圧縮するかどうか</param>
+/// <returns>書き出せたかどうか</returns>
+bool PackAssetArchive(const std::string& directoryPath, const std::string& archivePath, bool compress)
+{
+	if (std::filesystem::is_directory(directoryPath) == false)
+		return false;
+
+	// 書き出すアーカイブ自身は含めない
+	std::error_code errorCode;
+	std::filesystem::path archiveFullPath = std::filesystem::weakly_canonical(archivePath, errorCode);
+
+	// パスの順に並べて、毎回同じアーカイブになるようにする
+	std::vector<std::string> filePaths;
+	for (const std::filesystem::directory_entry& file : std::filesystem::recursive_directory_iterator(directoryPath))
+	{
+		if (file.is_regular_file() == false)
+			continue;
+
+		if (std::filesystem::weakly_canonical(file.path(), errorCode) == archiveFullPath)
+			continue;
+
+		filePaths.push_back(file.path().string());
+	}
+
+	std::sort(filePaths.begin(), filePaths.end());
+
+
+	/*----------------------
+	    中身を並べる
+	----------------------*/
+
+	std::vector<AssetArchiveEntry> entries;
+	std::string names;
+	std::vector<uint8_t> body;
+
+	for (const std::string& filePath : filePaths)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			return false;
+
+		std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		std::string path = AssetArchive::NormalizePath(filePath);
+
+		AssetArchiveEntry entry{};
+		entry.pathHash = HashString(path);
+		entry.contentHash = HashBytes(bytes.data(), bytes.size());
+		entry.size = bytes.size();
+		entry.nameOffset = uint32_t(names.size());
+		entry.nameLength = uint32_t(path.size());
+		entry.compression = kAssetCompressionNone;
+
+		names += path;
+
+		// 1割以上小さくならないものは、展開の手間を省くためにそのまま格納する
+		std::vector<uint8_t> compressed;
+		if (compress)
+		{
+			compressed = CompressLZ4Block(bytes.data(), bytes.size());
+		}
+
+		const std::vector<uint8_t>* stored = &bytes;
+		if (compress && compressed.size() * 10 < bytes.size() * 9)
+		{
+			entry.compression = kAssetCompressionLZ4;
+			stored = &compressed;
+		}
+
+		// マップしたまま使えるように、中身の先頭を揃える（位置はヘッダからの位置に後で直す）
+		body.resize((body.size() + kAssetArchiveAlignment - 1) / kAssetArchiveAlignment * kAssetArchiveAlignment);
+
+		entry.offset = body.size();
+		entry.storedSize = stored->size();
+		body.insert(body.end(), stored->begin(), stored->end());
+
+		entries.push_back(entry);
+	}
+
+	// パスのハッシュ値で二分探索できるように並べる
+	std::stable_sort(entries.begin(), entries.end(),
+		[](const AssetArchiveEntry& a, const AssetArchiveEntry& b) { return a.pathHash < b.pathHash; });
+
+
+	/*----------------------
+	    配置を決める
+	----------------------*/
+
+	auto align = [](uint64_t offset) { return (offset + kAssetArchiveAlignment - 1) / kAssetArchiveAlignment * kAssetArchiveAlignment; };
+
+	AssetArchiveHeader header{};
+	header.magic = kAssetArchiveMagic;
+	header.version = kAssetArchiveVersion;
+	header.numEntries = uint32_t(entries.size());
+	header.entriesOffset = align(sizeof(AssetArchiveHeader));
+	header.namesOffset = header.entriesOffset + entries.size() * sizeof(AssetArchiveEntry);
+	header.namesSize = names.size();
+
+	uint64_t bodyOffset = align(header.namesOffset + header.namesSize);
+
+	for (AssetArchiveEntry& entry : entries)
+	{
+		entry.offset += bodyOffset;
+	}
+
+
+	/*----------------------
+	    書き出す
+	----------------------*/
+
+	std::filesystem::path parentPath = std::filesystem::path(archivePath).parent_path();
+	if (parentPath.empty() == false)
+	{
+		std::filesystem::create_directories(parentPath);
+	}
+
+	// 書き出している途中のものを読まないように、一時ファイルに書いてから置き換える
+	std::string temporaryPath = archivePath + ".tmp";
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary);
+		if (!file)
+			return false;
+
+		std::vector<char> padding(kAssetArchiveAlignment, 0);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(padding.data(), header.entriesOffset - sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetArchiveEntry));
+		file.write(names.data(), names.size());
+		file.write(padding.data(), bodyOffset - (header.namesOffset + header.namesSize));
+		file.write(reinterpret_cast<const char*>(body.data()), body.size());
+
+		if (!file)
+			return false;
+	}
+
+	std::filesystem::rename(temporaryPath, archivePath, errorCode);
+	if (errorCode)
+	{
+		std::filesystem::remove(temporaryPath, errorCode);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include "../../Class/AssetArchive/AssetArchive.h"
+#include "../Hash/Hash.h"
+#include "../Compression/Compression.h"
+
+/// <summary>
+/// ディレクトリの中のファイルを、1つのアーカイブにまとめる
+/// </summary>
+/// <param name="directoryPath">まとめるディレクトリ（中のパスはこのディレクトリからの相対パスではなく、そのままのパスで登録する）</param>
+/// <param name="archivePath">書き出すアーカイブのパス</param>
+/// <param name="compress">小さくなるファイルはLZ4で圧縮するかどうか</param>
+/// <returns>書き出せたかどうか</returns>
+bool PackAssetArchive(const std::string& directoryPath, const std::string& archivePath, bool compress);
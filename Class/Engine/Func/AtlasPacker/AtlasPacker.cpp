@@ -0,0 +1,152 @@
+#include "AtlasPacker.h"
+
+// ImGuiと同じく、このファイルの中だけで実装を使う
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../../externals/imgui/imstb_rectpack.h"
+
+/// <summary>
+/// 余白の大きさから、隣の画像が混ざらないミップの数を求める
+/// </summary>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <returns>ミップの数</returns>
+uint32_t GetAtlasSafeMipLevels(uint32_t padding)
+{
+	// ミップを1段下げるごとに、1ピクセルが2倍の範囲を含む
+	uint32_t mipLevels = 1;
+	while ((2u << (mipLevels - 1)) <= padding)
+	{
+		mipLevels++;
+	}
+
+	return mipLevels;
+}
+
+/// <summary>
+/// 画像をページに置くときの大きさを求める（余白を含め、ミップの境界にそろえる）
+/// </summary>
+/// <param name="size">画像の幅、または高さ</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <returns>余白を含めた大きさ</returns>
+uint32_t GetAtlasSlotSize(uint32_t size, uint32_t padding)
+{
+	const uint32_t alignment = 1u << (GetAtlasSafeMipLevels(padding) - 1);
+	return (size + padding * 2 + alignment - 1) / alignment * alignment;
+}
+
+/// <summary>
+/// 画像を余白を含めた大きさでページに詰める（入らなければページを増やす）
+/// </summary>
+/// <param name="rects">画像の大きさを入れておくと、ページと位置を書き込む</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <param name="numPages">使ったページの数</param>
+/// <returns>詰められたかどうか（ページより大きい画像があればfalse）</returns>
+bool PackAtlasRects(std::vector<AtlasRect>& rects, uint32_t pageSize, uint32_t padding, uint32_t& numPages)
+{
+	numPages = 0;
+
+	std::vector<stbrp_rect> remaining(rects.size());
+	for (uint32_t i = 0; i < rects.size(); ++i)
+	{
+		uint32_t width = GetAtlasSlotSize(rects[i].width, padding);
+		uint32_t height = GetAtlasSlotSize(rects[i].height, padding);
+
+		// ページに入らない画像は詰められない
+		if (width > pageSize || height > pageSize)
+			return false;
+
+		remaining[i] = {};
+		remaining[i].id = int(i);
+		remaining[i].w = stbrp_coord(width);
+		remaining[i].h = stbrp_coord(height);
+	}
+
+	std::vector<stbrp_node> nodes(pageSize);
+
+	while (remaining.empty() == false)
+	{
+		stbrp_context context{};
+		stbrp_init_target(&context, int(pageSize), int(pageSize), nodes.data(), int(nodes.size()));
+
+		// 高さの順に並べ、下から詰める（キャッシュと同じ並びになるように、詰め方を決めておく）
+		stbrp_setup_heuristic(&context, STBRP_HEURISTIC_Skyline_BL_sortHeight);
+		stbrp_pack_rects(&context, remaining.data(), int(remaining.size()));
+
+		std::vector<stbrp_rect> next;
+		for (const stbrp_rect& rect : remaining)
+		{
+			if (rect.was_packed == false)
+			{
+				next.push_back(rect);
+				continue;
+			}
+
+			rects[rect.id].page = numPages;
+			rects[rect.id].x = uint32_t(rect.x) + padding;
+			rects[rect.id].y = uint32_t(rect.y) + padding;
+		}
+
+		// 空のページにも1枚も詰められなければ、それ以上は詰められない
+		if (next.size() == remaining.size())
+			return false;
+
+		remaining = std::move(next);
+		numPages++;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// 画像をページの詰めた位置に写す（余白には端のピクセルを広げ、フィルタやミップで隣の画像が混ざらないようにする）
+/// </summary>
+/// <param name="srcPixels">画像の先頭（R8G8B8A8）</param>
+/// <param name="srcRowPitch">画像の1行のバイト数</param>
+/// <param name="rect">詰めた位置</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <param name="pagePixels">ページの先頭（R8G8B8A8）</param>
+/// <param name="pageRowPitch">ページの1行のバイト数</param>
+void CopyAtlasImage(const uint8_t* srcPixels, size_t srcRowPitch, const AtlasRect& rect, uint32_t padding, uint8_t* pagePixels, size_t pageRowPitch)
+{
+	// 余白を含めた、ページに置いた範囲
+	const uint32_t slotX = rect.x - padding;
+	const uint32_t slotY = rect.y - padding;
+	const uint32_t slotWidth = GetAtlasSlotSize(rect.width, padding);
+	const uint32_t slotHeight = GetAtlasSlotSize(rect.height, padding);
+
+	for (uint32_t y = 0; y < slotHeight; ++y)
+	{
+		int64_t sy = std::clamp<int64_t>(int64_t(y) - padding, 0, int64_t(rect.height) - 1);
+		uint8_t* destRow = pagePixels + pageRowPitch * (slotY + y) + kAtlasBytesPerPixel * slotX;
+		const uint8_t* srcRow = srcPixels + srcRowPitch * sy;
+
+		for (uint32_t x = 0; x < slotWidth; ++x)
+		{
+			int64_t sx = std::clamp<int64_t>(int64_t(x) - padding, 0, int64_t(rect.width) - 1);
+			std::memcpy(destRow + kAtlasBytesPerPixel * x, srcRow + kAtlasBytesPerPixel * sx, kAtlasBytesPerPixel);
+		}
+	}
+}
+
+/// <summary>
+/// 画像のUVの左上を求める
+/// </summary>
+/// <param name="rect">詰めた位置</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <returns>UV</returns>
+Vector2 GetAtlasUVMin(const AtlasRect& rect, uint32_t pageSize)
+{
+	return { float(rect.x) / float(pageSize), float(rect.y) / float(pageSize) };
+}
+
+/// <summary>
+/// 画像のUVの右下を求める
+/// </summary>
+/// <param name="rect">詰めた位置</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <returns>UV</returns>
+Vector2 GetAtlasUVMax(const AtlasRect& rect, uint32_t pageSize)
+{
+	return { float(rect.x + rect.width) / float(pageSize), float(rect.y + rect.height) / float(pageSize) };
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include "../../Struct.h"
+
+// アトラスのページの1ピクセルのバイト数（R8G8B8A8）
+const uint32_t kAtlasBytesPerPixel = 4;
+
+// アトラスに詰めた画像の位置（余白を除いた、画像そのものの範囲）
+typedef struct AtlasRect
+{
+	// ページ
+	uint32_t page;
+
+	// ページ上の位置（ピクセル）
+	uint32_t x;
+	uint32_t y;
+
+	// 大きさ（ピクセル）
+	uint32_t width;
+	uint32_t height;
+}AtlasRect;
+
+/// <summary>
+/// 余白の大きさから、隣の画像が混ざらないミップの数を求める
+/// </summary>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <returns>ミップの数</returns>
+uint32_t GetAtlasSafeMipLevels(uint32_t padding);
+
+/// <summary>
+/// 画像をページに置くときの大きさを求める（余白を含め、ミップの境界にそろえる）
+/// </summary>
+/// <param name="size">画像の幅、または高さ</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <returns>余白を含めた大きさ</returns>
+uint32_t GetAtlasSlotSize(uint32_t size, uint32_t padding);
+
+/// <summary>
+/// 画像を余白を含めた大きさでページに詰める（入らなければページを増やす）
+/// </summary>
+/// <param name="rects">画像の大きさを入れておくと、ページと位置を書き込む</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <param name="numPages">使ったページの数</param>
+/// <returns>詰められたかどうか（ページより大きい画像があればfalse）</returns>
+bool PackAtlasRects(std::vector<AtlasRect>& rects, uint32_t pageSize, uint32_t padding, uint32_t& numPages);
+
+/// <summary>
+/// 画像をページの詰めた位置に写す（余白には端のピクセルを広げ、フィルタやミップで隣の画像が混ざらないようにする）
+/// </summary>
+/// <param name="srcPixels">画像の先頭（R8G8B8A8）</param>
+/// <param name="srcRowPitch">画像の1行のバイト数</param>
+/// <param name="rect">詰めた位置</param>
+/// <param name="padding">画像の周りに広げる余白</param>
+/// <param name="pagePixels">ページの先頭（R8G8B8A8）</param>
+/// <param name="pageRowPitch">ページの1行のバイト数</param>
+void CopyAtlasImage(const uint8_t* srcPixels, size_t srcRowPitch, const AtlasRect& rect, uint32_t padding, uint8_t* pagePixels, size_t pageRowPitch);
+
+/// <summary>
+/// 画像のUVの左上を求める
+/// </summary>
+/// <param name="rect">詰めた位置</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <returns>UV</returns>
+Vector2 GetAtlasUVMin(const AtlasRect& rect, uint32_t pageSize);
+
+/// <summary>
+/// 画像のUVの右下を求める
+/// </summary>
+/// <param name="rect">詰めた位置</param>
+/// <param name="pageSize">ページの大きさ</param>
+/// <returns>UV</returns>
+Vector2 GetAtlasUVMax(const AtlasRect& rect, uint32_t pageSize);
@@ -0,0 +1,235 @@
+#include "Compression.h"
+
+// 一致とみなす最小の長さ
+static const size_t kLZ4MinMatch = 4;
+
+// 末尾のこのバイト数は、必ずリテラルにする
+static const size_t kLZ4LastLiterals = 5;
+
+// 末尾からこのバイト数の範囲では、一致を探し始めない
+static const size_t kLZ4MatchFindLimit = 12;
+
+// 一致を遡れる最大の距離
+static const size_t kLZ4MaxOffset = 65535;
+
+// ハッシュ表の大きさ（ビット数）
+static const uint32_t kLZ4HashLog = 16;
+
+/// <summary>
+/// 4バイトを読む
+/// </summary>
+/// <param name="p">読む位置</param>
+/// <returns></returns>
+static uint32_t ReadLZ4Sequence(const uint8_t* p)
+{
+	uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+/// <summary>
+/// 15以上の長さを、255ずつ続けて書く
+/// </summary>
+/// <param name="output">書き込み先</param>
+/// <param name="length">token に入りきらなかった長さ</param>
+static void WriteLZ4Length(std::vector<uint8_t>& output, size_t length)
+{
+	while (length >= 255)
+	{
+		output.push_back(255);
+		length -= 255;
+	}
+
+	output.push_back(uint8_t(length));
+}
+
+/// <summary>
+/// リテラルと一致を1組書く（matchLengthが0ならリテラルだけの最後の組）
+/// </summary>
+/// <param name="output">書き込み先</param>
+/// <param name="literals">リテラル</param>
+/// <param name="numLiterals">リテラルの数</param>
+/// <param name="offset">一致の距離</param>
+/// <param name="matchLength">一致の長さ</param>
+static void WriteLZ4Sequence(std::vector<uint8_t>& output, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+	size_t extraMatch = matchLength >= kLZ4MinMatch ? matchLength - kLZ4MinMatch : 0;
+
+	uint8_t token = uint8_t((numLiterals < 15 ? numLiterals : 15) << 4);
+	if (matchLength > 0)
+	{
+		token |= uint8_t(extraMatch < 15 ? extraMatch : 15);
+	}
+
+	output.push_back(token);
+
+	if (numLiterals >= 15)
+	{
+		WriteLZ4Length(output, numLiterals - 15);
+	}
+
+	output.insert(output.end(), literals, literals + numLiterals);
+
+	if (matchLength == 0)
+		return;
+
+	output.push_back(uint8_t(offset & 0xFF));
+	output.push_back(uint8_t(offset >> 8));
+
+	if (extraMatch >= 15)
+	{
+		WriteLZ4Length(output, extraMatch - 15);
+	}
+}
+
+/// <summary>
+/// LZ4のブロック形式で圧縮する
+/// </summary>
+/// <param name="data">圧縮するデータ</param>
+/// <param name="size">バイト数</param>
+/// <returns>圧縮したデータ</returns>
+std::vector<uint8_t> CompressLZ4Block(const uint8_t* data, size_t size)
+{
+	std::vector<uint8_t> output;
+	output.reserve(size + size / 255 + 16);
+
+	// 4バイトのハッシュ値から、最後に現れた位置+1を引く表
+	std::vector<uint32_t> hashTable(size_t(1) << kLZ4HashLog, 0);
+
+	size_t anchor = 0;
+	size_t position = 0;
+
+	if (size > kLZ4MatchFindLimit)
+	{
+		const size_t findLimit = size - kLZ4MatchFindLimit;
+		const size_t matchLimit = size - kLZ4LastLiterals;
+
+		while (position < findLimit)
+		{
+			uint32_t sequence = ReadLZ4Sequence(data + position);
+			uint32_t hash = (sequence * 2654435761u) >> (32 - kLZ4HashLog);
+
+			size_t candidate = hashTable[hash];
+			hashTable[hash] = uint32_t(position + 1);
+
+			// 同じ4バイトが、届く距離に無ければ次へ
+			if (candidate == 0 || position - (candidate - 1) > kLZ4MaxOffset || ReadLZ4Sequence(data + candidate - 1) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			size_t reference = candidate - 1;
+
+			// 一致を後ろへ伸ばす
+			size_t matchEnd = position + kLZ4MinMatch;
+			while (matchEnd < matchLimit && data[matchEnd] == data[reference + (matchEnd - position)])
+			{
+				matchEnd++;
+			}
+
+			WriteLZ4Sequence(output, data + anchor, position - anchor, position - reference, matchEnd - position);
+
+			position = matchEnd;
+			anchor = position;
+		}
+	}
+
+	// 残りはリテラルとして書く
+	WriteLZ4Sequence(output, data + anchor, size - anchor, 0, 0);
+
+	return output;
+}
+
+/// <summary>
+/// LZ4のブロック形式を展開する（壊れたデータでは書き込み先の外に出ず、falseを返す）
+/// </summary>
+/// <param name="source">圧縮したデータ</param>
+/// <param name="sourceSize">圧縮したデータのバイト数</param>
+/// <param name="destination">書き込み先</param>
+/// <param name="destinationSize">展開後のバイト数</param>
+/// <returns>ちょうど展開後のバイト数になったかどうか</returns>
+bool DecompressLZ4Block(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+{
+	size_t in = 0;
+	size_t out = 0;
+
+	while (in < sourceSize)
+	{
+		uint8_t token = source[in++];
+
+		// リテラルの長さ
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15)
+		{
+			uint8_t byte = 0;
+			do
+			{
+				if (in >= sourceSize)
+					return false;
+
+				byte = source[in++];
+				numLiterals += byte;
+			} while (byte == 255);
+		}
+
+		if (numLiterals > sourceSize - in || numLiterals > destinationSize - out)
+			return false;
+
+		std::memcpy(destination + out, source + in, numLiterals);
+		in += numLiterals;
+		out += numLiterals;
+
+		// 最後の組はリテラルだけ
+		if (in == sourceSize)
+			break;
+
+		// 一致の距離
+		if (sourceSize - in < 2)
+			return false;
+
+		size_t offset = size_t(source[in]) | (size_t(source[in + 1]) << 8);
+		in += 2;
+
+		if (offset == 0 || offset > out)
+			return false;
+
+		// 一致の長さ
+		size_t matchLength = token & 0x0F;
+		if (matchLength == 15)
+		{
+			uint8_t byte = 0;
+			do
+			{
+				if (in >= sourceSize)
+					return false;
+
+				byte = source[in++];
+				matchLength += byte;
+			} while (byte == 255);
+		}
+
+		matchLength += kLZ4MinMatch;
+
+		if (matchLength > destinationSize - out)
+			return false;
+
+		// 距離が長さより短いときは、書いたばかりのものを繰り返すので1バイトずつ写す
+		const uint8_t* match = destination + out - offset;
+		if (offset >= matchLength)
+		{
+			std::memcpy(destination + out, match, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				destination[out + i] = match[i];
+			}
+		}
+
+		out += matchLength;
+	}
+
+	return out == destinationSize;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <cstring>
+
+/// <summary>
+/// LZ4のブロック形式で圧縮する
+/// </summary>
+/// <param name="data">圧縮するデータ</param>
+/// <param name="size">バイト数</param>
+/// <returns>圧縮したデータ</returns>
+std::vector<uint8_t> CompressLZ4Block(const uint8_t* data, size_t size);
+
+/// <summary>
+/// LZ4のブロック形式を展開する（壊れたデータでは書き込み先の外に出ず、falseを返す）
+/// </summary>
+/// <param name="source">圧縮したデータ</param>
+/// <param name="sourceSize">圧縮したデータのバイト数</param>
+/// <param name="destination">書き込み先</param>
+/// <param name="destinationSize">展開後のバイト数</param>
+/// <returns>ちょうど展開後のバイト数になったかどうか</returns>
+bool DecompressLZ4Block(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
@@ -0,0 +1,371 @@
+#include "DrawRecord.h"
+
+/// <summary>
+/// 描画に共通の設定を積む
+/// </summary>
+/// <param name="device">積む先</param>
+/// <param name="pass">描画の設定</param>
+static void SetPass(RenderDevice& device, const DrawPass& pass)
+{
+	// ビューポートの設定
+	device.SetViewport(pass.viewport);
+
+	// シザーの設定
+	device.SetScissorRect(pass.scissorRect);
+
+	// rootSignature
+	device.SetRootSignature(pass.rootSignature);
+
+	// PSOの設定
+	device.SetPipelineState(pass.pipelineState);
+}
+
+/// <summary>
+/// マテリアルを書き込んだバッファを作る
+/// </summary>
+/// <param name="device">作る先</param>
+/// <param name="color">色</param>
+/// <param name="enableLighting">ライティングを有効にするかどうか</param>
+/// <returns>バッファのアドレス</returns>
+static uint64_t WriteMaterial(RenderDevice& device, const Vector4& color, bool enableLighting)
+{
+	RenderBuffer materialBuffer = device.CreateUploadBuffer(sizeof(Material));
+	Material* materialData = static_cast<Material*>(materialBuffer.data);
+
+	Transform3D uvTransform = { {1.0f , 1.0f , 1.0f} , {0.0f , 0.0f , 0.0f} , {0.0f , 0.0f , 0.0f} };
+
+	materialData->color = color;
+	materialData->enableLighting = enableLighting;
+	materialData->uvTransform = Multiply(Multiply(Make4x4ScaleMatrix(uvTransform.scale),
+		Make4x4RotateZMatrix(uvTransform.rotate.z)), Make4x4TranslateMatrix(uvTransform.translate));
+
+	return materialBuffer.gpuAddress;
+}
+
+/// <summary>
+/// 座標変換の行列を書き込んだバッファを作る
+/// </summary>
+/// <param name="device">作る先</param>
+/// <param name="transform">姿勢</param>
+/// <param name="viewProjectionMatrix">ビュープロジェクション行列</param>
+/// <param name="worldViewProjectionMatrix">求めたワールドビュープロジェクション行列</param>
+/// <returns>バッファのアドレス</returns>
+static uint64_t WriteTransformationMatrix(RenderDevice& device, const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
+	Matrix4x4& worldViewProjectionMatrix)
+{
+	RenderBuffer transformationMatrixBuffer = device.CreateUploadBuffer(sizeof(TransformationMatrix));
+	TransformationMatrix* transformationMatrixData = static_cast<TransformationMatrix*>(transformationMatrixBuffer.data);
+
+	// 書き込み先のメモリは読まずに、求めた値を使う（アップロードヒープは読むと遅い）
+	Matrix4x4 world = Make4x4AffineMatrix(transform.scale, transform.rotate, transform.translate);
+	worldViewProjectionMatrix = Multiply(world, viewProjectionMatrix);
+
+	transformationMatrixData->world = world;
+	transformationMatrixData->worldViewProjection = worldViewProjectionMatrix;
+
+	return transformationMatrixBuffer.gpuAddress;
+}
+
+/// <summary>
+/// 平行光源を書き込んだバッファを作る
+/// </summary>
+/// <param name="device">作る先</param>
+/// <param name="light">平行光源</param>
+/// <returns>バッファのアドレス</returns>
+static uint64_t WriteDirectionalLight(RenderDevice& device, const DirectionalLight& light)
+{
+	RenderBuffer directionalLightBuffer = device.CreateUploadBuffer(sizeof(DirectionalLight));
+	DirectionalLight* directionalLightData = static_cast<DirectionalLight*>(directionalLightBuffer.data);
+
+	directionalLightData->color = light.color;
+	directionalLightData->direction = light.direction;
+	directionalLightData->intensity = light.intensity;
+
+	return directionalLightBuffer.gpuAddress;
+}
+
+// 三角形を描画するコマンドを積む
+Matrix4x4 RecordTriangle(RenderDevice& device, const DrawPass& pass, const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
+	Vector3 color, RenderHandle textureDescriptor)
+{
+	SetPass(device, pass);
+
+	// 頂点バッファを作る
+	RenderBuffer vertexBuffer = device.CreateUploadBuffer(sizeof(VertexData) * 6);
+
+	// データを書き込む
+	VertexData* vertexData = static_cast<VertexData*>(vertexBuffer.data);
+	vertexData[0].position = { 0.0f , 0.5f , 0.0f , 1.0f };
+	vertexData[0].texcoord = { 0.5f , 0.0f };
+	vertexData[0].normal = { 0.0f,0.0f,0.0f };
+	vertexData[1].position = { 0.5f , -0.5f , 0.0f , 1.0f };
+	vertexData[1].texcoord = { 1.0f , 1.0f };
+	vertexData[1].normal = { 0.0f,0.0f,0.0f };
+	vertexData[2].position = { -0.5f , -0.5f , 0.0f , 1.0f };
+	vertexData[2].texcoord = { 0.0f , 1.0f };
+	vertexData[2].normal = { 0.0f,0.0f,0.0f };
+	vertexData[3].position = { 0.0f , 0.0f , 0.0f , 1.0f };
+	vertexData[3].texcoord = { 0.5f , 0.0f };
+	vertexData[3].normal = { 0.0f,0.0f,0.0f };
+	vertexData[4].position = { 0.0f , -0.5f , -0.5f , 1.0f };
+	vertexData[4].texcoord = { 1.0f , 1.0f };
+	vertexData[4].normal = { 0.0f,0.0f,0.0f };
+	vertexData[5].position = { 0.0f , -0.5f , 0.5f , 1.0f };
+	vertexData[5].texcoord = { 0.0f , 1.0f };
+	vertexData[5].normal = { 0.0f,0.0f,0.0f };
+
+	// マテリアルと座標変換のバッファを作る
+	uint64_t materialAddress = WriteMaterial(device, { color.x , color.y , color.z , 1.0f }, false);
+
+	Matrix4x4 worldViewProjectionMatrix;
+	uint64_t transformationMatrixAddress = WriteTransformationMatrix(device, transform, viewProjectionMatrix, worldViewProjectionMatrix);
+
+
+	// VBVを設定する
+	device.SetVertexBuffer({ vertexBuffer.gpuAddress , vertexBuffer.sizeInBytes , sizeof(VertexData) });
+
+	// 形状を設定
+	device.SetPrimitiveTopology(RenderTopology::TriangleList);
+
+	// マテリアル用のCBVを設定する
+	device.SetConstantBuffer(0, materialAddress);
+
+	// 座標変換用のCBVを設定する
+	device.SetConstantBuffer(1, transformationMatrixAddress);
+
+	// テクスチャのディスクリプタテーブルを設定する
+	device.SetDescriptorTable(2, textureDescriptor);
+
+	// 描画する
+	device.Draw(6, 0);
+
+	return worldViewProjectionMatrix;
+}
+
+// スプライトを描画するコマンドを積む
+Matrix4x4 RecordSprite(RenderDevice& device, const DrawPass& pass, const Vector2 corners[4], const Transform3D& transform,
+	const Matrix4x4& viewOrthographicMatrix, const SpriteRegion& sprite, RenderHandle textureDescriptor)
+{
+	SetPass(device, pass);
+
+	// インデックスバッファを作る
+	RenderBuffer indexBuffer = device.CreateUploadBuffer(sizeof(uint32_t) * 6);
+
+	// データを書き込む
+	uint32_t* indexData = static_cast<uint32_t*>(indexBuffer.data);
+	indexData[0] = 0; indexData[1] = 1; indexData[2] = 2;
+	indexData[3] = 1; indexData[4] = 3; indexData[5] = 2;
+
+
+	// 頂点バッファを作る
+	RenderBuffer vertexBuffer = device.CreateUploadBuffer(sizeof(VertexData) * 4);
+
+	// データを書き込む（左下、左上、右下、右上の順）
+	VertexData* vertexData = static_cast<VertexData*>(vertexBuffer.data);
+	vertexData[0].position = { corners[2].x , corners[2].y , 0.0f , 1.0f };
+	vertexData[0].texcoord = { sprite.uvMin.x , sprite.uvMax.y };
+	vertexData[0].normal = { 0.0f , 0.0f , -1.0f };
+
+	vertexData[1].position = { corners[0].x , corners[0].y , 0.0f , 1.0f };
+	vertexData[1].texcoord = { sprite.uvMin.x , sprite.uvMin.y };
+	vertexData[1].normal = { 0.0f , 0.0f , -1.0f };
+
+	vertexData[2].position = { corners[3].x , corners[3].y , 0.0f , 1.0f };
+	vertexData[2].texcoord = { sprite.uvMax.x , sprite.uvMax.y };
+	vertexData[2].normal = { 0.0f , 0.0f , -1.0f };
+
+	vertexData[3].position = { corners[1].x , corners[1].y , 0.0f , 1.0f };
+	vertexData[3].texcoord = { sprite.uvMax.x , sprite.uvMin.y };
+	vertexData[3].normal = { 0.0f , 0.0f , -1.0f };
+
+	// マテリアルと座標変換のバッファを作る
+	uint64_t materialAddress = WriteMaterial(device, { 1.0f , 1.0f , 1.0f , 1.0f }, false);
+
+	Matrix4x4 worldViewProjectionMatrix;
+	uint64_t transformationMatrixAddress = WriteTransformationMatrix(device, transform, viewOrthographicMatrix, worldViewProjectionMatrix);
+
+
+	// IBVを設定する
+	device.SetIndexBuffer({ indexBuffer.gpuAddress , indexBuffer.sizeInBytes });
+
+	// VBVを設定する
+	device.SetVertexBuffer({ vertexBuffer.gpuAddress , vertexBuffer.sizeInBytes , sizeof(VertexData) });
+
+	// 形状を設定
+	device.SetPrimitiveTopology(RenderTopology::TriangleList);
+
+	// マテリアル用のCBVを設定する
+	device.SetConstantBuffer(0, materialAddress);
+
+	// 座標変換用のCBVを設定する
+	device.SetConstantBuffer(1, transformationMatrixAddress);
+
+	// テクスチャのディスクリプタテーブルを設定する
+	device.SetDescriptorTable(2, textureDescriptor);
+
+	// 描画する
+	device.DrawIndexed(6, 0, 0);
+
+	return worldViewProjectionMatrix;
+}
+
+// 球を描画するコマンドを積む
+Matrix4x4 RecordSphere(RenderDevice& device, const DrawPass& pass, uint32_t subdivisions, const Transform3D& transform,
+	const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light, RenderHandle textureDescriptor)
+{
+	SetPass(device, pass);
+
+	// インデックスバッファを作る
+	RenderBuffer indexBuffer = device.CreateUploadBuffer(sizeof(uint32_t) * (subdivisions * subdivisions * 6));
+
+	// データを書き込む
+	uint32_t* indexData = static_cast<uint32_t*>(indexBuffer.data);
+
+	for (uint32_t latIndex = 0; latIndex < subdivisions; ++latIndex)
+	{
+		for (uint32_t lonIndex = 0; lonIndex < subdivisions; ++lonIndex)
+		{
+			// 要素数
+			uint32_t index = (latIndex * subdivisions + lonIndex) * 6;
+
+			// 頂点の要素数
+			uint32_t vertexIndex = (latIndex * subdivisions + lonIndex) * 4;
+
+			indexData[index + 0] = vertexIndex + 0;
+			indexData[index + 1] = vertexIndex + 1;
+			indexData[index + 2] = vertexIndex + 2;
+			indexData[index + 3] = vertexIndex + 2;
+			indexData[index + 4] = vertexIndex + 1;
+			indexData[index + 5] = vertexIndex + 3;
+		}
+	}
+
+
+	// 頂点バッファを作る
+	RenderBuffer vertexBuffer = device.CreateUploadBuffer(sizeof(VertexData) * (subdivisions * subdivisions * 4));
+
+	// データを書き込む
+	VertexData* vertexData = static_cast<VertexData*>(vertexBuffer.data);
+
+	// 経度分割1つ分の角度φ
+	const float kLonEvery = float(M_PI) * 2.0f / static_cast<float>(subdivisions);
+
+	// 緯度分割1つ分の角度Θ
+	const float kLatEvery = float(M_PI) / static_cast<float>(subdivisions);
+
+	// 緯度の方向に分割
+	for (uint32_t latIndex = 0; latIndex < subdivisions; ++latIndex)
+	{
+		// 現在の緯度
+		float lat = -float(M_PI) / 2.0f + kLatEvery * latIndex;
+
+		// 経度の方向に分割
+		for (uint32_t lonIndex = 0; lonIndex < subdivisions; ++lonIndex)
+		{
+			// 現在の経度
+			float lon = lonIndex * kLonEvery;
+
+			// 要素数
+			uint32_t index = (latIndex * subdivisions + lonIndex) * 4;
+
+			// 4つの角（緯度と経度を、それぞれ1つ進めたもの）
+			const float kLats[4] = { lat , lat + kLatEvery , lat , lat + kLatEvery };
+			const float kLons[4] = { lon , lon , lon + kLonEvery , lon + kLonEvery };
+			const uint32_t kLatSteps[4] = { 0 , 1 , 0 , 1 };
+			const uint32_t kLonSteps[4] = { 0 , 0 , 1 , 1 };
+
+			for (uint32_t corner = 0; corner < 4; ++corner)
+			{
+				VertexData& vertex = vertexData[index + corner];
+				vertex.position.x = std::cos(kLats[corner]) * std::cos(kLons[corner]);
+				vertex.position.y = std::sin(kLats[corner]);
+				vertex.position.z = std::cos(kLats[corner]) * std::sin(kLons[corner]);
+				vertex.position.w = 1.0f;
+				vertex.texcoord.x = static_cast<float>(lonIndex + kLonSteps[corner]) / static_cast<float>(subdivisions);
+				vertex.texcoord.y = 1.0f - static_cast<float>(latIndex + kLatSteps[corner]) / static_cast<float>(subdivisions);
+				vertex.normal.x = vertex.position.x;
+				vertex.normal.y = vertex.position.y;
+				vertex.normal.z = vertex.position.z;
+			}
+		}
+	}
+
+	// マテリアル、座標変換、平行光源のバッファを作る
+	uint64_t materialAddress = WriteMaterial(device, { 1.0f , 1.0f , 1.0f , 1.0f }, true);
+
+	Matrix4x4 worldViewProjectionMatrix;
+	uint64_t transformationMatrixAddress = WriteTransformationMatrix(device, transform, viewProjectionMatrix, worldViewProjectionMatrix);
+
+	uint64_t directionalLightAddress = WriteDirectionalLight(device, light);
+
+
+	// IBVを設定する
+	device.SetIndexBuffer({ indexBuffer.gpuAddress , indexBuffer.sizeInBytes });
+
+	// VBVを設定する
+	device.SetVertexBuffer({ vertexBuffer.gpuAddress , vertexBuffer.sizeInBytes , sizeof(VertexData) });
+
+	// 形状を設定
+	device.SetPrimitiveTopology(RenderTopology::TriangleList);
+
+	// マテリアル用のCBVを設定する
+	device.SetConstantBuffer(0, materialAddress);
+
+	// 座標変換用のCBVを設定する
+	device.SetConstantBuffer(1, transformationMatrixAddress);
+
+	// 平行光源用のCBVを設定する
+	device.SetConstantBuffer(3, directionalLightAddress);
+
+	// テクスチャのディスクリプタテーブルを設定する
+	device.SetDescriptorTable(2, textureDescriptor);
+
+	// 描画する
+	device.DrawIndexed(subdivisions * subdivisions * 6, 0, 0);
+
+	return worldViewProjectionMatrix;
+}
+
+// モデルを描画するコマンドを積む
+Matrix4x4 RecordModel(RenderDevice& device, const DrawPass& pass, const RenderVertexBufferView& vertexBuffer, const RenderIndexBufferView& indexBuffer,
+	const std::vector<SubMesh>& subMeshes, const std::vector<RenderHandle>& textureDescriptors, const Transform3D& transform,
+	const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light)
+{
+	assert(subMeshes.size() == textureDescriptors.size());
+
+	SetPass(device, pass);
+
+	// マテリアル、座標変換、平行光源のバッファを作る
+	uint64_t materialAddress = WriteMaterial(device, { 1.0f , 1.0f , 1.0f , 1.0f }, true);
+
+	Matrix4x4 worldViewProjectionMatrix;
+	uint64_t transformationMatrixAddress = WriteTransformationMatrix(device, transform, viewProjectionMatrix, worldViewProjectionMatrix);
+
+	uint64_t directionalLightAddress = WriteDirectionalLight(device, light);
+
+
+	// 読み込み時に作ったVBVとIBVを設定する
+	device.SetVertexBuffer(vertexBuffer);
+	device.SetIndexBuffer(indexBuffer);
+
+	// 形状を設定
+	device.SetPrimitiveTopology(RenderTopology::TriangleList);
+
+	// マテリアル用のCBVを設定する
+	device.SetConstantBuffer(0, materialAddress);
+
+	// 座標変換用のCBVを設定する
+	device.SetConstantBuffer(1, transformationMatrixAddress);
+
+	// 平行光源用のCBVを設定する
+	device.SetConstantBuffer(3, directionalLightAddress);
+
+	// サブメッシュごとに、マテリアルのテクスチャを設定して描画する（バッファは設定したまま）
+	for (size_t i = 0; i < subMeshes.size(); ++i)
+	{
+		device.SetDescriptorTable(2, textureDescriptors[i]);
+		device.DrawIndexed(subMeshes[i].indexCount, subMeshes[i].indexStart, 0);
+	}
+
+	return worldViewProjectionMatrix;
+}
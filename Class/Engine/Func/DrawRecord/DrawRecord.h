@@ -0,0 +1,79 @@
+#pragma once
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+#include "../../Struct.h"
+#include "../Matrix/Matrix.h"
+#include "../../Class/RenderDevice/RenderDevice.h"
+
+// 描画に共通の設定
+typedef struct DrawPass
+{
+	// ビューポートとシザーレクト
+	RenderViewport viewport;
+	RenderRect scissorRect;
+
+	// ルートシグネチャとPSO
+	RenderHandle rootSignature;
+	RenderHandle pipelineState;
+}DrawPass;
+
+/// <summary>
+/// 三角形を描画するコマンドを積む
+/// </summary>
+/// <param name="device">積む先</param>
+/// <param name="pass">描画の設定</param>
+/// <param name="transform">姿勢</param>
+/// <param name="viewProjectionMatrix">ビュープロジェクション行列</param>
+/// <param name="color">色</param>
+/// <param name="textureDescriptor">テクスチャのディスクリプタ</param>
+/// <returns>ワールドビュープロジェクション行列</returns>
+Matrix4x4 RecordTriangle(RenderDevice& device, const DrawPass& pass, const Transform3D& transform, const Matrix4x4& viewProjectionMatrix,
+	Vector3 color, RenderHandle textureDescriptor);
+
+/// <summary>
+/// スプライトを描画するコマンドを積む
+/// </summary>
+/// <param name="device">積む先</param>
+/// <param name="pass">描画の設定</param>
+/// <param name="corners">左上、右上、左下、右下の順の頂点</param>
+/// <param name="transform">姿勢</param>
+/// <param name="viewOrthographicMatrix">ビュー平行投影行列</param>
+/// <param name="sprite">テクスチャの領域</param>
+/// <param name="textureDescriptor">テクスチャのディスクリプタ</param>
+/// <returns>ワールドビュープロジェクション行列</returns>
+Matrix4x4 RecordSprite(RenderDevice& device, const DrawPass& pass, const Vector2 corners[4], const Transform3D& transform,
+	const Matrix4x4& viewOrthographicMatrix, const SpriteRegion& sprite, RenderHandle textureDescriptor);
+
+/// <summary>
+/// 球を描画するコマンドを積む
+/// </summary>
+/// <param name="device">積む先</param>
+/// <param name="pass">描画の設定</param>
+/// <param name="subdivisions">分割数</param>
+/// <param name="transform">姿勢</param>
+/// <param name="viewProjectionMatrix">ビュープロジェクション行列</param>
+/// <param name="light">平行光源</param>
+/// <param name="textureDescriptor">テクスチャのディスクリプタ</param>
+/// <returns>ワールドビュープロジェクション行列</returns>
+Matrix4x4 RecordSphere(RenderDevice& device, const DrawPass& pass, uint32_t subdivisions, const Transform3D& transform,
+	const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light, RenderHandle textureDescriptor);
+
+/// <summary>
+/// モデルを描画するコマンドを積む（サブメッシュごとにテクスチャを替えて描画する）
+/// </summary>
+/// <param name="device">積む先</param>
+/// <param name="pass">描画の設定</param>
+/// <param name="vertexBuffer">読み込み時に作った頂点バッファ</param>
+/// <param name="indexBuffer">読み込み時に作ったインデックスバッファ</param>
+/// <param name="subMeshes">サブメッシュ</param>
+/// <param name="textureDescriptors">サブメッシュごとのテクスチャのディスクリプタ</param>
+/// <param name="transform">姿勢</param>
+/// <param name="viewProjectionMatrix">ビュープロジェクション行列</param>
+/// <param name="light">平行光源</param>
+/// <returns>ワールドビュープロジェクション行列</returns>
+Matrix4x4 RecordModel(RenderDevice& device, const DrawPass& pass, const RenderVertexBufferView& vertexBuffer, const RenderIndexBufferView& indexBuffer,
+	const std::vector<SubMesh>& subMeshes, const std::vector<RenderHandle>& textureDescriptors, const Transform3D& transform,
+	const Matrix4x4& viewProjectionMatrix, const DirectionalLight& light);
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// 文字列の書式は engine::format を使う（<format> の無い標準ライブラリ（GCC 12 など）では、{fmt} を使う）
+// CMakeLists.txt が、<format> をインクルードできないときだけ ENGINE_USE_FMT を定義し、{fmt} をリンクする
+#ifdef ENGINE_USE_FMT
+#include <fmt/format.h>
+#include <fmt/chrono.h>
+#else
+#include <format>
+#endif
+
+namespace engine
+{
+#ifdef ENGINE_USE_FMT
+	using fmt::format;
+	using fmt::format_to;
+	using fmt::vformat;
+	using fmt::vformat_to;
+	using fmt::make_format_args;
+
+	template<typename... Args>
+	using format_string = fmt::format_string<Args...>;
+
+	// 書式の文字列を取り出す
+	template<typename FormatString>
+	inline std::string_view get_format_text(const FormatString& format)
+	{
+		fmt::string_view text = format;
+		return std::string_view(text.data(), text.size());
+	}
+#else
+	using std::format;
+	using std::format_to;
+	using std::vformat;
+	using std::vformat_to;
+	using std::make_format_args;
+
+	template<typename... Args>
+	using format_string = std::format_string<Args...>;
+
+	// 書式の文字列を取り出す
+	template<typename FormatString>
+	inline std::string_view get_format_text(const FormatString& format)
+	{
+		return format.get();
+	}
+#endif
+}
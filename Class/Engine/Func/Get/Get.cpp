@@ -37,7 +37,7 @@ Microsoft::WRL::ComPtr<IDXGIAdapter4> GetUseAdapter(std::ostream& os, Microsoft:
 		if (!(adapterDesc.Flags & DXGI_ADAPTER_FLAG3_SOFTWARE))
 		{
 			// 採用したアダプタの情報をログに出力
-			Log(os ,ConvertString(std::format(L"Use Adapter : {} \n", adapterDesc.Description)));
+			Log(os, std::format("Use Adapter : {} \n", ConvertString(std::wstring(adapterDesc.Description))));
 			break;
 		}
 
@@ -0,0 +1,52 @@
+#include "Hash.h"
+
+/// <summary>
+/// バイト列のハッシュ値を求める（FNV-1a 64bit）
+/// </summary>
+/// <param name="data">データの先頭</param>
+/// <param name="size">バイト数</param>
+/// <param name="seed">続けて求めるときの、前回のハッシュ値</param>
+/// <returns>ハッシュ値</returns>
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+/// <summary>
+/// 文字列のハッシュ値を求める
+/// </summary>
+/// <param name="str">文字列</param>
+/// <param name="seed">続けて求めるときの、前回のハッシュ値</param>
+/// <returns>ハッシュ値</returns>
+uint64_t HashString(const std::string& str, uint64_t seed)
+{
+	return HashBytes(str.data(), str.size(), seed);
+}
+
+/// <summary>
+/// ハッシュ値を16桁の16進数の文字列にする
+/// </summary>
+/// <param name="hash">ハッシュ値</param>
+/// <returns>文字列</returns>
+std::string HashToString(uint64_t hash)
+{
+	const char kDigits[] = "0123456789abcdef";
+	std::string str(16, '0');
+
+	for (int32_t i = 15; i >= 0; --i)
+	{
+		str[i] = kDigits[hash & 0xF];
+		hash >>= 4;
+	}
+
+	return str;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+// FNV-1a の初期値
+const uint64_t kHashOffsetBasis = 14695981039346656037ull;
+
+/// <summary>
+/// バイト列のハッシュ値を求める（FNV-1a 64bit）
+/// </summary>
+/// <param name="data">データの先頭</param>
+/// <param name="size">バイト数</param>
+/// <param name="seed">続けて求めるときの、前回のハッシュ値</param>
+/// <returns>ハッシュ値</returns>
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = kHashOffsetBasis);
+
+/// <summary>
+/// 文字列のハッシュ値を求める
+/// </summary>
+/// <param name="str">文字列</param>
+/// <param name="seed">続けて求めるときの、前回のハッシュ値</param>
+/// <returns>ハッシュ値</returns>
+uint64_t HashString(const std::string& str, uint64_t seed = kHashOffsetBasis);
+
+/// <summary>
+/// ハッシュ値を16桁の16進数の文字列にする
+/// </summary>
+/// <param name="hash">ハッシュ値</param>
+/// <returns>文字列</returns>
+std::string HashToString(uint64_t hash);
@@ -0,0 +1,298 @@
+#include "MeshFile.h"
+
+// 頂点をそのままのバイト列で比べるためのハッシュ
+typedef struct VertexDataHash
+{
+	size_t operator()(const VertexData& vertex) const
+	{
+		return static_cast<size_t>(HashBytes(&vertex, sizeof(VertexData)));
+	}
+}VertexDataHash;
+
+// 頂点をそのままのバイト列で比べる
+typedef struct VertexDataEqual
+{
+	bool operator()(const VertexData& a, const VertexData& b) const
+	{
+		return std::memcmp(&a, &b, sizeof(VertexData)) == 0;
+	}
+}VertexDataEqual;
+
+/// <summary>
+/// 揃えの倍数に切り上げる
+/// </summary>
+/// <param name="value">値</param>
+/// <returns></returns>
+static uint64_t AlignMeshOffset(uint64_t value)
+{
+	return (value + kMeshFileAlignment - 1) & ~uint64_t(kMeshFileAlignment - 1);
+}
+
+/// <summary>
+/// 元のObjファイルに対応する、クック済みのメッシュファイルのパスを求める
+/// </summary>
+/// <param name="directoryPath">ディレクトリ</param>
+/// <param name="filename">ファイル名</param>
+/// <returns></returns>
+std::string GetMeshCachePath(const std::string& directoryPath, const std::string& filename)
+{
+	std::string filePath = directoryPath + "/" + filename;
+
+	// 元のファイルが更新されたら、別のキャッシュになるようにする
+	uint64_t stamp = AssetFile::GetStamp(filePath);
+
+	uint64_t hash = HashString(filePath);
+	hash = HashBytes(&stamp, sizeof(stamp), hash);
+	hash = HashBytes(&kMeshFileVersion, sizeof(kMeshFileVersion), hash);
+
+	return kMeshCacheDirectory + "/" + HashToString(hash) + ".mesh";
+}
+
+/// <summary>
+/// モデルデータをインデックス付きのメッシュファイルに書き出す
+/// </summary>
+/// <param name="modelData">モデルデータ</param>
+/// <param name="filePath">書き出すファイルパス</param>
+/// <returns>書き出せたかどうか</returns>
+bool CookMeshFile(const ModelData& modelData, const std::string& filePath)
+{
+	/*-----------------------------------
+	    同じ頂点をまとめて、インデックスを作る
+	-----------------------------------*/
+
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+	std::unordered_map<VertexData, uint32_t, VertexDataHash, VertexDataEqual> vertexIndices;
+
+	vertices.reserve(modelData.vertices.size());
+	indices.reserve(modelData.vertices.size());
+	vertexIndices.reserve(modelData.vertices.size());
+
+	// 境界ボックスは最初の頂点から広げていく
+	MeshBounds bounds{};
+	if (modelData.vertices.empty() == false)
+	{
+		const Vector4& position = modelData.vertices.front().position;
+		bounds.min = { position.x, position.y, position.z };
+		bounds.max = bounds.min;
+	}
+
+	for (const VertexData& vertex : modelData.vertices)
+	{
+		auto [it, isInserted] = vertexIndices.try_emplace(vertex, uint32_t(vertices.size()));
+		if (isInserted)
+		{
+			vertices.push_back(vertex);
+		}
+
+		indices.push_back(it->second);
+
+		// 境界ボックスを広げる
+		const Vector4& position = vertex.position;
+		bounds.min = { (std::min)(bounds.min.x, position.x), (std::min)(bounds.min.y, position.y), (std::min)(bounds.min.z, position.z) };
+		bounds.max = { (std::max)(bounds.max.x, position.x), (std::max)(bounds.max.y, position.y), (std::max)(bounds.max.z, position.z) };
+	}
+
+
+	/*-------------------------
+	    マテリアルの参照を並べる
+	-------------------------*/
+
+	// 長さと文字列を続けて並べる
+	std::vector<uint8_t> materials;
+	uint32_t numMaterials = 0;
+
+	// 表の位置がそのままサブメッシュのマテリアル番号になる（テクスチャが無ければ空の文字列）
+	std::vector<MaterialData> materialDatas = modelData.materials;
+	if (materialDatas.empty())
+	{
+		materialDatas.push_back(MaterialData{});
+	}
+
+	for (const MaterialData& material : materialDatas)
+	{
+		const std::string& path = material.textureFilePath;
+		uint32_t length = uint32_t(path.size());
+
+		materials.insert(materials.end(), reinterpret_cast<const uint8_t*>(&length), reinterpret_cast<const uint8_t*>(&length) + sizeof(length));
+		materials.insert(materials.end(), path.begin(), path.end());
+		numMaterials++;
+	}
+
+	// 頂点は並びを変えずにインデックスにしたので、頂点の範囲はそのままインデックスの範囲になる
+	std::vector<SubMesh> subMeshes = modelData.subMeshes;
+	if (subMeshes.empty())
+	{
+		subMeshes.push_back({ 0, uint32_t(indices.size()), 0 });
+	}
+
+
+	/*----------------------------
+	    セクションの配置を決める
+	----------------------------*/
+
+	const void* sectionData[kNumMeshSections] = { vertices.data(), indices.data(), &bounds, materials.data(), subMeshes.data() };
+
+	MeshFileSection sections[kNumMeshSections] =
+	{
+		{ kMeshSectionVertices, uint32_t(vertices.size()), 0, vertices.size() * sizeof(VertexData) },
+		{ kMeshSectionIndices, uint32_t(indices.size()), 0, indices.size() * sizeof(uint32_t) },
+		{ kMeshSectionBounds, 1, 0, sizeof(MeshBounds) },
+		{ kMeshSectionMaterials, numMaterials, 0, materials.size() },
+		{ kMeshSectionSubMeshes, uint32_t(subMeshes.size()), 0, subMeshes.size() * sizeof(SubMesh) }
+	};
+
+	MeshFileHeader header{ kMeshFileMagic, kMeshFileVersion, kNumMeshSections, 0 };
+
+	uint64_t offset = sizeof(MeshFileHeader) + sizeof(sections);
+	for (MeshFileSection& section : sections)
+	{
+		offset = AlignMeshOffset(offset);
+		section.offset = offset;
+		offset += section.size;
+	}
+
+
+	/*---------------
+	    書き出す
+	---------------*/
+
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+
+	std::ofstream file(filePath, std::ios_base::binary | std::ios_base::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+
+	const char padding[kMeshFileAlignment] = {};
+	uint64_t written = sizeof(MeshFileHeader) + sizeof(sections);
+
+	for (uint32_t i = 0; i < kNumMeshSections; ++i)
+	{
+		file.write(padding, std::streamsize(sections[i].offset - written));
+		file.write(reinterpret_cast<const char*>(sectionData[i]), std::streamsize(sections[i].size));
+		written = sections[i].offset + sections[i].size;
+	}
+
+	return file.good();
+}
+
+/// <summary>
+/// マップしたメッシュファイルを解釈する（コピーはせず、マップしたメモリを指す）
+/// </summary>
+/// <param name="file">マップしたファイル</param>
+/// <param name="view">中身</param>
+/// <returns>正しい形式かどうか</returns>
+bool LoadMeshFile(const MappedFile& file, MeshFileView& view)
+{
+	view = MeshFileView{};
+
+	const uint8_t* data = file.GetData();
+	size_t size = file.GetSize();
+
+	if (data == nullptr || size < sizeof(MeshFileHeader))
+		return false;
+
+	// ヘッダを確かめる
+	const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(data);
+	if (header->magic != kMeshFileMagic || header->version != kMeshFileVersion)
+		return false;
+
+	if (size < sizeof(MeshFileHeader) + uint64_t(header->numSections) * sizeof(MeshFileSection))
+		return false;
+
+	const MeshFileSection* sections = reinterpret_cast<const MeshFileSection*>(data + sizeof(MeshFileHeader));
+	bool hasBounds = false;
+
+	for (uint32_t i = 0; i < header->numSections; ++i)
+	{
+		const MeshFileSection& section = sections[i];
+
+		// ファイルの外や、揃っていない場所を指していたら壊れている
+		if (section.offset > size || section.size > size - section.offset || section.offset % kMeshFileAlignment != 0)
+			return false;
+
+		const uint8_t* sectionData = data + section.offset;
+
+		switch (section.type)
+		{
+		case kMeshSectionVertices:
+
+			if (section.size != uint64_t(section.count) * sizeof(VertexData))
+				return false;
+
+			view.vertices = std::span<const VertexData>(reinterpret_cast<const VertexData*>(sectionData), section.count);
+			break;
+
+		case kMeshSectionIndices:
+
+			if (section.size != uint64_t(section.count) * sizeof(uint32_t))
+				return false;
+
+			view.indices = std::span<const uint32_t>(reinterpret_cast<const uint32_t*>(sectionData), section.count);
+			break;
+
+		case kMeshSectionBounds:
+
+			if (section.size != sizeof(MeshBounds))
+				return false;
+
+			std::memcpy(&view.bounds, sectionData, sizeof(MeshBounds));
+			hasBounds = true;
+			break;
+
+		case kMeshSectionMaterials:
+		{
+			uint64_t position = 0;
+
+			for (uint32_t material = 0; material < section.count; ++material)
+			{
+				uint32_t length = 0;
+				if (section.size - position < sizeof(length))
+					return false;
+
+				std::memcpy(&length, sectionData + position, sizeof(length));
+				position += sizeof(length);
+
+				if (section.size - position < length)
+					return false;
+
+				view.materialFilePaths.emplace_back(reinterpret_cast<const char*>(sectionData + position), length);
+				position += length;
+			}
+
+			break;
+		}
+
+		case kMeshSectionSubMeshes:
+
+			if (section.size != uint64_t(section.count) * sizeof(SubMesh))
+				return false;
+
+			view.subMeshes = std::span<const SubMesh>(reinterpret_cast<const SubMesh*>(sectionData), section.count);
+			break;
+
+		default:
+
+			// 知らないセクションは読み飛ばす
+			break;
+		}
+	}
+
+	if (hasBounds == false || view.vertices.empty() || view.indices.empty() || view.subMeshes.empty())
+		return false;
+
+	// サブメッシュがインデックスとマテリアルの範囲内にあること（インデックスが頂点の外を指していないことは、クック時に保証している）
+	for (const SubMesh& subMesh : view.subMeshes)
+	{
+		if (uint64_t(subMesh.indexStart) + subMesh.indexCount > view.indices.size())
+			return false;
+
+		if (subMesh.materialIndex >= view.materialFilePaths.size())
+			return false;
+	}
+
+	return true;
+}
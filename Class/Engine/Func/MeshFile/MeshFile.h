@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <span>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <cassert>
+#include "../../Struct.h"
+#include "../Hash/Hash.h"
+#include "../StringInfo/StringInfo.h"
+#include "../ModelData/ModelData.h"
+#include "../ObjParser/ObjParser.h"
+#include "../../Class/MappedFile/MappedFile.h"
+#include "../../Class/AssetFile/AssetFile.h"
+#include "../Format/Format.h"
+
+// クックしたメッシュを置くディレクトリ
+const std::string kMeshCacheDirectory = "Class/Engine/Cache/Meshes";
+
+// メッシュファイルの識別子（"MESH"）
+const uint32_t kMeshFileMagic = 0x4853454D;
+
+// メッシュファイルのバージョン（形式を変えたら更新する）
+const uint32_t kMeshFileVersion = 2;
+
+// 各セクションの先頭の揃え
+const uint32_t kMeshFileAlignment = 16;
+
+// セクションの種類
+const uint32_t kMeshSectionVertices = 0;
+const uint32_t kMeshSectionIndices = 1;
+const uint32_t kMeshSectionBounds = 2;
+const uint32_t kMeshSectionMaterials = 3;
+const uint32_t kMeshSectionSubMeshes = 4;
+
+// 書き出すセクションの数
+const uint32_t kNumMeshSections = 5;
+
+// メッシュファイルのヘッダ
+typedef struct MeshFileHeader
+{
+	// 識別子
+	uint32_t magic;
+
+	// バージョン
+	uint32_t version;
+
+	// セクションの数
+	uint32_t numSections;
+
+	// 予約
+	uint32_t reserved;
+}MeshFileHeader;
+
+// メッシュファイルのセクション
+typedef struct MeshFileSection
+{
+	// 種類
+	uint32_t type;
+
+	// 要素数
+	uint32_t count;
+
+	// ファイルの先頭からの位置
+	uint64_t offset;
+
+	// バイト数
+	uint64_t size;
+}MeshFileSection;
+
+// マップしたメッシュファイルの中身（頂点とインデックスはマップしたメモリをそのまま指す）
+typedef struct MeshFileView
+{
+	std::span<const VertexData> vertices;
+	std::span<const uint32_t> indices;
+	std::span<const SubMesh> subMeshes;
+	MeshBounds bounds;
+	std::vector<std::string> materialFilePaths;
+}MeshFileView;
+
+/// <summary>
+/// 元のObjファイルに対応する、クック済みのメッシュファイルのパスを求める
+/// </summary>
+/// <param name="directoryPath">ディレクトリ</param>
+/// <param name="filename">ファイル名</param>
+/// <returns></returns>
+std::string GetMeshCachePath(const std::string& directoryPath, const std::string& filename);
+
+/// <summary>
+/// モデルデータをインデックス付きのメッシュファイルに書き出す
+/// </summary>
+/// <param name="modelData">モデルデータ</param>
+/// <param name="filePath">書き出すファイルパス</param>
+/// <returns>書き出せたかどうか</returns>
+bool CookMeshFile(const ModelData& modelData, const std::string& filePath);
+
+/// <summary>
+/// マップしたメッシュファイルを解釈する（コピーはせず、マップしたメモリを指す）
+/// </summary>
+/// <param name="file">マップしたファイル</param>
+/// <param name="view">中身</param>
+/// <returns>正しい形式かどうか</returns>
+bool LoadMeshFile(const MappedFile& file, MeshFileView& view);
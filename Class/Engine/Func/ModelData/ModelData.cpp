@@ -1,54 +1,88 @@
 #include "ModelData.h"
 
 /// <summary>
-/// Mtlファイルを読み込む
+/// Mtlファイルを読み込む（newmtlごとに1つのマテリアルにする）
 /// </summary>
 /// <param name="directoryPath"></param>
 /// <param name="filename"></param>
 /// <returns></returns>
-MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
+std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
 {
 	/*-----------------------------------
 		必要な変数の宣言と、ファイルを開く
 	-----------------------------------*/
 
 	// マテリアルデータ
-	MaterialData materialData;
+	std::vector<MaterialData> materialDatas;
 
 	// ファイルから読んだ1行を格納するもの
 	std::string line;
 
-	// ファイルを開く
-	std::ifstream file(directoryPath + "/" + filename);
-	assert(file.is_open());
+	// ファイルを開く（マウントしたアーカイブにあれば、そこから読む）
+	AssetFile file;
+	bool isOpen = file.Open(directoryPath + "/" + filename);
+	assert(isOpen);
 
-	while (std::getline(file, line))
+	while (std::getline(file.GetStream(), line))
 	{
 		std::string identifier;
 		std::istringstream s(line);
 		s >> identifier;
 
 		// identifierに応じた処理
-		if (identifier == "map_Kd")
+		if (identifier == "newmtl")
+		{
+			// 新しいマテリアルを始める
+			MaterialData materialData;
+			s >> materialData.name;
+			materialDatas.push_back(materialData);
+		}
+		else if (identifier == "map_Kd")
 		{
 			std::string textureFilename;
 			s >> textureFilename;
 
+			// newmtlの無いファイルでも読めるようにする
+			if (materialDatas.empty())
+			{
+				materialDatas.push_back(MaterialData{});
+			}
+
 			// 連結してファイルパスにする
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
+			materialDatas.back().textureFilePath = directoryPath + "/" + textureFilename;
 		}
 	}
 
-	return materialData;
+	return materialDatas;
 }
 
 /// <summary>
-/// Objファイルを読み込む
+/// Objファイルを読み込む（ファイルをマップし、並列に解釈する。マウントしたアーカイブにあれば、そこから読む）
 /// </summary>
 /// <param name="directoryPath"></param>
 /// <param name="filename"></param>
 /// <returns></returns>
 ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename)
+{
+	AssetFile file;
+	bool isOpen = file.Open(directoryPath + "/" + filename);
+	assert(isOpen);
+
+	if (isOpen == false)
+		return ModelData{};
+
+	const uint32_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+	return ParseObj(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), directoryPath, maxThreads);
+}
+
+/// <summary>
+/// Objファイルを1行ずつ文字列にして読み込む（比較用の以前の読み方）
+/// </summary>
+/// <param name="directoryPath"></param>
+/// <param name="filename"></param>
+/// <returns></returns>
+ModelData LoadObjFileStream(const std::string& directoryPath, const std::string& filename)
 {
 	/*----------------------------------
 	    必要な変数の宣言とファイルを開く
@@ -153,9 +187,18 @@ ModelData LoadObjFile(const std::string& directoryPath, const std::string& filen
 			std::string materialFilename;
 			s >> materialFilename;
 
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
+			std::vector<MaterialData> materials = LoadMaterialTemplateFile(directoryPath, materialFilename);
+			modelData.materials.insert(modelData.materials.end(), materials.begin(), materials.end());
 		}
 	}
 
+	// この読み方ではマテリアルを使い分けず、全体を1つのサブメッシュにする
+	if (modelData.materials.empty())
+	{
+		modelData.materials.push_back(MaterialData{});
+	}
+
+	modelData.subMeshes.push_back({ 0, uint32_t(modelData.vertices.size()), 0 });
+
 	return modelData;
 }
\ No newline at end of file
@@ -5,19 +5,30 @@
 #include <sstream>
 #include <cassert>
 #include "../../Struct.h"
+#include "../ObjParser/ObjParser.h"
+#include "../../Class/MappedFile/MappedFile.h"
+#include "../../Class/AssetFile/AssetFile.h"
 
 /// <summary>
-/// Mtlファイルを読み込む
+/// Mtlファイルを読み込む（newmtlごとに1つのマテリアルにする）
 /// </summary>
 /// <param name="directoryPath"></param>
 /// <param name="filename"></param>
 /// <returns></returns>
-MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
 
 /// <summary>
-/// Objファイルを読み込む
+/// Objファイルを読み込む（ファイルをマップし、並列に解釈する。マウントしたアーカイブにあれば、そこから読む）
 /// </summary>
 /// <param name="directoryPath"></param>
 /// <param name="filename"></param>
 /// <returns></returns>
-ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename);
\ No newline at end of file
+ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename);
+
+/// <summary>
+/// Objファイルを1行ずつ文字列にして読み込む（比較用の以前の読み方）
+/// </summary>
+/// <param name="directoryPath"></param>
+/// <param name="filename"></param>
+/// <returns></returns>
+ModelData LoadObjFileStream(const std::string& directoryPath, const std::string& filename);
\ No newline at end of file
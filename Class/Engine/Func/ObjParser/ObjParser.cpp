@@ -0,0 +1,701 @@
+#include "ObjParser.h"
+#include "../ModelData/ModelData.h"
+
+// 面の頂点で、要素が省略されていることを表すインデックス
+static const int32_t kObjMissingIndex = INT32_MIN;
+
+// 面の1頂点（位置/UV/法線 のインデックス）
+typedef struct ObjFaceVertex
+{
+	// 正のインデックスは0始まりの絶対位置、負のインデックスは塊の中での位置に直したもの
+	int32_t indices[3];
+
+	// 塊の中での位置になっている要素（ビット）
+	uint32_t relativeMask;
+}ObjFaceVertex;
+
+// オブジェクト、グループ、マテリアルの切り替え
+typedef struct ObjGroupEvent
+{
+	// 切り替わる面の頂点の位置（塊の中）
+	size_t faceVertex;
+
+	// マテリアルの切り替え（usemtl）かどうか（falseならo、g）
+	bool isMaterial;
+
+	// 名前
+	std::string name;
+}ObjGroupEvent;
+
+// 並列に読む1つの塊
+typedef struct ObjChunk
+{
+	// 範囲（行の先頭から行の終わりまで）
+	const char* begin;
+	const char* end;
+
+	// 塊の中で定義された要素
+	std::vector<Vector4> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+
+	// 三角形に分けた面の頂点（3つで1枚）
+	std::vector<ObjFaceVertex> faceVertices;
+
+	// 切り替え
+	std::vector<ObjGroupEvent> groupEvents;
+
+	// Mtlファイル名
+	std::vector<std::string> materialFilenames;
+
+	// 前の塊までの要素の数（つなぐときに求める）
+	int32_t baseCounts[3];
+
+	// 書き込む頂点の位置（つなぐときに求める）
+	size_t vertexOffset;
+}ObjChunk;
+
+/// <summary>
+/// 空白を読み飛ばす
+/// </summary>
+/// <param name="p">読む位置</param>
+/// <param name="end">行の終わり</param>
+/// <returns></returns>
+static const char* SkipObjSpaces(const char* p, const char* end)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+	{
+		++p;
+	}
+
+	return p;
+}
+
+/// <summary>
+/// 小数を読む（読めなければ0）
+/// </summary>
+/// <param name="p">読む位置</param>
+/// <param name="end">行の終わり</param>
+/// <param name="value">読んだ値</param>
+/// <returns>読み終わった位置</returns>
+static const char* ParseObjFloat(const char* p, const char* end, float& value)
+{
+	p = SkipObjSpaces(p, end);
+
+	// from_charsは先頭の+を読まない
+	if (p < end && *p == '+')
+	{
+		++p;
+	}
+
+	std::from_chars_result result = std::from_chars(p, end, value);
+	if (result.ec != std::errc{})
+	{
+		value = 0.0f;
+		return p;
+	}
+
+	return result.ptr;
+}
+
+/// <summary>
+/// 行の残りを、前後の空白を除いた名前として読む
+/// </summary>
+/// <param name="p">読む位置</param>
+/// <param name="end">行の終わり</param>
+/// <returns></returns>
+static std::string ParseObjName(const char* p, const char* end)
+{
+	p = SkipObjSpaces(p, end);
+	while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+	{
+		--end;
+	}
+
+	return std::string(p, end);
+}
+
+/// <summary>
+/// 面の頂点の定義（位置/UV/法線）を読む
+/// </summary>
+/// <param name="p">読む位置</param>
+/// <param name="end">行の終わり</param>
+/// <param name="counts">塊の中でここまでに定義された要素の数</param>
+/// <param name="faceVertex">読んだ頂点</param>
+/// <returns>読み終わった位置（読めなければnullptr）</returns>
+static const char* ParseObjFaceVertex(const char* p, const char* end, const int32_t counts[3], ObjFaceVertex& faceVertex)
+{
+	faceVertex.indices[0] = kObjMissingIndex;
+	faceVertex.indices[1] = kObjMissingIndex;
+	faceVertex.indices[2] = kObjMissingIndex;
+	faceVertex.relativeMask = 0;
+
+	for (uint32_t element = 0; element < 3; ++element)
+	{
+		// 2つ目以降は'/'で区切られている
+		if (element > 0)
+		{
+			if (p >= end || *p != '/')
+				break;
+
+			++p;
+
+			// v//vn のように省略されている
+			if (p < end && *p == '/')
+				continue;
+		}
+
+		int32_t index = 0;
+		std::from_chars_result result = std::from_chars(p, end, index);
+		if (result.ec != std::errc{} || index == 0)
+		{
+			// 位置は省略できない
+			if (element == 0)
+				return nullptr;
+
+			continue;
+		}
+
+		p = result.ptr;
+
+		if (index > 0)
+		{
+			faceVertex.indices[element] = index - 1;
+		}
+		else
+		{
+			// 負のインデックスは直前に定義された要素から数える
+			faceVertex.indices[element] = counts[element] + index;
+			faceVertex.relativeMask |= 1u << element;
+		}
+	}
+
+	return p;
+}
+
+/// <summary>
+/// 1つの塊を読む
+/// </summary>
+/// <param name="chunk">塊</param>
+static void ParseObjChunk(ObjChunk& chunk)
+{
+	// 多角形の頂点（行ごとに使い回す）
+	std::vector<ObjFaceVertex> polygon;
+
+	const char* p = chunk.begin;
+
+	while (p < chunk.end)
+	{
+		// 行の範囲
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+		if (lineEnd == nullptr)
+		{
+			lineEnd = chunk.end;
+		}
+
+		const char* next = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+
+		if (lineEnd > p && lineEnd[-1] == '\r')
+		{
+			--lineEnd;
+		}
+
+		// 先頭の識別子を読む
+		const char* q = SkipObjSpaces(p, lineEnd);
+		const char* identifier = q;
+		while (q < lineEnd && *q != ' ' && *q != '\t')
+		{
+			++q;
+		}
+
+		size_t identifierLength = q - identifier;
+
+		if (identifierLength == 1 && identifier[0] == 'v')
+		{
+			// 頂点位置
+			Vector4 position;
+			q = ParseObjFloat(q, lineEnd, position.x);
+			q = ParseObjFloat(q, lineEnd, position.y);
+			q = ParseObjFloat(q, lineEnd, position.z);
+			position.w = 1.0f;
+			chunk.positions.push_back(position);
+		}
+		else if (identifierLength == 2 && identifier[0] == 'v' && identifier[1] == 't')
+		{
+			// テクスチャ座標
+			Vector2 texcoord;
+			q = ParseObjFloat(q, lineEnd, texcoord.x);
+			q = ParseObjFloat(q, lineEnd, texcoord.y);
+			chunk.texcoords.push_back(texcoord);
+		}
+		else if (identifierLength == 2 && identifier[0] == 'v' && identifier[1] == 'n')
+		{
+			// 頂点法線
+			Vector3 normal;
+			q = ParseObjFloat(q, lineEnd, normal.x);
+			q = ParseObjFloat(q, lineEnd, normal.y);
+			q = ParseObjFloat(q, lineEnd, normal.z);
+			chunk.normals.push_back(normal);
+		}
+		else if (identifierLength == 1 && identifier[0] == 'f')
+		{
+			// 面（多角形は扇形に三角形へ分ける）
+			const int32_t counts[3] = { int32_t(chunk.positions.size()), int32_t(chunk.texcoords.size()), int32_t(chunk.normals.size()) };
+
+			polygon.clear();
+
+			while (true)
+			{
+				q = SkipObjSpaces(q, lineEnd);
+				if (q >= lineEnd)
+					break;
+
+				ObjFaceVertex faceVertex;
+				const char* parsed = ParseObjFaceVertex(q, lineEnd, counts, faceVertex);
+				if (parsed == nullptr)
+					break;
+
+				polygon.push_back(faceVertex);
+				q = parsed;
+			}
+
+			for (size_t i = 1; i + 1 < polygon.size(); ++i)
+			{
+				chunk.faceVertices.push_back(polygon[0]);
+				chunk.faceVertices.push_back(polygon[i]);
+				chunk.faceVertices.push_back(polygon[i + 1]);
+			}
+		}
+		else if (identifierLength == 6 && std::memcmp(identifier, "mtllib", 6) == 0)
+		{
+			// MaterialTemplateLibraryファイル名を取得する
+			chunk.materialFilenames.push_back(ParseObjName(q, lineEnd));
+		}
+		else if (identifierLength == 6 && std::memcmp(identifier, "usemtl", 6) == 0)
+		{
+			// マテリアルの切り替え
+			chunk.groupEvents.push_back({ chunk.faceVertices.size(), true, ParseObjName(q, lineEnd) });
+		}
+		else if (identifierLength == 1 && (identifier[0] == 'o' || identifier[0] == 'g'))
+		{
+			// オブジェクト、グループの切り替え
+			chunk.groupEvents.push_back({ chunk.faceVertices.size(), false, ParseObjName(q, lineEnd) });
+		}
+
+		p = next;
+	}
+}
+
+/// <summary>
+/// 面の頂点のインデックスを、ファイル全体での位置に直す（範囲外なら-1）
+/// </summary>
+/// <param name="faceVertex">面の頂点</param>
+/// <param name="element">要素（位置/UV/法線）</param>
+/// <param name="chunk">頂点のある塊</param>
+/// <param name="count">ファイル全体の要素の数</param>
+/// <returns></returns>
+static int32_t ResolveObjIndex(const ObjFaceVertex& faceVertex, uint32_t element, const ObjChunk& chunk, int32_t count)
+{
+	int32_t index = faceVertex.indices[element];
+	if (index == kObjMissingIndex)
+		return -1;
+
+	if (faceVertex.relativeMask & (1u << element))
+	{
+		index += chunk.baseCounts[element];
+	}
+
+	if (index < 0 || index >= count)
+		return -1;
+
+	return index;
+}
+
+/// <summary>
+/// 塊の三角形を、ファイル全体の要素から頂点に組み立てる
+/// </summary>
+/// <param name="chunk">塊</param>
+/// <param name="positions">ファイル全体の位置</param>
+/// <param name="texcoords">ファイル全体のテクスチャ座標</param>
+/// <param name="normals">ファイル全体の法線</param>
+/// <param name="vertices">書き込む先</param>
+static void BuildObjChunkVertices(const ObjChunk& chunk, const std::vector<Vector4>& positions, const std::vector<Vector2>& texcoords,
+	const std::vector<Vector3>& normals, VertexData* vertices)
+{
+	const int32_t counts[3] = { int32_t(positions.size()), int32_t(texcoords.size()), int32_t(normals.size()) };
+
+	VertexData* out = vertices + chunk.vertexOffset;
+
+	for (size_t face = 0; face + 2 < chunk.faceVertices.size(); face += 3)
+	{
+		VertexData triangle[3];
+		bool hasNormals = true;
+
+		for (uint32_t feceVertex = 0; feceVertex < 3; ++feceVertex)
+		{
+			const ObjFaceVertex& faceVertex = chunk.faceVertices[face + feceVertex];
+
+			int32_t positionIndex = ResolveObjIndex(faceVertex, 0, chunk, counts[0]);
+			int32_t texcoordIndex = ResolveObjIndex(faceVertex, 1, chunk, counts[1]);
+			int32_t normalIndex = ResolveObjIndex(faceVertex, 2, chunk, counts[2]);
+			assert(positionIndex >= 0);
+
+			triangle[feceVertex].position = positionIndex >= 0 ? positions[positionIndex] : Vector4{ 0.0f , 0.0f , 0.0f , 1.0f };
+			triangle[feceVertex].texcoord = texcoordIndex >= 0 ? texcoords[texcoordIndex] : Vector2{ 0.0f , 0.0f };
+			triangle[feceVertex].normal = normalIndex >= 0 ? normals[normalIndex] : Vector3{ 0.0f , 0.0f , 0.0f };
+
+			hasNormals = hasNormals && normalIndex >= 0;
+		}
+
+		// 法線が無ければ面の法線を使う
+		if (hasNormals == false)
+		{
+			const Vector4& p0 = triangle[0].position;
+			const Vector4& p1 = triangle[1].position;
+			const Vector4& p2 = triangle[2].position;
+
+			Vector3 e1 = { p1.x - p0.x , p1.y - p0.y , p1.z - p0.z };
+			Vector3 e2 = { p2.x - p0.x , p2.y - p0.y , p2.z - p0.z };
+			Vector3 normal = { e1.y * e2.z - e1.z * e2.y , e1.z * e2.x - e1.x * e2.z , e1.x * e2.y - e1.y * e2.x };
+
+			float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if (length > 0.0f)
+			{
+				normal = { normal.x / length , normal.y / length , normal.z / length };
+			}
+
+			for (VertexData& vertex : triangle)
+			{
+				vertex.normal = normal;
+			}
+		}
+
+		// 右手系から左手系に直す
+		for (VertexData& vertex : triangle)
+		{
+			vertex.position.x *= -1.0f;
+			vertex.normal.x *= -1.0f;
+			vertex.texcoord.y = 1.0f - vertex.texcoord.y;
+		}
+
+		// 回り順を逆にする
+		out[face + 0] = triangle[2];
+		out[face + 1] = triangle[1];
+		out[face + 2] = triangle[0];
+	}
+}
+
+/// <summary>
+/// マテリアルの名前から、表の位置を探す（見つからなければ0）
+/// </summary>
+/// <param name="materials">マテリアルの表</param>
+/// <param name="name">名前</param>
+/// <returns></returns>
+static uint32_t FindObjMaterial(const std::vector<MaterialData>& materials, const std::string& name)
+{
+	for (uint32_t i = 0; i < materials.size(); ++i)
+	{
+		if (materials[i].name == name)
+			return i;
+	}
+
+	return 0;
+}
+
+/// <summary>
+/// 塊の切り替えを順にたどり、オブジェクトとマテリアルが同じ範囲ごとにサブメッシュを作る
+/// </summary>
+/// <param name="chunks">つないだ塊</param>
+/// <param name="numVertices">頂点の数</param>
+/// <param name="materials">マテリアルの表</param>
+/// <returns></returns>
+static std::vector<SubMesh> BuildObjSubMeshes(const std::vector<ObjChunk>& chunks, size_t numVertices, const std::vector<MaterialData>& materials)
+{
+	std::vector<SubMesh> subMeshes;
+
+	uint32_t start = 0;
+	uint32_t materialIndex = 0;
+
+	// 範囲を閉じる（面が無ければ作らない）
+	auto closeSubMesh = [&](size_t end)
+		{
+			if (end > start)
+			{
+				subMeshes.push_back({ start, uint32_t(end) - start, materialIndex });
+			}
+
+			start = uint32_t(end);
+		};
+
+	for (const ObjChunk& chunk : chunks)
+	{
+		for (const ObjGroupEvent& event : chunk.groupEvents)
+		{
+			closeSubMesh(chunk.vertexOffset + event.faceVertex);
+
+			if (event.isMaterial)
+			{
+				materialIndex = FindObjMaterial(materials, event.name);
+			}
+		}
+	}
+
+	closeSubMesh(numVertices);
+
+	return subMeshes;
+}
+
+/// <summary>
+/// 塊ごとの処理をスレッドで並列に行う（最初の塊は呼び出したスレッドで行う）
+/// </summary>
+/// <param name="chunks">塊</param>
+/// <param name="function">処理</param>
+template<typename Function>
+static void ForEachObjChunk(std::vector<ObjChunk>& chunks, Function function)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(chunks.size());
+
+	for (size_t i = 1; i < chunks.size(); ++i)
+	{
+		threads.emplace_back(function, std::ref(chunks[i]));
+	}
+
+	if (chunks.empty() == false)
+	{
+		function(chunks[0]);
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/// <summary>
+/// メモリ上のObjファイルの中身を解釈する（行の途中で切らないように塊に分け、並列に読んでからつなぐ）
+/// </summary>
+/// <param name="data">ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="directoryPath">Mtlファイルを探すディレクトリ</param>
+/// <param name="maxThreads">使うスレッドの最大数</param>
+/// <returns></returns>
+ModelData ParseObj(const char* data, size_t size, const std::string& directoryPath, uint32_t maxThreads)
+{
+	/*-----------------------------
+	    行の区切りで塊に分ける
+	-----------------------------*/
+
+	size_t numChunks = (std::max)(size_t(1), (std::min)(size_t((std::max)(maxThreads, 1u)), size / kObjMinChunkBytes));
+
+	std::vector<ObjChunk> chunks(numChunks);
+	const char* end = data + size;
+	const char* begin = data;
+
+	for (size_t i = 0; i < numChunks; ++i)
+	{
+		const char* chunkEnd = (i + 1 == numChunks) ? end : data + size * (i + 1) / numChunks;
+
+		// 次の改行まで広げる
+		if (chunkEnd < begin)
+		{
+			chunkEnd = begin;
+		}
+
+		const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+		chunkEnd = (i + 1 == numChunks || newline == nullptr) ? end : newline + 1;
+
+		chunks[i].begin = begin;
+		chunks[i].end = chunkEnd;
+		begin = chunkEnd;
+	}
+
+
+	/*----------------------
+	    塊ごとに並列で読む
+	----------------------*/
+
+	ForEachObjChunk(chunks, [](ObjChunk& chunk) { ParseObjChunk(chunk); });
+
+
+	/*--------------------------------------------
+	    塊をつなぎ、要素と頂点の位置をずらす量を求める
+	--------------------------------------------*/
+
+	std::vector<Vector4> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+	size_t numVertices = 0;
+	std::vector<std::string> materialFilenames;
+
+	for (ObjChunk& chunk : chunks)
+	{
+		chunk.baseCounts[0] = int32_t(positions.size());
+		chunk.baseCounts[1] = int32_t(texcoords.size());
+		chunk.baseCounts[2] = int32_t(normals.size());
+		chunk.vertexOffset = numVertices;
+
+		positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+		texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+		normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+		numVertices += chunk.faceVertices.size();
+
+		for (const std::string& materialFilename : chunk.materialFilenames)
+		{
+			if (std::find(materialFilenames.begin(), materialFilenames.end(), materialFilename) == materialFilenames.end())
+			{
+				materialFilenames.push_back(materialFilename);
+			}
+		}
+	}
+
+
+	/*-------------------------------
+	    塊ごとに並列で頂点を組み立てる
+	-------------------------------*/
+
+	ModelData modelData;
+	modelData.vertices.resize(numVertices);
+
+	ForEachObjChunk(chunks, [&](ObjChunk& chunk) { BuildObjChunkVertices(chunk, positions, texcoords, normals, modelData.vertices.data()); });
+
+
+	/*-------------------------------------------
+	    マテリアルの表と、サブメッシュの範囲を作る
+	-------------------------------------------*/
+
+	for (const std::string& materialFilename : materialFilenames)
+	{
+		std::vector<MaterialData> materials = LoadMaterialTemplateFile(directoryPath, materialFilename);
+		modelData.materials.insert(modelData.materials.end(), materials.begin(), materials.end());
+	}
+
+	// マテリアルが無くても、サブメッシュが指せるものを1つ用意する
+	if (modelData.materials.empty())
+	{
+		modelData.materials.push_back(MaterialData{});
+	}
+
+	modelData.subMeshes = BuildObjSubMeshes(chunks, numVertices, modelData.materials);
+
+	return modelData;
+}
+
+/// <summary>
+/// 面の頂点の定義（位置/UV/法線）のインデックスをずらす
+/// </summary>
+/// <param name="vertexDefinition">頂点の定義</param>
+/// <param name="offsets">位置、UV、法線のずらす量</param>
+/// <returns></returns>
+static std::string OffsetFaceVertex(const std::string& vertexDefinition, const uint32_t offsets[3])
+{
+	std::string result;
+	std::istringstream v(vertexDefinition);
+	std::string index;
+
+	for (uint32_t element = 0; element < 3 && std::getline(v, index, '/'); ++element)
+	{
+		if (element > 0)
+		{
+			result += '/';
+		}
+
+		if (index.empty() == false)
+		{
+			int32_t value = std::stoi(index);
+
+			// 負のインデックスは複製しても同じものを指す
+			result += std::to_string(value > 0 ? value + int32_t(offsets[element]) : value);
+		}
+	}
+
+	return result;
+}
+
+/// <summary>
+/// Objファイルを複製し、X方向にずらして並べたObjファイルを書き出す（マテリアルは含めない）
+/// </summary>
+/// <param name="directoryPath">元のディレクトリ</param>
+/// <param name="filename">元のファイル名</param>
+/// <param name="numCopies">複製する数</param>
+/// <returns>書き出したファイル名（kObjTiledDirectoryの中）</returns>
+std::string WriteTiledObjFile(const std::string& directoryPath, const std::string& filename, uint32_t numCopies)
+{
+	std::vector<std::string> positionLines;
+	std::vector<std::string> texcoordLines;
+	std::vector<std::string> normalLines;
+	std::vector<std::string> faceLines;
+
+	{
+		std::ifstream file(directoryPath + "/" + filename);
+		assert(file.is_open());
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::string identifier;
+			std::istringstream s(line);
+			s >> identifier;
+
+			if (identifier == "v")
+				positionLines.push_back(line);
+			else if (identifier == "vt")
+				texcoordLines.push_back(line);
+			else if (identifier == "vn")
+				normalLines.push_back(line);
+			else if (identifier == "f")
+				faceLines.push_back(line);
+		}
+	}
+
+	std::filesystem::create_directories(kObjTiledDirectory);
+	std::string tiledFilename = "tiled_" + std::to_string(numCopies) + "_" + filename;
+
+	std::ofstream file(kObjTiledDirectory + "/" + tiledFilename, std::ios_base::trunc);
+	assert(file.is_open());
+
+	for (uint32_t copy = 0; copy < numCopies; ++copy)
+	{
+		// 重ならないように、X方向にずらして並べる
+		float shift = float(copy) * 3.0f;
+
+		for (const std::string& line : positionLines)
+		{
+			std::istringstream s(line);
+			std::string identifier;
+			Vector3 position{};
+			s >> identifier >> position.x >> position.y >> position.z;
+			file << engine::format("v {} {} {}\n", position.x + shift, position.y, position.z);
+		}
+
+		for (const std::string& line : texcoordLines)
+			file << line << '\n';
+
+		for (const std::string& line : normalLines)
+			file << line << '\n';
+
+		const uint32_t offsets[3] =
+		{
+			uint32_t(positionLines.size()) * copy,
+			uint32_t(texcoordLines.size()) * copy,
+			uint32_t(normalLines.size()) * copy
+		};
+
+		for (const std::string& line : faceLines)
+		{
+			std::istringstream s(line);
+			std::string identifier;
+			std::string vertexDefinition;
+			s >> identifier;
+
+			file << "f";
+			while (s >> vertexDefinition)
+			{
+				file << ' ' << OffsetFaceVertex(vertexDefinition, offsets);
+			}
+			file << '\n';
+		}
+	}
+
+	return tiledFilename;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cassert>
+#include "../../Struct.h"
+#include "../StringInfo/StringInfo.h"
+#include "../../Class/MappedFile/MappedFile.h"
+#include "../Format/Format.h"
+
+// 並列に読むときの、1つの塊の最小のバイト数
+const size_t kObjMinChunkBytes = 1024 * 1024;
+
+// 計測用に複製したObjファイルを置くディレクトリ
+const std::string kObjTiledDirectory = "Class/Engine/Cache/Benchmark";
+
+/// <summary>
+/// メモリ上のObjファイルの中身を解釈する（行の途中で切らないように塊に分け、並列に読んでからつなぐ）
+/// </summary>
+/// <param name="data">ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="directoryPath">Mtlファイルを探すディレクトリ</param>
+/// <param name="maxThreads">使うスレッドの最大数</param>
+/// <returns></returns>
+ModelData ParseObj(const char* data, size_t size, const std::string& directoryPath, uint32_t maxThreads);
+
+/// <summary>
+/// Objファイルを複製し、X方向にずらして並べたObjファイルを書き出す（マテリアルは含めない）
+/// </summary>
+/// <param name="directoryPath">元のディレクトリ</param>
+/// <param name="filename">元のファイル名</param>
+/// <param name="numCopies">複製する数</param>
+/// <returns>書き出したファイル名（kObjTiledDirectoryの中）</returns>
+std::string WriteTiledObjFile(const std::string& directoryPath, const std::string& filename, uint32_t numCopies);
@@ -0,0 +1,197 @@
+#include "ShaderCache.h"
+
+/// <summary>
+/// ファイルの中身を全て読む
+/// </summary>
+/// <param name="filePath">ファイルパス</param>
+/// <param name="text">読んだ中身</param>
+/// <returns>読めたかどうか</returns>
+static bool ReadShaderText(const std::string& filePath, std::string& text)
+{
+	std::ifstream file(filePath, std::ios_base::binary);
+	if (file.is_open() == false)
+		return false;
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	text = stream.str();
+
+	return true;
+}
+
+/// <summary>
+/// 長さを先に含めて、文字列をハッシュ値に加える（続けて加えた文字列との区切りが変われば、別のハッシュ値になる）
+/// </summary>
+/// <param name="field">文字列</param>
+/// <param name="seed">前回のハッシュ値</param>
+/// <returns>ハッシュ値</returns>
+static uint64_t HashShaderKeyField(const std::string& field, uint64_t seed)
+{
+	uint64_t length = field.size();
+	seed = HashBytes(&length, sizeof(length), seed);
+	return HashString(field, seed);
+}
+
+/// <summary>
+/// インクルードを再帰的にたどる
+/// </summary>
+/// <param name="filePath">たどるファイル</param>
+/// <param name="visitedPaths">たどり済みのパス（同じファイルを2回含めない）</param>
+/// <param name="includePaths">インクルードしているファイルのパス</param>
+static void CollectShaderIncludesRecursive(const std::string& filePath, std::unordered_set<std::string>& visitedPaths, std::vector<std::string>& includePaths)
+{
+	std::string text;
+	if (ReadShaderText(filePath, text) == false)
+		return;
+
+	std::filesystem::path directoryPath = std::filesystem::path(filePath).parent_path();
+	std::istringstream lines(text);
+	std::string line;
+
+	while (std::getline(lines, line))
+	{
+		// #include "ファイル名" だけを扱う（<>は標準のものなので、変わらないとみなす）
+		size_t hash = line.find_first_not_of(" \t");
+		if (hash == std::string::npos || line.compare(hash, 8, "#include") != 0)
+			continue;
+
+		size_t begin = line.find('"', hash + 8);
+		size_t end = begin == std::string::npos ? std::string::npos : line.find('"', begin + 1);
+		if (end == std::string::npos)
+			continue;
+
+		std::string includePath = (directoryPath / line.substr(begin + 1, end - begin - 1)).lexically_normal().generic_string();
+
+		if (visitedPaths.insert(includePath).second == false)
+			continue;
+
+		if (std::filesystem::is_regular_file(includePath) == false)
+			continue;
+
+		includePaths.push_back(includePath);
+		CollectShaderIncludesRecursive(includePath, visitedPaths, includePaths);
+	}
+}
+
+/// <summary>
+/// シェーダーがインクルードしているファイルを、インクルードの中も含めて集める（見つからないものは含めない）
+/// </summary>
+/// <param name="filePath">シェーダーのファイルパス</param>
+/// <param name="includePaths">インクルードしているファイルのパス（見つけた順）</param>
+void CollectShaderIncludes(const std::string& filePath, std::vector<std::string>& includePaths)
+{
+	std::unordered_set<std::string> visitedPaths;
+	visitedPaths.insert(std::filesystem::path(filePath).lexically_normal().generic_string());
+
+	CollectShaderIncludesRecursive(filePath, visitedPaths, includePaths);
+}
+
+/// <summary>
+/// コンパイル済みのシェーダーのキャッシュのパスを求める（ソース、インクルード先、プロファイル、引数のどれかが変われば別のパスになる）
+/// </summary>
+/// <param name="filePath">シェーダーのファイルパス</param>
+/// <param name="profile">プロファイル</param>
+/// <param name="arguments">コンパイルの引数</param>
+/// <returns>キャッシュのパス（ソースが読めなければ空）</returns>
+std::string GetShaderCachePath(const std::string& filePath, const std::string& profile, const std::vector<std::string>& arguments)
+{
+	std::string text;
+	if (ReadShaderText(filePath, text) == false)
+		return "";
+
+	// どの文字列も長さを先に含め、ソースの終わりとプロファイルの始めのような、区切りの違うものを別のキーにする
+	uint64_t hash = HashBytes(&kShaderCacheVersion, sizeof(kShaderCacheVersion));
+	hash = HashShaderKeyField(text, hash);
+	hash = HashShaderKeyField(profile, hash);
+
+	// 引数は数も含めて、並びが変わったら別のキーにする
+	uint64_t numArguments = arguments.size();
+	hash = HashBytes(&numArguments, sizeof(numArguments), hash);
+
+	for (const std::string& argument : arguments)
+	{
+		hash = HashShaderKeyField(argument, hash);
+	}
+
+	// インクルード先は、パスと中身の両方を含める
+	std::vector<std::string> includePaths;
+	CollectShaderIncludes(filePath, includePaths);
+
+	uint64_t numIncludes = includePaths.size();
+	hash = HashBytes(&numIncludes, sizeof(numIncludes), hash);
+
+	for (const std::string& includePath : includePaths)
+	{
+		std::string includeText;
+		ReadShaderText(includePath, includeText);
+
+		hash = HashShaderKeyField(includePath, hash);
+		hash = HashShaderKeyField(includeText, hash);
+	}
+
+	return kShaderCacheDirectory + "/" + HashToString(hash) + ".cso";
+}
+
+/// <summary>
+/// コンパイル済みのシェーダーをキャッシュから読む
+/// </summary>
+/// <param name="cachePath">キャッシュのパス</param>
+/// <param name="bytes">読んだバイナリ</param>
+/// <returns>読めたかどうか</returns>
+bool ReadShaderCache(const std::string& cachePath, std::vector<uint8_t>& bytes)
+{
+	if (cachePath.empty())
+		return false;
+
+	std::ifstream file(cachePath, std::ios_base::binary | std::ios_base::ate);
+	if (file.is_open() == false)
+		return false;
+
+	std::streamoff size = file.tellg();
+	if (size <= 0)
+		return false;
+
+	bytes.resize(size_t(size));
+	file.seekg(0, std::ios_base::beg);
+	file.read(reinterpret_cast<char*>(bytes.data()), size);
+
+	return bool(file);
+}
+
+/// <summary>
+/// コンパイル済みのシェーダーをキャッシュに書き出す
+/// </summary>
+/// <param name="cachePath">キャッシュのパス</param>
+/// <param name="data">バイナリの先頭</param>
+/// <param name="size">バイト数</param>
+/// <returns>書き出せたかどうか</returns>
+bool WriteShaderCache(const std::string& cachePath, const void* data, size_t size)
+{
+	if (cachePath.empty())
+		return false;
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(kShaderCacheDirectory, errorCode);
+
+	// 書き出している途中のものを読まないように、一時ファイルに書いてから置き換える
+	std::string temporaryPath = cachePath + ".tmp";
+
+	{
+		std::ofstream file(temporaryPath, std::ios_base::binary);
+		if (file.is_open() == false)
+			return false;
+
+		file.write(reinterpret_cast<const char*>(data), size);
+		if (!file)
+			return false;
+	}
+
+	std::filesystem::rename(temporaryPath, cachePath, errorCode);
+	if (errorCode)
+	{
+		std::filesystem::remove(temporaryPath, errorCode);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <unordered_set>
+#include "../Hash/Hash.h"
+
+// コンパイル済みのシェーダーを保存するディレクトリ
+const std::string kShaderCacheDirectory = "Class/Engine/Cache/Shaders";
+
+// キャッシュのバージョン（キャッシュの形式やキーの求め方を変えたら更新する）
+const uint32_t kShaderCacheVersion = 2;
+
+/// <summary>
+/// シェーダーがインクルードしているファイルを、インクルードの中も含めて集める（見つからないものは含めない）
+/// </summary>
+/// <param name="filePath">シェーダーのファイルパス</param>
+/// <param name="includePaths">インクルードしているファイルのパス（見つけた順）</param>
+void CollectShaderIncludes(const std::string& filePath, std::vector<std::string>& includePaths);
+
+/// <summary>
+/// コンパイル済みのシェーダーのキャッシュのパスを求める（ソース、インクルード先、プロファイル、引数のどれかが変われば別のパスになる）
+/// </summary>
+/// <param name="filePath">シェーダーのファイルパス</param>
+/// <param name="profile">プロファイル</param>
+/// <param name="arguments">コンパイルの引数</param>
+/// <returns>キャッシュのパス（ソースが読めなければ空）</returns>
+std::string GetShaderCachePath(const std::string& filePath, const std::string& profile, const std::vector<std::string>& arguments);
+
+/// <summary>
+/// コンパイル済みのシェーダーをキャッシュから読む
+/// </summary>
+/// <param name="cachePath">キャッシュのパス</param>
+/// <param name="bytes">読んだバイナリ</param>
+/// <returns>読めたかどうか</returns>
+bool ReadShaderCache(const std::string& cachePath, std::vector<uint8_t>& bytes);
+
+/// <summary>
+/// コンパイル済みのシェーダーをキャッシュに書き出す
+/// </summary>
+/// <param name="cachePath">キャッシュのパス</param>
+/// <param name="data">バイナリの先頭</param>
+/// <param name="size">バイト数</param>
+/// <returns>書き出せたかどうか</returns>
+bool WriteShaderCache(const std::string& cachePath, const void* data, size_t size);
@@ -0,0 +1,151 @@
+#include "ShaderPermutation.h"
+
+/// <summary>
+/// グループの選択肢を格納するのに必要なビット数を求める
+/// </summary>
+/// <param name="numKeywords">グループの選択肢の数</param>
+/// <returns>ビット数</returns>
+uint32_t GetShaderKeywordBits(size_t numKeywords)
+{
+	uint32_t bits = 0;
+	while ((size_t(1) << bits) < numKeywords)
+	{
+		bits++;
+	}
+
+	return bits;
+}
+
+/// <summary>
+/// キーワードのグループから、全てのバリアントのキーを列挙する
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <returns>バリアントのキー（各グループで選んだ番号を、グループの順にビットに詰めたもの）</returns>
+std::vector<uint32_t> EnumerateShaderVariants(const std::vector<std::vector<std::string>>& keywordGroups)
+{
+	std::vector<uint32_t> variantKeys = { 0 };
+	uint32_t shift = 0;
+
+	// グループごとに、これまでのバリアントと選択肢の全ての組み合わせを作る
+	for (const std::vector<std::string>& keywords : keywordGroups)
+	{
+		if (keywords.empty())
+			continue;
+
+		std::vector<uint32_t> combined;
+		combined.reserve(variantKeys.size() * keywords.size());
+
+		for (uint32_t variantKey : variantKeys)
+		{
+			for (uint32_t index = 0; index < keywords.size(); ++index)
+			{
+				combined.push_back(variantKey | (index << shift));
+			}
+		}
+
+		variantKeys = std::move(combined);
+		shift += GetShaderKeywordBits(keywords.size());
+		assert(shift <= 32);
+	}
+
+	std::sort(variantKeys.begin(), variantKeys.end());
+
+	return variantKeys;
+}
+
+/// <summary>
+/// 有効にするキーワードから、バリアントのキーを求める（グループに含まれないキーワードは無視する）
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <param name="keywords">有効にするキーワード</param>
+/// <returns>バリアントのキー</returns>
+uint32_t MakeShaderVariantKey(const std::vector<std::vector<std::string>>& keywordGroups, const std::vector<std::string>& keywords)
+{
+	uint32_t variantKey = 0;
+	uint32_t shift = 0;
+
+	for (const std::vector<std::string>& groupKeywords : keywordGroups)
+	{
+		for (uint32_t index = 0; index < groupKeywords.size(); ++index)
+		{
+			if (groupKeywords[index].empty())
+				continue;
+
+			if (std::find(keywords.begin(), keywords.end(), groupKeywords[index]) != keywords.end())
+			{
+				variantKey |= index << shift;
+				break;
+			}
+		}
+
+		shift += GetShaderKeywordBits(groupKeywords.size());
+	}
+
+	return variantKey;
+}
+
+/// <summary>
+/// バリアントのキーから、コンパイルするときに定義するマクロを求める
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <param name="variantKey">バリアントのキー</param>
+/// <returns>定義するマクロ</returns>
+std::vector<std::string> GetShaderVariantDefines(const std::vector<std::vector<std::string>>& keywordGroups, uint32_t variantKey)
+{
+	std::vector<std::string> defines;
+	uint32_t shift = 0;
+
+	for (const std::vector<std::string>& keywords : keywordGroups)
+	{
+		uint32_t bits = GetShaderKeywordBits(keywords.size());
+		uint32_t index = (variantKey >> shift) & ((1u << bits) - 1);
+		shift += bits;
+
+		if (index < keywords.size() && keywords[index].empty() == false)
+		{
+			defines.push_back(keywords[index]);
+		}
+	}
+
+	return defines;
+}
+
+/// <summary>
+/// 処理を複数のスレッドに分けて行う（空いたスレッドが次の番号を取る）
+/// </summary>
+/// <param name="numJobs">処理の数</param>
+/// <param name="maxThreads">使うスレッドの最大数</param>
+/// <param name="job">番号ごとの処理（workerはスレッドの番号）</param>
+void RunParallelJobs(uint32_t numJobs, uint32_t maxThreads, const std::function<void(uint32_t job, uint32_t worker)>& job)
+{
+	uint32_t numThreads = (std::min)((std::max)(maxThreads, 1u), numJobs);
+	std::atomic<uint32_t> nextJob = 0;
+
+	auto work = [&](uint32_t worker)
+		{
+			for (uint32_t i = nextJob++; i < numJobs; i = nextJob++)
+			{
+				job(i, worker);
+			}
+		};
+
+	// 1つだけなら、スレッドを作らずにこのスレッドで行う
+	if (numThreads <= 1)
+	{
+		work(0);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (uint32_t worker = 1; worker < numThreads; ++worker)
+	{
+		threads.emplace_back(work, worker);
+	}
+
+	work(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
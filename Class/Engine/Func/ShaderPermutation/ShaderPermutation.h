@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+/*   キーワードのグループ   */
+
+// 1つのグループからは1つのキーワードだけを選ぶ（""は何も定義しない）
+// 例 : { { "", "LIGHTING_HALF_LAMBERT" } } は、ライティング無しとハーフランバートの2通り
+
+
+/// <summary>
+/// グループの選択肢を格納するのに必要なビット数を求める
+/// </summary>
+/// <param name="numKeywords">グループの選択肢の数</param>
+/// <returns>ビット数</returns>
+uint32_t GetShaderKeywordBits(size_t numKeywords);
+
+/// <summary>
+/// キーワードのグループから、全てのバリアントのキーを列挙する
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <returns>バリアントのキー（各グループで選んだ番号を、グループの順にビットに詰めたもの）</returns>
+std::vector<uint32_t> EnumerateShaderVariants(const std::vector<std::vector<std::string>>& keywordGroups);
+
+/// <summary>
+/// 有効にするキーワードから、バリアントのキーを求める（グループに含まれないキーワードは無視する）
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <param name="keywords">有効にするキーワード</param>
+/// <returns>バリアントのキー</returns>
+uint32_t MakeShaderVariantKey(const std::vector<std::vector<std::string>>& keywordGroups, const std::vector<std::string>& keywords);
+
+/// <summary>
+/// バリアントのキーから、コンパイルするときに定義するマクロを求める
+/// </summary>
+/// <param name="keywordGroups">キーワードのグループ</param>
+/// <param name="variantKey">バリアントのキー</param>
+/// <returns>定義するマクロ</returns>
+std::vector<std::string> GetShaderVariantDefines(const std::vector<std::vector<std::string>>& keywordGroups, uint32_t variantKey);
+
+/// <summary>
+/// 処理を複数のスレッドに分けて行う（空いたスレッドが次の番号を取る）
+/// </summary>
+/// <param name="numJobs">処理の数</param>
+/// <param name="maxThreads">使うスレッドの最大数</param>
+/// <param name="job">番号ごとの処理（workerはスレッドの番号）</param>
+void RunParallelJobs(uint32_t numJobs, uint32_t maxThreads, const std::function<void(uint32_t job, uint32_t worker)>& job);
@@ -1,5 +1,7 @@
 #include "StringInfo.h"
 
+#ifdef _WIN32
+
 // string -> wstring に変換する
 std::wstring ConvertString(const std::string& str)
 {
@@ -36,12 +38,13 @@ std::string ConvertString(const std::wstring& str)
     return result;
 }
 
+#endif
+
 /// <summary>
-/// ログを表示する
+/// ログを表示する（1行ずつ書き込むだけで、ファイルとデバッガへの書き出しはLoggerのスレッドが行う）
 /// </summary>
 /// <param name="message">文字列</param>
 void Log(std::ostream& os,const std::string& message)
 {
-    os << message << std::endl;
-    OutputDebugStringA(message.c_str());
+    os << message << '\n';
 }
\ No newline at end of file
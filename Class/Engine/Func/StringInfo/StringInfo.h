@@ -1,16 +1,19 @@
 #pragma once
-#include <Windows.h>
 #include <string>
 #include <fstream>
 
+#ifdef _WIN32
+#include <Windows.h>
+
 // string -> wstring に変換する
 std::wstring ConvertString(const std::string& str);
 
 // wstring -> string に変換する
 std::string ConvertString(const std::wstring& str);
+#endif
 
 /// <summary>
-/// ログを表示する
+/// ログを表示する（1行ずつ書き込むだけで、ファイルとデバッガへの書き出しはLoggerのスレッドが行う）
 /// </summary>
 /// <param name="message">文字列</param>
 void Log(std::ostream& os,const std::string& message);
\ No newline at end of file
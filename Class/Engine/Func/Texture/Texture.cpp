@@ -1,16 +1,101 @@
 #include "Texture.h"
 
+// クックの処理を変えたら、古いキャッシュを使わないように更新する
+static const uint32_t kTextureCookVersion = 1;
+
 /// <summary>
-/// テクスチャをCPUに読み込む
+/// ファイルの中身を全て読む
 /// </summary>
 /// <param name="filePath">ファイルパス</param>
 /// <returns></returns>
-DirectX::ScratchImage LoadTexture(const std::string& filePath)
+std::vector<uint8_t> ReadTextureFile(const std::string& filePath)
+{
+	// マウントしたアーカイブにあれば、そこから読む
+	AssetFile file;
+	bool isOpen = file.Open(filePath);
+	assert(isOpen);
+
+	return std::vector<uint8_t>(file.GetData(), file.GetData() + file.GetSize());
+}
+
+/// <summary>
+/// テクスチャをCPUに読み込む（クック済みのDDSがあればそれを使い、無ければクックして保存する）
+/// </summary>
+/// <param name="os">ログの出力先</param>
+/// <param name="filePath">ファイルパス</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage LoadTexture(std::ostream& os, const std::string& filePath, const TextureCookSettings& settings)
+{
+	return LoadTexture(os, filePath, ReadTextureFile(filePath), settings);
+}
+
+/// <summary>
+/// 読んだファイルの中身から、テクスチャをCPUに読み込む（クック済みのDDSがあればそれを使い、無ければクックして保存する）
+/// </summary>
+/// <param name="os">ログの出力先</param>
+/// <param name="filePath">ファイルパス（ログ用）</param>
+/// <param name="sourceBytes">ファイルの中身</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage LoadTexture(std::ostream& os, const std::string& filePath, const std::vector<uint8_t>& sourceBytes, const TextureCookSettings& settings)
+{
+	// 計測開始
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// キャッシュの場所を決める
+	std::string cachePath = GetTextureCachePath(sourceBytes.data(), sourceBytes.size(), settings);
+	std::wstring cachePathW = ConvertString(cachePath);
+
+
+	/*----------------------------
+	    クック済みのDDSを読み込む
+	----------------------------*/
+
+	DirectX::ScratchImage mipImages{};
+	bool isCacheHit = false;
+
+	if (std::filesystem::exists(cachePath))
+	{
+		HRESULT hr = DirectX::LoadFromDDSFile(cachePathW.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, mipImages);
+		isCacheHit = SUCCEEDED(hr);
+	}
+
+
+	/*------------------------------------
+	    無ければクックして、キャッシュに保存する
+	------------------------------------*/
+
+	if (isCacheHit == false)
+	{
+		mipImages = CookTexture(sourceBytes.data(), sourceBytes.size(), settings);
+
+		std::filesystem::create_directories(kTextureCacheDirectory);
+		HRESULT hr = DirectX::SaveToDDSFile(mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(),
+			DirectX::DDS_FLAGS_NONE, cachePathW.c_str());
+		assert(SUCCEEDED(hr));
+	}
+
+	// 読み込みにかかった時間
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	Log(os, std::format("LoadTexture {} : {} , {:.2f}ms", isCacheHit ? "(cache hit)" : "(cooked)", filePath, elapsed.count()));
+
+	// ミップマップ付きのデータを返却する
+	return mipImages;
+}
+
+/// <summary>
+/// 画像ファイルの中身から、最終的なミップチェーンを作る
+/// </summary>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage CookTexture(const void* data, size_t size, const TextureCookSettings& settings)
 {
 	// テクスチャファイルを読んでプログラムで扱えるようにする
 	DirectX::ScratchImage image{};
-	std::wstring filePathW = ConvertString(filePath);
-	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
+	HRESULT hr = DirectX::LoadFromWICMemory(data, size, DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
 	assert(SUCCEEDED(hr));
 
 	// ミップマップを作成する
@@ -18,22 +103,74 @@ DirectX::ScratchImage LoadTexture(const std::string& filePath)
 	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
 	assert(SUCCEEDED(hr));
 
-	// ミップマップ付きのデータを返却する
-	return mipImages;
+	if (settings.compressFormat == DXGI_FORMAT_UNKNOWN)
+	{
+		return mipImages;
+	}
+
+
+	/*------------------
+	    ブロック圧縮する
+	------------------*/
+
+	// ブロック圧縮は4の倍数の大きさでないと使えない
+	const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
+	if (metadata.width % 4 != 0 || metadata.height % 4 != 0)
+	{
+		return mipImages;
+	}
+
+	DirectX::TEX_COMPRESS_FLAGS compressFlags = DirectX::TEX_COMPRESS_PARALLEL;
+	if (settings.fastCompression)
+	{
+		compressFlags |= DirectX::TEX_COMPRESS_BC7_FAST;
+	}
+
+	// 元がSRGBなので、圧縮後もSRGBにする
+	DirectX::ScratchImage compressedImages{};
+	hr = DirectX::Compress(mipImages.GetImages(), mipImages.GetImageCount(), metadata, DirectX::MakeSRGB(settings.compressFormat),
+		compressFlags, DirectX::TEX_THRESHOLD_DEFAULT, compressedImages);
+	assert(SUCCEEDED(hr));
+
+	return compressedImages;
 }
 
 /// <summary>
-/// テクスチャのメタデータを基にに、テクスチャリソースを作成する
+/// クック済みのテクスチャのパスを求める（元のファイルの中身と設定のハッシュ値で決まる）
 /// </summary>
-/// <param name="device"></param>
-/// <param name="metadata"></param>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
 /// <returns></returns>
-Microsoft::WRL::ComPtr<ID3D12Resource> CreateTextureResource(Microsoft::WRL::ComPtr<ID3D12Device> device, const DirectX::TexMetadata& metadata)
+std::string GetTextureCachePath(const void* data, size_t size, const TextureCookSettings& settings)
 {
-	/*------------------------------------
-	    メタデータを基に、リソースを作成する
-	------------------------------------*/
+	return kTextureCacheDirectory + "/" + HashToString(HashTextureContent(data, size, settings)) + ".dds";
+}
+
+/// <summary>
+/// 元のファイルの中身と設定から、クックしたテクスチャを表すハッシュ値を求める
+/// </summary>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+uint64_t HashTextureContent(const void* data, size_t size, const TextureCookSettings& settings)
+{
+	uint64_t hash = HashBytes(data, size);
+	hash = HashBytes(&settings.compressFormat, sizeof(settings.compressFormat), hash);
+	hash = HashBytes(&settings.fastCompression, sizeof(settings.fastCompression), hash);
+	hash = HashBytes(&kTextureCookVersion, sizeof(kTextureCookVersion), hash);
 
+	return hash;
+}
+
+/// <summary>
+/// テクスチャのメタデータを基に、リソースの設定を作る
+/// </summary>
+/// <param name="metadata"></param>
+/// <returns>リソースの設定</returns>
+D3D12_RESOURCE_DESC MakeTextureResourceDesc(const DirectX::TexMetadata& metadata)
+{
 	D3D12_RESOURCE_DESC resourceDesc{};
 
 	// Textureの幅と高さ
@@ -55,6 +192,23 @@ Microsoft::WRL::ComPtr<ID3D12Resource> CreateTextureResource(Microsoft::WRL::Com
 	// テクスチャの次元数
 	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);
 
+	return resourceDesc;
+}
+
+/// <summary>
+/// テクスチャのメタデータを基にに、テクスチャリソースを作成する
+/// </summary>
+/// <param name="device"></param>
+/// <param name="metadata"></param>
+/// <returns></returns>
+Microsoft::WRL::ComPtr<ID3D12Resource> CreateTextureResource(Microsoft::WRL::ComPtr<ID3D12Device> device, const DirectX::TexMetadata& metadata)
+{
+	/*------------------------------------
+	    メタデータを基に、リソースを作成する
+	------------------------------------*/
+
+	D3D12_RESOURCE_DESC resourceDesc = MakeTextureResourceDesc(metadata);
+
 
 	/*------------------------
 	    利用するヒープの設定
@@ -99,23 +253,22 @@ Microsoft::WRL::ComPtr<ID3D12Resource> CreateTextureResource(Microsoft::WRL::Com
 
 
 /// <summary>
-/// メタデータをテクスチャに転送する
+/// メタデータをテクスチャに転送する（転送用のバッファは呼ぶ側が用意し、GPUが使い終わるまで残す）
 /// </summary>
 /// <param name="texture"></param>
 /// <param name="mipImages"></param>
+/// <param name="intermediateResource">転送用のバッファ（GetRequiredIntermediateSize の大きさ）</param>
+/// <param name="intermediateOffset">転送用のバッファの中の位置（512バイトに揃える）</param>
 /// <param name="device"></param>
 /// <param name="commandList"></param>
-/// <returns></returns>
-[[nodiscard]]
-Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages,
-	Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+void UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages, ID3D12Resource* intermediateResource,
+	uint64_t intermediateOffset, Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
 {
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
 	DirectX::PrepareUpload(device.Get(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
-	uint64_t intermediateSize = GetRequiredIntermediateSize(texture.Get(), 0, UINT(subresources.size()));
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource = CreateBufferResource(device, static_cast<UINT>(intermediateSize));
+	assert(intermediateOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0);
 
-	UpdateSubresources(commandList.Get(), texture.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
+	UpdateSubresources(commandList.Get(), texture.Get(), intermediateResource, intermediateOffset, 0, UINT(subresources.size()), subresources.data());
 
 	D3D12_RESOURCE_BARRIER barrier{};
 	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -125,8 +278,42 @@ Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(Microsoft::WRL::ComPtr<
 	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
 	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
 	commandList->ResourceBarrier(1, &barrier);
+}
 
-	return intermediateResource;
+/// <summary>
+/// 指定した範囲のミップだけをテクスチャに転送する
+/// </summary>
+/// <param name="texture"></param>
+/// <param name="mipImages"></param>
+/// <param name="firstMip">転送する最初のミップ</param>
+/// <param name="numMips">転送するミップの数</param>
+/// <param name="intermediateResource">転送用のバッファ（GetRequiredIntermediateSize の大きさ）</param>
+/// <param name="intermediateOffset">転送用のバッファの中の位置（512バイトに揃える）</param>
+/// <param name="device"></param>
+/// <param name="commandList"></param>
+void UploadTextureMipData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages, uint32_t firstMip, uint32_t numMips,
+	ID3D12Resource* intermediateResource, uint64_t intermediateOffset, Microsoft::WRL::ComPtr<ID3D12Device> device,
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList)
+{
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	DirectX::PrepareUpload(device.Get(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
+	assert(firstMip + numMips <= subresources.size());
+	assert(intermediateOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0);
+
+	UpdateSubresources(commandList.Get(), texture.Get(), intermediateResource, intermediateOffset, firstMip, numMips, &subresources[firstMip]);
+
+	// 転送したミップだけを読み込める状態にする（残りのミップはCOPY_DESTのまま）
+	std::vector<D3D12_RESOURCE_BARRIER> barriers(numMips);
+	for (uint32_t i = 0; i < numMips; ++i)
+	{
+		barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barriers[i].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barriers[i].Transition.pResource = texture.Get();
+		barriers[i].Transition.Subresource = firstMip + i;
+		barriers[i].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+		barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
+	}
+	commandList->ResourceBarrier(numMips, barriers.data());
 }
 
 /// <summary>
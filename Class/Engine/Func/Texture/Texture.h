@@ -4,6 +4,10 @@
 #include <string>
 #include <cassert>
 #include <vector>
+#include <chrono>
+#include <format>
+#include <filesystem>
+#include <fstream>
 #include <wrl.h>
 #include <d3d12.h>
 #include <dxgi1_6.h>
@@ -11,6 +15,9 @@
 #include "../../externals/DirectXTex/DirectXTex.h"
 #include "../../externals/DirectXTex/d3dx12.h"
 #include "../StringInfo/StringInfo.h"
+#include "../Hash/Hash.h"
+#include "../../Class/AssetFile/AssetFile.h"
+#include "../../Struct.h"
 #include "../../Func/Create/Create.h"
 #include "../../Func/TransitionBarrier/TransitionBarrier.h"
 
@@ -18,12 +25,68 @@
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "dxguid.lib")
 
+// クックしたテクスチャを置くディレクトリ
+const std::string kTextureCacheDirectory = "Class/Engine/Cache/Textures";
+
 /// <summary>
-/// テクスチャをCPUに読み込む
+/// テクスチャをCPUに読み込む（クック済みのDDSがあればそれを使い、無ければクックして保存する）
 /// </summary>
+/// <param name="os">ログの出力先</param>
 /// <param name="filePath">ファイルパス</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage LoadTexture(std::ostream& os, const std::string& filePath, const TextureCookSettings& settings);
+
+/// <summary>
+/// 読んだファイルの中身から、テクスチャをCPUに読み込む（クック済みのDDSがあればそれを使い、無ければクックして保存する）
+/// </summary>
+/// <param name="os">ログの出力先</param>
+/// <param name="filePath">ファイルパス（ログ用）</param>
+/// <param name="sourceBytes">ファイルの中身</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage LoadTexture(std::ostream& os, const std::string& filePath, const std::vector<uint8_t>& sourceBytes, const TextureCookSettings& settings);
+
+/// <summary>
+/// ファイルの中身を全て読む
+/// </summary>
+/// <param name="filePath">ファイルパス</param>
+/// <returns></returns>
+std::vector<uint8_t> ReadTextureFile(const std::string& filePath);
+
+/// <summary>
+/// 画像ファイルの中身から、最終的なミップチェーンを作る
+/// </summary>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+DirectX::ScratchImage CookTexture(const void* data, size_t size, const TextureCookSettings& settings);
+
+/// <summary>
+/// クック済みのテクスチャのパスを求める（元のファイルの中身と設定のハッシュ値で決まる）
+/// </summary>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
+/// <returns></returns>
+std::string GetTextureCachePath(const void* data, size_t size, const TextureCookSettings& settings);
+
+/// <summary>
+/// 元のファイルの中身と設定から、クックしたテクスチャを表すハッシュ値を求める
+/// </summary>
+/// <param name="data">画像ファイルの中身</param>
+/// <param name="size">バイト数</param>
+/// <param name="settings">クックの設定</param>
 /// <returns></returns>
-DirectX::ScratchImage LoadTexture(const std::string& filePath);
+uint64_t HashTextureContent(const void* data, size_t size, const TextureCookSettings& settings);
+
+/// <summary>
+/// テクスチャのメタデータを基に、リソースの設定を作る
+/// </summary>
+/// <param name="metadata"></param>
+/// <returns>リソースの設定</returns>
+D3D12_RESOURCE_DESC MakeTextureResourceDesc(const DirectX::TexMetadata& metadata);
 
 /// <summary>
 /// テクスチャのメタデータを基にに、テクスチャリソースを作成する
@@ -34,16 +97,31 @@ DirectX::ScratchImage LoadTexture(const std::string& filePath);
 Microsoft::WRL::ComPtr<ID3D12Resource> CreateTextureResource(Microsoft::WRL::ComPtr<ID3D12Device> device, const DirectX::TexMetadata& metadata);
 
 /// <summary>
-/// メタデータをテクスチャに転送する
+/// メタデータをテクスチャに転送する（転送用のバッファは呼ぶ側が用意し、GPUが使い終わるまで残す）
 /// </summary>
 /// <param name="texture"></param>
 /// <param name="mipImages"></param>
+/// <param name="intermediateResource">転送用のバッファ（GetRequiredIntermediateSize の大きさ）</param>
+/// <param name="intermediateOffset">転送用のバッファの中の位置（512バイトに揃える）</param>
 /// <param name="device"></param>
 /// <param name="commandList"></param>
-/// <returns></returns>
-[[nodiscard]]
-Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages,
-	Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+void UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages, ID3D12Resource* intermediateResource,
+	uint64_t intermediateOffset, Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
+
+/// <summary>
+/// 指定した範囲のミップだけをテクスチャに転送する
+/// </summary>
+/// <param name="texture"></param>
+/// <param name="mipImages"></param>
+/// <param name="firstMip">転送する最初のミップ</param>
+/// <param name="numMips">転送するミップの数</param>
+/// <param name="intermediateResource">転送用のバッファ（GetRequiredIntermediateSize の大きさ）</param>
+/// <param name="intermediateOffset">転送用のバッファの中の位置（512バイトに揃える）</param>
+/// <param name="device"></param>
+/// <param name="commandList"></param>
+void UploadTextureMipData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages, uint32_t firstMip, uint32_t numMips,
+	ID3D12Resource* intermediateResource, uint64_t intermediateOffset, Microsoft::WRL::ComPtr<ID3D12Device> device,
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList);
 
 /// <summary>
 /// デプスステンシルテクスチャを作る
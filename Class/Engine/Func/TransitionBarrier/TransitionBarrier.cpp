@@ -26,4 +26,52 @@ void TransitionBarrier(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> command
 
 	// TransitionBarreirを張る
 	commandList->ResourceBarrier(1, &barrier);
+}
+
+/// <summary>
+/// レンダーグラフが求めたバリアを、まとめて1回で張る
+/// </summary>
+/// <param name="commandList"></param>
+/// <param name="barriers">バリア</param>
+void SubmitBarriers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, const std::vector<RenderBarrier>& barriers)
+{
+	if (barriers.empty())
+		return;
+
+	std::vector<D3D12_RESOURCE_BARRIER> resourceBarriers(barriers.size());
+
+	for (size_t i = 0; i < barriers.size(); ++i)
+	{
+		D3D12_RESOURCE_BARRIER& barrier = resourceBarriers[i];
+		ID3D12Resource* resource = reinterpret_cast<ID3D12Resource*>(barriers[i].resource);
+
+		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+
+		// 続けてUAVとして使うときは、前の書き込みを待つ
+		if (barriers[i].type == RenderBarrierType::UnorderedAccess)
+		{
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+			barrier.UAV.pResource = resource;
+			continue;
+		}
+
+		// 同じヒープの位置を使っていた前のリソースから切り替える（前のリソースは指定せず、どれからでもよいことにする）
+		if (barriers[i].type == RenderBarrierType::Aliasing)
+		{
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			barrier.Aliasing.pResourceBefore = nullptr;
+			barrier.Aliasing.pResourceAfter = resource;
+			continue;
+		}
+
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Transition.pResource = resource;
+		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+		// 状態の値はD3D12と同じ
+		barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(barriers[i].before);
+		barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(barriers[i].after);
+	}
+
+	commandList->ResourceBarrier(static_cast<UINT>(resourceBarriers.size()), resourceBarriers.data());
 }
\ No newline at end of file
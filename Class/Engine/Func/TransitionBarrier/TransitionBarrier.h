@@ -3,9 +3,11 @@
 #include <stdint.h>
 #include <string>
 #include <cassert>
+#include <vector>
 #include <wrl.h>
 #include <d3d12.h>
 #include <dxgi1_6.h>
+#include "../../Class/RenderGraph/RenderGraph.h"
 
 #pragma comment(lib,"d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -17,4 +19,11 @@
 /// <param name="before">現在のResourceState</param>
 /// <param name="after">遷移後のResourceState</param>
 void TransitionBarrier(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, Microsoft::WRL::ComPtr<ID3D12Resource> swapChainResources,
-	D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after);
\ No newline at end of file
+	D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after);
+
+/// <summary>
+/// レンダーグラフが求めたバリアを、まとめて1回で張る
+/// </summary>
+/// <param name="commandList"></param>
+/// <param name="barriers">バリア</param>
+void SubmitBarriers(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList, const std::vector<RenderBarrier>& barriers);
\ No newline at end of file
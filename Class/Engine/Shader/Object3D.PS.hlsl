@@ -32,16 +32,14 @@ PixelShaderOutput main(VertexShaderOutput input)
     float4 transformedUV = mul(float4(input.texcoord, 0.0f , 1.0f), gMaterial.uvTransform);
     float4 textureColor = gTexture.Sample(gSampler, transformedUV.xy);
     
-    if (gMaterial.enableLighting != 0)
-    {
-        float NdotL = dot(normalize(input.normal), -gDirectionalLight.direction);
-        float cos = pow(0.5f * NdotL + 0.5, 2.0f);
-        output.color = gMaterial.color * textureColor * gDirectionalLight.color * cos * gDirectionalLight.intensity;
-    }
-    else
-    {
-        output.color = gMaterial.color * textureColor;
-    }
+    // ライティングはバリアントごとに分けてコンパイルする（enableLightingでは分岐しない）
+#if defined(LIGHTING_HALF_LAMBERT)
+    float NdotL = dot(normalize(input.normal), -gDirectionalLight.direction);
+    float cos = pow(0.5f * NdotL + 0.5, 2.0f);
+    output.color = gMaterial.color * textureColor * gDirectionalLight.color * cos * gDirectionalLight.intensity;
+#else
+    output.color = gMaterial.color * textureColor;
+#endif
 
     return output;
 }
\ No newline at end of file
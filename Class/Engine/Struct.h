@@ -1,6 +1,9 @@
 #pragma once
+#include <stdint.h>
 #include <vector>
 #include <string>
+
+#ifdef _WIN32
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <dxgidebug.h>
@@ -9,6 +12,7 @@
 #pragma comment(lib,"d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "dxguid.lib")
+#endif
 
 	// 3+1次元ベクトル
 	typedef struct Vector4
@@ -125,18 +129,64 @@
 		float intensity;
 	}DirectionalLight;
 
+#ifdef _WIN32
+
+	// テクスチャの事前処理（クック）の設定
+	typedef struct TextureCookSettings
+	{
+		// ブロック圧縮のフォーマット（DXGI_FORMAT_UNKNOWNなら圧縮しない）
+		DXGI_FORMAT compressFormat;
+
+		// BC7を高速な設定（モード6と1だけを試す）で圧縮するかどうか
+		bool fastCompression;
+	}TextureCookSettings;
+
+#endif
+
+	// スプライトの領域（アトラスのテクスチャと、その中のUVの範囲）
+	typedef struct SpriteRegion
+	{
+		// テクスチャ
+		uint32_t textureHandle;
+
+		// UVの左上と右下
+		Vector2 uvMin;
+		Vector2 uvMax;
+	}SpriteRegion;
+
 	// マテリアルデータ
 	typedef struct MaterialData
 	{
+		std::string name;
 		std::string textureFilePath;
 	}MaterialData;
 
+	// サブメッシュ（インデックスの範囲と、使うマテリアル）
+	typedef struct SubMesh
+	{
+		uint32_t indexStart;
+		uint32_t indexCount;
+		uint32_t materialIndex;
+	}SubMesh;
+
+
+	// 軸に平行な境界ボックス
+	typedef struct MeshBounds
+	{
+		Vector3 min;
+		Vector3 max;
+	}MeshBounds;
 
 	// モデルデータ
 	typedef struct ModelData
 	{
 		std::vector<VertexData> vertices;
-		MaterialData material;
+
+		// マテリアルの表
+		std::vector<MaterialData> materials;
+
+		// サブメッシュ（全て同じ頂点配列を使い、頂点の範囲で分ける）
+		std::vector<SubMesh> subMeshes;
 	}ModelData;
 
 	// チャンクヘッド
@@ -159,6 +209,8 @@
 		char type[4];
 	}RiffHeader;
 
+#ifdef _WIN32
+
 	// FMTチャンク
 	typedef struct FormatChunk
 	{
@@ -196,4 +248,6 @@
 				debug->ReportLiveObjects(DXGI_DEBUG_D3D12, DXGI_DEBUG_RLO_ALL);
 			}
 		}
-	}D3DResourceLeakChecker;
\ No newline at end of file
+	}D3DResourceLeakChecker;
+
+#endif
@@ -45,6 +45,9 @@ namespace DirectX
 
         BC_FLAGS_FORCE_BC7_MODE6 = 0x100000,
         // BC7 should only use mode 6; skip other modes
+
+        BC_FLAGS_BC7_FAST = 0x200000,
+        // BC7 fast tier: mode 6, plus mode 1 on the best-ranked partitions for opaque blocks
     };
 
     //-------------------------------------------------------------------------------------
@@ -43,6 +43,7 @@ namespace
 
     constexpr size_t BC7_NUM_CHANNELS = 4;
     constexpr size_t BC7_MAX_SHAPES = 64;
+    constexpr size_t BC7_FAST_SHAPES = 2;   // mode 1 partitions refined by the fast tier
 
     constexpr int32_t BC67_WEIGHT_MAX = 64;
     constexpr uint32_t BC67_WEIGHT_SHIFT = 6;
@@ -784,11 +785,12 @@ namespace
         struct EncodeParams
         {
             uint8_t uMode;
+            bool bFast;
             LDREndPntPair aEndPts[BC7_MAX_SHAPES][BC7_MAX_REGIONS];
             LDRColorA aLDRPixels[NUM_PIXELS_PER_BLOCK];
             const HDRColorA* const aHDRPixels;
 
-            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal) {}
+            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), bFast(false), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal) {}
         };
     #pragma warning(pop)
 
@@ -855,8 +857,13 @@ namespace
 
         float MapColors(_In_ const EncodeParams* pEP, _In_reads_(np) const LDRColorA aColors[], _In_ size_t np, _In_ size_t uIndexMode,
             _In_ const LDREndPntPair& endPts, _In_ float fMinErr) const noexcept;
+        float MapColorsProjected(_In_ const EncodeParams* pEP, _In_reads_(np) const LDRColorA aColors[], _In_ size_t np, _In_ size_t uIndexMode,
+            _In_ const LDREndPntPair& endPts, _In_ float fMinErr) const noexcept;
         static float RoughMSE(_Inout_ EncodeParams* pEP, _In_ size_t uShape, _In_ size_t uIndexMode) noexcept;
 
+        void EncodeFast(_Inout_ EncodeParams* pEP, _In_ bool bHasAlpha) noexcept;
+        static void RankTwoSubsetShapes(_In_ const EncodeParams* pEP, _Out_writes_(uItems) size_t auShape[], _In_ size_t uItems) noexcept;
+
     private:
         static constexpr uint8_t c_NumModes = 8;
 
@@ -2780,6 +2787,12 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 
     const bool bHasAlpha = (alphaMask != 0xFF);
 
+    if (flags & BC_FLAGS_BC7_FAST)
+    {
+        EncodeFast(&EP, bHasAlpha);
+        return;
+    }
+
     for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
     {
         if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
@@ -2866,6 +2879,181 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
     *this = final;
 }
 
+//-------------------------------------------------------------------------------------
+// Fast tier: mode 6 for every block, plus mode 1 on the few partitions ranked best by
+// RankTwoSubsetShapes for opaque blocks. Skips rotations, index modes and the rough
+// MSE pass over all 64 partitions.
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void D3DX_BC7::EncodeFast(EncodeParams* pEP, bool bHasAlpha) noexcept
+{
+    assert(pEP);
+
+    // Refine maps colors through MapColorsProjected
+    pEP->bFast = true;
+
+    // Mode 6: single subset, RGBA endpoints with 4-bit indices
+    pEP->uMode = 6;
+    RoughMSE(pEP, 0, 0);
+    float fMSEBest = Refine(pEP, 0, 0, 0);
+    D3DX_BC7 final = *this;
+
+    // Mode 1: two subsets, RGB endpoints with 3-bit indices (alpha is always 255)
+    if (!bHasAlpha && fMSEBest > 0)
+    {
+        size_t auShape[BC7_FAST_SHAPES];
+        RankTwoSubsetShapes(pEP, auShape, BC7_FAST_SHAPES);
+
+        pEP->uMode = 1;
+        for (size_t i = 0; i < BC7_FAST_SHAPES && fMSEBest > 0; ++i)
+        {
+            RoughMSE(pEP, auShape[i], 0);
+            const float fMSE = Refine(pEP, auShape[i], 0, 0);
+            if (fMSE < fMSEBest)
+            {
+                final = *this;
+                fMSEBest = fMSE;
+            }
+        }
+    }
+
+    *this = final;
+}
+
+//-------------------------------------------------------------------------------------
+// Ranks the 2-subset partitions by how far each subset's colors lie off their principal
+// axis (covariance trace minus largest eigenvalue), accumulated with SIMD moments.
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void D3DX_BC7::RankTwoSubsetShapes(const EncodeParams* pEP, size_t auShape[], size_t uItems) noexcept
+{
+    assert(pEP);
+    assert(uItems > 0 && uItems <= BC7_MAX_SHAPES);
+
+    // Per-pixel moments: c, c*c (rr, gg, bb) and c*c.yzx (rg, gb, br)
+    XMVECTOR vColor[NUM_PIXELS_PER_BLOCK];
+    XMVECTOR vSquare[NUM_PIXELS_PER_BLOCK];
+    XMVECTOR vCross[NUM_PIXELS_PER_BLOCK];
+
+    XMVECTOR vTotalColor = XMVectorZero();
+    XMVECTOR vTotalSquare = XMVectorZero();
+    XMVECTOR vTotalCross = XMVectorZero();
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        const LDRColorA& c = pEP->aLDRPixels[i];
+        vColor[i] = XMVectorSet(float(c.r), float(c.g), float(c.b), 0.f);
+        vSquare[i] = XMVectorMultiply(vColor[i], vColor[i]);
+        vCross[i] = XMVectorMultiply(vColor[i], XMVectorSwizzle<XM_SWIZZLE_Y, XM_SWIZZLE_Z, XM_SWIZZLE_X, XM_SWIZZLE_W>(vColor[i]));
+
+        vTotalColor = XMVectorAdd(vTotalColor, vColor[i]);
+        vTotalSquare = XMVectorAdd(vTotalSquare, vSquare[i]);
+        vTotalCross = XMVectorAdd(vTotalCross, vCross[i]);
+    }
+
+    // Sum of squared distances from the best-fit line through the subset
+    auto lineError = [](FXMVECTOR vSum, FXMVECTOR vSumSq, FXMVECTOR vSumCross, size_t np) noexcept -> float
+        {
+            if (np < 3)
+                return 0.f;
+
+            const XMVECTOR vInvN = XMVectorReplicate(1.f / float(np));
+            const XMVECTOR vMean = XMVectorMultiply(vSum, vInvN);
+            const XMVECTOR vVar = XMVectorSubtract(XMVectorMultiply(vSumSq, vInvN), XMVectorMultiply(vMean, vMean));
+            const XMVECTOR vCov = XMVectorSubtract(XMVectorMultiply(vSumCross, vInvN),
+                XMVectorMultiply(vMean, XMVectorSwizzle<XM_SWIZZLE_Y, XM_SWIZZLE_Z, XM_SWIZZLE_X, XM_SWIZZLE_W>(vMean)));
+
+            XMFLOAT3 var, cov;
+            XMStoreFloat3(&var, vVar);
+            XMStoreFloat3(&cov, vCov);
+
+            // Covariance rows (cov.x = rg, cov.y = gb, cov.z = br)
+            const float m[3][3] =
+            {
+                { var.x, cov.x, cov.z },
+                { cov.x, var.y, cov.y },
+                { cov.z, cov.y, var.z },
+            };
+
+            const float trace = var.x + var.y + var.z;
+            if (trace <= 0.f)
+                return 0.f;
+
+            // Power iteration from the row with the largest variance
+            const size_t k = (var.x >= var.y && var.x >= var.z) ? 0 : ((var.y >= var.z) ? 1 : 2);
+            float v[3] = { m[k][0], m[k][1], m[k][2] };
+            float lambda = 0.f;
+            for (size_t iter = 0; iter < 4; ++iter)
+            {
+                const float w[3] =
+                {
+                    m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2],
+                    m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2],
+                    m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2],
+                };
+
+                const float vv = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+                if (vv <= 0.f)
+                    break;
+
+                lambda = (v[0] * w[0] + v[1] * w[1] + v[2] * w[2]) / vv;
+
+                const float ww = sqrtf(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+                if (ww <= 0.f)
+                    break;
+
+                v[0] = w[0] / ww;
+                v[1] = w[1] / ww;
+                v[2] = w[2] / ww;
+            }
+
+            return std::max<float>(0.f, trace - lambda) * float(np);
+        };
+
+    float afError[BC7_MAX_SHAPES];
+    for (size_t uShape = 0; uShape < BC7_MAX_SHAPES; ++uShape)
+    {
+        XMVECTOR vColor0 = XMVectorZero();
+        XMVECTOR vSquare0 = XMVectorZero();
+        XMVECTOR vCross0 = XMVectorZero();
+        size_t np0 = 0;
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (g_aPartitionTable[1][uShape][i] == 0)
+            {
+                vColor0 = XMVectorAdd(vColor0, vColor[i]);
+                vSquare0 = XMVectorAdd(vSquare0, vSquare[i]);
+                vCross0 = XMVectorAdd(vCross0, vCross[i]);
+                ++np0;
+            }
+        }
+
+        afError[uShape] = lineError(vColor0, vSquare0, vCross0, np0)
+            + lineError(XMVectorSubtract(vTotalColor, vColor0), XMVectorSubtract(vTotalSquare, vSquare0),
+                XMVectorSubtract(vTotalCross, vCross0), NUM_PIXELS_PER_BLOCK - np0);
+    }
+
+    // Select the uItems lowest errors
+    bool abUsed[BC7_MAX_SHAPES] = {};
+    for (size_t i = 0; i < uItems; ++i)
+    {
+        size_t uBest = 0;
+        float fBest = FLT_MAX;
+        for (size_t uShape = 0; uShape < BC7_MAX_SHAPES; ++uShape)
+        {
+            if (!abUsed[uShape] && afError[uShape] < fBest)
+            {
+                fBest = afError[uShape];
+                uBest = uShape;
+            }
+        }
+
+        abUsed[uBest] = true;
+        auShape[i] = uBest;
+    }
+}
+
 
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
@@ -3442,6 +3630,10 @@ float D3DX_BC7::MapColors(const EncodeParams* pEP, const LDRColorA aColors[], si
 
     const uint8_t uIndexPrec = uIndexMode ? ms_aInfo[pEP->uMode].uIndexPrec2 : ms_aInfo[pEP->uMode].uIndexPrec;
     const uint8_t uIndexPrec2 = uIndexMode ? ms_aInfo[pEP->uMode].uIndexPrec : ms_aInfo[pEP->uMode].uIndexPrec2;
+
+    if (pEP->bFast && uIndexPrec2 == 0)
+        return MapColorsProjected(pEP, aColors, np, uIndexMode, endPts, fMinErr);
+
     LDRColorA aPalette[BC7_MAX_INDICES];
     float fTotalErr = 0;
 
@@ -3459,6 +3651,63 @@ float D3DX_BC7::MapColors(const EncodeParams* pEP, const LDRColorA aColors[], si
     return fTotalErr;
 }
 
+//-------------------------------------------------------------------------------------
+// Fast tier version of MapColors for single index sets (modes 1 and 6). Refine spends
+// nearly all of its time here, walking the palette from index 0 for every pixel of every
+// perturbed endpoint pair. Instead, the palette is loaded into vectors once, each pixel is
+// projected onto the endpoint line, and only the entries next to the projected index are
+// compared (BC7 weights and endpoint rounding keep the nearest entry within one step).
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+float D3DX_BC7::MapColorsProjected(const EncodeParams* pEP, const LDRColorA aColors[], size_t np, size_t uIndexMode, const LDREndPntPair& endPts, float fMinErr) const noexcept
+{
+    assert(pEP);
+    assert(pEP->uMode < c_NumModes);
+    _Analysis_assume_(pEP->uMode < c_NumModes);
+
+    const uint8_t uIndexPrec = uIndexMode ? ms_aInfo[pEP->uMode].uIndexPrec2 : ms_aInfo[pEP->uMode].uIndexPrec;
+    const size_t uNumIndices = size_t(1) << uIndexPrec;
+    assert(uNumIndices > 1 && uNumIndices <= BC7_MAX_INDICES);
+    _Analysis_assume_(uNumIndices > 1 && uNumIndices <= BC7_MAX_INDICES);
+
+    LDRColorA aPalette[BC7_MAX_INDICES];
+    GeneratePaletteQuantized(pEP, uIndexMode, endPts, aPalette);
+
+    XMVECTOR vPalette[BC7_MAX_INDICES];
+    for (size_t i = 0; i < uNumIndices; ++i)
+        vPalette[i] = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(&aPalette[i]));
+
+    const XMVECTOR vDir = XMVectorSubtract(vPalette[uNumIndices - 1], vPalette[0]);
+    const float fLengthSq = XMVectorGetX(XMVector4Dot(vDir, vDir));
+    const XMVECTOR vScale = XMVectorReplicate((fLengthSq > 0.f) ? float(uNumIndices - 1) / fLengthSq : 0.f);
+    const float fLastIndex = float(uNumIndices - 1);
+
+    float fTotalErr = 0;
+    for (size_t i = 0; i < np; ++i)
+    {
+        const XMVECTOR vPixel = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(&aColors[i]));
+
+        const float fIndex = XMVectorGetX(XMVectorMultiply(XMVector4Dot(XMVectorSubtract(vPixel, vPalette[0]), vDir), vScale));
+        const auto uIndex = static_cast<size_t>(std::min<float>(std::max<float>(fIndex + 0.5f, 0.f), fLastIndex));
+
+        const size_t uLow = (uIndex > 0) ? uIndex - 1 : 0;
+        const size_t uHigh = std::min<size_t>(uIndex + 1, uNumIndices - 1);
+
+        float fBestErr = FLT_MAX;
+        for (size_t j = uLow; j <= uHigh; ++j)
+        {
+            const XMVECTOR vDiff = XMVectorSubtract(vPixel, vPalette[j]);
+            fBestErr = std::min<float>(fBestErr, XMVectorGetX(XMVector4Dot(vDiff, vDiff)));
+        }
+
+        fTotalErr += fBestErr;
+        if (fTotalErr > fMinErr)   // check for early exit
+            return FLT_MAX;
+    }
+
+    return fTotalErr;
+}
+
 _Use_decl_annotations_
 float D3DX_BC7::RoughMSE(EncodeParams* pEP, size_t uShape, size_t uIndexMode) noexcept
 {
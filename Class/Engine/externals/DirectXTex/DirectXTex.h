@@ -704,6 +704,13 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK = 0x100000,
         // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_BC7_FAST = 0x200000,
+        // Fast tier for BC7 compression: mode 6 plus mode 1 on heuristically ranked partitions
+        // (opaque blocks only); quality sits between TEX_COMPRESS_BC7_QUICK and the default search
+        // (measured on 5 images: 28x faster than the default search overall, 14x at worst;
+        //  PSNR -1.2 dB on average, -4.61 dB at worst on monsterBall.png)
+        // Re-measure with the Benchmark target: TextureQuality/* reports psnr_db and psnr_loss_db per image
+
         TEX_COMPRESS_SRGB_IN = 0x1000000,
         TEX_COMPRESS_SRGB_OUT = 0x2000000,
         TEX_COMPRESS_SRGB = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
@@ -722,6 +729,9 @@ namespace DirectX
         _In_ DXGI_FORMAT format, _In_ TEX_COMPRESS_FLAGS compress, _In_ float threshold, _Out_ ScratchImage& cImages) noexcept;
         // Note that threshold is only used by BC1. TEX_THRESHOLD_DEFAULT is a typical value to use
 
+    void __cdecl SetCompressThreadLimit(_In_ size_t maxThreads) noexcept;
+        // Upper bound on worker threads used by TEX_COMPRESS_PARALLEL (0 uses every hardware thread)
+
 #if defined(__d3d11_h__) || defined(__d3d11_x_h__)
     HRESULT __cdecl Compress(
         _In_ ID3D11Device* pDevice, _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ TEX_COMPRESS_FLAGS compress,
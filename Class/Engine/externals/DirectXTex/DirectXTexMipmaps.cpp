@@ -904,19 +904,32 @@ namespace
         return S_OK;
     }
 
-    //--- 2D Point Filter ---
-    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item) noexcept
-    {
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+    //--- Row-band parallelism for 2D mip generation ---
+    // Each destination level is split into contiguous row bands; every band owns its scanline buffers
+    // and writes disjoint rows of the destination, so the output is identical to the serial filter.
+    constexpr size_t c_MinPixelsPerMipBand = 64 * 1024;
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+    // Set through SetMipGenerationOptions (regression tests compare thread counts and the generic filters)
+    std::atomic<size_t> s_mipMaxThreads(0);
+    std::atomic<size_t> s_mipMinPixelsPerBand(c_MinPixelsPerMipBand);
+    std::atomic<bool> s_mipAllowFastPaths(true);
 
-        assert(levels > 1);
+    inline size_t MinRowsPerMipBand(size_t nwidth) noexcept
+    {
+        return std::max<size_t>(1, s_mipMinPixelsPerBand.load(std::memory_order_relaxed) / std::max<size_t>(nwidth, 1));
+    }
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+    inline size_t MaxMipThreads() noexcept
+    {
+        return s_mipMaxThreads.load(std::memory_order_relaxed);
+    }
 
+
+    //--- 2D Point Filter ---
+    HRESULT Generate2DMipsPointFilterRows(
+        size_t width, size_t height, size_t yBegin, size_t yEnd,
+        _In_ const Image* src, _In_ const Image* dest) noexcept
+    {
         // Allocate temporary space (2 scanlines)
         auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
         if (!scanline)
@@ -926,13 +939,65 @@ namespace
 
         XMVECTOR* row = target + width;
 
+    #ifdef _DEBUG
+        memset(row, 0xCD, sizeof(XMVECTOR)*width);
+    #endif
+
+        const uint8_t* pSrc = src->pixels;
+        uint8_t* pDest = dest->pixels + dest->rowPitch * yBegin;
+
+        const size_t rowPitch = src->rowPitch;
+
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+        const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+        const size_t xinc = (width << 16) / nwidth;
+        const size_t yinc = (height << 16) / nheight;
+
+        size_t lasty = size_t(-1);
+
+        size_t sy = yinc * yBegin;
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            if ((lasty ^ sy) >> 16)
+            {
+                if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
+                    return E_FAIL;
+                lasty = sy;
+            }
+
+            size_t sx = 0;
+            for (size_t x = 0; x < nwidth; ++x)
+            {
+                target[x] = row[sx >> 16];
+                sx += xinc;
+            }
+
+            if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
+                return E_FAIL;
+            pDest += dest->rowPitch;
+
+            sy += yinc;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
-
             // 2D point filter
             const Image* src = mipChain.GetImage(level - 1, item, 0);
             const Image* dest = mipChain.GetImage(level, item, 0);
@@ -940,42 +1005,16 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
-
-            const size_t rowPitch = src->rowPitch;
-
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-            const size_t xinc = (width << 16) / nwidth;
-            const size_t yinc = (height << 16) / nheight;
-
-            size_t lasty = size_t(-1);
-
-            size_t sy = 0;
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                if ((lasty ^ sy) >> 16)
-                {
-                    if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                        return E_FAIL;
-                    lasty = sy;
-                }
-
-                size_t sx = 0;
-                for (size_t x = 0; x < nwidth; ++x)
+            const HRESULT hr = ParallelForBands(nheight, MinRowsPerMipBand(nwidth), MaxMipThreads(),
+                [&](size_t yBegin, size_t yEnd) noexcept
                 {
-                    target[x] = row[sx >> 16];
-                    sx += xinc;
-                }
-
-                if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-
-                sy += yinc;
-            }
+                    return Generate2DMipsPointFilterRows(width, height, yBegin, yEnd, src, dest);
+                });
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -989,22 +1028,110 @@ namespace
 
 
     //--- 2D Box Filter ---
-    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    struct SRGBToLinearTable
+    {
+        float rgb[256];
+        float alpha[256];
+
+        SRGBToLinearTable() noexcept
+        {
+            // Built with the same load + conversion as LoadScanlineLinear so decoding is bit-exact
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                const auto c = static_cast<uint8_t>(i);
+                const PackedVector::XMUBYTEN4 packed(c, c, c, c);
+                const XMVECTOR v = PackedVector::XMLoadUByteN4(&packed);
+                rgb[i] = XMVectorGetX(XMColorSRGBToRGB(v));
+                alpha[i] = XMVectorGetW(v);
+            }
+        }
+    };
+
+    const SRGBToLinearTable& GetSRGBToLinearTable() noexcept
+    {
+        static const SRGBToLinearTable s_table;
+        return s_table;
+    }
+
+    bool UseFastSRGBBoxFilter(size_t width, size_t height, DXGI_FORMAT format, TEX_FILTER_FLAGS filter) noexcept
+    {
+        if (width <= 1 || height <= 1 || !s_mipAllowFastPaths.load(std::memory_order_relaxed))
+            return false;
+
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            return true;
+
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            return (filter & TEX_FILTER_SRGB_IN) != 0;
+
+        default:
+            return false;
+        }
+    }
+
+    inline XMVECTOR XM_CALLCONV LoadSRGBPixel(const SRGBToLinearTable& table, const uint8_t* p) noexcept
+    {
+        return XMVectorSet(table.rgb[p[0]], table.rgb[p[1]], table.rgb[p[2]], table.alpha[p[3]]);
+    }
+
+    // R8G8B8A8 sRGB fast path: decodes through a lookup table instead of per-pixel XMColorSRGBToRGB,
+    // and reads the 2x2 footprint directly from the source rows
+    HRESULT Generate2DMipsBoxFilterRowsSRGB(
+        size_t width, size_t yBegin, size_t yEnd,
+        _In_ const Image* src, _In_ const Image* dest, TEX_FILTER_FLAGS filter) noexcept
     {
         using namespace DirectX::Filters;
 
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+        const size_t nwidth = width >> 1;
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+        // Allocate temporary space (1 scanline)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(nwidth));
+        if (!scanline)
+            return E_OUTOFMEMORY;
 
-        assert(levels > 1);
+        XMVECTOR* target = scanline.get();
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        const SRGBToLinearTable& table = GetSRGBToLinearTable();
 
-        if (!ispow2(width) || !ispow2(height))
-            return E_FAIL;
+        const size_t rowPitch = src->rowPitch;
+
+        const uint8_t* pSrc = src->pixels + rowPitch * (yBegin * 2);
+        uint8_t* pDest = dest->pixels + dest->rowPitch * yBegin;
+
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            const uint8_t* pRow0 = pSrc;
+            const uint8_t* pRow1 = pSrc + rowPitch;
+
+            for (size_t x = 0; x < nwidth; ++x)
+            {
+                const size_t offset = x * 8;
+
+                const XMVECTOR p0 = LoadSRGBPixel(table, pRow0 + offset);
+                const XMVECTOR p1 = LoadSRGBPixel(table, pRow1 + offset);
+                const XMVECTOR p2 = LoadSRGBPixel(table, pRow0 + offset + 4);
+                const XMVECTOR p3 = LoadSRGBPixel(table, pRow1 + offset + 4);
+
+                AVERAGE4(target[x], p0, p1, p2, p3)
+            }
+
+            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                return E_FAIL;
+
+            pSrc += rowPitch * 2;
+            pDest += dest->rowPitch;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT Generate2DMipsBoxFilterRows(
+        size_t width, size_t height, size_t yBegin, size_t yEnd,
+        _In_ const Image* src, _In_ const Image* dest, TEX_FILTER_FLAGS filter) noexcept
+    {
+        using namespace DirectX::Filters;
 
         // Allocate temporary space (3 scanlines)
         auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
@@ -1019,20 +1146,70 @@ namespace
         const XMVECTOR* urow2 = urow0 + 1;
         const XMVECTOR* urow3 = urow1 + 1;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        if (height <= 1)
         {
-            if (height <= 1)
+            urow1 = urow0;
+        }
+
+        if (width <= 1)
+        {
+            urow2 = urow0;
+            urow3 = urow1;
+        }
+
+        const size_t rowPitch = src->rowPitch;
+
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+
+        const uint8_t* pSrc = src->pixels + rowPitch * ((urow0 != urow1) ? yBegin * 2 : yBegin);
+        uint8_t* pDest = dest->pixels + dest->rowPitch * yBegin;
+
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
+                return E_FAIL;
+            pSrc += rowPitch;
+
+            if (urow0 != urow1)
             {
-                urow1 = urow0;
+                if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
+                    return E_FAIL;
+                pSrc += rowPitch;
             }
 
-            if (width <= 1)
+            for (size_t x = 0; x < nwidth; ++x)
             {
-                urow2 = urow0;
-                urow3 = urow1;
+                const size_t x2 = x << 1;
+
+                AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
             }
 
+            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                return E_FAIL;
+            pDest += dest->rowPitch;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (!ispow2(width) || !ispow2(height))
+            return E_FAIL;
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
             // 2D box filter
             const Image* src = mipChain.GetImage(level - 1, item, 0);
             const Image* dest = mipChain.GetImage(level, item, 0);
@@ -1040,51 +1217,110 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
-
-            const size_t rowPitch = src->rowPitch;
-
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                    return E_FAIL;
-                pSrc += rowPitch;
+            const bool fastPath = UseFastSRGBBoxFilter(width, height, src->format, filter);
+
+            const HRESULT hr = ParallelForBands(nheight, MinRowsPerMipBand(nwidth), MaxMipThreads(),
+                [&](size_t yBegin, size_t yEnd) noexcept
+                {
+                    return fastPath
+                        ? Generate2DMipsBoxFilterRowsSRGB(width, yBegin, yEnd, src, dest, filter)
+                        : Generate2DMipsBoxFilterRows(width, height, yBegin, yEnd, src, dest, filter);
+                });
+            if (FAILED(hr))
+                return hr;
+
+            if (height > 1)
+                height >>= 1;
 
-                if (urow0 != urow1)
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+
+
+    //--- 2D Linear Filter ---
+    HRESULT Generate2DMipsLinearFilterRows(
+        size_t width, size_t yBegin, size_t yEnd,
+        _In_reads_(width) const Filters::LinearFilter* lfX, _In_ const Filters::LinearFilter* lfY,
+        _In_ const Image* src, _In_ const Image* dest, TEX_FILTER_FLAGS filter) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        // Allocate temporary space (3 scanlines)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* row0 = target + width;
+        XMVECTOR* row1 = target + width * 2;
+
+    #ifdef _DEBUG
+        memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+        memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+    #endif
+
+        const uint8_t* pSrc = src->pixels;
+        uint8_t* pDest = dest->pixels + dest->rowPitch * yBegin;
+
+        const size_t rowPitch = src->rowPitch;
+
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+
+        size_t u0 = size_t(-1);
+        size_t u1 = size_t(-1);
+
+        for (size_t y = yBegin; y < yEnd; ++y)
+        {
+            auto const& toY = lfY[y];
+
+            if (toY.u0 != u0)
+            {
+                if (toY.u0 != u1)
                 {
-                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
+                    u0 = toY.u0;
+
+                    if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
                         return E_FAIL;
-                    pSrc += rowPitch;
                 }
-
-                for (size_t x = 0; x < nwidth; ++x)
+                else
                 {
-                    const size_t x2 = x << 1;
+                    u0 = u1;
+                    u1 = size_t(-1);
 
-                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                    std::swap(row0, row1);
                 }
+            }
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+            if (toY.u1 != u1)
+            {
+                u1 = toY.u1;
+
+                if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
                     return E_FAIL;
-                pDest += dest->rowPitch;
             }
 
-            if (height > 1)
-                height >>= 1;
+            for (size_t x = 0; x < nwidth; ++x)
+            {
+                auto const& toX = lfX[x];
 
-            if (width > 1)
-                width >>= 1;
+                BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+            }
+
+            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                return E_FAIL;
+            pDest += dest->rowPitch;
         }
 
         return S_OK;
     }
 
-
-    //--- 2D Linear Filter ---
     HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
     {
         using namespace DirectX::Filters;
@@ -1099,11 +1335,7 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
+        // Allocate X and Y filters (shared read-only by every row band)
         std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
         if (!lf)
             return E_OUTOFMEMORY;
@@ -1111,11 +1343,6 @@ namespace
         LinearFilter* lfX = lf.get();
         LinearFilter* lfY = lf.get() + width;
 
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row0 = target + width;
-        XMVECTOR* row1 = target + width * 2;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
@@ -1126,66 +1353,19 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
-
-            const size_t rowPitch = src->rowPitch;
-
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
             CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
 
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
             CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        #ifdef _DEBUG
-            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
-        #endif
-
-            size_t u0 = size_t(-1);
-            size_t u1 = size_t(-1);
-
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                auto const& toY = lfY[y];
-
-                if (toY.u0 != u0)
-                {
-                    if (toY.u0 != u1)
-                    {
-                        u0 = toY.u0;
-
-                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
-                    else
-                    {
-                        u0 = u1;
-                        u1 = size_t(-1);
-
-                        std::swap(row0, row1);
-                    }
-                }
-
-                if (toY.u1 != u1)
+            const HRESULT hr = ParallelForBands(nheight, MinRowsPerMipBand(nwidth), MaxMipThreads(),
+                [&](size_t yBegin, size_t yEnd) noexcept
                 {
-                    u1 = toY.u1;
-
-                    if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                        return E_FAIL;
-                }
-
-                for (size_t x = 0; x < nwidth; ++x)
-                {
-                    auto const& toX = lfX[x];
-
-                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
-                }
-
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-            }
+                    return Generate2DMipsLinearFilterRows(width, yBegin, yEnd, lfX, lfY, src, dest, filter);
+                });
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -2800,6 +2980,18 @@ namespace
 }
 
 
+//-------------------------------------------------------------------------------------
+// Configure the custom 2D mip filters
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::Internal::SetMipGenerationOptions(size_t maxThreads, size_t minPixelsPerThread, bool allowFastPaths) noexcept
+{
+    s_mipMaxThreads.store(maxThreads, std::memory_order_relaxed);
+    s_mipMinPixelsPerBand.store(minPixelsPerThread ? minPixelsPerThread : c_MinPixelsPerMipBand, std::memory_order_relaxed);
+    s_mipAllowFastPaths.store(allowFastPaths, std::memory_order_relaxed);
+}
+
+
 //=====================================================================================
 // Entry-points
 //=====================================================================================
@@ -130,6 +130,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
@@ -137,12 +138,12 @@
 #include <iterator>
 #include <memory>
 #include <new>
+#include <thread>
 #include <tuple>
 
 #ifndef _WIN32
 #include <fstream>
 #include <filesystem>
-#include <thread>
 #endif
 
 #define _XM_NO_XMVECTOR_OVERLOADS_
@@ -428,6 +429,76 @@ namespace DirectX
         bool __cdecl CalculateMipLevels3D(_In_ size_t width, _In_ size_t height, _In_ size_t depth,
             _Inout_ size_t& mipLevels) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Portable parallel-for over [0, count) split into contiguous bands (std::thread, no OpenMP)
+        inline size_t GetParallelThreadCount(_In_ size_t count, _In_ size_t minPerThread, _In_ size_t maxThreads = 0) noexcept
+        {
+            size_t threads = std::thread::hardware_concurrency();
+            if (!threads)
+                threads = 1;
+
+            if (maxThreads > 0 && threads > maxThreads)
+                threads = maxThreads;
+
+            if (minPerThread > 0 && threads > count / minPerThread)
+                threads = count / minPerThread;
+
+            return (threads > 0) ? threads : 1;
+        }
+
+        template<typename Fn>
+        HRESULT ParallelForBands(_In_ size_t count, _In_ size_t minPerThread, _In_ size_t maxThreads, Fn&& fn) noexcept
+        {
+            const size_t threads = GetParallelThreadCount(count, minPerThread, maxThreads);
+            if (threads <= 1)
+                return fn(size_t(0), count);
+
+            std::unique_ptr<std::thread[]> workers(new (std::nothrow) std::thread[threads - 1]);
+            std::unique_ptr<HRESULT[]> results(new (std::nothrow) HRESULT[threads]);
+            if (!workers || !results)
+                return fn(size_t(0), count);
+
+            HRESULT* pResults = results.get();
+
+            // Band 0 runs on the calling thread, the rest on workers
+            for (size_t i = 1; i < threads; ++i)
+            {
+                const size_t begin = (count * i) / threads;
+                const size_t end = (count * (i + 1)) / threads;
+
+                try
+                {
+                    workers[i - 1] = std::thread([&fn, pResults, i, begin, end]() noexcept { pResults[i] = fn(begin, end); });
+                }
+                catch (...)
+                {
+                    // Thread creation failed; do the work inline
+                    pResults[i] = fn(begin, end);
+                }
+            }
+
+            pResults[0] = fn(size_t(0), count / threads);
+
+            for (size_t i = 0; i < threads - 1; ++i)
+            {
+                if (workers[i].joinable())
+                    workers[i].join();
+            }
+
+            for (size_t i = 0; i < threads; ++i)
+            {
+                if (FAILED(pResults[i]))
+                    return pResults[i];
+            }
+
+            return S_OK;
+        }
+
+        void __cdecl SetMipGenerationOptions(_In_ size_t maxThreads, _In_ size_t minPixelsPerThread, _In_ bool allowFastPaths) noexcept;
+            // Process-wide settings for the custom (non-WIC) 2D point, box and linear mip filters; for regression tests only
+            // maxThreads of '0' uses every hardware thread and '1' runs serially; minPixelsPerThread of '0' restores the default band size
+            // allowFastPaths=false forces the generic scanline filters
+
     #ifdef _WIN32
         HRESULT __cdecl ResizeSeparateColorAndAlpha(_In_ IWICImagingFactory* pWIC,
             _In_ bool iswic2,
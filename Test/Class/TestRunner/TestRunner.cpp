@@ -0,0 +1,83 @@
+#include "TestRunner.h"
+
+// 条件を確かめる
+bool TestContext::Check(bool condition, const char* expression, const char* file, int line)
+{
+	++numChecks_;
+
+	if (condition == false)
+	{
+		Fail(expression, file, line);
+	}
+
+	return condition;
+}
+
+// 失敗を記録する
+void TestContext::Fail(const std::string& message, const char* file, int line)
+{
+	failures_.push_back(engine::format("{}({}): {}", file, line, message));
+}
+
+// テストを登録する
+void TestRunner::Add(const std::string& group, const std::string& name, std::function<void(TestContext&)> function)
+{
+	cases_.push_back({ group, name, function });
+}
+
+// 名前にfilterを含むテストを実行し、失敗したテストの数を返す
+uint32_t TestRunner::Run(std::ostream& os, const std::string& filter)
+{
+	uint32_t numFailed = 0;
+	numRun_ = 0;
+
+	for (TestCase& testCase : cases_)
+	{
+		std::string fullName = testCase.group + "/" + testCase.name;
+		if (fullName.find(filter) == std::string::npos)
+			continue;
+
+		++numRun_;
+
+		// 例外が出たら、失敗として続ける
+		TestContext context;
+		try
+		{
+			testCase.function(context);
+		}
+		catch (const std::exception& exception)
+		{
+			context.Fail(engine::format("exception: {}", exception.what()), __FILE__, __LINE__);
+		}
+
+		if (context.GetFailures().empty())
+		{
+			os << engine::format("[ OK ] {} ({} checks)", fullName, context.GetNumChecks()) << std::endl;
+			continue;
+		}
+
+		++numFailed;
+		os << engine::format("[FAIL] {}", fullName) << std::endl;
+		for (const std::string& failure : context.GetFailures())
+		{
+			os << "       " << failure << std::endl;
+		}
+	}
+
+	os << engine::format("{} tests, {} failed", numRun_, numFailed) << std::endl;
+
+	return numFailed;
+}
+
+// 名前にfilterを含むテストの名前を書き出す
+void TestRunner::List(std::ostream& os, const std::string& filter) const
+{
+	for (const TestCase& testCase : cases_)
+	{
+		std::string fullName = testCase.group + "/" + testCase.name;
+		if (fullName.find(filter) != std::string::npos)
+		{
+			os << fullName << std::endl;
+		}
+	}
+}
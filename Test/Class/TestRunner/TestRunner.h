@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <exception>
+#include "../../../Class/Engine/Func/Format/Format.h"
+
+// 条件を確かめる（失敗しても、そのテストの残りは続ける）
+#define TEST_CHECK(context, expression) (context).Check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+// 1つのテストで、確かめた結果を記録する
+class TestContext
+{
+public:
+
+	// 条件を確かめる（falseなら失敗を記録する）
+	bool Check(bool condition, const char* expression, const char* file, int line);
+
+	// 失敗を記録する（値を書き出したいときに使う）
+	void Fail(const std::string& message, const char* file, int line);
+
+	// Getter
+	const std::vector<std::string>& GetFailures() const { return failures_; }
+	uint64_t GetNumChecks() const { return numChecks_; }
+
+
+private:
+
+	// 確かめた数
+	uint64_t numChecks_ = 0;
+
+	// 失敗したもの
+	std::vector<std::string> failures_;
+};
+
+// テスト
+typedef struct TestCase
+{
+	// 分類と名前
+	std::string group;
+	std::string name;
+
+	// 確かめる処理
+	std::function<void(TestContext&)> function;
+}TestCase;
+
+// テストを登録して実行し、失敗したものを書き出す
+class TestRunner
+{
+public:
+
+	// テストを登録する
+	void Add(const std::string& group, const std::string& name, std::function<void(TestContext&)> function);
+
+	// 名前（group/name）にfilterを含むテストを実行し、失敗したテストの数を返す
+	uint32_t Run(std::ostream& os, const std::string& filter);
+
+	// 名前にfilterを含むテストの名前を書き出す（実行はしない）
+	void List(std::ostream& os, const std::string& filter) const;
+
+	// Getter
+	uint32_t GetNumRun() const { return numRun_; }
+
+
+private:
+
+	// 登録したテスト
+	std::vector<TestCase> cases_;
+
+	// 実行したテストの数
+	uint32_t numRun_ = 0;
+};
@@ -0,0 +1,124 @@
+#include "TestCases.h"
+
+/// <summary>
+/// 乱数で、使うパスの範囲と大きさを決めたリソースを作る
+/// </summary>
+/// <param name="random">乱数</param>
+/// <param name="numRequests">リソースの数</param>
+/// <param name="numPasses">パスの数</param>
+/// <param name="isSameSize">全て同じ大きさにするか</param>
+/// <returns>リソース</returns>
+static std::vector<AliasingRequest> MakeRandomAliasingRequests(std::mt19937& random, uint32_t numRequests, uint32_t numPasses, bool isSameSize)
+{
+	std::uniform_int_distribution<uint32_t> passDistribution(0, numPasses - 1);
+	std::uniform_int_distribution<uint32_t> lengthDistribution(0, numPasses / 8);
+	std::uniform_int_distribution<uint64_t> sizeDistribution(1, 16 * 1024 * 1024);
+	std::uniform_int_distribution<uint32_t> alignmentDistribution(0, 3);
+
+	std::vector<AliasingRequest> requests;
+	for (uint32_t i = 0; i < numRequests; ++i)
+	{
+		AliasingRequest request{};
+		request.firstPass = passDistribution(random);
+		request.lastPass = (std::min)(request.firstPass + lengthDistribution(random), numPasses - 1);
+
+		if (isSameSize)
+		{
+			request.sizeInBytes = kDefaultAliasingAlignment;
+			request.alignment = kDefaultAliasingAlignment;
+		}
+		else
+		{
+			// 4MB揃え（MSAA）も混ぜる
+			request.sizeInBytes = sizeDistribution(random);
+			request.alignment = alignmentDistribution(random) == 0 ? 4 * 1024 * 1024 : kDefaultAliasingAlignment;
+		}
+
+		requests.push_back(request);
+	}
+
+	return requests;
+}
+
+// リソースを重ねて置く処理（Func/AliasingPlan）のテストを登録する
+void RegisterAliasingTests(TestRunner& runner)
+{
+	// 何も無ければ、ヒープもいらない
+	runner.Add("Aliasing", "EmptyPlan", [](TestContext& context)
+		{
+			AliasingPlan plan = PlanAliasing({});
+			TEST_CHECK(context, plan.offsets.empty());
+			TEST_CHECK(context, plan.heapSize == 0);
+			TEST_CHECK(context, plan.unaliasedSize == 0);
+		});
+
+	// 使うパスが重なるものは並べ、重ならないものは同じ位置に置く
+	runner.Add("Aliasing", "SharesOnlyDisjointLifetimes", [](TestContext& context)
+		{
+			const uint64_t kSize = kDefaultAliasingAlignment;
+			std::vector<AliasingRequest> requests =
+			{
+				{ kSize, kDefaultAliasingAlignment, 0, 1 },
+				{ kSize, kDefaultAliasingAlignment, 1, 2 },
+				{ kSize, kDefaultAliasingAlignment, 2, 3 },
+				{ kSize, kDefaultAliasingAlignment, 3, 4 }
+			};
+
+			AliasingPlan plan = PlanAliasing(requests);
+			TEST_CHECK(context, ValidateAliasing(requests, plan));
+			TEST_CHECK(context, plan.offsets[0] == plan.offsets[2]);
+			TEST_CHECK(context, plan.offsets[1] == plan.offsets[3]);
+			TEST_CHECK(context, plan.offsets[0] != plan.offsets[1]);
+			TEST_CHECK(context, plan.heapSize == kSize * 2);
+			TEST_CHECK(context, plan.unaliasedSize == kSize * 4);
+		});
+
+	// 使うパスが重なるのに同じ位置に置いたもの、揃えを守らないものは、正しくないと分かる
+	runner.Add("Aliasing", "ValidateRejectsBrokenPlans", [](TestContext& context)
+		{
+			const uint64_t kSize = kDefaultAliasingAlignment;
+			std::vector<AliasingRequest> requests =
+			{
+				{ kSize, kDefaultAliasingAlignment, 0, 2 },
+				{ kSize, kDefaultAliasingAlignment, 1, 3 }
+			};
+
+			AliasingPlan plan = PlanAliasing(requests);
+			TEST_CHECK(context, ValidateAliasing(requests, plan));
+
+			AliasingPlan overlapped = plan;
+			overlapped.offsets[1] = overlapped.offsets[0];
+			TEST_CHECK(context, ValidateAliasing(requests, overlapped) == false);
+
+			AliasingPlan misaligned = plan;
+			misaligned.offsets[1] += 256;
+			misaligned.heapSize += 256;
+			TEST_CHECK(context, ValidateAliasing(requests, misaligned) == false);
+		});
+
+	// 乱数で作った多くの組で、配置が正しいことを確かめる
+	// 同じ大きさのものだけなら区間グラフの彩色になり、使い始める順に置けば、同時に使う最大の数で収まる
+	runner.Add("Aliasing", "RandomPlansAreValid", [](TestContext& context)
+		{
+			const uint32_t kMaxRequests = 256;
+			const uint32_t kNumPasses = 128;
+
+			std::mt19937 random(20240601u);
+
+			for (uint32_t trial = 0; trial < 1000; ++trial)
+			{
+				bool isSameSize = trial % 2 == 0;
+				std::vector<AliasingRequest> requests = MakeRandomAliasingRequests(random, 1 + trial % kMaxRequests, kNumPasses, isSameSize);
+				AliasingPlan plan = PlanAliasing(requests);
+
+				// 失敗したら、どの組かを書き出して止める
+				bool isValid = ValidateAliasing(requests, plan) && plan.heapSize >= plan.peakLiveSize && plan.heapSize <= plan.unaliasedSize;
+				bool isOptimal = isSameSize == false || plan.heapSize == plan.peakLiveSize;
+				if (TEST_CHECK(context, isValid) == false || TEST_CHECK(context, isOptimal) == false)
+				{
+					context.Fail(engine::format("trial {} ({} requests, heap {}, peak {})", trial, requests.size(), plan.heapSize, plan.peakLiveSize), __FILE__, __LINE__);
+					return;
+				}
+			}
+		});
+}
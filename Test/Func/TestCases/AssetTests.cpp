@@ -0,0 +1,234 @@
+#include "TestCases.h"
+
+/// <summary>
+/// 乱数で、縮みやすさの違うバイト列を作る
+/// </summary>
+/// <param name="random">乱数</param>
+/// <param name="size">バイト数</param>
+/// <returns>同じ並びの繰り返しと、でたらめなバイトが混ざったバイト列</returns>
+static std::vector<uint8_t> MakeRandomBytes(std::mt19937& random, size_t size)
+{
+	std::vector<uint8_t> bytes(size);
+
+	// 使う値の種類が少ないほど、同じ並びが多くなる
+	uint32_t numSymbols = 1 + random() % 256;
+	for (size_t i = 0; i < size; )
+	{
+		// 前に出てきた並びを写す（離れた位置から写すと、重なった一致になる）
+		if (i > 0 && random() % 2 == 0)
+		{
+			size_t distance = 1 + random() % std::min<size_t>(i, 70000);
+			size_t length = std::min<size_t>(1 + random() % 300, size - i);
+			for (size_t k = 0; k < length; ++k, ++i)
+			{
+				bytes[i] = bytes[i - distance];
+			}
+		}
+		else
+		{
+			size_t length = std::min<size_t>(1 + random() % 64, size - i);
+			for (size_t k = 0; k < length; ++k, ++i)
+			{
+				bytes[i] = uint8_t(random() % numSymbols);
+			}
+		}
+	}
+
+	return bytes;
+}
+
+// ファイルを書き出す
+static void WriteBinaryFile(const std::string& filePath, const std::vector<uint8_t>& bytes)
+{
+	std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+
+	std::ofstream file(filePath, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+/// <summary>
+/// ディレクトリにファイルを書いてアーカイブにまとめ、マウントしてAssetFileから元の中身が読めるかを確かめる
+/// </summary>
+/// <param name="context">結果を記録する先</param>
+/// <param name="compress">圧縮するかどうか</param>
+static void CheckPackedArchive(TestContext& context, bool compress)
+{
+	const std::string name = compress ? "PackCompressed" : "PackStored";
+	const std::string directoryPath = MakeTestFilePath(name);
+	const std::string archivePath = MakeTestFilePath(name + ".pak");
+	std::filesystem::remove_all(directoryPath);
+
+	// 縮むもの、縮まないもの、空のもの、深い階層のもの
+	std::mt19937 random(20240601u);
+	std::vector<std::pair<std::string, std::vector<uint8_t>>> files =
+	{
+		{ directoryPath + "/Textures/repeat.dds" , std::vector<uint8_t>(100000, 0x7f) },
+		{ directoryPath + "/Textures/noise.png" , std::vector<uint8_t>(50000) },
+		{ directoryPath + "/Models/Nested/empty.obj" , std::vector<uint8_t>() },
+		{ directoryPath + "/Models/Nested/mixed.obj" , MakeRandomBytes(random, 30000) },
+		{ directoryPath + "/readme.txt" , std::vector<uint8_t>({ 'p' , 'a' , 'k' }) }
+	};
+
+	for (uint8_t& byte : files[1].second)
+	{
+		byte = uint8_t(random());
+	}
+
+	for (const auto& file : files)
+	{
+		WriteBinaryFile(file.first, file.second);
+	}
+
+	if (TEST_CHECK(context, PackAssetArchive(directoryPath, archivePath, compress)) == false)
+		return;
+
+	// ディスクから読んでいないことを確かめるため、元のファイルを消す
+	std::filesystem::remove_all(directoryPath);
+
+	AssetArchive archive;
+	if (TEST_CHECK(context, archive.Open(archivePath)) == false)
+		return;
+
+	TEST_CHECK(context, archive.GetNumEntries() == files.size());
+
+	// 縮むものだけを圧縮する
+	const AssetArchiveEntry* repeat = archive.FindEntry(files[0].first);
+	const AssetArchiveEntry* noise = archive.FindEntry(files[1].first);
+	if (TEST_CHECK(context, repeat != nullptr && noise != nullptr))
+	{
+		TEST_CHECK(context, repeat->compression == (compress ? kAssetCompressionLZ4 : kAssetCompressionNone));
+		TEST_CHECK(context, noise->compression == kAssetCompressionNone);
+		TEST_CHECK(context, archive.GetStoredData(*noise).size() == files[1].second.size());
+	}
+
+	// パスの書き方が違っても見つかり、無いものは見つからない
+	TEST_CHECK(context, archive.FindEntry("./" + directoryPath + "/Models/../readme.txt") != nullptr);
+	TEST_CHECK(context, archive.FindEntry(directoryPath + "/missing.txt") == nullptr);
+
+	AssetFile::MountArchive(&archive);
+
+	for (const auto& file : files)
+	{
+		AssetFile assetFile;
+		if (TEST_CHECK(context, assetFile.Open(file.first)) == false)
+			continue;
+
+		TEST_CHECK(context, assetFile.IsFromArchive());
+		TEST_CHECK(context, std::vector<uint8_t>(assetFile.GetData(), assetFile.GetData() + assetFile.GetSize()) == file.second);
+
+		// ストリームからも同じ中身が読める
+		std::vector<uint8_t> streamed((std::istreambuf_iterator<char>(assetFile.GetStream())), std::istreambuf_iterator<char>());
+		TEST_CHECK(context, streamed == file.second);
+
+		TEST_CHECK(context, AssetFile::GetStamp(file.first) == HashBytes(file.second.data(), file.second.size()));
+	}
+
+	TEST_CHECK(context, AssetFile::Exists(directoryPath + "/missing.txt") == false);
+
+	AssetFile::UnmountArchive(&archive);
+
+	// マウントを解除したら、もう読めない
+	TEST_CHECK(context, AssetFile::Exists(files[0].first) == false);
+}
+
+// アセットの圧縮とアーカイブ（Func/Compression、Func/AssetPacker、Class/AssetArchive、Class/AssetFile）のテストを登録する
+void RegisterAssetTests(TestRunner& runner)
+{
+	// 乱数で作ったデータを圧縮して展開すると、元に戻る
+	runner.Add("Compression", "LZ4RoundTripFuzz", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+
+			for (uint32_t trial = 0; trial < 300; ++trial)
+			{
+				// 小さいもの（リテラルと一致の長さの境目）を多めに、64KBの窓を超えるものも作る
+				size_t size = trial < 100 ? trial : random() % (trial < 280 ? 4096 : 200000);
+				std::vector<uint8_t> source = MakeRandomBytes(random, size);
+
+				std::vector<uint8_t> compressed = CompressLZ4Block(source.data(), source.size());
+
+				// 縮まないものでも、決まった大きさより大きくならない
+				if (TEST_CHECK(context, compressed.size() <= size + size / 255 + 16) == false)
+				{
+					context.Fail("trial " + std::to_string(trial) + " size " + std::to_string(size), __FILE__, __LINE__);
+					return;
+				}
+
+				std::vector<uint8_t> decompressed(size);
+				bool isDecompressed = DecompressLZ4Block(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+				if (TEST_CHECK(context, isDecompressed && decompressed == source) == false)
+				{
+					context.Fail("trial " + std::to_string(trial) + " size " + std::to_string(size), __FILE__, __LINE__);
+					return;
+				}
+			}
+		});
+
+	// 壊れたデータや大きさの違う書き込み先では、書き込み先の外に出ずにfalseを返す
+	runner.Add("Compression", "LZ4RejectsCorruptData", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+			std::vector<uint8_t> source = MakeRandomBytes(random, 20000);
+			std::vector<uint8_t> compressed = CompressLZ4Block(source.data(), source.size());
+
+			// 書き込み先の後ろに印を置き、書き換えられていないかを確かめる
+			const uint8_t kGuard = 0xcd;
+			std::vector<uint8_t> destination(source.size() + 64, kGuard);
+
+			TEST_CHECK(context, DecompressLZ4Block(compressed.data(), compressed.size(), destination.data(), source.size() - 1) == false);
+			TEST_CHECK(context, DecompressLZ4Block(compressed.data(), compressed.size(), destination.data(), source.size() + 1) == false);
+			TEST_CHECK(context, DecompressLZ4Block(compressed.data(), compressed.size() / 2, destination.data(), source.size()) == false);
+
+			uint32_t numOverruns = 0;
+			for (uint32_t trial = 0; trial < 500; ++trial)
+			{
+				std::vector<uint8_t> corrupted = compressed;
+				for (uint32_t i = 0; i < 1 + random() % 8; ++i)
+				{
+					corrupted[random() % corrupted.size()] = uint8_t(random());
+				}
+
+				std::fill(destination.begin(), destination.end(), kGuard);
+				DecompressLZ4Block(corrupted.data(), corrupted.size(), destination.data(), source.size());
+
+				if (std::any_of(destination.begin() + source.size(), destination.end(), [kGuard](uint8_t byte) { return byte != kGuard; }))
+				{
+					++numOverruns;
+				}
+			}
+
+			TEST_CHECK(context, numOverruns == 0);
+		});
+
+	// 圧縮したアーカイブと、圧縮しないアーカイブ
+	runner.Add("AssetArchive", "PackMountReadCompressed", [](TestContext& context) { CheckPackedArchive(context, true); });
+	runner.Add("AssetArchive", "PackMountReadStored", [](TestContext& context) { CheckPackedArchive(context, false); });
+
+	// 壊れたアーカイブは開かない
+	runner.Add("AssetArchive", "RejectsCorruptArchive", [](TestContext& context)
+		{
+			const std::string directoryPath = MakeTestFilePath("PackCorrupt");
+			const std::string archivePath = MakeTestFilePath("PackCorrupt.pak");
+			std::filesystem::remove_all(directoryPath);
+			WriteBinaryFile(directoryPath + "/data.bin", std::vector<uint8_t>(1000, 1));
+
+			if (TEST_CHECK(context, PackAssetArchive(directoryPath, archivePath, true)) == false)
+				return;
+
+			std::ifstream file(archivePath, std::ios::binary);
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			file.close();
+
+			// 識別子が違うもの
+			std::vector<uint8_t> badMagic = bytes;
+			badMagic[0] ^= 0xff;
+			WriteBinaryFile(archivePath, badMagic);
+
+			AssetArchive archive;
+			TEST_CHECK(context, archive.Open(archivePath) == false);
+
+			// 途中で切れたもの
+			WriteBinaryFile(archivePath, std::vector<uint8_t>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+			TEST_CHECK(context, archive.Open(archivePath) == false);
+		});
+}
@@ -0,0 +1,209 @@
+#include "TestCases.h"
+
+// アトラスに詰める画像（R8G8B8A8）
+typedef struct AtlasTestImage
+{
+	uint32_t width;
+	uint32_t height;
+	std::vector<uint8_t> pixels;
+}AtlasTestImage;
+
+// 番号と位置から、ピクセルごとに違う値の画像を作る（余白に写した値が、どのピクセルのものかを見分けられるようにする）
+static AtlasTestImage MakeAtlasTestImage(uint32_t number, uint32_t width, uint32_t height)
+{
+	AtlasTestImage image{ width, height, std::vector<uint8_t>(size_t(width) * height * kAtlasBytesPerPixel) };
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint8_t* pixel = image.pixels.data() + (size_t(y) * width + x) * kAtlasBytesPerPixel;
+			pixel[0] = uint8_t(number + 1);
+			pixel[1] = uint8_t(x);
+			pixel[2] = uint8_t(y);
+			pixel[3] = uint8_t(0x80 | ((x >> 8) & 0x7) | (((y >> 8) & 0x7) << 3));
+		}
+	}
+
+	return image;
+}
+
+// 余白を含めた範囲が、同じページで重なっているかどうか
+static bool IsAtlasSlotOverlapped(const AtlasRect& a, const AtlasRect& b, uint32_t padding)
+{
+	if (a.page != b.page)
+		return false;
+
+	uint32_t aRight = a.x - padding + GetAtlasSlotSize(a.width, padding);
+	uint32_t aBottom = a.y - padding + GetAtlasSlotSize(a.height, padding);
+	uint32_t bRight = b.x - padding + GetAtlasSlotSize(b.width, padding);
+	uint32_t bBottom = b.y - padding + GetAtlasSlotSize(b.height, padding);
+
+	return a.x - padding < bRight && b.x - padding < aRight && a.y - padding < bBottom && b.y - padding < aBottom;
+}
+
+// スプライトのアトラスの詰め方（Func/AtlasPacker）のテストを登録する
+void RegisterAtlasPackerTests(TestRunner& runner)
+{
+	// 余白を含めた範囲がページに収まってミップの境界にそろい、同じページで重ならず、UVが0から1に収まる
+	runner.Add("AtlasPacker", "SlotsStayInsidePagesWithoutOverlap", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+			std::uniform_int_distribution<uint32_t> sizeDistribution(1, 200);
+
+			for (uint32_t pageSize : { 256u , 512u })
+			{
+				for (uint32_t padding : { 0u , 1u , 4u , 8u })
+				{
+					std::vector<AtlasRect> rects(80);
+					for (AtlasRect& rect : rects)
+					{
+						rect = { 0, 0, 0, sizeDistribution(random), sizeDistribution(random) };
+					}
+
+					uint32_t numPages = 0;
+					if (TEST_CHECK(context, PackAtlasRects(rects, pageSize, padding, numPages)) == false)
+						return;
+
+					// 1ページには入りきらない量なので、ページを増やしている
+					TEST_CHECK(context, numPages > 1);
+
+					const uint32_t alignment = 1u << (GetAtlasSafeMipLevels(padding) - 1);
+					std::vector<bool> isPageUsed(numPages, false);
+
+					for (size_t i = 0; i < rects.size(); ++i)
+					{
+						const AtlasRect& rect = rects[i];
+						if (TEST_CHECK(context, rect.page < numPages && rect.x >= padding && rect.y >= padding) == false)
+							return;
+
+						isPageUsed[rect.page] = true;
+
+						TEST_CHECK(context, (rect.x - padding) % alignment == 0 && (rect.y - padding) % alignment == 0);
+						TEST_CHECK(context, rect.x - padding + GetAtlasSlotSize(rect.width, padding) <= pageSize);
+						TEST_CHECK(context, rect.y - padding + GetAtlasSlotSize(rect.height, padding) <= pageSize);
+
+						Vector2 uvMin = GetAtlasUVMin(rect, pageSize);
+						Vector2 uvMax = GetAtlasUVMax(rect, pageSize);
+						TEST_CHECK(context, uvMin.x >= 0.0f && uvMin.y >= 0.0f && uvMax.x <= 1.0f && uvMax.y <= 1.0f);
+						TEST_CHECK(context, uvMin.x < uvMax.x && uvMin.y < uvMax.y);
+						TEST_CHECK(context, uvMin.x * float(pageSize) == float(rect.x) && uvMax.y * float(pageSize) == float(rect.y + rect.height));
+
+						for (size_t j = i + 1; j < rects.size(); ++j)
+						{
+							if (TEST_CHECK(context, IsAtlasSlotOverlapped(rect, rects[j], padding) == false) == false)
+							{
+								context.Fail(engine::format("page {} padding {} : image {} overlaps image {}", pageSize, padding, i, j), __FILE__, __LINE__);
+								return;
+							}
+						}
+					}
+
+					// 空のページは作らない
+					TEST_CHECK(context, std::all_of(isPageUsed.begin(), isPageUsed.end(), [](bool isUsed) { return isUsed; }));
+				}
+			}
+		});
+
+	// 画像はそのまま写り、余白（ミップの境界にそろえた分を含む）は最も近い端のピクセルになり、範囲の外には書き込まない
+	runner.Add("AtlasPacker", "PaddingRepeatsEdgePixels", [](TestContext& context)
+		{
+			const uint32_t kPageSize = 64;
+			const uint32_t kPadding = 3;
+
+			const std::pair<uint32_t, uint32_t> sizes[] =
+			{
+				{ 1 , 1 }, { 1 , 7 }, { 9 , 1 }, { 13 , 5 }, { 20 , 20 }, { 31 , 2 }, { 6 , 17 }, { 40 , 40 }, { 2 , 2 }
+			};
+
+			std::vector<AtlasTestImage> images;
+			std::vector<AtlasRect> rects;
+			for (const std::pair<uint32_t, uint32_t>& size : sizes)
+			{
+				images.push_back(MakeAtlasTestImage(uint32_t(images.size()), size.first, size.second));
+				rects.push_back({ 0, 0, 0, size.first, size.second });
+			}
+
+			uint32_t numPages = 0;
+			if (TEST_CHECK(context, PackAtlasRects(rects, kPageSize, kPadding, numPages)) == false)
+				return;
+
+			const size_t pageRowPitch = size_t(kPageSize) * kAtlasBytesPerPixel;
+			std::vector<std::vector<uint8_t>> pages(numPages, std::vector<uint8_t>(pageRowPitch * kPageSize, 0));
+			for (size_t i = 0; i < images.size(); ++i)
+			{
+				CopyAtlasImage(images[i].pixels.data(), size_t(images[i].width) * kAtlasBytesPerPixel, rects[i], kPadding, pages[rects[i].page].data(), pageRowPitch);
+			}
+
+			// 余白を含めた範囲の全てのピクセルが、位置を画像の中にクランプしたピクセルと一致する
+			std::vector<std::vector<bool>> isCovered(numPages, std::vector<bool>(size_t(kPageSize) * kPageSize, false));
+			for (size_t i = 0; i < images.size(); ++i)
+			{
+				const AtlasRect& rect = rects[i];
+				const uint32_t slotWidth = GetAtlasSlotSize(rect.width, kPadding);
+				const uint32_t slotHeight = GetAtlasSlotSize(rect.height, kPadding);
+
+				for (uint32_t y = 0; y < slotHeight; ++y)
+				{
+					for (uint32_t x = 0; x < slotWidth; ++x)
+					{
+						uint32_t pageX = rect.x - kPadding + x;
+						uint32_t pageY = rect.y - kPadding + y;
+						uint32_t srcX = uint32_t(std::clamp<int64_t>(int64_t(x) - kPadding, 0, int64_t(rect.width) - 1));
+						uint32_t srcY = uint32_t(std::clamp<int64_t>(int64_t(y) - kPadding, 0, int64_t(rect.height) - 1));
+
+						const uint8_t* actual = pages[rect.page].data() + pageRowPitch * pageY + size_t(pageX) * kAtlasBytesPerPixel;
+						const uint8_t* expected = images[i].pixels.data() + (size_t(srcY) * rect.width + srcX) * kAtlasBytesPerPixel;
+						if (std::memcmp(actual, expected, kAtlasBytesPerPixel) != 0)
+						{
+							context.Fail(engine::format("image {} ({}x{}) slot pixel ({}, {}) is not source pixel ({}, {})",
+								i, rect.width, rect.height, x, y, srcX, srcY), __FILE__, __LINE__);
+							return;
+						}
+
+						isCovered[rect.page][size_t(pageY) * kPageSize + pageX] = true;
+					}
+				}
+			}
+
+			// どの画像の範囲でもないピクセルは、0のまま
+			for (uint32_t page = 0; page < numPages; ++page)
+			{
+				for (size_t pixel = 0; pixel < size_t(kPageSize) * kPageSize; ++pixel)
+				{
+					if (isCovered[page][pixel])
+						continue;
+
+					const uint8_t* value = pages[page].data() + pixel * kAtlasBytesPerPixel;
+					if (TEST_CHECK(context, value[0] == 0 && value[1] == 0 && value[2] == 0 && value[3] == 0) == false)
+					{
+						context.Fail(engine::format("page {} pixel {} was written outside every slot", page, pixel), __FILE__, __LINE__);
+						return;
+					}
+				}
+			}
+		});
+
+	// 余白を含めるとページより大きい画像は詰められず、ミップの数は余白で守れる段数になる
+	runner.Add("AtlasPacker", "RejectsImagesLargerThanPage", [](TestContext& context)
+		{
+			// 余白4ならミップの境界は4ピクセルで、250+8=258はページの256を超える
+			std::vector<AtlasRect> rects = { { 0, 0, 0, 10, 10 }, { 0, 0, 0, 250, 10 } };
+			uint32_t numPages = 0;
+			TEST_CHECK(context, PackAtlasRects(rects, 256, 4, numPages) == false);
+
+			// 余白2なら250+4=254に収まる
+			rects = { { 0, 0, 0, 10, 10 }, { 0, 0, 0, 250, 10 } };
+			TEST_CHECK(context, PackAtlasRects(rects, 256, 2, numPages) && numPages == 1);
+
+			TEST_CHECK(context, GetAtlasSafeMipLevels(0) == 1);
+			TEST_CHECK(context, GetAtlasSafeMipLevels(1) == 1);
+			TEST_CHECK(context, GetAtlasSafeMipLevels(2) == 2);
+			TEST_CHECK(context, GetAtlasSafeMipLevels(3) == 2);
+			TEST_CHECK(context, GetAtlasSafeMipLevels(4) == 3);
+			TEST_CHECK(context, GetAtlasSafeMipLevels(8) == 4);
+
+			TEST_CHECK(context, GetAtlasSlotSize(13, 3) == 20);
+			TEST_CHECK(context, GetAtlasSlotSize(1, 0) == 1);
+		});
+}
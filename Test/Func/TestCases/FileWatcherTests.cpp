@@ -0,0 +1,129 @@
+#include "TestCases.h"
+
+// ファイルを書き出す（閉じたときに、書き終わった通知が来る）
+static void WriteTextFile(const std::string& filePath, const std::string& text)
+{
+	std::ofstream file(filePath, std::ios::binary);
+	file << text;
+}
+
+// パスの書き方を、FileWatcherが返すものにそろえる
+static std::string NormalizePath(const std::string& filePath)
+{
+	return std::filesystem::path(filePath).lexically_normal().generic_string();
+}
+
+/// <summary>
+/// 変更を待っているファイルが指定した数になるまで、同じ時刻で通知を受け取る（同じ時刻なら、まとめた変更は返らない）
+/// </summary>
+/// <param name="watcher">監視</param>
+/// <param name="currentTime">時刻</param>
+/// <param name="numPending">待っているファイルの数</param>
+/// <returns>指定した数になればtrue（2秒待ってもならなければfalse）</returns>
+static bool WaitForPendingChanges(FileWatcher& watcher, double currentTime, uint32_t numPending)
+{
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		watcher.Update(currentTime);
+		if (watcher.GetNumPendingChanges() >= numPending)
+			return true;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	return false;
+}
+
+// 空の監視するディレクトリを作る
+static std::string MakeWatchDirectory(const std::string& name)
+{
+	std::string directoryPath = MakeTestFilePath(name);
+	std::filesystem::remove_all(directoryPath);
+	std::filesystem::create_directories(directoryPath);
+	return directoryPath;
+}
+
+// ファイルの変更の監視（Class/FileWatcher）のテストを登録する
+void RegisterFileWatcherTests(TestRunner& runner)
+{
+	// 書き方をそろえ、名前の順に返す
+	runner.Add("FileWatcher", "AddChangeNormalizesAndSorts", [](TestContext& context)
+		{
+			FileWatcher watcher;
+			watcher.AddChange("Resources/./Textures/../b.png", 0.0);
+			watcher.AddChange("Resources/a.png", 0.0);
+			watcher.AddChange("Resources/a.png", 0.1);
+
+			TEST_CHECK(context, watcher.GetNumPendingChanges() == 2);
+			TEST_CHECK(context, watcher.Update(0.1).empty());
+
+			std::vector<std::string> changed = watcher.Update(1.0);
+			TEST_CHECK(context, changed == std::vector<std::string>({ "Resources/a.png", "Resources/b.png" }));
+			TEST_CHECK(context, watcher.GetNumPendingChanges() == 0);
+		});
+
+	// 保存中の連続した書き込みは、最後の書き込みから一定時間たってから1回だけ返す
+	runner.Add("FileWatcher", "DebouncesRepeatedWrites", [](TestContext& context)
+		{
+			std::string directoryPath = MakeWatchDirectory("WatchDebounce");
+			std::string filePath = directoryPath + "/texture.png";
+
+			FileWatcher watcher;
+			watcher.SetDebounceSeconds(0.25);
+			if (TEST_CHECK(context, watcher.AddDirectory(directoryPath)) == false)
+				return;
+
+			WriteTextFile(filePath, "first");
+			TEST_CHECK(context, WaitForPendingChanges(watcher, 0.0, 1));
+
+			// 0.2秒後にもう一度書き込むと、最後の変更の時刻が0.2秒になる
+			WriteTextFile(filePath, "second");
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			TEST_CHECK(context, watcher.Update(0.2).empty());
+
+			// 最初の書き込みからは0.25秒たっているが、最後の書き込みからはたっていない
+			TEST_CHECK(context, watcher.Update(0.4).empty());
+
+			std::vector<std::string> changed = watcher.Update(0.46);
+			TEST_CHECK(context, changed == std::vector<std::string>({ NormalizePath(filePath) }));
+
+			// 返したものは、もう返さない
+			TEST_CHECK(context, watcher.Update(5.0).empty());
+		});
+
+	// 監視を始めた後に作られたディレクトリも監視し、監視に加えるまでに書かれたファイルも返す
+	runner.Add("FileWatcher", "WatchesNewSubdirectories", [](TestContext& context)
+		{
+			std::string directoryPath = MakeWatchDirectory("WatchSubdirectory");
+
+			FileWatcher watcher;
+			watcher.SetDebounceSeconds(0.25);
+			if (TEST_CHECK(context, watcher.AddDirectory(directoryPath)) == false)
+				return;
+
+			TEST_CHECK(context, watcher.GetNumDirectories() == 1);
+
+			// 通知を受け取る前に、ディレクトリを作ってすぐに書き込む
+			std::filesystem::create_directories(directoryPath + "/Sub");
+			WriteTextFile(directoryPath + "/Sub/early.png", "early");
+			std::filesystem::create_directories(directoryPath + "/Nested/Deeper");
+			WriteTextFile(directoryPath + "/Nested/Deeper/nested.png", "nested");
+			TEST_CHECK(context, WaitForPendingChanges(watcher, 0.0, 2));
+
+			// 監視に加えた後に書き込んだもの
+			WriteTextFile(directoryPath + "/Sub/late.png", "late");
+			WriteTextFile(directoryPath + "/Nested/Deeper/later.png", "later");
+			TEST_CHECK(context, WaitForPendingChanges(watcher, 0.0, 4));
+
+			std::vector<std::string> expected =
+			{
+				NormalizePath(directoryPath + "/Nested/Deeper/later.png"),
+				NormalizePath(directoryPath + "/Nested/Deeper/nested.png"),
+				NormalizePath(directoryPath + "/Sub/early.png"),
+				NormalizePath(directoryPath + "/Sub/late.png")
+			};
+			TEST_CHECK(context, watcher.Update(1.0) == expected);
+		});
+}
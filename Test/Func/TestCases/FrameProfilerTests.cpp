@@ -0,0 +1,206 @@
+#include "TestCases.h"
+
+// リングバッファに記録できる区間の数
+static const uint64_t kNumProfileRecords = FrameProfileThreadBuffer::kNumRecords;
+
+// 区間の名前（番号から決める）
+static const char* const kProfileNames[] = { "Update", "Draw", "Present" };
+
+// 番号sequenceの区間を書き込む（全ての値を番号から決め、読んだ区間が1つの書き込みのものかを確かめられるようにする）
+static void WriteSequenceRecord(FrameProfileThreadBuffer* buffer, uint32_t sequence)
+{
+	FrameProfiler::WriteRecord(buffer, kProfileNames[sequence % 3], int64_t(sequence), int64_t(sequence) * 3 + 1, sequence);
+}
+
+// 区間の深さに入れた番号の区間として、全ての値が合っているかどうか
+static bool IsSequenceEvent(const FrameProfileEvent& event, double (*ticksToMicroseconds)(int64_t))
+{
+	uint32_t sequence = event.depth;
+	return event.name == kProfileNames[sequence % 3] &&
+		event.startMicroseconds == ticksToMicroseconds(int64_t(sequence)) &&
+		event.durationMicroseconds == ticksToMicroseconds(int64_t(sequence) * 2 + 1);
+}
+
+// フレームの計測（Class/FrameProfiler）のテストを登録する
+void FrameProfilerTests::Register(TestRunner& runner)
+{
+	// 書き込んだ区間を順に読み、読んだところから続きを読む
+	runner.Add("FrameProfiler", "CollectsInOrder", [](TestContext& context)
+		{
+			std::unique_ptr<FrameProfileThreadBuffer> buffer = std::make_unique<FrameProfileThreadBuffer>();
+			uint64_t numDropped = FrameProfiler::GetNumDroppedRecords();
+
+			for (uint32_t i = 0; i < 100; ++i)
+			{
+				WriteSequenceRecord(buffer.get(), i);
+			}
+
+			FrameProfileFrame frame{};
+			FrameProfiler::CollectRecords(buffer.get(), frame);
+
+			if (TEST_CHECK(context, frame.events.size() == 100) == false)
+				return;
+
+			for (uint32_t i = 0; i < 100; ++i)
+			{
+				if (TEST_CHECK(context, frame.events[i].depth == i && IsSequenceEvent(frame.events[i], FrameProfiler::TicksToMicroseconds)) == false)
+					return;
+			}
+
+			TEST_CHECK(context, buffer->readCount == 100);
+			TEST_CHECK(context, FrameProfiler::GetNumDroppedRecords() == numDropped);
+
+			// 新しく書き込んだ分だけを読む
+			WriteSequenceRecord(buffer.get(), 100);
+			FrameProfileFrame nextFrame{};
+			FrameProfiler::CollectRecords(buffer.get(), nextFrame);
+			TEST_CHECK(context, nextFrame.events.size() == 1 && nextFrame.events[0].depth == 100);
+		});
+
+	// 1周以上遅れたら古い方から捨て、捨てた数を数える
+	runner.Add("FrameProfiler", "WrapDropsOldest", [](TestContext& context)
+		{
+			std::unique_ptr<FrameProfileThreadBuffer> buffer = std::make_unique<FrameProfileThreadBuffer>();
+			uint64_t numDropped = FrameProfiler::GetNumDroppedRecords();
+
+			const uint32_t kNumWrapped = 300;
+			for (uint32_t i = 0; i < kNumProfileRecords + kNumWrapped; ++i)
+			{
+				WriteSequenceRecord(buffer.get(), i);
+			}
+
+			FrameProfileFrame frame{};
+			FrameProfiler::CollectRecords(buffer.get(), frame);
+
+			// 上書きされた300に加えて、次に書き込まれる位置にある最も古い1つは、書いている途中かもしれないので捨てる
+			TEST_CHECK(context, FrameProfiler::GetNumDroppedRecords() - numDropped == kNumWrapped + 1);
+			if (TEST_CHECK(context, frame.events.size() == kNumProfileRecords - 1) == false)
+				return;
+
+			TEST_CHECK(context, frame.events.front().depth == kNumWrapped + 1);
+			TEST_CHECK(context, frame.events.back().depth == kNumProfileRecords + kNumWrapped - 1);
+			TEST_CHECK(context, std::all_of(frame.events.begin(), frame.events.end(),
+				[](const FrameProfileEvent& event) { return IsSequenceEvent(event, FrameProfiler::TicksToMicroseconds); }));
+
+			// 追い付いた後は、また全て読める
+			numDropped = FrameProfiler::GetNumDroppedRecords();
+			for (uint32_t i = 0; i < 10; ++i)
+			{
+				WriteSequenceRecord(buffer.get(), 5000 + i);
+			}
+
+			FrameProfileFrame nextFrame{};
+			FrameProfiler::CollectRecords(buffer.get(), nextFrame);
+			TEST_CHECK(context, nextFrame.events.size() == 10 && nextFrame.events.front().depth == 5000);
+			TEST_CHECK(context, FrameProfiler::GetNumDroppedRecords() == numDropped);
+		});
+
+	// 読んだ後に書き込みが追い付いていたら、上書きされた区間だけを捨てる
+	runner.Add("FrameProfiler", "DiscardsRecordsOverwrittenWhileReading", [](TestContext& context)
+		{
+			// 番号0から999までを読んだところで、書き込む側が追加でextraWrites書き込んだとする
+			auto discard = [](uint64_t extraWrites, std::vector<uint32_t>& sequences)
+				{
+					std::unique_ptr<FrameProfileThreadBuffer> buffer = std::make_unique<FrameProfileThreadBuffer>();
+					for (uint32_t i = 0; i < 1000; ++i)
+					{
+						WriteSequenceRecord(buffer.get(), i);
+					}
+
+					// 他のスレッドから読んだ区間は残す
+					FrameProfileFrame frame{};
+					frame.events.push_back({ "Other", 0.0, 0.0, 7, 1 });
+
+					size_t firstEvent = frame.events.size();
+					for (uint32_t i = 0; i < 1000; ++i)
+					{
+						frame.events.push_back({ kProfileNames[i % 3], 0.0, 0.0, i, 0 });
+					}
+
+					for (uint64_t i = 0; i < extraWrites; ++i)
+					{
+						WriteSequenceRecord(buffer.get(), uint32_t(1000 + i));
+					}
+
+					uint64_t numDiscarded = FrameProfiler::DiscardOverwrittenRecords(buffer.get(), frame, firstEvent, 0, 1000);
+
+					sequences.clear();
+					for (const FrameProfileEvent& event : frame.events)
+					{
+						sequences.push_back(event.depth);
+					}
+
+					return numDiscarded;
+				};
+
+			std::vector<uint32_t> sequences;
+			uint64_t numDropped = FrameProfiler::GetNumDroppedRecords();
+
+			// 1周に届かなければ何も捨てない
+			TEST_CHECK(context, discard(0, sequences) == 0 && sequences.size() == 1001);
+			TEST_CHECK(context, discard(kNumProfileRecords - 1000 - 1, sequences) == 0 && sequences.size() == 1001);
+
+			// 次に書き込む番号が、読んだ最も古い区間の位置に来たら、それを捨てる
+			TEST_CHECK(context, discard(kNumProfileRecords - 1000, sequences) == 1);
+			TEST_CHECK(context, sequences.size() == 1000 && sequences[0] == 7 && sequences[1] == 1);
+
+			// 番号0から5は上書き済み、6は書いている途中かもしれない
+			TEST_CHECK(context, discard(kNumProfileRecords - 1000 + 6, sequences) == 7);
+			TEST_CHECK(context, sequences.size() == 1001 - 7 && sequences[0] == 7 && sequences[1] == 7 && sequences.back() == 999);
+
+			// 1周以上追い付かれたら、読んだ分を全て捨てる
+			TEST_CHECK(context, discard(kNumProfileRecords + 2000, sequences) == 1000);
+			TEST_CHECK(context, sequences.size() == 1 && sequences[0] == 7);
+
+			TEST_CHECK(context, FrameProfiler::GetNumDroppedRecords() - numDropped == 1 + 7 + 1000);
+		});
+
+	// 別のスレッドが書き込み続けていても、読んだ区間は1つの書き込みのもので、読んだ数と捨てた数を足すと書き込んだ数になる
+	runner.Add("FrameProfiler", "ConcurrentWriterNeverYieldsTornRecords", [](TestContext& context)
+		{
+			const uint32_t kNumWrites = 200000;
+			std::unique_ptr<FrameProfileThreadBuffer> buffer = std::make_unique<FrameProfileThreadBuffer>();
+			uint64_t numDropped = FrameProfiler::GetNumDroppedRecords();
+
+			std::atomic<bool> isWriting{ true };
+			std::thread writer([&buffer, &isWriting, kNumWrites]()
+				{
+					for (uint32_t i = 0; i < kNumWrites; ++i)
+					{
+						WriteSequenceRecord(buffer.get(), i);
+					}
+
+					isWriting.store(false, std::memory_order_release);
+				});
+
+			uint64_t numCollected = 0;
+			int64_t lastSequence = -1;
+			bool isDone = false;
+			while (isDone == false)
+			{
+				isDone = isWriting.load(std::memory_order_acquire) == false;
+
+				FrameProfileFrame frame{};
+				FrameProfiler::CollectRecords(buffer.get(), frame);
+
+				for (const FrameProfileEvent& event : frame.events)
+				{
+					if (TEST_CHECK(context, IsSequenceEvent(event, FrameProfiler::TicksToMicroseconds) && int64_t(event.depth) > lastSequence) == false)
+					{
+						context.Fail(engine::format("sequence {} after {}", event.depth, lastSequence), __FILE__, __LINE__);
+						isDone = true;
+						break;
+					}
+
+					lastSequence = event.depth;
+				}
+
+				numCollected += frame.events.size();
+			}
+
+			writer.join();
+
+			TEST_CHECK(context, numCollected + (FrameProfiler::GetNumDroppedRecords() - numDropped) == kNumWrites);
+			TEST_CHECK(context, lastSequence == kNumWrites - 1);
+		});
+}
@@ -0,0 +1,285 @@
+#include "TestCases.h"
+
+// 書き出したログを1行ずつ読む
+static std::vector<std::string> ReadLogLines(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	std::vector<std::string> lines;
+	for (std::string line; std::getline(file, line);)
+	{
+		lines.push_back(line);
+	}
+
+	return lines;
+}
+
+// 重要度がlevelで、textを含む行の数
+static uint32_t CountLogLines(const std::vector<std::string>& lines, LogLevel level, const std::string& text)
+{
+	std::string levelText = engine::format("] {:<7} ", Logger::GetLevelName(level));
+
+	uint32_t count = 0;
+	for (const std::string& line : lines)
+	{
+		if (line.find(levelText) != std::string::npos && line.find(text) != std::string::npos)
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+// リングバッファのログ（Class/Logger）のテストを登録する
+void RegisterLoggerTests(TestRunner& runner)
+{
+	// 書式と引数は書き出すスレッドで文字列にし、文字列の引数は書き込んだときにコピーする
+	runner.Add("Logger", "FormatsDeferredArguments", [](TestContext& context)
+		{
+			const std::string filePath = MakeTestFilePath("LoggerFormat.log");
+
+			Logger logger(16);
+
+			// 書き出すスレッドを始める前に書き込み、元の文字列を書き換える
+			char name[] = "first";
+			logger.Write(LogLevel::Info, "name {} , value {} , ratio {:.2f}", static_cast<const char*>(name), 42, 0.5);
+			std::strcpy(name, "other");
+
+			// 置ききれない大きさの引数は、書き込むスレッドで文字列にする
+			std::string longText(LogRecord::kArgumentBytes * 2, 'x');
+			logger.Write(LogLevel::Warning, "long {} {}", longText, longText);
+
+			LogStream stream(logger, LogLevel::Debug);
+			stream << "stream line " << 7 << std::endl << "second line\n";
+
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			logger.Stop();
+
+			std::vector<std::string> lines = ReadLogLines(filePath);
+			if (TEST_CHECK(context, lines.size() == 4) == false)
+				return;
+
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Info, "name first , value 42 , ratio 0.50") == 1);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Warning, "long " + longText + " " + longText) == 1);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Debug, "stream line 7") == 1);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Debug, "second line") == 1);
+		});
+
+	// 複数のスレッドから書き込んでも、スレッドごとの順番は変わらず、1つも欠けない
+	runner.Add("Logger", "PerProducerOrdering", [](TestContext& context)
+		{
+			const uint32_t kNumThreads = 4;
+			const uint32_t kNumMessages = 5000;
+			const std::string filePath = MakeTestFilePath("LoggerOrdering.log");
+
+			// 小さなリングバッファで、何周もさせる（Warningは捨てずに、空くまで待つ）
+			Logger logger(64);
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			std::vector<std::thread> threads;
+			for (uint32_t thread = 0; thread < kNumThreads; ++thread)
+			{
+				threads.emplace_back([&logger, thread, kNumMessages]()
+					{
+						for (uint32_t i = 0; i < kNumMessages; ++i)
+						{
+							logger.Write(LogLevel::Warning, "producer {} message {}", thread, i);
+						}
+					});
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			logger.Stop();
+			TEST_CHECK(context, logger.GetNumDropped() == 0);
+			TEST_CHECK(context, logger.GetNumWritten() == uint64_t(kNumThreads) * kNumMessages);
+
+			// スレッドごとに、次に来るはずの番号
+			std::vector<uint32_t> nextMessages(kNumThreads, 0);
+			for (const std::string& line : ReadLogLines(filePath))
+			{
+				uint32_t thread = 0;
+				uint32_t message = 0;
+				size_t position = line.find("producer ");
+				if (position == std::string::npos || std::sscanf(line.c_str() + position, "producer %u message %u", &thread, &message) != 2 ||
+					thread >= kNumThreads)
+				{
+					context.Fail("unexpected line : " + line, __FILE__, __LINE__);
+					return;
+				}
+
+				if (message != nextMessages[thread])
+				{
+					context.Fail(engine::format("producer {} wrote {} after {}", thread, message, nextMessages[thread]), __FILE__, __LINE__);
+					return;
+				}
+
+				nextMessages[thread]++;
+			}
+
+			TEST_CHECK(context, std::all_of(nextMessages.begin(), nextMessages.end(), [kNumMessages](uint32_t count) { return count == kNumMessages; }));
+		});
+
+	// 満杯で捨てたInfoの数を正しく数え、書き出すときにその数を残す
+	runner.Add("Logger", "CountsDroppedInfo", [](TestContext& context)
+		{
+			const std::string filePath = MakeTestFilePath("LoggerDropped.log");
+
+			// 書き出すスレッドを始める前は空かないので、8つを超えた分は必ず捨てる
+			Logger logger(8);
+			for (uint32_t i = 0; i < 8 + 37; ++i)
+			{
+				logger.Write(LogLevel::Info, "flood {}", i);
+			}
+
+			TEST_CHECK(context, logger.GetNumDropped() == 37);
+
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			logger.Stop();
+
+			std::vector<std::string> lines = ReadLogLines(filePath);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Info, "flood ") == 8);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Info, "flood 7") == 1);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Info, "flood 8") == 0);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Warning, "dropped 37 messages") == 1);
+		});
+
+	// InfoがあふれていてもWarningとErrorは捨てない
+	runner.Add("Logger", "NeverDropsWarningOrError", [](TestContext& context)
+		{
+			const uint32_t kNumThreads = 4;
+			const uint32_t kNumWarnings = 2000;
+			const uint32_t kNumErrors = 20;
+			const std::string filePath = MakeTestFilePath("LoggerNoDrop.log");
+
+			Logger logger(16);
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			// 半分のスレッドはInfoを書き続けて、リングバッファを埋める
+			std::atomic<bool> isFlooding{ true };
+			std::vector<std::thread> floods;
+			for (uint32_t thread = 0; thread < kNumThreads; ++thread)
+			{
+				floods.emplace_back([&logger, &isFlooding]()
+					{
+						for (uint32_t i = 0; isFlooding.load(std::memory_order_relaxed); ++i)
+						{
+							logger.Write(LogLevel::Info, "flood {}", i);
+						}
+					});
+			}
+
+			std::vector<std::thread> threads;
+			for (uint32_t thread = 0; thread < kNumThreads; ++thread)
+			{
+				threads.emplace_back([&logger, thread, kNumWarnings, kNumErrors]()
+					{
+						for (uint32_t i = 0; i < kNumWarnings; ++i)
+						{
+							logger.Write(LogLevel::Warning, "warning {} {}", thread, i);
+
+							if (i % (kNumWarnings / kNumErrors) == 0)
+							{
+								logger.WriteMessage(LogLevel::Error, engine::format("error {} {}", thread, i));
+							}
+						}
+					});
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			isFlooding.store(false);
+			for (std::thread& thread : floods)
+			{
+				thread.join();
+			}
+
+			logger.Stop();
+
+			std::vector<std::string> lines = ReadLogLines(filePath);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Warning, "warning ") == kNumThreads * kNumWarnings);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Error, "error ") == kNumThreads * kNumErrors);
+
+			// 捨てたのはInfoだけなので、書き出した数と捨てた数を足すと、書き込んだInfoの数を含めて合う
+			uint32_t numInfo = CountLogLines(lines, LogLevel::Info, "flood ");
+			TEST_CHECK(context, logger.GetNumWritten() == uint64_t(numInfo) + kNumThreads * (kNumWarnings + kNumErrors));
+		});
+
+	// 最低の重要度より低いものは、リングバッファに置かない
+	runner.Add("Logger", "MinLevelNeverQueues", [](TestContext& context)
+		{
+			const std::string filePath = MakeTestFilePath("LoggerMinLevel.log");
+
+			Logger logger(4);
+			logger.SetMinLevel(LogLevel::Warning);
+			TEST_CHECK(context, logger.IsEnabled(LogLevel::Info) == false);
+			TEST_CHECK(context, logger.IsEnabled(LogLevel::Warning));
+
+			// 置いていれば、4つを超えたところで捨て始める
+			for (uint32_t i = 0; i < 100; ++i)
+			{
+				logger.Write(LogLevel::Debug, "debug {}", i);
+				logger.WriteMessage(LogLevel::Info, "info");
+			}
+
+			LogStream stream(logger, LogLevel::Trace);
+			stream << "trace" << std::endl;
+
+			TEST_CHECK(context, logger.GetNumDropped() == 0);
+
+			logger.Write(LogLevel::Warning, "kept {}", 1);
+
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			logger.Stop();
+
+			std::vector<std::string> lines = ReadLogLines(filePath);
+			TEST_CHECK(context, lines.size() == 1);
+			TEST_CHECK(context, CountLogLines(lines, LogLevel::Warning, "kept 1") == 1);
+			TEST_CHECK(context, logger.GetNumWritten() == 1);
+		});
+
+	// Flushから戻ったときには、それまでに書き込んだものがファイルにある
+	runner.Add("Logger", "FlushWaitsForFile", [](TestContext& context)
+		{
+			const std::string filePath = MakeTestFilePath("LoggerFlush.log");
+
+			Logger logger(8);
+
+			// 始める前は待たない
+			logger.Flush();
+
+			if (TEST_CHECK(context, logger.Start(filePath, false)) == false)
+				return;
+
+			for (uint32_t i = 0; i < 200; ++i)
+			{
+				logger.Write(LogLevel::Info, "flush {}", i);
+				logger.Flush();
+
+				// 書き出すスレッドを止めずに、別に開いて読む
+				std::vector<std::string> lines = ReadLogLines(filePath);
+				if (TEST_CHECK(context, lines.size() == i + 1 && lines.back().ends_with(engine::format("flush {}", i))) == false)
+				{
+					context.Fail(engine::format("after flush {} the file has {} lines", i, lines.size()), __FILE__, __LINE__);
+					break;
+				}
+			}
+
+			logger.Stop();
+		});
+}
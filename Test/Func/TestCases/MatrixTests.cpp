@@ -0,0 +1,65 @@
+#include "TestCases.h"
+
+// 行列が、誤差の範囲で等しいかどうか
+static bool IsNearlyEqual(const Matrix4x4& a, const Matrix4x4& b, float epsilon)
+{
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			if (std::fabs(a.m[row][column] - b.m[row][column]) > epsilon)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// ベクトルが、誤差の範囲で等しいかどうか
+static bool IsNearlyEqual(const Vector3& a, const Vector3& b, float epsilon)
+{
+	return std::fabs(a.x - b.x) <= epsilon && std::fabs(a.y - b.y) <= epsilon && std::fabs(a.z - b.z) <= epsilon;
+}
+
+// 行列の計算（Func/Matrix）のテストを登録する
+void RegisterMatrixTests(TestRunner& runner)
+{
+	// 逆行列を掛けると、単位行列になる
+	runner.Add("Matrix", "InverseTimesMatrixIsIdentity", [](TestContext& context)
+		{
+			std::mt19937 random(1);
+			std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+			for (int i = 0; i < 256; ++i)
+			{
+				Vector3 scale = { 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)) };
+				Vector3 rotation = { distribution(random), distribution(random), distribution(random) };
+				Vector3 translation = { distribution(random) * 10.0f, distribution(random) * 10.0f, distribution(random) * 10.0f };
+
+				Matrix4x4 affine = Make4x4AffineMatrix(scale, rotation, translation);
+				Matrix4x4 product = Multiply(affine, Make4x4InverseMatrix(affine));
+				TEST_CHECK(context, IsNearlyEqual(product, Make4x4IdenityMatrix(), 1e-4f));
+			}
+		});
+
+	// アフィン変換は、拡縮、回転、移動の順に掛けたものと同じ
+	runner.Add("Matrix", "AffineMatchesScaleRotateTranslate", [](TestContext& context)
+		{
+			Vector3 scale = { 2.0f, 0.5f, 1.5f };
+			Vector3 rotation = { 0.3f, -1.2f, 2.0f };
+			Vector3 translation = { 4.0f, -3.0f, 7.0f };
+
+			Matrix4x4 expected = Multiply(Multiply(Make4x4ScaleMatrix(scale), Make4x4RotateMatrix(rotation)), Make4x4TranslateMatrix(translation));
+			TEST_CHECK(context, IsNearlyEqual(Make4x4AffineMatrix(scale, rotation, translation), expected, 1e-5f));
+
+			// 原点は、移動した位置に移る
+			TEST_CHECK(context, IsNearlyEqual(Transform({ 0.0f, 0.0f, 0.0f }, expected), translation, 1e-5f));
+		});
+
+	// Y軸で90度回すと、X軸が-Z軸に移る
+	runner.Add("Matrix", "RotateYQuarterTurn", [](TestContext& context)
+		{
+			Vector3 rotated = Transform({ 1.0f, 0.0f, 0.0f }, Make4x4RotateYMatrix(float(M_PI) / 2.0f));
+			TEST_CHECK(context, IsNearlyEqual(rotated, { 0.0f, 0.0f, -1.0f }, 1e-5f));
+		});
+}
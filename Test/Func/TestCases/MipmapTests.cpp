@@ -0,0 +1,567 @@
+#include "TestCases.h"
+
+// DirectXTexはWindowsでしかビルドしないので、Test.vcxprojだけでコンパイルする
+// 比べる基準に、DirectXTexの内部の行の読み書きとフィルタを使うので、内部のヘッダも読み込む
+#include "../../../Class/Engine/externals/DirectXTex/DirectXTexP.h"
+#include "../../../Class/Engine/externals/DirectXTex/filters.h"
+
+// 比べる基準（行の帯に分ける前の DirectXTexMipmaps.cpp の2Dのフィルタを、変えずに写したもの）
+// 今のフィルタを基準にすると、どの設定も同じように間違えていたときに気付けないので、変える前のものと比べる
+namespace MipmapReference
+{
+    using namespace DirectX;
+
+    //--- 2D Point Filter ---
+    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using namespace DirectX::Internal;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        // Allocate temporary space (2 scanlines)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* row = target + width;
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+        #ifdef _DEBUG
+            memset(row, 0xCD, sizeof(XMVECTOR)*width);
+        #endif
+
+            // 2D point filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+            const uint8_t* pSrc = src->pixels;
+            uint8_t* pDest = dest->pixels;
+
+            const size_t rowPitch = src->rowPitch;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+            const size_t xinc = (width << 16) / nwidth;
+            const size_t yinc = (height << 16) / nheight;
+
+            size_t lasty = size_t(-1);
+
+            size_t sy = 0;
+            for (size_t y = 0; y < nheight; ++y)
+            {
+                if ((lasty ^ sy) >> 16)
+                {
+                    if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
+                        return E_FAIL;
+                    lasty = sy;
+                }
+
+                size_t sx = 0;
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    target[x] = row[sx >> 16];
+                    sx += xinc;
+                }
+
+                if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
+                    return E_FAIL;
+                pDest += dest->rowPitch;
+
+                sy += yinc;
+            }
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+
+
+    //--- 2D Box Filter ---
+    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using namespace DirectX::Internal;
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (!ispow2(width) || !ispow2(height))
+            return E_FAIL;
+
+        // Allocate temporary space (3 scanlines)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* urow0 = target + width;
+        XMVECTOR* urow1 = target + width * 2;
+
+        const XMVECTOR* urow2 = urow0 + 1;
+        const XMVECTOR* urow3 = urow1 + 1;
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            if (height <= 1)
+            {
+                urow1 = urow0;
+            }
+
+            if (width <= 1)
+            {
+                urow2 = urow0;
+                urow3 = urow1;
+            }
+
+            // 2D box filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+            const uint8_t* pSrc = src->pixels;
+            uint8_t* pDest = dest->pixels;
+
+            const size_t rowPitch = src->rowPitch;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+            for (size_t y = 0; y < nheight; ++y)
+            {
+                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
+                    return E_FAIL;
+                pSrc += rowPitch;
+
+                if (urow0 != urow1)
+                {
+                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
+                        return E_FAIL;
+                    pSrc += rowPitch;
+                }
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const size_t x2 = x << 1;
+
+                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                }
+
+                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                    return E_FAIL;
+                pDest += dest->rowPitch;
+            }
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+
+
+    //--- 2D Linear Filter ---
+    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        using namespace DirectX::Internal;
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        // Allocate temporary space (3 scanlines, plus X and Y filters)
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
+        if (!lf)
+            return E_OUTOFMEMORY;
+
+        LinearFilter* lfX = lf.get();
+        LinearFilter* lfY = lf.get() + width;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* row0 = target + width;
+        XMVECTOR* row1 = target + width * 2;
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            // 2D linear filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+            const uint8_t* pSrc = src->pixels;
+            uint8_t* pDest = dest->pixels;
+
+            const size_t rowPitch = src->rowPitch;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
+
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+
+        #ifdef _DEBUG
+            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+        #endif
+
+            size_t u0 = size_t(-1);
+            size_t u1 = size_t(-1);
+
+            for (size_t y = 0; y < nheight; ++y)
+            {
+                auto const& toY = lfY[y];
+
+                if (toY.u0 != u0)
+                {
+                    if (toY.u0 != u1)
+                    {
+                        u0 = toY.u0;
+
+                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
+                            return E_FAIL;
+                    }
+                    else
+                    {
+                        u0 = u1;
+                        u1 = size_t(-1);
+
+                        std::swap(row0, row1);
+                    }
+                }
+
+                if (toY.u1 != u1)
+                {
+                    u1 = toY.u1;
+
+                    if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
+                        return E_FAIL;
+                }
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    auto const& toX = lfX[x];
+
+                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                }
+
+                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                    return E_FAIL;
+                pDest += dest->rowPitch;
+            }
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+}
+
+/// <summary>
+/// 乱数で、指定したフォーマットの画像を作る
+/// </summary>
+/// <param name="random">乱数</param>
+/// <param name="format">フォーマット</param>
+/// <param name="width">横幅</param>
+/// <param name="height">縦幅</param>
+/// <returns>画像</returns>
+static DirectX::ScratchImage MakeRandomImage(std::mt19937& random, DXGI_FORMAT format, size_t width, size_t height)
+{
+	DirectX::ScratchImage image{};
+	HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1);
+	assert(SUCCEEDED(hr));
+
+	uint8_t* pixels = image.GetPixels();
+	for (size_t i = 0; i < image.GetPixelsSize(); ++i)
+	{
+		pixels[i] = uint8_t(random());
+	}
+
+	// R8G8B8A8はそのまま読み替え、それ以外は変換する（浮動小数点でも0～1の値になる）
+	if (format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+	{
+		image.OverrideFormat(format);
+		return image;
+	}
+
+	DirectX::ScratchImage converted{};
+	hr = DirectX::Convert(*image.GetImage(0, 0, 0), format, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+	assert(SUCCEEDED(hr));
+
+	return converted;
+}
+
+// 2のべき乗かどうか
+static bool IsPowerOfTwo(size_t value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+/// <summary>
+/// 設定を変えてミップを作り、設定を元に戻す
+/// </summary>
+/// <param name="source">元の画像</param>
+/// <param name="filter">フィルタ</param>
+/// <param name="maxThreads">スレッドの数の上限（1なら1つのスレッドで作る）</param>
+/// <param name="minPixelsPerThread">1つのスレッドが受け持つ最少のピクセル数（0なら決まった数）</param>
+/// <param name="allowFastPaths">R8G8B8A8のsRGBを速く作る処理を使うかどうか</param>
+/// <param name="mipChain">作ったミップ</param>
+/// <returns>作れたかどうか</returns>
+static HRESULT GenerateMips(const DirectX::ScratchImage& source, DirectX::TEX_FILTER_FLAGS filter,
+	size_t maxThreads, size_t minPixelsPerThread, bool allowFastPaths, DirectX::ScratchImage& mipChain)
+{
+	DirectX::Internal::SetMipGenerationOptions(maxThreads, minPixelsPerThread, allowFastPaths);
+
+	// WICを使わずに、DirectXTexのフィルタで作る
+	HRESULT hr = DirectX::GenerateMipMaps(*source.GetImage(0, 0, 0), filter | DirectX::TEX_FILTER_FORCE_NON_WIC, 0, mipChain);
+
+	DirectX::Internal::SetMipGenerationOptions(0, 0, true);
+
+	return hr;
+}
+
+/// <summary>
+/// 比べる基準のフィルタでミップを作る（GenerateMipMapsと同じように、最上段に元の画像を写してから、フィルタを選んで作る）
+/// </summary>
+/// <param name="source">元の画像</param>
+/// <param name="filter">フィルタ</param>
+/// <param name="mipChain">作ったミップ</param>
+/// <returns>作れたかどうか</returns>
+static HRESULT GenerateReferenceMips(const DirectX::ScratchImage& source, DirectX::TEX_FILTER_FLAGS filter, DirectX::ScratchImage& mipChain)
+{
+	const DirectX::Image& base = *source.GetImage(0, 0, 0);
+
+	// 1x1になるまでの段数
+	size_t levels = 1;
+	for (size_t width = base.width, height = base.height; width > 1 || height > 1; width = (std::max)(width / 2, size_t(1)), height = (std::max)(height / 2, size_t(1)))
+	{
+		++levels;
+	}
+
+	HRESULT hr = mipChain.Initialize2D(base.format, base.width, base.height, 1, levels);
+	if (FAILED(hr))
+		return hr;
+
+	// 最上段に元の画像を写す
+	const DirectX::Image& top = *mipChain.GetImage(0, 0, 0);
+	for (size_t y = 0; y < base.height; ++y)
+	{
+		std::memcpy(top.pixels + top.rowPitch * y, base.pixels + base.rowPitch * y, (std::min)(top.rowPitch, base.rowPitch));
+	}
+
+	// 指定が無ければ、2のべき乗なら箱フィルタ、そうでなければ線形フィルタ
+	DirectX::TEX_FILTER_FLAGS mode = filter & DirectX::TEX_FILTER_MODE_MASK;
+	if (mode == 0)
+	{
+		mode = (IsPowerOfTwo(base.width) && IsPowerOfTwo(base.height)) ? DirectX::TEX_FILTER_BOX : DirectX::TEX_FILTER_LINEAR;
+	}
+
+	filter |= DirectX::TEX_FILTER_FORCE_NON_WIC;
+
+	switch (mode)
+	{
+	case DirectX::TEX_FILTER_BOX:
+		return MipmapReference::Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
+
+	case DirectX::TEX_FILTER_POINT:
+		return MipmapReference::Generate2DMipsPointFilter(levels, mipChain, 0);
+
+	case DirectX::TEX_FILTER_LINEAR:
+		return MipmapReference::Generate2DMipsLinearFilter(levels, filter, mipChain, 0);
+
+	default:
+		return E_NOTIMPL;
+	}
+}
+
+/// <summary>
+/// 2つのミップの全てのバイトが一致するかを確かめる
+/// </summary>
+/// <param name="expected">比べる基準のフィルタで作ったミップ</param>
+/// <param name="actual">確かめるミップ</param>
+/// <returns>一致しない最初の段（全て一致すれば-1）</returns>
+static int32_t FindMismatchedLevel(const DirectX::ScratchImage& expected, const DirectX::ScratchImage& actual)
+{
+	if (expected.GetMetadata().mipLevels != actual.GetMetadata().mipLevels)
+		return 0;
+
+	for (size_t level = 0; level < expected.GetMetadata().mipLevels; ++level)
+	{
+		const DirectX::Image* a = expected.GetImage(level, 0, 0);
+		const DirectX::Image* b = actual.GetImage(level, 0, 0);
+
+		if (a->rowPitch != b->rowPitch || a->slicePitch != b->slicePitch || std::memcmp(a->pixels, b->pixels, a->slicePitch) != 0)
+			return int32_t(level);
+	}
+
+	return -1;
+}
+
+// ミップの作成（externals/DirectXTex の DirectXTexMipmaps）のテストを登録する
+void RegisterMipmapTests(TestRunner& runner)
+{
+	// 1つのスレッドで作ったミップ、速く作る処理、行の帯に分けて作ったミップが、変える前のフィルタで作ったものと全てのバイトで一致する
+	runner.Add("Mipmaps", "ParallelBandsMatchReference", [](TestContext& context)
+		{
+			const DXGI_FORMAT formats[] =
+			{
+				DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+				DXGI_FORMAT_R8G8B8A8_UNORM,
+				DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+				DXGI_FORMAT_R10G10B10A2_UNORM,
+				DXGI_FORMAT_R16G16B16A16_FLOAT,
+				DXGI_FORMAT_R32G32B32A32_FLOAT
+			};
+
+			const DirectX::TEX_FILTER_FLAGS filters[] =
+			{
+				DirectX::TEX_FILTER_DEFAULT,
+				DirectX::TEX_FILTER_BOX,
+				DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_SRGB,
+				DirectX::TEX_FILTER_LINEAR,
+				DirectX::TEX_FILTER_LINEAR | DirectX::TEX_FILTER_SRGB,
+				DirectX::TEX_FILTER_POINT
+			};
+
+			// 正方形、横長、縦長、幅が1のもの、2のべき乗でないもの
+			const std::pair<size_t, size_t> sizes[] =
+			{
+				{ 2 , 2 }, { 64 , 64 }, { 256 , 32 }, { 1 , 64 }, { 128 , 1 }, { 512 , 256 },
+				{ 37 , 23 }, { 1 , 19 }, { 101 , 3 }, { 255 , 257 }
+			};
+
+			// 帯の数（ピクセル数に関係なく分けるように、1つのスレッドが受け持つ最少のピクセル数は1にする）
+			const size_t threadCounts[] = { 2 , 3 , 4 , 7 , 16 };
+
+			std::mt19937 random(20240601u);
+			uint32_t numCompared = 0;
+
+			for (DXGI_FORMAT format : formats)
+			{
+				for (const std::pair<size_t, size_t>& size : sizes)
+				{
+					DirectX::ScratchImage source = MakeRandomImage(random, format, size.first, size.second);
+
+					for (DirectX::TEX_FILTER_FLAGS filter : filters)
+					{
+						// 箱フィルタは2のべき乗の大きさでしか使えない
+						if ((filter & DirectX::TEX_FILTER_MODE_MASK) == DirectX::TEX_FILTER_BOX &&
+							(IsPowerOfTwo(size.first) == false || IsPowerOfTwo(size.second) == false))
+							continue;
+
+						DirectX::ScratchImage expected{};
+						if (TEST_CHECK(context, SUCCEEDED(GenerateReferenceMips(source, filter, expected))) == false)
+							return;
+
+						// 1つのスレッドで、速く作る処理を使わずに作っても同じになる
+						DirectX::ScratchImage serial{};
+						if (TEST_CHECK(context, SUCCEEDED(GenerateMips(source, filter, 1, 0, false, serial))) == false)
+							return;
+
+						TEST_CHECK(context, FindMismatchedLevel(expected, serial) < 0);
+
+						for (size_t threads : threadCounts)
+						{
+							DirectX::ScratchImage actual{};
+							if (TEST_CHECK(context, SUCCEEDED(GenerateMips(source, filter, threads, 1, true, actual))) == false)
+								return;
+
+							int32_t level = FindMismatchedLevel(expected, actual);
+							if (TEST_CHECK(context, level < 0) == false)
+							{
+								context.Fail("format " + std::to_string(uint32_t(format)) + " filter " + std::to_string(uint32_t(filter)) +
+									" size " + std::to_string(size.first) + "x" + std::to_string(size.second) +
+									" threads " + std::to_string(threads) + " level " + std::to_string(level), __FILE__, __LINE__);
+								return;
+							}
+
+							++numCompared;
+						}
+
+						// 1つのスレッドでも、速く作る処理は同じになる
+						DirectX::ScratchImage fast{};
+						if (TEST_CHECK(context, SUCCEEDED(GenerateMips(source, filter, 1, 0, true, fast))) == false)
+							return;
+
+						TEST_CHECK(context, FindMismatchedLevel(expected, fast) < 0);
+					}
+				}
+			}
+
+			TEST_CHECK(context, numCompared > 0);
+		});
+
+	// 決まった設定（ハードウェアのスレッドの数、決まった帯の大きさ）でも、4Kに近い大きさで変える前のフィルタと一致する
+	runner.Add("Mipmaps", "DefaultBandsMatchReference", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+
+			const DXGI_FORMAT formats[] = { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB , DXGI_FORMAT_R8G8B8A8_UNORM };
+			for (DXGI_FORMAT format : formats)
+			{
+				DirectX::ScratchImage source = MakeRandomImage(random, format, 2048, 1024);
+
+				DirectX::ScratchImage expected{};
+				DirectX::ScratchImage actual{};
+				if (TEST_CHECK(context, SUCCEEDED(GenerateReferenceMips(source, DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_SRGB, expected))) == false)
+					return;
+
+				if (TEST_CHECK(context, SUCCEEDED(GenerateMips(source, DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_SRGB, 0, 0, true, actual))) == false)
+					return;
+
+				TEST_CHECK(context, FindMismatchedLevel(expected, actual) < 0);
+			}
+		});
+}
@@ -0,0 +1,368 @@
+#include "TestCases.h"
+
+// 2つのモデルが、同じ頂点、マテリアル、サブメッシュを持つかどうか
+static bool IsSameModel(const ModelData& a, const ModelData& b)
+{
+	if (a.vertices.size() != b.vertices.size() || a.materials.size() != b.materials.size() || a.subMeshes.size() != b.subMeshes.size())
+		return false;
+
+	if (a.vertices.empty() == false && std::memcmp(a.vertices.data(), b.vertices.data(), sizeof(VertexData) * a.vertices.size()) != 0)
+		return false;
+
+	for (size_t i = 0; i < a.materials.size(); ++i)
+	{
+		if (a.materials[i].name != b.materials[i].name || a.materials[i].textureFilePath != b.materials[i].textureFilePath)
+			return false;
+	}
+
+	for (size_t i = 0; i < a.subMeshes.size(); ++i)
+	{
+		if (a.subMeshes[i].indexStart != b.subMeshes[i].indexStart || a.subMeshes[i].indexCount != b.subMeshes[i].indexCount ||
+			a.subMeshes[i].materialIndex != b.subMeshes[i].materialIndex)
+			return false;
+	}
+
+	return true;
+}
+
+// ファイルの中身を全て読む
+static std::string ReadWholeFile(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// 文字列に書いたObjファイルを解釈する（Mtlファイルは参照しない）
+static ModelData ParseObjText(const std::string& text, uint32_t maxThreads)
+{
+	return ParseObj(text.data(), text.size(), ".", maxThreads);
+}
+
+// 頂点が、Objファイルの座標系で書いた位置、UV、法線を左手系に直したものと同じかどうか
+static bool IsObjVertex(const VertexData& vertex, const Vector3& position, const Vector2& texcoord, const Vector3& normal)
+{
+	return vertex.position.x == -position.x && vertex.position.y == position.y && vertex.position.z == position.z && vertex.position.w == 1.0f &&
+		vertex.texcoord.x == texcoord.x && vertex.texcoord.y == 1.0f - texcoord.y &&
+		std::abs(vertex.normal.x + normal.x) < 1e-6f && std::abs(vertex.normal.y - normal.y) < 1e-6f && std::abs(vertex.normal.z - normal.z) < 1e-6f;
+}
+
+// 三角形の頂点が、Objファイルの位置の番号（0始まり）の順に並んでいるかどうか（回り順を逆にするので、頂点は後ろから並ぶ）
+static bool IsObjTriangle(const ModelData& modelData, size_t triangle, const std::vector<Vector3>& positions, const uint32_t (&indices)[3])
+{
+	if (modelData.vertices.size() < (triangle + 1) * 3)
+		return false;
+
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const Vector4& position = modelData.vertices[triangle * 3 + 2 - i].position;
+		const Vector3& expected = positions[indices[i]];
+		if (position.x != -expected.x || position.y != expected.y || position.z != expected.z)
+			return false;
+	}
+
+	return true;
+}
+
+// サブメッシュが、インデックスの範囲とマテリアルの番号で並んでいるかどうか
+static bool IsSameSubMeshes(std::span<const SubMesh> subMeshes, const std::vector<SubMesh>& expected)
+{
+	return std::equal(subMeshes.begin(), subMeshes.end(), expected.begin(), expected.end(), [](const SubMesh& a, const SubMesh& b)
+		{
+			return a.indexStart == b.indexStart && a.indexCount == b.indexCount && a.materialIndex == b.materialIndex;
+		});
+}
+
+// Objファイルの読み込み（Func/ObjParser）のテストを登録する
+void RegisterObjParserTests(TestRunner& runner)
+{
+	// 並列に読んでも、1行ずつ読んだものと同じになる
+	runner.Add("ObjParser", "ParallelMatchesStream", [](TestContext& context)
+		{
+			const std::string directoryPath = "Resources/ModelDatas/monky";
+			ModelData expected = LoadObjFileStream(directoryPath, "monky.obj");
+			TEST_CHECK(context, expected.vertices.empty() == false);
+
+			std::string data = ReadWholeFile(directoryPath + "/monky.obj");
+			for (uint32_t maxThreads : { 1u, 2u, 3u, 8u })
+			{
+				TEST_CHECK(context, IsSameModel(ParseObj(data.data(), data.size(), directoryPath, maxThreads), expected));
+			}
+		});
+
+	// 塊の境目が行の途中に来る大きさでも、1行ずつ読んだものと同じになる
+	runner.Add("ObjParser", "TiledParallelMatchesStream", [](TestContext& context)
+		{
+			std::string filename = WriteTiledObjFile("Resources/ModelDatas/monky", "monky.obj", 64);
+			ModelData expected = LoadObjFileStream(kObjTiledDirectory, filename);
+			TEST_CHECK(context, expected.vertices.empty() == false);
+
+			std::string data = ReadWholeFile(kObjTiledDirectory + "/" + filename);
+			TEST_CHECK(context, data.size() > kObjMinChunkBytes * 2);
+
+			for (uint32_t maxThreads : { 2u, 5u, 16u })
+			{
+				TEST_CHECK(context, IsSameModel(ParseObj(data.data(), data.size(), kObjTiledDirectory, maxThreads), expected));
+			}
+		});
+
+	// 面の頂点の書き方（v/vt/vn、負のインデックス、v、v//vn、v/vt）を、それぞれ読む
+	runner.Add("ObjParser", "FaceVertexForms", [](TestContext& context)
+		{
+			const std::string text =
+				"v 0 0 0\n"
+				"v 2 0 0\n"
+				"v 0 2 0\n"
+				"vt 0.25 0.5\n"
+				"vt 1 0\n"
+				"vt 0 1\n"
+				"vn 0 0 1\n"
+				"vn 1 0 0\n"
+				"f 1/1/1 2/2/2 3/3/1\n"
+				"f -3/-3/-2 -2/-2/-1 -1/-1/-2\n"
+				"f 1 2 3\n"
+				"f 1//2 2//2 3//1\n"
+				"f 1/3 2/2 3/1\n";
+
+			ModelData modelData = ParseObjText(text, 1);
+			if (TEST_CHECK(context, modelData.vertices.size() == 5 * 3) == false)
+				return;
+
+			const std::vector<VertexData>& v = modelData.vertices;
+			const Vector3 kFaceNormal = { 0.0f , 0.0f , 1.0f };
+
+			// v/vt/vn と、同じものを負のインデックスで書いたもの（回り順を逆にするので、頂点は後ろから並ぶ）
+			for (size_t face = 0; face < 2; ++face)
+			{
+				TEST_CHECK(context, IsObjVertex(v[face * 3 + 2], { 0.0f , 0.0f , 0.0f }, { 0.25f , 0.5f }, { 0.0f , 0.0f , 1.0f }));
+				TEST_CHECK(context, IsObjVertex(v[face * 3 + 1], { 2.0f , 0.0f , 0.0f }, { 1.0f , 0.0f }, { 1.0f , 0.0f , 0.0f }));
+				TEST_CHECK(context, IsObjVertex(v[face * 3 + 0], { 0.0f , 2.0f , 0.0f }, { 0.0f , 1.0f }, { 0.0f , 0.0f , 1.0f }));
+			}
+
+			// 位置だけなら、UVは0で、法線は面の法線
+			TEST_CHECK(context, IsObjVertex(v[8], { 0.0f , 0.0f , 0.0f }, { 0.0f , 0.0f }, kFaceNormal));
+			TEST_CHECK(context, IsObjVertex(v[7], { 2.0f , 0.0f , 0.0f }, { 0.0f , 0.0f }, kFaceNormal));
+			TEST_CHECK(context, IsObjVertex(v[6], { 0.0f , 2.0f , 0.0f }, { 0.0f , 0.0f }, kFaceNormal));
+
+			// v//vn は、UVだけが0
+			TEST_CHECK(context, IsObjVertex(v[11], { 0.0f , 0.0f , 0.0f }, { 0.0f , 0.0f }, { 1.0f , 0.0f , 0.0f }));
+			TEST_CHECK(context, IsObjVertex(v[10], { 2.0f , 0.0f , 0.0f }, { 0.0f , 0.0f }, { 1.0f , 0.0f , 0.0f }));
+			TEST_CHECK(context, IsObjVertex(v[9], { 0.0f , 2.0f , 0.0f }, { 0.0f , 0.0f }, { 0.0f , 0.0f , 1.0f }));
+
+			// v/vt は、法線が面の法線
+			TEST_CHECK(context, IsObjVertex(v[14], { 0.0f , 0.0f , 0.0f }, { 0.0f , 1.0f }, kFaceNormal));
+			TEST_CHECK(context, IsObjVertex(v[13], { 2.0f , 0.0f , 0.0f }, { 1.0f , 0.0f }, kFaceNormal));
+			TEST_CHECK(context, IsObjVertex(v[12], { 0.0f , 2.0f , 0.0f }, { 0.25f , 0.5f }, kFaceNormal));
+
+			// マテリアルが無くても、1つのサブメッシュが全体を指す
+			TEST_CHECK(context, modelData.materials.size() == 1);
+			TEST_CHECK(context, modelData.subMeshes.size() == 1 && modelData.subMeshes[0].indexStart == 0 && modelData.subMeshes[0].indexCount == 15);
+		});
+
+	// 四角形と多角形は、最初の頂点を中心に扇形に三角形へ分ける
+	runner.Add("ObjParser", "FanTriangulation", [](TestContext& context)
+		{
+			const std::vector<Vector3> positions =
+			{
+				{ 0.0f , 0.0f , 0.0f } , { 1.0f , 0.0f , 0.0f } , { 1.0f , 1.0f , 0.0f } , { 0.0f , 1.0f , 0.0f } ,
+				{ -1.0f , 2.0f , 0.0f } , { -2.0f , 1.0f , 0.0f }
+			};
+
+			const std::string text =
+				"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv -1 2 0\nv -2 1 0\n"
+				"f 1 2 3 4\n"
+				"f 1 2 3 4 5 6\n"
+				"f -6 -5 -4 -3 -2\n"
+				"f 1 2\n";
+
+			ModelData modelData = ParseObjText(text, 1);
+
+			// 四角形は2枚、六角形は4枚、五角形は3枚、2頂点の面は作らない
+			if (TEST_CHECK(context, modelData.vertices.size() == (2 + 4 + 3) * 3) == false)
+				return;
+
+			TEST_CHECK(context, IsObjTriangle(modelData, 0, positions, { 0 , 1 , 2 }));
+			TEST_CHECK(context, IsObjTriangle(modelData, 1, positions, { 0 , 2 , 3 }));
+
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				TEST_CHECK(context, IsObjTriangle(modelData, 2 + i, positions, { 0 , i + 1 , i + 2 }));
+			}
+
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				TEST_CHECK(context, IsObjTriangle(modelData, 6 + i, positions, { 0 , i + 1 , i + 2 }));
+			}
+
+			// 平らな多角形なので、全て同じ面の法線になる
+			TEST_CHECK(context, std::all_of(modelData.vertices.begin(), modelData.vertices.end(), [](const VertexData& vertex)
+				{
+					return vertex.normal.x == 0.0f && vertex.normal.y == 0.0f && vertex.normal.z == 1.0f;
+				}));
+		});
+
+	// 法線が1つでも欠けていれば、三角形の全ての頂点に、長さ1の面の法線を使う
+	runner.Add("ObjParser", "GeneratesFaceNormals", [](TestContext& context)
+		{
+			const std::string text =
+				"v 0 0 0\n"
+				"v 0 0 3\n"
+				"v 0 3 0\n"
+				"v 4 0 0\n"
+				"vn 0 1 0\n"
+				"f 1 2 3\n"
+				"f 1//1 4//1 3\n"
+				"f 1 2 2\n";
+
+			ModelData modelData = ParseObjText(text, 1);
+			if (TEST_CHECK(context, modelData.vertices.size() == 3 * 3) == false)
+				return;
+
+			const std::vector<VertexData>& v = modelData.vertices;
+
+			// (0,0,3)x(0,3,0) = (-9,0,0) を長さ1にする
+			for (size_t i = 0; i < 3; ++i)
+			{
+				TEST_CHECK(context, std::abs(v[i].normal.x - 1.0f) < 1e-6f && v[i].normal.y == 0.0f && v[i].normal.z == 0.0f);
+			}
+
+			// (4,0,0)x(0,3,0) = (0,0,12) を使い、書かれていた法線(0,1,0)は使わない
+			for (size_t i = 3; i < 6; ++i)
+			{
+				TEST_CHECK(context, v[i].normal.x == 0.0f && v[i].normal.y == 0.0f && std::abs(v[i].normal.z - 1.0f) < 1e-6f);
+			}
+
+			// 面積が無ければ、0のままにする
+			for (size_t i = 6; i < 9; ++i)
+			{
+				TEST_CHECK(context, v[i].normal.x == 0.0f && v[i].normal.y == 0.0f && v[i].normal.z == 0.0f);
+			}
+		});
+
+	// 塊の境目をまたいで、前の塊の頂点を負のインデックスで指しても、同じ頂点を使う
+	runner.Add("ObjParser", "NegativeIndicesAcrossChunks", [](TestContext& context)
+		{
+			// 3頂点ごとに、その三角形と、kLookBack前の3頂点の三角形を書く
+			const uint32_t kNumBlocks = 40000;
+			const uint32_t kLookBack = 64;
+
+			// 三角形ごとの、最初の頂点の番号（3頂点は続いている）
+			std::vector<Vector3> positions;
+			std::vector<uint32_t> triangles;
+			std::string text;
+
+			for (uint32_t block = 0; block < kNumBlocks; ++block)
+			{
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					Vector3 position = { float(block) + 0.5f , float(corner) , -float(block) };
+					positions.push_back(position);
+					text += engine::format("v {} {} {}\n", position.x, position.y, position.z);
+				}
+
+				text += "f -3 -2 -1\n";
+				triangles.push_back(block * 3);
+
+				if (block >= kLookBack)
+				{
+					text += engine::format("f -{} -{} -{}\n", (kLookBack + 1) * 3, (kLookBack + 1) * 3 - 1, (kLookBack + 1) * 3 - 2);
+					triangles.push_back((block - kLookBack) * 3);
+				}
+			}
+
+			// 3つの塊に分かれる大きさにする
+			TEST_CHECK(context, text.size() > kObjMinChunkBytes * 3);
+
+			for (uint32_t maxThreads : { 1u , 2u , 3u })
+			{
+				ModelData modelData = ParseObjText(text, maxThreads);
+				if (TEST_CHECK(context, modelData.vertices.size() == triangles.size() * 3) == false)
+					return;
+
+				for (size_t triangle = 0; triangle < triangles.size(); ++triangle)
+				{
+					const uint32_t indices[3] = { triangles[triangle] , triangles[triangle] + 1 , triangles[triangle] + 2 };
+					if (IsObjTriangle(modelData, triangle, positions, indices) == false)
+					{
+						context.Fail(engine::format("{} threads : triangle {} does not use vertices {}..{}", maxThreads, triangle, indices[0], indices[2]),
+							__FILE__, __LINE__);
+						return;
+					}
+				}
+			}
+		});
+
+	// oとusemtlの切り替えごとにサブメッシュを分け、Mtlファイルの表の位置をマテリアルの番号にする（メッシュファイルに書き出しても変わらない）
+	runner.Add("ObjParser", "SubMeshesAndMaterials", [](TestContext& context)
+		{
+			// Mtlファイルは、テストで書き出すディレクトリに置く
+			{
+				std::ofstream file(MakeTestFilePath("SubMesh.mtl"), std::ios::binary | std::ios::trunc);
+				file <<
+					"newmtl Red\n"
+					"map_Kd red.png\n"
+					"newmtl Blue\n"
+					"map_Kd textures/blue.png\n"
+					"newmtl Plain\n";
+			}
+
+			const std::string text =
+				"mtllib SubMesh.mtl\n"
+				"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+				"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+				"vn 0 0 1\n"
+				"o First\n"
+				"usemtl Red\n"
+				"f 1/1/1 2/2/1 3/3/1\n"
+				"f 1/1/1 3/3/1 4/4/1\n"
+				"usemtl Blue\n"
+				"f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+				"o Second\n"
+				"f 4/4/1 3/3/1 2/2/1\n"
+				"usemtl Plain\n"
+				"f 1 2 3\n";
+
+			ModelData modelData = ParseObj(text.data(), text.size(), kTestTemporaryDirectory, 1);
+
+			// 表はMtlファイルに書いた順で、テクスチャのパスはMtlファイルのディレクトリから
+			if (TEST_CHECK(context, modelData.materials.size() == 3) == false)
+				return;
+
+			TEST_CHECK(context, modelData.materials[0].name == "Red" && modelData.materials[0].textureFilePath == kTestTemporaryDirectory + "/red.png");
+			TEST_CHECK(context, modelData.materials[1].name == "Blue" && modelData.materials[1].textureFilePath == kTestTemporaryDirectory + "/textures/blue.png");
+			TEST_CHECK(context, modelData.materials[2].name == "Plain" && modelData.materials[2].textureFilePath.empty());
+
+			// oで切り替えても、マテリアルは続けて使う
+			const std::vector<SubMesh> expectedSubMeshes = { { 0 , 6 , 0 } , { 6 , 6 , 1 } , { 12 , 3 , 1 } , { 15 , 3 , 2 } };
+			TEST_CHECK(context, modelData.vertices.size() == 18);
+			TEST_CHECK(context, IsSameSubMeshes(modelData.subMeshes, expectedSubMeshes));
+
+			// メッシュファイルに書き出して読んでも、サブメッシュとマテリアルの表は変わらない
+			const std::string meshPath = MakeTestFilePath("SubMesh.mesh");
+			if (TEST_CHECK(context, CookMeshFile(modelData, meshPath)) == false)
+				return;
+
+			MappedFile file;
+			MeshFileView view{};
+			if (TEST_CHECK(context, file.Open(meshPath) && LoadMeshFile(file, view)) == false)
+				return;
+
+			TEST_CHECK(context, IsSameSubMeshes(view.subMeshes, expectedSubMeshes));
+			TEST_CHECK(context, view.materialFilePaths.size() == 3);
+			for (size_t i = 0; i < view.materialFilePaths.size() && i < modelData.materials.size(); ++i)
+			{
+				TEST_CHECK(context, view.materialFilePaths[i] == modelData.materials[i].textureFilePath);
+			}
+
+			// 同じ頂点はまとめるが、インデックスでたどると元の頂点に戻る
+			TEST_CHECK(context, view.vertices.size() < modelData.vertices.size());
+			if (TEST_CHECK(context, view.indices.size() == modelData.vertices.size()) == false)
+				return;
+
+			for (size_t i = 0; i < view.indices.size(); ++i)
+			{
+				if (TEST_CHECK(context, view.indices[i] < view.vertices.size() &&
+					std::memcmp(&view.vertices[view.indices[i]], &modelData.vertices[i], sizeof(VertexData)) == 0) == false)
+					return;
+			}
+		});
+}
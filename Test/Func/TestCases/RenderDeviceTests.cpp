@@ -0,0 +1,290 @@
+#include "TestCases.h"
+
+// モデルのサブメッシュごとのインデックスの数
+static const uint32_t kNumSubMeshIndices = 300;
+
+// 画面の大きさに合わせた描画の設定（ルートシグネチャとPSOは、0でなければ何でもよい）
+static DrawPass MakeDrawPass()
+{
+	DrawPass pass{};
+	pass.viewport = { 0.0f , 0.0f , 1280.0f , 720.0f , 0.0f , 1.0f };
+	pass.scissorRect = { 0 , 0 , 1280 , 720 };
+	pass.rootSignature = 0x1000;
+	pass.pipelineState = 0x2000;
+	return pass;
+}
+
+// 読み込んだモデルの代わりに、解放しないバッファで作ったモデル
+typedef struct NullModel
+{
+	RenderVertexBufferView vertexBuffer;
+	RenderIndexBufferView indexBuffer;
+	std::vector<SubMesh> subMeshes;
+	std::vector<RenderHandle> textureDescriptors;
+}NullModel;
+
+// サブメッシュをnumSubMeshes個持つモデルを作る
+static NullModel MakeNullModel(NullRenderDevice& device, uint32_t numSubMeshes)
+{
+	RenderBuffer vertexBuffer = device.CreateStaticBuffer(sizeof(VertexData) * kNumSubMeshIndices);
+	RenderBuffer indexBuffer = device.CreateStaticBuffer(sizeof(uint32_t) * kNumSubMeshIndices * numSubMeshes);
+
+	NullModel model{};
+	model.vertexBuffer = { vertexBuffer.gpuAddress , vertexBuffer.sizeInBytes , sizeof(VertexData) };
+	model.indexBuffer = { indexBuffer.gpuAddress , indexBuffer.sizeInBytes };
+	for (uint32_t i = 0; i < numSubMeshes; ++i)
+	{
+		model.subMeshes.push_back({ i * kNumSubMeshIndices , kNumSubMeshIndices , i });
+		model.textureDescriptors.push_back(0x3000 + i * 32);
+	}
+
+	return model;
+}
+
+// モデルを描画するコマンドを積む
+static void RecordNullModel(NullRenderDevice& device, const DrawPass& pass, const NullModel& model)
+{
+	Transform3D transform = { { 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , 5.0f } };
+	DirectionalLight light = { { 1.0f , 1.0f , 1.0f , 1.0f } , { 0.0f , -1.0f , 0.0f } , 1.0f };
+	RecordModel(device, pass, model.vertexBuffer, model.indexBuffer, model.subMeshes, model.textureDescriptors, transform, Make4x4IdenityMatrix(), light);
+}
+
+// textを含む誤りが記録されているかどうか
+static bool HasRenderError(const NullRenderDevice& device, const std::string& text)
+{
+	return std::any_of(device.GetErrors().begin(), device.GetErrors().end(),
+		[&text](const std::string& error) { return error.find(text) != std::string::npos; });
+}
+
+// 描画のコマンドを積む処理（Func/DrawRecord）と、その検証（Class/RenderDevice/NullRenderDevice）のテストを登録する
+void RegisterRenderDeviceTests(TestRunner& runner)
+{
+	// モデルはサブメッシュごとに描画し、2回目は同じ状態を設定し直したものとして数える
+	runner.Add("RenderDevice", "RecordModelCounts", [](TestContext& context)
+		{
+			NullRenderDevice device;
+			DrawPass pass = MakeDrawPass();
+			NullModel model = MakeNullModel(device, 3);
+
+			device.SetRecording(true);
+			RecordNullModel(device, pass, model);
+
+			const RenderDeviceStats& stats = device.GetStats();
+			TEST_CHECK(context, stats.numErrors == 0);
+			TEST_CHECK(context, stats.numDraws == 3);
+			TEST_CHECK(context, stats.numVertices == 3 * kNumSubMeshIndices);
+
+			// ビューポート、シザーレクト、ルートシグネチャ、PSO、頂点バッファ、インデックスバッファ、形状
+			TEST_CHECK(context, stats.numStateChanges == 7);
+			TEST_CHECK(context, stats.numRedundantStateChanges == 0);
+
+			// 定数バッファが3つと、サブメッシュごとのテクスチャ
+			TEST_CHECK(context, stats.numRootArguments == 3 + 3);
+			TEST_CHECK(context, stats.numUploadBuffers == 3);
+
+			// サブメッシュごとに、テクスチャを設定してから描画する
+			const std::vector<RenderCommand>& commands = device.GetCommands();
+			if (TEST_CHECK(context, commands.size() >= 6) == false)
+				return;
+
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const RenderCommand& table = commands[commands.size() - 6 + i * 2];
+				const RenderCommand& draw = commands[commands.size() - 5 + i * 2];
+				TEST_CHECK(context, table.type == RenderCommandType::SetDescriptorTable && table.arguments[0] == 2 &&
+					table.arguments[1] == model.textureDescriptors[i]);
+				TEST_CHECK(context, draw.type == RenderCommandType::DrawIndexed && draw.arguments[0] == kNumSubMeshIndices &&
+					draw.arguments[1] == i * kNumSubMeshIndices);
+			}
+
+			// 同じモデルをもう一度描画すると、7つの状態は全て設定し直し（定数バッファは描画ごとに作るので、数えない）
+			RecordNullModel(device, pass, model);
+			TEST_CHECK(context, stats.numErrors == 0);
+			TEST_CHECK(context, stats.numDraws == 6);
+			TEST_CHECK(context, stats.numStateChanges == 14);
+			TEST_CHECK(context, stats.numRedundantStateChanges == 7);
+
+			// 同じテクスチャを続けて設定したものも数える
+			device.ResetStats();
+			model.textureDescriptors = { 0x3000 , 0x3000 , 0x3040 };
+			RecordNullModel(device, pass, model);
+			TEST_CHECK(context, stats.numErrors == 0);
+			TEST_CHECK(context, stats.numRedundantStateChanges == 7 + 1);
+		});
+
+	// スプライトは描画ごとにバッファを作るので、2回目もバッファは設定し直しにならない
+	runner.Add("RenderDevice", "RecordSpriteCounts", [](TestContext& context)
+		{
+			NullRenderDevice device;
+			DrawPass pass = MakeDrawPass();
+
+			Vector2 corners[4] = { { 0.0f , 0.0f } , { 64.0f , 0.0f } , { 0.0f , 64.0f } , { 64.0f , 64.0f } };
+			SpriteRegion sprite = { 1 , { 0.0f , 0.0f } , { 0.25f , 0.25f } };
+			Transform3D transform = { { 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , 0.0f } };
+
+			RecordSprite(device, pass, corners, transform, Make4x4IdenityMatrix(), sprite, 0x3000);
+
+			const RenderDeviceStats& stats = device.GetStats();
+			TEST_CHECK(context, stats.numErrors == 0);
+			TEST_CHECK(context, stats.numDraws == 1);
+			TEST_CHECK(context, stats.numVertices == 6);
+			TEST_CHECK(context, stats.numStateChanges == 7);
+			TEST_CHECK(context, stats.numRedundantStateChanges == 0);
+			TEST_CHECK(context, stats.numRootArguments == 3);
+
+			// インデックス、頂点、マテリアル、座標変換
+			TEST_CHECK(context, stats.numUploadBuffers == 4);
+
+			// ビューポート、シザーレクト、ルートシグネチャ、PSO、形状と、同じテクスチャが設定し直し
+			RecordSprite(device, pass, corners, transform, Make4x4IdenityMatrix(), sprite, 0x3000);
+			TEST_CHECK(context, stats.numErrors == 0);
+			TEST_CHECK(context, stats.numStateChanges == 14);
+			TEST_CHECK(context, stats.numRedundantStateChanges == 5 + 1);
+		});
+
+	// 球は分割数に合わせたインデックスで描画し、平行光源の定数バッファも設定する
+	runner.Add("RenderDevice", "RecordSphereCounts", [](TestContext& context)
+		{
+			// 平行光源も設定されていなければならないものにする
+			NullRenderDevice device(4, 0b1111);
+			DrawPass pass = MakeDrawPass();
+
+			Transform3D transform = { { 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , 5.0f } };
+			DirectionalLight light = { { 1.0f , 1.0f , 1.0f , 1.0f } , { 0.0f , -1.0f , 0.0f } , 1.0f };
+
+			for (uint32_t subdivisions : { 1u , 16u })
+			{
+				device.ResetStats();
+				RecordSphere(device, pass, subdivisions, transform, Make4x4IdenityMatrix(), light, 0x3000);
+				device.FinishFrame();
+
+				const RenderDeviceStats& stats = device.GetStats();
+				TEST_CHECK(context, stats.numErrors == 0);
+				TEST_CHECK(context, stats.numDraws == 1);
+				TEST_CHECK(context, stats.numVertices == subdivisions * subdivisions * 6);
+				TEST_CHECK(context, stats.numStateChanges == 7);
+				TEST_CHECK(context, stats.numRedundantStateChanges == 0);
+				TEST_CHECK(context, stats.numRootArguments == 4);
+
+				// インデックス、頂点、マテリアル、座標変換、平行光源
+				TEST_CHECK(context, stats.numUploadBuffers == 5);
+			}
+		});
+
+	// 1フレームに混ぜて積んでも誤りが無く、フレームを終えたら状態を忘れる
+	runner.Add("RenderDevice", "MixedFrameHasNoErrors", [](TestContext& context)
+		{
+			NullRenderDevice device;
+			DrawPass pass = MakeDrawPass();
+			NullModel model = MakeNullModel(device, 2);
+
+			Vector2 corners[4] = { { 0.0f , 0.0f } , { 64.0f , 0.0f } , { 0.0f , 64.0f } , { 64.0f , 64.0f } };
+			SpriteRegion sprite = { 1 , { 0.0f , 0.0f } , { 1.0f , 1.0f } };
+			Transform3D transform = { { 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , 5.0f } };
+			DirectionalLight light = { { 1.0f , 1.0f , 1.0f , 1.0f } , { 0.0f , -1.0f , 0.0f } , 1.0f };
+
+			for (uint32_t frame = 0; frame < 3; ++frame)
+			{
+				RecordNullModel(device, pass, model);
+				RecordSphere(device, pass, 8, transform, Make4x4IdenityMatrix(), light, 0x3000);
+				RecordSprite(device, pass, corners, transform, Make4x4IdenityMatrix(), sprite, 0x3020);
+				RecordNullModel(device, pass, model);
+
+				// 作ったバッファは全て、定数バッファに使えるように揃っている
+				TEST_CHECK(context, device.FinishFrame() % 256 == 0);
+			}
+
+			TEST_CHECK(context, device.GetStats().numErrors == 0);
+			TEST_CHECK(context, device.GetErrors().empty());
+			TEST_CHECK(context, device.GetStats().numDraws == 3 * (2 + 1 + 1 + 2));
+
+			// フレームを終えた後は、描画の設定からやり直す必要がある
+			device.DrawIndexed(3, 0, 0);
+			TEST_CHECK(context, HasRenderError(device, "viewport or scissor rect is not set"));
+			TEST_CHECK(context, HasRenderError(device, "vertex buffer is not set"));
+		});
+
+	// 描画までにルートの引数が設定されていなければ、足りないもののビットを報告する
+	runner.Add("RenderDevice", "ReportsMissingRootParameter", [](TestContext& context)
+		{
+			// スプライトは平行光源を設定しないので、必要にすると足りない
+			NullRenderDevice device(4, 0b1111);
+			DrawPass pass = MakeDrawPass();
+
+			Vector2 corners[4] = { { 0.0f , 0.0f } , { 64.0f , 0.0f } , { 0.0f , 64.0f } , { 64.0f , 64.0f } };
+			SpriteRegion sprite = { 1 , { 0.0f , 0.0f } , { 1.0f , 1.0f } };
+			Transform3D transform = { { 1.0f , 1.0f , 1.0f } , { 0.0f , 0.0f , 0.0f } , { 0.0f , 0.0f , 0.0f } };
+			RecordSprite(device, pass, corners, transform, Make4x4IdenityMatrix(), sprite, 0x3000);
+
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, "DrawIndexed : root parameters 0b1000 are not set"));
+
+			// ルートシグネチャを替えると、設定した引数は無効になる
+			device.ResetStats();
+			NullModel model = MakeNullModel(device, 1);
+			RecordNullModel(device, pass, model);
+			TEST_CHECK(context, device.GetStats().numErrors == 0);
+
+			device.SetRootSignature(0x1100);
+			device.SetConstantBuffer(0, device.CreateUploadBuffer(sizeof(Material)).gpuAddress);
+			device.DrawIndexed(kNumSubMeshIndices, 0, 0);
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, "DrawIndexed : root parameters 0b1110 are not set"));
+
+			// 範囲外のルートの引数も報告する
+			device.SetDescriptorTable(4, 0x3000);
+			TEST_CHECK(context, HasRenderError(device, "SetDescriptorTable : root parameter 4 is out of range (4)"));
+		});
+
+	// 定数バッファのアドレスは、作ったバッファのもので256バイトに揃っていなければならない
+	runner.Add("RenderDevice", "ReportsMisalignedConstantBuffer", [](TestContext& context)
+		{
+			NullRenderDevice device;
+			RenderBuffer buffer = device.CreateUploadBuffer(sizeof(Material) * 2);
+
+			device.SetConstantBuffer(0, buffer.gpuAddress);
+			TEST_CHECK(context, device.GetStats().numErrors == 0);
+
+			device.SetConstantBuffer(0, buffer.gpuAddress + sizeof(Material));
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, engine::format("SetConstantBuffer : root parameter 0 has invalid address {:#x}", buffer.gpuAddress + sizeof(Material))));
+
+			// 作っていないバッファのアドレス
+			device.SetConstantBuffer(1, 0x100);
+			TEST_CHECK(context, device.GetStats().numErrors == 2);
+
+			// フレームを終えたら、描画ごとのバッファのアドレスは使えない
+			device.FinishFrame();
+			device.SetConstantBuffer(0, buffer.gpuAddress);
+			TEST_CHECK(context, device.GetStats().numErrors == 3);
+		});
+
+	// インデックスバッファの範囲を超えて描画したら報告する
+	runner.Add("RenderDevice", "ReportsIndexBufferOutOfRange", [](TestContext& context)
+		{
+			NullRenderDevice device;
+			DrawPass pass = MakeDrawPass();
+			NullModel model = MakeNullModel(device, 2);
+
+			// 最後のサブメッシュが、1つだけはみ出す
+			model.subMeshes.back().indexCount += 1;
+			RecordNullModel(device, pass, model);
+
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, engine::format("DrawIndexed : indices {}..{} exceed the index buffer ({})",
+				kNumSubMeshIndices, kNumSubMeshIndices * 2 + 1, kNumSubMeshIndices * 2)));
+
+			// インデックスバッファの大きさは、4バイトの倍数でなければならない
+			device.ResetStats();
+			device.SetIndexBuffer({ model.indexBuffer.gpuAddress , model.indexBuffer.sizeInBytes - 2 });
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, "is not a multiple of 4"));
+
+			// 頂点バッファの範囲を超える描画も報告する
+			device.ResetStats();
+			device.SetIndexBuffer(model.indexBuffer);
+			device.Draw(kNumSubMeshIndices + 1, 0);
+			TEST_CHECK(context, device.GetStats().numErrors == 1);
+			TEST_CHECK(context, HasRenderError(device, "exceed the vertex buffer"));
+		});
+}
@@ -0,0 +1,277 @@
+#include "TestCases.h"
+
+// パスの前に張るバリアに、指定した遷移があるかどうか
+static bool HasTransition(const std::vector<RenderBarrier>& barriers, uint32_t resourceIndex, RenderState before, RenderState after)
+{
+	for (const RenderBarrier& barrier : barriers)
+	{
+		if (barrier.type == RenderBarrierType::Transition && barrier.resourceIndex == resourceIndex &&
+			barrier.before == before && barrier.after == after)
+			return true;
+	}
+
+	return false;
+}
+
+// 指定した種類のバリアの数
+static uint32_t CountBarriers(const std::vector<RenderBarrier>& barriers, RenderBarrierType type)
+{
+	uint32_t count = 0;
+	for (const RenderBarrier& barrier : barriers)
+	{
+		if (barrier.type == type)
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+// レンダーグラフ（Class/RenderGraph）のテストを登録する
+void RegisterRenderGraphTests(TestRunner& runner)
+{
+	// 外部のリソースに届かないパスだけを省く（省かれたパスだけが読むものを書くパスも省く）
+	runner.Add("RenderGraph", "CullsPassesThatReachNoImport", [](TestContext& context)
+		{
+			RenderGraph graph;
+			uint32_t backBuffer = graph.ImportResource("BackBuffer", 0x1000, RenderState::Present, RenderState::Present);
+			uint32_t scene = graph.CreateTransientResource("Scene");
+			uint32_t debugSource = graph.CreateTransientResource("DebugSource");
+			uint32_t debugView = graph.CreateTransientResource("DebugView");
+
+			uint32_t scenePass = graph.AddPass("Scene", nullptr);
+			graph.Write(scenePass, scene, RenderState::RenderTarget);
+
+			uint32_t debugSourcePass = graph.AddPass("DebugSource", nullptr);
+			graph.Write(debugSourcePass, debugSource, RenderState::RenderTarget);
+
+			uint32_t debugPass = graph.AddPass("Debug", nullptr);
+			graph.Read(debugPass, debugSource, RenderState::PixelShaderResource);
+			graph.Write(debugPass, debugView, RenderState::RenderTarget);
+
+			uint32_t capturePass = graph.AddPass("Capture", nullptr);
+			graph.Read(capturePass, scene, RenderState::CopySource);
+			graph.SetSideEffect(capturePass);
+
+			uint32_t compositePass = graph.AddPass("Composite", nullptr);
+			graph.Read(compositePass, scene, RenderState::PixelShaderResource);
+			graph.Write(compositePass, backBuffer, RenderState::RenderTarget);
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+			TEST_CHECK(context, graph.IsPassCulled(scenePass) == false);
+			TEST_CHECK(context, graph.IsPassCulled(debugSourcePass));
+			TEST_CHECK(context, graph.IsPassCulled(debugPass));
+			TEST_CHECK(context, graph.IsPassCulled(capturePass) == false);
+			TEST_CHECK(context, graph.IsPassCulled(compositePass) == false);
+			TEST_CHECK(context, graph.GetNumCulledPasses() == 2);
+		});
+
+	// 次に書き込むまでに読む状態を組み合わせて、最初に読むパスで1回だけ遷移させる
+	runner.Add("RenderGraph", "MergesFollowingReadsIntoOneTransition", [](TestContext& context)
+		{
+			RenderGraph graph;
+			uint32_t output = graph.ImportResource("Output", 0x1000, RenderState::Common, RenderState::Common);
+			uint32_t depth = graph.CreateTransientResource("Depth");
+
+			uint32_t depthPass = graph.AddPass("Depth", nullptr);
+			graph.Write(depthPass, depth, RenderState::DepthWrite);
+
+			uint32_t lightingPass = graph.AddPass("Lighting", nullptr);
+			graph.Read(lightingPass, depth, RenderState::PixelShaderResource);
+			graph.Write(lightingPass, output, RenderState::RenderTarget);
+
+			uint32_t postPass = graph.AddPass("Post", nullptr);
+			graph.Read(postPass, depth, RenderState::NonPixelShaderResource);
+			graph.Write(postPass, output, RenderState::UnorderedAccess);
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+			TEST_CHECK(context, graph.GetInitialState(depth) == RenderState::DepthWrite);
+			TEST_CHECK(context, HasTransition(graph.GetPassBarriers(lightingPass), depth, RenderState::DepthWrite,
+				RenderState::PixelShaderResource | RenderState::NonPixelShaderResource));
+
+			// 後から読むパスでは、深度を遷移させない
+			for (const RenderBarrier& barrier : graph.GetPassBarriers(postPass))
+			{
+				TEST_CHECK(context, barrier.resourceIndex != depth);
+			}
+
+			// 実行し終えたら、外部のリソースは最後の状態に、中だけで使うものは最初の状態に戻す
+			TEST_CHECK(context, HasTransition(graph.GetFinalBarriers(), output, RenderState::UnorderedAccess, RenderState::Common));
+			TEST_CHECK(context, HasTransition(graph.GetFinalBarriers(), depth,
+				RenderState::PixelShaderResource | RenderState::NonPixelShaderResource, RenderState::DepthWrite));
+		});
+
+	// UAVに続けて書き込むときは、UAVバリアを張る
+	runner.Add("RenderGraph", "UnorderedAccessBarrierBetweenWrites", [](TestContext& context)
+		{
+			RenderGraph graph;
+			uint32_t buffer = graph.ImportResource("Buffer", 0x1000, RenderState::UnorderedAccess, RenderState::UnorderedAccess);
+
+			uint32_t firstPass = graph.AddPass("First", nullptr);
+			graph.Write(firstPass, buffer, RenderState::UnorderedAccess);
+
+			uint32_t secondPass = graph.AddPass("Second", nullptr);
+			graph.Write(secondPass, buffer, RenderState::UnorderedAccess);
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+			TEST_CHECK(context, graph.GetPassBarriers(firstPass).empty());
+			TEST_CHECK(context, CountBarriers(graph.GetPassBarriers(secondPass), RenderBarrierType::UnorderedAccess) == 1);
+			TEST_CHECK(context, graph.GetFinalBarriers().empty());
+		});
+
+	// 読み込みだけの状態で書き込む宣言や、同じパスで違う状態で読み書きする宣言は、コンパイルできない
+	runner.Add("RenderGraph", "RejectsConflictingDeclarations", [](TestContext& context)
+		{
+			std::ostringstream log;
+
+			RenderGraph graph;
+			uint32_t target = graph.ImportResource("Target", 0x1000, RenderState::Common, RenderState::Common);
+			uint32_t pass = graph.AddPass("WriteReadOnly", nullptr);
+			graph.Write(pass, target, RenderState::PixelShaderResource);
+			TEST_CHECK(context, graph.Compile(log) == false);
+
+			graph.Reset();
+			target = graph.ImportResource("Target", 0x1000, RenderState::Common, RenderState::Common);
+			pass = graph.AddPass("ReadWrite", nullptr);
+			graph.Read(pass, target, RenderState::PixelShaderResource);
+			graph.Write(pass, target, RenderState::RenderTarget);
+			TEST_CHECK(context, graph.Compile(log) == false);
+		});
+
+	// パスごとにバリアを1回でまとめて発行し、続きから実行し直せる
+	runner.Add("RenderGraph", "ExecuteFlushesOncePerPassInOrder", [](TestContext& context)
+		{
+			RenderGraph graph;
+			std::vector<std::string> events;
+
+			uint32_t backBuffer = graph.ImportResource("BackBuffer", 0x1000, RenderState::Present, RenderState::Present);
+			uint32_t albedo = graph.CreateTransientResource("Albedo");
+			uint32_t normal = graph.CreateTransientResource("Normal");
+			graph.SetResource(albedo, 0x2000);
+			graph.SetResource(normal, 0x3000);
+
+			uint32_t gbufferPass = graph.AddPass("GBuffer", [&events]() { events.push_back("GBuffer"); });
+			graph.Write(gbufferPass, albedo, RenderState::RenderTarget);
+			graph.Write(gbufferPass, normal, RenderState::RenderTarget);
+
+			uint32_t lightingPass = graph.AddPass("Lighting", [&events]() { events.push_back("Lighting"); });
+			graph.Read(lightingPass, albedo, RenderState::PixelShaderResource);
+			graph.Read(lightingPass, normal, RenderState::PixelShaderResource);
+			graph.Write(lightingPass, backBuffer, RenderState::RenderTarget);
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+
+			auto flush = [&events](const std::vector<RenderBarrier>& barriers)
+				{
+					events.push_back(engine::format("Barriers{}", barriers.size()));
+				};
+
+			// GBufferまで実行してから、残りを実行する
+			graph.Execute(flush, gbufferPass);
+			TEST_CHECK(context, events == std::vector<std::string>({ "GBuffer" }));
+
+			graph.Execute(flush);
+			std::vector<std::string> expected = { "GBuffer", "Barriers3", "Lighting", "Barriers3" };
+			TEST_CHECK(context, events == expected);
+
+			// 全て実行した後は、何もしない
+			graph.Execute(flush);
+			TEST_CHECK(context, events == expected);
+		});
+
+	// 使うパスが重ならないものを重ねて置き、切り替えるところでエイリアシングバリアを張る
+	runner.Add("RenderGraph", "AliasesTransientResources", [](TestContext& context)
+		{
+			const uint64_t kSize = 4 * kDefaultAliasingAlignment;
+
+			RenderGraph graph;
+			uint32_t backBuffer = graph.ImportResource("BackBuffer", 0x1000, RenderState::Present, RenderState::Present);
+			uint32_t first = graph.CreateTransientResource("First", kSize);
+			uint32_t second = graph.CreateTransientResource("Second", kSize);
+			uint32_t third = graph.CreateTransientResource("Third", kSize);
+
+			uint32_t firstPass = graph.AddPass("First", nullptr);
+			graph.Write(firstPass, first, RenderState::RenderTarget);
+
+			uint32_t secondPass = graph.AddPass("Second", nullptr);
+			graph.Read(secondPass, first, RenderState::PixelShaderResource);
+			graph.Write(secondPass, second, RenderState::RenderTarget);
+
+			uint32_t thirdPass = graph.AddPass("Third", nullptr);
+			graph.Read(thirdPass, second, RenderState::PixelShaderResource);
+			graph.Write(thirdPass, third, RenderState::RenderTarget);
+
+			uint32_t presentPass = graph.AddPass("Present", nullptr);
+			graph.Read(presentPass, third, RenderState::PixelShaderResource);
+			graph.Write(presentPass, backBuffer, RenderState::RenderTarget);
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+
+			// 1つ目と3つ目は使うパスが重ならないので、同じ位置に置ける
+			const AliasingPlan& plan = graph.GetTransientPlan();
+			TEST_CHECK(context, plan.unaliasedSize == kSize * 3);
+			TEST_CHECK(context, plan.heapSize == kSize * 2);
+			TEST_CHECK(context, graph.GetHeapOffset(first) == graph.GetHeapOffset(third));
+			TEST_CHECK(context, graph.GetHeapOffset(first) != graph.GetHeapOffset(second));
+			TEST_CHECK(context, CountBarriers(graph.GetPassBarriers(thirdPass), RenderBarrierType::Aliasing) == 1);
+		});
+
+	// 影、Gバッファ、ポストエフェクトを並べたフレームで、デバッグのパスだけが省かれ、重ねたヒープが小さくなる
+	runner.Add("RenderGraph", "SyntheticFrame", [](TestContext& context)
+		{
+			const uint32_t kNumShadowPasses = 4;
+			const uint32_t kNumPostPasses = 48;
+			const uint32_t kNumDebugPasses = 9;
+			const uint64_t kShadowMapSize = 2048ull * 2048 * 4;
+			const uint64_t kHdrTargetSize = 1280ull * 720 * 8;
+
+			RenderGraph graph;
+			uint32_t backBuffer = graph.ImportResource("BackBuffer", 0x1000, RenderState::Present, RenderState::Present);
+
+			std::vector<uint32_t> shadowMaps;
+			for (uint32_t i = 0; i < kNumShadowPasses; ++i)
+			{
+				shadowMaps.push_back(graph.CreateTransientResource(engine::format("ShadowMap{}", i), kShadowMapSize));
+				uint32_t pass = graph.AddPass(engine::format("Shadow{}", i), nullptr);
+				graph.Write(pass, shadowMaps.back(), RenderState::DepthWrite);
+			}
+
+			uint32_t hdr = graph.CreateTransientResource("HDR", kHdrTargetSize);
+			uint32_t lightingPass = graph.AddPass("Lighting", nullptr);
+			for (uint32_t shadowMap : shadowMaps)
+			{
+				graph.Read(lightingPass, shadowMap, RenderState::PixelShaderResource);
+			}
+			graph.Write(lightingPass, hdr, RenderState::RenderTarget);
+
+			uint32_t source = hdr;
+			for (uint32_t i = 0; i < kNumPostPasses; ++i)
+			{
+				uint32_t destination = graph.CreateTransientResource(engine::format("Post{}", i), kHdrTargetSize);
+				uint32_t pass = graph.AddPass(engine::format("Post{}", i), nullptr);
+				graph.Read(pass, source, RenderState::NonPixelShaderResource);
+				graph.Write(pass, destination, RenderState::UnorderedAccess);
+				source = destination;
+			}
+
+			uint32_t tonemapPass = graph.AddPass("Tonemap", nullptr);
+			graph.Read(tonemapPass, source, RenderState::PixelShaderResource);
+			graph.Write(tonemapPass, backBuffer, RenderState::RenderTarget);
+
+			for (uint32_t i = 0; i < kNumDebugPasses; ++i)
+			{
+				uint32_t debugView = graph.CreateTransientResource(engine::format("DebugView{}", i), kHdrTargetSize);
+				uint32_t pass = graph.AddPass(engine::format("Debug{}", i), nullptr);
+				graph.Read(pass, hdr, RenderState::PixelShaderResource);
+				graph.Write(pass, debugView, RenderState::RenderTarget);
+			}
+
+			TEST_CHECK(context, graph.Compile(std::cout));
+			TEST_CHECK(context, graph.GetNumCulledPasses() == kNumDebugPasses);
+
+			const AliasingPlan& plan = graph.GetTransientPlan();
+			TEST_CHECK(context, plan.heapSize < plan.unaliasedSize);
+			TEST_CHECK(context, plan.heapSize >= plan.peakLiveSize);
+		});
+}
@@ -0,0 +1,251 @@
+#include "TestCases.h"
+
+// テキストファイルを書き出す
+static void WriteShaderFile(const std::string& filePath, const std::string& text)
+{
+	std::ofstream file(filePath, std::ios::binary);
+	file.write(text.data(), text.size());
+}
+
+// ライティング、影、スキニングの3つのグループ（影は4通りで、選択肢が2のべき乗でない場合も含む）
+static const std::vector<std::vector<std::string>> kKeywordGroups =
+{
+	{ "" , "LIGHTING_LAMBERT" , "LIGHTING_HALF_LAMBERT" },
+	{ "" , "SHADOW_HARD" , "SHADOW_PCF" , "SHADOW_PCSS" },
+	{},
+	{ "SKINNING" },
+	{ "" , "INSTANCING" }
+};
+
+// キャッシュのキーを確かめるシェーダー（インクルード先が、さらにインクルードする）
+static const std::string kShaderSource = "#include \"Common.hlsli\"\nfloat4 main() : SV_TARGET { return Shade(); }\n";
+static const std::string kCommonSource = "#include \"Light.hlsli\"\n";
+static const std::string kLightSource = "float4 Shade() { return 1.0f; }\n";
+
+// シェーダーのファイルを置いたディレクトリを作り、シェーダーのファイルパスを返す
+static std::string MakeShaderDirectory(const std::string& name)
+{
+	std::string directoryPath = MakeTestFilePath(name);
+	std::filesystem::remove_all(directoryPath);
+	std::filesystem::create_directories(directoryPath);
+
+	WriteShaderFile(directoryPath + "/Object3d.PS.hlsl", kShaderSource);
+	WriteShaderFile(directoryPath + "/Common.hlsli", kCommonSource);
+	WriteShaderFile(directoryPath + "/Light.hlsli", kLightSource);
+	return directoryPath + "/Object3d.PS.hlsl";
+}
+
+// シェーダーのバリアント（Func/ShaderPermutation）と、コンパイル済みのシェーダーのキャッシュ（Func/ShaderCache）のテストを登録する
+void RegisterShaderTests(TestRunner& runner)
+{
+	// 選択肢を格納するビット数
+	runner.Add("ShaderPermutation", "KeywordBits", [](TestContext& context)
+		{
+			TEST_CHECK(context, GetShaderKeywordBits(0) == 0);
+			TEST_CHECK(context, GetShaderKeywordBits(1) == 0);
+			TEST_CHECK(context, GetShaderKeywordBits(2) == 1);
+			TEST_CHECK(context, GetShaderKeywordBits(3) == 2);
+			TEST_CHECK(context, GetShaderKeywordBits(4) == 2);
+			TEST_CHECK(context, GetShaderKeywordBits(5) == 3);
+			TEST_CHECK(context, GetShaderKeywordBits(256) == 8);
+		});
+
+	// 全ての組み合わせを、重ならずに小さい順に列挙する
+	runner.Add("ShaderPermutation", "EnumerateVariants", [](TestContext& context)
+		{
+			TEST_CHECK(context, EnumerateShaderVariants({}) == std::vector<uint32_t>({ 0 }));
+			TEST_CHECK(context, EnumerateShaderVariants({ { "" , "A" } }) == std::vector<uint32_t>({ 0 , 1 }));
+
+			std::vector<uint32_t> variantKeys = EnumerateShaderVariants(kKeywordGroups);
+			if (TEST_CHECK(context, variantKeys.size() == 3 * 4 * 1 * 2) == false)
+				return;
+
+			TEST_CHECK(context, std::is_sorted(variantKeys.begin(), variantKeys.end()));
+			TEST_CHECK(context, std::adjacent_find(variantKeys.begin(), variantKeys.end()) == variantKeys.end());
+
+			// ライティング2ビット、影2ビット、スキニング0ビット、インスタンシング1ビットの5ビットに収まる
+			TEST_CHECK(context, variantKeys.back() < (1u << 5));
+
+			// 選択肢の無い番号（ライティングの3番）は使わない
+			TEST_CHECK(context, std::none_of(variantKeys.begin(), variantKeys.end(), [](uint32_t key) { return (key & 3u) == 3u; }));
+		});
+
+	// バリアントのキーとマクロを行き来しても、同じキーに戻る
+	runner.Add("ShaderPermutation", "KeyDefinesRoundTrip", [](TestContext& context)
+		{
+			for (uint32_t variantKey : EnumerateShaderVariants(kKeywordGroups))
+			{
+				std::vector<std::string> defines = GetShaderVariantDefines(kKeywordGroups, variantKey);
+
+				// グループごとに1つ（""を選んだグループは無し、選択肢が1つのグループは必ず）
+				TEST_CHECK(context, std::count(defines.begin(), defines.end(), "SKINNING") == 1);
+				TEST_CHECK(context, defines.size() <= 4);
+
+				if (TEST_CHECK(context, MakeShaderVariantKey(kKeywordGroups, defines) == variantKey) == false)
+				{
+					context.Fail("variant " + std::to_string(variantKey), __FILE__, __LINE__);
+					return;
+				}
+
+				// 並びが違っても、同じキーになる
+				std::reverse(defines.begin(), defines.end());
+				TEST_CHECK(context, MakeShaderVariantKey(kKeywordGroups, defines) == variantKey);
+			}
+		});
+
+	// キーワードからキーを求め、キーから定義するマクロを求める
+	runner.Add("ShaderPermutation", "KeyAndDefines", [](TestContext& context)
+		{
+			// ハーフランバート（1番 -> 2）、PCF（2番 -> 2 << 2）、インスタンシング（1番 -> 1 << 4）
+			uint32_t variantKey = MakeShaderVariantKey(kKeywordGroups, { "INSTANCING" , "LIGHTING_HALF_LAMBERT" , "SHADOW_PCF" });
+			TEST_CHECK(context, variantKey == (2u | (2u << 2) | (1u << 4)));
+			TEST_CHECK(context, GetShaderVariantDefines(kKeywordGroups, variantKey) ==
+				std::vector<std::string>({ "LIGHTING_HALF_LAMBERT" , "SHADOW_PCF" , "SKINNING" , "INSTANCING" }));
+
+			// グループに含まれないキーワードと、""は無視する
+			TEST_CHECK(context, MakeShaderVariantKey(kKeywordGroups, { "UNKNOWN" , "" }) == 0);
+			TEST_CHECK(context, GetShaderVariantDefines(kKeywordGroups, 0) == std::vector<std::string>({ "SKINNING" }));
+
+			// 同じグループから2つ指定したら、先にあるものを選ぶ
+			TEST_CHECK(context, MakeShaderVariantKey(kKeywordGroups, { "SHADOW_PCSS" , "SHADOW_HARD" }) == (1u << 2));
+
+			// 選択肢の外の番号は、何も定義しない
+			TEST_CHECK(context, GetShaderVariantDefines(kKeywordGroups, 3u) == std::vector<std::string>({ "SKINNING" }));
+		});
+
+	// 全ての処理を1回ずつ、決めた数以下のスレッドで行う
+	runner.Add("ShaderPermutation", "RunParallelJobs", [](TestContext& context)
+		{
+			const uint32_t jobCounts[] = { 0 , 1 , 7 , 1000 };
+			const uint32_t threadCounts[] = { 0 , 1 , 4 , 64 };
+
+			for (uint32_t numJobs : jobCounts)
+			{
+				for (uint32_t maxThreads : threadCounts)
+				{
+					std::vector<std::atomic<uint32_t>> numRuns(numJobs);
+					std::mutex workersMutex;
+					std::vector<uint32_t> workers;
+
+					RunParallelJobs(numJobs, maxThreads, [&](uint32_t job, uint32_t worker)
+						{
+							numRuns[job]++;
+
+							std::lock_guard<std::mutex> lock(workersMutex);
+							workers.push_back(worker);
+						});
+
+					bool isEachOnce = std::all_of(numRuns.begin(), numRuns.end(), [](const std::atomic<uint32_t>& count) { return count == 1; });
+					bool isWithinThreads = std::all_of(workers.begin(), workers.end(),
+						[&](uint32_t worker) { return worker < (std::max)((std::min)(maxThreads, numJobs), 1u); });
+
+					if (TEST_CHECK(context, isEachOnce && isWithinThreads && workers.size() == numJobs) == false)
+					{
+						context.Fail("jobs " + std::to_string(numJobs) + " threads " + std::to_string(maxThreads), __FILE__, __LINE__);
+						return;
+					}
+				}
+			}
+		});
+
+	// インクルードを中までたどり、見つけた順に1回ずつ集める
+	runner.Add("ShaderCache", "CollectIncludes", [](TestContext& context)
+		{
+			const std::string filePath = MakeShaderDirectory("ShaderCacheIncludes");
+			const std::string directoryPath = std::filesystem::path(filePath).parent_path().generic_string();
+
+			// 同じものを2回インクルードしても、1回だけ含める
+			WriteShaderFile(filePath, "#include \"Common.hlsli\"\n#include \"Light.hlsli\"\n#include \"Missing.hlsli\"\n" + kShaderSource);
+
+			std::vector<std::string> includePaths;
+			CollectShaderIncludes(filePath, includePaths);
+
+			if (TEST_CHECK(context, includePaths.size() == 2) == false)
+				return;
+
+			TEST_CHECK(context, std::filesystem::path(includePaths[0]).filename() == "Common.hlsli");
+			TEST_CHECK(context, std::filesystem::path(includePaths[1]).filename() == "Light.hlsli");
+			TEST_CHECK(context, includePaths[0].find(directoryPath) != std::string::npos);
+		});
+
+	// ソース、インクルード先、プロファイル、引数のどれが変わっても、別のキーになる
+	runner.Add("ShaderCache", "KeyChangesWithInputs", [](TestContext& context)
+		{
+			const std::string filePath = MakeShaderDirectory("ShaderCacheKey");
+			const std::string directoryPath = std::filesystem::path(filePath).parent_path().generic_string();
+			const std::vector<std::string> arguments = { "-E" , "main" , "-DLIGHTING_LAMBERT" };
+
+			const std::string basePath = GetShaderCachePath(filePath, "ps_6_0", arguments);
+			if (TEST_CHECK(context, basePath.empty() == false) == false)
+				return;
+
+			// 同じものからは、同じキーになり、キャッシュのディレクトリに置く
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) == basePath);
+			TEST_CHECK(context, basePath.rfind(kShaderCacheDirectory + "/", 0) == 0);
+			TEST_CHECK(context, std::filesystem::path(basePath).extension() == ".cso");
+
+			// プロファイルと引数
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_6", arguments) != basePath);
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "-E" , "main" , "-DLIGHTING_HALF_LAMBERT" }) != basePath);
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "-E" , "main" }) != basePath);
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "-DLIGHTING_LAMBERT" , "-E" , "main" }) != basePath);
+
+			// 引数の区切りの位置だけが違うもの
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "-DA" , "B" }) != GetShaderCachePath(filePath, "ps_6_0", { "-DAB" }));
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "ab" , "c" }) != GetShaderCachePath(filePath, "ps_6_0", { "a" , "bc" }));
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", { "" }) != GetShaderCachePath(filePath, "ps_6_0", {}));
+
+			// ソース
+			WriteShaderFile(filePath, kShaderSource + "// edited\n");
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) != basePath);
+			WriteShaderFile(filePath, kShaderSource);
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) == basePath);
+
+			// インクルード先の、さらにインクルード先
+			WriteShaderFile(directoryPath + "/Light.hlsli", "float4 Shade() { return 0.5f; }\n");
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) != basePath);
+			WriteShaderFile(directoryPath + "/Light.hlsli", kLightSource);
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) == basePath);
+
+			// ソースの終わりとプロファイルの始めで、区切りの位置だけが違うもの
+			WriteShaderFile(filePath, kShaderSource + "//ps");
+			const std::string shortProfilePath = GetShaderCachePath(filePath, "_6_0", arguments);
+			WriteShaderFile(filePath, kShaderSource + "//");
+			TEST_CHECK(context, GetShaderCachePath(filePath, "ps_6_0", arguments) != shortProfilePath);
+
+			// 読めないソースは、キーを作らない
+			TEST_CHECK(context, GetShaderCachePath(directoryPath + "/Missing.hlsl", "ps_6_0", arguments).empty());
+		});
+
+	// 書き出したものを、そのまま読める
+	runner.Add("ShaderCache", "WriteReadRoundTrip", [](TestContext& context)
+		{
+			const std::string filePath = MakeShaderDirectory("ShaderCacheRoundTrip");
+			const std::string cachePath = GetShaderCachePath(filePath, "ps_6_0", { "-E" , "main" });
+			std::filesystem::remove(cachePath);
+
+			// 無いものは読めない
+			std::vector<uint8_t> bytes;
+			TEST_CHECK(context, ReadShaderCache(cachePath, bytes) == false);
+			TEST_CHECK(context, ReadShaderCache("", bytes) == false);
+
+			std::vector<uint8_t> binary(4099);
+			for (size_t i = 0; i < binary.size(); ++i)
+			{
+				binary[i] = static_cast<uint8_t>(i * 31 + 7);
+			}
+
+			if (TEST_CHECK(context, WriteShaderCache(cachePath, binary.data(), binary.size())) == false)
+				return;
+
+			TEST_CHECK(context, ReadShaderCache(cachePath, bytes) && bytes == binary);
+
+			// 書き直したら、新しいものを読む（途中の一時ファイルは残さない）
+			binary.resize(16);
+			TEST_CHECK(context, WriteShaderCache(cachePath, binary.data(), binary.size()));
+			TEST_CHECK(context, ReadShaderCache(cachePath, bytes) && bytes == binary);
+			TEST_CHECK(context, std::filesystem::exists(cachePath + ".tmp") == false);
+
+			std::filesystem::remove(cachePath);
+		});
+}
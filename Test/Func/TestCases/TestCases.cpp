@@ -0,0 +1,31 @@
+#include "TestCases.h"
+
+// テストで書き出すファイルのパスを求める
+std::string MakeTestFilePath(const std::string& filename)
+{
+	std::filesystem::create_directories(kTestTemporaryDirectory);
+	return kTestTemporaryDirectory + "/" + filename;
+}
+
+// 全てのテストを登録する
+void RegisterAllTests(TestRunner& runner)
+{
+	RegisterMatrixTests(runner);
+	RegisterObjParserTests(runner);
+	RegisterRenderGraphTests(runner);
+	RegisterAliasingTests(runner);
+	RegisterTlsfTests(runner);
+	RegisterWavStreamTests(runner);
+	RegisterVoicePoolTests(runner);
+	RegisterFileWatcherTests(runner);
+	RegisterAssetTests(runner);
+	RegisterShaderTests(runner);
+	RegisterTextureStreamerTests(runner);
+	RegisterLoggerTests(runner);
+	FrameProfilerTests::Register(runner);
+	RegisterRenderDeviceTests(runner);
+	RegisterAtlasPackerTests(runner);
+#ifdef _WIN32
+	RegisterMipmapTests(runner);
+#endif
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <fstream>
+#include <cmath>
+#include <cassert>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include "../../Class/TestRunner/TestRunner.h"
+#include "../../../Class/Engine/Func/Matrix/Matrix.h"
+#include "../../../Class/Engine/Func/ModelData/ModelData.h"
+#include "../../../Class/Engine/Func/ObjParser/ObjParser.h"
+#include "../../../Class/Engine/Func/MeshFile/MeshFile.h"
+#include "../../../Class/Engine/Class/RenderGraph/RenderGraph.h"
+#include "../../../Class/Engine/Func/AliasingPlan/AliasingPlan.h"
+#include "../../../Class/Engine/Class/TlsfAllocator/TlsfAllocator.h"
+#include "../../../Class/Engine/Class/WavStream/WavStream.h"
+#include "../../../Class/Engine/Class/VoicePool/VoicePool.h"
+#include "../../../Class/Engine/Class/FileWatcher/FileWatcher.h"
+#include "../../../Class/Engine/Func/Compression/Compression.h"
+#include "../../../Class/Engine/Func/AssetPacker/AssetPacker.h"
+#include "../../../Class/Engine/Class/AssetArchive/AssetArchive.h"
+#include "../../../Class/Engine/Class/AssetFile/AssetFile.h"
+#include "../../../Class/Engine/Func/ShaderPermutation/ShaderPermutation.h"
+#include "../../../Class/Engine/Func/ShaderCache/ShaderCache.h"
+#include "../../../Class/Engine/Class/TextureStreamer/TextureStreamer.h"
+#include "../../../Class/Engine/Class/Logger/Logger.h"
+#include "../../../Class/Engine/Class/FrameProfiler/FrameProfiler.h"
+#include "../../../Class/Engine/Class/RenderDevice/NullRenderDevice/NullRenderDevice.h"
+#include "../../../Class/Engine/Func/DrawRecord/DrawRecord.h"
+#include "../../../Class/Engine/Func/AtlasPacker/AtlasPacker.h"
+#ifdef _WIN32
+#include "../../../Class/Engine/externals/DirectXTex/DirectXTex.h"
+#endif
+
+// テストで書き出すファイルを置くディレクトリ
+const std::string kTestTemporaryDirectory = "Class/Engine/Cache/Test";
+
+/// <summary>
+/// テストで書き出すファイルのパスを求める（ディレクトリが無ければ作る）
+/// </summary>
+/// <param name="filename">ファイル名</param>
+/// <returns>kTestTemporaryDirectoryの中のパス</returns>
+std::string MakeTestFilePath(const std::string& filename);
+
+/// <summary>
+/// 行列の計算（Func/Matrix）のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMatrixTests(TestRunner& runner);
+
+/// <summary>
+/// Objファイルの読み込み（Func/ObjParser）のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterObjParserTests(TestRunner& runner);
+
+/// <summary>
+/// レンダーグラフ（Class/RenderGraph）の省き方、バリア、重ねて置く処理のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderGraphTests(TestRunner& runner);
+
+/// <summary>
+/// リソースを重ねて置く処理（Func/AliasingPlan）を、決めた組と乱数で作った組で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAliasingTests(TestRunner& runner);
+
+/// <summary>
+/// ヒープの切り分け（Class/TlsfAllocator）を、決めた確保と乱数で繰り返す確保と解放で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTlsfTests(TestRunner& runner);
+
+/// <summary>
+/// .wavのストリーミング（Class/WavStream）を、作った.wavと作り物の再生先で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterWavStreamTests(TestRunner& runner);
+
+/// <summary>
+/// ボイスの使い回し（Class/VoicePool）を、決めた鳴らし方と乱数で繰り返す鳴らし方で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterVoicePoolTests(TestRunner& runner);
+
+/// <summary>
+/// ファイルの変更の監視（Class/FileWatcher）を、実際に書き込んだファイルと決めた時刻で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterFileWatcherTests(TestRunner& runner);
+
+/// <summary>
+/// アセットの圧縮とアーカイブ（Func/Compression、Func/AssetPacker、Class/AssetArchive、Class/AssetFile）のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAssetTests(TestRunner& runner);
+
+/// <summary>
+/// シェーダーのバリアント（Func/ShaderPermutation）と、コンパイル済みのシェーダーのキャッシュ（Func/ShaderCache）のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterShaderTests(TestRunner& runner);
+
+/// <summary>
+/// テクスチャのストリーミング（Class/TextureStreamer）のテストを、作り物の時計で登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterTextureStreamerTests(TestRunner& runner);
+
+/// <summary>
+/// リングバッファのログ（Class/Logger）のテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterLoggerTests(TestRunner& runner);
+
+/// <summary>
+/// 描画のコマンドを積む処理（Func/DrawRecord）を、検証して数える作り物の描画先（Class/RenderDevice/NullRenderDevice）で確かめるテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterRenderDeviceTests(TestRunner& runner);
+
+/// <summary>
+/// スプライトのアトラスの詰め方（Func/AtlasPacker）のテストを、DirectXTexを使わずにメモリ上のページで登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAtlasPackerTests(TestRunner& runner);
+
+// フレームの計測（Class/FrameProfiler）のリングバッファを読む処理を、直接呼んで確かめる（FrameProfilerのfriend）
+class FrameProfilerTests
+{
+public:
+
+	// テストを登録する
+	static void Register(TestRunner& runner);
+};
+
+#ifdef _WIN32
+/// <summary>
+/// ミップの作成（externals/DirectXTex の DirectXTexMipmaps）を、1つのスレッド、速く作る処理、行の帯に分けて作ったもので、変える前のフィルタで作ったものとバイトごとに比べるテストを登録する（DirectXTexはWindowsでしかビルドしない）
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterMipmapTests(TestRunner& runner);
+#endif
+
+/// <summary>
+/// 全てのテストを登録する
+/// </summary>
+/// <param name="runner">登録先</param>
+void RegisterAllTests(TestRunner& runner);
@@ -0,0 +1,237 @@
+#include "TestCases.h"
+
+// 1フレームの時間（秒）
+static const double kFrameTime = 1.0 / 60.0;
+
+// 時計を進めるだけの、作り物の時計（実際の時刻を使わずに、要求の期限を確かめる）
+typedef struct FakeClock
+{
+	// 今の時刻（秒）
+	double currentTime;
+
+	// 1フレーム進める
+	double Tick() { currentTime += kFrameTime; return currentTime; }
+}FakeClock;
+
+// RGBA8の正方形のテクスチャの、ミップごとのバイト数
+static std::vector<uint64_t> MakeMipByteSizes(uint32_t size)
+{
+	std::vector<uint64_t> mipByteSizes;
+	for (uint32_t mipSize = size; mipSize > 0; mipSize /= 2)
+	{
+		mipByteSizes.push_back(uint64_t(mipSize) * mipSize * 4);
+	}
+
+	return mipByteSizes;
+}
+
+// 転送予定が同じかどうか
+static bool IsSameRequests(const std::vector<StreamingRequest>& a, const std::vector<StreamingRequest>& b)
+{
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const StreamingRequest& x, const StreamingRequest& y)
+		{
+			return x.slot == y.slot && x.mipLevel == y.mipLevel && x.byteSize == y.byteSize;
+		});
+}
+
+// テクスチャのストリーミング（Class/TextureStreamer）のテストを登録する
+void RegisterTextureStreamerTests(TestRunner& runner)
+{
+	// 画面上の大きさから、1テクセルが1ピクセル以上になる最も粗いミップを選ぶ
+	runner.Add("TextureStreamer", "SelectMipLevel", [](TestContext& context)
+		{
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 2048.0f) == 0);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 1024.0f) == 0);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 1023.0f) == 0);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 512.0f) == 1);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 300.0f) == 1);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 1.0f) == 10);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 11, 0.0f) == 10);
+
+			// ミップが少なければ、最も粗いミップで止める
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 3, 16.0f) == 2);
+			TEST_CHECK(context, TextureStreamer::SelectMipLevel(1024, 512, 0, 16.0f) == 0);
+
+			// 末尾ミップは、縦横ともに決めた大きさ以下になる最初のミップ
+			TEST_CHECK(context, TextureStreamer::SelectTailMip(1024, 512, 11, 64) == 4);
+			TEST_CHECK(context, TextureStreamer::SelectTailMip(64, 64, 7, 64) == 0);
+			TEST_CHECK(context, TextureStreamer::SelectTailMip(4096, 4096, 3, 64) == 2);
+		});
+
+	// 要求は期限の間は細かい方を残し、期限が切れたら置き換える
+	runner.Add("TextureStreamer", "RequestLifetime", [](TestContext& context)
+		{
+			TextureStreamer streamer;
+			streamer.Initialize(1ull << 30, 1.0);
+			streamer.Register(0, 256, 256, MakeMipByteSizes(256), 2);
+
+			// 要求が無ければ、転送済みのミップで十分とする
+			TEST_CHECK(context, streamer.GetDesiredMip(0) == 2);
+
+			streamer.RequestScreenSize(0, 64.0f, 0.0);
+			streamer.RequestScreenSize(0, 256.0f, 0.5);
+			streamer.RequestScreenSize(0, 64.0f, 0.9);
+			TEST_CHECK(context, streamer.GetDesiredMip(0) == 0);
+
+			streamer.RequestScreenSize(0, 64.0f, 2.5);
+			TEST_CHECK(context, streamer.GetDesiredMip(0) == 2);
+
+			// 登録していないものへの要求は無視する
+			streamer.RequestScreenSize(5, 256.0f, 2.5);
+			TEST_CHECK(context, streamer.IsRegistered(5) == false);
+			TEST_CHECK(context, streamer.GetDesiredMip(5) == 0);
+		});
+
+	// 不足している段数が多いものから、同じなら小さいものから、粗いミップから1段ずつ転送する
+	runner.Add("TextureStreamer", "MipPriority", [](TestContext& context)
+		{
+			FakeClock clock{};
+			TextureStreamer streamer;
+			streamer.Initialize(1ull << 30, 1.0);
+
+			// 256は2段、128は1段不足している
+			streamer.Register(0, 256, 256, MakeMipByteSizes(256), 2);
+			streamer.Register(1, 128, 128, MakeMipByteSizes(128), 1);
+			streamer.RequestScreenSize(0, 256.0f, clock.currentTime);
+			streamer.RequestScreenSize(1, 128.0f, clock.currentTime);
+
+			std::vector<StreamingRequest> requests = streamer.Update(clock.Tick());
+			TEST_CHECK(context, IsSameRequests(requests, { { 0 , 1 , 65536 } , { 1 , 0 , 65536 } , { 0 , 0 , 262144 } }));
+			TEST_CHECK(context, streamer.IsFullyResident(0) && streamer.IsFullyResident(1));
+			TEST_CHECK(context, streamer.GetStreamedBytes() == 65536 + 65536 + 262144);
+
+			// 全て転送し終えたら、何も転送しない
+			TEST_CHECK(context, streamer.Update(clock.Tick()).empty());
+		});
+
+	// 予算を超える分は次のフレームに回し、1つも転送していないフレームだけは予算を超えても転送する
+	runner.Add("TextureStreamer", "BytesPerFrameBudget", [](TestContext& context)
+		{
+			FakeClock clock{};
+			TextureStreamer streamer;
+			streamer.Initialize(65536 + 16384, 1.0);
+			streamer.Register(0, 256, 256, MakeMipByteSizes(256), 2);
+			streamer.Register(1, 128, 128, MakeMipByteSizes(128), 1);
+
+			const std::vector<std::vector<StreamingRequest>> expectedFrames =
+			{
+				{ { 0 , 1 , 65536 } },
+				{ { 1 , 0 , 65536 } },
+				{ { 0 , 0 , 262144 } },
+				{}
+			};
+
+			for (const std::vector<StreamingRequest>& expected : expectedFrames)
+			{
+				// 描画するたびに要求する
+				streamer.RequestScreenSize(0, 256.0f, clock.currentTime);
+				streamer.RequestScreenSize(1, 128.0f, clock.currentTime);
+
+				if (TEST_CHECK(context, IsSameRequests(streamer.Update(clock.Tick()), expected)) == false)
+					return;
+			}
+
+			// 予算を変えれば、次のフレームから使う
+			streamer.Register(2, 256, 256, MakeMipByteSizes(256), 4);
+			streamer.SetBytesPerFrame(4096 + 16384);
+			streamer.RequestScreenSize(2, 256.0f, clock.currentTime);
+			TEST_CHECK(context, IsSameRequests(streamer.Update(clock.Tick()), { { 2 , 3 , 4096 } , { 2 , 2 , 16384 } }));
+		});
+
+	// 期限の切れた要求と、登録を解除したものは、それ以上転送しない
+	runner.Add("TextureStreamer", "ExpiredRequestsStopStreaming", [](TestContext& context)
+		{
+			FakeClock clock{};
+			TextureStreamer streamer;
+			streamer.Initialize(1, 1.0);
+			streamer.Register(0, 256, 256, MakeMipByteSizes(256), 2);
+			streamer.Register(1, 256, 256, MakeMipByteSizes(256), 2);
+
+			streamer.RequestScreenSize(0, 256.0f, clock.currentTime);
+			streamer.RequestScreenSize(1, 256.0f, clock.currentTime);
+			TEST_CHECK(context, IsSameRequests(streamer.Update(clock.Tick()), { { 0 , 1 , 65536 } }));
+
+			// 登録を解除したものは、要求が残っていても転送しない
+			streamer.Unregister(0);
+			TEST_CHECK(context, streamer.IsRegistered(0) == false);
+			TEST_CHECK(context, IsSameRequests(streamer.Update(clock.Tick()), { { 1 , 1 , 65536 } }));
+
+			// 要求されないまま期限が切れたら、転送済みのミップで止める
+			clock.currentTime += 1.5;
+			TEST_CHECK(context, streamer.Update(clock.Tick()).empty());
+			TEST_CHECK(context, streamer.GetResidentMip(1) == 1);
+			TEST_CHECK(context, streamer.GetDesiredMip(1) == 1);
+
+			// もう一度要求されれば、続きから転送する
+			streamer.RequestScreenSize(1, 256.0f, clock.currentTime);
+			TEST_CHECK(context, IsSameRequests(streamer.Update(clock.Tick()), { { 1 , 0 , 262144 } }));
+			TEST_CHECK(context, streamer.IsFullyResident(1));
+		});
+
+	// ランダムな大きさと予算でも、予算を守り、1段ずつ転送して、いずれ全て転送し終える
+	runner.Add("TextureStreamer", "RandomFramesConverge", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+
+			for (uint32_t trial = 0; trial < 50; ++trial)
+			{
+				FakeClock clock{};
+				TextureStreamer streamer;
+				uint64_t bytesPerFrame = std::uniform_int_distribution<uint64_t>(1, 1 << 20)(random);
+				streamer.Initialize(bytesPerFrame, 0.5);
+
+				const uint32_t numTextures = std::uniform_int_distribution<uint32_t>(1, 12)(random);
+				std::vector<float> screenPixels(numTextures);
+
+				for (uint32_t i = 0; i < numTextures; ++i)
+				{
+					uint32_t size = 1u << std::uniform_int_distribution<uint32_t>(0, 10)(random);
+					std::vector<uint64_t> mipByteSizes = MakeMipByteSizes(size);
+					uint32_t mipLevels = uint32_t(mipByteSizes.size());
+
+					streamer.Register(i, size, size, mipByteSizes, TextureStreamer::SelectTailMip(size, size, mipLevels, 64));
+					screenPixels[i] = std::uniform_real_distribution<float>(0.0f, 1500.0f)(random);
+				}
+
+				// 表示したい大きさが変わらなければ、決まったフレーム数以内に必要なミップが揃う
+				uint32_t frame = 0;
+				for (; frame < 1000; ++frame)
+				{
+					std::vector<uint32_t> previousMips(numTextures);
+					for (uint32_t i = 0; i < numTextures; ++i)
+					{
+						streamer.RequestScreenSize(i, screenPixels[i], clock.currentTime);
+						previousMips[i] = streamer.GetResidentMip(i);
+					}
+
+					std::vector<StreamingRequest> requests = streamer.Update(clock.Tick());
+					if (requests.empty())
+						break;
+
+					uint64_t frameBytes = 0;
+					for (const StreamingRequest& request : requests)
+					{
+						// 前に転送したミップの、1段細かいもの
+						if (TEST_CHECK(context, request.mipLevel + 1 == previousMips[request.slot]) == false)
+							return;
+
+						previousMips[request.slot] = request.mipLevel;
+						frameBytes += request.byteSize;
+					}
+
+					if (TEST_CHECK(context, frameBytes <= bytesPerFrame || requests.size() == 1) == false)
+					{
+						context.Fail("trial " + std::to_string(trial) + " frame " + std::to_string(frame), __FILE__, __LINE__);
+						return;
+					}
+				}
+
+				TEST_CHECK(context, frame < 1000);
+
+				for (uint32_t i = 0; i < numTextures; ++i)
+				{
+					TEST_CHECK(context, streamer.GetResidentMip(i) <= streamer.GetDesiredMip(i));
+				}
+			}
+		});
+}
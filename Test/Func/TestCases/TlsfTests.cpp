@@ -0,0 +1,218 @@
+#include "TestCases.h"
+
+/// <summary>
+/// 乱数で確保と解放を繰り返し、TlsfAllocatorの状態と確保した範囲が正しいかを確かめる
+/// </summary>
+/// <param name="context">結果を記録する先</param>
+/// <param name="random">乱数</param>
+/// <param name="capacity">管理する大きさ</param>
+/// <param name="numOperations">確保と解放の回数</param>
+/// <returns>正しければtrue</returns>
+static bool FuzzTlsfAllocator(TestContext& context, std::mt19937& random, uint64_t capacity, uint32_t numOperations)
+{
+	// 確保した範囲
+	typedef struct LiveBlock
+	{
+		uint32_t block;
+		uint64_t offset;
+		uint64_t sizeInBytes;
+	}LiveBlock;
+
+	TlsfAllocator allocator(capacity);
+	std::vector<LiveBlock> liveBlocks;
+
+	for (uint32_t operation = 0; operation < numOperations; ++operation)
+	{
+		// 2回に1回より多く確保して、いっぱいになるまで使う
+		if (liveBlocks.empty() || random() % 3 != 0)
+		{
+			uint64_t sizeInBytes = 1 + random() % (allocator.GetCapacity() / (1 + random() % 64));
+			uint64_t alignment = uint64_t(1) << (random() % 17);
+
+			uint64_t offset = 0;
+			uint32_t block = allocator.Allocate(sizeInBytes, alignment, offset);
+			if (block == TlsfAllocator::kInvalidBlock)
+				continue;
+
+			if (TEST_CHECK(context, offset % alignment == 0 && offset + sizeInBytes <= allocator.GetCapacity()) == false)
+				return false;
+
+			liveBlocks.push_back({ block , offset , sizeInBytes });
+		}
+		else
+		{
+			size_t index = random() % liveBlocks.size();
+			allocator.Free(liveBlocks[index].block);
+			liveBlocks[index] = liveBlocks.back();
+			liveBlocks.pop_back();
+		}
+
+		if (operation % 64 != 0)
+			continue;
+
+		// 確保した範囲が重なっていない
+		std::vector<LiveBlock> sorted = liveBlocks;
+		std::sort(sorted.begin(), sorted.end(), [](const LiveBlock& a, const LiveBlock& b) { return a.offset < b.offset; });
+		for (size_t i = 1; i < sorted.size(); ++i)
+		{
+			if (TEST_CHECK(context, sorted[i - 1].offset + sorted[i - 1].sizeInBytes <= sorted[i].offset) == false)
+				return false;
+		}
+
+		if (TEST_CHECK(context, allocator.Validate()) == false)
+			return false;
+	}
+
+	// 全て解放したら、1つの空きブロックに戻る
+	for (const LiveBlock& liveBlock : liveBlocks)
+	{
+		allocator.Free(liveBlock.block);
+	}
+
+	TlsfStats stats = allocator.GetStats();
+	return TEST_CHECK(context, allocator.Validate() && stats.usedBytes == 0 && stats.numFreeBlocks == 1 && stats.largestFreeBlock == allocator.GetCapacity());
+}
+
+/// <summary>
+/// GpuMemoryAllocatorと同じように、専用のヒープの大きさを決める（64KBに揃え、既定のヒープより小さくしない）
+/// </summary>
+/// <param name="sizeInBytes">確保する大きさ</param>
+/// <param name="alignment">揃え</param>
+/// <param name="defaultHeapSize">既定のヒープの大きさ</param>
+/// <returns>ヒープの大きさ</returns>
+static uint64_t GetDedicatedHeapSize(uint64_t sizeInBytes, uint64_t alignment, uint64_t defaultHeapSize)
+{
+	const uint64_t kHeapAlignment = 64 * 1024;
+	uint64_t requiredSize = (TlsfAllocator::GetRequiredCapacity(sizeInBytes, alignment) + kHeapAlignment - 1) / kHeapAlignment * kHeapAlignment;
+	return requiredSize > defaultHeapSize ? requiredSize : defaultHeapSize;
+}
+
+// ヒープの切り分け（Class/TlsfAllocator）のテストを登録する
+void RegisterTlsfTests(TestRunner& runner)
+{
+	// 揃えを守って確保し、解放すると前後の空きとつながる
+	runner.Add("Tlsf", "AllocateAlignAndCoalesce", [](TestContext& context)
+		{
+			const uint64_t kCapacity = 1024 * 1024;
+			TlsfAllocator allocator(kCapacity);
+
+			uint64_t offsets[3] = {};
+			uint32_t a = allocator.Allocate(1000, 256, offsets[0]);
+			uint32_t b = allocator.Allocate(5000, 64 * 1024, offsets[1]);
+			uint32_t c = allocator.Allocate(300, 512, offsets[2]);
+			TEST_CHECK(context, a != TlsfAllocator::kInvalidBlock && b != TlsfAllocator::kInvalidBlock && c != TlsfAllocator::kInvalidBlock);
+			TEST_CHECK(context, offsets[1] % (64 * 1024) == 0);
+			TEST_CHECK(context, offsets[2] % 512 == 0);
+			TEST_CHECK(context, allocator.GetNumAllocations() == 3);
+			TEST_CHECK(context, allocator.Validate());
+
+			// 大きさは kGranularity に揃える
+			TEST_CHECK(context, allocator.GetBlockSize(a) % TlsfAllocator::kGranularity == 0);
+			TEST_CHECK(context, allocator.GetBlockSize(a) >= 1000);
+
+			// 真ん中を先に解放しても、最後には1つの空きに戻る
+			allocator.Free(b);
+			TEST_CHECK(context, allocator.Validate());
+			allocator.Free(a);
+			allocator.Free(c);
+			TlsfStats stats = allocator.GetStats();
+			TEST_CHECK(context, allocator.Validate());
+			TEST_CHECK(context, allocator.IsEmpty());
+			TEST_CHECK(context, stats.numFreeBlocks == 1);
+			TEST_CHECK(context, stats.largestFreeBlock == kCapacity);
+			TEST_CHECK(context, GetFragmentation(stats) == 0.0);
+		});
+
+	// 空きが足りなければ、確保できない
+	runner.Add("Tlsf", "RejectsWhenFull", [](TestContext& context)
+		{
+			const uint64_t kCapacity = 64 * 1024;
+			TlsfAllocator allocator(kCapacity);
+
+			uint64_t offset = 0;
+			uint32_t half = allocator.Allocate(kCapacity / 2, 256, offset);
+			TEST_CHECK(context, half != TlsfAllocator::kInvalidBlock);
+			TEST_CHECK(context, allocator.Allocate(kCapacity, 256, offset) == TlsfAllocator::kInvalidBlock);
+			TEST_CHECK(context, allocator.GetNumAllocations() == 1);
+			TEST_CHECK(context, allocator.Validate());
+		});
+
+	// 大きさの違うヒープで、乱数で確保と解放を繰り返す
+	runner.Add("Tlsf", "RandomAllocateAndFree", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+
+			for (uint32_t trial = 0; trial < 200; ++trial)
+			{
+				uint64_t capacity = (uint64_t(1) << (16 + trial % 12)) + trial * 4096;
+				if (FuzzTlsfAllocator(context, random, capacity, 4000) == false)
+				{
+					context.Fail(engine::format("trial {} (capacity {})", trial, capacity), __FILE__, __LINE__);
+					return;
+				}
+			}
+		});
+
+	// 専用のヒープは、探すときにサイズクラスを切り上げても、確保する大きさが必ず入る
+	runner.Add("Tlsf", "DedicatedHeapFitsSizeClassRoundUp", [](TestContext& context)
+		{
+			const uint64_t kMegabyte = 1024 * 1024;
+			const uint64_t kUploadHeapSize = 16 * kMegabyte;
+			const uint64_t kTextureHeapSize = 64 * kMegabyte;
+
+			// 既定のヒープに入らず、専用のヒープを作る大きさ
+			typedef struct DedicatedCase
+			{
+				uint64_t sizeInBytes;
+				uint64_t alignment;
+				uint64_t defaultHeapSize;
+			}DedicatedCase;
+
+			std::vector<DedicatedCase> cases =
+			{
+				{ 16 * kMegabyte + 1, 256, kUploadHeapSize },
+				{ 33 * kMegabyte, 256, kUploadHeapSize },
+				{ 70 * kMegabyte, 256, kTextureHeapSize },
+				{ 70 * kMegabyte, 64 * 1024, kTextureHeapSize }
+			};
+
+			// サイズクラスの境目の前後と、乱数で決めた大きさも加える
+			for (uint32_t shift = 24; shift < 34; ++shift)
+			{
+				for (uint64_t delta : { uint64_t(1), uint64_t(255), uint64_t(256), uint64_t(64 * 1024), uint64_t(1) << (shift - 4) })
+				{
+					for (uint64_t alignment : { uint64_t(256), uint64_t(64 * 1024), uint64_t(4 * kMegabyte) })
+					{
+						cases.push_back({ (uint64_t(1) << shift) + delta, alignment, kTextureHeapSize });
+						cases.push_back({ (uint64_t(1) << shift) - delta, alignment, kUploadHeapSize });
+					}
+				}
+			}
+
+			std::mt19937_64 random(20240601u);
+			for (uint32_t i = 0; i < 2000; ++i)
+			{
+				cases.push_back({ 1 + random() % (512 * kMegabyte), uint64_t(1) << (8 + random() % 15), kUploadHeapSize });
+			}
+
+			for (const DedicatedCase& dedicated : cases)
+			{
+				uint64_t heapSize = GetDedicatedHeapSize(dedicated.sizeInBytes, dedicated.alignment, dedicated.defaultHeapSize);
+				TlsfAllocator allocator(heapSize);
+
+				uint64_t offset = 0;
+				uint32_t block = allocator.Allocate(dedicated.sizeInBytes, dedicated.alignment, offset);
+				bool isAllocated = block != TlsfAllocator::kInvalidBlock && offset % dedicated.alignment == 0 &&
+					offset + dedicated.sizeInBytes <= allocator.GetCapacity();
+				if (TEST_CHECK(context, isAllocated) == false)
+				{
+					context.Fail(engine::format("size {} alignment {} heap {}", dedicated.sizeInBytes, dedicated.alignment, heapSize), __FILE__, __LINE__);
+					return;
+				}
+
+				// 切り上げる分は、サイズクラスの幅（1/16）と揃えの分を超えない
+				uint64_t limit = dedicated.sizeInBytes + dedicated.sizeInBytes / 8 + dedicated.alignment + 64 * 1024;
+				TEST_CHECK(context, heapSize <= (limit > dedicated.defaultHeapSize ? limit : dedicated.defaultHeapSize));
+			}
+		});
+}
@@ -0,0 +1,188 @@
+#include "TestCases.h"
+
+/// <summary>
+/// 乱数で鳴らすのと鳴らし終えるのを繰り返し、VoicePoolが上限と優先度を守るかを確かめる
+/// </summary>
+/// <param name="context">結果を記録する先</param>
+/// <param name="random">乱数</param>
+/// <param name="maxVoices">同時に鳴らす数の上限</param>
+/// <param name="numOperations">鳴らすのと鳴らし終える回数</param>
+/// <returns>正しければtrue</returns>
+static bool FuzzVoicePool(TestContext& context, std::mt19937& random, uint32_t maxVoices, uint32_t numOperations)
+{
+	// 音ごとの波形フォーマット、優先度、同時に鳴らす数の上限
+	const uint32_t kNumSounds = 24;
+	const VoiceFormat kFormats[3] = { { 1 , 2 , 48000 , 4 , 16 } , { 1 , 1 , 44100 , 2 , 16 } , { 3 , 2 , 48000 , 8 , 32 } };
+
+	VoiceFormat formats[kNumSounds] = {};
+	int32_t priorities[kNumSounds] = {};
+	uint32_t maxInstances[kNumSounds] = {};
+	for (uint32_t i = 0; i < kNumSounds; ++i)
+	{
+		formats[i] = kFormats[random() % 3];
+		priorities[i] = static_cast<int32_t>(random() % 4);
+		maxInstances[i] = random() % 4;
+	}
+
+	VoicePool pool(maxVoices);
+
+	for (uint32_t operation = 0; operation < numOperations; ++operation)
+	{
+		// 鳴らし終えるものより、鳴らすものを多くして、上限まで埋める
+		if (random() % 3 != 0)
+		{
+			uint32_t sound = random() % kNumSounds;
+
+			// 鳴らす前に、止められるものがあるかを数える
+			bool isFull = pool.GetStats().numActive == maxVoices;
+			bool isInstanceCapped = maxInstances[sound] > 0 && pool.CountInstances(sound) >= maxInstances[sound];
+			bool hasVictim = false;
+			std::vector<bool> wasPlaying(pool.GetNumVoices());
+			for (uint32_t i = 0; i < pool.GetNumVoices(); ++i)
+			{
+				wasPlaying[i] = pool.IsPlaying(i);
+				hasVictim = hasVictim || (pool.IsPlaying(i) && pool.GetPriority(i) <= priorities[sound]);
+			}
+
+			VoiceRequest request = pool.Acquire(formats[sound], sound, priorities[sound], maxInstances[sound]);
+
+			// 鳴らせないのは、同じ音の上限でなく、優先度の高いもので埋まっているときだけ
+			if (request.voiceIndex == VoicePool::kInvalidVoice)
+			{
+				if (TEST_CHECK(context, isFull && isInstanceCapped == false && hasVictim == false) == false)
+					return false;
+
+				continue;
+			}
+
+			if (TEST_CHECK(context, isFull == false || isInstanceCapped || hasVictim) == false)
+				return false;
+
+			// 止めて使うのは、鳴っていたものだけ。波形フォーマットが違えば作り直す
+			uint32_t index = request.voiceIndex;
+			bool isExisting = index < wasPlaying.size();
+			if (TEST_CHECK(context, request.isStolen == (isExisting && wasPlaying[index])) == false ||
+				TEST_CHECK(context, request.needsCreate == (isExisting == false || request.needsDestroy)) == false ||
+				TEST_CHECK(context, pool.GetFormat(index) == formats[sound] && pool.GetSoundId(index) == sound) == false)
+				return false;
+		}
+		else if (pool.GetNumVoices() > 0)
+		{
+			pool.Release(random() % pool.GetNumVoices());
+		}
+
+		// 同じ音の数の上限を守っている
+		for (uint32_t sound = 0; sound < kNumSounds; ++sound)
+		{
+			if (TEST_CHECK(context, maxInstances[sound] == 0 || pool.CountInstances(sound) <= maxInstances[sound]) == false)
+				return false;
+		}
+
+		if (TEST_CHECK(context, pool.Validate()) == false)
+			return false;
+	}
+
+	return true;
+}
+
+// ボイスの使い回し（Class/VoicePool）のテストを登録する
+void RegisterVoicePoolTests(TestRunner& runner)
+{
+	// 同じ波形フォーマットの空きは作り直さずに使い回し、違えば作り直す
+	runner.Add("VoicePool", "ReusesVoicesPerFormat", [](TestContext& context)
+		{
+			const VoiceFormat kStereo = { 1 , 2 , 48000 , 4 , 16 };
+			const VoiceFormat kMono = { 1 , 1 , 44100 , 2 , 16 };
+
+			VoicePool pool(2);
+
+			VoiceRequest first = pool.Acquire(kStereo, 0, 0, 0);
+			TEST_CHECK(context, first.voiceIndex == 0 && first.needsCreate && first.needsDestroy == false && first.isStolen == false);
+			pool.Release(first.voiceIndex);
+
+			VoiceRequest reused = pool.Acquire(kStereo, 1, 0, 0);
+			TEST_CHECK(context, reused.voiceIndex == 0 && reused.needsCreate == false && reused.needsDestroy == false);
+
+			VoiceRequest second = pool.Acquire(kMono, 2, 0, 0);
+			TEST_CHECK(context, second.voiceIndex == 1 && second.needsCreate);
+			pool.Release(reused.voiceIndex);
+			pool.Release(second.voiceIndex);
+
+			// 作りきっていれば、最も前に鳴らし終えた空きを作り直す
+			const VoiceFormat kFloat = { 3 , 2 , 48000 , 8 , 32 };
+			VoiceRequest recreated = pool.Acquire(kFloat, 3, 0, 0);
+			TEST_CHECK(context, recreated.voiceIndex == 0 && recreated.needsDestroy && recreated.needsCreate);
+
+			const VoicePoolStats& stats = pool.GetStats();
+			TEST_CHECK(context, stats.numCreated == 3 && stats.numDestroyed == 1 && stats.numReused == 1);
+			TEST_CHECK(context, pool.Validate());
+		});
+
+	// 同じ音が上限まで鳴っていれば、その中で最も古いものを止める
+	runner.Add("VoicePool", "StealsOldestInstance", [](TestContext& context)
+		{
+			const VoiceFormat kFormat = { 1 , 2 , 48000 , 4 , 16 };
+			VoicePool pool(8);
+
+			uint32_t a = pool.Acquire(kFormat, 7, 0, 2).voiceIndex;
+			uint32_t b = pool.Acquire(kFormat, 7, 0, 2).voiceIndex;
+			VoiceRequest third = pool.Acquire(kFormat, 7, 0, 2);
+			TEST_CHECK(context, third.voiceIndex == a && third.isStolen);
+			TEST_CHECK(context, pool.CountInstances(7) == 2);
+
+			VoiceRequest fourth = pool.Acquire(kFormat, 7, 0, 2);
+			TEST_CHECK(context, fourth.voiceIndex == b && fourth.isStolen);
+			TEST_CHECK(context, pool.GetStats().numStolenByInstanceLimit == 2);
+		});
+
+	// 上限まで鳴っていれば、優先度が同じか低いものの中で最も低く古いものを止め、高いものしか無ければ鳴らさない
+	runner.Add("VoicePool", "StealsByPriority", [](TestContext& context)
+		{
+			const VoiceFormat kFormat = { 1 , 2 , 48000 , 4 , 16 };
+			VoicePool pool(3);
+
+			uint32_t low = pool.Acquire(kFormat, 0, 1, 0).voiceIndex;
+			pool.Acquire(kFormat, 1, 5, 0);
+			pool.Acquire(kFormat, 2, 5, 0);
+
+			VoiceRequest rejected = pool.Acquire(kFormat, 3, 0, 0);
+			TEST_CHECK(context, rejected.voiceIndex == VoicePool::kInvalidVoice);
+			TEST_CHECK(context, pool.GetStats().numRejected == 1);
+
+			VoiceRequest stolen = pool.Acquire(kFormat, 4, 5, 0);
+			TEST_CHECK(context, stolen.voiceIndex == low && stolen.isStolen);
+			TEST_CHECK(context, pool.GetPriority(low) == 5);
+			TEST_CHECK(context, pool.GetStats().numStolenByPriority == 1);
+			TEST_CHECK(context, pool.Validate());
+		});
+
+	// 作るのは上限まで。それ以降は使い回すか、止めて使う
+	runner.Add("VoicePool", "CreatesAtMostMaxVoices", [](TestContext& context)
+		{
+			VoicePool pool(32);
+			const VoiceFormat format = { 1 , 2 , 48000 , 4 , 16 };
+			for (uint32_t i = 0; i < 1000; ++i)
+			{
+				pool.Acquire(format, i % 8, 0, 4);
+			}
+
+			TEST_CHECK(context, pool.GetStats().numCreated == 32);
+			TEST_CHECK(context, pool.GetStats().numStolenByInstanceLimit > 0);
+			TEST_CHECK(context, pool.Validate());
+		});
+
+	// 乱数で鳴らすのと鳴らし終えるのを繰り返しても、上限と優先度を守る
+	runner.Add("VoicePool", "RandomAcquireAndRelease", [](TestContext& context)
+		{
+			std::mt19937 random(20240601u);
+
+			for (uint32_t trial = 0; trial < 200; ++trial)
+			{
+				if (FuzzVoicePool(context, random, 1 + trial % 48, 2000) == false)
+				{
+					context.Fail(engine::format("trial {} (max voices {})", trial, 1 + trial % 48), __FILE__, __LINE__);
+					return;
+				}
+			}
+		});
+}
@@ -0,0 +1,273 @@
+#include "TestCases.h"
+
+/// <summary>
+/// 乱数で決めた波形の.wavを書き出す（16bitステレオ。JUNKと、奇数の大きさのLISTを間に挟む）
+/// </summary>
+/// <param name="filePath">書き出す先</param>
+/// <param name="dataSize">波形データのバイト数</param>
+/// <param name="headerDataSize">ヘッダに書くバイト数（途中で切れたファイルを作るとき、dataSizeより大きくする）</param>
+/// <returns>書き出した波形データ</returns>
+static std::vector<uint8_t> WriteSyntheticWav(const std::string& filePath, uint32_t dataSize, uint32_t headerDataSize)
+{
+	std::mt19937 random(20240601u);
+	std::vector<uint8_t> data(dataSize);
+	for (uint8_t& byte : data)
+	{
+		byte = static_cast<uint8_t>(random());
+	}
+
+	WavStreamFormat format{};
+	format.formatTag = 1;
+	format.channels = 2;
+	format.samplesPerSec = 48000;
+	format.bitsPerSample = 16;
+	format.blockAlign = format.channels * format.bitsPerSample / 8;
+	format.avgBytesPerSec = format.samplesPerSec * format.blockAlign;
+
+	std::ofstream file(filePath, std::ios::binary);
+	auto writeChunkHeader = [&file](const char* id, uint32_t size)
+		{
+			file.write(id, 4);
+			file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		};
+
+	const char junk[10] = {};
+	const char list[5] = { 'I', 'N', 'F', 'O', 0 };
+
+	uint32_t riffSize = 4 + (8 + 16) + (8 + sizeof(junk)) + (8 + sizeof(list) + 1) + 8 + headerDataSize;
+	writeChunkHeader("RIFF", riffSize);
+	file.write("WAVE", 4);
+
+	writeChunkHeader("JUNK", sizeof(junk));
+	file.write(junk, sizeof(junk));
+
+	writeChunkHeader("fmt ", 16);
+	file.write(reinterpret_cast<const char*>(&format), 16);
+
+	writeChunkHeader("LIST", sizeof(list));
+	file.write(list, sizeof(list));
+	file.put(0);
+
+	writeChunkHeader("data", headerDataSize);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+	return data;
+}
+
+// 積まれたバッファを、別のスレッドで積まれた順に再生する代わりに写し取る
+class FakeStreamSink : public WavStreamSink
+{
+public:
+
+	// コンストラクタ
+	explicit FakeStreamSink(WavStream* stream) : stream_(stream) {}
+
+	// バッファを再生する列に積む
+	void SubmitBuffer(const uint8_t* data, uint32_t sizeInBytes, bool isEndOfStream) override
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back({ data , sizeInBytes , isEndOfStream });
+		maxQueued_ = queue_.size() > maxQueued_ ? queue_.size() : maxQueued_;
+		condition_.notify_one();
+	}
+
+	// 終わりまで、または maxBytes まで再生する（積まれるのを待ちきれなければfalse）
+	bool Play(uint64_t maxBytes)
+	{
+		while (isEndOfStream_ == false && played_.size() < maxBytes)
+		{
+			SubmittedBuffer buffer{};
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				if (condition_.wait_for(lock, std::chrono::seconds(5), [this]() { return queue_.empty() == false; }) == false)
+					return false;
+
+				buffer = queue_.front();
+				queue_.pop_front();
+			}
+
+			// 再生し終えるまでは、読み込むスレッドが書き換えていない
+			played_.insert(played_.end(), buffer.data, buffer.data + buffer.sizeInBytes);
+			sizes_.push_back(buffer.sizeInBytes);
+			isEndOfStream_ = buffer.isEndOfStream;
+
+			stream_->OnBufferEnd();
+		}
+
+		return true;
+	}
+
+	// Getter
+	const std::vector<uint8_t>& GetPlayed() const { return played_; }
+	const std::vector<uint32_t>& GetSizes() const { return sizes_; }
+	size_t GetMaxQueued() const { return maxQueued_; }
+	bool IsEndOfStream() const { return isEndOfStream_; }
+
+
+private:
+
+	// 積まれたバッファ
+	typedef struct SubmittedBuffer
+	{
+		const uint8_t* data;
+		uint32_t sizeInBytes;
+		bool isEndOfStream;
+	}SubmittedBuffer;
+
+	WavStream* stream_ = nullptr;
+
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	std::deque<SubmittedBuffer> queue_;
+	size_t maxQueued_ = 0;
+
+	// 再生したもの
+	std::vector<uint8_t> played_;
+	std::vector<uint32_t> sizes_;
+	bool isEndOfStream_ = false;
+};
+
+/// <summary>
+/// 作った.wavを読み込むスレッドで流し、再生したものが波形データと同じかを確かめる
+/// </summary>
+/// <param name="context">結果を記録する先</param>
+/// <param name="dataSize">波形データのバイト数</param>
+/// <param name="headerDataSize">ヘッダに書くバイト数</param>
+/// <param name="isLoop">ループするかどうか（するなら、2周半まで再生して止める）</param>
+static void CheckWavStream(TestContext& context, uint32_t dataSize, uint32_t headerDataSize, bool isLoop)
+{
+	std::string filePath = MakeTestFilePath("Stream.wav");
+	std::vector<uint8_t> data = WriteSyntheticWav(filePath, dataSize, headerDataSize);
+
+	WavStream stream;
+	if (TEST_CHECK(context, stream.Open(filePath)) == false)
+		return;
+
+	// ファイルにある分だけを読み、長さに関係なく同じメモリで流す
+	TEST_CHECK(context, stream.GetDataSize() == dataSize);
+	TEST_CHECK(context, stream.GetFormat().blockAlign == 4);
+	TEST_CHECK(context, stream.GetMemoryBytes() <= 512 * 1024);
+
+	FakeStreamSink sink(&stream);
+	stream.Start(&sink, isLoop);
+
+	uint64_t maxBytes = isLoop ? uint64_t(dataSize) * 5 / 2 : uint64_t(dataSize);
+	bool isPlayed = sink.Play(maxBytes);
+	stream.Stop();
+
+	TEST_CHECK(context, isPlayed);
+	TEST_CHECK(context, sink.GetMaxQueued() <= stream.GetNumBuffers());
+
+	// 最後のもの以外は、バッファの大きさずつ積まれる
+	const std::vector<uint32_t>& sizes = sink.GetSizes();
+	bool isChunked = true;
+	for (size_t i = 0; i + 1 < sizes.size(); ++i)
+	{
+		isChunked = isChunked && sizes[i] == stream.GetChunkSize();
+	}
+	TEST_CHECK(context, isChunked);
+
+	// ループするなら終わらずに、始めに戻って続く
+	const std::vector<uint8_t>& played = sink.GetPlayed();
+	if (isLoop)
+	{
+		TEST_CHECK(context, sink.IsEndOfStream() == false);
+		TEST_CHECK(context, played.size() >= maxBytes);
+
+		bool isSame = true;
+		for (size_t i = 0; i < played.size(); ++i)
+		{
+			isSame = isSame && played[i] == data[i % data.size()];
+		}
+		TEST_CHECK(context, isSame);
+		return;
+	}
+
+	TEST_CHECK(context, sink.IsEndOfStream());
+	TEST_CHECK(context, stream.IsFinished());
+	TEST_CHECK(context, played == data);
+}
+
+// .wavのストリーミング（Class/WavStream）のテストを登録する
+void RegisterWavStreamTests(TestRunner& runner)
+{
+	// 読み込むスレッドで流したものが、波形データと同じになる
+	runner.Add("WavStream", "StreamMatchesFile", [](TestContext& context)
+		{
+			// バッファの大きさで割り切れないもの
+			CheckWavStream(context, 1000000 + 12, 1000000 + 12, false);
+
+			// バッファの大きさで割り切れるもの
+			CheckWavStream(context, WavStream::kDefaultChunkSize * 3, WavStream::kDefaultChunkSize * 3, false);
+		});
+
+	// ループするものは、終わりまで読んだら始めに戻る
+	runner.Add("WavStream", "LoopWrapsToStart", [](TestContext& context)
+		{
+			CheckWavStream(context, 700000, 700000, true);
+		});
+
+	// ヘッダより短く切れたファイルは、ファイルにある分だけを流す
+	runner.Add("WavStream", "TruncatedFileStopsAtEnd", [](TestContext& context)
+		{
+			CheckWavStream(context, 300000, 900000, false);
+		});
+
+	// 読み込むスレッドを使わなくても、FillBuffersで空いているバッファを全て積む
+	runner.Add("WavStream", "FillBuffersWithoutThread", [](TestContext& context)
+		{
+			const uint32_t kDataSize = WavStream::kDefaultChunkSize * 5 + 100;
+			std::string filePath = MakeTestFilePath("Stream.wav");
+			std::vector<uint8_t> data = WriteSyntheticWav(filePath, kDataSize, kDataSize);
+
+			WavStream stream;
+			if (TEST_CHECK(context, stream.Open(filePath)) == false)
+				return;
+
+			FakeStreamSink sink(&stream);
+			stream.Start(&sink, false, false);
+
+			// 空いているバッファの数だけ積み、再生し終えるまでは積まない
+			TEST_CHECK(context, stream.FillBuffers() == stream.GetNumBuffers());
+			TEST_CHECK(context, stream.FillBuffers() == 0);
+			TEST_CHECK(context, stream.GetNumQueued() == stream.GetNumBuffers());
+
+			while (sink.IsEndOfStream() == false)
+			{
+				if (TEST_CHECK(context, sink.Play(sink.GetPlayed().size() + 1)) == false)
+					return;
+
+				stream.FillBuffers();
+			}
+
+			TEST_CHECK(context, stream.IsFinished());
+			TEST_CHECK(context, sink.GetPlayed() == data);
+			TEST_CHECK(context, stream.GetNumSubmitted() == 6);
+		});
+
+	// .wavでないものは開かず、知らないチャンクは飛ばしてヘッダを読む
+	runner.Add("WavStream", "ReadHeader", [](TestContext& context)
+		{
+			WavStreamFormat format{};
+			uint64_t dataOffset = 0;
+			uint32_t dataSize = 0;
+
+			std::istringstream notWav(std::string("RIFF\x04\0\0\0AVI ", 12));
+			TEST_CHECK(context, WavStream::ReadHeader(notWav, format, dataOffset, dataSize) == false);
+
+			std::istringstream empty;
+			TEST_CHECK(context, WavStream::ReadHeader(empty, format, dataOffset, dataSize) == false);
+
+			// JUNK、fmt、奇数の大きさのLIST（詰め物の1バイトを含む）の後に data がある
+			std::string filePath = MakeTestFilePath("Header.wav");
+			WriteSyntheticWav(filePath, 4000, 4000);
+			std::ifstream file(filePath, std::ios::binary);
+			TEST_CHECK(context, WavStream::ReadHeader(file, format, dataOffset, dataSize));
+			TEST_CHECK(context, dataSize == 4000);
+			TEST_CHECK(context, dataOffset == 12 + (8 + 10) + (8 + 16) + (8 + 5 + 1) + 8);
+			TEST_CHECK(context, format.channels == 2 && format.samplesPerSec == 48000 && format.bitsPerSample == 16);
+
+			WavStream stream;
+			TEST_CHECK(context, stream.Open(MakeTestFilePath("Missing.wav")) == false);
+		});
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include "Func/TestCases/TestCases.h"
+
+// 使い方
+static void PrintUsage()
+{
+	std::cout << "Test [--filter text] [--list]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	/*------------------
+	    引数を読み取る
+	------------------*/
+
+	std::string filter;
+	bool isListOnly = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--filter" && hasValue)
+		{
+			filter = argv[++i];
+		}
+		else if (argument == "--list")
+		{
+			isListOnly = true;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+
+	/*---------------
+	    実行する
+	---------------*/
+
+	TestRunner runner;
+	RegisterAllTests(runner);
+
+	if (isListOnly)
+	{
+		runner.List(std::cout, filter);
+		return 0;
+	}
+
+	uint32_t numFailed = runner.Run(std::cout, filter);
+
+	// 1つも実行しなければ、名前の指定が間違っている
+	if (runner.GetNumRun() == 0)
+	{
+		std::cout << "no tests matched " << filter << std::endl;
+		return 1;
+	}
+
+	return numFailed == 0 ? 0 : 1;
+}
@@ -6,6 +6,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 	Engine* engine = new Engine();
 	engine->Initialize(1280, 720);
 
+#ifdef _DEBUG
+	// 保存したアセットとシェーダーを、再起動せずに反映する
+	engine->EnableHotReload("Resources");
+#endif
+
 
 	// カメラ
 	Transform3D camera
@@ -47,15 +52,27 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 		/// ↓ 更新処理ここから
 		/// 
 
-		ImGui::Begin("Triangle");
-		ImGui::ColorEdit3("color", &color.x);
-		ImGui::DragFloat3("scale", &triangle.scale.x, 0.01f);
-		ImGui::DragFloat3("rotation", &triangle.rotate.x, 0.01f);
-		ImGui::DragFloat3("translation", &triangle.translate.x, 0.01f);
-		ImGui::End();
-
-		Matrix4x4 viewMatrix = Make4x4InverseMatrix(Make4x4AffineMatrix(camera.scale, camera.rotate, camera.translate));
-		Matrix4x4 projectionMatrix = Make4x4PerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+		Matrix4x4 viewProjectionMatrix;
+		{
+			PROFILE_SCOPE("Update");
+
+			ImGui::Begin("Triangle");
+			ImGui::ColorEdit3("color", &color.x);
+			ImGui::DragFloat3("scale", &triangle.scale.x, 0.01f);
+			ImGui::DragFloat3("rotation", &triangle.rotate.x, 0.01f);
+			ImGui::DragFloat3("translation", &triangle.translate.x, 0.01f);
+			ImGui::End();
+
+#ifdef _DEBUG
+			// フレームの時間とメモリの内訳を見る
+			engine->DrawFrameProfiler();
+			engine->DrawMemoryTracker();
+#endif
+
+			Matrix4x4 viewMatrix = Make4x4InverseMatrix(Make4x4AffineMatrix(camera.scale, camera.rotate, camera.translate));
+			Matrix4x4 projectionMatrix = Make4x4PerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+			viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
+		}
 
 		///
 		/// ↑ 更新処理ここまで
@@ -65,7 +82,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 		/// ↓ 描画処理ここから
 		/// 
 
-		engine->DrawTriangle(triangle, Multiply(viewMatrix, projectionMatrix), ghUvChecker, color);
+		{
+			PROFILE_SCOPE("Draw");
+
+			engine->DrawTriangle(triangle, viewProjectionMatrix, ghUvChecker, color);
+		}
 
 		///
 		/// ↑ 描画処理ここまで